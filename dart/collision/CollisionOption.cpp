@@ -46,7 +46,8 @@ CollisionOption::CollisionOption(
   : enableContact(enableContact),
     maxNumContacts(maxNumContacts),
     collisionFilter(collisionFilter),
-    contactClippingDepth(contactClippingDepth)
+    contactClippingDepth(contactClippingDepth),
+    maxNumContactsPerPair(0u)
 {
   // Do nothing
 }
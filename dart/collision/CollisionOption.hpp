@@ -63,6 +63,13 @@ struct CollisionOption
   /// CollisionFilter
   std::shared_ptr<CollisionFilter> collisionFilter;
 
+  /// If this is non-zero, collision detectors that support it (currently only
+  /// DARTCollisionDetector) reduce the contacts between each pair of objects
+  /// to at most this many points, chosen to cover the deepest point and as
+  /// much of the contact area as possible. 4 is usually enough for face-face
+  /// contacts. Zero (the default) keeps every contact.
+  std::size_t maxNumContactsPerPair;
+
   /// Constructor
   CollisionOption(
       bool enableContact = true,
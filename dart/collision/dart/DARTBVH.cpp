@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTBVH.hpp"
+
+#include <algorithm>
+
+namespace dart {
+namespace collision {
+
+//==============================================================================
+void DARTBVH::build(const std::vector<AABB>& boxes)
+{
+  clear();
+
+  if (boxes.empty())
+    return;
+
+  std::vector<Eigen::Vector3s> centers(boxes.size());
+  mPrimitives.resize(boxes.size());
+  for (std::size_t i = 0; i < boxes.size(); ++i)
+  {
+    centers[i] = boxes[i].center();
+    mPrimitives[i] = i;
+  }
+
+  // A binary tree with leaves of at least one primitive has fewer than twice
+  // as many nodes as primitives
+  mNodes.reserve(2 * boxes.size());
+  buildNode(boxes, centers, 0u, boxes.size());
+}
+
+//==============================================================================
+void DARTBVH::clear()
+{
+  mNodes.clear();
+  mPrimitives.clear();
+}
+
+//==============================================================================
+bool DARTBVH::isEmpty() const
+{
+  return mNodes.empty();
+}
+
+//==============================================================================
+const DARTBVH::AABB& DARTBVH::getBounds() const
+{
+  static const AABB empty;
+  return mNodes.empty() ? empty : mNodes[0].box;
+}
+
+//==============================================================================
+bool DARTBVH::intersectRay(
+    const AABB& box,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    const Eigen::Vector3s& invDir,
+    s_t maxFraction,
+    s_t& entry)
+{
+  s_t tMin = 0.0;
+  s_t tMax = maxFraction;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    if (dir(i) == 0.0)
+    {
+      // Parallel to this slab, so it's either always inside or never
+      if (from(i) < box.min()(i) || from(i) > box.max()(i))
+        return false;
+      continue;
+    }
+
+    s_t t1 = (box.min()(i) - from(i)) * invDir(i);
+    s_t t2 = (box.max()(i) - from(i)) * invDir(i);
+    if (t1 > t2)
+      std::swap(t1, t2);
+
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      return false;
+  }
+
+  entry = tMin;
+  return true;
+}
+
+//==============================================================================
+std::size_t DARTBVH::buildNode(
+    const std::vector<AABB>& boxes,
+    const std::vector<Eigen::Vector3s>& centers,
+    std::size_t begin,
+    std::size_t end)
+{
+  const std::size_t index = mNodes.size();
+  mNodes.emplace_back();
+
+  AABB box;
+  AABB centerBox;
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    box.extend(boxes[mPrimitives[i]]);
+    centerBox.extend(centers[mPrimitives[i]]);
+  }
+  mNodes[index].box = box;
+
+  const Eigen::Vector3s extent = centerBox.sizes();
+  int axis;
+  extent.maxCoeff(&axis);
+
+  // Make a leaf if there are few enough primitives, or if they all share a
+  // center and can't be split
+  if (end - begin <= MAX_LEAF_SIZE || extent(axis) <= 0.0)
+  {
+    mNodes[index].secondChild = 0u;
+    mNodes[index].first = begin;
+    mNodes[index].count = end - begin;
+    return index;
+  }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  std::nth_element(
+      mPrimitives.begin() + begin,
+      mPrimitives.begin() + middle,
+      mPrimitives.begin() + end,
+      [&](std::size_t a, std::size_t b) {
+        return centers[a](axis) < centers[b](axis);
+      });
+
+  // The first child always immediately follows its parent
+  buildNode(boxes, centers, begin, middle);
+  const std::size_t secondChild = buildNode(boxes, centers, middle, end);
+
+  // mNodes may have been reallocated, so index again rather than holding a
+  // reference across the recursion
+  mNodes[index].secondChild = secondChild;
+  mNodes[index].first = 0u;
+  mNodes[index].count = 0u;
+
+  return index;
+}
+
+}  // namespace collision
+}  // namespace dart
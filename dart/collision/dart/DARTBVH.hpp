@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTBVH_HPP_
+#define DART_COLLISION_DART_DARTBVH_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+/// A static bounding volume hierarchy of axis aligned boxes. This is used by
+/// DARTCollisionDetector both over the objects in a group (in world
+/// coordinates) and over the triangles of a mesh or heightmap (in the shape's
+/// own coordinates) to answer raycast and distance queries without visiting
+/// every primitive.
+///
+/// The tree is built top-down by splitting at the median centroid along the
+/// longest axis, and stored depth-first in a flat array so that traversal is
+/// cache friendly. It can't be updated in place; call build() again when the
+/// boxes move.
+class DARTBVH
+{
+public:
+  using AABB = Eigen::AlignedBox<s_t, 3>;
+
+  /// The most primitives a leaf holds
+  static constexpr std::size_t MAX_LEAF_SIZE = 4;
+
+  /// Builds the tree over `boxes`. Primitives are referred to by their index in
+  /// `boxes`.
+  void build(const std::vector<AABB>& boxes);
+
+  /// Removes everything from the tree
+  void clear();
+
+  /// Returns true if the tree holds no primitives
+  bool isEmpty() const;
+
+  /// Returns the box around everything in the tree
+  const AABB& getBounds() const;
+
+  /// Visits every primitive whose box is hit by the ray `from + t * dir`, for t
+  /// in [0, maxFraction], roughly nearest first. This calls
+  /// `visitor(std::size_t primitive, s_t& maxFraction)`, which can shorten the
+  /// ray (for closest-hit queries) by lowering maxFraction.
+  template <typename Visitor>
+  void raycast(
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& dir,
+      s_t maxFraction,
+      Visitor&& visitor) const;
+
+  /// Visits every primitive whose box is within `maxDistance` of `box`,
+  /// roughly nearest first. This calls
+  /// `visitor(std::size_t primitive, s_t& maxDistance)`, which can shrink the
+  /// search radius by lowering maxDistance.
+  template <typename Visitor>
+  void query(const AABB& box, s_t maxDistance, Visitor&& visitor) const;
+
+  /// Returns true if the ray `from + t * dir` enters `box` for some t in
+  /// [0, maxFraction], and if so sets `entry` to the first such t.
+  /// Components of `dir` that are exactly zero are handled separately, so
+  /// rays parallel to a face don't produce NaNs.
+  static bool intersectRay(
+      const AABB& box,
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& dir,
+      const Eigen::Vector3s& invDir,
+      s_t maxFraction,
+      s_t& entry);
+
+protected:
+  struct Node
+  {
+    /// The box around everything under this node
+    AABB box;
+
+    /// For internal nodes, the index of the second child. The first child is
+    /// always the next node.
+    std::size_t secondChild;
+
+    /// For leaves, the first entry of mPrimitives in this leaf
+    std::size_t first;
+
+    /// For leaves, the number of primitives in this leaf. Zero for internal
+    /// nodes.
+    std::size_t count;
+  };
+
+  /// Builds the subtree over mPrimitives[begin, end), and returns its index
+  std::size_t buildNode(
+      const std::vector<AABB>& boxes,
+      const std::vector<Eigen::Vector3s>& centers,
+      std::size_t begin,
+      std::size_t end);
+
+  std::vector<Node> mNodes;
+
+  /// Primitive indices, ordered so that every leaf is a contiguous range
+  std::vector<std::size_t> mPrimitives;
+};
+
+//==============================================================================
+template <typename Visitor>
+void DARTBVH::raycast(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t maxFraction,
+    Visitor&& visitor) const
+{
+  if (mNodes.empty())
+    return;
+
+  const Eigen::Vector3s invDir = dir.cwiseInverse();
+
+  s_t entry;
+  if (!intersectRay(mNodes[0].box, from, dir, invDir, maxFraction, entry))
+    return;
+
+  // (node, entry fraction) pairs still to visit
+  std::vector<std::pair<std::size_t, s_t>> stack;
+  stack.reserve(64);
+  stack.emplace_back(0u, entry);
+
+  while (!stack.empty())
+  {
+    const auto top = stack.back();
+    stack.pop_back();
+
+    // The ray may have been shortened since this node was pushed
+    if (top.second > maxFraction)
+      continue;
+
+    const Node& node = mNodes[top.first];
+    if (node.count > 0)
+    {
+      for (std::size_t i = node.first; i < node.first + node.count; ++i)
+        visitor(mPrimitives[i], maxFraction);
+      continue;
+    }
+
+    const std::size_t a = top.first + 1;
+    const std::size_t b = node.secondChild;
+    s_t entryA;
+    s_t entryB;
+    const bool hitA
+        = intersectRay(mNodes[a].box, from, dir, invDir, maxFraction, entryA);
+    const bool hitB
+        = intersectRay(mNodes[b].box, from, dir, invDir, maxFraction, entryB);
+
+    // Push the farther child first, so the nearer one is visited first
+    if (hitA && hitB)
+    {
+      if (entryA <= entryB)
+      {
+        stack.emplace_back(b, entryB);
+        stack.emplace_back(a, entryA);
+      }
+      else
+      {
+        stack.emplace_back(a, entryA);
+        stack.emplace_back(b, entryB);
+      }
+    }
+    else if (hitA)
+    {
+      stack.emplace_back(a, entryA);
+    }
+    else if (hitB)
+    {
+      stack.emplace_back(b, entryB);
+    }
+  }
+}
+
+//==============================================================================
+template <typename Visitor>
+void DARTBVH::query(const AABB& box, s_t maxDistance, Visitor&& visitor) const
+{
+  if (mNodes.empty())
+    return;
+
+  // (node, distance to node) pairs still to visit
+  std::vector<std::pair<std::size_t, s_t>> stack;
+  stack.reserve(64);
+  stack.emplace_back(0u, mNodes[0].box.exteriorDistance(box));
+
+  while (!stack.empty())
+  {
+    const auto top = stack.back();
+    stack.pop_back();
+
+    if (top.second > maxDistance)
+      continue;
+
+    const Node& node = mNodes[top.first];
+    if (node.count > 0)
+    {
+      for (std::size_t i = node.first; i < node.first + node.count; ++i)
+        visitor(mPrimitives[i], maxDistance);
+      continue;
+    }
+
+    const std::size_t a = top.first + 1;
+    const std::size_t b = node.secondChild;
+    const s_t distanceA = mNodes[a].box.exteriorDistance(box);
+    const s_t distanceB = mNodes[b].box.exteriorDistance(box);
+
+    if (distanceA <= distanceB)
+    {
+      stack.emplace_back(b, distanceB);
+      stack.emplace_back(a, distanceA);
+    }
+    else
+    {
+      stack.emplace_back(a, distanceA);
+      stack.emplace_back(b, distanceB);
+    }
+  }
+}
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTBVH_HPP_
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTBatchedNarrowphase.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "dart/collision/CollisionObject.hpp"
+#include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/CapsuleShape.hpp"
+#include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
+#include "dart/dynamics/PlaneShape.hpp"
+#include "dart/dynamics/SphereShape.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// Slack added to every overlap test, so that pairs that are exactly touching
+/// (or within round-off of touching) still go to the exact routines
+constexpr s_t kCullMargin = 1e-6;
+
+} // anonymous namespace
+
+//==============================================================================
+void DARTBatchedNarrowphase::clear()
+{
+  mObjects.clear();
+  clearPairs();
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::clearPairs()
+{
+  mPairs.clear();
+  for (auto& kernelPairs : mKernelPairs)
+    kernelPairs.clear();
+  mNumCulled = 0;
+}
+
+//==============================================================================
+std::size_t DARTBatchedNarrowphase::addObject(CollisionObject* object)
+{
+  const auto& shape = object->getShape();
+  const auto& shapeType = shape->getType();
+  const Eigen::Isometry3s& T = object->getTransform();
+
+  ObjectData data;
+  data.object = object;
+  data.kind = BOUNDED;
+  data.center = T.translation();
+
+  if (dynamics::PlaneShape::getStaticType() == shapeType
+      || dynamics::HeightmapShapef::getStaticType() == shapeType
+      || dynamics::HeightmapShaped::getStaticType() == shapeType)
+  {
+    data.kind = UNBOUNDED;
+  }
+  else if (dynamics::SphereShape::getStaticType() == shapeType)
+  {
+    const auto* sphere = static_cast<const dynamics::SphereShape*>(shape.get());
+    data.kind = SPHERE;
+    data.radius = sphere->getRadius();
+    data.boundingRadius = data.radius;
+  }
+  else if (dynamics::EllipsoidShape::getStaticType() == shapeType)
+  {
+    // DARTCollide treats every ellipsoid as a sphere of radius radii[0], but
+    // the bounding radius has to cover the real shape for the pairs that go
+    // through the bounding sphere test instead.
+    const auto* ellipsoid
+        = static_cast<const dynamics::EllipsoidShape*>(shape.get());
+    data.kind = SPHERE;
+    data.radius = ellipsoid->getRadii()[0];
+    data.boundingRadius
+        = std::max(data.radius, ellipsoid->getRadii().maxCoeff());
+  }
+  else if (dynamics::BoxShape::getStaticType() == shapeType)
+  {
+    const auto* box = static_cast<const dynamics::BoxShape*>(shape.get());
+    data.kind = BOX;
+    data.boxRotation = T.linear();
+    data.boxHalfSize = box->getSize() * 0.5;
+    data.radius = data.boxHalfSize.norm();
+    data.boundingRadius = data.radius;
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == shapeType)
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(shape.get());
+    const s_t halfHeight = capsule->getHeight() * 0.5;
+    data.kind = CAPSULE;
+    data.capsuleA = T * (Eigen::Vector3s::UnitZ() * -halfHeight);
+    data.capsuleB = T * (Eigen::Vector3s::UnitZ() * halfHeight);
+    data.radius = capsule->getRadius();
+    data.boundingRadius = halfHeight + data.radius;
+  }
+  else
+  {
+    const math::BoundingBox& box = shape->getBoundingBox();
+    data.center = T * box.computeCenter();
+    data.radius = box.computeHalfExtents().norm();
+    data.boundingRadius = data.radius;
+  }
+
+  if (!std::isfinite(data.boundingRadius) || !data.center.allFinite())
+    data.kind = UNBOUNDED;
+
+  mObjects.push_back(data);
+
+  return mObjects.size() - 1u;
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::addPair(std::size_t object1, std::size_t object2)
+{
+  assert(object1 < mObjects.size());
+  assert(object2 < mObjects.size());
+
+  PairData pair;
+  pair.object1 = object1;
+  pair.object2 = object2;
+  pair.kernel = KERNEL_NONE;
+  pair.row = 0u;
+  pair.mayCollide = true;
+
+  const ObjectKind kind1 = mObjects[object1].kind;
+  const ObjectKind kind2 = mObjects[object2].kind;
+
+  if (kind1 != UNBOUNDED && kind2 != UNBOUNDED)
+  {
+    if (kind1 == SPHERE && kind2 == BOX)
+      pair.kernel = KERNEL_SPHERE_BOX;
+    else if (kind1 == BOX && kind2 == SPHERE)
+      pair.kernel = KERNEL_SPHERE_BOX;
+    else if (kind1 == SPHERE && kind2 == CAPSULE)
+      pair.kernel = KERNEL_SPHERE_CAPSULE;
+    else if (kind1 == CAPSULE && kind2 == SPHERE)
+      pair.kernel = KERNEL_SPHERE_CAPSULE;
+    else
+      pair.kernel = KERNEL_SPHERES;
+  }
+
+  if (pair.kernel != KERNEL_NONE)
+  {
+    pair.row = mKernelPairs[pair.kernel].size();
+    mKernelPairs[pair.kernel].push_back(mPairs.size());
+  }
+
+  mPairs.push_back(pair);
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::cull()
+{
+  mNumCulled = 0;
+
+  cullSpheres();
+  cullSphereBoxes();
+  cullSphereCapsules();
+
+  for (const auto& pair : mPairs)
+  {
+    if (!pair.mayCollide)
+      ++mNumCulled;
+  }
+}
+
+//==============================================================================
+std::size_t DARTBatchedNarrowphase::getNumPairs() const
+{
+  return mPairs.size();
+}
+
+//==============================================================================
+CollisionObject* DARTBatchedNarrowphase::getFirstObject(std::size_t i) const
+{
+  return mObjects[mPairs[i].object1].object;
+}
+
+//==============================================================================
+CollisionObject* DARTBatchedNarrowphase::getSecondObject(std::size_t i) const
+{
+  return mObjects[mPairs[i].object2].object;
+}
+
+//==============================================================================
+bool DARTBatchedNarrowphase::mayCollide(std::size_t i) const
+{
+  return mPairs[i].mayCollide;
+}
+
+//==============================================================================
+std::size_t DARTBatchedNarrowphase::getNumCulledPairs() const
+{
+  return mNumCulled;
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::cullSpheres()
+{
+  const auto& pairs = mKernelPairs[KERNEL_SPHERES];
+  const auto n = static_cast<Eigen::Index>(pairs.size());
+  if (n == 0)
+    return;
+
+  auto& data = mKernelData[KERNEL_SPHERES];
+  data.resize(n, 8);
+
+  // Gather. Exact spheres use their own radius, everything else its bounding
+  // sphere.
+  for (Eigen::Index k = 0; k < n; ++k)
+  {
+    const PairData& pair = mPairs[pairs[k]];
+    const ObjectData& o1 = mObjects[pair.object1];
+    const ObjectData& o2 = mObjects[pair.object2];
+    const bool spheres = o1.kind == SPHERE && o2.kind == SPHERE;
+
+    data.block<1, 3>(k, 0) = o1.center.transpose();
+    data(k, 3) = spheres ? o1.radius : o1.boundingRadius;
+    data.block<1, 3>(k, 4) = o2.center.transpose();
+    data(k, 7) = spheres ? o2.radius : o2.boundingRadius;
+  }
+
+  // Kernel
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> distSq
+      = (data.col(0) - data.col(4)).square()
+        + (data.col(1) - data.col(5)).square()
+        + (data.col(2) - data.col(6)).square();
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> reach
+      = data.col(3) + data.col(7) + kCullMargin;
+
+  // Scatter
+  for (Eigen::Index k = 0; k < n; ++k)
+    mPairs[pairs[k]].mayCollide = distSq(k) <= reach(k) * reach(k);
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::cullSphereBoxes()
+{
+  const auto& pairs = mKernelPairs[KERNEL_SPHERE_BOX];
+  const auto n = static_cast<Eigen::Index>(pairs.size());
+  if (n == 0)
+    return;
+
+  auto& data = mKernelData[KERNEL_SPHERE_BOX];
+  data.resize(n, 19);
+
+  // Gather
+  for (Eigen::Index k = 0; k < n; ++k)
+  {
+    const PairData& pair = mPairs[pairs[k]];
+    const bool sphereFirst = mObjects[pair.object1].kind == SPHERE;
+    const ObjectData& sphere
+        = mObjects[sphereFirst ? pair.object1 : pair.object2];
+    const ObjectData& box = mObjects[sphereFirst ? pair.object2 : pair.object1];
+
+    data.block<1, 3>(k, 0) = sphere.center.transpose();
+    data(k, 3) = sphere.radius;
+    data.block<1, 3>(k, 4) = box.center.transpose();
+    for (int c = 0; c < 3; ++c)
+      data.block<1, 3>(k, 7 + 3 * c) = box.boxRotation.col(c).transpose();
+    data.block<1, 3>(k, 16) = box.boxHalfSize.transpose();
+  }
+
+  // Kernel: express the sphere center in the box frame, then measure how far
+  // it sits outside the box along each axis.
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> dx = data.col(0) - data.col(4);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> dy = data.col(1) - data.col(5);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> dz = data.col(2) - data.col(6);
+
+  Eigen::Array<s_t, Eigen::Dynamic, 1> distSq
+      = Eigen::Array<s_t, Eigen::Dynamic, 1>::Zero(n);
+  for (int c = 0; c < 3; ++c)
+  {
+    const int axis = 7 + 3 * c;
+    const Eigen::Array<s_t, Eigen::Dynamic, 1> local
+        = data.col(axis) * dx + data.col(axis + 1) * dy
+          + data.col(axis + 2) * dz;
+    const Eigen::Array<s_t, Eigen::Dynamic, 1> excess
+        = (local.abs() - data.col(16 + c)).max(s_t(0));
+    distSq += excess.square();
+  }
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> reach = data.col(3) + kCullMargin;
+
+  // Scatter
+  for (Eigen::Index k = 0; k < n; ++k)
+    mPairs[pairs[k]].mayCollide = distSq(k) <= reach(k) * reach(k);
+}
+
+//==============================================================================
+void DARTBatchedNarrowphase::cullSphereCapsules()
+{
+  const auto& pairs = mKernelPairs[KERNEL_SPHERE_CAPSULE];
+  const auto n = static_cast<Eigen::Index>(pairs.size());
+  if (n == 0)
+    return;
+
+  auto& data = mKernelData[KERNEL_SPHERE_CAPSULE];
+  data.resize(n, 11);
+
+  // Gather
+  for (Eigen::Index k = 0; k < n; ++k)
+  {
+    const PairData& pair = mPairs[pairs[k]];
+    const bool sphereFirst = mObjects[pair.object1].kind == SPHERE;
+    const ObjectData& sphere
+        = mObjects[sphereFirst ? pair.object1 : pair.object2];
+    const ObjectData& capsule
+        = mObjects[sphereFirst ? pair.object2 : pair.object1];
+
+    data.block<1, 3>(k, 0) = sphere.center.transpose();
+    data(k, 3) = sphere.radius;
+    data.block<1, 3>(k, 4) = capsule.capsuleA.transpose();
+    data.block<1, 3>(k, 7) = capsule.capsuleB.transpose();
+    data(k, 10) = capsule.radius;
+  }
+
+  // Kernel: distance from the sphere center to the capsule's segment
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> ux = data.col(7) - data.col(4);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> uy = data.col(8) - data.col(5);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> uz = data.col(9) - data.col(6);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> px = data.col(0) - data.col(4);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> py = data.col(1) - data.col(5);
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> pz = data.col(2) - data.col(6);
+
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> lengthSq
+      = (ux.square() + uy.square() + uz.square()).max(s_t(1e-20));
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> t
+      = ((px * ux + py * uy + pz * uz) / lengthSq).max(s_t(0)).min(s_t(1));
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> distSq
+      = (px - t * ux).square() + (py - t * uy).square()
+        + (pz - t * uz).square();
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> reach
+      = data.col(3) + data.col(10) + kCullMargin;
+
+  // Scatter
+  for (Eigen::Index k = 0; k < n; ++k)
+    mPairs[pairs[k]].mayCollide = distSq(k) <= reach(k) * reach(k);
+}
+
+} // namespace collision
+} // namespace dart
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTBATCHEDNARROWPHASE_HPP_
+#define DART_COLLISION_DART_DARTBATCHEDNARROWPHASE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+class CollisionObject;
+
+/// This culls candidate pairs for DARTCollisionDetector in bulk, before they
+/// go through the exact (and much more expensive) per-pair routines in
+/// DARTCollide.
+///
+/// Every object is classified once when it's added, rather than once per pair.
+/// Candidate pairs are then bucketed by shape-type combination (sphere-sphere,
+/// sphere-box, sphere-capsule, and bounding spheres for everything else with
+/// finite extent), and each bucket is laid out as structure-of-arrays so the
+/// overlap tests vectorize. The tests are conservative, so the set of pairs
+/// that produce contacts (and the contacts themselves, which still come from
+/// the exact routines) is unchanged.
+class DARTBatchedNarrowphase
+{
+public:
+  /// The number of pairs it's worth accumulating before running the kernels.
+  /// Callers flush in chunks of this size to bound memory.
+  static constexpr std::size_t CHUNK_SIZE = 4096;
+
+  /// Removes all the objects and pairs
+  void clear();
+
+  /// Removes all the pairs, but keeps the objects
+  void clearPairs();
+
+  /// Classifies an object, and returns the index to refer to it by in
+  /// addPair()
+  std::size_t addObject(CollisionObject* object);
+
+  /// Adds a candidate pair, using the indices returned from addObject()
+  void addPair(std::size_t object1, std::size_t object2);
+
+  /// Runs the overlap kernels over all the candidate pairs added since the
+  /// last clearPairs()
+  void cull();
+
+  /// Returns the number of candidate pairs
+  std::size_t getNumPairs() const;
+
+  /// Returns the first object of pair `i`
+  CollisionObject* getFirstObject(std::size_t i) const;
+
+  /// Returns the second object of pair `i`
+  CollisionObject* getSecondObject(std::size_t i) const;
+
+  /// After cull(), this returns false if pair `i` definitely doesn't collide
+  bool mayCollide(std::size_t i) const;
+
+  /// Returns the number of pairs that cull() ruled out
+  std::size_t getNumCulledPairs() const;
+
+protected:
+  /// How an object takes part in the overlap tests
+  enum ObjectKind
+  {
+    /// A sphere (or an ellipsoid, which DARTCollide treats as a sphere)
+    SPHERE = 0,
+    BOX = 1,
+    CAPSULE = 2,
+    /// Anything else with a finite bounding box
+    BOUNDED = 3,
+    /// Planes, heightmaps, etc, that always go to the exact routines
+    UNBOUNDED = 4
+  };
+
+  /// Which kernel is responsible for a pair
+  enum PairKernel
+  {
+    KERNEL_SPHERES = 0,
+    KERNEL_SPHERE_BOX = 1,
+    KERNEL_SPHERE_CAPSULE = 2,
+    KERNEL_NONE = 3
+  };
+
+  struct ObjectData
+  {
+    CollisionObject* object;
+    ObjectKind kind;
+    /// The center of the sphere, or the bounding sphere of anything else
+    Eigen::Vector3s center;
+    /// The radius of the sphere or capsule. For boxes and bounded objects,
+    /// this is the radius of the bounding sphere.
+    s_t radius;
+    /// The radius of a sphere around `center` that contains the whole object
+    s_t boundingRadius;
+    /// Capsule endpoints
+    Eigen::Vector3s capsuleA;
+    Eigen::Vector3s capsuleB;
+    /// Box frame and half-extents
+    Eigen::Matrix3s boxRotation;
+    Eigen::Vector3s boxHalfSize;
+  };
+
+  struct PairData
+  {
+    std::size_t object1;
+    std::size_t object2;
+    PairKernel kernel;
+    /// The row of this pair in its kernel's SoA block
+    std::size_t row;
+    bool mayCollide;
+  };
+
+  /// Overlap of two spheres: columns are (x1, y1, z1, r1, x2, y2, z2, r2)
+  void cullSpheres();
+
+  /// Overlap of a sphere and a box: columns are (x, y, z, r, tx, ty, tz, the
+  /// 9 entries of the box rotation in column-major order, hx, hy, hz)
+  void cullSphereBoxes();
+
+  /// Overlap of a sphere and a capsule: columns are (x, y, z, r, ax, ay, az,
+  /// bx, by, bz, capsule radius)
+  void cullSphereCapsules();
+
+  std::vector<ObjectData> mObjects;
+  std::vector<PairData> mPairs;
+
+  /// The pairs for each kernel, as indices into mPairs
+  std::vector<std::size_t> mKernelPairs[KERNEL_NONE];
+
+  /// The structure-of-arrays block for each kernel, one row per pair
+  Eigen::Array<s_t, Eigen::Dynamic, Eigen::Dynamic> mKernelData[KERNEL_NONE];
+
+  std::size_t mNumCulled = 0;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTBATCHEDNARROWPHASE_HPP_
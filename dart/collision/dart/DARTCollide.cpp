@@ -32,7 +32,11 @@
 
 #include "dart/collision/dart/DARTCollide.hpp"
 
+#include <array>
+#include <limits>
+#include <map>
 #include <memory>
+#include <set>
 #include <thread>
 
 #include "dart/collision/CollisionObject.hpp"
@@ -41,7 +45,9 @@
 #include "dart/dynamics/CapsuleShape.hpp"
 #include "dart/dynamics/CylinderShape.hpp"
 #include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
 #include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/PlaneShape.hpp"
 #include "dart/dynamics/SphereShape.hpp"
 #include "dart/math/Geometry.hpp"
 #include "dart/math/Helpers.hpp"
@@ -4903,8 +4909,8 @@ int collideCylinderSphere(
     const Eigen::Isometry3s& T0,
     const s_t& sphere_rad,
     const Eigen::Isometry3s& T1,
-    CollisionResult& result,
     const CollisionOption& /* option */,
+    CollisionResult& result,
     ClipSphereHalfspace /* halfspace */)
 {
   Eigen::Vector3s center = T0.inverse() * T1.translation();
@@ -4921,9 +4927,13 @@ int collideCylinderSphere(
     contact.point
         = T0
           * Eigen::Vector3s(
-              center[0], center[1], half_height - contact.penetrationDepth);
+              center[0],
+              center[1],
+              math::sign(center[2])
+                  * (half_height - contact.penetrationDepth));
+    // The normal points from the sphere (o2) back into the cylinder (o1)
     contact.normal
-        = T0.linear() * Eigen::Vector3s(0.0, 0.0, math::sign(center[2]));
+        = T0.linear() * Eigen::Vector3s(0.0, 0.0, -math::sign(center[2]));
     result.addContact(contact);
     return 1;
   }
@@ -4978,89 +4988,1793 @@ int collideCylinderSphere(
   return 0;
 }
 
-int collideCylinderPlane(
+int collideCylinderPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& cyl_rad,
+    const s_t& half_height,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& plane_normal,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& /* option */,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = T1.linear() * plane_normal;
+  Eigen::Vector3s Rx = T0.linear().rightCols(1);
+  Eigen::Vector3s Ry = normal - normal.dot(Rx) * Rx;
+  s_t mag = Ry.norm();
+  Ry.normalize();
+  if (mag < DART_COLLISION_EPS)
+  {
+    if (abs(Rx[2]) > 1.0 - DART_COLLISION_EPS)
+      Ry = Eigen::Vector3s::UnitX();
+    else
+      Ry = (Eigen::Vector3s(Rx[1], -Rx[0], 0.0)).normalized();
+  }
+
+  Eigen::Vector3s Rz = Rx.cross(Ry);
+  Eigen::Isometry3s T;
+  T.linear().col(0) = Rx;
+  T.linear().col(1) = Ry;
+  T.linear().col(2) = Rz;
+  T.translation() = T0.translation();
+
+  Eigen::Vector3s nn = T.linear().transpose() * normal;
+  Eigen::Vector3s pn = T.inverse() * T1.translation();
+
+  // four corners c0 = ( -h/2, -r ), c1 = ( +h/2, -r ), c2 = ( +h/2, +r ), c3
+  // = ( -h/2, +r )
+  Eigen::Vector3s c[4]
+      = {Eigen::Vector3s(-half_height, -cyl_rad, 0.0),
+         Eigen::Vector3s(+half_height, -cyl_rad, 0.0),
+         Eigen::Vector3s(+half_height, +cyl_rad, 0.0),
+         Eigen::Vector3s(-half_height, +cyl_rad, 0.0)};
+
+  s_t depth[4]
+      = {(pn - c[0]).dot(nn),
+         (pn - c[1]).dot(nn),
+         (pn - c[2]).dot(nn),
+         (pn - c[3]).dot(nn)};
+
+  s_t penetration = -1.0;
+  int found = -1;
+  for (int i = 0; i < 4; i++)
+  {
+    if (depth[i] > penetration)
+    {
+      penetration = depth[i];
+      found = i;
+    }
+  }
+
+  Eigen::Vector3s point;
+
+  if (abs(depth[found] - depth[(found + 1) % 4]) < DART_COLLISION_EPS)
+    point = T * (0.5 * (c[found] + c[(found + 1) % 4]));
+  else if (abs(depth[found] - depth[(found + 3) % 4]) < DART_COLLISION_EPS)
+    point = T * (0.5 * (c[found] + c[(found + 3) % 4]));
+  else
+    point = T * c[found];
+
+  if (penetration > 0.0)
+  {
+    Contact contact;
+    contact.collisionObject1 = o1;
+    contact.collisionObject2 = o2;
+    contact.point = point;
+    contact.normal = normal;
+    contact.penetrationDepth = penetration;
+    result.addContact(contact);
+    return 1;
+  }
+
+  return 0;
+}
+
+//==============================================================================
+int collideSphereCylinder(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& sphere_rad,
+    const Eigen::Isometry3s& T0,
+    const s_t& cyl_rad,
+    const s_t& half_height,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionResult flipped;
+  int numContacts = collideCylinderSphere(
+      o2, o1, cyl_rad, half_height, T1, sphere_rad, T0, option, flipped);
+  for (Contact contact : flipped.getContacts())
+  {
+    contact.collisionObject1 = o1;
+    contact.collisionObject2 = o2;
+    contact.normal *= -1;
+    result.addContact(contact);
+  }
+  return numContacts;
+}
+
+//==============================================================================
+int collidePlaneCylinder(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& plane_normal,
+    const Eigen::Isometry3s& T0,
+    const s_t& cyl_rad,
+    const s_t& half_height,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionResult flipped;
+  int numContacts = collideCylinderPlane(
+      o2, o1, cyl_rad, half_height, T1, plane_normal, T0, option, flipped);
+  for (Contact contact : flipped.getContacts())
+  {
+    contact.collisionObject1 = o1;
+    contact.collisionObject2 = o2;
+    contact.normal *= -1;
+    result.addContact(contact);
+  }
+  return numContacts;
+}
+
+namespace {
+
+//==============================================================================
+/// This calls `visitor` with every vertex of the mesh, in the world frame.
+template <typename Visitor>
+void forEachMeshVertex(
+    const aiScene* mesh,
+    const Eigen::Vector3s& scale,
+    const Eigen::Isometry3s& T,
+    Visitor visitor)
+{
+  for (int i = 0; i < mesh->mNumMeshes; i++)
+  {
+    aiMesh* m = mesh->mMeshes[i];
+    for (int k = 0; k < m->mNumVertices; k++)
+    {
+      Eigen::Vector3s vertex(
+          m->mVertices[k].x * scale(0),
+          m->mVertices[k].y * scale(1),
+          m->mVertices[k].z * scale(2));
+      visitor(T * vertex);
+    }
+  }
+}
+
+//==============================================================================
+/// This calls `visitor` with every corner of the box, in the world frame.
+template <typename Visitor>
+void forEachBoxVertex(
+    const Eigen::Vector3s& size, const Eigen::Isometry3s& T, Visitor visitor)
+{
+  for (int i = 0; i < 8; i++)
+  {
+    Eigen::Vector3s corner(
+        (i & 1) ? 0.5 * size(0) : -0.5 * size(0),
+        (i & 2) ? 0.5 * size(1) : -0.5 * size(1),
+        (i & 4) ? 0.5 * size(2) : -0.5 * size(2));
+    visitor(T * corner);
+  }
+}
+
+//==============================================================================
+/// This creates a contact between a vertex and a face, with the face normal
+/// `faceNormal` (in world space, pointing out of the solid side of the face).
+/// If `vertexIsA` is true, this is a VERTEX_FACE contact, otherwise it's a
+/// FACE_VERTEX contact.
+int createVertexFaceContact(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& vertex,
+    const Eigen::Vector3s& faceNormal,
+    s_t depth,
+    bool vertexIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  if (depth <= 0 || depth > option.contactClippingDepth)
+    return 0;
+
+  Contact contact;
+  contact.collisionObject1 = o1;
+  contact.collisionObject2 = o2;
+  contact.point = vertex;
+  contact.penetrationDepth = depth;
+  if (vertexIsA)
+  {
+    contact.normal = faceNormal;
+    contact.type = VERTEX_FACE;
+  }
+  else
+  {
+    contact.normal = -faceNormal;
+    contact.type = FACE_VERTEX;
+  }
+  result.addContact(contact);
+  return 1;
+}
+
+//==============================================================================
+/// This creates the contacts between a sphere and a face with the given
+/// outward normal and a point on the face. If `sphereIsA` is true, this is a
+/// SPHERE_FACE contact, otherwise it's a FACE_SPHERE contact.
+int createSphereFaceContact(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& sphereCenter,
+    s_t sphereRadius,
+    const Eigen::Vector3s& faceNormal,
+    const Eigen::Vector3s& facePoint,
+    bool sphereIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  s_t depth = sphereRadius - faceNormal.dot(sphereCenter - facePoint);
+  if (depth <= 0 || depth > option.contactClippingDepth)
+    return 0;
+
+  Contact contact;
+  contact.collisionObject1 = o1;
+  contact.collisionObject2 = o2;
+  contact.point = sphereCenter - faceNormal * sphereRadius;
+  contact.sphereCenter = sphereCenter;
+  contact.sphereRadius = sphereRadius;
+  contact.penetrationDepth = depth;
+  if (sphereIsA)
+  {
+    contact.normal = faceNormal;
+    contact.type = SPHERE_FACE;
+  }
+  else
+  {
+    contact.normal = -faceNormal;
+    contact.type = FACE_SPHERE;
+  }
+  result.addContact(contact);
+  return 1;
+}
+
+//==============================================================================
+/// This collides a sphere with a plane, from either side of the pair.
+int collideSpherePlaneImpl(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t radius,
+    const Eigen::Isometry3s& sphereT,
+    const Eigen::Vector3s& planeNormal,
+    s_t planeOffset,
+    const Eigen::Isometry3s& planeT,
+    bool sphereIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = planeT.linear() * planeNormal;
+  Eigen::Vector3s planePoint = planeT * (planeNormal * planeOffset);
+  return createSphereFaceContact(
+      o1,
+      o2,
+      sphereT.translation(),
+      radius,
+      normal,
+      planePoint,
+      sphereIsA,
+      option,
+      result);
+}
+
+} // anonymous namespace
+
+//==============================================================================
+int collideSpherePlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideSpherePlaneImpl(
+      o1, o2, r0, T0, normal1, offset1, T1, true, option, result);
+}
+
+//==============================================================================
+int collidePlaneSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideSpherePlaneImpl(
+      o1, o2, r1, T1, normal0, offset0, T0, false, option, result);
+}
+
+//==============================================================================
+int collideBoxPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = T1.linear() * normal1;
+  Eigen::Vector3s planePoint = T1 * (normal1 * offset1);
+  int numContacts = 0;
+  forEachBoxVertex(size0, T0, [&](const Eigen::Vector3s& vertex) {
+    numContacts += createVertexFaceContact(
+        o1,
+        o2,
+        vertex,
+        normal,
+        normal.dot(planePoint - vertex),
+        true,
+        option,
+        result);
+  });
+  return numContacts;
+}
+
+//==============================================================================
+int collidePlaneBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = T0.linear() * normal0;
+  Eigen::Vector3s planePoint = T0 * (normal0 * offset0);
+  int numContacts = 0;
+  forEachBoxVertex(size1, T1, [&](const Eigen::Vector3s& vertex) {
+    numContacts += createVertexFaceContact(
+        o1,
+        o2,
+        vertex,
+        normal,
+        normal.dot(planePoint - vertex),
+        false,
+        option,
+        result);
+  });
+  return numContacts;
+}
+
+//==============================================================================
+int collideMeshPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = T1.linear() * normal1;
+  Eigen::Vector3s planePoint = T1 * (normal1 * offset1);
+  int numContacts = 0;
+  forEachMeshVertex(mesh0, size0, T0, [&](const Eigen::Vector3s& vertex) {
+    numContacts += createVertexFaceContact(
+        o1,
+        o2,
+        vertex,
+        normal,
+        normal.dot(planePoint - vertex),
+        true,
+        option,
+        result);
+  });
+  return numContacts;
+}
+
+//==============================================================================
+int collidePlaneMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Vector3s normal = T0.linear() * normal0;
+  Eigen::Vector3s planePoint = T0 * (normal0 * offset0);
+  int numContacts = 0;
+  forEachMeshVertex(mesh1, size1, T1, [&](const Eigen::Vector3s& vertex) {
+    numContacts += createVertexFaceContact(
+        o1,
+        o2,
+        vertex,
+        normal,
+        normal.dot(planePoint - vertex),
+        false,
+        option,
+        result);
+  });
+  return numContacts;
+}
+
+//==============================================================================
+int collideCapsulePlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  // A capsule can only ever touch a plane with its end spheres (or both, if
+  // it's lying flat)
+  Eigen::Isometry3s top = T0;
+  top.translate(Eigen::Vector3s(0, 0, height0 / 2));
+  Eigen::Isometry3s bottom = T0;
+  bottom.translate(Eigen::Vector3s(0, 0, -height0 / 2));
+  return collideSpherePlaneImpl(
+             o1, o2, radius0, top, normal1, offset1, T1, true, option, result)
+         + collideSpherePlaneImpl(
+             o1,
+             o2,
+             radius0,
+             bottom,
+             normal1,
+             offset1,
+             T1,
+             true,
+             option,
+             result);
+}
+
+//==============================================================================
+int collidePlaneCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  Eigen::Isometry3s top = T1;
+  top.translate(Eigen::Vector3s(0, 0, height1 / 2));
+  Eigen::Isometry3s bottom = T1;
+  bottom.translate(Eigen::Vector3s(0, 0, -height1 / 2));
+  return collideSpherePlaneImpl(
+             o1, o2, radius1, top, normal0, offset0, T0, false, option, result)
+         + collideSpherePlaneImpl(
+             o1,
+             o2,
+             radius1,
+             bottom,
+             normal0,
+             offset0,
+             T0,
+             false,
+             option,
+             result);
+}
+
+namespace {
+
+//==============================================================================
+/// This finds the closest point on the triangle (a, b, c) to p, following
+/// Ericson's "Real-Time Collision Detection" (section 5.1.5). The feature of
+/// the triangle that the closest point lies on is written to `mask`, as a
+/// bitmask of the triangle vertices: one bit set for a vertex, two for an
+/// edge, and all three for the face.
+Eigen::Vector3s closestPointOnTriangle(
+    const Eigen::Vector3s& p,
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    const Eigen::Vector3s& c,
+    int* mask)
+{
+  Eigen::Vector3s ab = b - a;
+  Eigen::Vector3s ac = c - a;
+  Eigen::Vector3s ap = p - a;
+  s_t d1 = ab.dot(ap);
+  s_t d2 = ac.dot(ap);
+  if (d1 <= 0 && d2 <= 0)
+  {
+    *mask = 1;
+    return a;
+  }
+
+  Eigen::Vector3s bp = p - b;
+  s_t d3 = ab.dot(bp);
+  s_t d4 = ac.dot(bp);
+  if (d3 >= 0 && d4 <= d3)
+  {
+    *mask = 2;
+    return b;
+  }
+
+  s_t vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+  {
+    *mask = 1 | 2;
+    return a + ab * (d1 / (d1 - d3));
+  }
+
+  Eigen::Vector3s cp = p - c;
+  s_t d5 = ab.dot(cp);
+  s_t d6 = ac.dot(cp);
+  if (d6 >= 0 && d5 <= d6)
+  {
+    *mask = 4;
+    return c;
+  }
+
+  s_t vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+  {
+    *mask = 1 | 4;
+    return a + ac * (d2 / (d2 - d6));
+  }
+
+  s_t va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+  {
+    *mask = 2 | 4;
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  }
+
+  *mask = 1 | 2 | 4;
+  s_t denom = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//==============================================================================
+/// This finds the closest pair of points between the segment (p, q) and the
+/// triangle (a, b, c). Returns the distance, and writes the feature of the
+/// triangle the closest point lies on to `mask` (see closestPointOnTriangle()).
+s_t closestSegmentTriangle(
+    const Eigen::Vector3s& p,
+    const Eigen::Vector3s& q,
+    const Eigen::Vector3s* tri,
+    Eigen::Vector3s* segmentPoint,
+    Eigen::Vector3s* trianglePoint,
+    int* mask)
+{
+  // If the segment pierces the triangle, the face is the closest feature
+  Eigen::Vector3s n = (tri[1] - tri[0]).cross(tri[2] - tri[0]);
+  s_t dp = n.dot(p - tri[0]);
+  s_t dq = n.dot(q - tri[0]);
+  if ((dp < 0 && dq > 0) || (dp > 0 && dq < 0))
+  {
+    Eigen::Vector3s hit = p + (q - p) * (dp / (dp - dq));
+    int hitMask;
+    Eigen::Vector3s onTriangle
+        = closestPointOnTriangle(hit, tri[0], tri[1], tri[2], &hitMask);
+    if (hitMask == (1 | 2 | 4))
+    {
+      *segmentPoint = hit;
+      *trianglePoint = onTriangle;
+      *mask = hitMask;
+      return 0;
+    }
+  }
+
+  // Otherwise, the closest point is either at one of the segment endpoints,
+  // or between the segment and one of the triangle edges. We check the
+  // endpoints first, so that ties go to the face.
+  s_t bestDist = std::numeric_limits<s_t>::infinity();
+  const Eigen::Vector3s* endpoints[2] = {&p, &q};
+  for (int i = 0; i < 2; i++)
+  {
+    int endMask;
+    Eigen::Vector3s onTriangle = closestPointOnTriangle(
+        *endpoints[i], tri[0], tri[1], tri[2], &endMask);
+    s_t dist = (*endpoints[i] - onTriangle).norm();
+    if (dist < bestDist)
+    {
+      bestDist = dist;
+      *segmentPoint = *endpoints[i];
+      *trianglePoint = onTriangle;
+      *mask = endMask;
+    }
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    int j = (i + 1) % 3;
+    s_t alpha;
+    s_t beta;
+    dSegmentsClosestApproach(p, tri[i], q, tri[j], &alpha, &beta);
+    Eigen::Vector3s onSegment = p + (q - p) * alpha;
+    Eigen::Vector3s onTriangle = tri[i] + (tri[j] - tri[i]) * beta;
+    s_t dist = (onSegment - onTriangle).norm();
+    if (dist < bestDist)
+    {
+      bestDist = dist;
+      *segmentPoint = onSegment;
+      *trianglePoint = onTriangle;
+      if (beta <= 0)
+        *mask = 1 << i;
+      else if (beta >= 1)
+        *mask = 1 << j;
+      else
+        *mask = (1 << i) | (1 << j);
+    }
+  }
+  return bestDist;
+}
+
+//==============================================================================
+/// This is a read-only view of a heightmap as a grid of triangles. Vertex
+/// (row, col) sits at x = (col - (width-1)/2) * scale.x, y = -(row -
+/// (depth-1)/2) * scale.y, z = height * scale.z, in the frame of the
+/// heightmap. Cell (row, col) is split into the triangles {(row, col), (row+1,
+/// col), (row+1, col+1)} and {(row, col), (row+1, col+1), (row, col+1)}, both
+/// of which have upward facing normals.
+template <typename S>
+class HeightmapGrid
+{
+public:
+  HeightmapGrid(
+      const HeightmapField<S>& heights, const Eigen::Matrix<S, 3, 1>& scale)
+    : mHeights(heights),
+      mScale(scale.template cast<s_t>()),
+      mRowCenter(0.5 * (heights.rows() - 1)),
+      mColCenter(0.5 * (heights.cols() - 1))
+  {
+  }
+
+  /// Returns false if there aren't enough points to form a single cell
+  bool isValid() const
+  {
+    return mHeights.rows() >= 2 && mHeights.cols() >= 2 && mScale(0) > 0
+           && mScale(1) > 0;
+  }
+
+  int getWidth() const
+  {
+    return mHeights.cols();
+  }
+
+  /// Returns the position of a grid vertex in the local heightmap frame
+  Eigen::Vector3s getVertex(int row, int col) const
+  {
+    return Eigen::Vector3s(
+        (col - mColCenter) * mScale(0),
+        -(row - mRowCenter) * mScale(1),
+        static_cast<s_t>(mHeights(row, col)) * mScale(2));
+  }
+
+  /// Returns a unique ID for a grid vertex
+  int getVertexId(int row, int col) const
+  {
+    return row * mHeights.cols() + col;
+  }
+
+  /// This fills in the corners of triangle `tri` (0 or 1) of the cell, and
+  /// the corresponding vertex IDs.
+  void getTriangle(
+      int row, int col, int tri, Eigen::Vector3s* corners, int* ids) const
+  {
+    int rows[3] = {row, row + 1, tri == 0 ? row + 1 : row};
+    int cols[3] = {col, tri == 0 ? col : col + 1, col + 1};
+    for (int i = 0; i < 3; i++)
+    {
+      corners[i] = getVertex(rows[i], cols[i]);
+      ids[i] = getVertexId(rows[i], cols[i]);
+    }
+  }
+
+  /// Returns the maximum height (scaled) of the four corners of a cell
+  s_t getCellMaxHeight(int row, int col) const
+  {
+    S h = std::max(
+        std::max(mHeights(row, col), mHeights(row, col + 1)),
+        std::max(mHeights(row + 1, col), mHeights(row + 1, col + 1)));
+    return static_cast<s_t>(h) * mScale(2);
+  }
+
+  /// This finds the range of cells (inclusive) that overlap the AABB [min,
+  /// max] in the XY plane. Returns false if there are none.
+  bool getCellRange(
+      const Eigen::Vector3s& min,
+      const Eigen::Vector3s& max,
+      int* rowMin,
+      int* rowMax,
+      int* colMin,
+      int* colMax) const
+  {
+    s_t colLow = min(0) / mScale(0) + mColCenter;
+    s_t colHigh = max(0) / mScale(0) + mColCenter;
+    s_t rowLow = mRowCenter - max(1) / mScale(1);
+    s_t rowHigh = mRowCenter - min(1) / mScale(1);
+    int lastRow = mHeights.rows() - 2;
+    int lastCol = mHeights.cols() - 2;
+    if (colHigh < 0 || rowHigh < 0 || colLow > lastCol + 1
+        || rowLow > lastRow + 1)
+      return false;
+    *colMin = std::max(0, static_cast<int>(floor(colLow)));
+    *colMax = std::min(lastCol, static_cast<int>(floor(colHigh)));
+    *rowMin = std::max(0, static_cast<int>(floor(rowLow)));
+    *rowMax = std::min(lastRow, static_cast<int>(floor(rowHigh)));
+    return true;
+  }
+
+  /// This finds the triangle of the grid directly above or below the point
+  /// `p`, and returns the (upward) unit normal and a point on that triangle.
+  /// Returns false if `p` isn't over the grid.
+  bool getTriangleUnder(
+      const Eigen::Vector3s& p,
+      Eigen::Vector3s* normal,
+      Eigen::Vector3s* point) const
+  {
+    s_t colF = p(0) / mScale(0) + mColCenter;
+    s_t rowF = mRowCenter - p(1) / mScale(1);
+    if (colF < 0 || rowF < 0 || colF > mHeights.cols() - 1
+        || rowF > mHeights.rows() - 1)
+      return false;
+    int col = std::min(
+        static_cast<int>(floor(colF)), static_cast<int>(mHeights.cols() - 2));
+    int row = std::min(
+        static_cast<int>(floor(rowF)), static_cast<int>(mHeights.rows() - 2));
+    // Triangle 0 covers the half of the cell below the (row, col) -> (row+1,
+    // col+1) diagonal
+    int tri = (rowF - row >= colF - col) ? 0 : 1;
+    Eigen::Vector3s corners[3];
+    int ids[3];
+    getTriangle(row, col, tri, corners, ids);
+    *normal
+        = (corners[1] - corners[0]).cross(corners[2] - corners[0]).normalized();
+    *point = corners[0];
+    return true;
+  }
+
+private:
+  const HeightmapField<S>& mHeights;
+  Eigen::Vector3s mScale;
+  s_t mRowCenter;
+  s_t mColCenter;
+};
+
+/// This is the closest feature of a single terrain triangle to the query shape
+struct HeightmapFeature
+{
+  /// The triangle this came from, as (cell index * 2 + triangle)
+  int triangle;
+  /// The vertex IDs of the feature, sorted, with unused entries set to -1
+  std::array<int, 3> ids;
+  /// The positions of the feature vertices, in the heightmap frame
+  Eigen::Vector3s points[3];
+  int numPoints;
+  /// The distance from the query shape to the triangle
+  s_t distance;
+  /// False if this triangle shouldn't produce a contact, but still gets a say
+  /// in whether its neighbors do
+  bool valid;
+};
+
+//==============================================================================
+/// This finds the closest feature of every triangle under the AABB [min, max]
+/// (in the heightmap frame) to the query shape, and filters them down to the
+/// set that are local minima of distance over the terrain surface. An edge or
+/// vertex is only kept if every triangle that shares it agrees that it's the
+/// closest feature, so a sphere resting on a triangle only produces a face
+/// contact, and not also edge contacts with its neighbors.
+///
+/// `closest` gets called with the three corners of each triangle, and needs to
+/// return the closest-feature mask (see closestPointOnTriangle()), the
+/// distance to the triangle, and whether the query shape is in front of the
+/// triangle (and so is allowed to make a contact).
+template <typename S, typename ClosestFn>
+std::vector<HeightmapFeature> findHeightmapFeatures(
+    const HeightmapGrid<S>& grid,
+    const Eigen::Vector3s& min,
+    const Eigen::Vector3s& max,
+    ClosestFn closest)
+{
+  std::vector<HeightmapFeature> features;
+  int rowMin, rowMax, colMin, colMax;
+  if (!grid.isValid()
+      || !grid.getCellRange(min, max, &rowMin, &rowMax, &colMin, &colMax))
+    return features;
+
+  // Every triangle in the window reports its closest feature, keyed by sorted
+  // vertex IDs
+  std::map<std::array<int, 3>, std::vector<int>> reports;
+  for (int row = rowMin; row <= rowMax; row++)
+  {
+    for (int col = colMin; col <= colMax; col++)
+    {
+      if (grid.getCellMaxHeight(row, col) < min(2))
+        continue;
+      for (int tri = 0; tri < 2; tri++)
+      {
+        Eigen::Vector3s corners[3];
+        int ids[3];
+        grid.getTriangle(row, col, tri, corners, ids);
+        s_t distance = 0;
+        bool inFront = true;
+        int mask = closest(corners, &distance, &inFront);
+
+        HeightmapFeature feature;
+        feature.triangle = grid.getVertexId(row, col) * 2 + tri;
+        feature.ids = {-1, -1, -1};
+        feature.numPoints = 0;
+        feature.distance = distance;
+        feature.valid = inFront || mask == (1 | 2 | 4);
+        for (int i = 0; i < 3; i++)
+        {
+          if (mask & (1 << i))
+          {
+            feature.ids[feature.numPoints] = ids[i];
+            feature.points[feature.numPoints] = corners[i];
+            feature.numPoints++;
+          }
+        }
+        std::sort(feature.ids.begin(), feature.ids.begin() + feature.numPoints);
+        reports[feature.ids].push_back(feature.triangle);
+        features.push_back(feature);
+      }
+    }
+  }
+
+  // Count how many of the visited triangles contain each vertex, so we can
+  // check whether all of the neighbors of an edge or vertex agreed on it
+  std::map<int, int> trianglesWithVertex;
+  std::map<std::pair<int, int>, int> trianglesWithEdge;
+  for (int row = rowMin; row <= rowMax; row++)
+  {
+    for (int col = colMin; col <= colMax; col++)
+    {
+      if (grid.getCellMaxHeight(row, col) < min(2))
+        continue;
+      for (int tri = 0; tri < 2; tri++)
+      {
+        Eigen::Vector3s corners[3];
+        int ids[3];
+        grid.getTriangle(row, col, tri, corners, ids);
+        for (int i = 0; i < 3; i++)
+        {
+          trianglesWithVertex[ids[i]]++;
+          int j = (i + 1) % 3;
+          trianglesWithEdge[std::make_pair(
+              std::min(ids[i], ids[j]), std::max(ids[i], ids[j]))]++;
+        }
+      }
+    }
+  }
+
+  std::vector<HeightmapFeature> kept;
+  std::set<std::array<int, 3>> emitted;
+  for (const HeightmapFeature& feature : features)
+  {
+    if (!feature.valid)
+      continue;
+    if (feature.numPoints < 3)
+    {
+      int numSharing = feature.numPoints == 1
+                           ? trianglesWithVertex[feature.ids[0]]
+                           : trianglesWithEdge[std::make_pair(
+                               feature.ids[0], feature.ids[1])];
+      if (static_cast<int>(reports[feature.ids].size()) < numSharing)
+        continue;
+      if (emitted.count(feature.ids))
+        continue;
+      emitted.insert(feature.ids);
+    }
+    kept.push_back(feature);
+  }
+  return kept;
+}
+
+//==============================================================================
+/// This computes the AABB of a world-space AABB [min, max] in the frame `T`
+void transformAABB(
+    const Eigen::Isometry3s& T,
+    const Eigen::Vector3s& min,
+    const Eigen::Vector3s& max,
+    Eigen::Vector3s* outMin,
+    Eigen::Vector3s* outMax)
+{
+  Eigen::Vector3s center = T * (0.5 * (min + max));
+  Eigen::Vector3s halfExtents
+      = T.linear().cwiseAbs() * (0.5 * (max - min)).cwiseAbs();
+  *outMin = center - halfExtents;
+  *outMax = center + halfExtents;
+}
+
+//==============================================================================
+template <typename S>
+int collideSphereHeightmapImpl(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t radius,
+    const Eigen::Isometry3s& sphereT,
+    const HeightmapField<S>& heights,
+    const Eigen::Matrix<S, 3, 1>& scale,
+    const Eigen::Isometry3s& heightmapT,
+    bool sphereIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  HeightmapGrid<S> grid(heights, scale);
+  Eigen::Vector3s center = heightmapT.inverse() * sphereT.translation();
+  Eigen::Vector3s min = center - Eigen::Vector3s::Constant(radius);
+  Eigen::Vector3s max = center + Eigen::Vector3s::Constant(radius);
+
+  std::vector<HeightmapFeature> features = findHeightmapFeatures(
+      grid,
+      min,
+      max,
+      [&](const Eigen::Vector3s* tri, s_t* distance, bool* inFront) {
+        int mask;
+        Eigen::Vector3s closest
+            = closestPointOnTriangle(center, tri[0], tri[1], tri[2], &mask);
+        Eigen::Vector3s normal = (tri[1] - tri[0]).cross(tri[2] - tri[0]);
+        *distance = (center - closest).norm();
+        *inFront = normal.dot(center - closest) >= 0;
+        return mask;
+      });
+
+  // `dir` points from o1 to o2, which is down into the terrain if the sphere
+  // is o1
+  Eigen::Vector3s up = heightmapT.linear().col(2);
+  ccd_vec3_t dir;
+  dir.v[0] = static_cast<ccd_real_t>(sphereIsA ? -up(0) : up(0));
+  dir.v[1] = static_cast<ccd_real_t>(sphereIsA ? -up(1) : up(1));
+  dir.v[2] = static_cast<ccd_real_t>(sphereIsA ? -up(2) : up(2));
+
+  int numContacts = 0;
+  for (const HeightmapFeature& feature : features)
+  {
+    std::vector<Eigen::Vector3s> witness;
+    for (int i = 0; i < feature.numPoints; i++)
+      witness.push_back(feature.points[i]);
+
+    // Faces measure depth along the face normal, so a sphere center that's
+    // sunk below the surface still gets pushed back out the right way
+    s_t depth = radius - feature.distance;
+    if (feature.numPoints == 3)
+    {
+      Eigen::Vector3s normal = (witness[1] - witness[0])
+                                   .cross(witness[2] - witness[0])
+                                   .normalized();
+      depth = radius - normal.dot(center - witness[0]);
+    }
+    if (depth <= 0 || depth > option.contactClippingDepth)
+      continue;
+
+    for (Eigen::Vector3s& point : witness)
+      point = heightmapT * point;
+    if (sphereIsA)
+    {
+      numContacts += createSphereMeshContact(
+          o1, o2, result, &dir, sphereT.translation(), radius, witness);
+    }
+    else
+    {
+      numContacts += createMeshSphereContact(
+          o1, o2, result, &dir, witness, sphereT.translation(), radius);
+    }
+  }
+  return numContacts;
+}
+
+//==============================================================================
+template <typename S>
+int collideCapsuleHeightmapImpl(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height,
+    s_t radius,
+    const Eigen::Isometry3s& capsuleT,
+    const HeightmapField<S>& heights,
+    const Eigen::Matrix<S, 3, 1>& scale,
+    const Eigen::Isometry3s& heightmapT,
+    bool capsuleIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  HeightmapGrid<S> grid(heights, scale);
+  Eigen::Isometry3s toLocal = heightmapT.inverse();
+  Eigen::Vector3s capsuleA = capsuleT * Eigen::Vector3s(0, 0, height / 2);
+  Eigen::Vector3s capsuleB = capsuleT * Eigen::Vector3s(0, 0, -height / 2);
+  Eigen::Vector3s localA = toLocal * capsuleA;
+  Eigen::Vector3s localB = toLocal * capsuleB;
+  Eigen::Vector3s min
+      = localA.cwiseMin(localB) - Eigen::Vector3s::Constant(radius);
+  Eigen::Vector3s max
+      = localA.cwiseMax(localB) + Eigen::Vector3s::Constant(radius);
+
+  std::vector<HeightmapFeature> features = findHeightmapFeatures(
+      grid,
+      min,
+      max,
+      [&](const Eigen::Vector3s* tri, s_t* distance, bool* inFront) {
+        int mask;
+        Eigen::Vector3s onSegment;
+        Eigen::Vector3s onTriangle;
+        *distance = closestSegmentTriangle(
+            localA, localB, tri, &onSegment, &onTriangle, &mask);
+        Eigen::Vector3s normal = (tri[1] - tri[0]).cross(tri[2] - tri[0]);
+        *inFront = normal.dot(onSegment - onTriangle) >= 0;
+        return mask;
+      });
+
+  Eigen::Vector3s up = heightmapT.linear().col(2);
+  ccd_vec3_t dir;
+  dir.v[0] = static_cast<ccd_real_t>(capsuleIsA ? -up(0) : up(0));
+  dir.v[1] = static_cast<ccd_real_t>(capsuleIsA ? -up(1) : up(1));
+  dir.v[2] = static_cast<ccd_real_t>(capsuleIsA ? -up(2) : up(2));
+
+  int numContacts = 0;
+  std::vector<Contact> contacts;
+  for (const HeightmapFeature& feature : features)
+  {
+    if (feature.distance >= radius)
+      continue;
+
+    // Faces can only be touched by the end spheres (the pipe itself would
+    // first touch an edge of the triangle, or the face from a neighboring
+    // triangle), so these are the same as capsule-plane contacts, just limited
+    // to ends that lie over the triangle.
+    if (feature.numPoints == 3)
+    {
+      const Eigen::Vector3s* tri = feature.points;
+      Eigen::Vector3s normal
+          = (tri[1] - tri[0]).cross(tri[2] - tri[0]).normalized();
+      for (const Eigen::Vector3s* end : {&localA, &localB})
+      {
+        int mask;
+        closestPointOnTriangle(*end, tri[0], tri[1], tri[2], &mask);
+        if (mask != (1 | 2 | 4))
+          continue;
+        numContacts += createSphereFaceContact(
+            o1,
+            o2,
+            heightmapT * (*end),
+            radius,
+            heightmapT.linear() * normal,
+            heightmapT * tri[0],
+            capsuleIsA,
+            option,
+            result);
+      }
+      continue;
+    }
+
+    // createCapsuleMeshContact() handles the clipping depth for us
+    std::vector<Eigen::Vector3s> witness;
+    for (int i = 0; i < feature.numPoints; i++)
+      witness.push_back(heightmapT * feature.points[i]);
+    createCapsuleMeshContact(
+        o1,
+        o2,
+        contacts,
+        &dir,
+        capsuleA,
+        capsuleB,
+        radius,
+        witness,
+        !capsuleIsA,
+        option);
+  }
+  for (Contact& contact : contacts)
+  {
+    contact.collisionObject1 = o1;
+    contact.collisionObject2 = o2;
+    result.addContact(contact);
+  }
+  return numContacts + contacts.size();
+}
+
+//==============================================================================
+/// This is the vertex-based part of box-heightmap and mesh-heightmap
+/// collision. It checks each vertex against the terrain triangle directly
+/// below (or above) it.
+template <typename S>
+int collideVerticesHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const std::vector<Eigen::Vector3s>& vertices,
+    const HeightmapGrid<S>& grid,
+    const Eigen::Isometry3s& heightmapT,
+    bool verticesAreA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  if (!grid.isValid())
+    return 0;
+  Eigen::Isometry3s toLocal = heightmapT.inverse();
+  int numContacts = 0;
+  for (const Eigen::Vector3s& vertex : vertices)
+  {
+    Eigen::Vector3s local = toLocal * vertex;
+    Eigen::Vector3s normal;
+    Eigen::Vector3s point;
+    if (!grid.getTriangleUnder(local, &normal, &point))
+      continue;
+    numContacts += createVertexFaceContact(
+        o1,
+        o2,
+        vertex,
+        heightmapT.linear() * normal,
+        normal.dot(point - local),
+        verticesAreA,
+        option,
+        result);
+  }
+  return numContacts;
+}
+
+//==============================================================================
+template <typename S>
+int collideBoxHeightmapImpl(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size,
+    const Eigen::Isometry3s& boxT,
+    const HeightmapField<S>& heights,
+    const Eigen::Matrix<S, 3, 1>& scale,
+    const Eigen::Isometry3s& heightmapT,
+    bool boxIsA,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  HeightmapGrid<S> grid(heights, scale);
+  if (!grid.isValid())
+    return 0;
+
+  // Box corners under the terrain
+  std::vector<Eigen::Vector3s> corners;
+  forEachBoxVertex(size, boxT, [&](const Eigen::Vector3s& vertex) {
+    corners.push_back(vertex);
+  });
+  int numContacts = collideVerticesHeightmap(
+      o1, o2, corners, grid, heightmapT, boxIsA, option, result);
+
+  // Terrain vertices poking up into the bottom of the box
+  Eigen::Isometry3s boxToLocal = heightmapT.inverse() * boxT;
+  Eigen::Vector3s min;
+  Eigen::Vector3s max;
+  transformAABB(boxToLocal, -0.5 * size, 0.5 * size, &min, &max);
+  int rowMin, rowMax, colMin, colMax;
+  if (!grid.getCellRange(min, max, &rowMin, &rowMax, &colMin, &colMax))
+    return numContacts;
+
+  Eigen::Isometry3s localToBox = boxToLocal.inverse();
+  Eigen::Vector3s halfSize = 0.5 * size;
+  Eigen::Vector3s up = boxToLocal.linear().transpose().col(2);
+  for (int row = rowMin; row <= rowMax + 1; row++)
+  {
+    for (int col = colMin; col <= colMax + 1; col++)
+    {
+      Eigen::Vector3s vertex = grid.getVertex(row, col);
+      if (vertex(2) < min(2))
+        continue;
+      Eigen::Vector3s inBox = localToBox * vertex;
+      if ((inBox.cwiseAbs() - halfSize).maxCoeff() >= 0)
+        continue;
+
+      // Push out through the nearest box face, as long as it faces down
+      // towards the terrain
+      int axis;
+      (halfSize - inBox.cwiseAbs()).minCoeff(&axis);
+      Eigen::Vector3s faceNormal = Eigen::Vector3s::Zero();
+      faceNormal(axis) = inBox(axis) > 0 ? 1.0 : -1.0;
+      if (faceNormal.dot(up) >= 0)
+        continue;
+
+      // createVertexFaceContact() takes the normal of the face's solid side,
+      // from the point of view of the vertex's object
+      numContacts += createVertexFaceContact(
+          o1,
+          o2,
+          heightmapT * vertex,
+          boxT.linear() * faceNormal,
+          halfSize(axis) - std::abs(inBox(axis)),
+          !boxIsA,
+          option,
+          result);
+    }
+  }
+  return numContacts;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+template <typename S>
+int collideSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideSphereHeightmapImpl(
+      o1, o2, r0, T0, heights1, scale1, T1, true, option, result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideSphereHeightmapImpl(
+      o1, o2, r1, T1, heights0, scale0, T0, false, option, result);
+}
+
+//==============================================================================
+template <typename S>
+int collideCapsuleHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideCapsuleHeightmapImpl(
+      o1, o2, height0, radius0, T0, heights1, scale1, T1, true, option, result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideCapsuleHeightmapImpl(
+      o1,
+      o2,
+      height1,
+      radius1,
+      T1,
+      heights0,
+      scale0,
+      T0,
+      false,
+      option,
+      result);
+}
+
+//==============================================================================
+template <typename S>
+int collideBoxHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  return collideBoxHeightmapImpl(
+      o1, o2, size0, T0, heights1, scale1, T1, true, option, result);
+}
+
+//==============================================================================
+template <typename S>
+int collideHeightmapBox(
     CollisionObject* o1,
     CollisionObject* o2,
-    const s_t& cyl_rad,
-    const s_t& half_height,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
     const Eigen::Isometry3s& T0,
-    const Eigen::Vector3s& plane_normal,
+    const Eigen::Vector3s& size1,
     const Eigen::Isometry3s& T1,
-    const CollisionOption& /* option */,
+    const CollisionOption& option,
     CollisionResult& result)
 {
-  Eigen::Vector3s normal = T1.linear() * plane_normal;
-  Eigen::Vector3s Rx = T0.linear().rightCols(1);
-  Eigen::Vector3s Ry = normal - normal.dot(Rx) * Rx;
-  s_t mag = Ry.norm();
-  Ry.normalize();
-  if (mag < DART_COLLISION_EPS)
-  {
-    if (abs(Rx[2]) > 1.0 - DART_COLLISION_EPS)
-      Ry = Eigen::Vector3s::UnitX();
-    else
-      Ry = (Eigen::Vector3s(Rx[1], -Rx[0], 0.0)).normalized();
-  }
-
-  Eigen::Vector3s Rz = Rx.cross(Ry);
-  Eigen::Isometry3s T;
-  T.linear().col(0) = Rx;
-  T.linear().col(1) = Ry;
-  T.linear().col(2) = Rz;
-  T.translation() = T0.translation();
+  return collideBoxHeightmapImpl(
+      o1, o2, size1, T1, heights0, scale0, T0, false, option, result);
+}
 
-  Eigen::Vector3s nn = T.linear().transpose() * normal;
-  Eigen::Vector3s pn = T.inverse() * T1.translation();
+//==============================================================================
+template <typename S>
+int collideMeshHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  std::vector<Eigen::Vector3s> vertices;
+  forEachMeshVertex(mesh0, size0, T0, [&](const Eigen::Vector3s& vertex) {
+    vertices.push_back(vertex);
+  });
+  return collideVerticesHeightmap(
+      o1,
+      o2,
+      vertices,
+      HeightmapGrid<S>(heights1, scale1),
+      T1,
+      true,
+      option,
+      result);
+}
 
-  // four corners c0 = ( -h/2, -r ), c1 = ( +h/2, -r ), c2 = ( +h/2, +r ), c3
-  // = ( -h/2, +r )
-  Eigen::Vector3s c[4]
-      = {Eigen::Vector3s(-half_height, -cyl_rad, 0.0),
-         Eigen::Vector3s(+half_height, -cyl_rad, 0.0),
-         Eigen::Vector3s(+half_height, +cyl_rad, 0.0),
-         Eigen::Vector3s(-half_height, +cyl_rad, 0.0)};
+//==============================================================================
+template <typename S>
+int collideHeightmapMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  std::vector<Eigen::Vector3s> vertices;
+  forEachMeshVertex(mesh1, size1, T1, [&](const Eigen::Vector3s& vertex) {
+    vertices.push_back(vertex);
+  });
+  return collideVerticesHeightmap(
+      o1,
+      o2,
+      vertices,
+      HeightmapGrid<S>(heights0, scale0),
+      T0,
+      false,
+      option,
+      result);
+}
 
-  s_t depth[4]
-      = {(pn - c[0]).dot(nn),
-         (pn - c[1]).dot(nn),
-         (pn - c[2]).dot(nn),
-         (pn - c[3]).dot(nn)};
+#define DART_INSTANTIATE_HEIGHTMAP_COLLIDE(S)                                  \
+  template int collideSphereHeightmap<S>(                                      \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const s_t&,                                                              \
+      const Eigen::Isometry3s&,                                                \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapSphere<S>(                                      \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const s_t&,                                                              \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideCapsuleHeightmap<S>(                                     \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      s_t,                                                                     \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapCapsule<S>(                                     \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      s_t,                                                                     \
+      s_t,                                                                     \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideBoxHeightmap<S>(                                         \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapBox<S>(                                         \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideMeshHeightmap<S>(                                        \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const aiScene*,                                                          \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);                                                       \
+  template int collideHeightmapMesh<S>(                                        \
+      CollisionObject*,                                                        \
+      CollisionObject*,                                                        \
+      const HeightmapField<S>&,                                                \
+      const Eigen::Matrix<S, 3, 1>&,                                           \
+      const Eigen::Isometry3s&,                                                \
+      const aiScene*,                                                          \
+      const Eigen::Vector3s&,                                                  \
+      const Eigen::Isometry3s&,                                                \
+      const CollisionOption&,                                                  \
+      CollisionResult&);
+
+DART_INSTANTIATE_HEIGHTMAP_COLLIDE(float)
+DART_INSTANTIATE_HEIGHTMAP_COLLIDE(s_t)
+
+#undef DART_INSTANTIATE_HEIGHTMAP_COLLIDE
+
+namespace {
 
-  s_t penetration = -1.0;
-  int found = -1;
-  for (int i = 0; i < 4; i++)
+//==============================================================================
+/// This dispatches collisions between a plane and any other shape. The plane
+/// is o1 if `planeIsFirst` is true, otherwise it's o2. Returns -1 if the pair
+/// isn't supported.
+int collideWithPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    bool planeIsFirst,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionObject* planeObject = planeIsFirst ? o1 : o2;
+  CollisionObject* otherObject = planeIsFirst ? o2 : o1;
+  const auto* plane = static_cast<const dynamics::PlaneShape*>(
+      planeObject->getShape().get());
+  const auto& other = otherObject->getShape();
+  const auto& otherType = other->getType();
+  const Eigen::Isometry3s& planeT = planeObject->getTransform();
+  const Eigen::Isometry3s& otherT = otherObject->getTransform();
+
+  const Eigen::Vector3s& normal = plane->getNormal();
+  const s_t offset = plane->getOffset();
+
+  if (dynamics::SphereShape::getStaticType() == otherType
+      || dynamics::EllipsoidShape::getStaticType() == otherType)
+  {
+    const s_t radius
+        = dynamics::SphereShape::getStaticType() == otherType
+              ? static_cast<const dynamics::SphereShape*>(other.get())
+                    ->getRadius()
+              : static_cast<const dynamics::EllipsoidShape*>(other.get())
+                    ->getRadii()[0];
+    if (planeIsFirst)
+      return collidePlaneSphere(
+          o1, o2, normal, offset, planeT, radius, otherT, option, result);
+    else
+      return collideSpherePlane(
+          o1, o2, radius, otherT, normal, offset, planeT, option, result);
+  }
+  else if (dynamics::BoxShape::getStaticType() == otherType)
   {
-    if (depth[i] > penetration)
-    {
-      penetration = depth[i];
-      found = i;
-    }
+    const auto* box = static_cast<const dynamics::BoxShape*>(other.get());
+    if (planeIsFirst)
+      return collidePlaneBox(
+          o1,
+          o2,
+          normal,
+          offset,
+          planeT,
+          box->getSize(),
+          otherT,
+          option,
+          result);
+    else
+      return collideBoxPlane(
+          o1,
+          o2,
+          box->getSize(),
+          otherT,
+          normal,
+          offset,
+          planeT,
+          option,
+          result);
+  }
+  else if (dynamics::MeshShape::getStaticType() == otherType)
+  {
+    const auto* mesh = static_cast<const dynamics::MeshShape*>(other.get());
+    if (planeIsFirst)
+      return collidePlaneMesh(
+          o1,
+          o2,
+          normal,
+          offset,
+          planeT,
+          mesh->getMesh(),
+          mesh->getScale(),
+          otherT,
+          option,
+          result);
+    else
+      return collideMeshPlane(
+          o1,
+          o2,
+          mesh->getMesh(),
+          mesh->getScale(),
+          otherT,
+          normal,
+          offset,
+          planeT,
+          option,
+          result);
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == otherType)
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(other.get());
+    if (planeIsFirst)
+      return collidePlaneCapsule(
+          o1,
+          o2,
+          normal,
+          offset,
+          planeT,
+          capsule->getHeight(),
+          capsule->getRadius(),
+          otherT,
+          option,
+          result);
+    else
+      return collideCapsulePlane(
+          o1,
+          o2,
+          capsule->getHeight(),
+          capsule->getRadius(),
+          otherT,
+          normal,
+          offset,
+          planeT,
+          option,
+          result);
+  }
+  else if (dynamics::CylinderShape::getStaticType() == otherType)
+  {
+    const auto* cylinder
+        = static_cast<const dynamics::CylinderShape*>(other.get());
+    // The cylinder routines expect the plane to pass through the origin of T
+    Eigen::Isometry3s offsetPlaneT = planeT;
+    offsetPlaneT.translate(normal * offset);
+    if (planeIsFirst)
+      return collidePlaneCylinder(
+          o1,
+          o2,
+          normal,
+          offsetPlaneT,
+          cylinder->getRadius(),
+          cylinder->getHeight() / 2,
+          otherT,
+          option,
+          result);
+    else
+      return collideCylinderPlane(
+          o1,
+          o2,
+          cylinder->getRadius(),
+          cylinder->getHeight() / 2,
+          otherT,
+          normal,
+          offsetPlaneT,
+          option,
+          result);
+  }
+  else if (
+      dynamics::PlaneShape::getStaticType() == otherType
+      || dynamics::HeightmapShapef::getStaticType() == otherType
+      || dynamics::HeightmapShaped::getStaticType() == otherType)
+  {
+    // Terrain doesn't collide with other terrain
+    return 0;
   }
 
-  Eigen::Vector3s point;
-
-  if (abs(depth[found] - depth[(found + 1) % 4]) < DART_COLLISION_EPS)
-    point = T * (0.5 * (c[found] + c[(found + 1) % 4]));
-  else if (abs(depth[found] - depth[(found + 3) % 4]) < DART_COLLISION_EPS)
-    point = T * (0.5 * (c[found] + c[(found + 3) % 4]));
-  else
-    point = T * c[found];
+  return -1;
+}
 
-  if (penetration > 0.0)
+//==============================================================================
+/// This dispatches collisions between a heightmap and any other shape. The
+/// heightmap is o1 if `heightmapIsFirst` is true, otherwise it's o2. Returns
+/// -1 if the pair isn't supported.
+template <typename S>
+int collideWithHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    bool heightmapIsFirst,
+    const CollisionOption& option,
+    CollisionResult& result)
+{
+  CollisionObject* heightmapObject = heightmapIsFirst ? o1 : o2;
+  CollisionObject* otherObject = heightmapIsFirst ? o2 : o1;
+  const auto* heightmap = static_cast<const dynamics::HeightmapShape<S>*>(
+      heightmapObject->getShape().get());
+  const auto& other = otherObject->getShape();
+  const auto& otherType = other->getType();
+  const Eigen::Isometry3s& heightmapT = heightmapObject->getTransform();
+  const Eigen::Isometry3s& otherT = otherObject->getTransform();
+
+  const auto& heights = heightmap->getHeightField();
+  const auto& scale = heightmap->getScale();
+
+  if (dynamics::SphereShape::getStaticType() == otherType
+      || dynamics::EllipsoidShape::getStaticType() == otherType)
+  {
+    const s_t radius
+        = dynamics::SphereShape::getStaticType() == otherType
+              ? static_cast<const dynamics::SphereShape*>(other.get())
+                    ->getRadius()
+              : static_cast<const dynamics::EllipsoidShape*>(other.get())
+                    ->getRadii()[0];
+    if (heightmapIsFirst)
+      return collideHeightmapSphere(
+          o1, o2, heights, scale, heightmapT, radius, otherT, option, result);
+    else
+      return collideSphereHeightmap(
+          o1, o2, radius, otherT, heights, scale, heightmapT, option, result);
+  }
+  else if (dynamics::BoxShape::getStaticType() == otherType)
   {
-    Contact contact;
-    contact.collisionObject1 = o1;
-    contact.collisionObject2 = o2;
-    contact.point = point;
-    contact.normal = normal;
-    contact.penetrationDepth = penetration;
-    result.addContact(contact);
-    return 1;
+    const auto* box = static_cast<const dynamics::BoxShape*>(other.get());
+    if (heightmapIsFirst)
+      return collideHeightmapBox(
+          o1,
+          o2,
+          heights,
+          scale,
+          heightmapT,
+          box->getSize(),
+          otherT,
+          option,
+          result);
+    else
+      return collideBoxHeightmap(
+          o1,
+          o2,
+          box->getSize(),
+          otherT,
+          heights,
+          scale,
+          heightmapT,
+          option,
+          result);
+  }
+  else if (dynamics::MeshShape::getStaticType() == otherType)
+  {
+    const auto* mesh = static_cast<const dynamics::MeshShape*>(other.get());
+    if (heightmapIsFirst)
+      return collideHeightmapMesh(
+          o1,
+          o2,
+          heights,
+          scale,
+          heightmapT,
+          mesh->getMesh(),
+          mesh->getScale(),
+          otherT,
+          option,
+          result);
+    else
+      return collideMeshHeightmap(
+          o1,
+          o2,
+          mesh->getMesh(),
+          mesh->getScale(),
+          otherT,
+          heights,
+          scale,
+          heightmapT,
+          option,
+          result);
+  }
+  else if (dynamics::CapsuleShape::getStaticType() == otherType)
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(other.get());
+    if (heightmapIsFirst)
+      return collideHeightmapCapsule(
+          o1,
+          o2,
+          heights,
+          scale,
+          heightmapT,
+          capsule->getHeight(),
+          capsule->getRadius(),
+          otherT,
+          option,
+          result);
+    else
+      return collideCapsuleHeightmap(
+          o1,
+          o2,
+          capsule->getHeight(),
+          capsule->getRadius(),
+          otherT,
+          heights,
+          scale,
+          heightmapT,
+          option,
+          result);
+  }
+  else if (
+      dynamics::PlaneShape::getStaticType() == otherType
+      || dynamics::HeightmapShapef::getStaticType() == otherType
+      || dynamics::HeightmapShaped::getStaticType() == otherType)
+  {
+    // Terrain doesn't collide with other terrain
+    return 0;
   }
 
-  return 0;
+  return -1;
 }
 
+} // anonymous namespace
+
 //==============================================================================
 int collide(
     CollisionObject* o1,
@@ -5080,6 +6794,44 @@ int collide(
   const Eigen::Isometry3s& T1 = o1->getTransform();
   const Eigen::Isometry3s& T2 = o2->getTransform();
 
+  // Planes and heightmaps collide with most other shapes, so they get their
+  // own dispatchers
+  int numTerrainContacts = -1;
+  if (dynamics::PlaneShape::getStaticType() == shapeType1
+      || dynamics::PlaneShape::getStaticType() == shapeType2)
+  {
+    numTerrainContacts = collideWithPlane(
+        o1,
+        o2,
+        dynamics::PlaneShape::getStaticType() == shapeType1,
+        option,
+        result);
+  }
+  else if (
+      dynamics::HeightmapShapef::getStaticType() == shapeType1
+      || dynamics::HeightmapShapef::getStaticType() == shapeType2)
+  {
+    numTerrainContacts = collideWithHeightmap<float>(
+        o1,
+        o2,
+        dynamics::HeightmapShapef::getStaticType() == shapeType1,
+        option,
+        result);
+  }
+  else if (
+      dynamics::HeightmapShaped::getStaticType() == shapeType1
+      || dynamics::HeightmapShaped::getStaticType() == shapeType2)
+  {
+    numTerrainContacts = collideWithHeightmap<s_t>(
+        o1,
+        o2,
+        dynamics::HeightmapShaped::getStaticType() == shapeType1,
+        option,
+        result);
+  }
+  if (numTerrainContacts >= 0)
+    return numTerrainContacts;
+
   if (dynamics::SphereShape::getStaticType() == shapeType1)
   {
     const auto* sphere0
@@ -5160,6 +6912,22 @@ int collide(
           option,
           result);
     }
+    else if (dynamics::CylinderShape::getStaticType() == shapeType2)
+    {
+      const auto* cylinder1
+          = static_cast<const dynamics::CylinderShape*>(shape2.get());
+
+      return collideSphereCylinder(
+          o1,
+          o2,
+          sphere0->getRadius(),
+          T1,
+          cylinder1->getRadius(),
+          cylinder1->getHeight() / 2,
+          T2,
+          option,
+          result);
+    }
   }
   else if (dynamics::BoxShape::getStaticType() == shapeType1)
   {
@@ -5446,6 +7214,22 @@ int collide(
           option,
           result);
     }
+    else if (dynamics::CylinderShape::getStaticType() == shapeType2)
+    {
+      const auto* cylinder1
+          = static_cast<const dynamics::CylinderShape*>(shape2.get());
+
+      return collideSphereCylinder(
+          o1,
+          o2,
+          ellipsoid0->getRadii()[0],
+          T1,
+          cylinder1->getRadius(),
+          cylinder1->getHeight() / 2,
+          T2,
+          option,
+          result);
+    }
   }
   else if (dynamics::MeshShape::getStaticType() == shapeType1)
   {
@@ -5618,6 +7402,44 @@ int collide(
           result);
     }
   }
+  else if (dynamics::CylinderShape::getStaticType() == shapeType1)
+  {
+    const auto* cylinder0
+        = static_cast<const dynamics::CylinderShape*>(shape1.get());
+
+    if (dynamics::SphereShape::getStaticType() == shapeType2)
+    {
+      const auto* sphere1
+          = static_cast<const dynamics::SphereShape*>(shape2.get());
+
+      return collideCylinderSphere(
+          o1,
+          o2,
+          cylinder0->getRadius(),
+          cylinder0->getHeight() / 2,
+          T1,
+          sphere1->getRadius(),
+          T2,
+          option,
+          result);
+    }
+    else if (dynamics::EllipsoidShape::getStaticType() == shapeType2)
+    {
+      const auto* ellipsoid1
+          = static_cast<const dynamics::EllipsoidShape*>(shape2.get());
+
+      return collideCylinderSphere(
+          o1,
+          o2,
+          cylinder0->getRadius(),
+          cylinder0->getHeight() / 2,
+          T1,
+          ellipsoid1->getRadii()[0],
+          T2,
+          option,
+          result);
+    }
+  }
   // collideCapsuleCapsule
 
   dterr << "[DARTCollisionDetector] Attempting to check for an "
@@ -291,6 +291,250 @@ int collideCylinderPlane(
     const CollisionOption& option,
     CollisionResult& result);
 
+int collideSphereCylinder(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& sphere_rad,
+    const Eigen::Isometry3s& T0,
+    const s_t& cyl_rad,
+    const s_t& half_height,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collidePlaneCylinder(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& plane_normal,
+    const Eigen::Isometry3s& T0,
+    const s_t& cyl_rad,
+    const s_t& half_height,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/////////////////////////////////////////////////////////////////////
+// Infinite planes:
+/////////////////////////////////////////////////////////////////////
+
+// The plane is the set of points x with (normal.dot(x) == offset) in the frame
+// of the plane, and everything below it is treated as solid. Contacts get the
+// same annotations as the equivalent mesh face contacts (SPHERE_FACE,
+// VERTEX_FACE, etc), so the gradients treat the plane as a single big face.
+
+int collideSpherePlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collidePlaneSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideBoxPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collidePlaneBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideMeshPlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collidePlaneMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collideCapsulePlane(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& normal1,
+    const s_t& offset1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+int collidePlaneCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& normal0,
+    const s_t& offset0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/////////////////////////////////////////////////////////////////////
+// Heightmaps:
+/////////////////////////////////////////////////////////////////////
+
+// These treat the heightmap as a triangle mesh (two triangles per grid cell,
+// laid out the same way as dynamics::HeightmapShape), with everything below
+// the surface solid. Only the grid cells under the AABB of the other shape are
+// visited, so the cost doesn't grow with the size of the terrain. Contacts are
+// annotated exactly like the equivalent mesh contacts, so they get the same
+// gradients.
+
+template <typename S>
+using HeightmapField
+    = Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+template <typename S>
+int collideSphereHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const s_t& r0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideHeightmapSphere(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    const s_t& r1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideCapsuleHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    s_t height0,
+    s_t radius0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideHeightmapCapsule(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    s_t height1,
+    s_t radius1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/// Box-heightmap contacts are VERTEX_FACE for box corners under the terrain,
+/// and FACE_VERTEX for terrain vertices that poke into a downward facing box
+/// face.
+template <typename S>
+int collideBoxHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideHeightmapBox(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+/// Mesh-heightmap contacts only consider mesh vertices under the terrain
+/// (VERTEX_FACE), so meshes should be reasonably finely tessellated relative to
+/// the terrain features they rest on.
+template <typename S>
+int collideMeshHeightmap(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const aiScene* mesh0,
+    const Eigen::Vector3s& size0,
+    const Eigen::Isometry3s& T0,
+    const HeightmapField<S>& heights1,
+    const Eigen::Matrix<S, 3, 1>& scale1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
+template <typename S>
+int collideHeightmapMesh(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const HeightmapField<S>& heights0,
+    const Eigen::Matrix<S, 3, 1>& scale0,
+    const Eigen::Isometry3s& T0,
+    const aiScene* mesh1,
+    const Eigen::Vector3s& size1,
+    const Eigen::Isometry3s& T1,
+    const CollisionOption& option,
+    CollisionResult& result);
+
 /////////////////////////////////////////////////////////////////////
 // Interface with libccd:
 /////////////////////////////////////////////////////////////////////
@@ -32,15 +32,27 @@
 
 #include "dart/collision/dart/DARTCollisionDetector.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/DistanceFilter.hpp"
+#include "dart/collision/dart/DARTBVH.hpp"
+#include "dart/collision/dart/DARTBatchedNarrowphase.hpp"
 #include "dart/collision/dart/DARTCollide.hpp"
 #include "dart/collision/dart/DARTCollisionGroup.hpp"
 #include "dart/collision/dart/DARTCollisionObject.hpp"
+#include "dart/collision/dart/DARTContactManifold.hpp"
+#include "dart/collision/dart/DARTDistance.hpp"
+#include "dart/collision/dart/DARTRaycast.hpp"
 #include "dart/dynamics/BoxShape.hpp"
 #include "dart/dynamics/CapsuleShape.hpp"
+#include "dart/dynamics/CylinderShape.hpp"
 #include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
 #include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/PlaneShape.hpp"
 #include "dart/dynamics/ShapeFrame.hpp"
 #include "dart/dynamics/SphereShape.hpp"
 
@@ -53,7 +65,8 @@ bool checkPair(
     CollisionObject* o1,
     CollisionObject* o2,
     const CollisionOption& option,
-    CollisionResult* result = nullptr);
+    CollisionResult* result = nullptr,
+    DARTContactManifoldCache* manifolds = nullptr);
 
 bool isClose(
     const Eigen::Vector3s& pos1, const Eigen::Vector3s& pos2, double tol);
@@ -65,6 +78,62 @@ void postProcess(
     CollisionResult& totalResult,
     const CollisionResult& pairResult);
 
+bool checkBatch(
+    DARTBatchedNarrowphase& batch,
+    const CollisionOption& option,
+    CollisionResult* result,
+    DARTContactManifoldCache* manifolds,
+    bool& collisionFound,
+    std::size_t& numCulledPairs);
+
+void reduceContacts(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    DARTContactManifoldCache* manifolds,
+    CollisionResult& pairResult);
+
+/// The objects of a group, prepared for raycast and distance queries
+struct QueryScene
+{
+  std::vector<DARTCollisionObject*> objects;
+
+  /// The world frame box around each object, if it has one
+  std::vector<DARTBVH::AABB> boxes;
+
+  /// A tree over the objects with finite bounds
+  DARTBVH tree;
+
+  /// Maps primitives of the tree back into objects
+  std::vector<std::size_t> bounded;
+
+  /// The objects without finite bounds, like planes
+  std::vector<std::size_t> unbounded;
+
+  void build(const std::vector<CollisionObject*>& groupObjects);
+};
+
+bool raycastScene(
+    const QueryScene& scene,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& to,
+    const RaycastOption& option,
+    RaycastResult* result);
+
+double distanceScenes(
+    const QueryScene& scene1,
+    const QueryScene* scene2,
+    const DistanceOption& option,
+    DistanceResult* result);
+
+/// Scratch space for the batched culling, reused across calls so that steady
+/// state collision checking doesn't allocate
+DARTBatchedNarrowphase& getThreadBatch()
+{
+  static thread_local DARTBatchedNarrowphase batch;
+  return batch;
+}
+
 } // anonymous namespace
 
 //==============================================================================
@@ -86,7 +155,9 @@ std::shared_ptr<DARTCollisionDetector> DARTCollisionDetector::create()
 std::shared_ptr<CollisionDetector>
 DARTCollisionDetector::cloneWithoutCollisionObjects() const
 {
-  return DARTCollisionDetector::create();
+  auto clone = DARTCollisionDetector::create();
+  clone->setUseBatchedNarrowphase(mUseBatchedNarrowphase);
+  return clone;
 }
 
 //==============================================================================
@@ -131,6 +202,7 @@ bool DARTCollisionDetector::collide(
 {
   if (result)
     result->clear();
+  mNumCulledPairs = 0u;
 
   if (0u == option.maxNumContacts)
     return false;
@@ -147,6 +219,56 @@ bool DARTCollisionDetector::collide(
   auto collisionFound = false;
   const auto& filter = option.collisionFilter;
 
+  DARTContactManifoldCache* manifolds = nullptr;
+  if (result && option.maxNumContactsPerPair > 0u)
+  {
+    manifolds = &mContactManifolds;
+    manifolds->startCheck();
+  }
+
+  if (mUseBatchedNarrowphase)
+  {
+    auto& batch = getThreadBatch();
+    batch.clear();
+    for (auto* object : objects)
+      batch.addObject(object);
+
+    for (auto i = 0u; i < objects.size() - 1; ++i)
+    {
+      for (auto j = i + 1u; j < objects.size(); ++j)
+      {
+        if (filter && filter->ignoresCollision(objects[i], objects[j]))
+          continue;
+
+        batch.addPair(i, j);
+
+        if (batch.getNumPairs() >= DARTBatchedNarrowphase::CHUNK_SIZE)
+        {
+          if (checkBatch(
+                  batch,
+                  option,
+                  result,
+                  manifolds,
+                  collisionFound,
+                  mNumCulledPairs))
+            return true;
+        }
+      }
+    }
+
+    if (checkBatch(
+            batch,
+            option,
+            result,
+            manifolds,
+            collisionFound,
+            mNumCulledPairs))
+      return true;
+
+    // Either no collision found or not reached the maximum number of contacts
+    return collisionFound;
+  }
+
   for (auto i = 0u; i < objects.size() - 1; ++i)
   {
     auto* collObj1 = objects[i];
@@ -158,7 +280,8 @@ bool DARTCollisionDetector::collide(
       if (filter && filter->ignoresCollision(collObj1, collObj2))
         continue;
 
-      collisionFound = checkPair(collObj1, collObj2, option, result);
+      collisionFound
+          = checkPair(collObj1, collObj2, option, result, manifolds);
 
       if (result)
       {
@@ -187,6 +310,7 @@ bool DARTCollisionDetector::collide(
 {
   if (result)
     result->clear();
+  mNumCulledPairs = 0u;
 
   if (0u == option.maxNumContacts)
     return false;
@@ -209,6 +333,59 @@ bool DARTCollisionDetector::collide(
   auto collisionFound = false;
   const auto& filter = option.collisionFilter;
 
+  DARTContactManifoldCache* manifolds = nullptr;
+  if (result && option.maxNumContactsPerPair > 0u)
+  {
+    manifolds = &mContactManifolds;
+    manifolds->startCheck();
+  }
+
+  if (mUseBatchedNarrowphase)
+  {
+    auto& batch = getThreadBatch();
+    batch.clear();
+    for (auto* object : objects1)
+      batch.addObject(object);
+    for (auto* object : objects2)
+      batch.addObject(object);
+
+    const auto offset = objects1.size();
+    for (auto i = 0u; i < objects1.size(); ++i)
+    {
+      for (auto j = 0u; j < objects2.size(); ++j)
+      {
+        if (filter && filter->ignoresCollision(objects1[i], objects2[j]))
+          continue;
+
+        batch.addPair(i, offset + j);
+
+        if (batch.getNumPairs() >= DARTBatchedNarrowphase::CHUNK_SIZE)
+        {
+          if (checkBatch(
+                  batch,
+                  option,
+                  result,
+                  manifolds,
+                  collisionFound,
+                  mNumCulledPairs))
+            return true;
+        }
+      }
+    }
+
+    if (checkBatch(
+            batch,
+            option,
+            result,
+            manifolds,
+            collisionFound,
+            mNumCulledPairs))
+      return true;
+
+    // Either no collision found or not reached the maximum number of contacts
+    return collisionFound;
+  }
+
   for (auto i = 0u; i < objects1.size(); ++i)
   {
     auto* collObj1 = objects1[i];
@@ -220,7 +397,8 @@ bool DARTCollisionDetector::collide(
       if (filter && filter->ignoresCollision(collObj1, collObj2))
         continue;
 
-      collisionFound = checkPair(collObj1, collObj2, option, result);
+      collisionFound
+          = checkPair(collObj1, collObj2, option, result, manifolds);
 
       if (result)
       {
@@ -240,29 +418,153 @@ bool DARTCollisionDetector::collide(
   return collisionFound;
 }
 
+//==============================================================================
+void DARTCollisionDetector::setUseBatchedNarrowphase(bool use)
+{
+  mUseBatchedNarrowphase = use;
+}
+
+//==============================================================================
+bool DARTCollisionDetector::getUseBatchedNarrowphase() const
+{
+  return mUseBatchedNarrowphase;
+}
+
+//==============================================================================
+std::size_t DARTCollisionDetector::getNumCulledPairs() const
+{
+  return mNumCulledPairs;
+}
+
 //==============================================================================
 double DARTCollisionDetector::distance(
-    CollisionGroup* /*group*/,
-    const DistanceOption& /*option*/,
-    DistanceResult* /*result*/)
+    CollisionGroup* group,
+    const DistanceOption& option,
+    DistanceResult* result)
 {
-  dtwarn << "[DARTCollisionDetector::distance] This collision detector does "
-         << "not support (signed) distance queries. Returning 0.0.\n";
+  if (result)
+    result->clear();
+
+  if (!checkGroupValidity(this, group))
+    return 0.0;
+
+  QueryScene scene;
+  scene.build(static_cast<DARTCollisionGroup*>(group)->mCollisionObjects);
 
-  return 0.0;
+  return distanceScenes(scene, nullptr, option, result);
 }
 
 //==============================================================================
 double DARTCollisionDetector::distance(
-    CollisionGroup* /*group1*/,
-    CollisionGroup* /*group2*/,
-    const DistanceOption& /*option*/,
-    DistanceResult* /*result*/)
+    CollisionGroup* group1,
+    CollisionGroup* group2,
+    const DistanceOption& option,
+    DistanceResult* result)
+{
+  if (result)
+    result->clear();
+
+  if (!checkGroupValidity(this, group1))
+    return 0.0;
+
+  if (!checkGroupValidity(this, group2))
+    return 0.0;
+
+  QueryScene scene1;
+  scene1.build(static_cast<DARTCollisionGroup*>(group1)->mCollisionObjects);
+  QueryScene scene2;
+  scene2.build(static_cast<DARTCollisionGroup*>(group2)->mCollisionObjects);
+
+  return distanceScenes(scene1, &scene2, option, result);
+}
+
+//==============================================================================
+bool DARTCollisionDetector::raycast(
+    CollisionGroup* group,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& to,
+    const RaycastOption& option,
+    RaycastResult* result)
+{
+  if (result)
+    result->clear();
+
+  if (!checkGroupValidity(this, group))
+    return false;
+
+  QueryScene scene;
+  scene.build(static_cast<DARTCollisionGroup*>(group)->mCollisionObjects);
+
+  return raycastScene(scene, from, to, option, result);
+}
+
+//==============================================================================
+std::size_t DARTCollisionDetector::raycastBatch(
+    CollisionGroup* group,
+    const std::vector<Eigen::Vector3s>& from,
+    const std::vector<Eigen::Vector3s>& to,
+    const RaycastOption& option,
+    std::vector<RaycastResult>* results)
 {
-  dtwarn << "[DARTCollisionDetector::distance] This collision detector does "
-         << "not support (signed) distance queries. Returning 0.0.\n";
+  assert(from.size() == to.size());
+  const std::size_t numRays = std::min(from.size(), to.size());
+
+  if (results)
+  {
+    results->resize(numRays);
+    for (auto& result : *results)
+      result.clear();
+  }
+
+  if (!checkGroupValidity(this, group))
+    return 0u;
 
-  return 0.0;
+  QueryScene scene;
+  scene.build(static_cast<DARTCollisionGroup*>(group)->mCollisionObjects);
+
+  std::vector<char> hits(numRays, 0);
+
+  // Rays are handed out in contiguous chunks, so each thread walks the tree
+  // for neighboring (and usually similar) rays
+  const std::size_t chunkSize = 64u;
+  const std::size_t numChunks = (numRays + chunkSize - 1) / chunkSize;
+  auto castChunk = [&](std::size_t chunk) {
+    const std::size_t end = std::min(numRays, (chunk + 1) * chunkSize);
+    for (std::size_t i = chunk * chunkSize; i < end; ++i)
+    {
+      hits[i] = raycastScene(
+          scene, from[i], to[i], option, results ? &(*results)[i] : nullptr);
+    }
+  };
+
+  if (mRaycastThreadPool)
+  {
+    mRaycastThreadPool->parallelFor(numChunks, castChunk);
+  }
+  else
+  {
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk)
+      castChunk(chunk);
+  }
+
+  return std::count(hits.begin(), hits.end(), 1);
+}
+
+//==============================================================================
+void DARTCollisionDetector::setNumRaycastThreads(std::size_t numThreads)
+{
+  if (numThreads == getNumRaycastThreads())
+    return;
+  if (numThreads <= 1)
+    mRaycastThreadPool.reset();
+  else
+    mRaycastThreadPool = std::make_unique<common::ThreadPool>(numThreads);
+}
+
+//==============================================================================
+std::size_t DARTCollisionDetector::getNumRaycastThreads() const
+{
+  return mRaycastThreadPool ? mRaycastThreadPool->getNumThreads() : 1;
 }
 
 //==============================================================================
@@ -292,6 +594,17 @@ void warnUnsupportedShapeType(const dynamics::ShapeFrame* shapeFrame)
   if (shapeType == dynamics::CapsuleShape::getStaticType())
     return;
 
+  if (shapeType == dynamics::PlaneShape::getStaticType())
+    return;
+
+  if (shapeType == dynamics::HeightmapShapef::getStaticType()
+      || shapeType == dynamics::HeightmapShaped::getStaticType())
+    return;
+
+  // Cylinders only collide with spheres and planes
+  if (shapeType == dynamics::CylinderShape::getStaticType())
+    return;
+
   if (shapeType == dynamics::EllipsoidShape::getStaticType())
   {
     const auto& ellipsoid
@@ -305,7 +618,8 @@ void warnUnsupportedShapeType(const dynamics::ShapeFrame* shapeFrame)
         << shapeType << "] that is not supported "
         << "by DARTCollisionDetector. Currently, only BoxShape and "
         << "EllipsoidShape (only when all the radii are equal) and SphereShape "
-           "and MeshShape and CapsuleShape are "
+           "and MeshShape and CapsuleShape and PlaneShape and HeightmapShape "
+           "(and CylinderShape, against spheres and planes) are "
         << "supported. This shape will always get penetrated by other "
         << "objects.\n";
 }
@@ -333,7 +647,8 @@ bool checkPair(
     CollisionObject* o1,
     CollisionObject* o2,
     const CollisionOption& option,
-    CollisionResult* result)
+    CollisionResult* result,
+    DARTContactManifoldCache* manifolds)
 {
   CollisionResult pairResult;
 
@@ -344,11 +659,283 @@ bool checkPair(
   if (!result)
     return pairResult.isCollision();
 
+  if (manifolds)
+    reduceContacts(o1, o2, option, manifolds, pairResult);
+
   postProcess(o1, o2, option, *result, pairResult);
 
   return pairResult.isCollision();
 }
 
+//==============================================================================
+void reduceContacts(
+    CollisionObject* o1,
+    CollisionObject* o2,
+    const CollisionOption& option,
+    DARTContactManifoldCache* manifolds,
+    CollisionResult& pairResult)
+{
+  if (!pairResult.isCollision())
+    return;
+
+  const auto& contacts = pairResult.getContacts();
+  const auto kept = reduceContactManifold(
+      contacts,
+      option.maxNumContactsPerPair,
+      manifolds->getLastPoints(o1, o2));
+
+  std::vector<Eigen::Vector3s> keptPoints;
+  keptPoints.reserve(kept.size());
+  for (auto index : kept)
+    keptPoints.push_back(contacts[index].point);
+  manifolds->setPoints(o1, o2, keptPoints);
+
+  if (kept.size() == contacts.size())
+    return;
+
+  CollisionResult reduced;
+  for (auto index : kept)
+    reduced.addContact(contacts[index]);
+  pairResult = reduced;
+}
+
+//==============================================================================
+bool checkBatch(
+    DARTBatchedNarrowphase& batch,
+    const CollisionOption& option,
+    CollisionResult* result,
+    DARTContactManifoldCache* manifolds,
+    bool& collisionFound,
+    std::size_t& numCulledPairs)
+{
+  batch.cull();
+  numCulledPairs += batch.getNumCulledPairs();
+
+  for (std::size_t i = 0u; i < batch.getNumPairs(); ++i)
+  {
+    // Pairs that were culled still count as checked, so that the return value
+    // matches checking every pair one at a time
+    collisionFound = batch.mayCollide(i)
+                     && checkPair(
+                         batch.getFirstObject(i),
+                         batch.getSecondObject(i),
+                         option,
+                         result,
+                         manifolds);
+
+    if (result)
+    {
+      if (result->getNumContacts() >= option.maxNumContacts)
+        return true;
+    }
+    else
+    {
+      // If no result is passed, stop checking when the first contact is found
+      if (collisionFound)
+        return true;
+    }
+  }
+
+  batch.clearPairs();
+
+  return false;
+}
+
+//==============================================================================
+void QueryScene::build(const std::vector<CollisionObject*>& groupObjects)
+{
+  objects.clear();
+  boxes.clear();
+  bounded.clear();
+  unbounded.clear();
+
+  objects.reserve(groupObjects.size());
+  boxes.resize(groupObjects.size());
+  for (std::size_t i = 0; i < groupObjects.size(); ++i)
+  {
+    auto* object = static_cast<DARTCollisionObject*>(groupObjects[i]);
+    objects.push_back(object);
+
+    // Build any triangle trees now, so queries can run on several threads
+    object->getTriangleBVH();
+
+    if (computeWorldBoundingBox(object, boxes[i]))
+      bounded.push_back(i);
+    else
+      unbounded.push_back(i);
+  }
+
+  std::vector<DARTBVH::AABB> boundedBoxes;
+  boundedBoxes.reserve(bounded.size());
+  for (auto index : bounded)
+    boundedBoxes.push_back(boxes[index]);
+  tree.build(boundedBoxes);
+}
+
+//==============================================================================
+bool raycastScene(
+    const QueryScene& scene,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& to,
+    const RaycastOption& option,
+    RaycastResult* result)
+{
+  const Eigen::Vector3s dir = to - from;
+  std::vector<RayHit> hits;
+
+  // For the closest hit, every hit shortens the ray for everything after it
+  s_t closest = 1.0;
+
+  auto castAt = [&](std::size_t index) {
+    DARTCollisionObject* object = scene.objects[index];
+    s_t fraction = option.mEnableAllHits ? 1.0 : closest;
+    Eigen::Vector3s normal;
+    if (!raycastObject(object, from, to, fraction, normal))
+      return;
+
+    RayHit hit;
+    hit.mCollisionObject = object;
+    hit.mNormal = normal.normalized();
+    hit.mPoint = from + fraction * dir;
+    hit.mFraction = fraction;
+
+    if (option.mEnableAllHits)
+    {
+      hits.push_back(hit);
+    }
+    else
+    {
+      closest = fraction;
+      hits.assign(1u, hit);
+    }
+  };
+
+  scene.tree.raycast(
+      from, dir, 1.0, [&](std::size_t primitive, s_t& maxFraction) {
+        castAt(scene.bounded[primitive]);
+        if (!option.mEnableAllHits)
+          maxFraction = closest;
+      });
+  for (auto index : scene.unbounded)
+    castAt(index);
+
+  if (hits.empty())
+    return false;
+
+  if (result)
+  {
+    if (option.mEnableAllHits && option.mSortByClosest)
+    {
+      std::sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b) {
+        return a.mFraction < b.mFraction;
+      });
+    }
+    result->mRayHits.insert(result->mRayHits.end(), hits.begin(), hits.end());
+  }
+
+  return true;
+}
+
+//==============================================================================
+double distanceScenes(
+    const QueryScene& scene1,
+    const QueryScene* scene2,
+    const DistanceOption& option,
+    DistanceResult* result)
+{
+  const bool self = scene2 == nullptr;
+  const QueryScene& other = self ? scene1 : *scene2;
+  const auto& filter = option.distanceFilter;
+
+  bool found = false;
+  bool done = false;
+  s_t best = std::numeric_limits<s_t>::infinity();
+  DARTCollisionObject* best1 = nullptr;
+  DARTCollisionObject* best2 = nullptr;
+  Eigen::Vector3s bestPoint1 = Eigen::Vector3s::Zero();
+  Eigen::Vector3s bestPoint2 = Eigen::Vector3s::Zero();
+
+  auto checkPair = [&](std::size_t i, std::size_t j) {
+    // Within a single group, only check each pair once
+    if (done || (self && j <= i))
+      return;
+
+    DARTCollisionObject* o1 = scene1.objects[i];
+    DARTCollisionObject* o2 = other.objects[j];
+    if (filter && !filter->needDistance(o1, o2))
+      return;
+
+    s_t distance;
+    Eigen::Vector3s point1;
+    Eigen::Vector3s point2;
+    if (!distanceObjects(o1, o2, best, distance, point1, point2))
+      return;
+
+    // Pairs that are skipped for being farther than `best` come back with an
+    // infinite distance, and don't count as found
+    if (distance < best)
+    {
+      found = true;
+      best = distance;
+      best1 = o1;
+      best2 = o2;
+      bestPoint1 = point1;
+      bestPoint2 = point2;
+    }
+
+    if (best <= option.distanceLowerBound)
+      done = true;
+  };
+
+  for (std::size_t i = 0; i < scene1.objects.size() && !done; ++i)
+  {
+    const bool isBounded = std::binary_search(
+        scene1.bounded.begin(), scene1.bounded.end(), i);
+
+    if (isBounded)
+    {
+      // Boxes never overlap by a negative amount, so while anything is
+      // penetrating we can only prune pairs whose boxes are apart
+      other.tree.query(
+          scene1.boxes[i],
+          std::max(best, s_t(0.0)),
+          [&](std::size_t primitive, s_t& maxDistance) {
+            checkPair(i, other.bounded[primitive]);
+            maxDistance = done ? -std::numeric_limits<s_t>::infinity()
+                               : std::max(best, s_t(0.0));
+          });
+    }
+    else
+    {
+      for (auto j : other.bounded)
+        checkPair(i, j);
+    }
+
+    for (auto j : other.unbounded)
+      checkPair(i, j);
+  }
+
+  if (!found)
+    return 0.0;
+
+  const s_t minDistance = std::max(best, s_t(option.distanceLowerBound));
+
+  if (result)
+  {
+    result->minDistance = minDistance;
+    result->unclampedMinDistance = best;
+    result->shapeFrame1 = best1->getShapeFrame();
+    result->shapeFrame2 = best2->getShapeFrame();
+    if (option.enableNearestPoints)
+    {
+      result->nearestPoint1 = bestPoint1;
+      result->nearestPoint2 = bestPoint2;
+    }
+  }
+
+  return minDistance;
+}
+
 //==============================================================================
 bool isClose(
     const Eigen::Vector3s& pos1, const Eigen::Vector3s& pos2, double tol)
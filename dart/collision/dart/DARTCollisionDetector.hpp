@@ -33,8 +33,11 @@
 #ifndef DART_COLLISION_DART_DARTCOLLISIONDETECTOR_HPP_
 #define DART_COLLISION_DART_DARTCOLLISIONDETECTOR_HPP_
 
+#include <memory>
 #include <vector>
 #include "dart/collision/CollisionDetector.hpp"
+#include "dart/collision/dart/DARTContactManifold.hpp"
+#include "dart/common/ThreadPool.hpp"
 
 namespace dart {
 namespace collision {
@@ -87,6 +90,49 @@ public:
       const DistanceOption& option = DistanceOption(false, 0.0, nullptr),
       DistanceResult* result = nullptr) override;
 
+  // Documentation inherited
+  bool raycast(
+      CollisionGroup* group,
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& to,
+      const RaycastOption& option = RaycastOption(),
+      RaycastResult* result = nullptr) override;
+
+  /// Casts a batch of rays, from `from[i]` to `to[i]`, at the same group.
+  /// This builds the bounding volume hierarchy over the group once for the
+  /// whole batch, and spreads the rays over the raycast threads (see
+  /// setNumRaycastThreads()). If `results` is not nullptr it's resized to the
+  /// number of rays, and entry `i` is filled in just like raycast() would for
+  /// ray `i`. Returns the number of rays that hit something.
+  std::size_t raycastBatch(
+      CollisionGroup* group,
+      const std::vector<Eigen::Vector3s>& from,
+      const std::vector<Eigen::Vector3s>& to,
+      const RaycastOption& option = RaycastOption(),
+      std::vector<RaycastResult>* results = nullptr);
+
+  /// Sets the number of threads raycastBatch() spreads rays over, including
+  /// the calling thread. The default is 1, which runs everything on the
+  /// calling thread.
+  void setNumRaycastThreads(std::size_t numThreads);
+
+  /// Returns the number of threads raycastBatch() spreads rays over
+  std::size_t getNumRaycastThreads() const;
+
+  /// Sets whether candidate pairs are culled in bulk with
+  /// DARTBatchedNarrowphase before running the exact narrowphase. This doesn't
+  /// change the contacts that are found, only how fast they are found. On by
+  /// default.
+  void setUseBatchedNarrowphase(bool use);
+
+  /// Returns whether candidate pairs are culled in bulk before running the
+  /// exact narrowphase
+  bool getUseBatchedNarrowphase() const;
+
+  /// Returns the number of candidate pairs that the last collide() call ruled
+  /// out in bulk, without running the exact narrowphase
+  std::size_t getNumCulledPairs() const;
+
 protected:
 
   /// Constructor
@@ -99,6 +145,20 @@ protected:
   // Documentation inherited
   void refreshCollisionObject(CollisionObject* object) override;
 
+  /// Whether to cull candidate pairs with DARTBatchedNarrowphase
+  bool mUseBatchedNarrowphase = true;
+
+  /// The number of pairs the last collide() call culled in bulk
+  std::size_t mNumCulledPairs = 0u;
+
+  /// The contact points kept for each pair on the last check, when
+  /// CollisionOption::maxNumContactsPerPair is set
+  DARTContactManifoldCache mContactManifolds;
+
+  /// The threads raycastBatch() uses, or nullptr to use only the calling
+  /// thread
+  std::unique_ptr<common::ThreadPool> mRaycastThreadPool;
+
 private:
   static Registrar<DARTCollisionDetector> mRegistrar;
 };
@@ -32,6 +32,9 @@
 
 #include "dart/collision/dart/DARTCollisionObject.hpp"
 
+#include "dart/dynamics/HeightmapShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+
 namespace dart {
 namespace collision {
 
@@ -39,11 +42,52 @@ namespace collision {
 DARTCollisionObject::DARTCollisionObject(
     CollisionDetector* collisionDetector,
     const dynamics::ShapeFrame* shapeFrame)
-  : CollisionObject(collisionDetector, shapeFrame)
+  : CollisionObject(collisionDetector, shapeFrame),
+    mTriangleSource(nullptr),
+    mTriangleVersion(0u),
+    mTriangleScale(Eigen::Vector3s::Zero())
 {
   // Do nothing
 }
 
+//==============================================================================
+const DARTTriangleBVH* DARTCollisionObject::getTriangleBVH()
+{
+  const auto shape = getShape();
+  const auto& type = shape->getType();
+
+  if (type == dynamics::MeshShape::getStaticType())
+  {
+    const auto* mesh = static_cast<const dynamics::MeshShape*>(shape.get());
+    if (!mTriangleBVH || mTriangleSource != mesh->getMesh()
+        || mTriangleScale != mesh->getScale())
+    {
+      mTriangleBVH
+          = DARTTriangleBVH::createFromMesh(mesh->getMesh(), mesh->getScale());
+      mTriangleSource = mesh->getMesh();
+      mTriangleScale = mesh->getScale();
+    }
+    return mTriangleBVH.get();
+  }
+
+  if (type == dynamics::HeightmapShapef::getStaticType()
+      || type == dynamics::HeightmapShaped::getStaticType())
+  {
+    if (!mTriangleBVH || mTriangleSource != shape.get()
+        || mTriangleVersion != shape->getVersion())
+    {
+      mTriangleBVH = DARTTriangleBVH::createFromHeightmap(shape.get());
+      mTriangleSource = shape.get();
+      mTriangleVersion = shape->getVersion();
+    }
+    return mTriangleBVH.get();
+  }
+
+  mTriangleBVH.reset();
+  mTriangleSource = nullptr;
+  return nullptr;
+}
+
 //==============================================================================
 void DARTCollisionObject::updateEngineData()
 {
@@ -33,8 +33,11 @@
 #ifndef DART_COLLISION_DART_DARTCOLLISIONOBJECT_HPP_
 #define DART_COLLISION_DART_DARTCOLLISIONOBJECT_HPP_
 
+#include <memory>
+
 #include <Eigen/Dense>
 #include "dart/collision/CollisionObject.hpp"
+#include "dart/collision/dart/DARTTriangleBVH.hpp"
 
 namespace dart {
 namespace collision {
@@ -47,6 +50,13 @@ public:
 
   friend class DARTCollisionDetector;
 
+  /// Returns a DARTTriangleBVH over the triangles of this object's mesh or
+  /// heightmap, in the frame of the shape, or nullptr for any other shape. The
+  /// tree is built on first use, and rebuilt when the shape changes. This
+  /// isn't thread safe, so call it once before sharing the object between
+  /// threads.
+  const DARTTriangleBVH* getTriangleBVH();
+
 protected:
 
   /// Constructor
@@ -56,6 +66,19 @@ protected:
   // Documentation inherited
   void updateEngineData() override;
 
+  /// The cached triangles, if any
+  std::shared_ptr<DARTTriangleBVH> mTriangleBVH;
+
+  /// What mTriangleBVH was built from: the mesh, or the heightmap shape
+  const void* mTriangleSource;
+
+  /// The shape version mTriangleBVH was built at
+  std::size_t mTriangleVersion;
+
+  /// The mesh scale mTriangleBVH was built with. MeshShape::setMesh() doesn't
+  /// bump the shape version, so the mesh and scale are checked directly.
+  Eigen::Vector3s mTriangleScale;
+
 };
 
 }  // namespace collision
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTContactManifold.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "dart/collision/CollisionObject.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// How much a contact that was kept last step gets its score scaled up by
+constexpr s_t kPersistenceBonus = 1.25;
+
+/// Gains below this are treated as no gain at all
+constexpr s_t kDegenerateGain = 1e-12;
+
+//==============================================================================
+s_t cross2D(
+    const Eigen::Vector2s& o,
+    const Eigen::Vector2s& a,
+    const Eigen::Vector2s& b)
+{
+  return (a(0) - o(0)) * (b(1) - o(1)) - (a(1) - o(1)) * (b(0) - o(0));
+}
+
+//==============================================================================
+/// Returns the area of the convex hull of a (small) set of points, using
+/// Andrew's monotone chain
+s_t convexHullArea(std::vector<Eigen::Vector2s> points)
+{
+  if (points.size() < 3)
+    return 0.0;
+
+  std::sort(
+      points.begin(),
+      points.end(),
+      [](const Eigen::Vector2s& a, const Eigen::Vector2s& b) {
+        return a(0) < b(0) || (a(0) == b(0) && a(1) < b(1));
+      });
+
+  std::vector<Eigen::Vector2s> hull(2 * points.size());
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    while (k >= 2 && cross2D(hull[k - 2], hull[k - 1], points[i]) <= 0)
+      --k;
+    hull[k++] = points[i];
+  }
+  for (std::size_t i = points.size() - 1, t = k + 1; i > 0; --i)
+  {
+    while (k >= t && cross2D(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+      --k;
+    hull[k++] = points[i - 1];
+  }
+  // The last point is a repeat of the first
+  hull.resize(k - 1);
+
+  s_t area = 0.0;
+  for (std::size_t i = 0; i < hull.size(); ++i)
+  {
+    const Eigen::Vector2s& a = hull[i];
+    const Eigen::Vector2s& b = hull[(i + 1) % hull.size()];
+    area += a(0) * b(1) - a(1) * b(0);
+  }
+
+  return 0.5 * std::abs(area);
+}
+
+//==============================================================================
+/// Returns the index of the unchosen candidate with the highest score, with
+/// persistent candidates getting a bonus
+std::size_t pickBest(
+    const std::vector<s_t>& scores,
+    const std::vector<bool>& chosen,
+    const std::vector<bool>& persistent)
+{
+  std::size_t best = scores.size();
+  s_t bestScore = 0.0;
+  for (std::size_t i = 0; i < scores.size(); ++i)
+  {
+    if (chosen[i])
+      continue;
+
+    const s_t score = persistent[i] ? scores[i] * kPersistenceBonus : scores[i];
+    if (best == scores.size() || score > bestScore)
+    {
+      best = i;
+      bestScore = score;
+    }
+  }
+
+  return best;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+std::vector<std::size_t> reduceContactManifold(
+    const std::vector<Contact>& contacts,
+    std::size_t maxNumContacts,
+    const std::vector<Eigen::Vector3s>& preferredPoints,
+    s_t preferredPointTolerance)
+{
+  const std::size_t n = contacts.size();
+  std::vector<std::size_t> kept;
+
+  if (n <= maxNumContacts)
+  {
+    kept.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+      kept[i] = i;
+    return kept;
+  }
+
+  if (maxNumContacts == 0u)
+    return kept;
+
+  // Find the contacts that were kept last time
+  const s_t toleranceSquared
+      = preferredPointTolerance * preferredPointTolerance;
+  std::vector<bool> persistent(n, false);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    for (const Eigen::Vector3s& point : preferredPoints)
+    {
+      if ((contacts[i].point - point).squaredNorm() <= toleranceSquared)
+      {
+        persistent[i] = true;
+        break;
+      }
+    }
+  }
+
+  // Build a frame in the plane of the manifold, so that areas are measured
+  // perpendicular to the contact normal
+  Eigen::Vector3s normal = Eigen::Vector3s::Zero();
+  for (const Contact& contact : contacts)
+    normal += contact.normal;
+  if (normal.squaredNorm() < kDegenerateGain)
+    normal = contacts[0].normal;
+  if (normal.squaredNorm() < kDegenerateGain)
+    normal = Eigen::Vector3s::UnitZ();
+  normal.normalize();
+
+  Eigen::Vector3s u = normal.unitOrthogonal();
+  Eigen::Vector3s v = normal.cross(u);
+  std::vector<Eigen::Vector2s> projected(n);
+  for (std::size_t i = 0; i < n; ++i)
+    projected[i] = Eigen::Vector2s(
+        contacts[i].point.dot(u), contacts[i].point.dot(v));
+
+  std::vector<bool> chosen(n, false);
+  std::vector<s_t> scores(n, 0.0);
+
+  // 1. The deepest contact
+  for (std::size_t i = 0; i < n; ++i)
+    scores[i] = std::max(contacts[i].penetrationDepth, s_t(0.0))
+                + kDegenerateGain;
+  std::size_t first = pickBest(scores, chosen, persistent);
+  chosen[first] = true;
+  kept.push_back(first);
+
+  while (kept.size() < maxNumContacts)
+  {
+    // 2. and beyond: the contact that grows the manifold the most
+    std::vector<Eigen::Vector2s> hull;
+    for (std::size_t index : kept)
+      hull.push_back(projected[index]);
+    const s_t area = convexHullArea(hull);
+
+    bool anyGain = false;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      scores[i] = 0.0;
+      if (chosen[i] || kept.size() < 2u)
+        continue;
+
+      hull.push_back(projected[i]);
+      scores[i] = convexHullArea(hull) - area;
+      hull.pop_back();
+
+      if (scores[i] > kDegenerateGain)
+        anyGain = true;
+    }
+
+    // If no contact adds any area (for the second contact, or when the contacts
+    // are all on a line), spread them out instead
+    if (!anyGain)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (chosen[i])
+          continue;
+
+        s_t closest = std::numeric_limits<s_t>::infinity();
+        for (std::size_t index : kept)
+        {
+          closest = std::min(
+              closest,
+              (contacts[i].point - contacts[index].point).squaredNorm());
+        }
+        scores[i] = closest;
+      }
+    }
+
+    std::size_t next = pickBest(scores, chosen, persistent);
+    chosen[next] = true;
+    kept.push_back(next);
+  }
+
+  std::sort(kept.begin(), kept.end());
+
+  return kept;
+}
+
+//==============================================================================
+void DARTContactManifoldCache::startCheck()
+{
+  mLastPoints.swap(mPoints);
+  mPoints.clear();
+}
+
+//==============================================================================
+void DARTContactManifoldCache::clear()
+{
+  mLastPoints.clear();
+  mPoints.clear();
+}
+
+//==============================================================================
+std::vector<Eigen::Vector3s> DARTContactManifoldCache::getLastPoints(
+    const CollisionObject* o1, const CollisionObject* o2) const
+{
+  std::vector<Eigen::Vector3s> points;
+
+  auto it = mLastPoints.find(ObjectPair(o1, o2));
+  if (it == mLastPoints.end())
+    return points;
+
+  const Eigen::Isometry3s& T = o1->getTransform();
+  points.reserve(it->second.size());
+  for (const Eigen::Vector3s& localPoint : it->second)
+    points.push_back(T * localPoint);
+
+  return points;
+}
+
+//==============================================================================
+void DARTContactManifoldCache::setPoints(
+    const CollisionObject* o1,
+    const CollisionObject* o2,
+    const std::vector<Eigen::Vector3s>& points)
+{
+  const Eigen::Isometry3s T = o1->getTransform().inverse();
+  std::vector<Eigen::Vector3s>& localPoints = mPoints[ObjectPair(o1, o2)];
+  localPoints.clear();
+  localPoints.reserve(points.size());
+  for (const Eigen::Vector3s& point : points)
+    localPoints.push_back(T * point);
+}
+
+} // namespace collision
+} // namespace dart
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTCONTACTMANIFOLD_HPP_
+#define DART_COLLISION_DART_DARTCONTACTMANIFOLD_HPP_
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/collision/Contact.hpp"
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+class CollisionObject;
+
+/// This picks which of the contacts between a single pair of objects to keep,
+/// when there are more than `maxNumContacts` of them. It keeps the deepest
+/// contact, then the contact farthest from it, then greedily adds whichever
+/// contact grows the area of the manifold (projected along the average normal)
+/// the most. Contacts that are close to one of the `preferredPoints` (usually
+/// the points kept last step) win ties and near-ties, so that resting
+/// contacts keep the same features from one step to the next.
+///
+/// This returns the indices of the contacts to keep, in increasing order, so
+/// the relative order of the surviving contacts is unchanged. The contacts
+/// themselves aren't modified, so all the metadata that the gradients need is
+/// carried over as-is.
+std::vector<std::size_t> reduceContactManifold(
+    const std::vector<Contact>& contacts,
+    std::size_t maxNumContacts,
+    const std::vector<Eigen::Vector3s>& preferredPoints
+    = std::vector<Eigen::Vector3s>(),
+    s_t preferredPointTolerance = 1e-3);
+
+/// This remembers which contact points were kept for each pair of objects on
+/// the last collision check, in the frame of the first object, so that
+/// reduceContactManifold() can prefer the same points on the next check.
+class DARTContactManifoldCache
+{
+public:
+  /// Call this at the start of every collision check. The points recorded
+  /// during the previous check become the ones returned by getLastPoints().
+  void startCheck();
+
+  /// Forgets everything
+  void clear();
+
+  /// Returns the points kept for this pair on the last check, transformed into
+  /// the world frame using the current transform of `o1`
+  std::vector<Eigen::Vector3s> getLastPoints(
+      const CollisionObject* o1, const CollisionObject* o2) const;
+
+  /// Records the (world frame) points that were kept for this pair on this
+  /// check
+  void setPoints(
+      const CollisionObject* o1,
+      const CollisionObject* o2,
+      const std::vector<Eigen::Vector3s>& points);
+
+protected:
+  using ObjectPair = std::pair<const CollisionObject*, const CollisionObject*>;
+
+  /// The points from the last check, in the frame of the first object
+  std::map<ObjectPair, std::vector<Eigen::Vector3s>> mLastPoints;
+
+  /// The points from this check, in the frame of the first object
+  std::map<ObjectPair, std::vector<Eigen::Vector3s>> mPoints;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTCONTACTMANIFOLD_HPP_
@@ -0,0 +1,756 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTDistance.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "dart/collision/CollisionOption.hpp"
+#include "dart/collision/CollisionResult.hpp"
+#include "dart/collision/dart/DARTCollide.hpp"
+#include "dart/collision/dart/DARTCollisionObject.hpp"
+#include "dart/collision/dart/DARTRaycast.hpp"
+#include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/CapsuleShape.hpp"
+#include "dart/dynamics/CylinderShape.hpp"
+#include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/HeightmapShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+#include "dart/dynamics/PlaneShape.hpp"
+#include "dart/dynamics/SphereShape.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+/// GJK stops once the distance estimate improves by less than this fraction
+constexpr s_t kGJKRelativeTolerance = 1e-10;
+
+/// GJK treats distances below this as touching
+constexpr s_t kGJKAbsoluteTolerance = 1e-12;
+
+constexpr int kGJKMaxIterations = 64;
+
+//==============================================================================
+/// A convex shape described by its support function in world coordinates
+struct ConvexShape
+{
+  enum Kind
+  {
+    SPHERE,
+    ELLIPSOID,
+    BOX,
+    CAPSULE,
+    CYLINDER,
+    POINTS,
+    UNSUPPORTED
+  };
+
+  Kind kind = UNSUPPORTED;
+  Eigen::Isometry3s transform = Eigen::Isometry3s::Identity();
+
+  /// Sphere and capsule radius, or cylinder radius
+  s_t radius = 0.0;
+
+  /// Half the height of a capsule or cylinder
+  s_t halfHeight = 0.0;
+
+  /// Ellipsoid radii, or half the size of a box
+  Eigen::Vector3s extents = Eigen::Vector3s::Zero();
+
+  /// The points whose convex hull this is, in the local frame, for POINTS
+  const Eigen::Vector3s* points = nullptr;
+  std::size_t numPoints = 0;
+
+  /// Returns the point of the shape farthest along `dir`, in world coordinates
+  Eigen::Vector3s support(const Eigen::Vector3s& dir) const
+  {
+    const Eigen::Vector3s d = transform.linear().transpose() * dir;
+    Eigen::Vector3s local = Eigen::Vector3s::Zero();
+    const s_t norm = d.norm();
+
+    switch (kind)
+    {
+      case SPHERE:
+        if (norm > 0.0)
+          local = radius * d / norm;
+        break;
+      case ELLIPSOID:
+      {
+        const Eigen::Vector3s scaled = extents.cwiseProduct(d);
+        const s_t scaledNorm = scaled.norm();
+        if (scaledNorm > 0.0)
+          local = extents.cwiseProduct(scaled) / scaledNorm;
+        break;
+      }
+      case BOX:
+        for (int i = 0; i < 3; ++i)
+          local(i) = d(i) < 0.0 ? -extents(i) : extents(i);
+        break;
+      case CAPSULE:
+        local(2) = d(2) < 0.0 ? -halfHeight : halfHeight;
+        if (norm > 0.0)
+          local += radius * d / norm;
+        break;
+      case CYLINDER:
+      {
+        local(2) = d(2) < 0.0 ? -halfHeight : halfHeight;
+        const s_t radial = std::sqrt(d(0) * d(0) + d(1) * d(1));
+        if (radial > 0.0)
+        {
+          local(0) = radius * d(0) / radial;
+          local(1) = radius * d(1) / radial;
+        }
+        break;
+      }
+      case POINTS:
+      {
+        s_t best = -std::numeric_limits<s_t>::infinity();
+        for (std::size_t i = 0; i < numPoints; ++i)
+        {
+          const s_t projection = points[i].dot(d);
+          if (projection > best)
+          {
+            best = projection;
+            local = points[i];
+          }
+        }
+        break;
+      }
+      case UNSUPPORTED:
+        break;
+    }
+
+    return transform * local;
+  }
+
+  /// Returns a point inside the shape
+  Eigen::Vector3s center() const
+  {
+    if (kind == POINTS && numPoints > 0)
+      return transform * points[0];
+    return transform.translation();
+  }
+};
+
+//==============================================================================
+/// Describes `object` as a ConvexShape, if it is one
+ConvexShape makeConvexShape(DARTCollisionObject* object)
+{
+  ConvexShape convex;
+  convex.transform = object->getTransform();
+
+  const auto shape = object->getShape();
+  const auto& type = shape->getType();
+
+  if (type == dynamics::SphereShape::getStaticType())
+  {
+    convex.kind = ConvexShape::SPHERE;
+    convex.radius
+        = static_cast<const dynamics::SphereShape*>(shape.get())->getRadius();
+  }
+  else if (type == dynamics::EllipsoidShape::getStaticType())
+  {
+    convex.kind = ConvexShape::ELLIPSOID;
+    convex.extents
+        = static_cast<const dynamics::EllipsoidShape*>(shape.get())->getRadii();
+  }
+  else if (type == dynamics::BoxShape::getStaticType())
+  {
+    convex.kind = ConvexShape::BOX;
+    convex.extents
+        = 0.5 * static_cast<const dynamics::BoxShape*>(shape.get())->getSize();
+  }
+  else if (type == dynamics::CapsuleShape::getStaticType())
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(shape.get());
+    convex.kind = ConvexShape::CAPSULE;
+    convex.radius = capsule->getRadius();
+    convex.halfHeight = 0.5 * capsule->getHeight();
+  }
+  else if (type == dynamics::CylinderShape::getStaticType())
+  {
+    const auto* cylinder
+        = static_cast<const dynamics::CylinderShape*>(shape.get());
+    convex.kind = ConvexShape::CYLINDER;
+    convex.radius = cylinder->getRadius();
+    convex.halfHeight = 0.5 * cylinder->getHeight();
+  }
+  else if (type == dynamics::MeshShape::getStaticType())
+  {
+    const DARTTriangleBVH* triangles = object->getTriangleBVH();
+    if (triangles && !triangles->getVertices().empty())
+    {
+      convex.kind = ConvexShape::POINTS;
+      convex.points = triangles->getVertices().data();
+      convex.numPoints = triangles->getVertices().size();
+    }
+  }
+
+  return convex;
+}
+
+//==============================================================================
+struct SimplexVertex
+{
+  /// The point of the Minkowski difference, a - b
+  Eigen::Vector3s w;
+  /// The support points on each shape that make up w
+  Eigen::Vector3s a;
+  Eigen::Vector3s b;
+};
+
+//==============================================================================
+/// Returns the barycentric coordinates of the point of triangle (a, b, c)
+/// closest to the origin, from "Real-Time Collision Detection" (Ericson)
+Eigen::Vector3s closestOnTriangle(
+    const Eigen::Vector3s& a,
+    const Eigen::Vector3s& b,
+    const Eigen::Vector3s& c)
+{
+  const Eigen::Vector3s ab = b - a;
+  const Eigen::Vector3s ac = c - a;
+  const Eigen::Vector3s ap = -a;
+
+  const s_t d1 = ab.dot(ap);
+  const s_t d2 = ac.dot(ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+    return Eigen::Vector3s(1.0, 0.0, 0.0);
+
+  const Eigen::Vector3s bp = -b;
+  const s_t d3 = ab.dot(bp);
+  const s_t d4 = ac.dot(bp);
+  if (d3 >= 0.0 && d4 <= d3)
+    return Eigen::Vector3s(0.0, 1.0, 0.0);
+
+  const s_t vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+  {
+    const s_t v = d1 / (d1 - d3);
+    return Eigen::Vector3s(1.0 - v, v, 0.0);
+  }
+
+  const Eigen::Vector3s cp = -c;
+  const s_t d5 = ab.dot(cp);
+  const s_t d6 = ac.dot(cp);
+  if (d6 >= 0.0 && d5 <= d6)
+    return Eigen::Vector3s(0.0, 0.0, 1.0);
+
+  const s_t vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+  {
+    const s_t w = d2 / (d2 - d6);
+    return Eigen::Vector3s(1.0 - w, 0.0, w);
+  }
+
+  const s_t va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+  {
+    const s_t w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return Eigen::Vector3s(0.0, 1.0 - w, w);
+  }
+
+  const s_t denom = 1.0 / (va + vb + vc);
+  const s_t v = vb * denom;
+  const s_t w = vc * denom;
+  return Eigen::Vector3s(1.0 - v - w, v, w);
+}
+
+//==============================================================================
+/// Replaces `simplex` with the smallest sub-simplex containing its point
+/// closest to the origin, sets `weights` to the barycentric coordinates of that
+/// point on the new simplex, and returns the point. Returns false if the
+/// origin is inside a full tetrahedron.
+bool reduceSimplex(
+    std::vector<SimplexVertex>& simplex,
+    std::vector<s_t>& weights,
+    Eigen::Vector3s& closest)
+{
+  weights.assign(simplex.size(), 0.0);
+
+  if (simplex.size() == 1)
+  {
+    weights[0] = 1.0;
+  }
+  else if (simplex.size() == 2)
+  {
+    const Eigen::Vector3s& a = simplex[0].w;
+    const Eigen::Vector3s ab = simplex[1].w - a;
+    const s_t lengthSquared = ab.squaredNorm();
+    s_t t = lengthSquared > 0.0 ? -a.dot(ab) / lengthSquared : 0.0;
+    t = std::max(s_t(0.0), std::min(s_t(1.0), t));
+    weights[0] = 1.0 - t;
+    weights[1] = t;
+  }
+  else if (simplex.size() == 3)
+  {
+    const Eigen::Vector3s bary
+        = closestOnTriangle(simplex[0].w, simplex[1].w, simplex[2].w);
+    for (int i = 0; i < 3; ++i)
+      weights[i] = bary(i);
+  }
+  else
+  {
+    static const int faces[4][4]
+        = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+
+    // A flat tetrahedron can't contain the origin, so just find the nearest
+    // of its faces
+    const Eigen::Vector3s& w0 = simplex[0].w;
+    const s_t volume = (simplex[1].w - w0)
+                           .cross(simplex[2].w - w0)
+                           .dot(simplex[3].w - w0);
+    s_t scale = 0.0;
+    for (const auto& vertex : simplex)
+      scale = std::max(scale, (vertex.w - w0).norm());
+    const bool flat = std::abs(volume) <= 1e-12 * scale * scale * scale;
+
+    s_t bestDistance = std::numeric_limits<s_t>::infinity();
+    bool outside = false;
+    for (const auto& face : faces)
+    {
+      const Eigen::Vector3s& a = simplex[face[0]].w;
+      const Eigen::Vector3s& b = simplex[face[1]].w;
+      const Eigen::Vector3s& c = simplex[face[2]].w;
+      const Eigen::Vector3s& d = simplex[face[3]].w;
+
+      // The origin can only be closest to this face if it's on the other side
+      // of it from the fourth vertex
+      const Eigen::Vector3s n = (b - a).cross(c - a);
+      if (!flat && n.dot(-a) * n.dot(d - a) >= 0.0)
+        continue;
+
+      outside = true;
+      const Eigen::Vector3s bary = closestOnTriangle(a, b, c);
+      const Eigen::Vector3s point = bary(0) * a + bary(1) * b + bary(2) * c;
+      const s_t distance = point.squaredNorm();
+      if (distance < bestDistance)
+      {
+        bestDistance = distance;
+        std::fill(weights.begin(), weights.end(), 0.0);
+        for (int i = 0; i < 3; ++i)
+          weights[face[i]] = bary(i);
+      }
+    }
+
+    if (!outside)
+      return false;
+  }
+
+  std::vector<SimplexVertex> reducedSimplex;
+  std::vector<s_t> reducedWeights;
+  closest.setZero();
+  for (std::size_t i = 0; i < simplex.size(); ++i)
+  {
+    if (weights[i] <= 0.0)
+      continue;
+    closest += weights[i] * simplex[i].w;
+    reducedSimplex.push_back(simplex[i]);
+    reducedWeights.push_back(weights[i]);
+  }
+  simplex.swap(reducedSimplex);
+  weights.swap(reducedWeights);
+
+  return true;
+}
+
+//==============================================================================
+/// Returns the distance between two convex shapes, or zero if they overlap,
+/// and the nearest point on each
+s_t gjkDistance(
+    const ConvexShape& shapeA,
+    const ConvexShape& shapeB,
+    Eigen::Vector3s& pointA,
+    Eigen::Vector3s& pointB)
+{
+  std::vector<SimplexVertex> simplex;
+  std::vector<s_t> weights;
+  simplex.reserve(4);
+  weights.reserve(4);
+
+  SimplexVertex first;
+  first.a = shapeA.center();
+  first.b = shapeB.center();
+  first.w = first.a - first.b;
+  simplex.push_back(first);
+  weights.push_back(1.0);
+  Eigen::Vector3s v = first.w;
+
+  for (int iteration = 0; iteration < kGJKMaxIterations; ++iteration)
+  {
+    if (v.squaredNorm() <= kGJKAbsoluteTolerance * kGJKAbsoluteTolerance)
+      break;
+
+    SimplexVertex next;
+    next.a = shapeA.support(-v);
+    next.b = shapeB.support(v);
+    next.w = next.a - next.b;
+
+    // No meaningful progress, so v is as close as it gets
+    const s_t vv = v.squaredNorm();
+    if (vv - v.dot(next.w) <= kGJKRelativeTolerance * vv)
+      break;
+
+    std::vector<SimplexVertex> candidate = simplex;
+    candidate.push_back(next);
+    std::vector<s_t> candidateWeights;
+    if (!reduceSimplex(candidate, candidateWeights, v))
+    {
+      v.setZero();
+      break;
+    }
+    simplex.swap(candidate);
+    weights.swap(candidateWeights);
+  }
+
+  pointA.setZero();
+  pointB.setZero();
+  for (std::size_t i = 0; i < simplex.size(); ++i)
+  {
+    pointA += weights[i] * simplex[i].a;
+    pointB += weights[i] * simplex[i].b;
+  }
+
+  return v.norm();
+}
+
+//==============================================================================
+/// Returns minus the deepest penetration DARTCollide finds between the two
+/// objects, or zero if it doesn't find any, and sets the nearest points
+/// either side of the deepest contact
+s_t penetrationDistance(
+    DARTCollisionObject* o1,
+    DARTCollisionObject* o2,
+    Eigen::Vector3s& point1,
+    Eigen::Vector3s& point2)
+{
+  CollisionOption option;
+  option.contactClippingDepth = std::numeric_limits<s_t>::infinity();
+  CollisionResult result;
+  collide(o1, o2, option, result);
+
+  s_t depth = 0.0;
+  for (const Contact& contact : result.getContacts())
+  {
+    if (contact.penetrationDepth <= depth)
+      continue;
+
+    depth = contact.penetrationDepth;
+    // The normal points from o2 to o1
+    point1 = contact.point - 0.5 * depth * contact.normal;
+    point2 = contact.point + 0.5 * depth * contact.normal;
+  }
+
+  return -depth;
+}
+
+//==============================================================================
+bool isHeightmap(const std::string& type)
+{
+  return type == dynamics::HeightmapShapef::getStaticType()
+         || type == dynamics::HeightmapShaped::getStaticType();
+}
+
+//==============================================================================
+/// The signed distance from a convex shape to the solid below a plane
+s_t distanceConvexPlane(
+    const ConvexShape& convex,
+    DARTCollisionObject* planeObject,
+    Eigen::Vector3s& convexPoint,
+    Eigen::Vector3s& planePoint)
+{
+  const auto* plane
+      = static_cast<const dynamics::PlaneShape*>(planeObject->getShape().get());
+  const Eigen::Isometry3s& T = planeObject->getTransform();
+  const Eigen::Vector3s normal = T.linear() * plane->getNormal();
+  const s_t offset = plane->getOffset() + normal.dot(T.translation());
+
+  convexPoint = convex.support(-normal);
+  const s_t distance = normal.dot(convexPoint) - offset;
+  planePoint = convexPoint - distance * normal;
+  return distance;
+}
+
+//==============================================================================
+/// Returns a box in the frame `T` that contains the world frame box `worldBox`
+DARTBVH::AABB toLocalBox(
+    const DARTBVH::AABB& worldBox, const Eigen::Isometry3s& T)
+{
+  const Eigen::Isometry3s inverse = T.inverse();
+  const Eigen::Vector3s center = inverse * worldBox.center();
+  const Eigen::Vector3s half
+      = inverse.linear().cwiseAbs() * (0.5 * worldBox.sizes());
+  return DARTBVH::AABB(center - half, center + half);
+}
+
+//==============================================================================
+/// The distance from a convex shape inside the world frame box `worldBox` to
+/// the nearest triangle of a heightmap or mesh, or infinity if no triangle is
+/// within maxDistance
+s_t distanceConvexTriangles(
+    const ConvexShape& convex,
+    const DARTBVH::AABB& worldBox,
+    DARTCollisionObject* trianglesObject,
+    s_t maxDistance,
+    Eigen::Vector3s& convexPoint,
+    Eigen::Vector3s& trianglesPoint)
+{
+  const DARTTriangleBVH* triangles = trianglesObject->getTriangleBVH();
+  if (!triangles)
+    return std::numeric_limits<s_t>::infinity();
+
+  const Eigen::Isometry3s& T = trianglesObject->getTransform();
+  s_t best = std::numeric_limits<s_t>::infinity();
+  triangles->getTree().query(
+      toLocalBox(worldBox, T),
+      std::max(maxDistance, s_t(0.0)),
+      [&](std::size_t i, s_t& limit) {
+        Eigen::Vector3s corners[3];
+        triangles->getTriangle(i, corners);
+
+        ConvexShape triangle;
+        triangle.kind = ConvexShape::POINTS;
+        triangle.transform = T;
+        triangle.points = corners;
+        triangle.numPoints = 3;
+
+        Eigen::Vector3s a;
+        Eigen::Vector3s b;
+        const s_t distance = gjkDistance(convex, triangle, a, b);
+        if (distance < best)
+        {
+          best = distance;
+          convexPoint = a;
+          trianglesPoint = b;
+          limit = std::min(limit, best);
+        }
+      });
+
+  return best;
+}
+
+//==============================================================================
+/// The distance from a convex object to the nearest triangle of a heightmap,
+/// or infinity if no triangle is within maxDistance
+s_t distanceConvexHeightmap(
+    const ConvexShape& convex,
+    DARTCollisionObject* convexObject,
+    DARTCollisionObject* heightmapObject,
+    s_t maxDistance,
+    Eigen::Vector3s& convexPoint,
+    Eigen::Vector3s& heightmapPoint)
+{
+  DARTBVH::AABB worldBox;
+  if (!computeWorldBoundingBox(convexObject, worldBox))
+    return std::numeric_limits<s_t>::infinity();
+
+  return distanceConvexTriangles(
+      convex,
+      worldBox,
+      heightmapObject,
+      maxDistance,
+      convexPoint,
+      heightmapPoint);
+}
+
+//==============================================================================
+/// The distance from a mesh's triangles to another mesh's triangles, or to a
+/// convex object, or infinity if nothing is within maxDistance. Unlike the
+/// convex hull, this gets concave meshes right. Returns false if `other`
+/// isn't supported.
+bool distanceMeshTriangles(
+    DARTCollisionObject* meshObject,
+    DARTCollisionObject* other,
+    s_t maxDistance,
+    s_t& distance,
+    Eigen::Vector3s& meshPoint,
+    Eigen::Vector3s& otherPoint)
+{
+  distance = std::numeric_limits<s_t>::infinity();
+  const bool otherIsMesh
+      = other->getShape()->getType() == dynamics::MeshShape::getStaticType();
+  const ConvexShape convex = makeConvexShape(other);
+  if (!otherIsMesh && convex.kind == ConvexShape::UNSUPPORTED)
+    return false;
+
+  DARTBVH::AABB otherBox;
+  const DARTTriangleBVH* triangles = meshObject->getTriangleBVH();
+  if (!triangles || !computeWorldBoundingBox(other, otherBox))
+    return true;
+
+  if (!otherIsMesh)
+  {
+    distance = distanceConvexTriangles(
+        convex, otherBox, meshObject, maxDistance, otherPoint, meshPoint);
+    return true;
+  }
+
+  // Each of our triangles near the other mesh is a convex shape in its own
+  // right, which we can measure against the other mesh's triangles
+  const Eigen::Isometry3s& T = meshObject->getTransform();
+  triangles->getTree().query(
+      toLocalBox(otherBox, T),
+      std::max(maxDistance, s_t(0.0)),
+      [&](std::size_t i, s_t& limit) {
+        Eigen::Vector3s corners[3];
+        triangles->getTriangle(i, corners);
+
+        ConvexShape triangle;
+        triangle.kind = ConvexShape::POINTS;
+        triangle.transform = T;
+        triangle.points = corners;
+        triangle.numPoints = 3;
+
+        DARTBVH::AABB triangleBox;
+        for (const auto& corner : corners)
+          triangleBox.extend(T * corner);
+
+        Eigen::Vector3s a;
+        Eigen::Vector3s b;
+        const s_t triangleDistance
+            = distanceConvexTriangles(triangle, triangleBox, other, limit, a, b);
+        if (triangleDistance < distance)
+        {
+          distance = triangleDistance;
+          meshPoint = a;
+          otherPoint = b;
+          limit = std::min(limit, distance);
+        }
+      });
+
+  return true;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+bool distanceObjects(
+    DARTCollisionObject* o1,
+    DARTCollisionObject* o2,
+    s_t maxDistance,
+    s_t& distance,
+    Eigen::Vector3s& point1,
+    Eigen::Vector3s& point2)
+{
+  const auto& type1 = o1->getShape()->getType();
+  const auto& type2 = o2->getShape()->getType();
+  const bool isPlane1 = type1 == dynamics::PlaneShape::getStaticType();
+  const bool isPlane2 = type2 == dynamics::PlaneShape::getStaticType();
+  const bool isHeightmap1 = isHeightmap(type1);
+  const bool isHeightmap2 = isHeightmap(type2);
+
+  if ((isPlane1 || isHeightmap1) && (isPlane2 || isHeightmap2))
+    return false;
+
+  if (isPlane1 || isPlane2)
+  {
+    const ConvexShape convex = makeConvexShape(isPlane1 ? o2 : o1);
+    if (convex.kind == ConvexShape::UNSUPPORTED)
+      return false;
+
+    if (isPlane1)
+      distance = distanceConvexPlane(convex, o1, point2, point1);
+    else
+      distance = distanceConvexPlane(convex, o2, point1, point2);
+    return true;
+  }
+
+  if (isHeightmap1 || isHeightmap2)
+  {
+    DARTCollisionObject* convexObject = isHeightmap1 ? o2 : o1;
+    DARTCollisionObject* heightmapObject = isHeightmap1 ? o1 : o2;
+    const ConvexShape convex = makeConvexShape(convexObject);
+    if (convex.kind == ConvexShape::UNSUPPORTED)
+      return false;
+
+    if (isHeightmap1)
+    {
+      distance = distanceConvexHeightmap(
+          convex, convexObject, heightmapObject, maxDistance, point2, point1);
+    }
+    else
+    {
+      distance = distanceConvexHeightmap(
+          convex, convexObject, heightmapObject, maxDistance, point1, point2);
+    }
+  }
+  else if (type1 == dynamics::MeshShape::getStaticType())
+  {
+    if (!distanceMeshTriangles(o1, o2, maxDistance, distance, point1, point2))
+      return false;
+  }
+  else if (type2 == dynamics::MeshShape::getStaticType())
+  {
+    if (!distanceMeshTriangles(o2, o1, maxDistance, distance, point2, point1))
+      return false;
+  }
+  else
+  {
+    const ConvexShape convex1 = makeConvexShape(o1);
+    const ConvexShape convex2 = makeConvexShape(o2);
+    if (convex1.kind == ConvexShape::UNSUPPORTED
+        || convex2.kind == ConvexShape::UNSUPPORTED)
+    {
+      return false;
+    }
+
+    distance = gjkDistance(convex1, convex2, point1, point2);
+  }
+
+  // GJK can only tell that the shapes overlap, not by how much
+  if (distance <= kGJKAbsoluteTolerance)
+  {
+    Eigen::Vector3s penetration1 = point1;
+    Eigen::Vector3s penetration2 = point2;
+    const s_t penetration
+        = penetrationDistance(o1, o2, penetration1, penetration2);
+    if (penetration < 0.0)
+    {
+      distance = penetration;
+      point1 = penetration1;
+      point2 = penetration2;
+    }
+    else
+    {
+      distance = 0.0;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace collision
+}  // namespace dart
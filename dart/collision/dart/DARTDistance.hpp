@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTDISTANCE_HPP_
+#define DART_COLLISION_DART_DARTDISTANCE_HPP_
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+class DARTCollisionObject;
+
+/// Computes the signed distance between two objects, with GJK for pairs of
+/// convex shapes. Distances to a mesh are measured to its nearest triangle,
+/// so concave meshes are handled, except against planes and heightmaps, which
+/// see the convex hull of its vertices. A shape entirely inside a closed mesh
+/// is reported at its distance from the surface. Planes and heightmaps are
+/// supported against any convex shape or mesh, but not against each other.
+///
+/// When the shapes overlap, the distance is minus the deepest penetration
+/// that DARTCollide reports for the pair, and the nearest points straddle
+/// that contact point.
+///
+/// Returns false if the pair isn't supported. Otherwise this sets `distance`
+/// and the world frame nearest points on each object. Heightmap pairs that
+/// are certainly farther apart than `maxDistance` are skipped, and get an
+/// infinite distance.
+bool distanceObjects(
+    DARTCollisionObject* o1,
+    DARTCollisionObject* o2,
+    s_t maxDistance,
+    s_t& distance,
+    Eigen::Vector3s& point1,
+    Eigen::Vector3s& point2);
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTDISTANCE_HPP_
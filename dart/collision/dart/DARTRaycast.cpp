@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTRaycast.hpp"
+
+#include <cmath>
+
+#include "dart/collision/dart/DARTCollisionObject.hpp"
+#include "dart/dynamics/BoxShape.hpp"
+#include "dart/dynamics/CapsuleShape.hpp"
+#include "dart/dynamics/CylinderShape.hpp"
+#include "dart/dynamics/EllipsoidShape.hpp"
+#include "dart/dynamics/PlaneShape.hpp"
+#include "dart/dynamics/SphereShape.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+// All of these work in the frame of the shape, on the ray from + t * dir, and
+// only report hits with t in [0, fraction]. On a hit they lower `fraction` and
+// set the (unit length) `normal`.
+
+//==============================================================================
+bool raycastSphere(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    const Eigen::Vector3s& center,
+    s_t radius,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const Eigen::Vector3s f = from - center;
+  const s_t c = f.squaredNorm() - radius * radius;
+  // Starting inside
+  if (c < 0.0)
+    return false;
+
+  const s_t a = dir.squaredNorm();
+  const s_t b = f.dot(dir);
+  const s_t discriminant = b * b - a * c;
+  if (a == 0.0 || discriminant < 0.0)
+    return false;
+
+  const s_t t = (-b - std::sqrt(discriminant)) / a;
+  if (t < 0.0 || t > fraction)
+    return false;
+
+  fraction = t;
+  normal = (f + t * dir) / radius;
+  return true;
+}
+
+//==============================================================================
+bool raycastEllipsoid(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    const Eigen::Vector3s& radii,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  // Squash the ellipsoid into a unit sphere, which keeps t unchanged
+  const Eigen::Vector3s inverseRadii = radii.cwiseInverse();
+  Eigen::Vector3s unitNormal;
+  if (!raycastSphere(
+          from.cwiseProduct(inverseRadii),
+          dir.cwiseProduct(inverseRadii),
+          Eigen::Vector3s::Zero(),
+          1.0,
+          fraction,
+          unitNormal))
+  {
+    return false;
+  }
+
+  // Normals transform with the inverse transpose of the squashing
+  normal = unitNormal.cwiseProduct(inverseRadii).normalized();
+  return true;
+}
+
+//==============================================================================
+bool raycastBox(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    const Eigen::Vector3s& size,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const Eigen::Vector3s half = 0.5 * size;
+  if ((from.array().abs() <= half.array()).all())
+    return false;
+
+  s_t tMin = 0.0;
+  s_t tMax = fraction;
+  int entryAxis = -1;
+  s_t entrySign = 0.0;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    if (dir(i) == 0.0)
+    {
+      if (std::abs(from(i)) > half(i))
+        return false;
+      continue;
+    }
+
+    // The face the ray enters through is the one facing back along the ray
+    const s_t sign = dir(i) > 0.0 ? -1.0 : 1.0;
+    const s_t tEnter = (sign * half(i) - from(i)) / dir(i);
+    const s_t tExit = (-sign * half(i) - from(i)) / dir(i);
+
+    if (tEnter >= tMin)
+    {
+      tMin = tEnter;
+      entryAxis = i;
+      entrySign = sign;
+    }
+    tMax = std::min(tMax, tExit);
+    if (tMin > tMax)
+      return false;
+  }
+
+  if (entryAxis < 0)
+    return false;
+
+  fraction = tMin;
+  normal = Eigen::Vector3s::Zero();
+  normal(entryAxis) = entrySign;
+  return true;
+}
+
+//==============================================================================
+/// The side of an infinite cylinder along Z, limited to |z| <= halfHeight
+bool raycastTube(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t radius,
+    s_t halfHeight,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const s_t a = dir(0) * dir(0) + dir(1) * dir(1);
+  if (a == 0.0)
+    return false;
+
+  const s_t b = from(0) * dir(0) + from(1) * dir(1);
+  const s_t c = from(0) * from(0) + from(1) * from(1) - radius * radius;
+  if (c < 0.0)
+    return false;
+
+  const s_t discriminant = b * b - a * c;
+  if (discriminant < 0.0)
+    return false;
+
+  const s_t t = (-b - std::sqrt(discriminant)) / a;
+  if (t < 0.0 || t > fraction)
+    return false;
+
+  const Eigen::Vector3s point = from + t * dir;
+  if (std::abs(point(2)) > halfHeight)
+    return false;
+
+  fraction = t;
+  normal = Eigen::Vector3s(point(0), point(1), 0.0) / radius;
+  return true;
+}
+
+//==============================================================================
+bool raycastCapsule(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t height,
+    s_t radius,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const s_t halfHeight = 0.5 * height;
+  const Eigen::Vector3s closest(
+      0.0, 0.0, std::max(-halfHeight, std::min(halfHeight, from(2))));
+  if ((from - closest).squaredNorm() < radius * radius)
+    return false;
+
+  bool hit = raycastTube(from, dir, radius, halfHeight, fraction, normal);
+  hit |= raycastSphere(
+      from,
+      dir,
+      Eigen::Vector3s(0.0, 0.0, halfHeight),
+      radius,
+      fraction,
+      normal);
+  hit |= raycastSphere(
+      from,
+      dir,
+      Eigen::Vector3s(0.0, 0.0, -halfHeight),
+      radius,
+      fraction,
+      normal);
+  return hit;
+}
+
+//==============================================================================
+bool raycastCylinder(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t height,
+    s_t radius,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const s_t halfHeight = 0.5 * height;
+  if (std::abs(from(2)) <= halfHeight
+      && from(0) * from(0) + from(1) * from(1) <= radius * radius)
+  {
+    return false;
+  }
+
+  bool hit = raycastTube(from, dir, radius, halfHeight, fraction, normal);
+
+  // The cap facing back along the ray
+  if (dir(2) != 0.0)
+  {
+    const s_t sign = dir(2) > 0.0 ? -1.0 : 1.0;
+    const s_t t = (sign * halfHeight - from(2)) / dir(2);
+    const Eigen::Vector3s point = from + t * dir;
+    if (t >= 0.0 && t <= fraction
+        && point(0) * point(0) + point(1) * point(1) <= radius * radius)
+    {
+      fraction = t;
+      normal = Eigen::Vector3s(0.0, 0.0, sign);
+      hit = true;
+    }
+  }
+
+  return hit;
+}
+
+//==============================================================================
+bool raycastPlane(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    const Eigen::Vector3s& planeNormal,
+    s_t offset,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const s_t height = planeNormal.dot(from) - offset;
+  const s_t speed = planeNormal.dot(dir);
+  if (height < 0.0 || speed >= 0.0)
+    return false;
+
+  const s_t t = -height / speed;
+  if (t > fraction)
+    return false;
+
+  fraction = t;
+  normal = planeNormal;
+  return true;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+bool computeWorldBoundingBox(const CollisionObject* object, DARTBVH::AABB& box)
+{
+  const auto shape = object->getShape();
+  if (shape->getType() == dynamics::PlaneShape::getStaticType())
+    return false;
+
+  const math::BoundingBox& local = shape->getBoundingBox();
+  if (!local.getMin().allFinite() || !local.getMax().allFinite())
+    return false;
+
+  // The box around a rotated box: center moves rigidly, and the half extents
+  // are scaled by the absolute rotation
+  const Eigen::Isometry3s& T = object->getTransform();
+  const Eigen::Vector3s center = T * local.computeCenter();
+  const Eigen::Vector3s half
+      = T.linear().cwiseAbs() * local.computeHalfExtents();
+  box = DARTBVH::AABB(center - half, center + half);
+  return true;
+}
+
+//==============================================================================
+bool raycastObject(
+    DARTCollisionObject* object,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& to,
+    s_t& fraction,
+    Eigen::Vector3s& normal)
+{
+  const auto shape = object->getShape();
+  const auto& type = shape->getType();
+  const Eigen::Isometry3s& T = object->getTransform();
+
+  // Work in the frame of the shape. This doesn't change t.
+  const Eigen::Vector3s localFrom = T.inverse() * from;
+  const Eigen::Vector3s localDir = T.linear().transpose() * (to - from);
+  Eigen::Vector3s localNormal;
+  bool hit = false;
+
+  if (type == dynamics::SphereShape::getStaticType())
+  {
+    const auto* sphere = static_cast<const dynamics::SphereShape*>(shape.get());
+    hit = raycastSphere(
+        localFrom,
+        localDir,
+        Eigen::Vector3s::Zero(),
+        sphere->getRadius(),
+        fraction,
+        localNormal);
+  }
+  else if (type == dynamics::EllipsoidShape::getStaticType())
+  {
+    const auto* ellipsoid
+        = static_cast<const dynamics::EllipsoidShape*>(shape.get());
+    hit = raycastEllipsoid(
+        localFrom, localDir, ellipsoid->getRadii(), fraction, localNormal);
+  }
+  else if (type == dynamics::BoxShape::getStaticType())
+  {
+    const auto* box = static_cast<const dynamics::BoxShape*>(shape.get());
+    hit = raycastBox(
+        localFrom, localDir, box->getSize(), fraction, localNormal);
+  }
+  else if (type == dynamics::CapsuleShape::getStaticType())
+  {
+    const auto* capsule
+        = static_cast<const dynamics::CapsuleShape*>(shape.get());
+    hit = raycastCapsule(
+        localFrom,
+        localDir,
+        capsule->getHeight(),
+        capsule->getRadius(),
+        fraction,
+        localNormal);
+  }
+  else if (type == dynamics::CylinderShape::getStaticType())
+  {
+    const auto* cylinder
+        = static_cast<const dynamics::CylinderShape*>(shape.get());
+    hit = raycastCylinder(
+        localFrom,
+        localDir,
+        cylinder->getHeight(),
+        cylinder->getRadius(),
+        fraction,
+        localNormal);
+  }
+  else if (type == dynamics::PlaneShape::getStaticType())
+  {
+    const auto* plane = static_cast<const dynamics::PlaneShape*>(shape.get());
+    hit = raycastPlane(
+        localFrom,
+        localDir,
+        plane->getNormal(),
+        plane->getOffset(),
+        fraction,
+        localNormal);
+  }
+  else if (const DARTTriangleBVH* triangles = object->getTriangleBVH())
+  {
+    hit = triangles->raycast(localFrom, localDir, fraction, localNormal);
+  }
+
+  if (hit)
+    normal = T.linear() * localNormal;
+
+  return hit;
+}
+
+}  // namespace collision
+}  // namespace dart
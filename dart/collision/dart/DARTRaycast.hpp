@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTRAYCAST_HPP_
+#define DART_COLLISION_DART_DARTRAYCAST_HPP_
+
+#include <Eigen/Dense>
+
+#include "dart/collision/dart/DARTBVH.hpp"
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace collision {
+
+class CollisionObject;
+class DARTCollisionObject;
+
+/// Sets `box` to the axis aligned box around `object` in world coordinates.
+/// Returns false (and leaves `box` alone) if the shape has no finite bounds,
+/// like a PlaneShape.
+bool computeWorldBoundingBox(const CollisionObject* object, DARTBVH::AABB& box);
+
+/// Casts the ray `from + t * (to - from)`, for t in [0, fraction], at
+/// `object`. If it hits, this returns true, lowers `fraction` to the first hit
+/// and sets `normal` to the world frame surface normal there.
+///
+/// Solid shapes (spheres, boxes, capsules, cylinders, and the space below a
+/// plane) are only hit from outside: a ray that starts inside one of them
+/// doesn't hit it. Meshes and heightmaps are hit on either side of every
+/// triangle, and the normal always faces back along the ray.
+bool raycastObject(
+    DARTCollisionObject* object,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& to,
+    s_t& fraction,
+    Eigen::Vector3s& normal);
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTRAYCAST_HPP_
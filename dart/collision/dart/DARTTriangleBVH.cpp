@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dart/collision/dart/DARTTriangleBVH.hpp"
+
+#include "dart/dynamics/HeightmapShape.hpp"
+#include "dart/dynamics/MeshShape.hpp"
+
+namespace dart {
+namespace collision {
+
+namespace {
+
+//==============================================================================
+template <typename S>
+std::shared_ptr<DARTTriangleBVH> triangulateHeightmap(
+    const dynamics::HeightmapShape<S>& heightmap)
+{
+  const auto& heights = heightmap.getHeightField();
+  const Eigen::Vector3s scale = heightmap.getScale().template cast<s_t>();
+  const int numRows = heights.rows();
+  const int numCols = heights.cols();
+  if (numRows < 2 || numCols < 2)
+    return nullptr;
+
+  // This matches the grid used by the heightmap narrowphase in DARTCollide
+  const s_t rowCenter = 0.5 * (numRows - 1);
+  const s_t colCenter = 0.5 * (numCols - 1);
+
+  std::vector<Eigen::Vector3s> vertices;
+  vertices.reserve(numRows * numCols);
+  for (int row = 0; row < numRows; ++row)
+  {
+    for (int col = 0; col < numCols; ++col)
+    {
+      vertices.emplace_back(
+          (col - colCenter) * scale(0),
+          -(row - rowCenter) * scale(1),
+          static_cast<s_t>(heights(row, col)) * scale(2));
+    }
+  }
+
+  std::vector<Eigen::Vector3i> triangles;
+  triangles.reserve(2 * (numRows - 1) * (numCols - 1));
+  for (int row = 0; row < numRows - 1; ++row)
+  {
+    for (int col = 0; col < numCols - 1; ++col)
+    {
+      const int a = row * numCols + col;
+      const int b = row * numCols + col + 1;
+      const int c = (row + 1) * numCols + col;
+      const int d = (row + 1) * numCols + col + 1;
+      triangles.emplace_back(a, c, d);
+      triangles.emplace_back(a, d, b);
+    }
+  }
+
+  return std::make_shared<DARTTriangleBVH>(
+      std::move(vertices), std::move(triangles));
+}
+
+} // anonymous namespace
+
+//==============================================================================
+DARTTriangleBVH::DARTTriangleBVH(
+    std::vector<Eigen::Vector3s> vertices,
+    std::vector<Eigen::Vector3i> triangles)
+  : mVertices(std::move(vertices)), mTriangles(std::move(triangles))
+{
+  std::vector<DARTBVH::AABB> boxes(mTriangles.size());
+  for (std::size_t i = 0; i < mTriangles.size(); ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      boxes[i].extend(mVertices[mTriangles[i](j)]);
+  }
+  mTree.build(boxes);
+}
+
+//==============================================================================
+std::shared_ptr<DARTTriangleBVH> DARTTriangleBVH::createFromMesh(
+    const aiScene* scene, const Eigen::Vector3s& scale)
+{
+  std::vector<Eigen::Vector3s> vertices;
+  std::vector<Eigen::Vector3i> triangles;
+
+  if (scene)
+  {
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+    {
+      const aiMesh* mesh = scene->mMeshes[i];
+      const int offset = vertices.size();
+      for (unsigned int k = 0; k < mesh->mNumVertices; ++k)
+      {
+        vertices.emplace_back(
+            mesh->mVertices[k].x * scale(0),
+            mesh->mVertices[k].y * scale(1),
+            mesh->mVertices[k].z * scale(2));
+      }
+      for (unsigned int k = 0; k < mesh->mNumFaces; ++k)
+      {
+        const aiFace& face = mesh->mFaces[k];
+        if (face.mNumIndices != 3)
+          continue;
+        triangles.emplace_back(
+            offset + face.mIndices[0],
+            offset + face.mIndices[1],
+            offset + face.mIndices[2]);
+      }
+    }
+  }
+
+  return std::make_shared<DARTTriangleBVH>(
+      std::move(vertices), std::move(triangles));
+}
+
+//==============================================================================
+std::shared_ptr<DARTTriangleBVH> DARTTriangleBVH::createFromHeightmap(
+    const dynamics::Shape* shape)
+{
+  const auto& type = shape->getType();
+  if (type == dynamics::HeightmapShapef::getStaticType())
+  {
+    return triangulateHeightmap(
+        *static_cast<const dynamics::HeightmapShapef*>(shape));
+  }
+  if (type == dynamics::HeightmapShaped::getStaticType())
+  {
+    return triangulateHeightmap(
+        *static_cast<const dynamics::HeightmapShaped*>(shape));
+  }
+
+  return nullptr;
+}
+
+//==============================================================================
+std::size_t DARTTriangleBVH::getNumTriangles() const
+{
+  return mTriangles.size();
+}
+
+//==============================================================================
+const std::vector<Eigen::Vector3s>& DARTTriangleBVH::getVertices() const
+{
+  return mVertices;
+}
+
+//==============================================================================
+void DARTTriangleBVH::getTriangle(std::size_t i, Eigen::Vector3s* corners) const
+{
+  for (int j = 0; j < 3; ++j)
+    corners[j] = mVertices[mTriangles[i](j)];
+}
+
+//==============================================================================
+const DARTBVH::AABB& DARTTriangleBVH::getBounds() const
+{
+  return mTree.getBounds();
+}
+
+//==============================================================================
+const DARTBVH& DARTTriangleBVH::getTree() const
+{
+  return mTree;
+}
+
+//==============================================================================
+bool DARTTriangleBVH::raycast(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t& fraction,
+    Eigen::Vector3s& normal) const
+{
+  bool hit = false;
+  mTree.raycast(from, dir, fraction, [&](std::size_t i, s_t& maxFraction) {
+    s_t t;
+    Eigen::Vector3s n;
+    if (intersectTriangle(i, from, dir, maxFraction, t, n))
+    {
+      maxFraction = t;
+      fraction = t;
+      normal = n;
+      hit = true;
+    }
+  });
+
+  if (hit)
+    normal.normalize();
+
+  return hit;
+}
+
+//==============================================================================
+void DARTTriangleBVH::raycastAll(
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t maxFraction,
+    std::vector<std::pair<s_t, Eigen::Vector3s>>& hits) const
+{
+  mTree.raycast(from, dir, maxFraction, [&](std::size_t i, s_t& limit) {
+    s_t t;
+    Eigen::Vector3s n;
+    if (intersectTriangle(i, from, dir, limit, t, n))
+      hits.emplace_back(t, n.normalized());
+  });
+}
+
+//==============================================================================
+bool DARTTriangleBVH::intersectTriangle(
+    std::size_t i,
+    const Eigen::Vector3s& from,
+    const Eigen::Vector3s& dir,
+    s_t maxFraction,
+    s_t& t,
+    Eigen::Vector3s& normal) const
+{
+  // Moller-Trumbore
+  const Eigen::Vector3s& v0 = mVertices[mTriangles[i](0)];
+  const Eigen::Vector3s e1 = mVertices[mTriangles[i](1)] - v0;
+  const Eigen::Vector3s e2 = mVertices[mTriangles[i](2)] - v0;
+
+  const Eigen::Vector3s p = dir.cross(e2);
+  const s_t det = e1.dot(p);
+  if (std::abs(det) < 1e-20)
+    return false;
+  const s_t invDet = 1.0 / det;
+
+  const Eigen::Vector3s s = from - v0;
+  const s_t u = s.dot(p) * invDet;
+  if (u < 0.0 || u > 1.0)
+    return false;
+
+  const Eigen::Vector3s q = s.cross(e1);
+  const s_t v = dir.dot(q) * invDet;
+  if (v < 0.0 || u + v > 1.0)
+    return false;
+
+  t = e2.dot(q) * invDet;
+  if (t < 0.0 || t > maxFraction)
+    return false;
+
+  normal = e1.cross(e2);
+  if (normal.dot(dir) > 0.0)
+    normal = -normal;
+
+  return true;
+}
+
+}  // namespace collision
+}  // namespace dart
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DART_COLLISION_DART_DARTTRIANGLEBVH_HPP_
+#define DART_COLLISION_DART_DARTTRIANGLEBVH_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/collision/dart/DARTBVH.hpp"
+#include "dart/math/MathTypes.hpp"
+
+struct aiScene;
+
+namespace dart {
+namespace dynamics {
+class Shape;
+} // namespace dynamics
+
+namespace collision {
+
+/// A triangle soup with a DARTBVH over it, in the coordinates of the shape it
+/// came from (with any scaling already applied). This is how
+/// DARTCollisionDetector answers raycast and distance queries against meshes
+/// and heightmaps.
+class DARTTriangleBVH
+{
+public:
+  /// Builds the tree over `triangles`, which index into `vertices`
+  DARTTriangleBVH(
+      std::vector<Eigen::Vector3s> vertices,
+      std::vector<Eigen::Vector3i> triangles);
+
+  /// Collects the triangles of every mesh in `scene`, scaled by `scale`.
+  /// Faces that aren't triangles are skipped.
+  static std::shared_ptr<DARTTriangleBVH> createFromMesh(
+      const aiScene* scene, const Eigen::Vector3s& scale);
+
+  /// Triangulates a HeightmapShapef or HeightmapShaped the same way DARTCollide
+  /// does. Returns nullptr for any other kind of shape.
+  static std::shared_ptr<DARTTriangleBVH> createFromHeightmap(
+      const dynamics::Shape* shape);
+
+  /// Returns the number of triangles
+  std::size_t getNumTriangles() const;
+
+  /// Returns every vertex, including any that aren't part of a triangle
+  const std::vector<Eigen::Vector3s>& getVertices() const;
+
+  /// Returns the corners of triangle `i`
+  void getTriangle(std::size_t i, Eigen::Vector3s* corners) const;
+
+  /// Returns the box around all the triangles
+  const DARTBVH::AABB& getBounds() const;
+
+  /// Returns the tree over the triangles
+  const DARTBVH& getTree() const;
+
+  /// Finds the nearest triangle hit by the ray `from + t * dir`, for t in
+  /// [0, fraction]. If there is one, this returns true, lowers `fraction` to
+  /// the hit and sets `normal` to the triangle normal facing back along the
+  /// ray. Triangles are two-sided.
+  bool raycast(
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& dir,
+      s_t& fraction,
+      Eigen::Vector3s& normal) const;
+
+  /// Like raycast(), but collects every hit rather than the nearest one
+  void raycastAll(
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& dir,
+      s_t maxFraction,
+      std::vector<std::pair<s_t, Eigen::Vector3s>>& hits) const;
+
+protected:
+  /// Returns true if the ray hits triangle `i` for some t in [0, maxFraction],
+  /// and if so sets `t` and the (unnormalized, two-sided) `normal`
+  bool intersectTriangle(
+      std::size_t i,
+      const Eigen::Vector3s& from,
+      const Eigen::Vector3s& dir,
+      s_t maxFraction,
+      s_t& t,
+      Eigen::Vector3s& normal) const;
+
+  std::vector<Eigen::Vector3s> mVertices;
+  std::vector<Eigen::Vector3i> mTriangles;
+  DARTBVH mTree;
+};
+
+}  // namespace collision
+}  // namespace dart
+
+#endif  // DART_COLLISION_DART_DARTTRIANGLEBVH_HPP_
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "dart/common/ThreadPool.hpp"
+
+#include <cassert>
+
+namespace dart {
+namespace common {
+
+//==============================================================================
+ThreadPool::ThreadPool(std::size_t numThreads)
+  : mGeneration(0),
+    mPending(0),
+    mStopping(false),
+    mJobSize(0),
+    mJob(nullptr)
+{
+  if (numThreads < 1)
+    numThreads = 1;
+  // The calling thread is thread 0, so we only need numThreads - 1 workers
+  mWorkers.reserve(numThreads - 1);
+  for (std::size_t i = 1; i < numThreads; i++)
+  {
+    mWorkers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+//==============================================================================
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWorkReady.notify_all();
+  for (std::thread& worker : mWorkers)
+  {
+    worker.join();
+  }
+}
+
+//==============================================================================
+std::size_t ThreadPool::getNumThreads() const
+{
+  return mWorkers.size() + 1;
+}
+
+//==============================================================================
+void ThreadPool::parallelFor(
+    std::size_t n, const std::function<void(std::size_t)>& fn)
+{
+  if (n == 0)
+    return;
+
+  // Don't bother waking anybody up if there's only work for the caller
+  if (mWorkers.empty() || n == 1)
+  {
+    for (std::size_t i = 0; i < n; i++)
+      fn(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    assert(mJob == nullptr && "ThreadPool::parallelFor() is not reentrant");
+    mJob = &fn;
+    mJobSize = n;
+    mPending = mWorkers.size();
+    mFirstException = nullptr;
+    mGeneration++;
+  }
+  mWorkReady.notify_all();
+
+  runShare(0);
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWorkDone.wait(lock, [this] { return mPending == 0; });
+    mJob = nullptr;
+    exception = mFirstException;
+    mFirstException = nullptr;
+  }
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+//==============================================================================
+void ThreadPool::workerLoop(std::size_t threadIndex)
+{
+  std::size_t lastGeneration = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWorkReady.wait(lock, [this, lastGeneration] {
+        return mStopping || mGeneration != lastGeneration;
+      });
+      if (mStopping)
+        return;
+      lastGeneration = mGeneration;
+    }
+
+    runShare(threadIndex);
+
+    bool lastOneDone = false;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mPending--;
+      lastOneDone = (mPending == 0);
+    }
+    if (lastOneDone)
+      mWorkDone.notify_one();
+  }
+}
+
+//==============================================================================
+void ThreadPool::runShare(std::size_t threadIndex)
+{
+  const std::size_t stride = getNumThreads();
+  try
+  {
+    for (std::size_t i = threadIndex; i < mJobSize; i += stride)
+    {
+      (*mJob)(i);
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFirstException)
+      mFirstException = std::current_exception();
+  }
+}
+
+} // namespace common
+} // namespace dart
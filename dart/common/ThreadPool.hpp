@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef DART_COMMON_THREADPOOL_HPP_
+#define DART_COMMON_THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dart {
+namespace common {
+
+/// ThreadPool keeps a fixed set of worker threads alive, so that short
+/// parallel loops (like the per-skeleton updates inside a single World::step)
+/// don't pay for spawning threads every time.
+///
+/// Work is statically partitioned: in parallelFor(), item `i` always runs on
+/// thread `i % getNumThreads()`, with the calling thread acting as thread 0.
+/// That keeps the same data on the same core from call to call, and makes the
+/// assignment deterministic.
+class ThreadPool
+{
+public:
+  /// Creates a pool that runs work on `numThreads` threads in total, including
+  /// the thread that calls parallelFor(). A pool of 1 thread runs everything
+  /// inline on the caller.
+  explicit ThreadPool(std::size_t numThreads);
+
+  /// Stops and joins all the worker threads
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+
+  /// Returns the number of threads work is spread over, including the caller
+  std::size_t getNumThreads() const;
+
+  /// Calls fn(i) for every i in [0, n), and blocks until they've all finished.
+  /// Item `i` runs on thread `i % getNumThreads()`, and items assigned to the
+  /// same thread run in increasing order. If any call throws, the first
+  /// exception is rethrown here once every thread has finished.
+  ///
+  /// This is not reentrant: fn must not call parallelFor() on the same pool.
+  void parallelFor(std::size_t n, const std::function<void(std::size_t)>& fn);
+
+protected:
+  /// The loop each worker thread runs until the pool is destroyed
+  void workerLoop(std::size_t threadIndex);
+
+  /// Runs this thread's share of the current job
+  void runShare(std::size_t threadIndex);
+
+  std::vector<std::thread> mWorkers;
+
+  std::mutex mMutex;
+  std::condition_variable mWorkReady;
+  std::condition_variable mWorkDone;
+
+  /// Incremented every time a new job is posted, so workers can tell a new job
+  /// from a spurious wakeup
+  std::size_t mGeneration;
+  /// The number of workers that haven't finished the current job yet
+  std::size_t mPending;
+  bool mStopping;
+
+  std::size_t mJobSize;
+  const std::function<void(std::size_t)>* mJob;
+  std::exception_ptr mFirstException;
+};
+
+} // namespace common
+} // namespace dart
+
+#endif // DART_COMMON_THREADPOOL_HPP_
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "dart/constraint/BlockPivotingBoxedLcpSolver.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <Eigen/Jacobi>
+
+#include "dart/external/odelcpsolver/lcp.h"
+
+namespace dart {
+namespace constraint {
+
+namespace {
+
+enum class IndexState
+{
+  CLAMPED,
+  AT_LO,
+  AT_HI
+};
+
+} // namespace
+
+//==============================================================================
+BlockPivotingBoxedLcpSolver::Option::Option(
+    int maxPivots, s_t tolerance, s_t epsilonForDivision)
+  : mMaxPivots(maxPivots),
+    mTolerance(tolerance),
+    mEpsilonForDivision(epsilonForDivision)
+{
+  // Do nothing
+}
+
+//==============================================================================
+const std::string& BlockPivotingBoxedLcpSolver::getType() const
+{
+  return getStaticType();
+}
+
+//==============================================================================
+const std::string& BlockPivotingBoxedLcpSolver::getStaticType()
+{
+  static const std::string type = "BlockPivotingBoxedLcpSolver";
+  return type;
+}
+
+//==============================================================================
+bool BlockPivotingBoxedLcpSolver::solve(
+    int n,
+    s_t* A,
+    s_t* x,
+    s_t* b,
+    int nub,
+    s_t* lo,
+    s_t* hi,
+    int* findex,
+    bool earlyTermination)
+{
+  performance::PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE
+  if (mPerfLog != nullptr)
+  {
+    thisLog = mPerfLog->startRun("BlockPivotingBoxedLcpSolver.solve");
+  }
+#endif
+
+  mLastUsedFallback = false;
+  bool success = solveWarmStarted(n, A, x, b, nub, lo, hi, findex);
+
+  // The warm start didn't work out, so restart the pivoting from scratch.
+  // solveWarmStarted() doesn't touch A, b, lo, hi or findex, so Dantzig sees
+  // the original problem, except that Dantzig only knows an index is unbounded
+  // from its limits, so we overwrite lo and hi for the first nub indices.
+  if (!success)
+  {
+    mLastUsedFallback = true;
+    for (int i = 0; i < nub; ++i)
+    {
+      lo[i] = -std::numeric_limits<s_t>::infinity();
+      hi[i] = std::numeric_limits<s_t>::infinity();
+    }
+    success = DantzigBoxedLcpSolver::solve(
+        n, A, x, b, nub, lo, hi, findex, earlyTermination);
+  }
+
+#ifdef LOG_PERFORMANCE
+  if (thisLog != nullptr)
+  {
+    thisLog->incrementCounter("pivots", mLastNumPivots);
+    thisLog->incrementCounter("fallbacks", mLastUsedFallback ? 1 : 0);
+    thisLog->end();
+  }
+#endif
+
+  return success;
+}
+
+//==============================================================================
+void BlockPivotingBoxedLcpSolver::setOption(
+    const BlockPivotingBoxedLcpSolver::Option& option)
+{
+  mOption = option;
+}
+
+//==============================================================================
+const BlockPivotingBoxedLcpSolver::Option&
+BlockPivotingBoxedLcpSolver::getOption() const
+{
+  return mOption;
+}
+
+//==============================================================================
+void BlockPivotingBoxedLcpSolver::setPerformanceLog(
+    performance::PerformanceLog* log)
+{
+  mPerfLog = log;
+}
+
+//==============================================================================
+int BlockPivotingBoxedLcpSolver::getLastNumPivots() const
+{
+  return mLastNumPivots;
+}
+
+//==============================================================================
+bool BlockPivotingBoxedLcpSolver::getLastUsedFallback() const
+{
+  return mLastUsedFallback;
+}
+
+//==============================================================================
+bool BlockPivotingBoxedLcpSolver::solveWarmStarted(
+    int n,
+    const s_t* A,
+    s_t* x,
+    const s_t* b,
+    int nub,
+    const s_t* lo,
+    const s_t* hi,
+    const int* findex)
+{
+  mLastNumPivots = 0;
+  const s_t tol = mOption.mTolerance;
+
+  const int nSkip = dPAD(n);
+  mCachedA.resize(n, n);
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j < n; j++)
+    {
+      mCachedA(i, j) = A[nSkip * i + j];
+    }
+  }
+  Eigen::Map<const Eigen::VectorXs> bVec(b, n);
+  Eigen::VectorXs cur = Eigen::Map<Eigen::VectorXs>(x, n);
+  if (cur.hasNaN())
+    return false;
+
+  // Friction bounds are scaled by the corresponding normal impulse, so they
+  // have to be recomputed every time the normal impulses change. The first nub
+  // indices are unbounded no matter what lo and hi say, so they always stay
+  // clamped.
+  Eigen::VectorXs lower(n);
+  Eigen::VectorXs upper(n);
+  auto updateBounds = [&]() {
+    for (int i = 0; i < n; i++)
+    {
+      if (i < nub)
+      {
+        upper(i) = std::numeric_limits<s_t>::infinity();
+        lower(i) = -std::numeric_limits<s_t>::infinity();
+      }
+      else if (findex[i] >= 0)
+      {
+        const s_t normal = cur(findex[i]);
+        upper(i) = abs(hi[i] * normal);
+        lower(i) = -abs(lo[i] * normal);
+      }
+      else
+      {
+        upper(i) = hi[i];
+        lower(i) = lo[i];
+      }
+    }
+  };
+  updateBounds();
+
+  // Seed the index sets from the guess
+  mCachedL.resize(n, n);
+  mClamped.clear();
+  std::vector<IndexState> state(n);
+  for (int i = 0; i < n; i++)
+  {
+    if (upper(i) - lower(i) <= tol || cur(i) <= lower(i) + tol)
+    {
+      state[i] = IndexState::AT_LO;
+    }
+    else if (cur(i) >= upper(i) - tol)
+    {
+      state[i] = IndexState::AT_HI;
+    }
+    else
+    {
+      state[i] = IndexState::CLAMPED;
+      addClamped(i);
+    }
+  }
+
+  // Each pivot is one change to the index sets. We also allow one re-solve
+  // without a pivot per index, for when the friction bounds move underneath
+  // us.
+  const int maxIterations = mOption.mMaxPivots + n + 1;
+  for (int iter = 0; iter < maxIterations; iter++)
+  {
+    // Pin every unclamped index to its bound
+    for (int i = 0; i < n; i++)
+    {
+      if (state[i] == IndexState::AT_LO)
+        cur(i) = lower(i);
+      else if (state[i] == IndexState::AT_HI)
+        cur(i) = upper(i);
+      else
+        cur(i) = 0;
+    }
+
+    // Solve A_CC * x_C = b_C - A_CN * x_N with the cached factorization
+    const int m = mClamped.size();
+    if (m > 0)
+    {
+      Eigen::VectorXs xC(m);
+      for (int k = 0; k < m; k++)
+      {
+        const int i = mClamped[k];
+        xC(k) = bVec(i) - mCachedA.row(i).dot(cur);
+      }
+      mCachedL.topLeftCorner(m, m).triangularView<Eigen::Lower>().solveInPlace(
+          xC);
+      mCachedL.topLeftCorner(m, m)
+          .transpose()
+          .triangularView<Eigen::Upper>()
+          .solveInPlace(xC);
+      for (int k = 0; k < m; k++)
+      {
+        cur(mClamped[k]) = xC(k);
+      }
+    }
+    if (cur.hasNaN())
+      return false;
+
+    // Check whether moving the normal impulses moved any of the bounds we've
+    // pinned friction impulses to
+    updateBounds();
+    bool boundsMoved = false;
+    for (int i = 0; i < n; i++)
+    {
+      if ((state[i] == IndexState::AT_LO && abs(cur(i) - lower(i)) > tol)
+          || (state[i] == IndexState::AT_HI && abs(cur(i) - upper(i)) > tol))
+      {
+        boundsMoved = true;
+        break;
+      }
+    }
+
+    // Find the worst violation of the complementarity conditions
+    Eigen::VectorXs w = mCachedA * cur - bVec;
+    int worst = -1;
+    s_t worstViolation = tol;
+    IndexState worstTarget = IndexState::CLAMPED;
+    for (int i = 0; i < n; i++)
+    {
+      if (state[i] == IndexState::CLAMPED)
+      {
+        if (lower(i) - cur(i) > worstViolation)
+        {
+          worst = i;
+          worstViolation = lower(i) - cur(i);
+          worstTarget = IndexState::AT_LO;
+        }
+        else if (cur(i) - upper(i) > worstViolation)
+        {
+          worst = i;
+          worstViolation = cur(i) - upper(i);
+          worstTarget = IndexState::AT_HI;
+        }
+      }
+      else if (upper(i) - lower(i) <= tol)
+      {
+        // A zero-width box (usually friction under a zero normal impulse)
+        // allows velocity in either direction
+        continue;
+      }
+      else if (state[i] == IndexState::AT_LO && -w(i) > worstViolation)
+      {
+        worst = i;
+        worstViolation = -w(i);
+        worstTarget = IndexState::CLAMPED;
+      }
+      else if (state[i] == IndexState::AT_HI && w(i) > worstViolation)
+      {
+        worst = i;
+        worstViolation = w(i);
+        worstTarget = IndexState::CLAMPED;
+      }
+    }
+
+    if (worst == -1)
+    {
+      if (boundsMoved)
+        continue;
+      // Clamped indices that addClamped() had to regularize only get w = 0 if
+      // b_C is consistent, so check that before we accept the solution
+      for (int i : mClamped)
+      {
+        if (abs(w(i)) > tol)
+          return false;
+      }
+      Eigen::Map<Eigen::VectorXs>(x, n) = cur;
+      return true;
+    }
+
+    if (mLastNumPivots >= mOption.mMaxPivots)
+      return false;
+    mLastNumPivots++;
+
+    if (state[worst] == IndexState::CLAMPED)
+    {
+      const int k = std::find(mClamped.begin(), mClamped.end(), worst)
+                    - mClamped.begin();
+      removeClamped(k);
+    }
+    else
+    {
+      addClamped(worst);
+    }
+    state[worst] = worstTarget;
+  }
+
+  return false;
+}
+
+//==============================================================================
+void BlockPivotingBoxedLcpSolver::addClamped(int i)
+{
+  const int m = mClamped.size();
+  s_t diag = mCachedA(i, i);
+  if (m > 0)
+  {
+    // Solve L * l = A(C, i) for the new row of the factor
+    Eigen::VectorXs l(m);
+    for (int k = 0; k < m; k++)
+    {
+      l(k) = mCachedA(mClamped[k], i);
+    }
+    mCachedL.topLeftCorner(m, m).triangularView<Eigen::Lower>().solveInPlace(
+        l);
+    diag -= l.squaredNorm();
+    mCachedL.row(m).head(m) = l.transpose();
+  }
+  // If row i is a combination of the clamped rows, like the fourth corner of a
+  // box resting on its face, the clamped block is singular. Instead we factor
+  // it as though A(i, i) had been raised enough to make the pivot A(i, i).
+  // When b_C is consistent, that still solves the clamped block exactly, with
+  // x_i = 0 and the other clamped rows taking up its share.
+  if (diag <= mOption.mEpsilonForDivision)
+  {
+    diag = mCachedA(i, i) > mOption.mEpsilonForDivision ? mCachedA(i, i) : 1;
+  }
+  mCachedL(m, m) = sqrt(diag);
+  mClamped.push_back(i);
+}
+
+//==============================================================================
+void BlockPivotingBoxedLcpSolver::removeClamped(int k)
+{
+  const int m = mClamped.size();
+
+  // Dropping row k leaves each of the rows below it with one entry above the
+  // diagonal. Rotating columns (j, j+1) zeros those back out without changing
+  // L * L^T.
+  for (int row = k; row < m - 1; row++)
+  {
+    mCachedL.row(row).head(m) = mCachedL.row(row + 1).head(m);
+  }
+  for (int j = k; j < m - 1; j++)
+  {
+    Eigen::JacobiRotation<s_t> rotation;
+    rotation.makeGivens(mCachedL(j, j), mCachedL(j, j + 1));
+    mCachedL.block(j, 0, m - 1 - j, m).applyOnTheRight(j, j + 1, rotation);
+    if (mCachedL(j, j) < 0)
+      mCachedL.block(j, j, m - 1 - j, 1) *= -1;
+  }
+
+  mClamped.erase(mClamped.begin() + k);
+}
+
+} // namespace constraint
+} // namespace dart
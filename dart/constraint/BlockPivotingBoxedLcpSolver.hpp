@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef DART_CONSTRAINT_BLOCKPIVOTINGBOXEDLCPSOLVER_HPP_
+#define DART_CONSTRAINT_BLOCKPIVOTINGBOXEDLCPSOLVER_HPP_
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/constraint/DantzigBoxedLcpSolver.hpp"
+#include "dart/performance/PerformanceLog.hpp"
+
+namespace dart {
+namespace constraint {
+
+/// A warm-started active-set variant of the Dantzig boxed LCP solver.
+///
+/// The incoming x is treated as a guess (usually last timestep's solution),
+/// and is used to seed which indices are clamped (lo < x < hi, w = 0) and
+/// which are sitting at their lower or upper bounds. We then repair the guess
+/// one pivot at a time, keeping a Cholesky factorization of the clamped block
+/// of A up to date with rank-one insertions and deletions rather than
+/// refactoring from scratch. In steady contact, the guess is usually already
+/// correct, and we solve the LCP with zero pivots and a single factorization.
+///
+/// Redundant contact rows, like the four corners of a box resting on its face,
+/// make the clamped block of A singular. We regularize those rows, which
+/// gives them zero impulse and leaves the rest of the clamped block exact. If
+/// we exceed the pivot budget, or the regularized rows can't be satisfied, we
+/// fall back to the from-scratch Dantzig solver.
+class BlockPivotingBoxedLcpSolver : public DantzigBoxedLcpSolver
+{
+public:
+  struct Option
+  {
+    /// The maximum number of pivots we'll try before giving up on the warm
+    /// start and falling back to Dantzig
+    int mMaxPivots;
+
+    /// The tolerance we use to decide if a complementarity condition is
+    /// violated
+    s_t mTolerance;
+
+    /// The smallest acceptable pivot when we extend the Cholesky factor. Below
+    /// this we treat the new row as redundant, and regularize it.
+    s_t mEpsilonForDivision;
+
+    Option(
+        int maxPivots = 10,
+        s_t tolerance = 1e-9,
+        s_t epsilonForDivision = 1e-12);
+  };
+
+  // Documentation inherited.
+  const std::string& getType() const override;
+
+  /// Returns type for this class
+  static const std::string& getStaticType();
+
+  // Documentation inherited.
+  bool solve(
+      int n,
+      s_t* A,
+      s_t* x,
+      s_t* b,
+      int nub,
+      s_t* lo,
+      s_t* hi,
+      int* findex,
+      bool earlyTermination) override;
+
+  /// Sets options
+  void setOption(const Option& option);
+
+  /// Returns options.
+  const Option& getOption() const;
+
+  /// This sets a PerformanceLog that every solve() will record a run under,
+  /// along with "pivots" and "fallbacks" counters. Pass nullptr to disable.
+  void setPerformanceLog(performance::PerformanceLog* log);
+
+  /// Returns the number of pivots the warm start took on the last call to
+  /// solve(). If the last solve fell back to Dantzig, this is the number of
+  /// pivots we tried before giving up.
+  int getLastNumPivots() const;
+
+  /// Returns true if the last call to solve() had to fall back to the
+  /// from-scratch Dantzig solver.
+  bool getLastUsedFallback() const;
+
+protected:
+  /// This attempts to solve the LCP by pivoting from the guess in x. It
+  /// returns false if it runs out of pivots or can't satisfy a redundant row,
+  /// in which case x is left untouched. The first nub indices are treated as
+  /// unbounded, whatever lo and hi say, following dSolveLCP's convention.
+  bool solveWarmStarted(
+      int n,
+      const s_t* A,
+      s_t* x,
+      const s_t* b,
+      int nub,
+      const s_t* lo,
+      const s_t* hi,
+      const int* findex);
+
+  /// Adds index i to the clamped set, extending the Cholesky factor by one row.
+  /// Redundant rows are regularized, so this always succeeds.
+  void addClamped(int i);
+
+  /// Removes the k'th entry of the clamped set, downdating the Cholesky factor
+  /// with Givens rotations
+  void removeClamped(int k);
+
+  Option mOption;
+
+  performance::PerformanceLog* mPerfLog = nullptr;
+
+  int mLastNumPivots = 0;
+
+  bool mLastUsedFallback = false;
+
+  /// The A matrix of the problem we're currently solving, unpadded
+  Eigen::MatrixXs mCachedA;
+
+  /// The lower triangular Cholesky factor of the clamped block of A, where
+  /// only the top-left mClamped.size() square is valid
+  Eigen::MatrixXs mCachedL;
+
+  /// The indices in the clamped set, in the order they appear in mCachedL
+  std::vector<int> mClamped;
+};
+
+} // namespace constraint
+} // namespace dart
+
+#endif // DART_CONSTRAINT_BLOCKPIVOTINGBOXEDLCPSOLVER_HPP_
@@ -32,7 +32,10 @@
 
 #include "dart/constraint/BoxedLcpConstraintSolver.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <unordered_map>
 #ifndef NDEBUG
 #include <iomanip>
 #include <iostream>
@@ -40,11 +43,14 @@
 
 #include "dart/collision/Contact.hpp"
 #include "dart/common/Console.hpp"
+#include "dart/constraint/BlockPivotingBoxedLcpSolver.hpp"
 #include "dart/constraint/ConstraintBase.hpp"
 #include "dart/constraint/ContactConstraint.hpp"
 #include "dart/constraint/DantzigBoxedLcpSolver.hpp"
 #include "dart/constraint/LCPUtils.hpp"
 #include "dart/constraint/PgsBoxedLcpSolver.hpp"
+#include "dart/dynamics/Joint.hpp"
+#include "dart/dynamics/Skeleton.hpp"
 #include "dart/external/odelcpsolver/lcp.h"
 #include "dart/lcpsolver/Lemke.hpp"
 #include "dart/neural/ConstrainedGroupGradientMatrices.hpp"
@@ -88,7 +94,7 @@ BoxedLcpConstraintSolver::BoxedLcpConstraintSolver(
 //==============================================================================
 BoxedLcpConstraintSolver::BoxedLcpConstraintSolver(
     BoxedLcpSolverPtr boxedLcpSolver, BoxedLcpSolverPtr secondaryBoxedLcpSolver)
-  : ConstraintSolver()
+  : ConstraintSolver(), mJacobianAssemblyEnabled(false)
 {
   if (boxedLcpSolver)
   {
@@ -148,6 +154,25 @@ ConstBoxedLcpSolverPtr BoxedLcpConstraintSolver::getBoxedLcpSolver() const
   return mBoxedLcpSolver;
 }
 
+//==============================================================================
+void BoxedLcpConstraintSolver::setWarmStartedLcpEnabled(bool enabled)
+{
+  if (enabled == isWarmStartedLcpEnabled())
+    return;
+
+  if (enabled)
+    setBoxedLcpSolver(std::make_shared<BlockPivotingBoxedLcpSolver>());
+  else
+    setBoxedLcpSolver(std::make_shared<DantzigBoxedLcpSolver>());
+}
+
+//==============================================================================
+bool BoxedLcpConstraintSolver::isWarmStartedLcpEnabled() const
+{
+  return mBoxedLcpSolver->getType()
+         == BlockPivotingBoxedLcpSolver::getStaticType();
+}
+
 //==============================================================================
 void BoxedLcpConstraintSolver::setSecondaryBoxedLcpSolver(
     BoxedLcpSolverPtr lcpSolver)
@@ -186,6 +211,35 @@ void BoxedLcpConstraintSolver::setCachedLCPSolution(Eigen::VectorXs X)
   mX = X;
 }
 
+//==============================================================================
+void BoxedLcpConstraintSolver::setJacobianAssemblyEnabled(bool enabled)
+{
+  mJacobianAssemblyEnabled = enabled;
+}
+
+//==============================================================================
+bool BoxedLcpConstraintSolver::isJacobianAssemblyEnabled() const
+{
+  return mJacobianAssemblyEnabled;
+}
+
+//==============================================================================
+void BoxedLcpConstraintSolver::setNumAssemblyThreads(std::size_t numThreads)
+{
+  if (numThreads == getNumAssemblyThreads())
+    return;
+  if (numThreads <= 1)
+    mAssemblyThreadPool.reset();
+  else
+    mAssemblyThreadPool = std::make_unique<common::ThreadPool>(numThreads);
+}
+
+//==============================================================================
+std::size_t BoxedLcpConstraintSolver::getNumAssemblyThreads() const
+{
+  return mAssemblyThreadPool ? mAssemblyThreadPool->getNumThreads() : 1;
+}
+
 //==============================================================================
 void BoxedLcpConstraintSolver::solveConstrainedGroup(
     ConstrainedGroup& group, simulation::World* world)
@@ -226,6 +280,11 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(
     mOffset[i] = mOffset[i - 1] + constraint->getDimension();
   }
 
+  // If we can, fill A from the constraint Jacobians, which replaces all the
+  // impulse tests below
+  const bool assembledFromJacobians
+      = mJacobianAssemblyEnabled && assembleFromJacobians(group);
+
   // For each constraint
   ConstraintInfo constInfo;
   constInfo.invTimeStep = 1.0 / mTimeStep;
@@ -251,6 +310,17 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(
       group.getGradientConstraintMatrices()->registerConstraint(constraint);
     }
 
+    if (assembledFromJacobians)
+    {
+      // Adjust findex for global index
+      for (std::size_t j = 0; j < constraint->getDimension(); ++j)
+      {
+        if (mFIndex[mOffset[i] + j] >= 0)
+          mFIndex[mOffset[i] + j] += mOffset[i];
+      }
+      continue;
+    }
+
     // Fill a matrix by impulse tests: A
     constraint->excite();
 
@@ -712,6 +782,203 @@ void BoxedLcpConstraintSolver::solveConstrainedGroup(
   }
 }
 
+//==============================================================================
+namespace {
+
+/// The rows of A that one skeleton contributes to, and their Jacobian
+struct SkeletonRows
+{
+  dynamics::Skeleton* skeleton;
+
+  /// Rows of A, in increasing order
+  std::vector<std::size_t> rows;
+
+  /// The Jacobian of each constraint, until they're stacked into `jacobian`
+  std::vector<Eigen::MatrixXs> pieces;
+
+  /// rows.size() by dofs
+  Eigen::MatrixXs jacobian;
+
+  /// M^{-1} * J^T, dofs by rows.size()
+  Eigen::MatrixXs massedJacobian;
+
+  /// The upper triangle of J * M^{-1} * J^T for these rows
+  Eigen::MatrixXs block;
+};
+
+/// A contiguous range of rows of one skeleton's Jacobian
+struct AssemblyTask
+{
+  std::size_t skeleton;
+  std::size_t start;
+  std::size_t size;
+};
+
+/// Every skeleton's rows are split into tasks of this many rows. This doesn't
+/// depend on the number of threads, so neither does the result.
+constexpr std::size_t ASSEMBLY_BLOCK_SIZE = 32;
+
+} // namespace
+
+//==============================================================================
+bool BoxedLcpConstraintSolver::assembleFromJacobians(ConstrainedGroup& group)
+{
+  const std::size_t numConstraints = group.getNumConstraints();
+
+  std::vector<SkeletonRows> skeletons;
+  std::unordered_map<const dynamics::Skeleton*, std::size_t> skeletonIndices;
+
+  // For each constraint, the index in `skeletons` of each of its skeletons,
+  // in the order of getSkeletons()
+  std::vector<std::vector<std::size_t>> constraintSkeletons(numConstraints);
+
+  // Collect the Jacobians serially, because the skeletons cache them lazily
+  Eigen::MatrixXs jacobian;
+  for (std::size_t i = 0; i < numConstraints; ++i)
+  {
+    const ConstraintBasePtr& constraint = group.getConstraint(i);
+    for (const dynamics::SkeletonPtr& skel : constraint->getSkeletons())
+    {
+      auto inserted
+          = skeletonIndices.emplace(skel.get(), skeletonIndices.size());
+      if (inserted.second)
+      {
+        // Impulse tests don't move kinematic joints, which M^{-1} can't
+        // express
+        for (std::size_t j = 0; j < skel->getNumJoints(); ++j)
+        {
+          if (!skel->getJoint(j)->isDynamic())
+            return false;
+        }
+        skeletons.push_back(SkeletonRows());
+        skeletons.back().skeleton = skel.get();
+      }
+
+      const std::size_t index = inserted.first->second;
+      std::vector<std::size_t>& indices = constraintSkeletons[i];
+      indices.push_back(index);
+
+      // Both bodies of a self collision report the same skeleton, and its
+      // Jacobian already covers both of them
+      if (std::count(indices.begin(), indices.end(), index) > 1)
+        continue;
+
+      if (!constraint->getJacobian(skel.get(), jacobian))
+        return false;
+
+      SkeletonRows& entry = skeletons[index];
+      for (std::size_t j = 0; j < constraint->getDimension(); ++j)
+        entry.rows.push_back(mOffset[i] + j);
+      entry.pieces.push_back(jacobian);
+    }
+  }
+
+  // Stack the Jacobians, and split every skeleton's rows into tasks
+  std::vector<const Eigen::MatrixXs*> invMassMatrices;
+  std::vector<AssemblyTask> tasks;
+  for (std::size_t s = 0; s < skeletons.size(); ++s)
+  {
+    SkeletonRows& entry = skeletons[s];
+    const std::size_t dofs = entry.skeleton->getNumDofs();
+    const std::size_t numRows = entry.rows.size();
+
+    entry.jacobian.resize(numRows, dofs);
+    std::size_t row = 0;
+    for (const Eigen::MatrixXs& piece : entry.pieces)
+    {
+      entry.jacobian.middleRows(row, piece.rows()) = piece;
+      row += piece.rows();
+    }
+    entry.pieces.clear();
+    entry.massedJacobian.resize(dofs, numRows);
+    entry.block.setZero(numRows, numRows);
+
+    // This is cached lazily too, so it has to be computed before we fan out
+    invMassMatrices.push_back(&entry.skeleton->getInvMassMatrix());
+
+    for (std::size_t start = 0; start < numRows; start += ASSEMBLY_BLOCK_SIZE)
+    {
+      tasks.push_back(AssemblyTask{
+          s, start, std::min(ASSEMBLY_BLOCK_SIZE, numRows - start)});
+    }
+  }
+
+  auto runTasks = [&](const std::function<void(std::size_t)>& fn) {
+    if (mAssemblyThreadPool)
+    {
+      mAssemblyThreadPool->parallelFor(tasks.size(), fn);
+    }
+    else
+    {
+      for (std::size_t t = 0; t < tasks.size(); ++t)
+        fn(t);
+    }
+  };
+
+  // M^{-1} * J^T, a block of columns at a time
+  runTasks([&](std::size_t t) {
+    const AssemblyTask& task = tasks[t];
+    SkeletonRows& entry = skeletons[task.skeleton];
+    entry.massedJacobian.middleCols(task.start, task.size).noalias()
+        = *invMassMatrices[task.skeleton]
+          * entry.jacobian.middleRows(task.start, task.size).transpose();
+  });
+
+  // J * M^{-1} * J^T, a block of rows at a time. A is symmetric, so we only
+  // need the part of each row on and above the diagonal.
+  runTasks([&](std::size_t t) {
+    const AssemblyTask& task = tasks[t];
+    SkeletonRows& entry = skeletons[task.skeleton];
+    const std::size_t numCols = entry.rows.size() - task.start;
+    entry.block.block(task.start, task.start, task.size, numCols).noalias()
+        = entry.jacobian.middleRows(task.start, task.size)
+          * entry.massedJacobian.rightCols(numCols);
+  });
+
+  // Sum the skeletons' contributions in a fixed order, then mirror the upper
+  // triangle into the lower one
+  mA.setZero();
+  for (const SkeletonRows& entry : skeletons)
+  {
+    const std::size_t numRows = entry.rows.size();
+    for (std::size_t a = 0; a < numRows; ++a)
+      for (std::size_t b = a; b < numRows; ++b)
+        mA(entry.rows[a], entry.rows[b]) += entry.block(a, b);
+  }
+  const std::size_t n = group.getTotalDimension();
+  for (std::size_t row = 1; row < n; ++row)
+    for (std::size_t col = 0; col < row; ++col)
+      mA(row, col) = mA(col, row);
+
+  // The gradients need the velocity changes the impulse tests would have
+  // measured, which are the columns of M^{-1} * J^T
+  if (group.getGradientConstraintMatrices())
+  {
+    std::vector<Eigen::VectorXs> velocityChanges;
+    for (std::size_t i = 0; i < numConstraints; ++i)
+    {
+      const ConstraintBasePtr& constraint = group.getConstraint(i);
+      for (std::size_t j = 0; j < constraint->getDimension(); ++j)
+      {
+        const std::size_t row = mOffset[i] + j;
+        velocityChanges.clear();
+        for (std::size_t index : constraintSkeletons[i])
+        {
+          const SkeletonRows& entry = skeletons[index];
+          const std::size_t col
+              = std::lower_bound(entry.rows.begin(), entry.rows.end(), row)
+                - entry.rows.begin();
+          velocityChanges.push_back(entry.massedJacobian.col(col));
+        }
+        group.getGradientConstraintMatrices()->measureConstraintImpulse(
+            constraint, velocityChanges);
+      }
+    }
+  }
+
+  return true;
+}
+
 //==============================================================================
 #ifndef NDEBUG
 bool BoxedLcpConstraintSolver::isSymmetric(std::size_t n, s_t* A)
@@ -33,6 +33,9 @@
 #ifndef DART_CONSTRAINT_BOXEDLCPCONSTRAINTSOLVER_HPP_
 #define DART_CONSTRAINT_BOXEDLCPCONSTRAINTSOLVER_HPP_
 
+#include <memory>
+
+#include "dart/common/ThreadPool.hpp"
 #include "dart/constraint/ConstraintSolver.hpp"
 #include "dart/constraint/SmartPointer.hpp"
 
@@ -95,6 +98,15 @@ public:
   /// Returns boxed LCP (BLCP) solver
   ConstBoxedLcpSolverPtr getBoxedLcpSolver() const;
 
+  /// When enabled, this replaces the primary LCP solver with a
+  /// BlockPivotingBoxedLcpSolver, which warm starts each solve from the cached
+  /// solution of the previous step. Disabling it goes back to Dantzig. Does
+  /// nothing if the primary solver is already of the requested kind.
+  void setWarmStartedLcpEnabled(bool enabled);
+
+  /// Returns true if the primary LCP solver is a BlockPivotingBoxedLcpSolver
+  bool isWarmStartedLcpEnabled() const;
+
   /// Sets boxed LCP (BLCP) solver that is used when the primary solver failed
   void setSecondaryBoxedLcpSolver(BoxedLcpSolverPtr lcpSolver);
 
@@ -112,11 +124,33 @@ public:
   /// our optimistic LCP-stabilization-to-acceptance approach.
   virtual void setCachedLCPSolution(Eigen::VectorXs X) override;
 
+  /// When enabled, the LCP matrix A of each constrained group is assembled as
+  /// J * M^{-1} * J^T from the constraint Jacobians and each skeleton's
+  /// inverse mass matrix, instead of by one impulse test per constraint
+  /// dimension. Groups with constraints that don't provide a Jacobian, or
+  /// with kinematic joints, still use impulse tests. Off by default.
+  void setJacobianAssemblyEnabled(bool enabled);
+
+  /// Returns true if A is assembled from constraint Jacobians when possible
+  bool isJacobianAssemblyEnabled() const;
+
+  /// Sets how many threads compute the Jacobian products when assembling A.
+  /// The result doesn't depend on the number of threads.
+  void setNumAssemblyThreads(std::size_t numThreads);
+
+  /// Returns the number of threads used to assemble A
+  std::size_t getNumAssemblyThreads() const;
+
 protected:
   // Documentation inherited.
   void solveConstrainedGroup(
       ConstrainedGroup& group, simulation::World* world) override;
 
+  /// Fills mA with J * M^{-1} * J^T, and reports the velocity changes to the
+  /// group's gradient matrices, if it has any. Returns false without touching
+  /// anything if some constraint or skeleton in the group doesn't support it.
+  bool assembleFromJacobians(ConstrainedGroup& group);
+
   /// Boxed LCP solver
   BoxedLcpSolverPtr mBoxedLcpSolver;
   // TODO(JS): Hold as unique_ptr because there is no reason to share. Make this
@@ -170,6 +204,13 @@ protected:
   /// Cache data for boxed LCP formulation
   Eigen::VectorXi mOffset;
 
+  /// True if A should be assembled from constraint Jacobians when possible
+  bool mJacobianAssemblyEnabled;
+
+  /// Threads for assembling A from constraint Jacobians. This is null when
+  /// running single threaded.
+  std::unique_ptr<common::ThreadPool> mAssemblyThreadPool;
+
 #ifndef NDEBUG
 private:
   /// Return true if the matrix is symmetric
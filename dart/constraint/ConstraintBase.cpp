@@ -72,6 +72,13 @@ std::vector<dynamics::SkeletonPtr> ConstraintBase::getSkeletons() const
   return skeletons;
 }
 
+//==============================================================================
+bool ConstraintBase::getJacobian(
+    const dynamics::Skeleton* /*skeleton*/, Eigen::MatrixXs& /*jacobian*/) const
+{
+  return false;
+}
+
 //==============================================================================
 dynamics::SkeletonPtr ConstraintBase::compressPath(
     dynamics::SkeletonPtr _skeleton)
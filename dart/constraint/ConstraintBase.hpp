@@ -124,6 +124,15 @@ public:
   /// Returns the skeletons that this constraint touches
   virtual std::vector<dynamics::SkeletonPtr> getSkeletons() const;
 
+  /// Fills `jacobian` with this constraint's Jacobian with respect to the
+  /// generalized velocities of `skeleton`, which must be one of
+  /// getSkeletons(). The result is getDimension() by skeleton->getNumDofs(),
+  /// and J * M^{-1} * J^T is the velocity change that applyUnitImpulse() and
+  /// getVelocityChange() would measure. Returns false if this constraint can
+  /// only be measured with impulse tests, which is the default.
+  virtual bool getJacobian(
+      const dynamics::Skeleton* skeleton, Eigen::MatrixXs& jacobian) const;
+
   /// Returns the root union skeleton, even if there are multiple hops. Also
   /// compresses the hops somewhat as it goes, though not completely.
   static dynamics::SkeletonPtr compressPath(dynamics::SkeletonPtr skeleton);
@@ -32,6 +32,8 @@
 
 #include "dart/constraint/ConstraintSolver.hpp"
 
+#include <tuple>
+
 #include "dart/collision/CollisionFilter.hpp"
 #include "dart/collision/CollisionGroup.hpp"
 #include "dart/collision/CollisionObject.hpp"
@@ -70,7 +72,9 @@ ConstraintSolver::ConstraintSolver(s_t timeStep)
         false), // Default to no penetration correction, because it breaks our
                 // gradients
     mContactClippingDepth(
-        0.03) // Default to clipping only after fairly deep penetration
+        0.03), // Default to clipping only after fairly deep penetration
+    mContactCoherenceEnabled(false),
+    mConstrainedGroupsReusable(false)
 {
   assert(timeStep > 0.0);
 }
@@ -87,7 +91,9 @@ ConstraintSolver::ConstraintSolver()
         false), // Default to no penetration correction, because it breaks our
                 // gradients
     mContactClippingDepth(
-        0.03) // Default to clipping only after fairly deep penetration
+        0.03), // Default to clipping only after fairly deep penetration
+    mContactCoherenceEnabled(false),
+    mConstrainedGroupsReusable(false)
 {
 }
 
@@ -143,6 +149,7 @@ void ConstraintSolver::removeSkeleton(const SkeletonPtr& skeleton)
   mSkeletons.erase(
       remove(mSkeletons.begin(), mSkeletons.end(), skeleton), mSkeletons.end());
   mConstrainedGroups.reserve(mSkeletons.size());
+  clearContactCoherence();
 }
 
 //==============================================================================
@@ -158,6 +165,7 @@ void ConstraintSolver::removeAllSkeletons()
 {
   mCollisionGroup->removeAllShapeFrames();
   mSkeletons.clear();
+  clearContactCoherence();
 }
 
 //==============================================================================
@@ -246,6 +254,8 @@ void ConstraintSolver::clearLastCollisionResult()
 void ConstraintSolver::setTimeStep(s_t _timeStep)
 {
   assert(_timeStep > 0.0 && "Time step should be positive value.");
+  if (mTimeStep != _timeStep)
+    clearContactCoherence();
   mTimeStep = _timeStep;
 }
 
@@ -281,6 +291,7 @@ void ConstraintSolver::setCollisionDetector(
   mCollisionDetector = collisionDetector;
 
   mCollisionGroup = mCollisionDetector->createCollisionGroupAsSharedPtr();
+  clearContactCoherence();
 
   for (const auto& skeleton : mSkeletons)
     mCollisionGroup->addShapeFramesOf(skeleton.get());
@@ -403,6 +414,8 @@ void ConstraintSolver::setGradientEnabled(bool enabled)
 //==============================================================================
 void ConstraintSolver::setPenetrationCorrectionEnabled(bool enable)
 {
+  if (mPenetrationCorrectionEnabled != enable)
+    clearContactCoherence();
   mPenetrationCorrectionEnabled = enable;
 }
 
@@ -438,6 +451,62 @@ s_t ConstraintSolver::getContactClippingDepth()
   return mContactClippingDepth;
 }
 
+//==============================================================================
+void ConstraintSolver::setContactCoherenceEnabled(bool enabled)
+{
+  if (enabled == mContactCoherenceEnabled)
+    return;
+  mContactCoherenceEnabled = enabled;
+  clearContactCoherence();
+  resetContactCoherenceStats();
+}
+
+//==============================================================================
+bool ConstraintSolver::getContactCoherenceEnabled() const
+{
+  return mContactCoherenceEnabled;
+}
+
+//==============================================================================
+const ContactCoherenceStats& ConstraintSolver::getContactCoherenceStats() const
+{
+  return mContactCoherenceStats;
+}
+
+//==============================================================================
+void ConstraintSolver::resetContactCoherenceStats()
+{
+  mContactCoherenceStats = ContactCoherenceStats();
+}
+
+//==============================================================================
+void ConstraintSolver::clearContactCoherence()
+{
+  mPersistentContacts.clear();
+  mLastActiveConstraints.clear();
+  mConstrainedGroupsReusable = false;
+}
+
+//==============================================================================
+bool ConstraintSolver::ContactFeature::operator<(
+    const ContactFeature& other) const
+{
+  return std::tie(
+             collisionObject1,
+             collisionObject2,
+             type,
+             triID1,
+             triID2,
+             ordinal)
+         < std::tie(
+             other.collisionObject1,
+             other.collisionObject2,
+             other.type,
+             other.triID1,
+             other.triID2,
+             other.ordinal);
+}
+
 //==============================================================================
 bool ConstraintSolver::containSkeleton(const ConstSkeletonPtr& _skeleton) const
 {
@@ -526,6 +595,16 @@ void ConstraintSolver::updateConstraints()
   // Destroy previous soft contact constraints
   mSoftContactConstraints.clear();
 
+  // Contact constraints from the last step that we can reuse, and the ones we
+  // use this step, keyed by contact feature
+  std::map<ContactFeature, ContactConstraintPtr> lastContacts;
+  std::map<ContactFeature, ContactConstraintPtr> nextContacts;
+  std::map<ContactFeature, int> featureCounts;
+  if (mContactCoherenceEnabled)
+  {
+    lastContacts.swap(mPersistentContacts);
+  }
+
   // Create new contact constraints
   for (auto i = 0u; i < mCollisionResult.getNumContacts(); ++i)
   {
@@ -563,6 +642,41 @@ void ConstraintSolver::updateConstraints()
       mSoftContactConstraints.push_back(
           std::make_shared<SoftContactConstraint>(contact, mTimeStep));
     }
+    else if (mContactCoherenceEnabled)
+    {
+      ContactFeature feature;
+      feature.collisionObject1 = contact.collisionObject1;
+      feature.collisionObject2 = contact.collisionObject2;
+      feature.type = static_cast<int>(contact.type);
+      feature.triID1 = contact.triID1;
+      feature.triID2 = contact.triID2;
+      feature.ordinal = 0;
+      feature.ordinal = featureCounts[feature]++;
+
+      ContactConstraintPtr contactConstraint;
+      auto last = lastContacts.find(feature);
+      // Collision objects can be freed and their addresses reused, so
+      // double check that we're still talking about the same bodies
+      if (last != lastContacts.end()
+          && last->second->getBodyNodeA()
+                 == shapeFrame1->asShapeNode()->getBodyNodePtr().get()
+          && last->second->getBodyNodeB()
+                 == shapeFrame2->asShapeNode()->getBodyNodePtr().get())
+      {
+        contactConstraint = last->second;
+        contactConstraint->setContact(contact);
+        lastContacts.erase(last);
+        mContactCoherenceStats.numPersistentContacts++;
+      }
+      else
+      {
+        contactConstraint = std::make_shared<ContactConstraint>(
+            contact, mTimeStep, mPenetrationCorrectionEnabled);
+        mContactCoherenceStats.numNewContacts++;
+      }
+      mContactConstraints.push_back(contactConstraint);
+      nextContacts[feature] = contactConstraint;
+    }
     else
     {
       mContactConstraints.push_back(std::make_shared<ContactConstraint>(
@@ -570,6 +684,13 @@ void ConstraintSolver::updateConstraints()
     }
   }
 
+  if (mContactCoherenceEnabled)
+  {
+    mContactCoherenceStats.numSteps++;
+    mContactCoherenceStats.numRemovedContacts += lastContacts.size();
+    mPersistentContacts.swap(nextContacts);
+  }
+
   // Add the new contact constraints to dynamic constraint list
   for (const auto& contactConstraint : mContactConstraints)
   {
@@ -680,6 +801,40 @@ void ConstraintSolver::updateConstraints()
 //==============================================================================
 void ConstraintSolver::buildConstrainedGroups()
 {
+  // If exactly the same constraints are active as last step, then uniting the
+  // skeletons would give us back exactly the same groups, so keep them
+  if (mContactCoherenceEnabled && mConstrainedGroupsReusable
+      && mActiveConstraints == mLastActiveConstraints)
+  {
+    mContactCoherenceStats.numReusedConstrainedGroups++;
+    if (mGradientEnabled)
+    {
+      for (const auto& skel : mSkeletons)
+      {
+        skel->clearGradientConstraintMatrices();
+      }
+      for (auto& constrainedGroup : mConstrainedGroups)
+      {
+        auto m = neural::createGradientMatrices(constrainedGroup, mTimeStep);
+        constrainedGroup.setGradientConstraintMatrices(m);
+      }
+    }
+    else
+    {
+      // A freshly built group wouldn't have any gradient matrices attached
+      for (auto& constrainedGroup : mConstrainedGroups)
+      {
+        constrainedGroup.mGradientConstraintMatrices = nullptr;
+      }
+    }
+    return;
+  }
+  if (mContactCoherenceEnabled)
+  {
+    mLastActiveConstraints = mActiveConstraints;
+    mConstrainedGroupsReusable = true;
+  }
+
   // Clear constrained groups
   mConstrainedGroups.clear();
   if (mGradientEnabled)
@@ -33,6 +33,7 @@
 #ifndef DART_CONSTRAINT_CONSTRAINTSOVER_HPP_
 #define DART_CONSTRAINT_CONSTRAINTSOVER_HPP_
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -58,6 +59,29 @@ class ShapeNodeCollisionObject;
 
 namespace constraint {
 
+/// Running totals of how the contact set changed between calls to
+/// ConstraintSolver::solve(), collected while contact coherence is enabled.
+struct ContactCoherenceStats
+{
+  /// Number of calls to solve() that these totals cover
+  std::size_t numSteps = 0;
+
+  /// Contacts that matched a contact from the previous step, and reused its
+  /// ContactConstraint
+  std::size_t numPersistentContacts = 0;
+
+  /// Contacts that had no match in the previous step, and needed a new
+  /// ContactConstraint
+  std::size_t numNewContacts = 0;
+
+  /// Contacts from the previous step that had no match in the next step
+  std::size_t numRemovedContacts = 0;
+
+  /// Number of steps where the constrained groups from the previous step were
+  /// reused as-is, because the active constraints didn't change
+  std::size_t numReusedConstrainedGroups = 0;
+};
+
 /// ConstraintSolver manages constraints and computes constraint impulses
 class ConstraintSolver
 {
@@ -221,6 +245,25 @@ public:
   /// impossibly deep inter-penetration during multiple shooting optimization.
   s_t getContactClippingDepth();
 
+  /// False by default. When enabled, contacts are matched against the previous
+  /// step by their collision objects and features, and matching contacts
+  /// reuse their ContactConstraint instead of allocating a new one. If the
+  /// resulting set of active constraints is unchanged from the previous step,
+  /// the constrained groups are reused too. The simulation results are
+  /// identical either way; this only saves work in scenes where the contact
+  /// set is stable, like quasi-static manipulation.
+  void setContactCoherenceEnabled(bool enabled);
+
+  /// Returns true if contact coherence is enabled
+  bool getContactCoherenceEnabled() const;
+
+  /// Returns the contact churn recorded since contact coherence was enabled, or
+  /// since the last call to resetContactCoherenceStats()
+  const ContactCoherenceStats& getContactCoherenceStats() const;
+
+  /// Zeros out the contact churn totals
+  void resetContactCoherenceStats();
+
 protected:
   // TODO(JS): Docstring
   virtual void solveConstrainedGroup(
@@ -251,6 +294,26 @@ protected:
   /// Return true if at least one of colliding body is soft body
   bool isSoftContact(const collision::Contact& contact) const;
 
+  /// Drops every ContactConstraint and group kept for contact coherence. This
+  /// needs to be called whenever something other than the contact geometry
+  /// would make a reused constraint differ from a freshly built one.
+  void clearContactCoherence();
+
+  /// Identifies a contact across timesteps. Two contacts match if they're
+  /// between the same collision objects with the same features. `ordinal`
+  /// disambiguates contacts that are otherwise identical.
+  struct ContactFeature
+  {
+    const collision::CollisionObject* collisionObject1;
+    const collision::CollisionObject* collisionObject2;
+    int type;
+    int triID1;
+    int triID2;
+    int ordinal;
+
+    bool operator<(const ContactFeature& other) const;
+  };
+
   using CollisionDetector = collision::CollisionDetector;
 
   /// Collision detector
@@ -309,6 +372,23 @@ protected:
   /// This is a simple solution to avoid extremely nasty situations with
   /// impossibly deep inter-penetration during multiple shooting optimization.
   s_t mContactClippingDepth;
+
+  /// True if we want to reuse contact constraints and constrained groups
+  /// across timesteps
+  bool mContactCoherenceEnabled;
+
+  /// Contact constraints from the last step, keyed by contact feature
+  std::map<ContactFeature, ContactConstraintPtr> mPersistentContacts;
+
+  /// Active constraints from the last step, used to decide whether the last
+  /// step's constrained groups can be reused
+  std::vector<ConstraintBasePtr> mLastActiveConstraints;
+
+  /// True if mConstrainedGroups may be reused on the next step
+  bool mConstrainedGroupsReusable;
+
+  /// Contact churn since contact coherence was enabled
+  ContactCoherenceStats mContactCoherenceStats;
 };
 
 } // namespace constraint
@@ -77,7 +77,7 @@ ContactConstraint::ContactConstraint(
                    contact.collisionObject2->getShapeFrame())
                    ->asShapeNode()
                    ->getBodyNodePtr()),
-    mContact(contact),
+    mContact(&contact),
     mFirstFrictionalDirection(Eigen::Vector3s::UnitZ()),
     mIsFrictionOn(true),
     mAppliedImpulseIndex(dynamics::INVALID_INDEX),
@@ -86,6 +86,35 @@ ContactConstraint::ContactConstraint(
     mIsBounceOn(false),
     mActive(false)
 {
+  setContact(contact);
+}
+
+//==============================================================================
+void ContactConstraint::setContact(collision::Contact& contact)
+{
+  assert(
+      contact.collisionObject1->getShapeFrame()
+          ->asShapeNode()
+          ->getBodyNodePtr()
+          .get()
+      == mBodyNodeA.get());
+  assert(
+      contact.collisionObject2->getShapeFrame()
+          ->asShapeNode()
+          ->getBodyNodePtr()
+          .get()
+      == mBodyNodeB.get());
+
+  // Reset everything to the state a freshly constructed constraint would have,
+  // so that reusing a constraint is indistinguishable from making a new one
+  mContact = &contact;
+  mFirstFrictionalDirection = Eigen::Vector3s::UnitZ();
+  mIsFrictionOn = true;
+  mAppliedImpulseIndex = dynamics::INVALID_INDEX;
+  mDidBounce = false;
+  mIsBounceOn = false;
+  mActive = false;
+
   assert(
       contact.normal.squaredNorm() >= DART_CONTACT_CONSTRAINT_EPSILON_SQUARED);
 
@@ -148,7 +177,7 @@ ContactConstraint::ContactConstraint(
     Eigen::Vector3s bodyPointA;
     Eigen::Vector3s bodyPointB;
 
-    collision::Contact& ct = mContact;
+    collision::Contact& ct = *mContact;
 
     // TODO(JS): Assumed that the number of tangent basis is 2.
     const TangentBasisMatrix D = getTangentBasisMatrixODE(ct.normal);
@@ -206,7 +235,7 @@ ContactConstraint::ContactConstraint(
     mSpatialNormalA.resize(6, 1);
     mSpatialNormalB.resize(6, 1);
 
-    collision::Contact& ct = mContact;
+    collision::Contact& ct = *mContact;
 
     // Contact normal in the local coordinates
     const Eigen::Vector3s bodyDirectionA
@@ -380,7 +409,7 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
     // Bouncing
     //------------------------------------------------------------------------
     // A. Penetration correction
-    s_t bouncingVelocity = mContact.penetrationDepth - mErrorAllowance;
+    s_t bouncingVelocity = mContact->penetrationDepth - mErrorAllowance;
     if (bouncingVelocity < 0.0)
     {
       bouncingVelocity = 0.0;
@@ -449,7 +478,7 @@ void ContactConstraint::getInformation(ConstraintInfo* info)
     // Bouncing
     //------------------------------------------------------------------------
     // A. Penetration correction
-    s_t bouncingVelocity = mContact.penetrationDepth - DART_ERROR_ALLOWANCE;
+    s_t bouncingVelocity = mContact->penetrationDepth - DART_ERROR_ALLOWANCE;
     if (bouncingVelocity < 0.0)
     {
       bouncingVelocity = 0.0;
@@ -627,7 +656,7 @@ void ContactConstraint::applyImpulse(s_t* lambda)
     assert(!math::isNan(lambda[2]));
 
     // Store contact impulse (force) toward the normal w.r.t. world frame
-    mContact.force = mContact.normal * lambda[0] / mTimeStep;
+    mContact->force = mContact->normal * lambda[0] / mTimeStep;
 
     // Normal impulsive force
     if (mBodyNodeA->isReactive())
@@ -636,8 +665,8 @@ void ContactConstraint::applyImpulse(s_t* lambda)
       mBodyNodeB->addConstraintImpulse(mSpatialNormalB.col(0) * lambda[0]);
 
     // Add contact impulse (force) toward the tangential w.r.t. world frame
-    const Eigen::MatrixXs D = getTangentBasisMatrixODE(mContact.normal);
-    mContact.force += D.col(0) * lambda[1] / mTimeStep;
+    const Eigen::MatrixXs D = getTangentBasisMatrixODE(mContact->normal);
+    mContact->force += D.col(0) * lambda[1] / mTimeStep;
 
     // Tangential direction-1 impulsive force
     if (mBodyNodeA->isReactive())
@@ -646,7 +675,7 @@ void ContactConstraint::applyImpulse(s_t* lambda)
       mBodyNodeB->addConstraintImpulse(mSpatialNormalB.col(1) * lambda[1]);
 
     // Add contact impulse (force) toward the tangential w.r.t. world frame
-    mContact.force += D.col(1) * lambda[2] / mTimeStep;
+    mContact->force += D.col(1) * lambda[2] / mTimeStep;
 
     // Tangential direction-2 impulsive force
     if (mBodyNodeA->isReactive())
@@ -667,7 +696,7 @@ void ContactConstraint::applyImpulse(s_t* lambda)
       mBodyNodeB->addConstraintImpulse(mSpatialNormalB * lambda[0]);
 
     // Store contact impulse (force) toward the normal w.r.t. world frame
-    mContact.force = mContact.normal * lambda[0] / mTimeStep;
+    mContact->force = mContact->normal * lambda[0] / mTimeStep;
   }
 }
 
@@ -901,10 +930,33 @@ std::vector<dynamics::SkeletonPtr> ContactConstraint::getSkeletons() const
   return skeletons;
 }
 
+//==============================================================================
+bool ContactConstraint::getJacobian(
+    const dynamics::Skeleton* skeleton, Eigen::MatrixXs& jacobian) const
+{
+  jacobian.setZero(mDim, skeleton->getNumDofs());
+
+  // In a self collision both bodies belong to the same skeleton, and both
+  // contribute to the same rows
+  if (mBodyNodeA->isReactive() && mBodyNodeA->getSkeleton().get() == skeleton)
+  {
+    jacobian.noalias()
+        += mSpatialNormalA.transpose() * skeleton->getJacobian(mBodyNodeA);
+  }
+
+  if (mBodyNodeB->isReactive() && mBodyNodeB->getSkeleton().get() == skeleton)
+  {
+    jacobian.noalias()
+        += mSpatialNormalB.transpose() * skeleton->getJacobian(mBodyNodeB);
+  }
+
+  return true;
+}
+
 //==============================================================================
 const collision::Contact& ContactConstraint::getContact() const
 {
-  return mContact;
+  return *mContact;
 }
 
 //==============================================================================
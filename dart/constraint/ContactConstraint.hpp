@@ -93,6 +93,13 @@ public:
   /// Get first frictional direction
   const Eigen::Vector3s& getFrictionDirection1() const;
 
+  /// Rebinds this constraint to a new contact between the same pair of body
+  /// nodes, and recomputes everything that depends on the contact geometry.
+  /// This is equivalent to constructing a fresh ContactConstraint, and lets
+  /// ConstraintSolver reuse constraints for contacts that persist across
+  /// timesteps.
+  void setContact(collision::Contact& contact);
+
   // Returns the contact
   const collision::Contact& getContact() const;
 
@@ -144,6 +151,11 @@ protected:
   // Documentation inherited
   std::vector<dynamics::SkeletonPtr> getSkeletons() const override;
 
+  // Documentation inherited
+  bool getJacobian(
+      const dynamics::Skeleton* skeleton,
+      Eigen::MatrixXs& jacobian) const override;
+
   // Documentation inherited
   bool isActive() const override;
 
@@ -188,7 +200,7 @@ private:
   dynamics::BodyNodePtr mBodyNodeB;
 
   /// Contact between mBodyNode1 and mBodyNode2
-  collision::Contact& mContact;
+  collision::Contact* mContact;
 
   /// First frictional direction
   Eigen::Vector3s mFirstFrictionalDirection;
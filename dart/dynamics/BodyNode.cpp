@@ -1495,6 +1495,7 @@ void BodyNode::dirtyTransform()
     SET_FLAGS(mGravityForces);
     SET_FLAGS(mCoriolisAndGravityForces);
     SET_FLAGS(mExternalForces);
+    SET_FLAGS(mWorldPositionJacobians);
   }
 
   // Child BodyNodes and other generic Entities are notified separately to allow
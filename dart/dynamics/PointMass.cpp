@@ -145,29 +145,7 @@ PointMass::PointMass(SoftBodyNode* _softBodyNode)
     mVelocitiesDeriv(Eigen::Vector3s::Zero()),
     mAccelerationsDeriv(Eigen::Vector3s::Zero()),
     mForcesDeriv(Eigen::Vector3s::Zero()),
-    mVelocityChanges(Eigen::Vector3s::Zero()),
-    // mImpulse(Eigen::Vector3s::Zero()),
-    mConstraintImpulses(Eigen::Vector3s::Zero()),
-    mW(Eigen::Vector3s::Zero()),
-    mX(Eigen::Vector3s::Zero()),
-    mV(Eigen::Vector3s::Zero()),
-    mEta(Eigen::Vector3s::Zero()),
-    mAlpha(Eigen::Vector3s::Zero()),
-    mBeta(Eigen::Vector3s::Zero()),
-    mA(Eigen::Vector3s::Zero()),
-    mF(Eigen::Vector3s::Zero()),
-    mPsi(0.0),
-    mImplicitPsi(0.0),
-    mPi(0.0),
-    mImplicitPi(0.0),
-    mB(Eigen::Vector3s::Zero()),
-    mFext(Eigen::Vector3s::Zero()),
     mIsColliding(false),
-    mDelV(Eigen::Vector3s::Zero()),
-    mImpB(Eigen::Vector3s::Zero()),
-    mImpAlpha(Eigen::Vector3s::Zero()),
-    mImpBeta(Eigen::Vector3s::Zero()),
-    mImpF(Eigen::Vector3s::Zero()),
     mNotifier(_softBodyNode->mNotifier)
 {
   assert(mParentSoftBodyNode != nullptr);
@@ -207,6 +185,7 @@ void PointMass::setMass(s_t _mass)
     return;
 
   mMass = _mass;
+  mParentSoftBodyNode->mPointArrays.mNeedConstantsUpdate = true;
   mParentSoftBodyNode->incrementVersion();
 }
 
@@ -220,28 +199,28 @@ s_t PointMass::getMass() const
 s_t PointMass::getPsi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mPsi;
+  return mParentSoftBodyNode->mPointArrays.mPsi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getImplicitPsi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mImplicitPsi;
+  return mParentSoftBodyNode->mPointArrays.mImplicitPsi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getPi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mPi;
+  return mParentSoftBodyNode->mPointArrays.mPi[mIndex];
 }
 
 //==============================================================================
 s_t PointMass::getImplicitPi() const
 {
   mParentSoftBodyNode->checkArticulatedInertiaUpdate();
-  return mImplicitPi;
+  return mParentSoftBodyNode->mPointArrays.mImplicitPi[mIndex];
 }
 
 //==============================================================================
@@ -251,6 +230,7 @@ void PointMass::addConnectedPointMass(PointMass* _pointMass)
 
   mParentSoftBodyNode->mAspectProperties.mPointProps[mIndex].
       mConnectedPointMassIndices.push_back(_pointMass->mIndex);
+  mParentSoftBodyNode->mPointArrays.mNeedConstantsUpdate = true;
   mParentSoftBodyNode->incrementVersion();
 }
 
@@ -416,11 +396,9 @@ const Vector3s& PointMass::getAccelerations() const
 }
 
 //==============================================================================
-const Vector3s& PointMass::getPartialAccelerations() const
+Vector3s PointMass::getPartialAccelerations() const
 {
-  if(mNotifier->needsPartialAccelerationUpdate())
-    mParentSoftBodyNode->updatePartialAcceleration();
-  return mEta;
+  return mParentSoftBodyNode->getPointMassPartialAccelerations().col(mIndex);
 }
 
 //==============================================================================
@@ -469,7 +447,8 @@ void PointMass::setVelocityChange(std::size_t _index, s_t _velocityChange)
 {
   assert(_index < 3);
 
-  mVelocityChanges[_index] = _velocityChange;
+  mParentSoftBodyNode->mPointArrays.mVelocityChanges(_index, mIndex)
+      = _velocityChange;
 }
 
 //==============================================================================
@@ -477,13 +456,13 @@ s_t PointMass::getVelocityChange(std::size_t _index)
 {
   assert(_index < 3);
 
-  return mVelocityChanges[_index];
+  return mParentSoftBodyNode->mPointArrays.mVelocityChanges(_index, mIndex);
 }
 
 //==============================================================================
 void PointMass::resetVelocityChanges()
 {
-  mVelocityChanges.setZero();
+  mParentSoftBodyNode->mPointArrays.mVelocityChanges.col(mIndex).setZero();
 }
 
 //==============================================================================
@@ -491,7 +470,8 @@ void PointMass::setConstraintImpulse(std::size_t _index, s_t _impulse)
 {
   assert(_index < 3);
 
-  mConstraintImpulses[_index] = _impulse;
+  mParentSoftBodyNode->mPointArrays.mConstraintImpulses(_index, mIndex)
+      = _impulse;
 }
 
 //==============================================================================
@@ -499,13 +479,14 @@ s_t PointMass::getConstraintImpulse(std::size_t _index)
 {
   assert(_index < 3);
 
-  return mConstraintImpulses[_index];
+  return mParentSoftBodyNode->mPointArrays.mConstraintImpulses(
+      _index, mIndex);
 }
 
 //==============================================================================
 void PointMass::resetConstraintImpulses()
 {
-  mConstraintImpulses.setZero();
+  mParentSoftBodyNode->mPointArrays.mConstraintImpulses.col(mIndex).setZero();
 }
 
 //==============================================================================
@@ -523,36 +504,39 @@ void PointMass::integrateVelocities(s_t _dt)
 //==============================================================================
 void PointMass::addExtForce(const Eigen::Vector3s& _force, bool _isForceLocal)
 {
+  auto fext = mParentSoftBodyNode->mPointArrays.mFext.col(mIndex);
   if (_isForceLocal)
   {
-    mFext += _force;
+    fext += _force;
   }
   else
   {
-    mFext += mParentSoftBodyNode->getWorldTransform().linear().transpose()
-             * _force;
+    fext += mParentSoftBodyNode->getWorldTransform().linear().transpose()
+            * _force;
   }
 }
 
 //==============================================================================
 void PointMass::clearExtForce()
 {
-  mFext.setZero();
+  mParentSoftBodyNode->mPointArrays.mFext.col(mIndex).setZero();
 }
 
 //==============================================================================
 void PointMass::setConstraintImpulse(const Eigen::Vector3s& _constImp,
                                      bool _isLocal)
 {
+  auto impulse = mParentSoftBodyNode->mPointArrays.mConstraintImpulses.col(
+      mIndex);
   if (_isLocal)
   {
-    mConstraintImpulses = _constImp;
+    impulse = _constImp;
   }
   else
   {
     const Matrix3s Rt
         = mParentSoftBodyNode->getWorldTransform().linear().transpose();
-    mConstraintImpulses = Rt * _constImp;
+    impulse = Rt * _constImp;
   }
 }
 
@@ -560,34 +544,37 @@ void PointMass::setConstraintImpulse(const Eigen::Vector3s& _constImp,
 void PointMass::addConstraintImpulse(const Eigen::Vector3s& _constImp,
                                      bool _isLocal)
 {
+  auto impulse = mParentSoftBodyNode->mPointArrays.mConstraintImpulses.col(
+      mIndex);
   if (_isLocal)
   {
-    mConstraintImpulses += _constImp;
+    impulse += _constImp;
   }
   else
   {
     const Matrix3s Rt
         = mParentSoftBodyNode->getWorldTransform().linear().transpose();
-    mConstraintImpulses.noalias() += Rt * _constImp;
+    impulse.noalias() += Rt * _constImp;
   }
 }
 
 //==============================================================================
 Eigen::Vector3s PointMass::getConstraintImpulses() const
 {
-  return mConstraintImpulses;
+  return mParentSoftBodyNode->mPointArrays.mConstraintImpulses.col(mIndex);
 }
 
 //==============================================================================
 void PointMass::clearConstraintImpulse()
 {
   assert(getNumDofs() == 3);
-  mConstraintImpulses.setZero();
-  mDelV.setZero();
-  mImpB.setZero();
-  mImpAlpha.setZero();
-  mImpBeta.setZero();
-  mImpF.setZero();
+  SoftBodyNode::PointMassArrays& arrays = mParentSoftBodyNode->mPointArrays;
+  arrays.mConstraintImpulses.col(mIndex).setZero();
+  arrays.mDelV.col(mIndex).setZero();
+  arrays.mImpB.col(mIndex).setZero();
+  arrays.mImpAlpha.col(mIndex).setZero();
+  arrays.mImpBeta.col(mIndex).setZero();
+  arrays.mImpF.col(mIndex).setZero();
 }
 
 //==============================================================================
@@ -600,6 +587,7 @@ void PointMass::setRestingPosition(const Eigen::Vector3s& _p)
     return;
 
   mRest = _p;
+  mParentSoftBodyNode->mPointArrays.mNeedConstantsUpdate = true;
   mParentSoftBodyNode->incrementVersion();
   mNotifier->dirtyTransform();
 }
@@ -611,19 +599,17 @@ const Eigen::Vector3s& PointMass::getRestingPosition() const
 }
 
 //==============================================================================
-const Eigen::Vector3s& PointMass::getLocalPosition() const
+Eigen::Vector3s PointMass::getLocalPosition() const
 {
-  if(mNotifier->needsTransformUpdate())
-    mParentSoftBodyNode->updateTransform();
-  return mX;
+  return mParentSoftBodyNode->getPointMassLocalPositions().col(mIndex);
 }
 
 //==============================================================================
-const Eigen::Vector3s& PointMass::getWorldPosition() const
+Eigen::Vector3s PointMass::getWorldPosition() const
 {
   if(mNotifier && mNotifier->needsTransformUpdate())
     mParentSoftBodyNode->updateTransform();
-  return mW;
+  return mParentSoftBodyNode->mPointArrays.mW.col(mIndex);
 }
 
 //==============================================================================
@@ -656,9 +642,9 @@ Eigen::Matrix<s_t, 3, Eigen::Dynamic> PointMass::getWorldJacobian()
 }
 
 //==============================================================================
-const Eigen::Vector3s& PointMass::getBodyVelocityChange() const
+Eigen::Vector3s PointMass::getBodyVelocityChange() const
 {
-  return mDelV;
+  return mParentSoftBodyNode->mPointArrays.mDelV.col(mIndex);
 }
 
 //==============================================================================
@@ -687,11 +673,9 @@ const SoftBodyNode* PointMass::getParentSoftBodyNode() const
 //}
 
 //==============================================================================
-const Eigen::Vector3s&PointMass::getBodyVelocity() const
+Eigen::Vector3s PointMass::getBodyVelocity() const
 {
-  if(mNotifier->needsVelocityUpdate())
-    mParentSoftBodyNode->updateVelocity();
-  return mV;
+  return mParentSoftBodyNode->getPointMassBodyVelocities().col(mIndex);
 }
 
 //==============================================================================
@@ -701,11 +685,9 @@ Eigen::Vector3s PointMass::getWorldVelocity() const
 }
 
 //==============================================================================
-const Eigen::Vector3s& PointMass::getBodyAcceleration() const
+Eigen::Vector3s PointMass::getBodyAcceleration() const
 {
-  if(mNotifier->needsAccelerationUpdate())
-    mParentSoftBodyNode->updateAccelerationID();
-  return mA;
+  return mParentSoftBodyNode->getPointMassBodyAccelerations().col(mIndex);
 }
 
 //==============================================================================
@@ -720,167 +702,6 @@ void PointMass::init()
   mDependentGenCoordIndices = mParentSoftBodyNode->getDependentGenCoordIndices();
 }
 
-//==============================================================================
-void PointMass::updateTransform() const
-{
-  // Local translation
-  mX = getPositions() + getRestingPosition();
-  assert(!math::isNan(mX));
-
-  // World translation
-  const Eigen::Isometry3s& parentW = mParentSoftBodyNode->getWorldTransform();
-  mW = parentW.translation() + parentW.linear() * mX;
-  assert(!math::isNan(mW));
-}
-
-//==============================================================================
-void PointMass::updateVelocity() const
-{
-  // v = w(parent) x mX + v(parent) + dq
-  const Eigen::Vector6s& v_parent = mParentSoftBodyNode->getSpatialVelocity();
-  mV = v_parent.head<3>().cross(getLocalPosition()) + v_parent.tail<3>()
-       + getVelocities();
-  assert(!math::isNan(mV));
-}
-
-//==============================================================================
-void PointMass::updatePartialAcceleration() const
-{
-  // eta = w(parent) x dq
-  const Eigen::Vector3s& dq = getVelocities();
-  mEta = mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(dq);
-  assert(!math::isNan(mEta));
-}
-
-//==============================================================================
-void PointMass::updateAccelerationID() const
-{
-  // dv = dw(parent) x mX + dv(parent) + eata + ddq
-  const Eigen::Vector6s& a_parent = mParentSoftBodyNode->getSpatialAcceleration();
-  mA = a_parent.head<3>().cross(getLocalPosition()) + a_parent.tail<3>()
-       + getPartialAccelerations() + getAccelerations();
-  assert(!math::isNan(mA));
-}
-
-//==============================================================================
-void PointMass::updateTransmittedForceID(const Eigen::Vector3s& _gravity,
-                                         bool /*_withExternalForces*/)
-{
-  // f = m*dv + w(parent) x m*v - fext
-  mF.noalias() = getMass() * getBodyAcceleration();
-  mF += mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
-        getMass() * getBodyVelocity()) - mFext;
-  if (mParentSoftBodyNode->getGravityMode() == true)
-  {
-    mF -= getMass() * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
-                   * _gravity);
-  }
-  assert(!math::isNan(mF));
-}
-
-//==============================================================================
-void PointMass::updateArtInertiaFD(s_t _timeStep) const
-{
-  // Articulated inertia
-  // - Do nothing
-
-  // Cache data: PsiK and Psi
-  mPsi = 1.0 / getMass();
-  mImplicitPsi
-      = 1.0 / (getMass()
-               + _timeStep * mParentSoftBodyNode->getDampingCoefficient()
-               + _timeStep * _timeStep
-                 * mParentSoftBodyNode->getVertexSpringStiffness());
-  assert(!math::isNan(mImplicitPsi));
-
-  // Cache data: AI_S_Psi
-  // - Do nothing
-
-  // Cache data: Pi
-  mPi         = getMass() - getMass() * getMass() * mPsi;
-  mImplicitPi = getMass() - getMass() * getMass() * mImplicitPsi;
-  assert(!math::isNan(mPi));
-  assert(!math::isNan(mImplicitPi));
-}
-
-//==============================================================================
-void PointMass::updateJointForceID(s_t /*_timeStep*/,
-                                   s_t /*_withDampingForces*/,
-                                   s_t /*_withSpringForces*/)
-{
-  // tau = f
-  getState().mForces = mF;
-  // TODO: need to add spring and damping forces
-}
-
-//==============================================================================
-void PointMass::updateBiasForceFD(s_t _dt, const Eigen::Vector3s& _gravity)
-{
-  // B = w(parent) x m*v - fext - fgravity
-  // - w(parent) x m*v - fext
-  mB = mParentSoftBodyNode->getSpatialVelocity().head<3>().cross(
-        getMass() * getBodyVelocity()) - mFext;
-  // - fgravity
-  if (mParentSoftBodyNode->getGravityMode() == true)
-  {
-    mB -= getMass()
-          * (mParentSoftBodyNode->getWorldTransform().linear().transpose()
-             * _gravity);
-  }
-  assert(!math::isNan(mB));
-
-  const State& state = getState();
-
-  // Cache data: alpha
-  s_t kv = mParentSoftBodyNode->getVertexSpringStiffness();
-  s_t ke = mParentSoftBodyNode->getEdgeSpringStiffness();
-  s_t kd = mParentSoftBodyNode->getDampingCoefficient();
-  int nN = getNumConnectedPointMasses();
-  mAlpha = state.mForces
-           - (kv + nN * ke) * getPositions()
-           - (_dt * (kv + nN * ke) + kd) * getVelocities()
-           - getMass() * getPartialAccelerations()
-           - mB;
-  for (std::size_t i = 0; i < getNumConnectedPointMasses(); ++i)
-  {
-    const State& i_state = getConnectedPointMass(i)->getState();
-    mAlpha += ke * (i_state.mPositions + _dt * i_state.mVelocities);
-  }
-  assert(!math::isNan(mAlpha));
-
-  // Cache data: beta
-  mBeta = mB;
-  mBeta.noalias() += getMass() * (getPartialAccelerations() + getImplicitPsi() * mAlpha);
-  assert(!math::isNan(mBeta));
-}
-
-//==============================================================================
-void PointMass::updateAccelerationFD()
-{
-  // ddq = imp_psi*(alpha - m*(dw(parent) x mX + dv(parent))
-  const Eigen::Vector3s& X = getLocalPosition();
-  const Eigen::Vector6s& a_parent = mParentSoftBodyNode->getSpatialAcceleration();
-  Eigen::Vector3s ddq =
-      getImplicitPsi()
-      * (mAlpha - getMass() * (a_parent.head<3>().cross(X) + a_parent.tail<3>()));
-  setAccelerations(ddq);
-  assert(!math::isNan(ddq));
-
-  // dv = dw(parent) x mX + dv(parent) + eata + ddq
-  mA = a_parent.head<3>().cross(X) + a_parent.tail<3>()
-       + getPartialAccelerations() + getAccelerations();
-  assert(!math::isNan(mA));
-}
-
-//==============================================================================
-void PointMass::updateTransmittedForce()
-{
-  // f = m*dv + B
-  mF = mB;
-  mF.noalias() += getMass() * getBodyAcceleration();
-  assert(!math::isNan(mF));
-}
-
 //==============================================================================
 void PointMass::updateMassMatrix()
 {
@@ -890,76 +711,6 @@ void PointMass::updateMassMatrix()
   assert(!math::isNan(mM_dV));
 }
 
-//==============================================================================
-void PointMass::updateBiasImpulseFD()
-{
-  mImpB = -mConstraintImpulses;
-  assert(!math::isNan(mImpB));
-
-  // Cache data: alpha
-  mImpAlpha = -mImpB;
-  assert(!math::isNan(mImpAlpha));
-
-  // Cache data: beta
-  mImpBeta.setZero();
-  assert(!math::isNan(mImpBeta));
-}
-
-//==============================================================================
-void PointMass::updateVelocityChangeFD()
-{
-  //  Eigen::Vector3s del_dq
-  //      = mPsi
-  //        * (mImpAlpha - mMass
-  //           * (mParentSoftBodyNode->getBodyVelocityChange().head<3>().cross(mX)
-  //              + mParentSoftBodyNode->getBodyVelocityChange().tail<3>()));
-
-  const Eigen::Vector3s& X = getLocalPosition();
-  Eigen::Vector3s del_dq
-      = getPsi() * mImpAlpha
-        - mParentSoftBodyNode->getBodyVelocityChange().head<3>().cross(X)
-        - mParentSoftBodyNode->getBodyVelocityChange().tail<3>();
-
-  //  del_dq = Eigen::Vector3s::Zero();
-
-  mVelocityChanges = del_dq;
-  assert(!math::isNan(del_dq));
-
-  mDelV = mParentSoftBodyNode->getBodyVelocityChange().head<3>().cross(X)
-          + mParentSoftBodyNode->getBodyVelocityChange().tail<3>()
-          + mVelocityChanges;
-  assert(!math::isNan(mDelV));
-}
-
-
-//==============================================================================
-void PointMass::updateTransmittedImpulse()
-{
-  mImpF = mImpB;
-  mImpF.noalias() += getMass() * mDelV;
-  assert(!math::isNan(mImpF));
-}
-
-//==============================================================================
-void PointMass::updateConstrainedTermsFD(s_t _timeStep)
-{
-  // 1. dq = dq + del_dq
-  setVelocities( getVelocities() + mVelocityChanges );
-
-  // 2. ddq = ddq + del_dq / dt
-  setAccelerations( getAccelerations() + mVelocityChanges / _timeStep );
-
-  // 3. tau = tau + imp / dt
-  getState().mForces.noalias() += mConstraintImpulses / _timeStep;
-
-  ///
-//  mA += mDelV / _timeStep;
-  setAccelerations( getAccelerations() + mDelV / _timeStep );
-
-  ///
-  mF += _timeStep * mImpF;
-}
-
 //==============================================================================
 void PointMass::aggregateMassMatrix(MatrixXs& /*_MCol*/, int /*_col*/)
 {
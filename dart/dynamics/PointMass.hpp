@@ -268,7 +268,7 @@ public:
   const Eigen::Vector3s& getAccelerations() const;
 
   /// Get the Eta term of this PointMass
-  const Eigen::Vector3s& getPartialAccelerations() const;
+  Eigen::Vector3s getPartialAccelerations() const;
 
   // Documentation inherited
   void resetAccelerations();
@@ -366,17 +366,17 @@ public:
   const Eigen::Vector3s& getRestingPosition() const;
 
   ///
-  const Eigen::Vector3s& getLocalPosition() const;
+  Eigen::Vector3s getLocalPosition() const;
 
   ///
-  const Eigen::Vector3s& getWorldPosition() const;
+  Eigen::Vector3s getWorldPosition() const;
 
   /// \todo Temporary function.
   Eigen::Matrix<s_t, 3, Eigen::Dynamic> getBodyJacobian();
   Eigen::Matrix<s_t, 3, Eigen::Dynamic> getWorldJacobian();
 
   /// Return velocity change due to impulse
-  const Eigen::Vector3s& getBodyVelocityChange() const;
+  Eigen::Vector3s getBodyVelocityChange() const;
 
   ///
   SoftBodyNode* getParentSoftBodyNode();
@@ -394,7 +394,7 @@ public:
 
   /// Get the generalized velocity at the position of this point mass
   ///        where the velocity is expressed in the parent soft body node frame.
-  const Eigen::Vector3s& getBodyVelocity() const;
+  Eigen::Vector3s getBodyVelocity() const;
 
   /// Get the generalized velocity at the position of this point mass
   ///        where the velocity is expressed in the world frame.
@@ -403,7 +403,7 @@ public:
   /// Get the generalized acceleration at the position of this point mass
   ///        where the acceleration is expressed in the parent soft body node
   ///        frame.
-  const Eigen::Vector3s& getBodyAcceleration() const;
+  Eigen::Vector3s getBodyAcceleration() const;
 
   /// Get the generalized acceleration at the position of this point mass
   ///        where the acceleration is expressed in the world frame.
@@ -416,64 +416,6 @@ protected:
   ///
   void init();
 
-  //----------------------------------------------------------------------------
-  /// \{ \name Recursive dynamics routines
-  //----------------------------------------------------------------------------
-
-  /// \brief Update transformation.
-  void updateTransform() const;
-
-  /// \brief Update body velocity.
-  void updateVelocity() const;
-
-  /// \brief Update partial body acceleration due to parent joint's velocity.
-  void updatePartialAcceleration() const;
-
-  /// \brief Update articulated body inertia. Forward dynamics routine.
-  /// \param[in] _timeStep Rquired for implicit joint stiffness and damping.
-  void updateArtInertiaFD(s_t _timeStep) const;
-
-  /// \brief Update bias force associated with the articulated body inertia.
-  /// Forward dynamics routine.
-  /// \param[in] _dt Required for implicit joint stiffness and damping.
-  /// \param[in] _gravity Vector of gravitational acceleration
-  void updateBiasForceFD(s_t _dt, const Eigen::Vector3s& _gravity);
-
-  /// \brief Update bias impulse associated with the articulated body inertia.
-  /// Impulse-based forward dynamics routine.
-  void updateBiasImpulseFD();
-
-  /// \brief Update body acceleration with the partial body acceleration.
-  void updateAccelerationID() const;
-
-  /// \brief Update body acceleration. Forward dynamics routine.
-  void updateAccelerationFD();
-
-  /// \brief Update body velocity change. Impluse-based forward dynamics
-  /// routine.
-  void updateVelocityChangeFD();
-
-  /// \brief Update body force. Inverse dynamics routine.
-  void updateTransmittedForceID(const Eigen::Vector3s& _gravity,
-                                bool _withExternalForces = false);
-
-  /// \brief Update body force. Forward dynamics routine.
-  void updateTransmittedForce();
-
-  /// \brief Update body force. Impulse-based forward dynamics routine.
-  void updateTransmittedImpulse();
-
-  /// \brief Update the joint force. Inverse dynamics routine.
-  void updateJointForceID(s_t _timeStep,
-                          s_t _withDampingForces,
-                          s_t _withSpringForces);
-
-  /// \brief Update constrained terms due to the constraint impulses. Foward
-  /// dynamics routine.
-  void updateConstrainedTermsFD(s_t _timeStep);
-
-  /// \}
-
   //----------------------------------------------------------------------------
   /// \{ \name Equations of motion related routines
   //----------------------------------------------------------------------------
@@ -580,86 +522,12 @@ protected:
   /// Derivatives w.r.t. an arbitrary scalr variable
   Eigen::Vector3s mForcesDeriv;
 
-  //----------------------------------------------------------------------------
-  // Impulse
-  //----------------------------------------------------------------------------
-
-  /// Change of generalized velocity
-  Eigen::Vector3s mVelocityChanges;
-
-//  /// Generalized impulse
-//  Eigen::Vector3s mImpulse;
-
-  /// Generalized constraint impulse
-  Eigen::Vector3s mConstraintImpulses;
-
-  //----------------------------------------------------------------------------
-
-  /// Current position viewed in world frame.
-  mutable Eigen::Vector3s mW;
-
-  /// Current position viewed in parent soft body node frame.
-  mutable Eigen::Vector3s mX;
-
-  /// Current velocity viewed in parent soft body node frame.
-  mutable Eigen::Vector3s mV;
-
-  /// Partial Acceleration of this PointMass
-  mutable Eigen::Vector3s mEta;
-
-  ///
-  Eigen::Vector3s mAlpha;
-
-  ///
-  Eigen::Vector3s mBeta;
-
-  /// Current acceleration viewed in parent body node frame.
-  mutable Eigen::Vector3s mA;
-
-  ///
-  Eigen::Vector3s mF;
-
-  ///
-  mutable s_t mPsi;
-
-  ///
-  mutable s_t mImplicitPsi;
-
-  ///
-  mutable s_t mPi;
-
-  ///
-  mutable s_t mImplicitPi;
-
-  /// Bias force
-  Eigen::Vector3s mB;
-
-  /// External force.
-  Eigen::Vector3s mFext;
-
   /// A increasingly sorted list of dependent dof indices.
   std::vector<std::size_t> mDependentGenCoordIndices;
 
   /// Whether the node is currently in collision with another node.
   bool mIsColliding;
 
-  //------------------------- Impulse-based Dyanmics ---------------------------
-  /// Velocity change due to constraint impulse
-  Eigen::Vector3s mDelV;
-
-  /// Impulsive bias force due to external impulsive force exerted on
-  ///        bodies of the parent skeleton.
-  Eigen::Vector3s mImpB;
-
-  /// Cache data for mImpB
-  Eigen::Vector3s mImpAlpha;
-
-  /// Cache data for mImpB
-  Eigen::Vector3s mImpBeta;
-
-  /// Generalized impulsive body force w.r.t. body frame.
-  Eigen::Vector3s mImpF;
-
   PointMassNotifier* mNotifier;
 };
 
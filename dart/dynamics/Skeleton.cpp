@@ -3220,10 +3220,7 @@ void Skeleton::integratePositions(s_t _dt)
     mSkelCache.mBodyNodes[i]->getParentJoint()->integratePositions(_dt);
 
   for (std::size_t i = 0; i < mSoftBodyNodes.size(); ++i)
-  {
-    for (std::size_t j = 0; j < mSoftBodyNodes[i]->getNumPointMasses(); ++j)
-      mSoftBodyNodes[i]->getPointMass(j)->integratePositions(_dt);
-  }
+    mSoftBodyNodes[i]->integratePointMassPositions(_dt);
 }
 
 //==============================================================================
@@ -3290,10 +3287,7 @@ void Skeleton::integrateVelocities(s_t _dt)
     mSkelCache.mBodyNodes[i]->getParentJoint()->integrateVelocities(_dt);
 
   for (std::size_t i = 0; i < mSoftBodyNodes.size(); ++i)
-  {
-    for (std::size_t j = 0; j < mSoftBodyNodes[i]->getNumPointMasses(); ++j)
-      mSoftBodyNodes[i]->getPointMass(j)->integrateVelocities(_dt);
-  }
+    mSoftBodyNodes[i]->integratePointMassVelocities(_dt);
 }
 
 //==============================================================================
@@ -3707,6 +3701,52 @@ s_t Skeleton::MultipleContactInverseDynamicsOverTimeResult::
   return loss;
 }
 
+//==============================================================================
+/// This solves a symmetric block-tridiagonal system with a block LU (Thomas)
+/// sweep. `diag[i]` are the diagonal blocks, and `offDiag[i]` is the block
+/// coupling unknown block i to block i + 1 (its transpose couples i + 1 to i).
+/// For T blocks of size n this is O(T * n^3), rather than O((T * n)^3) for a
+/// dense factorization of the whole system.
+static std::vector<Eigen::VectorXs> solveBlockTridiagonal(
+    const std::vector<Eigen::MatrixXs>& diag,
+    const std::vector<Eigen::MatrixXs>& offDiag,
+    const std::vector<Eigen::VectorXs>& rhs)
+{
+  int blocks = diag.size();
+  assert(offDiag.size() + 1 == diag.size() || diag.size() == 0);
+  assert(rhs.size() == diag.size());
+
+  // Forward elimination. For each block we keep w_i = S_i^{-1} y_i and
+  // X_{i+1} = S_i^{-1} U_i, where S_i is the running Schur complement, which is
+  // everything the back substitution needs.
+  std::vector<Eigen::VectorXs> w(blocks);
+  std::vector<Eigen::MatrixXs> X(blocks);
+  Eigen::MatrixXs schur = blocks > 0 ? diag[0] : Eigen::MatrixXs();
+  Eigen::VectorXs y = blocks > 0 ? rhs[0] : Eigen::VectorXs();
+  for (int i = 0; i < blocks; i++)
+  {
+    // KKT blocks are indefinite, so use a pivoting factorization
+    Eigen::FullPivLU<Eigen::MatrixXs> lu(schur);
+    w[i] = lu.solve(y);
+    if (i + 1 < blocks)
+    {
+      X[i + 1] = lu.solve(offDiag[i]);
+      schur = diag[i + 1] - offDiag[i].transpose() * X[i + 1];
+      y = rhs[i + 1] - offDiag[i].transpose() * w[i];
+    }
+  }
+
+  // Back substitution
+  std::vector<Eigen::VectorXs> solution(blocks);
+  for (int i = blocks - 1; i >= 0; i--)
+  {
+    solution[i] = w[i];
+    if (i + 1 < blocks)
+      solution[i] -= X[i + 1] * solution[i + 1];
+  }
+  return solution;
+}
+
 //==============================================================================
 /// This sets up and solves a QP that tracks multiple contacts over a
 /// time-series of positions. This has two blending factors to control the
@@ -3741,9 +3781,18 @@ Skeleton::getMultipleContactInverseDynamicsOverTime(
 
   int timesteps = positions.cols() - 2;
   result.timesteps = timesteps;
-  Eigen::MatrixXs B = Eigen::MatrixXs::Zero(fDim * timesteps, fDim * timesteps);
-  Eigen::MatrixXs A = Eigen::MatrixXs::Zero(6 * timesteps, fDim * timesteps);
-  Eigen::VectorXs c = Eigen::VectorXs::Zero(6 * timesteps);
+
+  // The smoothing term only couples adjacent timesteps, and the root
+  // dynamics constraints only touch the forces at their own timestep. So if we
+  // order the KKT unknowns by timestep, as [f_i; lambda_i], the KKT matrix is
+  // block-tridiagonal, and we can solve it in time linear in `timesteps`.
+  int blockDim = fDim + 6;
+  std::vector<Eigen::MatrixXs> kktDiag;
+  std::vector<Eigen::MatrixXs> kktOffDiag;
+  std::vector<Eigen::VectorXs> kktVector;
+  kktDiag.reserve(timesteps);
+  kktOffDiag.reserve(timesteps);
+  kktVector.reserve(timesteps);
 
   result.positions = Eigen::MatrixXs::Zero(dofs, timesteps);
   result.velocities = Eigen::MatrixXs::Zero(dofs, timesteps);
@@ -3762,21 +3811,30 @@ Skeleton::getMultipleContactInverseDynamicsOverTime(
     torqueStamp(j * 6 + 5, j * 6 + 5) = eps;
   }
 
-  B.block(0, 0, fDim, fDim)
-      += prevContactWeight * Eigen::MatrixXs::Identity(fDim, fDim);
   for (int i = 0; i < timesteps; i++)
   {
-    B.block(fDim * i, fDim * i, fDim, fDim) += minTorqueWeight * torqueStamp;
-    if (i + 1 < timesteps)
+    Eigen::MatrixXs diag = Eigen::MatrixXs::Zero(blockDim, blockDim);
+    Eigen::VectorXs rhs = Eigen::VectorXs::Zero(blockDim);
+
+    diag.block(0, 0, fDim, fDim) += minTorqueWeight * torqueStamp;
+    if (i == 0)
     {
-      B.block(fDim * i, fDim * i, fDim, fDim)
+      diag.block(0, 0, fDim, fDim)
+          += prevContactWeight * Eigen::MatrixXs::Identity(fDim, fDim);
+    }
+    if (i > 0)
+    {
+      diag.block(0, 0, fDim, fDim)
           += smoothingWeight * Eigen::MatrixXs::Identity(fDim, fDim);
-      B.block(fDim * (i + 1), fDim * i, fDim, fDim)
-          -= smoothingWeight * Eigen::MatrixXs::Identity(fDim, fDim);
-      B.block(fDim * i, fDim * (i + 1), fDim, fDim)
-          -= smoothingWeight * Eigen::MatrixXs::Identity(fDim, fDim);
-      B.block(fDim * (i + 1), fDim * (i + 1), fDim, fDim)
+    }
+    if (i + 1 < timesteps)
+    {
+      diag.block(0, 0, fDim, fDim)
           += smoothingWeight * Eigen::MatrixXs::Identity(fDim, fDim);
+      Eigen::MatrixXs offDiag = Eigen::MatrixXs::Zero(blockDim, blockDim);
+      offDiag.block(0, 0, fDim, fDim)
+          = -smoothingWeight * Eigen::MatrixXs::Identity(fDim, fDim);
+      kktOffDiag.push_back(offDiag);
     }
 
     Eigen::VectorXs vel
@@ -3803,39 +3861,34 @@ Skeleton::getMultipleContactInverseDynamicsOverTime(
     }
     timestepJacs.push_back(jacs);
 
-    A.block(6 * i, fDim * i, 6, fDim) = jacs.block(0, 0, fDim, 6).transpose();
+    diag.block(fDim, 0, 6, fDim) = jacs.block(0, 0, fDim, 6).transpose();
+    diag.block(0, fDim, fDim, 6) = jacs.block(0, 0, fDim, 6);
 
     Eigen::VectorXs jointTorques
         = (multiplyByImplicitMassMatrix(accel) + getCoriolisAndGravityForces()
            - getExternalForces());
     timestepJointTorques.push_back(jointTorques);
-    c.segment<6>(6 * i) = jointTorques.head<6>();
-  }
+    rhs.segment<6>(fDim) = jointTorques.head<6>();
 
-  // We now have B, b, A, and c, so build the KKT matrix
+    kktDiag.push_back(diag);
+    kktVector.push_back(rhs);
+  }
 
-  Eigen::MatrixXs kktMatrix
-      = Eigen::MatrixXs::Zero(B.rows() + A.rows(), B.rows() + A.rows());
-  kktMatrix.block(0, 0, B.rows(), B.cols()) = B;
-  kktMatrix.block(B.rows(), 0, A.rows(), A.cols()) = A;
-  kktMatrix.block(0, B.cols(), A.cols(), A.rows()) = A.transpose();
-  Eigen::VectorXs kktVector
-      = Eigen::VectorXs::Zero(fDim * timesteps + c.size());
   if (prevContactWeight > 0)
   {
     result.prevContactForces = prevContactForces;
     assert(prevContactForces.size() == bodies.size());
     for (int i = 0; i < bodies.size(); i++)
     {
-      kktVector.segment<6>(i * 6)
+      kktVector[0].segment<6>(i * 6)
           = -2 * prevContactWeight * prevContactForces[i];
     }
   }
-  kktVector.segment(fDim * timesteps, c.size()) = c;
 
   // Now factor and solve:
 
-  Eigen::VectorXs kktSolution = kktMatrix.householderQr().solve(kktVector);
+  std::vector<Eigen::VectorXs> kktSolution
+      = solveBlockTridiagonal(kktDiag, kktOffDiag, kktVector);
 
   // And we can read the solution off of the result:
   for (int i = 0; i < timesteps; i++)
@@ -3843,13 +3896,12 @@ Skeleton::getMultipleContactInverseDynamicsOverTime(
     std::vector<Eigen::Vector6s> timestepContactWrenches;
     for (int j = 0; j < bodies.size(); j++)
     {
-      timestepContactWrenches.push_back(
-          kktSolution.segment<6>(i * fDim + j * 6));
+      timestepContactWrenches.push_back(kktSolution[i].segment<6>(j * 6));
     }
     result.contactWrenches.push_back(timestepContactWrenches);
 
     Eigen::VectorXs contactTorques
-        = timestepJacs[i].transpose() * kktSolution.segment(i * fDim, fDim);
+        = timestepJacs[i].transpose() * kktSolution[i].head(fDim);
     result.jointTorques.col(i) = timestepJointTorques[i] - contactTorques;
     result.jointTorques.col(i).head<6>().setZero();
   }
@@ -3998,50 +4050,70 @@ math::Jacobian variadicGetWorldJacobian(
 math::Jacobian Skeleton::getWorldPositionJacobian(
     const JacobianNode* _node) const
 {
-  math::Jacobian J = math::Jacobian::Zero(6, getNumDofs());
-
   if (!isValidBodyNode(this, _node, "getWorldJacobian"))
-    return J;
+    return math::Jacobian::Zero(6, getNumDofs());
+
+  updateWorldPositionScrews();
 
   const BodyNode* bodyNode = static_cast<const BodyNode*>(_node);
+  std::size_t index = bodyNode->getIndexInSkeleton();
+  math::Jacobian& J = mSkelCache.mWorldPositionJacobians[index];
+  if (mSkelCache.mWorldPositionJacobianValid[index])
+    return J;
+
+  J = math::Jacobian::Zero(6, getNumDofs());
   Eigen::Vector3s originalRotation
       = math::logMap(bodyNode->getWorldTransform().linear());
+  Eigen::Vector3s translation = bodyNode->getWorldTransform().translation();
 
-  for (int i = 0; i < getNumDofs(); i++)
+  // Only the dofs above this node move it, the rest of J stays zero
+  for (std::size_t i : bodyNode->getDependentGenCoordIndices())
   {
-    const DegreeOfFreedom* dof = getDof(i);
-    const Joint* joint = dof->getJoint();
+    Eigen::Vector6s screw = mSkelCache.mWorldPositionScrews.col(i);
+    screw.tail<3>() += screw.head<3>().cross(translation);
+    // This is key so we get an actual gradient of the angle (as a screw),
+    // rather than just a screw representing a rotation.
+    screw.head<3>()
+        = math::expMapNestedGradient(originalRotation, screw.head<3>());
+    J.col(i) = screw;
+  }
+  mSkelCache.mWorldPositionJacobianValid[index] = true;
 
-    bool isParent = false;
-    const BodyNode* cursor = bodyNode;
-    while (cursor != nullptr)
-    {
-      if (cursor->getParentJoint() == joint)
-      {
-        isParent = true;
-        break;
-      }
-      if (cursor->getParentJoint() != nullptr)
-      {
-        cursor = cursor->getParentJoint()->getParentBodyNode();
-      }
-    }
+  return J;
+}
 
-    if (isParent)
+//==============================================================================
+Eigen::MatrixXs Skeleton::getWorldPositionJacobians(
+    const std::vector<const BodyNode*>& _nodes) const
+{
+  Eigen::MatrixXs J = Eigen::MatrixXs::Zero(6 * _nodes.size(), getNumDofs());
+  for (std::size_t i = 0; i < _nodes.size(); i++)
+  {
+    J.block(6 * i, 0, 6, J.cols()) = getWorldPositionJacobian(_nodes[i]);
+  }
+  return J;
+}
+
+//==============================================================================
+Eigen::MatrixXs Skeleton::getWorldJacobians(
+    const std::vector<const BodyNode*>& _nodes) const
+{
+  Eigen::MatrixXs J = Eigen::MatrixXs::Zero(6 * _nodes.size(), getNumDofs());
+  for (std::size_t i = 0; i < _nodes.size(); i++)
+  {
+    if (!isValidBodyNode(this, _nodes[i], "getWorldJacobians"))
+      continue;
+
+    // Each BodyNode already caches its own world Jacobian, which it builds
+    // from its parent's, so we only need to scatter the dependent columns
+    const math::Jacobian& JBodyNode = _nodes[i]->getWorldJacobian();
+    const std::vector<std::size_t>& dofs
+        = _nodes[i]->getDependentGenCoordIndices();
+    for (std::size_t j = 0; j < dofs.size(); j++)
     {
-      Eigen::Vector6s screw
-          = joint->getWorldAxisScrewForPosition(dof->getIndexInJoint());
-      screw.tail<3>()
-          += screw.head<3>().cross(bodyNode->getWorldTransform().translation());
-      // This is key so we get an actual gradient of the angle (as a screw),
-      // rather than just a screw representing a rotation.
-      screw.head<3>()
-          = math::expMapNestedGradient(originalRotation, screw.head<3>());
-      J.col(i) = screw;
+      J.block<6, 1>(6 * i, dofs[j]) = JBodyNode.col(j);
     }
-    // else leave J.col(i) as zeros
   }
-
   return J;
 }
 
@@ -4525,7 +4597,8 @@ Eigen::VectorXs Skeleton::multiplyByImplicitMassMatrix(Eigen::VectorXs x)
 //==============================================================================
 Eigen::VectorXs Skeleton::multiplyByImplicitInvMassMatrix(Eigen::VectorXs x)
 {
-  // The trick here is to treat x as delta force, and measure delta acceleration
+  // Where we can, this reuses the LTDL factorization of M. Otherwise, the
+  // trick is to treat x as delta force, and measure delta acceleration
 
   std::size_t dof = mSkelCache.mDofs.size();
   assert(
@@ -4536,6 +4609,34 @@ Eigen::VectorXs Skeleton::multiplyByImplicitInvMassMatrix(Eigen::VectorXs x)
     return x;
   }
 
+  // We don't need to set this to 0 if the below is correct
+  Eigen::VectorXs finalResult = Eigen::VectorXs(dof);
+
+  // Trees that we can't solve with the mass matrix factorization go through
+  // the articulated body algorithm instead
+  std::vector<std::size_t> articulatedTrees;
+  for (std::size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  {
+    const std::vector<DegreeOfFreedom*>& treeDofs = mTreeCache[tree].mDofs;
+    std::size_t nTreeDofs = treeDofs.size();
+    if (nTreeDofs == 0)
+      continue;
+    if (!canUseMassMatrixFactor(tree))
+    {
+      articulatedTrees.push_back(tree);
+      continue;
+    }
+
+    Eigen::VectorXs treeX(nTreeDofs);
+    for (std::size_t i = 0; i < nTreeDofs; ++i)
+      treeX(i) = x(treeDofs[i]->getIndexInSkeleton());
+    solveWithMassMatrixFactor(tree, treeX);
+    for (std::size_t i = 0; i < nTreeDofs; ++i)
+      finalResult(treeDofs[i]->getIndexInSkeleton()) = treeX(i);
+  }
+  if (articulatedTrees.empty())
+    return finalResult;
+
   // Backup the origianl internal force
   Eigen::VectorXs originalInternalForce = getControlForces();
 
@@ -4543,17 +4644,9 @@ Eigen::VectorXs Skeleton::multiplyByImplicitInvMassMatrix(Eigen::VectorXs x)
   // through Featherstone
   setControlForces(x);
 
-  // We don't need to set this to 0 if the below is correct
-  Eigen::VectorXs finalResult = Eigen::VectorXs(dof);
-
-  for (std::size_t tree = 0; tree < mTreeCache.size(); ++tree)
+  for (std::size_t tree : articulatedTrees)
   {
     DataCache& cache = mTreeCache[tree];
-    std::size_t dof = cache.mDofs.size();
-    if (dof == 0)
-    {
-      continue;
-    }
 
     // Prepare cache data
     for (std::vector<BodyNode*>::const_reverse_iterator it
@@ -5322,6 +5415,8 @@ void Skeleton::updateCacheDimensions(Skeleton::DataCache& _cache)
   _cache.mAugM = Eigen::MatrixXs::Zero(dof, dof);
   _cache.mInvM = Eigen::MatrixXs::Zero(dof, dof);
   _cache.mInvAugM = Eigen::MatrixXs::Zero(dof, dof);
+  _cache.mMassFactor = Eigen::MatrixXs::Zero(dof, dof);
+  _cache.mDofParents.assign(dof, -1);
   _cache.mCvec = Eigen::VectorXs::Zero(dof);
   _cache.mG = Eigen::VectorXs::Zero(dof);
   _cache.mCg = Eigen::VectorXs::Zero(dof);
@@ -5334,10 +5429,38 @@ void Skeleton::updateCacheDimensions(std::size_t _treeIdx)
 {
   updateCacheDimensions(mTreeCache[_treeIdx]);
   updateCacheDimensions(mSkelCache);
+  SET_FLAG(_treeIdx, mWorldPositionJacobians);
 
   dirtyArticulatedInertia(_treeIdx);
 }
 
+//==============================================================================
+void Skeleton::updateWorldPositionScrews() const
+{
+  if (!mSkelCache.mDirty.mWorldPositionJacobians)
+    return;
+
+  // Bring every transform up to date first. Otherwise a BodyNode that was
+  // already dirty wouldn't flag us again the next time it moves.
+  for (const BodyNode* bodyNode : mSkelCache.mBodyNodes)
+    bodyNode->getWorldTransform();
+
+  std::size_t numDofs = getNumDofs();
+  mSkelCache.mWorldPositionScrews.resize(6, numDofs);
+  for (std::size_t i = 0; i < numDofs; i++)
+  {
+    const DegreeOfFreedom* dof = getDof(i);
+    mSkelCache.mWorldPositionScrews.col(i)
+        = dof->getJoint()->getWorldAxisScrewForPosition(dof->getIndexInJoint());
+  }
+
+  std::size_t numBodyNodes = getNumBodyNodes();
+  mSkelCache.mWorldPositionJacobians.resize(numBodyNodes);
+  mSkelCache.mWorldPositionJacobianValid.assign(numBodyNodes, false);
+
+  mSkelCache.mDirty.mWorldPositionJacobians = false;
+}
+
 //==============================================================================
 void Skeleton::updateArticulatedInertia(std::size_t _tree) const
 {
@@ -5382,6 +5505,79 @@ void Skeleton::updateMassMatrix(std::size_t _treeIdx) const
 
   cache.mM.setZero();
 
+  if (mSoftBodyNodes.empty())
+  {
+    const std::size_t numBodies = cache.mBodyNodes.size();
+
+    // The transpose of each body's motion transform to its parent. This maps
+    // spatial forces (and, on both sides, inertias) into the parent frame.
+    common::aligned_vector<Eigen::Matrix6s> toParent(numBodies);
+    // Composite rigid body inertias, in each body's own frame
+    common::aligned_vector<Eigen::Matrix6s> composite(numBodies);
+    for (std::size_t i = 0; i < numBodies; ++i)
+    {
+      const BodyNode* body = cache.mBodyNodes[i];
+      const Eigen::Isometry3s& T = body->getParentJoint()->getRelativeTransform();
+      toParent[i] = math::getAdTMatrix(T.inverse()).transpose();
+      composite[i] = body->getSpatialInertia();
+    }
+
+    // Accumulate composite inertias from the leaves in. Parents always come
+    // before their children in mBodyNodes.
+    for (std::size_t i = numBodies; i-- > 0;)
+    {
+      const BodyNode* parent = cache.mBodyNodes[i]->getParentBodyNode();
+      if (parent != nullptr)
+      {
+        composite[parent->getIndexInTree()]
+            += toParent[i] * composite[i] * toParent[i].transpose();
+      }
+    }
+
+    // Each joint's block column comes from walking the force its motion
+    // subspace needs up to the root, projecting onto every ancestor joint
+    Eigen::Matrix<s_t, 6, Eigen::Dynamic> force;
+    for (std::size_t i = 0; i < numBodies; ++i)
+    {
+      const BodyNode* body = cache.mBodyNodes[i];
+      const Joint* joint = body->getParentJoint();
+      const std::size_t localDof = joint->getNumDofs();
+      if (localDof == 0)
+        continue;
+      const std::size_t iStart = joint->getIndexInTree(0);
+      const math::Jacobian S = joint->getRelativeJacobian();
+
+      force.noalias() = composite[i] * S;
+      cache.mM.block(iStart, iStart, localDof, localDof).noalias()
+          = S.transpose() * force;
+
+      std::size_t child = i;
+      const BodyNode* ancestor = body->getParentBodyNode();
+      while (ancestor != nullptr)
+      {
+        force = toParent[child] * force;
+        child = ancestor->getIndexInTree();
+
+        const Joint* ancestorJoint = ancestor->getParentJoint();
+        const std::size_t ancestorDof = ancestorJoint->getNumDofs();
+        if (ancestorDof > 0)
+        {
+          const std::size_t jStart = ancestorJoint->getIndexInTree(0);
+          cache.mM.block(iStart, jStart, localDof, ancestorDof).noalias()
+              = force.transpose() * ancestorJoint->getRelativeJacobian();
+        }
+        ancestor = ancestor->getParentBodyNode();
+      }
+    }
+    cache.mM.triangularView<Eigen::StrictlyUpper>() = cache.mM.transpose();
+
+    cache.mDirty.mMassMatrix = false;
+    return;
+  }
+
+  // Soft bodies carry point masses that aren't part of their spatial inertia,
+  // so we measure M one column at a time through the recursive dynamics
+
   // Backup the original internal force
   Eigen::VectorXs originalGenAcceleration = getAccelerations();
 
@@ -5581,6 +5777,14 @@ void Skeleton::updateInvMassMatrix(std::size_t _treeIdx) const
     return;
   }
 
+  if (canUseMassMatrixFactor(_treeIdx))
+  {
+    cache.mInvM.setIdentity();
+    solveWithMassMatrixFactor(_treeIdx, cache.mInvM);
+    cache.mDirty.mInvMassMatrix = false;
+    return;
+  }
+
   // We don't need to set mInvM as zero matrix as long as the below is correct
   // cache.mInvM.setZero();
 
@@ -5668,6 +5872,106 @@ void Skeleton::updateInvMassMatrix() const
   mSkelCache.mDirty.mInvMassMatrix = false;
 }
 
+//==============================================================================
+void Skeleton::updateMassMatrixFactor(std::size_t _treeIdx) const
+{
+  const Eigen::MatrixXs& M = getMassMatrix(_treeIdx);
+  DataCache& cache = mTreeCache[_treeIdx];
+  const int dof = static_cast<int>(cache.mDofs.size());
+
+  // Each dof's parent is the previous dof of the same joint, or else the last
+  // dof of the nearest ancestor joint that has any
+  for (const BodyNode* body : cache.mBodyNodes)
+  {
+    const Joint* joint = body->getParentJoint();
+    const std::size_t localDof = joint->getNumDofs();
+    if (localDof == 0)
+      continue;
+    const int iStart = static_cast<int>(joint->getIndexInTree(0));
+
+    int parent = -1;
+    for (const BodyNode* ancestor = body->getParentBodyNode();
+         ancestor != nullptr;
+         ancestor = ancestor->getParentBodyNode())
+    {
+      const Joint* ancestorJoint = ancestor->getParentJoint();
+      const std::size_t ancestorDof = ancestorJoint->getNumDofs();
+      if (ancestorDof > 0)
+      {
+        parent = static_cast<int>(
+            ancestorJoint->getIndexInTree(ancestorDof - 1));
+        break;
+      }
+    }
+    for (std::size_t k = 0; k < localDof; ++k)
+    {
+      cache.mDofParents[iStart + k] = parent;
+      parent = iStart + static_cast<int>(k);
+    }
+  }
+
+  // Factor M = L^T D L in place, from the leaves in. Only the ancestor chain
+  // of each dof is ever touched, so there's no fill-in.
+  Eigen::MatrixXs& H = cache.mMassFactor;
+  H = M;
+  const std::vector<int>& parents = cache.mDofParents;
+  for (int k = dof - 1; k >= 0; --k)
+  {
+    for (int i = parents[k]; i != -1; i = parents[i])
+    {
+      const s_t a = H(k, i) / H(k, k);
+      for (int j = i; j != -1; j = parents[j])
+        H(i, j) -= a * H(k, j);
+      H(k, i) = a;
+    }
+  }
+
+  cache.mDirty.mMassMatrixFactor = false;
+}
+
+//==============================================================================
+bool Skeleton::canUseMassMatrixFactor(std::size_t _treeIdx) const
+{
+  if (!mSoftBodyNodes.empty())
+    return false;
+  for (const BodyNode* body : mTreeCache[_treeIdx].mBodyNodes)
+  {
+    if (!body->getParentJoint()->isDynamic())
+      return false;
+  }
+  return true;
+}
+
+//==============================================================================
+void Skeleton::solveWithMassMatrixFactor(
+    std::size_t _treeIdx, Eigen::Ref<Eigen::MatrixXs> x) const
+{
+  if (mTreeCache[_treeIdx].mDirty.mMassMatrixFactor)
+    updateMassMatrixFactor(_treeIdx);
+
+  const DataCache& cache = mTreeCache[_treeIdx];
+  const Eigen::MatrixXs& H = cache.mMassFactor;
+  const std::vector<int>& parents = cache.mDofParents;
+  const int dof = static_cast<int>(cache.mDofs.size());
+  assert(x.rows() == dof);
+
+  // x = L^{-T} x
+  for (int i = dof - 1; i >= 0; --i)
+  {
+    for (int j = parents[i]; j != -1; j = parents[j])
+      x.row(j) -= H(i, j) * x.row(i);
+  }
+  // x = D^{-1} x
+  for (int i = 0; i < dof; ++i)
+    x.row(i) /= H(i, i);
+  // x = L^{-1} x
+  for (int i = 0; i < dof; ++i)
+  {
+    for (int j = parents[i]; j != -1; j = parents[j])
+      x.row(i) -= H(i, j) * x.row(j);
+  }
+}
+
 //==============================================================================
 void Skeleton::updateInvAugMassMatrix(std::size_t _treeIdx) const
 {
@@ -6335,6 +6639,7 @@ void Skeleton::dirtyArticulatedInertia(std::size_t _treeIdx)
   SET_FLAG(_treeIdx, mAugMassMatrix);
   SET_FLAG(_treeIdx, mInvMassMatrix);
   SET_FLAG(_treeIdx, mInvAugMassMatrix);
+  SET_FLAG(_treeIdx, mMassMatrixFactor);
   SET_FLAG(_treeIdx, mCoriolisForces);
   SET_FLAG(_treeIdx, mGravityForces);
   SET_FLAG(_treeIdx, mCoriolisAndGravityForces);
@@ -6790,6 +7095,7 @@ Skeleton::DirtyFlags::DirtyFlags()
     mAugMassMatrix(true),
     mInvMassMatrix(true),
     mInvAugMassMatrix(true),
+    mMassMatrixFactor(true),
     mGravityForces(true),
     mCoriolisForces(true),
     mCoriolisAndGravityForces(true),
@@ -6797,6 +7103,7 @@ Skeleton::DirtyFlags::DirtyFlags()
     mDampingForces(true),
     mSupport(true),
     mParentMap(true),
+    mWorldPositionJacobians(true),
     mSupportVersion(0)
 {
   // Do nothing
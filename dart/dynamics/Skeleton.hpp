@@ -1147,9 +1147,22 @@ public:
       const Eigen::Vector3s& _localOffset,
       const Frame* _inCoordinatesOf) const override;
 
-  // Documentation inherited
+  /// This returns the Jacobian of the world position of _node, with the
+  /// rotation expressed in log space. The per-DOF world screws every node's
+  /// Jacobian is built from are computed together, once per configuration, and
+  /// each node's Jacobian is cached until the next change in positions.
   math::Jacobian getWorldPositionJacobian(const JacobianNode* _node) const;
 
+  /// This returns getWorldPositionJacobian() for each of _nodes, stacked
+  /// vertically, 6 rows per node.
+  Eigen::MatrixXs getWorldPositionJacobians(
+      const std::vector<const BodyNode*>& _nodes) const;
+
+  /// This returns getWorldJacobian() for each of _nodes, stacked vertically,
+  /// 6 rows per node.
+  Eigen::MatrixXs getWorldJacobians(
+      const std::vector<const BodyNode*>& _nodes) const;
+
   // Documentation inherited
   math::Jacobian finiteDifferenceWorldPositionJacobian(
       const JacobianNode* _node, bool useRidders = true);
@@ -1528,7 +1541,13 @@ protected:
   /// Update the articulated inertias of the skeleton
   void updateArticulatedInertia() const;
 
-  /// Update the mass matrix of a tree
+  /// Recompute the world screws of every dof, and forget any cached world
+  /// position Jacobians, if the positions have changed since the last time
+  void updateWorldPositionScrews() const;
+
+  /// Update the mass matrix of a tree. For rigid trees this runs the
+  /// composite-rigid-body algorithm, which costs O(n * depth) rather than the
+  /// O(n * bodies) of sweeping a unit acceleration through every column.
   void updateMassMatrix(std::size_t _treeIdx) const;
 
   /// Update mass matrix of the skeleton.
@@ -1545,6 +1564,22 @@ protected:
   /// Update inverse of mass matrix of the skeleton.
   void updateInvMassMatrix() const;
 
+  /// Update the branch-induced sparse LTDL factorization of a tree's mass
+  /// matrix (Featherstone, RBDA section 6.5). Because M only couples a dof to
+  /// its ancestors, L has no fill-in outside the ancestor chains, so factoring
+  /// and solving cost O(n * depth^2) and O(n * depth).
+  void updateMassMatrixFactor(std::size_t _treeIdx) const;
+
+  /// Returns true if M^{-1} for this tree can come from the LTDL
+  /// factorization. That requires rigid bodies (point masses aren't in the
+  /// composite inertias) and dynamic joints (the articulated-body inverse
+  /// treats kinematic joints as rigid, which isn't the inverse of M).
+  bool canUseMassMatrixFactor(std::size_t _treeIdx) const;
+
+  /// Overwrites `x` with M^{-1} x for a tree, using the LTDL factorization
+  void solveWithMassMatrixFactor(
+      std::size_t _treeIdx, Eigen::Ref<Eigen::MatrixXs> x) const;
+
   /// Update the inverse augmented mass matrix of a tree
   void updateInvAugMassMatrix(std::size_t _treeIdx) const;
 
@@ -1631,6 +1666,9 @@ protected:
     /// Dirty flag for the inverse of augmented mass matrix.
     bool mInvAugMassMatrix;
 
+    /// Dirty flag for the LTDL factorization of the mass matrix.
+    bool mMassMatrixFactor;
+
     /// Dirty flag for the gravity force vector.
     bool mGravityForces;
 
@@ -1652,6 +1690,9 @@ protected:
     /// Dirty flag for the parent map
     bool mParentMap;
 
+    /// Dirty flag for the world position Jacobians
+    bool mWorldPositionJacobians;
+
     /// Increments each time a new support polygon is computed to help keep
     /// track of changes in the support polygon
     std::size_t mSupportVersion;
@@ -1685,6 +1726,15 @@ protected:
     /// Inverse of augmented mass matrix for the skeleton.
     Eigen::MatrixXs mInvAugM;
 
+    /// The LTDL factorization of mM, where M = L^T D L. D is stored on the
+    /// diagonal, and the strictly lower triangle holds L (which has a unit
+    /// diagonal). Only entries on the ancestor chains are meaningful.
+    Eigen::MatrixXs mMassFactor;
+
+    /// For each dof in the tree, the index of its nearest ancestor dof, or -1
+    /// if it has none. This is the sparsity pattern of mMassFactor.
+    std::vector<int> mDofParents;
+
     /// Coriolis vector for the skeleton which is C(q,dq)*dq.
     Eigen::VectorXs mCvec;
 
@@ -1721,6 +1771,17 @@ protected:
     /// A map of the parent relationships between dofs in this skeleton.
     Eigen::MatrixXi mParentMap;
 
+    /// The world screw of each dof, in position space, one column per dof.
+    /// Every BodyNode's world position Jacobian is built from these. Only
+    /// used in mSkelCache.
+    Eigen::MatrixXs mWorldPositionScrews;
+
+    /// The world position Jacobian of each BodyNode, by index in the
+    /// Skeleton. Only entries with mWorldPositionJacobianValid set are
+    /// meaningful. Only used in mSkelCache.
+    std::vector<math::Jacobian> mWorldPositionJacobians;
+    std::vector<bool> mWorldPositionJacobianValid;
+
     /// A shared pointer to the saved gradient matrices for the ConstrainedGroup
     /// this skeleton was part of in the last LCP solve.
     std::shared_ptr<neural::ConstrainedGroupGradientMatrices>
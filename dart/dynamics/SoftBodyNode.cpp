@@ -126,6 +126,99 @@ SoftBodyNodeProperties::SoftBodyNodeProperties(
 
 } // namespace detail
 
+namespace {
+
+using PointVectors = Eigen::Matrix<s_t, 3, Eigen::Dynamic>;
+
+//==============================================================================
+/// Copies one field of every PointMass::State into the columns of _vectors
+void gatherStates(
+    const std::vector<PointMass::State>& _states,
+    Eigen::Vector3s PointMass::State::*_field,
+    PointVectors& _vectors)
+{
+  _vectors.resize(3, _states.size());
+  for (std::size_t i = 0; i < _states.size(); ++i)
+    _vectors.col(i) = _states[i].*_field;
+}
+
+//==============================================================================
+/// Copies the columns of _vectors back into one field of every
+/// PointMass::State
+void scatterStates(
+    const PointVectors& _vectors,
+    Eigen::Vector3s PointMass::State::*_field,
+    std::vector<PointMass::State>& _states)
+{
+  assert(static_cast<std::size_t>(_vectors.cols()) == _states.size());
+  for (std::size_t i = 0; i < _states.size(); ++i)
+    _states[i].*_field = _vectors.col(i);
+}
+
+//==============================================================================
+/// Returns w x X.col(i) + v for every point mass, which is the linear part of
+/// the spatial motion (w, v) of the SoftBodyNode at each point mass
+PointVectors getPointMotion(
+    const Eigen::Vector6s& _motion, const PointVectors& _X)
+{
+  PointVectors motion = math::makeSkewSymmetric(_motion.head<3>()) * _X;
+  motion.colwise() += _motion.tail<3>();
+  return motion;
+}
+
+//==============================================================================
+/// Adds the spatial force that the linear forces `_f` on the point masses at
+/// `_X` exert on the SoftBodyNode
+void addPointForces(
+    Eigen::Vector6s& _F, const PointVectors& _X, const PointVectors& _f)
+{
+  // The sum of _X.col(i).cross(_f.col(i))
+  _F[0] += _X.row(1).dot(_f.row(2)) - _X.row(2).dot(_f.row(1));
+  _F[1] += _X.row(2).dot(_f.row(0)) - _X.row(0).dot(_f.row(2));
+  _F[2] += _X.row(0).dot(_f.row(1)) - _X.row(1).dot(_f.row(0));
+  _F.tail<3>() += _f.rowwise().sum();
+}
+
+//==============================================================================
+/// Adds the articulated inertias `_Pi` of the point masses at `_X`. Each point
+/// mass contributes Pi * [-[p]^2, [p]; -[p], I], where [p] is the skew
+/// symmetric matrix of its position p. Since [p]^2 = p * p^T - |p|^2 * I, the
+/// sum over all the point masses only needs a few reductions.
+void addPointArtInertias(
+    Eigen::Matrix6s& _AI, const PointVectors& _X, const Eigen::VectorXs& _Pi)
+{
+  const Eigen::Matrix3s secondMoment = _X * _Pi.asDiagonal() * _X.transpose();
+  const s_t squaredNorms = _X.colwise().squaredNorm().dot(_Pi);
+  const Eigen::Matrix3s firstMoment = math::makeSkewSymmetric(_X * _Pi);
+
+  _AI.topLeftCorner<3, 3>() -= secondMoment;
+  _AI.topLeftCorner<3, 3>().diagonal().array() += squaredNorms;
+  _AI.topRightCorner<3, 3>() += firstMoment;
+  _AI.bottomLeftCorner<3, 3>() -= firstMoment;
+  _AI.bottomRightCorner<3, 3>().diagonal().array() += _Pi.sum();
+}
+
+//==============================================================================
+/// Resizes `_vectors` to hold `_count` point masses, zeroing any new ones
+void resizePoints(PointVectors& _vectors, std::size_t _count)
+{
+  const Eigen::Index oldCount = _vectors.cols();
+  _vectors.conservativeResize(3, _count);
+  if (static_cast<Eigen::Index>(_count) > oldCount)
+    _vectors.rightCols(_count - oldCount).setZero();
+}
+
+//==============================================================================
+void resizePoints(Eigen::VectorXs& _scalars, std::size_t _count)
+{
+  const Eigen::Index oldCount = _scalars.size();
+  _scalars.conservativeResize(_count);
+  if (static_cast<Eigen::Index>(_count) > oldCount)
+    _scalars.tail(_count - oldCount).setZero();
+}
+
+} // namespace
+
 //==============================================================================
 SoftBodyNode::~SoftBodyNode()
 {
@@ -295,6 +388,13 @@ void SoftBodyNode::configurePointMasses(ShapeNode* softNode)
   std::size_t newCount = softProperties.mPointProps.size();
   std::size_t oldCount = mPointMasses.size();
 
+  // Resize the number of States in the Aspect, along with the arrays that the
+  // dynamics routines work on. The masses, resting positions or springs may
+  // have changed even if the number of point masses didn't.
+  mAspectState.mPointStates.resize(newCount, PointMass::State());
+  resizePointMassArrays(newCount);
+  mPointArrays.mNeedConstantsUpdate = true;
+
   if (newCount == oldCount)
     return;
 
@@ -316,10 +416,6 @@ void SoftBodyNode::configurePointMasses(ShapeNode* softNode)
     }
   }
 
-  // Resize the number of States in the Aspect
-  mAspectState.mPointStates.resize(
-      softProperties.mPointProps.size(), PointMass::State());
-
   // Access the SoftMeshShape and reallocate its meshes
   if (softNode)
   {
@@ -527,8 +623,12 @@ void SoftBodyNode::clearConstraintImpulse()
 {
   BodyNode::clearConstraintImpulse();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->clearConstraintImpulse();
+  mPointArrays.mConstraintImpulses.setZero();
+  mPointArrays.mDelV.setZero();
+  mPointArrays.mImpB.setZero();
+  mPointArrays.mImpAlpha.setZero();
+  mPointArrays.mImpBeta.setZero();
+  mPointArrays.mImpF.setZero();
 }
 
 //==============================================================================
@@ -539,13 +639,158 @@ void SoftBodyNode::checkArticulatedInertiaUpdate() const
     skel->updateArticulatedInertia(mTreeIndex);
 }
 
+//==============================================================================
+void SoftBodyNode::updatePointMassConstants() const
+{
+  if (!mPointArrays.mNeedConstantsUpdate)
+    return;
+
+  const std::vector<PointMass::Properties>& props
+      = mAspectProperties.mPointProps;
+  const std::size_t numPoints = props.size();
+
+  mPointArrays.mMasses.resize(numPoints);
+  mPointArrays.mRestingPositions.resize(3, numPoints);
+  mPointArrays.mSpringOffsets.resize(numPoints + 1);
+  mPointArrays.mSpringIndices.clear();
+
+  mPointArrays.mSpringOffsets[0] = 0;
+  for (std::size_t i = 0; i < numPoints; ++i)
+  {
+    mPointArrays.mMasses[i] = props[i].mMass;
+    mPointArrays.mRestingPositions.col(i) = props[i].mX0;
+
+    const std::vector<std::size_t>& connections
+        = props[i].mConnectedPointMassIndices;
+    mPointArrays.mSpringIndices.insert(
+        mPointArrays.mSpringIndices.end(),
+        connections.begin(),
+        connections.end());
+    mPointArrays.mSpringOffsets[i + 1] = mPointArrays.mSpringIndices.size();
+  }
+
+  mPointArrays.mNeedConstantsUpdate = false;
+}
+
+//==============================================================================
+void SoftBodyNode::resizePointMassArrays(std::size_t _count)
+{
+  for (PointMassArrays::Vectors* vectors : {&mPointArrays.mX,
+                                            &mPointArrays.mW,
+                                            &mPointArrays.mV,
+                                            &mPointArrays.mEta,
+                                            &mPointArrays.mA,
+                                            &mPointArrays.mF,
+                                            &mPointArrays.mB,
+                                            &mPointArrays.mFext,
+                                            &mPointArrays.mAlpha,
+                                            &mPointArrays.mBeta,
+                                            &mPointArrays.mConstraintImpulses,
+                                            &mPointArrays.mVelocityChanges,
+                                            &mPointArrays.mDelV,
+                                            &mPointArrays.mImpB,
+                                            &mPointArrays.mImpAlpha,
+                                            &mPointArrays.mImpBeta,
+                                            &mPointArrays.mImpF})
+  {
+    resizePoints(*vectors, _count);
+  }
+
+  for (Eigen::VectorXs* scalars : {&mPointArrays.mPsi,
+                                   &mPointArrays.mImplicitPsi,
+                                   &mPointArrays.mPi,
+                                   &mPointArrays.mImplicitPi})
+  {
+    resizePoints(*scalars, _count);
+  }
+}
+
+//==============================================================================
+const SoftBodyNode::PointMassArrays::Vectors&
+SoftBodyNode::getPointMassLocalPositions() const
+{
+  if (mNotifier->needsTransformUpdate())
+    const_cast<SoftBodyNode*>(this)->updateTransform();
+  return mPointArrays.mX;
+}
+
+//==============================================================================
+const SoftBodyNode::PointMassArrays::Vectors&
+SoftBodyNode::getPointMassBodyVelocities() const
+{
+  if (mNotifier->needsVelocityUpdate())
+    const_cast<SoftBodyNode*>(this)->updateVelocity();
+  return mPointArrays.mV;
+}
+
+//==============================================================================
+const SoftBodyNode::PointMassArrays::Vectors&
+SoftBodyNode::getPointMassPartialAccelerations() const
+{
+  if (mNotifier->needsPartialAccelerationUpdate())
+    updatePartialAcceleration();
+  return mPointArrays.mEta;
+}
+
+//==============================================================================
+const SoftBodyNode::PointMassArrays::Vectors&
+SoftBodyNode::getPointMassBodyAccelerations() const
+{
+  if (mNotifier->needsAccelerationUpdate())
+    const_cast<SoftBodyNode*>(this)->updateAccelerationID();
+  return mPointArrays.mA;
+}
+
+//==============================================================================
+void SoftBodyNode::integratePointMassPositions(s_t _dt)
+{
+  if (mPointMasses.empty())
+    return;
+
+  std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  gatherStates(states, &PointMass::State::mPositions, mPointArrays.mQ);
+  gatherStates(states, &PointMass::State::mVelocities, mPointArrays.mDq);
+  mPointArrays.mQ += mPointArrays.mDq * _dt;
+  scatterStates(mPointArrays.mQ, &PointMass::State::mPositions, states);
+
+  mNotifier->dirtyTransform();
+}
+
+//==============================================================================
+void SoftBodyNode::integratePointMassVelocities(s_t _dt)
+{
+  if (mPointMasses.empty())
+    return;
+
+  std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  gatherStates(states, &PointMass::State::mVelocities, mPointArrays.mDq);
+  gatherStates(states, &PointMass::State::mAccelerations, mPointArrays.mDdq);
+  mPointArrays.mDq += mPointArrays.mDdq * _dt;
+  scatterStates(mPointArrays.mDq, &PointMass::State::mVelocities, states);
+
+  mNotifier->dirtyVelocity();
+}
+
 //==============================================================================
 void SoftBodyNode::updateTransform()
 {
   BodyNode::updateTransform();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateTransform();
+  updatePointMassConstants();
+
+  // Local translation
+  gatherStates(
+      mAspectState.mPointStates,
+      &PointMass::State::mPositions,
+      mPointArrays.mQ);
+  mPointArrays.mX = mPointArrays.mQ + mPointArrays.mRestingPositions;
+  assert(!math::isNan(mPointArrays.mX));
+
+  // World translation
+  const Eigen::Isometry3s& W = getWorldTransform();
+  mPointArrays.mW.noalias() = W.linear() * mPointArrays.mX;
+  mPointArrays.mW.colwise() += W.translation();
+  assert(!math::isNan(mPointArrays.mW));
 
   mNotifier->clearTransformNotice();
 }
@@ -555,8 +800,15 @@ void SoftBodyNode::updateVelocity()
 {
   BodyNode::updateVelocity();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateVelocity();
+  // v = w(parent) x mX + v(parent) + dq
+  gatherStates(
+      mAspectState.mPointStates,
+      &PointMass::State::mVelocities,
+      mPointArrays.mDq);
+  mPointArrays.mV
+      = getPointMotion(getSpatialVelocity(), getPointMassLocalPositions())
+        + mPointArrays.mDq;
+  assert(!math::isNan(mPointArrays.mV));
 
   mNotifier->clearVelocityNotice();
 }
@@ -566,8 +818,15 @@ void SoftBodyNode::updatePartialAcceleration() const
 {
   BodyNode::updatePartialAcceleration();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updatePartialAcceleration();
+  // eta = w(parent) x dq
+  gatherStates(
+      mAspectState.mPointStates,
+      &PointMass::State::mVelocities,
+      mPointArrays.mDq);
+  mPointArrays.mEta.noalias()
+      = math::makeSkewSymmetric(getSpatialVelocity().head<3>())
+        * mPointArrays.mDq;
+  assert(!math::isNan(mPointArrays.mEta));
 
   mNotifier->clearPartialAccelerationNotice();
 }
@@ -577,8 +836,15 @@ void SoftBodyNode::updateAccelerationID()
 {
   BodyNode::updateAccelerationID();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateAccelerationID();
+  // dv = dw(parent) x mX + dv(parent) + eta + ddq
+  gatherStates(
+      mAspectState.mPointStates,
+      &PointMass::State::mAccelerations,
+      mPointArrays.mDdq);
+  mPointArrays.mA
+      = getPointMotion(getSpatialAcceleration(), getPointMassLocalPositions())
+        + getPointMassPartialAccelerations() + mPointArrays.mDdq;
+  assert(!math::isNan(mPointArrays.mA));
 
   mNotifier->clearAccelerationNotice();
 }
@@ -589,15 +855,31 @@ void SoftBodyNode::updateTransmittedForceID(
 {
   const Eigen::Matrix6s& mI
       = BodyNode::mAspectProperties.mInertia.getSpatialTensor();
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateTransmittedForceID(_gravity, _withExternalForces);
+
+  // f = m*dv + w(parent) x m*v - fext - fgravity
+  updatePointMassConstants();
+  const Eigen::VectorXs& masses = mPointArrays.mMasses;
+  mPointArrays.mF.noalias()
+      = getPointMassBodyAccelerations() * masses.asDiagonal();
+  mPointArrays.mF.noalias()
+      += math::makeSkewSymmetric(getSpatialVelocity().head<3>())
+         * (getPointMassBodyVelocities() * masses.asDiagonal());
+  mPointArrays.mF -= mPointArrays.mFext;
 
   // Gravity force
   if (BodyNode::mAspectProperties.mGravityMode == true)
+  {
+    const Eigen::Vector3s localGravity
+        = getWorldTransform().linear().transpose() * _gravity;
+    mPointArrays.mF.noalias() -= localGravity * masses.transpose();
     mFgravity.noalias()
         = mI * math::AdInvRLinear(getWorldTransform(), _gravity);
+  }
   else
+  {
     mFgravity.setZero();
+  }
+  assert(!math::isNan(mPointArrays.mF));
 
   // Inertial force
   mF.noalias() = mI * getSpatialAcceleration();
@@ -625,11 +907,7 @@ void SoftBodyNode::updateTransmittedForceID(
     mF += math::dAdInvT(
         childJoint->getRelativeTransform(), childBodyNode->getBodyForce());
   }
-  for (auto& pointMass : mPointMasses)
-  {
-    mF.head<3>() += pointMass->getLocalPosition().cross(pointMass->mF);
-    mF.tail<3>() += pointMass->mF;
-  }
+  addPointForces(mF, getPointMassLocalPositions(), mPointArrays.mF);
 
   // Verification
   assert(!math::isNan(mF));
@@ -639,9 +917,10 @@ void SoftBodyNode::updateTransmittedForceID(
 void SoftBodyNode::updateJointForceID(
     s_t _timeStep, bool _withDampingForces, bool _withSpringForces)
 {
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->updateJointForceID(
-        _timeStep, _withDampingForces, _withSpringForces);
+  // tau = f
+  // TODO: need to add spring and damping forces
+  scatterStates(
+      mPointArrays.mF, &PointMass::State::mForces, mAspectState.mPointStates);
 
   BodyNode::updateJointForceID(
       _timeStep, _withDampingForces, _withSpringForces);
@@ -666,8 +945,25 @@ void SoftBodyNode::updateArtInertia(s_t _timeStep) const
 {
   const Eigen::Matrix6s& mI
       = BodyNode::mAspectProperties.mInertia.getSpatialTensor();
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateArtInertiaFD(_timeStep);
+
+  // Cache data: Psi and Pi of the point masses
+  updatePointMassConstants();
+  const Eigen::Array<s_t, Eigen::Dynamic, 1> masses
+      = mPointArrays.mMasses.array();
+  mPointArrays.mPsi = masses.inverse().matrix();
+  mPointArrays.mImplicitPsi
+      = (masses + _timeStep * getDampingCoefficient()
+         + _timeStep * _timeStep * getVertexSpringStiffness())
+            .inverse()
+            .matrix();
+  mPointArrays.mPi
+      = (masses - masses * masses * mPointArrays.mPsi.array()).matrix();
+  mPointArrays.mImplicitPi
+      = (masses - masses * masses * mPointArrays.mImplicitPsi.array())
+            .matrix();
+  assert(!math::isNan(mPointArrays.mImplicitPsi));
+  assert(!math::isNan(mPointArrays.mPi));
+  assert(!math::isNan(mPointArrays.mImplicitPi));
 
   assert(mParentJoint != nullptr);
 
@@ -686,12 +982,9 @@ void SoftBodyNode::updateArtInertia(s_t _timeStep) const
   }
 
   //
-  for (const auto& pointMass : mPointMasses)
-  {
-    _addPiToArtInertia(pointMass->getLocalPosition(), pointMass->mPi);
-    _addPiToArtInertiaImplicit(
-        pointMass->getLocalPosition(), pointMass->mImplicitPi);
-  }
+  const PointMassArrays::Vectors& X = getPointMassLocalPositions();
+  addPointArtInertias(mArtInertia, X, mPointArrays.mPi);
+  addPointArtInertias(mArtInertiaImplicit, X, mPointArrays.mImplicitPi);
 
   // Verification
   assert(!math::isNan(mArtInertia));
@@ -712,15 +1005,67 @@ void SoftBodyNode::updateBiasForce(
 {
   const Eigen::Matrix6s& mI
       = BodyNode::mAspectProperties.mInertia.getSpatialTensor();
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateBiasForceFD(_timeStep, _gravity);
+
+  // B = w(parent) x m*v - fext - fgravity
+  updatePointMassConstants();
+  const Eigen::VectorXs& masses = mPointArrays.mMasses;
+  mPointArrays.mB.noalias()
+      = math::makeSkewSymmetric(getSpatialVelocity().head<3>())
+        * (getPointMassBodyVelocities() * masses.asDiagonal());
+  mPointArrays.mB -= mPointArrays.mFext;
 
   // Gravity force
   if (BodyNode::mAspectProperties.mGravityMode == true)
+  {
+    const Eigen::Vector3s localGravity
+        = getWorldTransform().linear().transpose() * _gravity;
+    mPointArrays.mB.noalias() -= localGravity * masses.transpose();
     mFgravity.noalias()
         = mI * math::AdInvRLinear(getWorldTransform(), _gravity);
+  }
   else
+  {
     mFgravity.setZero();
+  }
+  assert(!math::isNan(mPointArrays.mB));
+
+  // Cache data: alpha
+  const std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  gatherStates(states, &PointMass::State::mPositions, mPointArrays.mQ);
+  gatherStates(states, &PointMass::State::mVelocities, mPointArrays.mDq);
+  gatherStates(states, &PointMass::State::mForces, mPointArrays.mTau);
+  const PointMassArrays::Vectors& q = mPointArrays.mQ;
+  const PointMassArrays::Vectors& dq = mPointArrays.mDq;
+  const PointMassArrays::Vectors& eta = getPointMassPartialAccelerations();
+  const s_t kv = getVertexSpringStiffness();
+  const s_t ke = getEdgeSpringStiffness();
+  const s_t kd = getDampingCoefficient();
+  PointMassArrays::Vectors& alpha = mPointArrays.mAlpha;
+  alpha = mPointArrays.mTau - mPointArrays.mB;
+  alpha.noalias() -= eta * masses.asDiagonal();
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    const std::size_t begin = mPointArrays.mSpringOffsets[i];
+    const std::size_t end = mPointArrays.mSpringOffsets[i + 1];
+    const s_t k = kv + (end - begin) * ke;
+    alpha.col(i) -= k * q.col(i) + (_timeStep * k + kd) * dq.col(i);
+
+    for (std::size_t j = begin; j < end; ++j)
+    {
+      const std::size_t neighbor = mPointArrays.mSpringIndices[j];
+      alpha.col(i)
+          += ke * (q.col(neighbor) + _timeStep * dq.col(neighbor));
+    }
+  }
+  assert(!math::isNan(alpha));
+
+  // Cache data: beta
+  checkArticulatedInertiaUpdate();
+  mPointArrays.mBeta = mPointArrays.mB;
+  mPointArrays.mBeta.noalias()
+      += (eta + alpha * mPointArrays.mImplicitPsi.asDiagonal())
+         * masses.asDiagonal();
+  assert(!math::isNan(mPointArrays.mBeta));
 
   // Set bias force
   const Eigen::Vector6s& V = getSpatialVelocity();
@@ -742,12 +1087,8 @@ void SoftBodyNode::updateBiasForce(
   }
 
   //
-  for (const auto& pointMass : mPointMasses)
-  {
-    mBiasForce.head<3>()
-        += pointMass->getLocalPosition().cross(pointMass->mBeta);
-    mBiasForce.tail<3>() += pointMass->mBeta;
-  }
+  addPointForces(
+      mBiasForce, getPointMassLocalPositions(), mPointArrays.mBeta);
 
   // Verifycation
   assert(!math::isNan(mBiasForce));
@@ -764,8 +1105,23 @@ void SoftBodyNode::updateAccelerationFD()
 {
   BodyNode::updateAccelerationFD();
 
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateAccelerationFD();
+  // ddq = imp_psi*(alpha - m*(dw(parent) x mX + dv(parent))
+  updatePointMassConstants();
+  checkArticulatedInertiaUpdate();
+  const PointMassArrays::Vectors parentAcceleration = getPointMotion(
+      getSpatialAcceleration(), getPointMassLocalPositions());
+  PointMassArrays::Vectors& ddq = mPointArrays.mDdq;
+  ddq = (mPointArrays.mAlpha
+         - parentAcceleration * mPointArrays.mMasses.asDiagonal())
+        * mPointArrays.mImplicitPsi.asDiagonal();
+  assert(!math::isNan(ddq));
+  scatterStates(
+      ddq, &PointMass::State::mAccelerations, mAspectState.mPointStates);
+
+  // dv = dw(parent) x mX + dv(parent) + eta + ddq
+  mPointArrays.mA
+      = parentAcceleration + getPointMassPartialAccelerations() + ddq;
+  assert(!math::isNan(mPointArrays.mA));
 
   mNotifier->clearAccelerationNotice();
 }
@@ -775,15 +1131,22 @@ void SoftBodyNode::updateTransmittedForceFD()
 {
   BodyNode::updateTransmittedForceFD();
 
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateTransmittedForce();
+  // f = m*dv + B
+  updatePointMassConstants();
+  mPointArrays.mF = mPointArrays.mB;
+  mPointArrays.mF.noalias()
+      += getPointMassBodyAccelerations() * mPointArrays.mMasses.asDiagonal();
+  assert(!math::isNan(mPointArrays.mF));
 }
 
 //==============================================================================
 void SoftBodyNode::updateBiasImpulse()
 {
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateBiasImpulseFD();
+  // The point masses have no bias of their own, so their impulsive bias force
+  // (beta) is always zero
+  mPointArrays.mImpB = -mPointArrays.mConstraintImpulses;
+  mPointArrays.mImpAlpha = mPointArrays.mConstraintImpulses;
+  mPointArrays.mImpBeta.setZero();
 
   // Update impulsive bias force
   mBiasImpulse = -mConstraintImpulse;
@@ -799,13 +1162,6 @@ void SoftBodyNode::updateBiasImpulse()
         childBodyNode->mBiasImpulse);
   }
 
-  for (auto& pointMass : mPointMasses)
-  {
-    mBiasImpulse.head<3>()
-        += pointMass->getLocalPosition().cross(pointMass->mImpBeta);
-    mBiasImpulse.tail<3>() += pointMass->mImpBeta;
-  }
-
   // Verification
   assert(!math::isNan(mBiasImpulse));
 
@@ -818,8 +1174,17 @@ void SoftBodyNode::updateVelocityChangeFD()
 {
   BodyNode::updateVelocityChangeFD();
 
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateVelocityChangeFD();
+  // del_dq = psi*imp_alpha - (del_w(parent) x mX + del_v(parent))
+  checkArticulatedInertiaUpdate();
+  const PointMassArrays::Vectors parentVelocityChange = getPointMotion(
+      getBodyVelocityChange(), getPointMassLocalPositions());
+  mPointArrays.mVelocityChanges
+      = mPointArrays.mImpAlpha * mPointArrays.mPsi.asDiagonal()
+        - parentVelocityChange;
+  assert(!math::isNan(mPointArrays.mVelocityChanges));
+
+  mPointArrays.mDelV = parentVelocityChange + mPointArrays.mVelocityChanges;
+  assert(!math::isNan(mPointArrays.mDelV));
 }
 
 //==============================================================================
@@ -827,8 +1192,11 @@ void SoftBodyNode::updateTransmittedImpulse()
 {
   BodyNode::updateTransmittedImpulse();
 
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateTransmittedImpulse();
+  updatePointMassConstants();
+  mPointArrays.mImpF = mPointArrays.mImpB;
+  mPointArrays.mImpF.noalias()
+      += mPointArrays.mDelV * mPointArrays.mMasses.asDiagonal();
+  assert(!math::isNan(mPointArrays.mImpF));
 }
 
 //==============================================================================
@@ -836,8 +1204,37 @@ void SoftBodyNode::updateConstrainedTerms(s_t _timeStep)
 {
   BodyNode::updateConstrainedTerms(_timeStep);
 
-  for (auto& pointMass : mPointMasses)
-    pointMass->updateConstrainedTermsFD(_timeStep);
+  if (mPointMasses.empty())
+    return;
+
+  std::vector<PointMass::State>& states = mAspectState.mPointStates;
+  gatherStates(states, &PointMass::State::mVelocities, mPointArrays.mDq);
+  gatherStates(states, &PointMass::State::mAccelerations, mPointArrays.mDdq);
+  gatherStates(states, &PointMass::State::mForces, mPointArrays.mTau);
+  PointMassArrays::Vectors& dq = mPointArrays.mDq;
+  PointMassArrays::Vectors& ddq = mPointArrays.mDdq;
+  PointMassArrays::Vectors& forces = mPointArrays.mTau;
+
+  // 1. dq = dq + del_dq
+  dq += mPointArrays.mVelocityChanges;
+
+  // 2. ddq = ddq + del_dq / dt
+  ddq += mPointArrays.mVelocityChanges / _timeStep;
+
+  // 3. tau = tau + imp / dt
+  forces += mPointArrays.mConstraintImpulses / _timeStep;
+
+  ///
+  ddq += mPointArrays.mDelV / _timeStep;
+
+  ///
+  mPointArrays.mF += _timeStep * mPointArrays.mImpF;
+
+  scatterStates(dq, &PointMass::State::mVelocities, states);
+  scatterStates(ddq, &PointMass::State::mAccelerations, states);
+  scatterStates(forces, &PointMass::State::mForces, states);
+
+  mNotifier->dirtyVelocity();
 }
 
 //==============================================================================
@@ -1211,13 +1608,8 @@ void SoftBodyNode::aggregateExternalForces(Eigen::VectorXs& _Fext)
         (*it)->mParentJoint->getRelativeTransform(), (*it)->mFext_F);
   }
 
-  for (std::vector<PointMass*>::iterator it = mPointMasses.begin();
-       it != mPointMasses.end();
-       ++it)
-  {
-    mFext_F.head<3>() += (*it)->getLocalPosition().cross((*it)->mFext);
-    mFext_F.tail<3>() += (*it)->mFext;
-  }
+  addPointForces(
+      mFext_F, getPointMassLocalPositions(), mPointArrays.mFext);
 
   int nGenCoords = mParentJoint->getNumDofs();
   if (nGenCoords > 0)
@@ -1234,8 +1626,7 @@ void SoftBodyNode::clearExternalForces()
 {
   BodyNode::clearExternalForces();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses.at(i)->clearExtForce();
+  mPointArrays.mFext.setZero();
 }
 
 //==============================================================================
@@ -1243,37 +1634,8 @@ void SoftBodyNode::clearInternalForces()
 {
   BodyNode::clearInternalForces();
 
-  for (std::size_t i = 0; i < mPointMasses.size(); ++i)
-    mPointMasses[i]->resetForces();
-}
-
-//==============================================================================
-void SoftBodyNode::_addPiToArtInertia(const Eigen::Vector3s& _p, s_t _Pi) const
-{
-  Eigen::Matrix3s tmp = math::makeSkewSymmetric(_p);
-
-  mArtInertia.topLeftCorner<3, 3>() -= _Pi * tmp * tmp;
-  mArtInertia.topRightCorner<3, 3>() += _Pi * tmp;
-  mArtInertia.bottomLeftCorner<3, 3>() -= _Pi * tmp;
-
-  mArtInertia(3, 3) += _Pi;
-  mArtInertia(4, 4) += _Pi;
-  mArtInertia(5, 5) += _Pi;
-}
-
-//==============================================================================
-void SoftBodyNode::_addPiToArtInertiaImplicit(
-    const Eigen::Vector3s& _p, s_t _ImplicitPi) const
-{
-  Eigen::Matrix3s tmp = math::makeSkewSymmetric(_p);
-
-  mArtInertiaImplicit.topLeftCorner<3, 3>() -= _ImplicitPi * tmp * tmp;
-  mArtInertiaImplicit.topRightCorner<3, 3>() += _ImplicitPi * tmp;
-  mArtInertiaImplicit.bottomLeftCorner<3, 3>() -= _ImplicitPi * tmp;
-
-  mArtInertiaImplicit(3, 3) += _ImplicitPi;
-  mArtInertiaImplicit(4, 4) += _ImplicitPi;
-  mArtInertiaImplicit(5, 5) += _ImplicitPi;
+  for (PointMass::State& state : mAspectState.mPointStates)
+    state.mForces.setZero();
 }
 
 //==============================================================================
@@ -314,14 +314,93 @@ protected:
   ///
   math::Inertia mArtInertiaImplicit2;
 
-private:
-  /// \brief
-  void _addPiToArtInertia(const Eigen::Vector3s& _p, s_t _Pi) const;
-
-  /// \brief
-  void _addPiToArtInertiaImplicit(const Eigen::Vector3s& _p,
-                                  s_t _ImplicitPi) const;
+  /// Per point mass quantities of the recursive dynamics, with one column per
+  /// point mass. Each dynamics routine sweeps these arrays in one pass instead
+  /// of visiting every PointMass object in turn. The generalized state of the
+  /// point masses stays in the AspectState, and is copied in and out of mQ,
+  /// mDq, mDdq and mTau around each sweep.
+  struct PointMassArrays
+  {
+    using Vectors = Eigen::Matrix<s_t, 3, Eigen::Dynamic>;
+
+    /// Masses and resting positions, copied out of the AspectProperties
+    Eigen::VectorXs mMasses;
+    Vectors mRestingPositions;
+
+    /// The edge springs in compressed sparse row form. Point mass i is
+    /// connected to mSpringIndices[k] for every k from mSpringOffsets[i] up to
+    /// (but not including) mSpringOffsets[i + 1].
+    std::vector<std::size_t> mSpringOffsets;
+    std::vector<std::size_t> mSpringIndices;
+
+    /// True when the masses, resting positions and springs above need to be
+    /// copied out of the AspectProperties again
+    bool mNeedConstantsUpdate = true;
+
+    /// The generalized positions, velocities, accelerations and forces. The
+    /// AspectState owns these, so they're copied in before each sweep that
+    /// reads them, and copied back out after each sweep that writes them.
+    Vectors mQ;
+    Vectors mDq;
+    Vectors mDdq;
+    Vectors mTau;
+
+    /// Positions in the SoftBodyNode frame and in the world frame
+    Vectors mX;
+    Vectors mW;
+
+    /// Velocities, partial accelerations and accelerations, in the
+    /// SoftBodyNode frame
+    Vectors mV;
+    Vectors mEta;
+    Vectors mA;
+
+    /// Forces, bias forces and external forces
+    Vectors mF;
+    Vectors mB;
+    Vectors mFext;
+
+    /// Cache data for the articulated body algorithm
+    Vectors mAlpha;
+    Vectors mBeta;
+    Eigen::VectorXs mPsi;
+    Eigen::VectorXs mImplicitPsi;
+    Eigen::VectorXs mPi;
+    Eigen::VectorXs mImplicitPi;
+
+    /// Impulse-based dynamics
+    Vectors mConstraintImpulses;
+    Vectors mVelocityChanges;
+    Vectors mDelV;
+    Vectors mImpB;
+    Vectors mImpAlpha;
+    Vectors mImpBeta;
+    Vectors mImpF;
+  };
+
+  /// The dynamics quantities of every point mass
+  mutable PointMassArrays mPointArrays;
+
+  /// Copies the masses, resting positions and springs of the point masses
+  /// into mPointArrays, if they've changed since we last did
+  void updatePointMassConstants() const;
+
+  /// Resizes mPointArrays to hold `_count` point masses. Point masses that
+  /// already existed keep their values, and new ones start at zero.
+  void resizePointMassArrays(std::size_t _count);
+
+  /// These return the positions, body velocities, partial accelerations and
+  /// body accelerations of every point mass, updating them first if needed
+  const PointMassArrays::Vectors& getPointMassLocalPositions() const;
+  const PointMassArrays::Vectors& getPointMassBodyVelocities() const;
+  const PointMassArrays::Vectors& getPointMassPartialAccelerations() const;
+  const PointMassArrays::Vectors& getPointMassBodyAccelerations() const;
+
+  /// These integrate the generalized state of every point mass at once
+  void integratePointMassPositions(s_t _dt);
+  void integratePointMassVelocities(s_t _dt);
 
+private:
   ///
   void updateInertiaWithPointMass();
 };
@@ -157,6 +157,25 @@ void ConstrainedGroupGradientMatrices::measureConstraintImpulse(
   mMassedImpulseTests.push_back(massedImpulseTest);
 }
 
+//==============================================================================
+void ConstrainedGroupGradientMatrices::measureConstraintImpulse(
+    const constraint::ConstraintBasePtr& constraint,
+    const std::vector<Eigen::VectorXs>& velocityChanges)
+{
+  const std::vector<SkeletonPtr> skels = constraint->getSkeletons();
+  assert(skels.size() == velocityChanges.size());
+
+  Eigen::VectorXs massedImpulseTest = Eigen::VectorXs::Zero(mNumDOFs);
+  for (std::size_t i = 0; i < skels.size(); ++i)
+  {
+    std::size_t offset = mSkeletonOffset[skels[i]->getName()];
+    std::size_t dofs = skels[i]->getNumDofs();
+
+    massedImpulseTest.segment(offset, dofs) = velocityChanges[i];
+  }
+  mMassedImpulseTests.push_back(massedImpulseTest);
+}
+
 //==============================================================================
 void ConstrainedGroupGradientMatrices::mockMeasureConstraintImpulse(
     Eigen::VectorXs massedImpulseTest)
@@ -70,6 +70,14 @@ public:
       const std::shared_ptr<constraint::ConstraintBase>& constraint,
       std::size_t constraintIndex);
 
+  /// This is the same as measureConstraintImpulse(), but for solvers that
+  /// compute the velocity changes as M^{-1} J^T instead of applying a
+  /// measurement impulse. `velocityChanges` holds the velocity change of each
+  /// skeleton in constraint->getSkeletons(), in the same order.
+  void measureConstraintImpulse(
+      const std::shared_ptr<constraint::ConstraintBase>& constraint,
+      const std::vector<Eigen::VectorXs>& velocityChanges);
+
   /// This will attempt to quickly solve an LCP by exploiting locality in the
   /// solution. Assuming we were initialized at the last solution, there's
   /// actually a good chance that we're still in all the same force categories.
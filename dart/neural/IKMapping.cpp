@@ -14,7 +14,10 @@ namespace neural {
 
 //==============================================================================
 IKMapping::IKMapping(std::shared_ptr<simulation::World> world)
-  : mIKIterationLimit(100)
+  : mIKIterationLimit(100),
+    mIKWarmStart(false),
+    mIKTolerance(1e-21),
+    mIKDamping(1e-4)
 {
   mMassDim = world->getMassDims();
 }
@@ -38,6 +41,42 @@ int IKMapping::getIKIterationLimit()
   return mIKIterationLimit;
 }
 
+//==============================================================================
+void IKMapping::setIKWarmStart(bool warmStart)
+{
+  mIKWarmStart = warmStart;
+}
+
+//==============================================================================
+bool IKMapping::getIKWarmStart()
+{
+  return mIKWarmStart;
+}
+
+//==============================================================================
+void IKMapping::setIKTolerance(s_t tolerance)
+{
+  mIKTolerance = tolerance;
+}
+
+//==============================================================================
+s_t IKMapping::getIKTolerance()
+{
+  return mIKTolerance;
+}
+
+//==============================================================================
+void IKMapping::setIKDamping(s_t damping)
+{
+  mIKDamping = damping;
+}
+
+//==============================================================================
+s_t IKMapping::getIKDamping()
+{
+  return mIKDamping;
+}
+
 //==============================================================================
 void IKMapping::addSpatialBodyNode(dynamics::BodyNode* node)
 {
@@ -86,76 +125,127 @@ void IKMapping::setPositions(
     std::shared_ptr<simulation::World> world,
     const Eigen::Ref<Eigen::VectorXs>& positions)
 {
-  // Reset to 0, so that solutions are always deterministic even if IK is
-  // under/over specified
-  world->setPositions(Eigen::VectorXs::Zero(world->getNumDofs()));
-  // Run simple IK to try to get as close as possible. Completely possible that
-  // the requested positions are infeasible, in which case we'll just do a best
-  // guess.
-  s_t error = std::numeric_limits<s_t>::infinity();
-  s_t lr = 0.05;
-  bool useTranspose = false;
-  for (int i = 0; i < mIKIterationLimit; i++)
+  // While the positions stay this close to where we last factored the
+  // Jacobian, we keep taking steps with that factorization rather than
+  // rebuilding it.
+  const s_t jacobianReuseDistance = 1e-3;
+  // If the damping has to climb this high to make any progress, we're stuck
+  const s_t maxDamping = 1e6;
+
+  if (!mIKWarmStart)
+  {
+    // Reset to 0, so that solutions are always deterministic even if IK is
+    // under/over specified
+    world->setPositions(Eigen::VectorXs::Zero(world->getNumDofs()));
+  }
+  // Run damped least-squares IK to try to get as close as possible. Completely
+  // possible that the requested positions are infeasible, in which case we'll
+  // just do a best guess.
+  const int dim = getDim();
+  const int dofs = world->getNumDofs();
+  s_t damping = mIKDamping;
+
+  Eigen::VectorXs bestPos = world->getPositions();
+  Eigen::VectorXs bestDiff = positions - getPositions(world);
+  s_t bestError = bestDiff.squaredNorm();
+
+  Eigen::MatrixXs J;
+  Eigen::LLT<Eigen::MatrixXs> factored;
+  Eigen::VectorXs factoredAt;
+  bool needsFactoring = true;
+
+  int i = 0;
+  for (; i < mIKIterationLimit; i++)
   {
-    Eigen::VectorXs diff = positions - getPositions(world);
-    s_t newError = diff.squaredNorm();
-    s_t errorChange = newError - error;
-    error = newError;
 #ifdef DART_NEURAL_LOG_IK_OUTPUT
-    std::cout << "IK iteration " << i << " lr: " << lr << " loss: " << error
-              << " change: " << errorChange << std::endl;
+    std::cout << "IK iteration " << i << " damping: " << damping
+              << " loss: " << bestError << std::endl;
 #endif
-    if (error < 1e-21)
+    if (bestError < mIKTolerance)
     {
-#ifdef DART_NEURAL_LOG_IK_OUTPUT
-      std::cout << "Terminating IK search after " << i
-                << " iterations with loss: " << error << std::endl;
-#endif
       break;
     }
-    if (errorChange > 0)
+
+    if (needsFactoring
+        || (bestPos - factoredAt).squaredNorm()
+               > jacobianReuseDistance * jacobianReuseDistance)
     {
-      lr *= 0.5;
+      J = getPosJacobian(world);
+      // J^T (J J^T + d^2 I)^-1 == (J^T J + d^2 I)^-1 J^T, so we factor
+      // whichever of the two is smaller
+      if (dim <= dofs)
+      {
+        factored.compute(
+            J * J.transpose()
+            + damping * damping * Eigen::MatrixXs::Identity(dim, dim));
+      }
+      else
+      {
+        factored.compute(
+            J.transpose() * J
+            + damping * damping * Eigen::MatrixXs::Identity(dofs, dofs));
+      }
+      factoredAt = bestPos;
+      needsFactoring = false;
     }
-    else if (errorChange > -1e-22)
+    const bool freshFactorization = factoredAt == bestPos;
+
+    Eigen::VectorXs delta;
+    if (dim <= dofs)
     {
-#ifdef DART_NEURAL_LOG_IK_OUTPUT
-      std::cout << "Terminating IK search after " << i
-                << " iterations with optimal loss: " << error << std::endl;
-#endif
-      break;
+      delta = J.transpose() * factored.solve(bestDiff);
     }
     else
     {
-      // Slowly grow LR while we're safely decreasing loss
-      lr *= 1.1;
-    }
-    if (lr < 1e-4)
-    {
-      useTranspose = true;
+      delta = factored.solve(J.transpose() * bestDiff);
     }
+    world->setPositions(bestPos + delta);
 
-    Eigen::MatrixXs J = getPosJacobian(world);
-    Eigen::VectorXs delta;
+    Eigen::VectorXs diff = positions - getPositions(world);
+    s_t error = diff.squaredNorm();
 
-    if (useTranspose)
+    if (error < bestError)
     {
-      delta = J.transpose() * diff;
+      bool stalled = bestError - error < mIKTolerance;
+      bestPos = world->getPositions();
+      bestDiff = diff;
+      bestError = error;
+      if (stalled)
+      {
+        if (freshFactorization)
+        {
+          break;
+        }
+        // Maybe we just need a fresh Jacobian
+        needsFactoring = true;
+      }
+      else if (damping > mIKDamping)
+      {
+        // Relax the damping again while we're making progress
+        damping = std::max(damping * 0.1, mIKDamping);
+        needsFactoring = true;
+      }
     }
     else
     {
-      delta = J.completeOrthogonalDecomposition().solve(diff);
+      // The step made things worse, so back out of it. If we were using an
+      // old Jacobian, try again with a fresh one. Otherwise, we overshot, so
+      // take a more heavily damped step.
+      world->setPositions(bestPos);
+      if (freshFactorization)
+      {
+        damping *= 10;
+        if (damping > maxDamping)
+        {
+          break;
+        }
+      }
+      needsFactoring = true;
     }
-#ifdef DART_NEURAL_LOG_IK_OUTPUT
-    // std::cout << "IK Diff: " << std::endl << diff << std::endl;
-    // std::cout << "IK J: " << std::endl << J << std::endl;
-    // std::cout << "IK Delta: " << std::endl << delta << std::endl;
-    // std::cout << "J * IK Delta: " << std::endl << J * delta << std::endl;
-#endif
-    world->setPositions(world->getPositions() + (lr * delta));
   }
 #ifdef DART_NEURAL_LOG_IK_OUTPUT
-  std::cout << "Finished IK search with loss: " << error << std::endl;
+  std::cout << "Finished IK search after " << i
+            << " iterations with loss: " << bestError << std::endl;
 #endif
 }
 
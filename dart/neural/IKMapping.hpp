@@ -48,6 +48,25 @@ public:
   void setIKIterationLimit(int limit);
   int getIKIterationLimit();
 
+  /// By default, the IK solve in setPositions() starts from all zeros, which
+  /// makes the answer independent of the world's prior state when the IK has
+  /// more than one solution. Turning this on starts every solve from the
+  /// world's current positions instead, which are usually the solution to the
+  /// previous call, or close to it. That's faster, but the answer can then
+  /// depend on the order of calls.
+  void setIKWarmStart(bool warmStart);
+  bool getIKWarmStart();
+
+  /// The IK solve stops once the squared error in the mapped positions drops
+  /// below this, or once a step fails to improve it by more than this.
+  void setIKTolerance(s_t tolerance);
+  s_t getIKTolerance();
+
+  /// The IK solve takes damped least-squares steps. This is the smallest
+  /// damping it uses, which it raises temporarily whenever a step overshoots.
+  void setIKDamping(s_t damping);
+  s_t getIKDamping();
+
   /// This adds the spatial (6D) coordinates of a body node to the list,
   /// increasing Dim size by 6
   void addSpatialBodyNode(dynamics::BodyNode* node);
@@ -176,6 +195,9 @@ protected:
 
   int mMassDim;
   int mIKIterationLimit;
+  bool mIKWarmStart;
+  s_t mIKTolerance;
+  s_t mIKDamping;
 };
 
 } // namespace neural
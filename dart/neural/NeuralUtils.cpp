@@ -132,18 +132,27 @@ std::shared_ptr<MappedBackpropSnapshot> mappedForwardPass(
 }
 
 //==============================================================================
-Eigen::MatrixXs jointPosToWorldSpatialJacobian(
+/// This finds the BodyNodes in `skel` with the same indices as `nodes`, which
+/// may come from a different copy of the skeleton
+static std::vector<const dynamics::BodyNode*> getSkelBodyNodes(
     const std::shared_ptr<dynamics::Skeleton>& skel,
     const std::vector<dynamics::BodyNode*>& nodes)
 {
-  int dofs = skel->getNumDofs();
-  Eigen::MatrixXs jac = Eigen::MatrixXs::Zero(nodes.size() * 6, dofs);
-  for (int i = 0; i < nodes.size(); i++)
+  std::vector<const dynamics::BodyNode*> skelNodes;
+  skelNodes.reserve(nodes.size());
+  for (dynamics::BodyNode* node : nodes)
   {
-    jac.block(i * 6, 0, 6, dofs) = skel->getWorldPositionJacobian(
-        skel->getBodyNode(nodes[i]->getIndexInSkeleton()));
+    skelNodes.push_back(skel->getBodyNode(node->getIndexInSkeleton()));
   }
-  return jac;
+  return skelNodes;
+}
+
+//==============================================================================
+Eigen::MatrixXs jointPosToWorldSpatialJacobian(
+    const std::shared_ptr<dynamics::Skeleton>& skel,
+    const std::vector<dynamics::BodyNode*>& nodes)
+{
+  return skel->getWorldPositionJacobians(getSkelBodyNodes(skel, nodes));
 }
 
 //==============================================================================
@@ -168,14 +177,7 @@ Eigen::MatrixXs jointVelToWorldSpatialJacobian(
     const std::shared_ptr<dynamics::Skeleton>& skel,
     const std::vector<dynamics::BodyNode*>& nodes)
 {
-  int dofs = skel->getNumDofs();
-  Eigen::MatrixXs jac = Eigen::MatrixXs::Zero(nodes.size() * 6, dofs);
-  for (int i = 0; i < nodes.size(); i++)
-  {
-    jac.block(i * 6, 0, 6, dofs) = skel->getWorldJacobian(
-        skel->getBodyNode(nodes[i]->getIndexInSkeleton()));
-  }
-  return jac;
+  return skel->getWorldJacobians(getSkelBodyNodes(skel, nodes));
 }
 
 //==============================================================================
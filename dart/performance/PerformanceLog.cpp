@@ -157,6 +157,21 @@ void PerformanceLog::end()
   mEndClock = getClock();
 }
 
+//==============================================================================
+/// This adds `amount` to a named counter attached to this run. Counters are
+/// useful to record non-timing statistics (like pivot counts) alongside the
+/// timing tree, and get aggregated when we call finalize().
+void PerformanceLog::incrementCounter(char const* name, long amount)
+{
+  int nameIndex;
+  {
+    // mapStringToIndex() mutates the global string index
+    const std::lock_guard<std::mutex> lock(globalPerfLogListMutex);
+    nameIndex = mapStringToIndex(name);
+  }
+  mCounters[nameIndex] += amount;
+}
+
 //==============================================================================
 /// This will look through the global static lists and recursively construct
 /// all the FinalizedPerformanceLogs to unify everything.
@@ -179,6 +194,12 @@ FinalizedPerformanceLog::recursivelyConstruct(std::vector<int> nameIdStack)
     {
       uint64_t diff = rawLog->mEndClock - rawLog->mStartClock;
       log->registerRun(diff);
+      for (auto pair : rawLog->mCounters)
+      {
+        log->registerCounter(
+            PerformanceLog::globalPerfStringReverseIndex[pair.first],
+            pair.second);
+      }
       selfIds.insert(rawLog->mId);
     }
   }
@@ -238,6 +259,14 @@ void FinalizedPerformanceLog::registerRun(uint64_t duration)
   mRuns.push_back(duration);
 }
 
+//==============================================================================
+/// This records one sample of a named counter, from a single run
+void FinalizedPerformanceLog::registerCounter(
+    const std::string& name, long value)
+{
+  mCounters[name].push_back(value);
+}
+
 //==============================================================================
 int FinalizedPerformanceLog::getNumRuns()
 {
@@ -262,6 +291,30 @@ uint64_t FinalizedPerformanceLog::getTotalRuntime()
   return sum;
 }
 
+//==============================================================================
+/// This returns the sum of all the samples of a named counter across every
+/// run, or 0 if the counter was never recorded.
+long FinalizedPerformanceLog::getCounterTotal(const std::string& name)
+{
+  long sum = 0;
+  for (long value : getCounterSamples(name))
+    sum += value;
+  return sum;
+}
+
+//==============================================================================
+/// This returns all the samples recorded for a named counter, one per run
+/// that recorded it.
+const std::vector<long>& FinalizedPerformanceLog::getCounterSamples(
+    const std::string& name)
+{
+  static const std::vector<long> empty;
+  auto it = mCounters.find(name);
+  if (it == mCounters.end())
+    return empty;
+  return it->second;
+}
+
 //==============================================================================
 /// This will print the results in human readable format, which we can pipe to
 /// a file or to std::out
@@ -301,6 +354,14 @@ void FinalizedPerformanceLog::recursivePrettyPrint(
          << " runs at mean " << getMeanRuntime() << " cycles = " << totalCycles
          << " total)\n";
 
+  for (auto pair : mCounters)
+  {
+    for (int i = 0; i < tabs + 1; i++)
+      stream << "  ";
+    stream << "# " << pair.first << ": " << getCounterTotal(pair.first)
+           << " total over " << pair.second.size() << " runs\n";
+  }
+
   for (auto pair : mChildren)
   {
     pair.second->recursivePrettyPrint(
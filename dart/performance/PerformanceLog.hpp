@@ -34,12 +34,23 @@ public:
 
   void registerRun(uint64_t duration);
 
+  /// This records one sample of a named counter, from a single run
+  void registerCounter(const std::string& name, long value);
+
   int getNumRuns();
 
   s_t getMeanRuntime();
 
   uint64_t getTotalRuntime();
 
+  /// This returns the sum of all the samples of a named counter across every
+  /// run, or 0 if the counter was never recorded.
+  long getCounterTotal(const std::string& name);
+
+  /// This returns all the samples recorded for a named counter, one per run
+  /// that recorded it.
+  const std::vector<long>& getCounterSamples(const std::string& name);
+
   /// This will print the results in human readable format, which we can pipe to
   /// a file or to std::out
   std::string prettyPrint();
@@ -53,6 +64,7 @@ protected:
   std::unordered_map<std::string, std::shared_ptr<FinalizedPerformanceLog>>
       mChildren;
   std::vector<uint64_t> mRuns;
+  std::unordered_map<std::string, std::vector<long>> mCounters;
 
   /// This pretty prints to a stream
   void recursivePrettyPrint(
@@ -95,6 +107,11 @@ public:
   /// object.
   void end();
 
+  /// This adds `amount` to a named counter attached to this run. Counters are
+  /// useful to record non-timing statistics (like pivot counts) alongside the
+  /// timing tree, and get aggregated when we call finalize().
+  void incrementCounter(char const* name, long amount = 1);
+
   /// This needs to be called once at the beginning of execution, and if it's
   /// called multiple times will clear previous logs.
   static void initialize();
@@ -115,6 +132,9 @@ protected:
   /// This is the parent's ID
   int mParentId;
 
+  /// These are any counters recorded on this run, keyed by name index
+  std::unordered_map<int, long> mCounters;
+
   static int mapStringToIndex(const char* str);
 
   static std::unordered_map<std::string, int> globalPerfStringIndex;
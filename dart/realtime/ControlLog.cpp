@@ -3,12 +3,12 @@
 namespace dart {
 namespace realtime {
 
-ControlLog::ControlLog(int dim, int millisPerStep)
-  : mDim(dim), mMillisPerStep(millisPerStep), mLogEnd(0L)
+ControlLog::ControlLog(int dim, Duration stepDuration)
+  : mDim(dim), mStepDuration(stepDuration), mLogEnd()
 {
 }
 
-void ControlLog::record(long time, Eigen::VectorXs control)
+void ControlLog::record(TimePoint time, Eigen::VectorXs control)
 {
   if (time > mLogEnd)
     mLogEnd = time;
@@ -19,8 +19,9 @@ void ControlLog::record(long time, Eigen::VectorXs control)
   }
   else
   {
-    long logEnd = mLogStart + ((mLog.size() - 1) * mMillisPerStep);
-    int steps = (int)floor((s_t)(time - logEnd) / mMillisPerStep);
+    TimePoint logEnd
+        = mLogStart + static_cast<int>(mLog.size() - 1) * mStepDuration;
+    int steps = floorSteps(time - logEnd, mStepDuration);
     // This means we're recording backwards in time, which shouldn't be allowed.
     if (steps < 0)
     {
@@ -48,12 +49,12 @@ void ControlLog::record(long time, Eigen::VectorXs control)
   }
 }
 
-long ControlLog::last()
+TimePoint ControlLog::last()
 {
   return mLogEnd;
 }
 
-Eigen::VectorXs ControlLog::get(long time)
+Eigen::VectorXs ControlLog::get(TimePoint time)
 {
   // If we haven't recorded anything yet, default to 0
   if (mLog.size() == 0)
@@ -61,7 +62,7 @@ Eigen::VectorXs ControlLog::get(long time)
     return Eigen::VectorXs::Zero(mDim);
   }
 
-  int steps = (int)floor((s_t)(time - mLogStart) / mMillisPerStep);
+  int steps = floorSteps(time - mLogStart, mStepDuration);
   // If we're out of bounds in the past, extend our initial force
   if (steps <= 0)
     return mLog[0];
@@ -72,11 +73,11 @@ Eigen::VectorXs ControlLog::get(long time)
   return mLog[steps];
 }
 
-void ControlLog::discardBefore(long time)
+void ControlLog::discardBefore(TimePoint time)
 {
   if (time <= mLogStart || mLog.size() == 0)
     return;
-  int discardSteps = (int)ceil((s_t)(time - mLogStart) / mMillisPerStep);
+  int discardSteps = ceilSteps(time - mLogStart, mStepDuration);
   // This means we're throwing out the whole log, just extrapolate the last
   // known force
   if (discardSteps >= mLog.size())
@@ -95,21 +96,21 @@ void ControlLog::discardBefore(long time)
     trimmedLog.push_back(mLog[i]);
   }
   mLog = trimmedLog;
-  mLogStart += discardSteps * mMillisPerStep;
+  mLogStart += discardSteps * mStepDuration;
 }
 
-void ControlLog::setMillisPerStep(int newMillisPerStep)
+void ControlLog::setStepDuration(Duration newStepDuration)
 {
-  int duration = mLog.size() * mMillisPerStep;
-  int newSteps = (int)ceil((s_t)duration / newMillisPerStep);
+  Duration duration = static_cast<int>(mLog.size()) * mStepDuration;
+  int newSteps = ceilSteps(duration, newStepDuration);
 
   std::vector<Eigen::VectorXs> newLog;
   for (int i = 0; i < newSteps; i++)
   {
-    newLog.push_back(get(mLogStart + i * newMillisPerStep));
+    newLog.push_back(get(mLogStart + i * newStepDuration));
   }
 
-  mMillisPerStep = newMillisPerStep;
+  mStepDuration = newStepDuration;
   mLog = newLog;
 }
 
@@ -6,6 +6,7 @@
 #include <Eigen/Dense>
 
 #include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
 
 namespace dart {
 namespace realtime {
@@ -13,27 +14,27 @@ namespace realtime {
 class ControlLog
 {
 public:
-  ControlLog(int dim, int millisPerStep);
+  ControlLog(int dim, Duration stepDuration);
 
-  void record(long time, Eigen::VectorXs control);
+  void record(TimePoint time, Eigen::VectorXs control);
 
-  long last();
+  TimePoint last();
 
-  Eigen::VectorXs get(long time);
+  Eigen::VectorXs get(TimePoint time);
 
-  void discardBefore(long time);
+  void discardBefore(TimePoint time);
 
-  void setMillisPerStep(int millisPerStep);
+  void setStepDuration(Duration stepDuration);
 
 protected:
   int mDim;
-  int mMillisPerStep;
-  long mLogStart;
-  long mLogEnd;
+  Duration mStepDuration;
+  TimePoint mLogStart;
+  TimePoint mLogEnd;
   std::vector<Eigen::VectorXs> mLog;
 };
 
 } // namespace realtime
 } // namespace dart
 
-#endif
\ No newline at end of file
+#endif
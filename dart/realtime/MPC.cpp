@@ -5,18 +5,17 @@
 namespace dart {
 namespace realtime {
 
-/// This calls getControlForce() with the current system clock as the time parameter
+/// This calls getControlForce() with the current time
 Eigen::VectorXs MPC::getControlForceNow()
 {
-  return getControlForce(timeSinceEpochMillis());
+  return getControlForce(now());
 }
 
-/// This calls recordGroundTruthState() with the current system clock as the
-/// time parameter
+/// This calls recordGroundTruthState() with the current time
 void MPC::recordGroundTruthStateNow(
     Eigen::VectorXs pos, Eigen::VectorXs vel, Eigen::VectorXs mass)
 {
-  recordGroundTruthState(timeSinceEpochMillis(), pos, vel, mass);
+  recordGroundTruthState(now(), pos, vel, mass);
 }
 
 } // namespace realtime
@@ -5,11 +5,17 @@
 
 #include <Eigen/Dense>
 
+#include "dart/realtime/Millis.hpp"
 #include "dart/trajectory/TrajectoryRollout.hpp"
 
 namespace dart {
 namespace realtime {
 
+/// This gets called with the time a new plan starts, the plan, and how long
+/// it took to compute
+using ReplanningListener = std::function<void(
+    TimePoint, const trajectory::TrajectoryRollout*, Duration)>;
+
 class MPC
 {
 public:
@@ -17,24 +23,26 @@ public:
 
   /// This gets the force to apply to the world at this instant. If we haven't
   /// computed anything for this instant yet, this just returns 0s.
-  virtual Eigen::VectorXs getControlForce(long now) = 0;
+  virtual Eigen::VectorXs getControlForce(TimePoint now) = 0;
 
-  /// This calls getControlForce() with the current system clock as the time parameter
+  /// This calls getControlForce() with the current time
   virtual Eigen::VectorXs getControlForceNow();
 
-  /// This returns how many millis we have left until we've run out of plan.
-  /// This can be a negative number, if we've run past our plan.
-  virtual long getRemainingPlanBufferMillis() = 0;
+  /// This returns how much time we have left until we've run out of plan.
+  /// This can be negative, if we've run past our plan.
+  virtual Duration getRemainingPlanBuffer() = 0;
 
   /// This records the current state of the world based on some external sensing
   /// and inference. This resets the error in our model just assuming the world
   /// is exactly following our simulation.
   virtual void recordGroundTruthState(
-      long time, Eigen::VectorXs pos, Eigen::VectorXs vel, Eigen::VectorXs mass)
+      TimePoint time,
+      Eigen::VectorXs pos,
+      Eigen::VectorXs vel,
+      Eigen::VectorXs mass)
       = 0;
 
-  /// This calls recordGroundTruthState() with the current system clock as the
-  /// time parameter
+  /// This calls recordGroundTruthState() with the current time
   virtual void recordGroundTruthStateNow(
       Eigen::VectorXs pos, Eigen::VectorXs vel, Eigen::VectorXs mass);
 
@@ -45,9 +53,7 @@ public:
   virtual void stop() = 0;
 
   /// This registers a listener to get called when we finish replanning
-  virtual void registerReplanningListener(
-      std::function<void(long, const trajectory::TrajectoryRollout*, long)>
-          replanListener)
+  virtual void registerReplanningListener(ReplanningListener replanListener)
       = 0;
 };
 
@@ -9,6 +9,7 @@
 #include "dart/proto/SerializeEigen.hpp"
 #include "dart/realtime/Millis.hpp"
 #include "dart/realtime/RealTimeControlBuffer.hpp"
+#include "dart/realtime/SharedMemoryChannel.hpp"
 #include "dart/simulation/World.hpp"
 #include "dart/trajectory/IPOptOptimizer.hpp"
 #include "dart/trajectory/LossFn.hpp"
@@ -26,26 +27,26 @@ namespace realtime {
 MPCLocal::MPCLocal(
     std::shared_ptr<simulation::World> world,
     std::shared_ptr<trajectory::LossFn> loss,
-    int planningHorizonMillis)
+    Duration planningHorizon)
   : mRunning(false),
     mWorld(world),
     mLoss(loss),
     mObservationLog(
-        timeSinceEpochMillis(),
+        now(),
         world->getPositions(),
         world->getVelocities(),
         world->getMasses()),
     mEnableLinesearch(true),
     mEnableOptimizationGuards(false),
     mRecordIterations(false),
-    mPlanningHorizonMillis(planningHorizonMillis),
-    mMillisPerStep(1000 * world->getTimeStep()),
-    mSteps((int)ceil((s_t)planningHorizonMillis / mMillisPerStep)),
+    mPlanningHorizon(planningHorizon),
+    mStepDuration(secondsToDuration(world->getTimeStep())),
+    mSteps(ceilSteps(planningHorizon, mStepDuration)),
     mShotLength(50),
     mMaxIterations(5),
-    mMillisInAdvanceToPlan(0),
-    mLastOptimizedTime(0L),
-    mBuffer(RealTimeControlBuffer(world->getNumDofs(), mSteps, mMillisPerStep)),
+    mTimeInAdvanceToPlan(Duration::zero()),
+    mLastOptimizedTime(),
+    mBuffer(RealTimeControlBuffer(world->getNumDofs(), mSteps, mStepDuration)),
     mSilent(false)
 {
 }
@@ -59,12 +60,12 @@ MPCLocal::MPCLocal(const MPCLocal& mpc)
     mEnableLinesearch(mpc.mEnableLinesearch),
     mEnableOptimizationGuards(mpc.mEnableOptimizationGuards),
     mRecordIterations(mpc.mRecordIterations),
-    mPlanningHorizonMillis(mpc.mPlanningHorizonMillis),
-    mMillisPerStep(mpc.mMillisPerStep),
+    mPlanningHorizon(mpc.mPlanningHorizon),
+    mStepDuration(mpc.mStepDuration),
     mSteps(mpc.mSteps),
     mShotLength(mpc.mShotLength),
     mMaxIterations(mpc.mMaxIterations),
-    mMillisInAdvanceToPlan(mpc.mMillisInAdvanceToPlan),
+    mTimeInAdvanceToPlan(mpc.mTimeInAdvanceToPlan),
     mLastOptimizedTime(mpc.mLastOptimizedTime),
     mBuffer(mpc.mBuffer),
     mSilent(mpc.mSilent)
@@ -108,16 +109,16 @@ std::shared_ptr<trajectory::Problem> MPCLocal::getProblem()
 
 /// This gets the force to apply to the world at this instant. If we haven't
 /// computed anything for this instant yet, this just returns 0s.
-Eigen::VectorXs MPCLocal::getControlForce(long now)
+Eigen::VectorXs MPCLocal::getControlForce(TimePoint now)
 {
   return mBuffer.getPlannedForce(now);
 }
 
-/// This returns how many millis we have left until we've run out of plan.
-/// This can be a negative number, if we've run past our plan.
-long MPCLocal::getRemainingPlanBufferMillis()
+/// This returns how much time we have left until we've run out of plan.
+/// This can be negative, if we've run past our plan.
+Duration MPCLocal::getRemainingPlanBuffer()
 {
-  return mBuffer.getPlanBufferMillisAfter(timeSinceEpochMillis());
+  return mBuffer.getPlanBufferAfter(now());
 }
 
 /// This can completely silence log output
@@ -171,13 +172,16 @@ void MPCLocal::setMaxIterations(int maxIters)
 /// and inference. This resets the error in our model just assuming the world
 /// is exactly following our simulation.
 void MPCLocal::recordGroundTruthState(
-    long time, Eigen::VectorXs pos, Eigen::VectorXs vel, Eigen::VectorXs mass)
+    TimePoint time,
+    Eigen::VectorXs pos,
+    Eigen::VectorXs vel,
+    Eigen::VectorXs mass)
 {
   mObservationLog.observe(time, pos, vel, mass);
 }
 
 /// This optimizes a block of the plan, starting at `startTime`
-void MPCLocal::optimizePlan(long startTime)
+void MPCLocal::optimizePlan(TimePoint startTime)
 {
   // We don't allow time to go backwards, because that leads to all sorts of
   // issues. We can get called for a time before a time we already optimized
@@ -240,7 +244,7 @@ void MPCLocal::optimizePlan(long startTime)
 
     mBuffer.setControlForcePlan(
         startTime,
-        timeSinceEpochMillis(),
+        now(),
         mProblem->getRolloutCache(worldClone)->getControlForcesConst());
 
     log->end();
@@ -252,22 +256,22 @@ void MPCLocal::optimizePlan(long startTime)
   {
     std::shared_ptr<simulation::World> worldClone = mWorld->clone();
 
-    int diff = startTime - mLastOptimizedTime;
-    int steps
-        = static_cast<int>(floor(static_cast<s_t>(diff) / mMillisPerStep));
-    int roundedDiff = steps * mMillisPerStep;
-    long roundedStartTime = mLastOptimizedTime + roundedDiff;
-    long totalPlanTime = mSteps * mMillisPerStep;
-    s_t percentage = (s_t)roundedDiff * 100.0 / totalPlanTime;
+    int steps = floorSteps(startTime - mLastOptimizedTime, mStepDuration);
+    Duration roundedDiff = steps * mStepDuration;
+    TimePoint roundedStartTime = mLastOptimizedTime + roundedDiff;
+    Duration totalPlanTime = mSteps * mStepDuration;
+    s_t percentage
+        = (s_t)roundedDiff.count() * 100.0 / (s_t)totalPlanTime.count();
 
     if (!mSilent)
     {
-      std::cout << "Advancing plan by " << roundedDiff << "ms = " << steps
-                << " steps, " << (percentage) << "% of total " << totalPlanTime
-                << "ms plan time" << std::endl;
+      std::cout << "Advancing plan by " << toMillis(roundedDiff)
+                << "ms = " << steps << " steps, " << (percentage)
+                << "% of total " << toMillis(totalPlanTime) << "ms plan time"
+                << std::endl;
     }
 
-    long startComputeWallTime = timeSinceEpochMillis();
+    TimePoint startCompute = now();
 
     mBuffer.estimateWorldStateAt(
         worldClone, &mObservationLog, roundedStartTime);
@@ -285,11 +289,10 @@ void MPCLocal::optimizePlan(long startTime)
 
     mBuffer.setControlForcePlan(
         startTime,
-        timeSinceEpochMillis(),
+        now(),
         mProblem->getRolloutCache(worldClone)->getControlForcesConst());
 
-    long computeDurationWallTime
-        = timeSinceEpochMillis() - startComputeWallTime;
+    Duration computeDuration = now() - startCompute;
 
     // Call any listeners that might be waiting on us
     for (auto listener : mReplannedListeners)
@@ -297,18 +300,28 @@ void MPCLocal::optimizePlan(long startTime)
       listener(
           startTime,
           mProblem->getRolloutCache(worldClone),
-          computeDurationWallTime);
+          computeDuration);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mSharedMemoryChannelMutex);
+      if (mSharedMemoryChannel)
+      {
+        mSharedMemoryChannel->publishPlan(
+            startTime,
+            computeDuration,
+            mProblem->getRolloutCache(worldClone));
+      }
     }
 
     if (!mSilent)
     {
       s_t factorOfSafety = 0.5;
       std::cout << " -> We were allowed "
-                << (int)floor(roundedDiff * factorOfSafety)
-                << "ms to solve this problem (" << roundedDiff
+                << (int)floor(toMillis(roundedDiff) * factorOfSafety)
+                << "ms to solve this problem (" << toMillis(roundedDiff)
                 << "ms new planning * " << factorOfSafety
                 << " factor of safety), and it took us "
-                << computeDurationWallTime << "ms" << std::endl;
+                << toMillis(computeDuration) << "ms" << std::endl;
     }
 
     mLastOptimizedTime = roundedStartTime;
@@ -321,34 +334,35 @@ void MPCLocal::optimizePlan(long startTime)
 /// and increasing the parallelism. We can also change the step size in the
 /// physics engine to produce less accurate results, but keep up with the
 /// world in fewer steps.
-void MPCLocal::adjustPerformance(long lastOptimizeTimeMillis)
+void MPCLocal::adjustPerformance(Duration lastOptimizeTime)
 {
   // This ensures that we don't "optimize our way out of sync", by letting the
   // optimizer change forces that already happened by the time the optimization
   // finishes, leading to us getting out of sync. Better to make our plans start
   // into the future.
-  mMillisInAdvanceToPlan = 1.2 * lastOptimizeTimeMillis;
+  mTimeInAdvanceToPlan
+      = std::chrono::duration_cast<Duration>(1.2 * lastOptimizeTime);
   // Don't go more than 200ms into the future, cause then errors have a chance
   // to propagate
-  if (mMillisInAdvanceToPlan > 200)
-    mMillisInAdvanceToPlan = 200;
+  if (mTimeInAdvanceToPlan > std::chrono::milliseconds(200))
+    mTimeInAdvanceToPlan = std::chrono::milliseconds(200);
 
   /*
-  s_t millisToComputeEachStep = (s_t)lastOptimizeTimeMillis / mSteps;
+  Duration timeToComputeEachStep = lastOptimizeTime / mSteps;
   // Our safety margin is 3x, we want to be at least 3 times as fast as real
   // time
-  long desiredMillisPerStep = 3 * millisToComputeEachStep;
+  Duration desiredStepDuration = 3 * timeToComputeEachStep;
 
   // This means our simulation step is too small, and we risk overflowing our
   // buffer before optimization finishes
-  if (desiredMillisPerStep > mMillisPerStep)
+  if (desiredStepDuration > mStepDuration)
   {
     std::cout << "Detected we're going too slow! Increasing timestep size from "
-              << mMillisPerStep << "ms -> " << desiredMillisPerStep << "ms"
-              << std::endl;
+              << toMillis(mStepDuration) << "ms -> "
+              << toMillis(desiredStepDuration) << "ms" << std::endl;
 
-    mBuffer.setMillisPerStep(mMillisPerStep);
-    mMillisPerStep = desiredMillisPerStep;
+    mBuffer.setStepDuration(mStepDuration);
+    mStepDuration = desiredStepDuration;
   }
   */
 }
@@ -379,9 +393,7 @@ std::shared_ptr<trajectory::Solution> MPCLocal::getCurrentSolution()
 }
 
 /// This registers a listener to get called when we finish replanning
-void MPCLocal::registerReplanningListener(
-    std::function<void(long, const trajectory::TrajectoryRollout*, long)>
-        replanListener)
+void MPCLocal::registerReplanningListener(ReplanningListener replanListener)
 {
   mReplannedListeners.push_back(replanListener);
 }
@@ -410,6 +422,62 @@ void MPCLocal::serve(int port)
   server->Wait();
 }
 
+/// This creates a named shared memory channel, and serves MPC clients on this
+/// machine over it. This call blocks until a client closes the channel.
+void MPCLocal::serveSharedMemory(const std::string& name, bool replaceExisting)
+{
+  std::shared_ptr<SharedMemoryChannel> channel = SharedMemoryChannel::create(
+      name,
+      mWorld->getNumDofs(),
+      mWorld->getMassDims(),
+      mSteps,
+      mStepDuration,
+      replaceExisting);
+  if (!channel)
+    return;
+  std::cout << "Serving MPC over shared memory \"" << name << "\""
+            << std::endl;
+  serveSharedMemory(channel);
+}
+
+/// This serves a single client over an existing shared memory channel. This
+/// call blocks until the channel is closed, and then stops optimizing.
+void MPCLocal::serveSharedMemory(std::shared_ptr<SharedMemoryChannel> channel)
+{
+  // This isn't a replanning listener, because those can't be removed again,
+  // and each call would leave one behind publishing into a closed channel
+  {
+    std::lock_guard<std::mutex> lock(mSharedMemoryChannelMutex);
+    mSharedMemoryChannel = channel;
+  }
+
+  SharedMemoryMessage message;
+  while (!channel->isClosed())
+  {
+    // Wake up periodically, so we notice if the channel gets closed
+    if (!channel->receiveMessage(message, std::chrono::milliseconds(100)))
+      continue;
+    switch (message.type)
+    {
+      case SharedMemoryMessage::START:
+        start();
+        break;
+      case SharedMemoryMessage::STOP:
+        stop();
+        break;
+      case SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE:
+        recordGroundTruthState(
+            message.time, message.pos, message.vel, message.mass);
+        break;
+    }
+  }
+  stop();
+
+  // Let go of the channel, so its name gets freed once the caller is done
+  std::lock_guard<std::mutex> lock(mSharedMemoryChannelMutex);
+  mSharedMemoryChannel = nullptr;
+}
+
 ///////////////////////////////////////////////////////////////////////
 /// Implements the gRPC API
 ///////////////////////////////////////////////////////////////////////
@@ -446,13 +514,15 @@ grpc::Status RPCWrapperMPCLocal::ListenForUpdates(
 {
   proto::MPCListenForUpdatesReply reply;
   mLocal.registerReplanningListener(
-      [&](long startTime,
+      [&](TimePoint startTime,
           const trajectory::TrajectoryRollout* rollout,
-          long duration) {
+          Duration duration) {
         reply.mutable_rollout()->Clear();
         rollout->serialize(*reply.mutable_rollout());
-        reply.set_starttime(startTime);
-        reply.set_replandurationmillis(duration);
+        // The wire format is in wall clock millis, so it works between
+        // machines
+        reply.set_starttime(toEpochMillis(startTime));
+        reply.set_replandurationmillis(toMillis(duration));
         writer->Write(reply);
       });
 
@@ -470,7 +540,7 @@ grpc::Status RPCWrapperMPCLocal::RecordGroundTruthState(
 {
   // std::cout << "gRPC server: RecordGroundTruthState" << std::endl;
   mLocal.recordGroundTruthState(
-      request->time(),
+      fromEpochMillis(request->time()),
       deserializeVector(request->pos()),
       deserializeVector(request->vel()),
       deserializeVector(request->mass()));
@@ -485,7 +555,7 @@ grpc::Status RPCWrapperMPCLocal::ObserveForce(
 {
   // std::cout << "gRPC server: ObserveForce" << std::endl;
   mLocal.mBuffer.manuallyRecordObservedForce(
-      request->time(), deserializeVector(request->force()));
+      fromEpochMillis(request->time()), deserializeVector(request->force()));
   return grpc::Status::OK;
 }
 
@@ -502,10 +572,9 @@ void MPCLocal::optimizationThreadLoop()
 
   while (mRunning)
   {
-    long startTime = timeSinceEpochMillis();
-    optimizePlan(startTime + mMillisInAdvanceToPlan);
-    long endTime = timeSinceEpochMillis();
-    adjustPerformance(endTime - startTime);
+    TimePoint startTime = now();
+    optimizePlan(startTime + mTimeInAdvanceToPlan);
+    adjustPerformance(now() - startTime);
   }
 }
 
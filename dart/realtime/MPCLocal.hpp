@@ -2,6 +2,7 @@
 #define DART_REALTIME_MPCLocal
 
 #include <memory>
+#include <mutex>
 #include <thread>
 
 #include <Eigen/Dense>
@@ -27,16 +28,19 @@ class TrajectoryRollout;
 
 namespace realtime {
 
+class SharedMemoryChannel;
+
 class MPCLocal final : public MPC
 {
 
   friend class MPCRemote;
+  friend class MPCSharedMemory;
 
 public:
   MPCLocal(
       std::shared_ptr<simulation::World> world,
       std::shared_ptr<trajectory::LossFn> loss,
-      int planningHorizonMillis);
+      Duration planningHorizon);
 
   /// Copy constructor
   MPCLocal(const MPCLocal& mpc);
@@ -63,11 +67,11 @@ public:
 
   /// This gets the force to apply to the world at this instant. If we haven't
   /// computed anything for this instant yet, this just returns 0s.
-  Eigen::VectorXs getControlForce(long now) override;
+  Eigen::VectorXs getControlForce(TimePoint now) override;
 
-  /// This returns how many millis we have left until we've run out of plan.
-  /// This can be a negative number, if we've run past our plan.
-  long getRemainingPlanBufferMillis() override;
+  /// This returns how much time we have left until we've run out of plan.
+  /// This can be negative, if we've run past our plan.
+  Duration getRemainingPlanBuffer() override;
 
   /// This can completely silence log output
   void setSilent(bool silent);
@@ -102,13 +106,13 @@ public:
   /// and inference. This resets the error in our model just assuming the world
   /// is exactly following our simulation.
   void recordGroundTruthState(
-      long time,
+      TimePoint time,
       Eigen::VectorXs pos,
       Eigen::VectorXs vel,
       Eigen::VectorXs mass) override;
 
   /// This optimizes a block of the plan, starting at `startTime`
-  void optimizePlan(long startTime);
+  void optimizePlan(TimePoint startTime);
 
   /// This adjusts parameters to make sure we're keeping up with real time. We
   /// can compute how many (ms / step) it takes us to optimize plans. Sometimes
@@ -116,7 +120,7 @@ public:
   /// and increasing the parallelism. We can also change the step size in the
   /// physics engine to produce less accurate results, but keep up with the
   /// world in fewer steps.
-  void adjustPerformance(long lastOptimizeTimeMillis);
+  void adjustPerformance(Duration lastOptimizeTime);
 
   /// This starts our main thread and begins running optimizations
   void start() override;
@@ -129,14 +133,27 @@ public:
   std::shared_ptr<trajectory::Solution> getCurrentSolution();
 
   /// This registers a listener to get called when we finish replanning
-  void registerReplanningListener(
-      std::function<void(long, const trajectory::TrajectoryRollout*, long)>
-          replanListener) override;
+  void registerReplanningListener(ReplanningListener replanListener) override;
 
   /// This launches a server on the specified port. This call blocks
   /// indefinitely, until the program is killed with Ctrl+C
   void serve(int port);
 
+  /// This creates a named shared memory channel (see SharedMemoryChannel),
+  /// and serves MPC clients on this machine over it, which is much lower
+  /// latency than serve(). The name should start with a '/'. This call blocks
+  /// until a client closes the channel. If the name is already taken, this
+  /// returns straight away, unless `replaceExisting` is true (see
+  /// SharedMemoryChannel::create()).
+  void serveSharedMemory(
+      const std::string& name, bool replaceExisting = false);
+
+  /// This serves a single client over an existing shared memory channel. This
+  /// call blocks until the channel is closed, and then stops optimizing. Only
+  /// one channel is served at a time, and new plans stop going to the channel
+  /// once this returns, so this can be called again for the next client.
+  void serveSharedMemory(std::shared_ptr<SharedMemoryChannel> channel);
+
 protected:
   /// This is the function for the optimization thread to run when we're live
   void optimizationThreadLoop();
@@ -151,13 +168,13 @@ protected:
   bool mEnableOptimizationGuards;
   bool mRecordIterations;
 
-  int mPlanningHorizonMillis;
-  int mMillisPerStep;
+  Duration mPlanningHorizon;
+  Duration mStepDuration;
   int mSteps;
   int mShotLength;
   int mMaxIterations;
-  int mMillisInAdvanceToPlan;
-  long mLastOptimizedTime;
+  Duration mTimeInAdvanceToPlan;
+  TimePoint mLastOptimizedTime;
   RealTimeControlBuffer mBuffer;
   std::thread mOptimizationThread;
   bool mSilent;
@@ -167,9 +184,13 @@ protected:
   std::shared_ptr<trajectory::Problem> mProblem;
 
   // These are listeners that get called when we finish replanning
-  std::vector<
-      std::function<void(long, const trajectory::TrajectoryRollout*, long)>>
-      mReplannedListeners;
+  std::vector<ReplanningListener> mReplannedListeners;
+
+  // This is the channel serveSharedMemory() is serving, if any, which gets
+  // every new plan. It's guarded by the mutex, because plans get published
+  // from the optimization thread.
+  std::shared_ptr<SharedMemoryChannel> mSharedMemoryChannel;
+  std::mutex mSharedMemoryChannelMutex;
 
   friend class RPCWrapperMPCLocal;
 };
@@ -12,16 +12,18 @@
 namespace dart {
 namespace realtime {
 
-// RealTimeControlBuffer(int forceDim, int steps, int millisPerStep);
-
 /// This connects to an MPC remote server
 MPCRemote::MPCRemote(
-    const std::string& host, int port, int dofs, int steps, int millisPerStep)
+    const std::string& host,
+    int port,
+    int dofs,
+    int steps,
+    Duration stepDuration)
   : mRunning(false),
     mChannel(grpc::CreateChannel(
         host + ":" + std::to_string(port), grpc::InsecureChannelCredentials())),
     mStub(proto::MPCService::NewStub(mChannel)),
-    mBuffer(dofs, steps, millisPerStep)
+    mBuffer(dofs, steps, stepDuration)
 {
 }
 
@@ -32,7 +34,7 @@ MPCRemote::MPCRemote(MPCLocal& local, int /* ignored */)
     mChannel(nullptr),
     mStub(nullptr),
     mBuffer(RealTimeControlBuffer(
-        local.mWorld->getNumDofs(), local.mSteps, local.mMillisPerStep))
+        local.mWorld->getNumDofs(), local.mSteps, local.mStepDuration))
 {
   int port = (rand() % 2000) + 2000;
 
@@ -78,30 +80,34 @@ MPCRemote::MPCRemote(MPCLocal& local, int /* ignored */)
 
 /// This gets the force to apply to the world at this instant. If we haven't
 /// computed anything for this instant yet, this just returns 0s.
-Eigen::VectorXs MPCRemote::getControlForce(long now)
+Eigen::VectorXs MPCRemote::getControlForce(TimePoint now)
 {
   return mBuffer.getPlannedForce(now);
 }
 
-/// This returns how many millis we have left until we've run out of plan.
-/// This can be a negative number, if we've run past our plan.
-long MPCRemote::getRemainingPlanBufferMillis()
+/// This returns how much time we have left until we've run out of plan.
+/// This can be negative, if we've run past our plan.
+Duration MPCRemote::getRemainingPlanBuffer()
 {
-  return mBuffer.getPlanBufferMillisAfter(timeSinceEpochMillis());
+  return mBuffer.getPlanBufferAfter(now());
 }
 
 /// This records the current state of the world based on some external sensing
 /// and inference. This resets the error in our model just assuming the world
 /// is exactly following our simulation.
 void MPCRemote::recordGroundTruthState(
-    long time, Eigen::VectorXs pos, Eigen::VectorXs vel, Eigen::VectorXs mass)
+    TimePoint time,
+    Eigen::VectorXs pos,
+    Eigen::VectorXs vel,
+    Eigen::VectorXs mass)
 {
   // Context for the client. It could be used to convey extra information to
   // the server and/or tweak certain RPC behaviors.
   grpc::ClientContext context;
 
   proto::MPCRecordGroundTruthStateRequest request;
-  request.set_time(time);
+  // The wire format is in wall clock millis, so it works between machines
+  request.set_time(toEpochMillis(time));
   proto::serializeVector(*request.mutable_pos(), pos);
   proto::serializeVector(*request.mutable_vel(), vel);
   proto::serializeVector(*request.mutable_mass(), mass);
@@ -164,12 +170,16 @@ void MPCRemote::start()
       trajectory::TrajectoryRolloutReal rollout
           = trajectory::TrajectoryRollout::deserialize(reply.rollout());
 
+      TimePoint startTime = fromEpochMillis(reply.starttime());
       mBuffer.setControlForcePlan(
-          reply.starttime(), timeSinceEpochMillis(), rollout.getControlForcesConst());
+          startTime, now(), rollout.getControlForcesConst());
 
       for (auto listener : mReplannedListeners)
       {
-        listener(reply.starttime(), &rollout, reply.replandurationmillis());
+        listener(
+            startTime,
+            &rollout,
+            std::chrono::milliseconds(reply.replandurationmillis()));
       }
     }
   });
@@ -203,9 +213,7 @@ void MPCRemote::stop()
 }
 
 /// This registers a listener to get called when we finish replanning
-void MPCRemote::registerReplanningListener(
-    std::function<void(long, const trajectory::TrajectoryRollout*, long)>
-        replanListener)
+void MPCRemote::registerReplanningListener(ReplanningListener replanListener)
 {
   mReplannedListeners.push_back(replanListener);
 }
@@ -27,7 +27,7 @@ public:
       int port,
       int dofs,
       int steps,
-      int millisPerStep);
+      Duration stepDuration);
 
   /// This forks the process, starts a server on another process, and connects
   /// to it
@@ -35,17 +35,17 @@ public:
 
   /// This gets the force to apply to the world at this instant. If we haven't
   /// computed anything for this instant yet, this just returns 0s.
-  Eigen::VectorXs getControlForce(long now) override;
+  Eigen::VectorXs getControlForce(TimePoint now) override;
 
-  /// This returns how many millis we have left until we've run out of plan.
-  /// This can be a negative number, if we've run past our plan.
-  long getRemainingPlanBufferMillis() override;
+  /// This returns how much time we have left until we've run out of plan.
+  /// This can be negative, if we've run past our plan.
+  Duration getRemainingPlanBuffer() override;
 
   /// This records the current state of the world based on some external sensing
   /// and inference. This resets the error in our model just assuming the world
   /// is exactly following our simulation.
   void recordGroundTruthState(
-      long time,
+      TimePoint time,
       Eigen::VectorXs pos,
       Eigen::VectorXs vel,
       Eigen::VectorXs mass) override;
@@ -57,9 +57,7 @@ public:
   void stop() override;
 
   /// This registers a listener to get called when we finish replanning
-  void registerReplanningListener(
-      std::function<void(long, const trajectory::TrajectoryRollout*, long)>
-          replanListener) override;
+  void registerReplanningListener(ReplanningListener replanListener) override;
 
 protected:
   bool mRunning;
@@ -69,9 +67,7 @@ protected:
   std::thread mUpdateListenerThread;
 
   // These are listeners that get called when we finish replanning
-  std::vector<
-      std::function<void(long, const trajectory::TrajectoryRollout*, long)>>
-      mReplannedListeners;
+  std::vector<ReplanningListener> mReplannedListeners;
 };
 
 } // namespace realtime
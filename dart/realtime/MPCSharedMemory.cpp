@@ -0,0 +1,217 @@
+#include "dart/realtime/MPCSharedMemory.hpp"
+
+#include <iostream>
+#include <unordered_map>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "dart/realtime/Millis.hpp"
+#include "dart/simulation/World.hpp"
+#include "dart/trajectory/TrajectoryRollout.hpp"
+
+namespace dart {
+namespace realtime {
+
+namespace {
+
+/// How long the plan listener blocks before rechecking whether we've stopped
+constexpr std::chrono::milliseconds PLAN_POLL_TIMEOUT(100);
+
+/// How long sendMessage() keeps retrying when the server has fallen behind
+constexpr std::chrono::milliseconds SEND_RETRY_TIMEOUT(100);
+
+RealTimeControlBuffer createBuffer(
+    const std::shared_ptr<SharedMemoryChannel>& channel)
+{
+  if (!channel)
+    return RealTimeControlBuffer(0, 1, std::chrono::milliseconds(1));
+  return RealTimeControlBuffer(
+      channel->getNumDofs(),
+      channel->getNumSteps(),
+      channel->getStepDuration());
+}
+
+} // namespace
+
+/// This connects to an MPCLocal::serveSharedMemory() server, running in
+/// another process on this machine
+MPCSharedMemory::MPCSharedMemory(const std::string& name)
+  : mRunning(false),
+    mChannel(SharedMemoryChannel::open(name)),
+    mBuffer(createBuffer(mChannel))
+{
+}
+
+/// This forks the process, serves `local` on the child process, and connects
+/// to it over an anonymous shared mapping
+MPCSharedMemory::MPCSharedMemory(MPCLocal& local)
+  : mRunning(false),
+    mChannel(SharedMemoryChannel::createAnonymous(
+        local.mWorld->getNumDofs(),
+        local.mWorld->getMassDims(),
+        local.mSteps,
+        local.mStepDuration)),
+    mBuffer(createBuffer(mChannel))
+{
+  if (!mChannel)
+    return;
+
+  int original_id = getpid();
+  int child_id = fork();
+  // We're in the child process, serve over the channel
+  if (child_id == 0)
+  {
+    // Start a thread to periodically check if our parent has died, and if so
+    // commit suicide
+    std::thread parent_liveness_poll([&]() {
+      while (true)
+      {
+        // Only poll once-per-second
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        int parent_id = getppid();
+        // This means the parent is dead
+        if (parent_id != original_id)
+        {
+          exit(0);
+        }
+      }
+    });
+    // Serve on this thread, until the parent closes the channel
+    local.serveSharedMemory(mChannel);
+    // When we're done serving, kill this process
+    exit(0);
+  }
+  // We're in the parent process
+  else if (child_id > 0)
+  {
+    std::cout << "(MPC fork process id = " << child_id << ")" << std::endl;
+  }
+}
+
+/// This stops the server and closes the channel
+MPCSharedMemory::~MPCSharedMemory()
+{
+  stop();
+  if (mChannel)
+    mChannel->close();
+}
+
+/// This gets the force to apply to the world at this instant. If we haven't
+/// computed anything for this instant yet, this just returns 0s.
+Eigen::VectorXs MPCSharedMemory::getControlForce(TimePoint now)
+{
+  return mBuffer.getPlannedForce(now);
+}
+
+/// This returns how much time we have left until we've run out of plan.
+/// This can be negative, if we've run past our plan.
+Duration MPCSharedMemory::getRemainingPlanBuffer()
+{
+  return mBuffer.getPlanBufferAfter(now());
+}
+
+/// This records the current state of the world based on some external sensing
+/// and inference. This resets the error in our model just assuming the world
+/// is exactly following our simulation.
+void MPCSharedMemory::recordGroundTruthState(
+    TimePoint time,
+    Eigen::VectorXs pos,
+    Eigen::VectorXs vel,
+    Eigen::VectorXs mass)
+{
+  sendMessage(
+      SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE, time, pos, vel, mass);
+}
+
+/// This starts our main thread and begins running optimizations
+void MPCSharedMemory::start()
+{
+  if (mRunning || !mChannel)
+    return;
+  mRunning = true;
+
+  sendMessage(SharedMemoryMessage::START, now());
+
+  // Start a thread to listen for updates
+  mUpdateListenerThread = std::thread([&]() {
+    uint32_t sequence = 0;
+    SharedMemoryPlan plan;
+    while (mRunning)
+    {
+      if (!mChannel->waitForPlan(sequence, plan, PLAN_POLL_TIMEOUT))
+        continue;
+
+      mBuffer.setControlForcePlan(plan.startTime, now(), plan.forces);
+
+      if (mReplannedListeners.empty())
+        continue;
+      // Only pay to build a rollout if someone's listening
+      std::unordered_map<std::string, Eigen::MatrixXs> poses;
+      std::unordered_map<std::string, Eigen::MatrixXs> vels;
+      std::unordered_map<std::string, Eigen::MatrixXs> forces;
+      poses["identity"] = plan.poses;
+      vels["identity"] = plan.vels;
+      forces["identity"] = plan.forces;
+      trajectory::TrajectoryRolloutReal rollout(
+          poses,
+          vels,
+          forces,
+          plan.masses,
+          std::unordered_map<std::string, Eigen::MatrixXs>());
+      for (auto listener : mReplannedListeners)
+      {
+        listener(plan.startTime, &rollout, plan.replanDuration);
+      }
+    }
+  });
+}
+
+/// This stops our main thread, waits for it to finish, and then returns
+void MPCSharedMemory::stop()
+{
+  if (!mRunning)
+    return;
+  mRunning = false;
+
+  sendMessage(SharedMemoryMessage::STOP, now());
+  mUpdateListenerThread.join();
+}
+
+/// This registers a listener to get called when we finish replanning
+void MPCSharedMemory::registerReplanningListener(
+    ReplanningListener replanListener)
+{
+  mReplannedListeners.push_back(replanListener);
+}
+
+/// This sends a message to the server, retrying briefly if the ring is full
+void MPCSharedMemory::sendMessage(
+    SharedMemoryMessage::Type type,
+    TimePoint time,
+    const Eigen::VectorXs& pos,
+    const Eigen::VectorXs& vel,
+    const Eigen::VectorXs& mass)
+{
+  if (!mChannel)
+    return;
+
+  const std::lock_guard<std::mutex> lock(mSendMutex);
+  const TimePoint deadline = now() + SEND_RETRY_TIMEOUT;
+  while (!mChannel->sendMessage(type, time, pos, vel, mass))
+  {
+    if (mChannel->isClosed())
+      return;
+    if (now() > deadline)
+    {
+      std::cout << "MPCSharedMemory dropped a message, the server isn't "
+                   "keeping up"
+                << std::endl;
+      return;
+    }
+    std::this_thread::yield();
+  }
+}
+
+} // namespace realtime
+} // namespace dart
@@ -0,0 +1,88 @@
+#ifndef DART_MPC_SHARED_MEMORY
+#define DART_MPC_SHARED_MEMORY
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dart/realtime/MPC.hpp"
+#include "dart/realtime/MPCLocal.hpp"
+#include "dart/realtime/RealTimeControlBuffer.hpp"
+#include "dart/realtime/SharedMemoryChannel.hpp"
+
+namespace dart {
+
+namespace realtime {
+
+/// This is a drop-in replacement for MPCRemote, for when the MPC server runs
+/// on the same machine. It talks to the server over a SharedMemoryChannel
+/// instead of gRPC, which cuts the latency of getting a fresh plan from
+/// milliseconds down to microseconds.
+class MPCSharedMemory : public MPC
+{
+public:
+  /// This connects to an MPCLocal::serveSharedMemory() server, running in
+  /// another process on this machine
+  MPCSharedMemory(const std::string& name);
+
+  /// This forks the process, serves `local` on the child process, and
+  /// connects to it over an anonymous shared mapping
+  MPCSharedMemory(MPCLocal& local);
+
+  /// This stops the server and closes the channel
+  ~MPCSharedMemory();
+
+  /// This gets the force to apply to the world at this instant. If we haven't
+  /// computed anything for this instant yet, this just returns 0s.
+  Eigen::VectorXs getControlForce(TimePoint now) override;
+
+  /// This returns how much time we have left until we've run out of plan.
+  /// This can be negative, if we've run past our plan.
+  Duration getRemainingPlanBuffer() override;
+
+  /// This records the current state of the world based on some external sensing
+  /// and inference. This resets the error in our model just assuming the world
+  /// is exactly following our simulation.
+  void recordGroundTruthState(
+      TimePoint time,
+      Eigen::VectorXs pos,
+      Eigen::VectorXs vel,
+      Eigen::VectorXs mass) override;
+
+  /// This starts our main thread and begins running optimizations
+  void start() override;
+
+  /// This stops our main thread, waits for it to finish, and then returns
+  void stop() override;
+
+  /// This registers a listener to get called when we finish replanning
+  void registerReplanningListener(ReplanningListener replanListener) override;
+
+protected:
+  /// This sends a message to the server, retrying briefly if the ring is full
+  void sendMessage(
+      SharedMemoryMessage::Type type,
+      TimePoint time,
+      const Eigen::VectorXs& pos = Eigen::VectorXs(),
+      const Eigen::VectorXs& vel = Eigen::VectorXs(),
+      const Eigen::VectorXs& mass = Eigen::VectorXs());
+
+  std::atomic<bool> mRunning;
+  std::shared_ptr<SharedMemoryChannel> mChannel;
+  /// The ring only supports one sender at a time
+  std::mutex mSendMutex;
+  RealTimeControlBuffer mBuffer;
+  std::thread mUpdateListenerThread;
+
+  // These are listeners that get called when we finish replanning
+  std::vector<ReplanningListener> mReplannedListeners;
+};
+
+} // namespace realtime
+} // namespace dart
+
+#endif
@@ -1,6 +1,6 @@
 #include "dart/realtime/Millis.hpp"
 
-#include <chrono>
+#include <cmath>
 
 namespace dart {
 long timeSinceEpochMillis()
@@ -9,4 +9,69 @@ long timeSinceEpochMillis()
   return duration_cast<milliseconds>(system_clock::now().time_since_epoch())
       .count();
 }
-}
\ No newline at end of file
+
+int64_t steadyClockNanos()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+namespace realtime {
+
+TimePoint now()
+{
+  return std::chrono::time_point_cast<Duration>(Clock::now());
+}
+
+Duration secondsToDuration(s_t seconds)
+{
+  return Duration(static_cast<int64_t>(
+      std::llround(static_cast<double>(seconds) * 1e9)));
+}
+
+long toMillis(Duration duration)
+{
+  const int64_t nanosPerMilli = 1000000;
+  int64_t millis = duration.count() / nanosPerMilli;
+  if (duration.count() % nanosPerMilli != 0 && duration.count() < 0)
+    millis--;
+  return static_cast<long>(millis);
+}
+
+long toEpochMillis(TimePoint time)
+{
+  Duration wallClockOffset
+      = std::chrono::system_clock::now().time_since_epoch()
+        - now().time_since_epoch();
+  return toMillis(time.time_since_epoch() + wallClockOffset);
+}
+
+TimePoint fromEpochMillis(long millis)
+{
+  Duration wallClockOffset
+      = std::chrono::system_clock::now().time_since_epoch()
+        - now().time_since_epoch();
+  return TimePoint(std::chrono::milliseconds(millis) - wallClockOffset);
+}
+
+int floorSteps(Duration elapsed, Duration step)
+{
+  int64_t steps = elapsed.count() / step.count();
+  // Integer division rounds towards zero, so negative times need to go down
+  // one more
+  if (elapsed.count() % step.count() != 0 && elapsed.count() < 0)
+    steps--;
+  return static_cast<int>(steps);
+}
+
+int ceilSteps(Duration elapsed, Duration step)
+{
+  int64_t steps = elapsed.count() / step.count();
+  if (elapsed.count() % step.count() != 0 && elapsed.count() > 0)
+    steps++;
+  return static_cast<int>(steps);
+}
+
+} // namespace realtime
+} // namespace dart
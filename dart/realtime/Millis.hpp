@@ -1,8 +1,53 @@
 #ifndef DART_REALTIME_MILLIS
 #define DART_REALTIME_MILLIS
 
+#include <chrono>
+#include <cstdint>
+
+#include "dart/math/MathTypes.hpp"
+
 namespace dart {
 long timeSinceEpochMillis();
+
+/// Nanoseconds on the monotonic steady clock. Unlike timeSinceEpochMillis()
+/// this never jumps when the wall clock is adjusted, so it's the one to use
+/// for measuring durations and scheduling deadlines. The epoch is arbitrary,
+/// so only differences between two readings are meaningful.
+int64_t steadyClockNanos();
+
+namespace realtime {
+
+/// Everything in realtime/ is timed on the steady clock, in nanoseconds, so
+/// control can run faster than a millisecond per step and never jumps when
+/// the wall clock is adjusted.
+using Clock = std::chrono::steady_clock;
+using Duration = std::chrono::nanoseconds;
+using TimePoint = std::chrono::time_point<Clock, Duration>;
+
+/// The current time on the realtime clock
+TimePoint now();
+
+/// This converts a length of time in seconds, like World::getTimeStep(), to
+/// the nearest Duration
+Duration secondsToDuration(s_t seconds);
+
+/// This rounds a Duration down to whole milliseconds
+long toMillis(Duration duration);
+
+/// The Python bindings and the gRPC wire format predate TimePoint, and take
+/// wall clock milliseconds since the epoch, like timeSinceEpochMillis(). These
+/// convert to and from them, using the current offset between the two clocks.
+long toEpochMillis(TimePoint time);
+TimePoint fromEpochMillis(long millis);
+
+/// The number of whole `step`s that have passed in `elapsed`, rounded down.
+/// Negative if `elapsed` is.
+int floorSteps(Duration elapsed, Duration step);
+
+/// The number of `step`s needed to cover `elapsed`, rounded up
+int ceilSteps(Duration elapsed, Duration step);
+
+} // namespace realtime
 } // namespace dart
 
-#endif
\ No newline at end of file
+#endif
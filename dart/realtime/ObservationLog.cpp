@@ -7,13 +7,14 @@
 namespace dart {
 namespace realtime {
 
-Observation::Observation(long time, Eigen::VectorXs pos, Eigen::VectorXs vel)
+Observation::Observation(
+    TimePoint time, Eigen::VectorXs pos, Eigen::VectorXs vel)
   : time(time), pos(pos), vel(vel)
 {
 }
 
 ObservationLog::ObservationLog(
-    long startTime,
+    TimePoint startTime,
     Eigen::VectorXs initialPos,
     Eigen::VectorXs initialVel,
     Eigen::VectorXs initialMass)
@@ -23,7 +24,7 @@ ObservationLog::ObservationLog(
 }
 
 void ObservationLog::observe(
-    long time,
+    TimePoint time,
     Eigen::VectorXs pos,
     Eigen::VectorXs vel,
     // TODO(keenon): Support mass observations
@@ -32,7 +33,7 @@ void ObservationLog::observe(
   mObservations.emplace_back(time, pos, vel);
 }
 
-Observation ObservationLog::getClosestObservationBefore(long time)
+Observation ObservationLog::getClosestObservationBefore(TimePoint time)
 {
   for (int i = mObservations.size() - 1; i >= 0; i--)
   {
@@ -50,7 +51,7 @@ Eigen::VectorXs ObservationLog::getMass()
   return mMass;
 }
 
-void ObservationLog::discardBefore(long time)
+void ObservationLog::discardBefore(TimePoint time)
 {
   int discardBeforeIndex = -1;
   for (int i = mObservations.size() - 1; i >= 0; i--)
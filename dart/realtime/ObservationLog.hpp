@@ -6,38 +6,40 @@
 #include <Eigen/Dense>
 
 #include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
+
 namespace dart {
 namespace realtime {
 
 struct Observation
 {
-  long time;
+  TimePoint time;
   Eigen::VectorXs pos;
   Eigen::VectorXs vel;
 
-  Observation(long time, Eigen::VectorXs pos, Eigen::VectorXs vel);
+  Observation(TimePoint time, Eigen::VectorXs pos, Eigen::VectorXs vel);
 };
 
 class ObservationLog
 {
 public:
   ObservationLog(
-      long startTime,
+      TimePoint startTime,
       Eigen::VectorXs initialPos,
       Eigen::VectorXs initialVel,
       Eigen::VectorXs initialMass);
 
   void observe(
-      long time,
+      TimePoint time,
       Eigen::VectorXs pos,
       Eigen::VectorXs vel,
       Eigen::VectorXs mass);
 
-  Observation getClosestObservationBefore(long time);
+  Observation getClosestObservationBefore(TimePoint time);
 
   Eigen::VectorXs getMass();
 
-  void discardBefore(long time);
+  void discardBefore(TimePoint time);
 
 protected:
   int mDofs;
@@ -8,33 +8,34 @@ namespace dart {
 namespace realtime {
 
 RealTimeControlBuffer::RealTimeControlBuffer(
-    int forceDim, int steps, int millisPerStep)
+    int forceDim, int steps, Duration stepDuration)
   : mForceDim(forceDim),
     mNumSteps(steps),
-    mMillisPerStep(millisPerStep),
+    mStepDuration(stepDuration),
     mActiveBuffer(UNINITIALIZED),
     mBufA(Eigen::MatrixXs::Zero(forceDim, steps)),
     mBufB(Eigen::MatrixXs::Zero(forceDim, steps)),
-    mControlLog(ControlLog(forceDim, millisPerStep))
+    mControlLog(ControlLog(forceDim, stepDuration))
 {
 }
 
 /// Gets the force at a given timestep
-Eigen::VectorXs RealTimeControlBuffer::getPlannedForce(long time, bool dontLog)
+Eigen::VectorXs RealTimeControlBuffer::getPlannedForce(
+    TimePoint time, bool dontLog)
 {
   if (mActiveBuffer == UNINITIALIZED)
   {
     // Unitialized, default to no force
     return Eigen::VectorXs::Zero(mForceDim);
   }
-  int elapsed = time - mLastWroteBufferAt;
-  if (elapsed < 0)
+  Duration elapsed = time - mLastWroteBufferAt;
+  if (elapsed < Duration::zero())
   {
     // Asking for some time in the past, default to no force
     return Eigen::VectorXs::Zero(mForceDim);
   }
 
-  int step = (int)floor((s_t)elapsed / mMillisPerStep);
+  int step = floorSteps(elapsed, mStepDuration);
   if (step < mNumSteps)
   {
     if (mActiveBuffer == BUF_A)
@@ -69,7 +70,7 @@ Eigen::VectorXs RealTimeControlBuffer::getPlannedForce(long time, bool dontLog)
 /// runs. It supports walking off the end of known future, and assumes 0
 /// forces in all extrapolation.
 void RealTimeControlBuffer::getPlannedForcesStartingAt(
-    long start, Eigen::Ref<Eigen::MatrixXs> forcesOut)
+    TimePoint start, Eigen::Ref<Eigen::MatrixXs> forcesOut)
 {
   if (mActiveBuffer == UNINITIALIZED)
   {
@@ -77,14 +78,14 @@ void RealTimeControlBuffer::getPlannedForcesStartingAt(
     forcesOut.setZero();
     return;
   }
-  int elapsed = start - mLastWroteBufferAt;
-  if (elapsed < 0)
+  Duration elapsed = start - mLastWroteBufferAt;
+  if (elapsed < Duration::zero())
   {
     // Asking for some time in the past, default to 0
     forcesOut.setZero();
     return;
   }
-  int startStep = (int)floor((s_t)elapsed / mMillisPerStep);
+  int startStep = floorSteps(elapsed, mStepDuration);
   if (startStep < mNumSteps)
   {
     // Copy the appropriate block of our active buffer to the forcesOut block
@@ -113,12 +114,11 @@ void RealTimeControlBuffer::getPlannedForcesStartingAt(
 /// This swaps in a new buffer of forces. The assumption is that "startAt" is
 /// before "now", because we'll erase old data in this process.
 void RealTimeControlBuffer::setControlForcePlan(
-    long startAt, long now, Eigen::MatrixXs forces)
+    TimePoint startAt, TimePoint now, Eigen::MatrixXs forces)
 {
   if (startAt > now)
   {
-    long padMillis = startAt - now;
-    int padSteps = (int)floor((s_t)padMillis / mMillisPerStep);
+    int padSteps = floorSteps(startAt - now, mStepDuration);
     // If we're trying to set the force plan too far out in the future, this
     // whole exercise is a no-op
     if (padSteps >= mNumSteps)
@@ -126,8 +126,7 @@ void RealTimeControlBuffer::setControlForcePlan(
       return;
     }
     // Otherwise, we're going to copy part of the existing plan
-    int currentStep
-        = (int)floor((s_t)(now - mLastWroteBufferAt) / mMillisPerStep);
+    int currentStep = floorSteps(now - mLastWroteBufferAt, mStepDuration);
     int remainingSteps = mNumSteps - currentStep;
     mLastWroteBufferAt = now;
 
@@ -205,23 +204,23 @@ void RealTimeControlBuffer::setControlForcePlan(
 /// been applying forces from the buffer since the last state that we fully
 /// observed.
 void RealTimeControlBuffer::estimateWorldStateAt(
-    std::shared_ptr<simulation::World> world, ObservationLog* log, long time)
+    std::shared_ptr<simulation::World> world,
+    ObservationLog* log,
+    TimePoint time)
 {
   Observation obs = log->getClosestObservationBefore(time);
-  int elapsedSinceObservation = time - obs.time;
-  if (elapsedSinceObservation < 0)
+  Duration elapsedSinceObservation = time - obs.time;
+  if (elapsedSinceObservation < Duration::zero())
   {
     assert(
-        elapsedSinceObservation >= 0
+        elapsedSinceObservation >= Duration::zero()
         && "estimateWorldStateAt() cannot ask far a time before the earliest available observation.");
   }
   int stepsSinceObservation
-      = (int)floor((s_t)elapsedSinceObservation / mMillisPerStep);
+      = floorSteps(elapsedSinceObservation, mStepDuration);
   /*
-  std::cout << "RealTimeControlBuffer time: " << time << std::endl;
-  std::cout << "RealTimeControlBuffer obs.time: " << obs.time << std::endl;
   std::cout << "RealTimeControlBuffer elapsedSinceObservation: "
-            << elapsedSinceObservation << std::endl;
+            << elapsedSinceObservation.count() << "ns" << std::endl;
   std::cout << "RealTimeControlBuffer stepsSinceObservation: "
             << stepsSinceObservation << std::endl;
   */
@@ -231,7 +230,7 @@ void RealTimeControlBuffer::estimateWorldStateAt(
   world->setMasses(log->getMass());
   for (int i = 0; i < stepsSinceObservation; i++)
   {
-    long at = obs.time + i * mMillisPerStep;
+    TimePoint at = obs.time + i * mStepDuration;
     // In the future, project assuming planned forces
     if (at > mControlLog.last())
     {
@@ -249,18 +248,18 @@ void RealTimeControlBuffer::estimateWorldStateAt(
 /// This rescales the timestep size. This is useful because larger timesteps
 /// mean fewer time steps per real unit of time, and thus we can run our
 /// optimization slower and still keep up with real life.
-void RealTimeControlBuffer::setMillisPerStep(int newMillisPerStep)
+void RealTimeControlBuffer::setStepDuration(Duration newStepDuration)
 {
-  mControlLog.setMillisPerStep(newMillisPerStep);
+  mControlLog.setStepDuration(newStepDuration);
   if (mActiveBuffer == BUF_A)
   {
-    rescaleBuffer(mBufA, mMillisPerStep, newMillisPerStep);
+    rescaleBuffer(mBufA, mStepDuration, newStepDuration);
   }
   else if (mActiveBuffer == BUF_B)
   {
-    rescaleBuffer(mBufB, mMillisPerStep, newMillisPerStep);
+    rescaleBuffer(mBufB, mStepDuration, newStepDuration);
   }
-  mMillisPerStep = newMillisPerStep;
+  mStepDuration = newStepDuration;
 }
 
 /// This changes the number of steps. Fewer steps mean we can compute a buffer
@@ -289,18 +288,18 @@ void RealTimeControlBuffer::setNumSteps(int newNumSteps)
   mBufB = newBuf;
 }
 
-/// This returns the number of millis we have left in the plan after `time`.
-/// This can be a negative number.
-long RealTimeControlBuffer::getPlanBufferMillisAfter(long time)
+/// This returns how much time we have left in the plan after `time`. This can
+/// be negative.
+Duration RealTimeControlBuffer::getPlanBufferAfter(TimePoint time)
 {
-  long planEnd = mLastWroteBufferAt + (mNumSteps * mMillisPerStep);
+  TimePoint planEnd = mLastWroteBufferAt + mNumSteps * mStepDuration;
   return planEnd - time;
 }
 
 /// This is useful when we're replicating a log across a network boundary,
 /// which comes up in distributed MPC.
 void RealTimeControlBuffer::manuallyRecordObservedForce(
-    long time, Eigen::VectorXs observation)
+    TimePoint time, Eigen::VectorXs observation)
 {
   mControlLog.record(time, observation);
 }
@@ -308,26 +307,24 @@ void RealTimeControlBuffer::manuallyRecordObservedForce(
 /// This is a helper to rescale the timestep size of a buffer while leaving
 /// the data otherwise unchanged.
 void RealTimeControlBuffer::rescaleBuffer(
-    Eigen::MatrixXs& buf, int oldMillisPerStep, int newMillisPerStep)
+    Eigen::MatrixXs& buf, Duration oldStepDuration, Duration newStepDuration)
 {
   Eigen::MatrixXs newBuf = Eigen::MatrixXs::Zero(buf.rows(), buf.cols());
 
   for (int i = mNumSteps - 1; i >= 0; i--)
   {
-    if (newMillisPerStep > oldMillisPerStep)
+    if (newStepDuration > oldStepDuration)
     {
       // If we're increasing the step size, there's more than one old column per
       // new column, so map from old to new
-      int newCol = static_cast<int>(
-          floor(static_cast<s_t>(i * oldMillisPerStep) / newMillisPerStep));
+      int newCol = floorSteps(i * oldStepDuration, newStepDuration);
       newBuf.col(newCol) = buf.col(i);
     }
     else
     {
       // If we're increasing the step size, there's more than one new column per
       // old column, so map from new to old
-      int oldCol = static_cast<int>(
-          floor(static_cast<s_t>(i * newMillisPerStep) / oldMillisPerStep));
+      int oldCol = floorSteps(i * newStepDuration, oldStepDuration);
       newBuf.col(i) = buf.col(oldCol);
     }
   }
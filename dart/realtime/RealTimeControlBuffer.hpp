@@ -8,6 +8,7 @@
 
 #include "dart/math/MathTypes.hpp"
 #include "dart/realtime/ControlLog.hpp"
+#include "dart/realtime/Millis.hpp"
 #include "dart/realtime/ObservationLog.hpp"
 
 namespace dart {
@@ -27,58 +28,64 @@ enum BufferSwitchEnum
 class RealTimeControlBuffer
 {
 public:
-  RealTimeControlBuffer(int forceDim, int steps, int millisPerStep);
+  RealTimeControlBuffer(int forceDim, int steps, Duration stepDuration);
 
   /// Gets the force at a given timestep. This HAS SIDE EFFECTS! We actually
   /// keep track of what forces were read, and assume that they're "immediately"
   /// applied to the real world after they're read.
-  Eigen::VectorXs getPlannedForce(long time, bool dontLog = false);
+  Eigen::VectorXs getPlannedForce(TimePoint time, bool dontLog = false);
 
   /// This gets planned forces starting at `start`, and continuing for the
   /// length of our buffer size `mSteps`. This is useful for initializing MPC
   /// runs. It supports walking off the end of known future, and assumes 0
   /// forces in all extrapolation.
   void getPlannedForcesStartingAt(
-      long start, Eigen::Ref<Eigen::MatrixXs> forcesOut);
+      TimePoint start, Eigen::Ref<Eigen::MatrixXs> forcesOut);
 
   /// This swaps in a new buffer of forces. If "startAt" is after "now", this
   /// will copy enough of the current buffer into our updated buffer to keep the
   /// current trajectory.
-  void setControlForcePlan(long startAt, long now, Eigen::MatrixXs forces);
+  void setControlForcePlan(
+      TimePoint startAt, TimePoint now, Eigen::MatrixXs forces);
 
   /// This retrieves the state of the world at a given time, assuming that we've
   /// been applying forces from the buffer since the last state that we fully
   /// observed.
   void estimateWorldStateAt(
-      std::shared_ptr<simulation::World> world, ObservationLog* log, long time);
+      std::shared_ptr<simulation::World> world,
+      ObservationLog* log,
+      TimePoint time);
 
   /// This rescales the timestep size. This is useful because larger timesteps
   /// mean fewer time steps per real unit of time, and thus we can run our
   /// optimization slower and still keep up with real life.
-  void setMillisPerStep(int millisPerStep);
+  void setStepDuration(Duration stepDuration);
 
   /// This changes the number of steps. Fewer steps mean we can compute a buffer
   /// faster, but it also means we have less time to compute the buffer. This
   /// probably has a nonlinear effect on runtime.
   void setNumSteps(int numSteps);
 
-  /// This returns the number of millis we have left in the plan after `time`.
-  /// This can be a negative number.
-  long getPlanBufferMillisAfter(long time);
+  /// This returns how much time we have left in the plan after `time`. This
+  /// can be negative.
+  Duration getPlanBufferAfter(TimePoint time);
 
   /// This is useful when we're replicating a log across a network boundary,
   /// which comes up in distributed MPC.
-  void manuallyRecordObservedForce(long time, Eigen::VectorXs observation);
+  void manuallyRecordObservedForce(
+      TimePoint time, Eigen::VectorXs observation);
 
 protected:
   int mForceDim;
   int mNumSteps;
-  int mMillisPerStep;
+  Duration mStepDuration;
 
   /// This is a helper to rescale the timestep size of a buffer while leaving
   /// the data otherwise unchanged.
   void rescaleBuffer(
-      Eigen::MatrixXs& buf, int oldMillisPerStep, int newMillisPerStep);
+      Eigen::MatrixXs& buf,
+      Duration oldStepDuration,
+      Duration newStepDuration);
 
   /// This controls which of our buffers is currently active
   BufferSwitchEnum mActiveBuffer;
@@ -90,7 +97,7 @@ protected:
   Eigen::MatrixXs mBufB;
 
   /// This is the time when the last buffer was written to
-  long mLastWroteBufferAt;
+  TimePoint mLastWroteBufferAt;
 
   /// This keeps a log of all the control outputs we send, so that we can get
   /// the current state on request, even if we last had an observation a while
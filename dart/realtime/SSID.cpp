@@ -19,19 +19,19 @@ namespace realtime {
 SSID::SSID(
     std::shared_ptr<simulation::World> world,
     std::shared_ptr<trajectory::LossFn> loss,
-    int planningHistoryMillis,
+    Duration planningHistory,
     int sensorDim)
   : mRunning(false),
     mWorld(world),
     mLoss(loss),
-    mPlanningHistoryMillis(planningHistoryMillis),
+    mPlanningHistory(planningHistory),
     mSensorDim(sensorDim),
     mSensorLog(VectorLog(sensorDim)),
     mControlLog(VectorLog(world->getNumDofs()))
 {
   int dofs = world->getNumDofs();
   mInitialPosEstimator
-      = [dofs](Eigen::MatrixXs /* sensors */, long /* time */) {
+      = [dofs](Eigen::MatrixXs /* sensors */, TimePoint /* time */) {
           return Eigen::VectorXs::Zero(dofs);
         };
 
@@ -80,7 +80,8 @@ void SSID::setProblem(std::shared_ptr<trajectory::Problem> problem)
 /// This registers a function that can be used to estimate the initial state
 /// for the inference system from recent sensor history and the timestamp
 void SSID::setInitialPosEstimator(
-    std::function<Eigen::VectorXs(Eigen::MatrixXs, long)> initialPosEstimator)
+    std::function<Eigen::VectorXs(Eigen::MatrixXs, TimePoint)>
+        initialPosEstimator)
 {
   mInitialPosEstimator = initialPosEstimator;
 }
@@ -94,24 +95,24 @@ std::shared_ptr<trajectory::Problem> SSID::getProblem()
 /// This logs that the sensor output is a specific vector now
 void SSID::registerSensorsNow(Eigen::VectorXs sensors)
 {
-  return registerSensors(timeSinceEpochMillis(), sensors);
+  return registerSensors(now(), sensors);
 }
 
 /// This logs that the controls are a specific vector now
 void SSID::registerControlsNow(Eigen::VectorXs controls)
 {
-  return registerControls(timeSinceEpochMillis(), controls);
+  return registerControls(now(), controls);
 }
 
 /// This logs that the sensor output was a specific vector at a specific
 /// moment
-void SSID::registerSensors(long now, Eigen::VectorXs sensors)
+void SSID::registerSensors(TimePoint now, Eigen::VectorXs sensors)
 {
   mSensorLog.record(now, sensors);
 }
 
 /// This logs that our controls were this value at this time
-void SSID::registerControls(long now, Eigen::VectorXs controls)
+void SSID::registerControls(TimePoint now, Eigen::VectorXs controls)
 {
   mControlLog.record(now, controls);
 }
@@ -135,13 +136,12 @@ void SSID::stop()
 }
 
 /// This runs inference to find mutable values, starting at `startTime`
-void SSID::runInference(long startTime)
+void SSID::runInference(TimePoint startTime)
 {
-  long startComputeWallTime = timeSinceEpochMillis();
+  TimePoint startCompute = now();
 
-  int millisPerStep = static_cast<int>(ceil(mWorld->getTimeStep() * 1000.0));
-  int steps = static_cast<int>(
-      ceil(static_cast<s_t>(mPlanningHistoryMillis) / millisPerStep));
+  Duration stepDuration = secondsToDuration(mWorld->getTimeStep());
+  int steps = ceilSteps(mPlanningHistory, stepDuration);
 
   if (!mProblem)
   {
@@ -154,7 +154,7 @@ void SSID::runInference(long startTime)
   // Every turn, we need to pin all the forces
 
   Eigen::MatrixXs forceHistory = mControlLog.getValues(
-      startTime - mPlanningHistoryMillis, steps, millisPerStep);
+      startTime - mPlanningHistory, steps, stepDuration);
   for (int i = 0; i < steps; i++)
   {
     mProblem->pinForce(i, forceHistory.col(i));
@@ -163,7 +163,7 @@ void SSID::runInference(long startTime)
   // We also need to set all the sensor history into metadata
 
   Eigen::MatrixXs sensorHistory = mSensorLog.getValues(
-      startTime - mPlanningHistoryMillis, steps, millisPerStep);
+      startTime - mPlanningHistory, steps, stepDuration);
   mProblem->setMetadata("forces", forceHistory);
   mProblem->setMetadata("sensors", sensorHistory);
 
@@ -173,7 +173,7 @@ void SSID::runInference(long startTime)
 
   mSolution = mOptimizer->optimize(mProblem.get());
 
-  long computeDurationWallTime = timeSinceEpochMillis() - startComputeWallTime;
+  Duration computeDuration = now() - startCompute;
 
   const trajectory::TrajectoryRollout* cache
       = mProblem->getRolloutCache(mWorld);
@@ -184,15 +184,18 @@ void SSID::runInference(long startTime)
 
   for (auto listener : mInferListeners)
   {
-    listener(startTime, pos, vel, mass, computeDurationWallTime);
+    listener(startTime, pos, vel, mass, computeDuration);
   }
 }
 
 /// This registers a listener to get called when we finish replanning
 void SSID::registerInferListener(
-    std::function<
-        void(long, Eigen::VectorXs, Eigen::VectorXs, Eigen::VectorXs, long)>
-        inferListener)
+    std::function<void(
+        TimePoint,
+        Eigen::VectorXs,
+        Eigen::VectorXs,
+        Eigen::VectorXs,
+        Duration)> inferListener)
 {
   mInferListeners.push_back(inferListener);
 }
@@ -210,13 +213,13 @@ void SSID::optimizationThreadLoop()
 
   while (mRunning)
   {
-    long startTime = timeSinceEpochMillis();
-    if (mControlLog.availableHistoryBefore(startTime) > mPlanningHistoryMillis)
+    TimePoint startTime = now();
+    if (mControlLog.availableHistoryBefore(startTime) > mPlanningHistory)
     {
       std::cout << "Running inference" << std::endl;
       runInference(startTime);
     }
-    // long endTime = timeSinceEpochMillis();
+    // TimePoint endTime = now();
   }
 }
 
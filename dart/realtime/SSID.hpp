@@ -7,6 +7,7 @@
 #include <Eigen/Dense>
 
 #include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
 #include "dart/realtime/VectorLog.hpp"
 
 namespace dart {
@@ -30,7 +31,7 @@ public:
   SSID(
       std::shared_ptr<simulation::World> world,
       std::shared_ptr<trajectory::LossFn> loss,
-      int planningHistoryMillis,
+      Duration planningHistory,
       int sensorDim);
 
   /// This updates the loss function that we're going to move in real time to
@@ -53,7 +54,7 @@ public:
   /// This registers a function that can be used to estimate the initial state
   /// for the inference system from recent sensor history and the timestamp
   void setInitialPosEstimator(
-      std::function<Eigen::VectorXs(Eigen::MatrixXs, long)>
+      std::function<Eigen::VectorXs(Eigen::MatrixXs, TimePoint)>
           initialPosEstimator);
 
   /// This returns the current problem definition that MPC is using
@@ -67,10 +68,10 @@ public:
 
   /// This logs that the sensor output was a specific vector at a specific
   /// moment
-  void registerSensors(long now, Eigen::VectorXs sensors);
+  void registerSensors(TimePoint now, Eigen::VectorXs sensors);
 
   /// This logs that our controls were this value at this time
-  void registerControls(long now, Eigen::VectorXs controls);
+  void registerControls(TimePoint now, Eigen::VectorXs controls);
 
   /// This starts our main thread and begins running optimizations
   void start();
@@ -79,13 +80,16 @@ public:
   void stop();
 
   /// This runs inference to find mutable values, starting at `startTime`
-  void runInference(long startTime);
+  void runInference(TimePoint startTime);
 
   /// This registers a listener to get called when we finish replanning
   void registerInferListener(
-      std::function<
-          void(long, Eigen::VectorXs, Eigen::VectorXs, Eigen::VectorXs, long)>
-          inferListener);
+      std::function<void(
+          TimePoint,
+          Eigen::VectorXs,
+          Eigen::VectorXs,
+          Eigen::VectorXs,
+          Duration)> inferListener);
 
 protected:
   /// This is the function for the optimization thread to run when we're live
@@ -94,7 +98,7 @@ protected:
   bool mRunning;
   std::shared_ptr<simulation::World> mWorld;
   std::shared_ptr<trajectory::LossFn> mLoss;
-  int mPlanningHistoryMillis;
+  Duration mPlanningHistory;
   int mSensorDim;
   VectorLog mSensorLog;
   VectorLog mControlLog;
@@ -106,12 +110,13 @@ protected:
 
   // These are listeners that get called when we finish replanning
   std::vector<std::function<void(
-      long, Eigen::VectorXs, Eigen::VectorXs, Eigen::VectorXs, long)> >
+      TimePoint, Eigen::VectorXs, Eigen::VectorXs, Eigen::VectorXs, Duration)> >
       mInferListeners;
 
   // This is the function that estimates our initial state before launching
   // learning
-  std::function<Eigen::VectorXs(Eigen::MatrixXs, long)> mInitialPosEstimator;
+  std::function<Eigen::VectorXs(Eigen::MatrixXs, TimePoint)>
+      mInitialPosEstimator;
 };
 
 } // namespace realtime
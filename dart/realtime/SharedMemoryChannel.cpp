@@ -0,0 +1,537 @@
+#include "dart/realtime/SharedMemoryChannel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "dart/realtime/Millis.hpp"
+#include "dart/trajectory/TrajectoryRollout.hpp"
+
+namespace dart {
+namespace realtime {
+
+namespace {
+
+constexpr uint32_t CHANNEL_MAGIC = 0x4d504353; // "MPCS"
+constexpr uint32_t CHANNEL_VERSION = 2;
+constexpr uint32_t RING_CAPACITY = 64;
+constexpr std::size_t CACHE_LINE = 64;
+
+// std::atomic<T>::is_always_lock_free is C++17, and this builds as C++14
+static_assert(
+    sizeof(uint32_t) == sizeof(unsigned int) && ATOMIC_INT_LOCK_FREE == 2,
+    "Shared memory atomics must be lock free to work across processes");
+
+/// The fixed part of each ring slot, followed by pos, vel and mass
+struct SlotHeader
+{
+  int32_t type;
+  int32_t padding;
+  /// Nanoseconds since the realtime clock's epoch
+  int64_t time;
+};
+
+/// The fixed part of the plan, followed by poses, vels and forces (column
+/// major, dofs x steps each) and then masses
+struct PlanHeader
+{
+  /// Nanoseconds since the realtime clock's epoch
+  int64_t startTime;
+  int64_t replanDurationNanos;
+  int32_t steps;
+  int32_t padding;
+};
+
+std::size_t roundUp(std::size_t size)
+{
+  return (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+std::size_t getSlotSize(int dofs, int massDim)
+{
+  return roundUp(sizeof(SlotHeader) + sizeof(double) * (2 * dofs + massDim));
+}
+
+/// Blocks while `*word == expected`, for at most `timeoutNanos`. This can
+/// return early, so callers always recheck their condition.
+void futexWait(
+    std::atomic<uint32_t>* word, uint32_t expected, int64_t timeoutNanos)
+{
+#ifdef __linux__
+  struct timespec timeout;
+  timeout.tv_sec = static_cast<time_t>(timeoutNanos / 1000000000);
+  timeout.tv_nsec = static_cast<long>(timeoutNanos % 1000000000);
+  // Not FUTEX_WAIT_PRIVATE, because the waker may be another process
+  syscall(
+      SYS_futex,
+      reinterpret_cast<uint32_t*>(word),
+      FUTEX_WAIT,
+      expected,
+      &timeout,
+      nullptr,
+      0);
+#else
+  if (word->load(std::memory_order_acquire) == expected)
+  {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(
+        std::min<int64_t>(timeoutNanos, 50000)));
+  }
+#endif
+}
+
+/// Wakes everyone blocked in futexWait() on `word`
+void futexWake(std::atomic<uint32_t>* word)
+{
+#ifdef __linux__
+  syscall(
+      SYS_futex,
+      reinterpret_cast<uint32_t*>(word),
+      FUTEX_WAKE,
+      INT_MAX,
+      nullptr,
+      nullptr,
+      0);
+#else
+  (void)word;
+#endif
+}
+
+void writeVector(double* out, const Eigen::VectorXs& vec, int size)
+{
+  const int n = std::min(size, static_cast<int>(vec.size()));
+  for (int i = 0; i < n; i++)
+    out[i] = static_cast<double>(vec(i));
+  for (int i = n; i < size; i++)
+    out[i] = 0.0;
+}
+
+} // namespace
+
+/// The start of the mapping. Each atomic gets its own cache line, so the
+/// client and server don't bounce lines back and forth between them.
+struct SharedMemoryChannel::Header
+{
+  uint32_t magic;
+  uint32_t version;
+  int32_t dofs;
+  int32_t massDim;
+  int32_t steps;
+  int64_t stepNanos;
+
+  alignas(CACHE_LINE) std::atomic<uint32_t> closed;
+  /// Only the client writes this. The server waits on it.
+  alignas(CACHE_LINE) std::atomic<uint32_t> writeIndex;
+  /// Only the server writes this
+  alignas(CACHE_LINE) std::atomic<uint32_t> readIndex;
+  /// Odd while the server is writing a plan. The client waits on it.
+  alignas(CACHE_LINE) std::atomic<uint32_t> planSequence;
+};
+
+//==============================================================================
+std::shared_ptr<SharedMemoryChannel> SharedMemoryChannel::createAnonymous(
+    int dofs, int massDim, int steps, Duration stepDuration)
+{
+  const std::size_t size = getMappingSize(dofs, massDim, steps);
+  void* mapping = mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (mapping == MAP_FAILED)
+  {
+    std::cout << "SharedMemoryChannel failed to map " << size
+              << " bytes: " << strerror(errno) << std::endl;
+    return nullptr;
+  }
+  initialize(mapping, dofs, massDim, steps, stepDuration);
+  return std::shared_ptr<SharedMemoryChannel>(
+      new SharedMemoryChannel(mapping, size, ""));
+}
+
+//==============================================================================
+std::shared_ptr<SharedMemoryChannel> SharedMemoryChannel::create(
+    const std::string& name,
+    int dofs,
+    int massDim,
+    int steps,
+    Duration stepDuration,
+    bool replaceExisting)
+{
+  const std::size_t size = getMappingSize(dofs, massDim, steps);
+
+  // We can't tell a name left behind by a server that crashed from one that a
+  // live server is using, so we only clear it out if we've been told to
+  if (replaceExisting)
+    shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    const int error = errno;
+    std::cout << "SharedMemoryChannel failed to create \"" << name
+              << "\": " << strerror(error) << std::endl;
+    if (error == EEXIST)
+    {
+      std::cout << "If no server is using it anymore, pass replaceExisting "
+                   "to take it over"
+                << std::endl;
+    }
+    return nullptr;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+  {
+    std::cout << "SharedMemoryChannel failed to size \"" << name
+              << "\": " << strerror(errno) << std::endl;
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void* mapping
+      = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cout << "SharedMemoryChannel failed to map \"" << name
+              << "\": " << strerror(errno) << std::endl;
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+
+  initialize(mapping, dofs, massDim, steps, stepDuration);
+  return std::shared_ptr<SharedMemoryChannel>(
+      new SharedMemoryChannel(mapping, size, name));
+}
+
+//==============================================================================
+std::shared_ptr<SharedMemoryChannel> SharedMemoryChannel::open(
+    const std::string& name)
+{
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0)
+  {
+    std::cout << "SharedMemoryChannel failed to open \"" << name
+              << "\": " << strerror(errno) << std::endl;
+    return nullptr;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0
+      || static_cast<std::size_t>(info.st_size) < sizeof(Header))
+  {
+    std::cout << "SharedMemoryChannel \"" << name
+              << "\" isn't a channel, or isn't initialized yet" << std::endl;
+    ::close(fd);
+    return nullptr;
+  }
+  const std::size_t size = static_cast<std::size_t>(info.st_size);
+  void* mapping
+      = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cout << "SharedMemoryChannel failed to map \"" << name
+              << "\": " << strerror(errno) << std::endl;
+    return nullptr;
+  }
+
+  const Header* header = static_cast<const Header*>(mapping);
+  if (header->magic != CHANNEL_MAGIC || header->version != CHANNEL_VERSION
+      || size < getMappingSize(header->dofs, header->massDim, header->steps))
+  {
+    std::cout << "SharedMemoryChannel \"" << name
+              << "\" has an incompatible layout" << std::endl;
+    munmap(mapping, size);
+    return nullptr;
+  }
+
+  return std::shared_ptr<SharedMemoryChannel>(
+      new SharedMemoryChannel(mapping, size, ""));
+}
+
+//==============================================================================
+SharedMemoryChannel::SharedMemoryChannel(
+    void* mapping, std::size_t size, const std::string& name)
+  : mMapping(mapping),
+    mSize(size),
+    mHeader(static_cast<Header*>(mapping)),
+    mOwnedName(name)
+{
+}
+
+//==============================================================================
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+  munmap(mMapping, mSize);
+  if (!mOwnedName.empty())
+    shm_unlink(mOwnedName.c_str());
+}
+
+//==============================================================================
+void SharedMemoryChannel::initialize(
+    void* mapping,
+    int dofs,
+    int massDim,
+    int steps,
+    Duration stepDuration)
+{
+  Header* header = new (mapping) Header();
+  header->dofs = dofs;
+  header->massDim = massDim;
+  header->steps = steps;
+  header->stepNanos = stepDuration.count();
+  header->closed.store(0, std::memory_order_relaxed);
+  header->writeIndex.store(0, std::memory_order_relaxed);
+  header->readIndex.store(0, std::memory_order_relaxed);
+  header->planSequence.store(0, std::memory_order_relaxed);
+  header->version = CHANNEL_VERSION;
+  // The magic number goes last, so a process that opens the channel early
+  // sees it as not ready yet rather than half initialized
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = CHANNEL_MAGIC;
+}
+
+//==============================================================================
+std::size_t SharedMemoryChannel::getMappingSize(
+    int dofs, int massDim, int steps)
+{
+  return roundUp(sizeof(Header)) + RING_CAPACITY * getSlotSize(dofs, massDim)
+         + roundUp(
+             sizeof(PlanHeader)
+             + sizeof(double) * (3 * dofs * steps + massDim));
+}
+
+//==============================================================================
+unsigned char* SharedMemoryChannel::getSlot(uint32_t index) const
+{
+  return static_cast<unsigned char*>(mMapping) + roundUp(sizeof(Header))
+         + (index % RING_CAPACITY)
+               * getSlotSize(mHeader->dofs, mHeader->massDim);
+}
+
+//==============================================================================
+unsigned char* SharedMemoryChannel::getPlan() const
+{
+  return static_cast<unsigned char*>(mMapping) + roundUp(sizeof(Header))
+         + RING_CAPACITY * getSlotSize(mHeader->dofs, mHeader->massDim);
+}
+
+//==============================================================================
+int SharedMemoryChannel::getNumDofs() const
+{
+  return mHeader->dofs;
+}
+
+//==============================================================================
+int SharedMemoryChannel::getMassDim() const
+{
+  return mHeader->massDim;
+}
+
+//==============================================================================
+int SharedMemoryChannel::getNumSteps() const
+{
+  return mHeader->steps;
+}
+
+//==============================================================================
+Duration SharedMemoryChannel::getStepDuration() const
+{
+  return Duration(mHeader->stepNanos);
+}
+
+//==============================================================================
+bool SharedMemoryChannel::sendMessage(
+    SharedMemoryMessage::Type type,
+    TimePoint time,
+    const Eigen::VectorXs& pos,
+    const Eigen::VectorXs& vel,
+    const Eigen::VectorXs& mass)
+{
+  if (isClosed())
+    return false;
+
+  const uint32_t write = mHeader->writeIndex.load(std::memory_order_relaxed);
+  const uint32_t read = mHeader->readIndex.load(std::memory_order_acquire);
+  if (write - read >= RING_CAPACITY)
+    return false;
+
+  unsigned char* slot = getSlot(write);
+  SlotHeader* slotHeader = reinterpret_cast<SlotHeader*>(slot);
+  slotHeader->type = static_cast<int32_t>(type);
+  slotHeader->time = time.time_since_epoch().count();
+  if (type == SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE)
+  {
+    const int dofs = mHeader->dofs;
+    double* data = reinterpret_cast<double*>(slot + sizeof(SlotHeader));
+    writeVector(data, pos, dofs);
+    writeVector(data + dofs, vel, dofs);
+    writeVector(data + 2 * dofs, mass, mHeader->massDim);
+  }
+
+  mHeader->writeIndex.store(write + 1, std::memory_order_release);
+  futexWake(&mHeader->writeIndex);
+  return true;
+}
+
+//==============================================================================
+bool SharedMemoryChannel::receiveMessage(
+    SharedMemoryMessage& message, Duration timeout)
+{
+  const TimePoint deadline = now() + timeout;
+  const uint32_t read = mHeader->readIndex.load(std::memory_order_relaxed);
+  while (mHeader->writeIndex.load(std::memory_order_acquire) == read)
+  {
+    if (isClosed())
+      return false;
+    const Duration remaining = deadline - now();
+    if (remaining <= Duration::zero())
+      return false;
+    futexWait(&mHeader->writeIndex, read, remaining.count());
+  }
+
+  const unsigned char* slot = getSlot(read);
+  const SlotHeader* slotHeader = reinterpret_cast<const SlotHeader*>(slot);
+  message.type = static_cast<SharedMemoryMessage::Type>(slotHeader->type);
+  message.time = TimePoint(Duration(slotHeader->time));
+  if (message.type == SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE)
+  {
+    const int dofs = mHeader->dofs;
+    const double* data
+        = reinterpret_cast<const double*>(slot + sizeof(SlotHeader));
+    message.pos = Eigen::Map<const Eigen::VectorXd>(data, dofs).cast<s_t>();
+    message.vel
+        = Eigen::Map<const Eigen::VectorXd>(data + dofs, dofs).cast<s_t>();
+    message.mass = Eigen::Map<const Eigen::VectorXd>(
+                       data + 2 * dofs, mHeader->massDim)
+                       .cast<s_t>();
+  }
+
+  // Hand the slot back to the client
+  mHeader->readIndex.store(read + 1, std::memory_order_release);
+  return true;
+}
+
+//==============================================================================
+void SharedMemoryChannel::publishPlan(
+    TimePoint startTime,
+    Duration replanDuration,
+    const trajectory::TrajectoryRollout* rollout)
+{
+  const int dofs = mHeader->dofs;
+  const int massDim = mHeader->massDim;
+  const Eigen::Ref<const Eigen::MatrixXs> poses = rollout->getPosesConst();
+  const Eigen::Ref<const Eigen::MatrixXs> vels = rollout->getVelsConst();
+  const Eigen::Ref<const Eigen::MatrixXs> forces
+      = rollout->getControlForcesConst();
+  const int steps
+      = std::min(mHeader->steps, static_cast<int>(forces.cols()));
+
+  // Odd sequence numbers tell the client that a write is in progress
+  const uint32_t sequence
+      = mHeader->planSequence.load(std::memory_order_relaxed);
+  mHeader->planSequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  unsigned char* plan = getPlan();
+  PlanHeader* planHeader = reinterpret_cast<PlanHeader*>(plan);
+  planHeader->startTime = startTime.time_since_epoch().count();
+  planHeader->replanDurationNanos = replanDuration.count();
+  planHeader->steps = steps;
+  double* data = reinterpret_cast<double*>(plan + sizeof(PlanHeader));
+  Eigen::Map<Eigen::MatrixXd>(data, dofs, steps)
+      = poses.leftCols(steps).cast<double>();
+  Eigen::Map<Eigen::MatrixXd>(data + dofs * steps, dofs, steps)
+      = vels.leftCols(steps).cast<double>();
+  Eigen::Map<Eigen::MatrixXd>(data + 2 * dofs * steps, dofs, steps)
+      = forces.leftCols(steps).cast<double>();
+  writeVector(data + 3 * dofs * steps, rollout->getMassesConst(), massDim);
+
+  mHeader->planSequence.store(sequence + 2, std::memory_order_release);
+  futexWake(&mHeader->planSequence);
+}
+
+//==============================================================================
+bool SharedMemoryChannel::waitForPlan(
+    uint32_t& lastSequence, SharedMemoryPlan& plan, Duration timeout)
+{
+  const TimePoint deadline = now() + timeout;
+  const int dofs = mHeader->dofs;
+  const int massDim = mHeader->massDim;
+
+  while (true)
+  {
+    if (isClosed())
+      return false;
+
+    const uint32_t before
+        = mHeader->planSequence.load(std::memory_order_acquire);
+    if (before == lastSequence || (before & 1u))
+    {
+      const Duration remaining = deadline - now();
+      if (remaining <= Duration::zero())
+        return false;
+      futexWait(&mHeader->planSequence, before, remaining.count());
+      continue;
+    }
+
+    const unsigned char* data = getPlan();
+    const PlanHeader* planHeader = reinterpret_cast<const PlanHeader*>(data);
+    const int steps = std::min(mHeader->steps, std::max(0, planHeader->steps));
+    plan.startTime = TimePoint(Duration(planHeader->startTime));
+    plan.replanDuration = Duration(planHeader->replanDurationNanos);
+    const double* values
+        = reinterpret_cast<const double*>(data + sizeof(PlanHeader));
+    plan.poses
+        = Eigen::Map<const Eigen::MatrixXd>(values, dofs, steps).cast<s_t>();
+    plan.vels = Eigen::Map<const Eigen::MatrixXd>(
+                    values + dofs * steps, dofs, steps)
+                    .cast<s_t>();
+    plan.forces = Eigen::Map<const Eigen::MatrixXd>(
+                      values + 2 * dofs * steps, dofs, steps)
+                      .cast<s_t>();
+    plan.masses = Eigen::Map<const Eigen::VectorXd>(
+                      values + 3 * dofs * steps, massDim)
+                      .cast<s_t>();
+
+    // If the server started another write while we were copying, what we
+    // copied may be torn, so go around again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (mHeader->planSequence.load(std::memory_order_relaxed) != before)
+      continue;
+
+    lastSequence = before;
+    return true;
+  }
+}
+
+//==============================================================================
+void SharedMemoryChannel::close()
+{
+  mHeader->closed.store(1, std::memory_order_release);
+  futexWake(&mHeader->writeIndex);
+  futexWake(&mHeader->planSequence);
+}
+
+//==============================================================================
+bool SharedMemoryChannel::isClosed() const
+{
+  return mHeader->closed.load(std::memory_order_acquire) != 0;
+}
+
+} // namespace realtime
+} // namespace dart
@@ -0,0 +1,171 @@
+#ifndef DART_REALTIME_SHARED_MEMORY_CHANNEL
+#define DART_REALTIME_SHARED_MEMORY_CHANNEL
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
+
+namespace dart {
+
+namespace trajectory {
+class TrajectoryRollout;
+}
+
+namespace realtime {
+
+/// A message from an MPC client to the MPC server
+struct SharedMemoryMessage
+{
+  enum Type
+  {
+    RECORD_GROUND_TRUTH_STATE = 0,
+    START = 1,
+    STOP = 2
+  };
+
+  Type type;
+  TimePoint time;
+  /// These are only filled for RECORD_GROUND_TRUTH_STATE
+  Eigen::VectorXs pos;
+  Eigen::VectorXs vel;
+  Eigen::VectorXs mass;
+};
+
+/// A plan published by the MPC server, in the "identity" mapping
+struct SharedMemoryPlan
+{
+  TimePoint startTime;
+  Duration replanDuration;
+  Eigen::MatrixXs poses;
+  Eigen::MatrixXs vels;
+  Eigen::MatrixXs forces;
+  Eigen::VectorXs masses;
+};
+
+/// This is a transport between an MPC client and an MPCLocal on the same
+/// machine, which skips the serialization and TCP stack that gRPC goes
+/// through. Everything lives in one shared memory mapping:
+///
+/// - Client -> server messages go through a single-producer single-consumer
+///   ring of fixed size slots.
+/// - Server -> client plans go through a single "latest plan" slot guarded by
+///   a sequence lock, since a client only ever wants the newest plan.
+///
+/// Both sides block on futexes in the shared mapping (on Linux; elsewhere they
+/// poll), so a wakeup costs microseconds instead of a network round trip.
+/// Times are sent as they are on the realtime clock, which is shared by every
+/// process on the machine.
+class SharedMemoryChannel
+{
+public:
+  /// Creates a channel in an anonymous shared mapping. This can only be
+  /// reached by this process, and by processes it forks after this call.
+  static std::shared_ptr<SharedMemoryChannel> createAnonymous(
+      int dofs, int massDim, int steps, Duration stepDuration);
+
+  /// Creates a channel as a named POSIX shared memory object, which other
+  /// processes on this machine can open(). The name should start with a '/'.
+  /// The name is unlinked again when this channel is destroyed. Returns
+  /// nullptr on failure, including if something already has this name, unless
+  /// `replaceExisting` is true. That unlinks whatever is there first, which is
+  /// how a server takes over a name left behind by one that crashed. Only do
+  /// that once the old owner is gone, because it unlinks the name when it's
+  /// destroyed, even if the name isn't its anymore.
+  static std::shared_ptr<SharedMemoryChannel> create(
+      const std::string& name,
+      int dofs,
+      int massDim,
+      int steps,
+      Duration stepDuration,
+      bool replaceExisting = false);
+
+  /// Opens a channel that another process created with create(). Returns
+  /// nullptr if it doesn't exist, or isn't a compatible channel.
+  static std::shared_ptr<SharedMemoryChannel> open(const std::string& name);
+
+  ~SharedMemoryChannel();
+
+  SharedMemoryChannel(const SharedMemoryChannel& other) = delete;
+  SharedMemoryChannel& operator=(const SharedMemoryChannel& other) = delete;
+
+  int getNumDofs() const;
+  int getMassDim() const;
+  int getNumSteps() const;
+  Duration getStepDuration() const;
+
+  /// Client side: queues a message for the server. This never blocks. Only
+  /// one thread per channel may send at a time. Returns false if the ring is
+  /// full or the channel is closed.
+  bool sendMessage(
+      SharedMemoryMessage::Type type,
+      TimePoint time,
+      const Eigen::VectorXs& pos = Eigen::VectorXs(),
+      const Eigen::VectorXs& vel = Eigen::VectorXs(),
+      const Eigen::VectorXs& mass = Eigen::VectorXs());
+
+  /// Server side: waits up to `timeout` for the next message. Returns false
+  /// on a timeout, or if the channel is closed.
+  bool receiveMessage(SharedMemoryMessage& message, Duration timeout);
+
+  /// Server side: replaces the latest plan, and wakes the client. Plans
+  /// longer than getNumSteps() are truncated.
+  void publishPlan(
+      TimePoint startTime,
+      Duration replanDuration,
+      const trajectory::TrajectoryRollout* rollout);
+
+  /// Client side: waits up to `timeout` for a plan newer than
+  /// `lastSequence`, copies it into `plan`, and updates `lastSequence`. Pass
+  /// 0 for `lastSequence` to get the first plan. Returns false on a timeout,
+  /// or if the channel is closed.
+  bool waitForPlan(
+      uint32_t& lastSequence, SharedMemoryPlan& plan, Duration timeout);
+
+  /// Closes the channel from either side. This wakes up anyone waiting on it,
+  /// and makes any further sends and waits fail.
+  void close();
+
+  /// Returns true once either side has called close()
+  bool isClosed() const;
+
+protected:
+  struct Header;
+
+  SharedMemoryChannel(void* mapping, std::size_t size, const std::string& name);
+
+  /// Lays out a fresh header in `mapping`
+  static void initialize(
+      void* mapping,
+      int dofs,
+      int massDim,
+      int steps,
+      Duration stepDuration);
+
+  /// Returns the number of bytes a channel with these sizes needs
+  static std::size_t getMappingSize(int dofs, int massDim, int steps);
+
+  /// Returns a pointer to the start of ring slot `index`
+  unsigned char* getSlot(uint32_t index) const;
+
+  /// Returns a pointer to the start of the plan data
+  unsigned char* getPlan() const;
+
+  void* mMapping;
+  std::size_t mSize;
+  Header* mHeader;
+
+  /// The name of the shared memory object, if we created it and need to
+  /// unlink it on destruction
+  std::string mOwnedName;
+};
+
+} // namespace realtime
+} // namespace dart
+
+#endif
@@ -1,13 +1,28 @@
 #include "dart/realtime/Ticker.hpp"
 
+#include <chrono>
+
+#include "dart/performance/PerformanceLog.hpp"
 #include "dart/realtime/Millis.hpp"
 
 namespace dart {
 namespace realtime {
 
 Ticker::Ticker(s_t secondsPerTick)
-  : mRunning(false), mSecondsPerTick(secondsPerTick)
+  : mRunning(false),
+    mSecondsPerTick(secondsPerTick),
+    mTickDuration(secondsToDuration(secondsPerTick)),
+    mSpinWait(Duration::zero()),
+    mMainThread(nullptr),
+    mListeners(std::make_shared<
+               const std::vector<std::function<void(TimePoint)>>>()),
+    mPerfLog(nullptr),
+    mNumTicks(0),
+    mNumOverruns(0),
+    mNumSkippedTicks(0)
 {
+  if (mTickDuration < Duration(1))
+    mTickDuration = Duration(1);
 }
 
 Ticker::~Ticker()
@@ -15,15 +30,52 @@ Ticker::~Ticker()
   stop();
 }
 
-void Ticker::registerTickListener(std::function<void(long)> listener)
+void Ticker::registerTickListener(std::function<void(TimePoint)> listener)
 {
-  mListeners.push_back(listener);
+  const std::lock_guard<std::mutex> lock(mListenersMutex);
+  auto listeners
+      = std::make_shared<std::vector<std::function<void(TimePoint)>>>(
+          *mListeners);
+  listeners->push_back(listener);
+  mListeners = listeners;
 }
 
 /// Remove all tick listeners, without deleting the Ticker
 void Ticker::clear()
 {
-  mListeners.clear();
+  const std::lock_guard<std::mutex> lock(mListenersMutex);
+  mListeners
+      = std::make_shared<const std::vector<std::function<void(TimePoint)>>>();
+}
+
+void Ticker::setSpinWait(Duration spinWait)
+{
+  mSpinWait = spinWait < Duration::zero() ? Duration::zero() : spinWait;
+}
+
+Duration Ticker::getSpinWait() const
+{
+  return mSpinWait;
+}
+
+void Ticker::setPerformanceLog(performance::PerformanceLog* log)
+{
+  mPerfLog = log;
+}
+
+long Ticker::getNumTicks() const
+{
+  return mNumTicks.load();
+}
+
+long Ticker::getNumOverruns() const
+{
+  return mNumOverruns.load();
+}
+
+long Ticker::getNumSkippedTicks() const
+{
+  return mNumSkippedTicks.load();
 }
 
 void Ticker::start()
@@ -41,23 +93,93 @@ void Ticker::stop()
   mRunning = false;
   mMainThread->join();
   delete mMainThread;
+  mMainThread = nullptr;
+}
+
+void Ticker::waitUntil(TimePoint deadline)
+{
+  TimePoint sleepUntil = deadline - mSpinWait;
+  if (now() < sleepUntil)
+  {
+    std::this_thread::sleep_until(sleepUntil);
+  }
+  while (now() < deadline)
+  {
+    // Spin through the last stretch, which OS sleeps can't hit precisely
+  }
 }
 
 void Ticker::mainLoop()
 {
+  performance::PerformanceLog* thisLog = nullptr;
+  if (mPerfLog != nullptr)
+    thisLog = mPerfLog->startRun("Ticker.mainLoop");
+
+  // Wake-up lateness histogram, bucketed by powers of 10 from 1us to 1ms.
+  // These are kept locally and only written to the log when we stop, so the
+  // tick loop never contends on the log's lock.
+  long jitterBuckets[5] = {0, 0, 0, 0, 0};
+  long ticks = 0;
+  long overruns = 0;
+  long skipped = 0;
+
+  // Deadlines are absolute multiples of the period from the start time, so
+  // time spent in listeners or waking up late doesn't accumulate as drift.
+  TimePoint start = now();
+  int64_t tick = 0;
   while (mRunning)
   {
-    int interval = (int)round(mSecondsPerTick * 1000);
-    auto x = std::chrono::steady_clock::now()
-             + std::chrono::milliseconds(interval);
-    long millis = timeSinceEpochMillis();
+    TimePoint deadline = start + tick * mTickDuration;
+    waitUntil(deadline);
+    if (!mRunning)
+      break;
 
-    for (auto listener : mListeners)
-      listener(millis);
+    int64_t lateness = (now() - deadline).count();
+    int bucket = 0;
+    for (int64_t limit = 1000; bucket < 4 && lateness >= limit; limit *= 10)
+      bucket++;
+    jitterBuckets[bucket]++;
 
-    std::this_thread::sleep_until(x);
+    std::shared_ptr<const std::vector<std::function<void(TimePoint)>>>
+        listeners;
+    {
+      const std::lock_guard<std::mutex> lock(mListenersMutex);
+      listeners = mListeners;
+    }
+    for (const auto& listener : *listeners)
+      listener(deadline);
+    ticks++;
+    mNumTicks++;
+
+    // If the listeners took longer than a period, drop the ticks we missed
+    // rather than firing them back-to-back to catch up.
+    tick++;
+    TimePoint finished = now();
+    TimePoint nextDeadline = start + tick * mTickDuration;
+    if (finished > nextDeadline)
+    {
+      int64_t behind = (finished - nextDeadline) / mTickDuration + 1;
+      tick += behind;
+      overruns++;
+      skipped += static_cast<long>(behind);
+      mNumOverruns++;
+      mNumSkippedTicks += static_cast<long>(behind);
+    }
+  }
+
+  if (thisLog != nullptr)
+  {
+    thisLog->incrementCounter("ticks", ticks);
+    thisLog->incrementCounter("overruns", overruns);
+    thisLog->incrementCounter("skippedTicks", skipped);
+    thisLog->incrementCounter("jitter <1us", jitterBuckets[0]);
+    thisLog->incrementCounter("jitter <10us", jitterBuckets[1]);
+    thisLog->incrementCounter("jitter <100us", jitterBuckets[2]);
+    thisLog->incrementCounter("jitter <1ms", jitterBuckets[3]);
+    thisLog->incrementCounter("jitter >=1ms", jitterBuckets[4]);
+    thisLog->end();
   }
 }
 
 } // namespace realtime
-} // namespace dart
\ No newline at end of file
+} // namespace dart
@@ -1,37 +1,85 @@
 #ifndef DART_TICKER
 #define DART_TICKER
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 #include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
 
 namespace dart {
+
+namespace performance {
+class PerformanceLog;
+}
+
 namespace realtime {
 
+/// Ticker schedules its ticks on the realtime clock (see TimePoint), so they
+/// don't drift or jump when the wall clock is adjusted. Listeners get each
+/// tick's scheduled deadline, which can go straight to MPC::getControlForce().
 class Ticker
 {
 public:
   Ticker(s_t secondsPerTick);
   ~Ticker();
-  void registerTickListener(std::function<void(long)> listener);
+  void registerTickListener(std::function<void(TimePoint)> listener);
   /// Remove all tick listeners, without deleting the Ticker
   void clear();
 
+  /// OS sleeps tend to wake up tens of microseconds late. If this is > 0, the
+  /// ticker sleeps until `spinWait` before each deadline and then busy-waits
+  /// the rest of the way, trading CPU for lower jitter. Defaults to 0, which
+  /// always sleeps.
+  void setSpinWait(Duration spinWait);
+  Duration getSpinWait() const;
+
+  /// If set, each run of the ticker records a "Ticker.mainLoop" run into this
+  /// log, along with counters for ticks, overruns, skipped ticks and a
+  /// histogram of wake-up jitter. Must be set before start().
+  void setPerformanceLog(performance::PerformanceLog* log);
+
+  /// Number of ticks delivered to listeners since construction
+  long getNumTicks() const;
+  /// Number of times a tick finished after the next deadline had passed
+  long getNumOverruns() const;
+  /// Number of ticks that were dropped to catch back up after overruns
+  long getNumSkippedTicks() const;
+
   void start();
   void stop();
 
 protected:
   void mainLoop();
-  bool mRunning;
+  /// Blocks until now() reaches `deadline`
+  void waitUntil(TimePoint deadline);
+
+  std::atomic<bool> mRunning;
 
   s_t mSecondsPerTick;
+  Duration mTickDuration;
+  Duration mSpinWait;
   std::thread* mMainThread;
-  std::vector<std::function<void(long)>> mListeners;
+
+  // Listeners are copy-on-write, so each tick only takes a reference to the
+  // current list rather than copying it, and registering a listener while
+  // running is safe.
+  std::mutex mListenersMutex;
+  std::shared_ptr<const std::vector<std::function<void(TimePoint)>>>
+      mListeners;
+
+  performance::PerformanceLog* mPerfLog;
+  std::atomic<long> mNumTicks;
+  std::atomic<long> mNumOverruns;
+  std::atomic<long> mNumSkippedTicks;
 };
 
 } // namespace realtime
 } // namespace dart
 
-#endif
\ No newline at end of file
+#endif
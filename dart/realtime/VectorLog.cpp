@@ -3,16 +3,16 @@
 namespace dart {
 namespace realtime {
 
-VectorObservation::VectorObservation(long time, Eigen::VectorXs value)
+VectorObservation::VectorObservation(TimePoint time, Eigen::VectorXs value)
   : time(time), value(value)
 {
 }
 
-VectorLog::VectorLog(int dim) : mDim(dim), mStartTime(0L)
+VectorLog::VectorLog(int dim) : mDim(dim), mStartTime()
 {
 }
 
-void VectorLog::record(long time, Eigen::VectorXs val)
+void VectorLog::record(TimePoint time, Eigen::VectorXs val)
 {
   if (mObservations.size() == 0)
     mStartTime = time;
@@ -20,7 +20,8 @@ void VectorLog::record(long time, Eigen::VectorXs val)
   mObservations.emplace_back(time, val);
 }
 
-Eigen::MatrixXs VectorLog::getValues(long start, int steps, long millisPerStep)
+Eigen::MatrixXs VectorLog::getValues(
+    TimePoint start, int steps, Duration stepDuration)
 {
   Eigen::MatrixXs observations = Eigen::MatrixXs::Zero(mDim, steps);
 
@@ -28,8 +29,7 @@ Eigen::MatrixXs VectorLog::getValues(long start, int steps, long millisPerStep)
   int cursorStep = 0;
   for (const VectorObservation& obs : mObservations)
   {
-    int step = static_cast<int>(
-        ceil(static_cast<s_t>(obs.time - start) / millisPerStep));
+    int step = ceilSteps(obs.time - start, stepDuration);
     if (step > steps - 1)
       break;
     if (step >= cursorStep)
@@ -60,12 +60,12 @@ Eigen::MatrixXs VectorLog::getValues(long start, int steps, long millisPerStep)
   return observations;
 }
 
-long VectorLog::availableHistoryBefore(long time)
+Duration VectorLog::availableHistoryBefore(TimePoint time)
 {
   return time - mStartTime;
 }
 
-void VectorLog::discardBefore(long time)
+void VectorLog::discardBefore(TimePoint time)
 {
   int discardBeforeIndex = -1;
   for (int i = mObservations.size() - 1; i >= 0; i--)
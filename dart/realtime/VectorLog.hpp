@@ -6,16 +6,17 @@
 #include <Eigen/Dense>
 
 #include "dart/math/MathTypes.hpp"
+#include "dart/realtime/Millis.hpp"
 
 namespace dart {
 namespace realtime {
 
 struct VectorObservation
 {
-  long time;
+  TimePoint time;
   Eigen::VectorXs value;
 
-  VectorObservation(long time, Eigen::VectorXs value);
+  VectorObservation(TimePoint time, Eigen::VectorXs value);
 };
 
 class VectorLog
@@ -23,17 +24,17 @@ class VectorLog
 public:
   VectorLog(int dim);
 
-  void record(long time, Eigen::VectorXs val);
+  void record(TimePoint time, Eigen::VectorXs val);
 
-  Eigen::MatrixXs getValues(long start, int steps, long millisPerStep);
+  Eigen::MatrixXs getValues(TimePoint start, int steps, Duration stepDuration);
 
-  void discardBefore(long time);
+  void discardBefore(TimePoint time);
 
-  long availableHistoryBefore(long time);
+  Duration availableHistoryBefore(TimePoint time);
 
 protected:
   int mDim;
-  long mStartTime;
+  TimePoint mStartTime;
   std::vector<VectorObservation> mObservations;
 };
 
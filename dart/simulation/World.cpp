@@ -39,6 +39,7 @@
 #include "dart/simulation/World.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -46,6 +47,7 @@
 
 #include "dart/collision/CollisionGroup.hpp"
 #include "dart/common/Console.hpp"
+#include "dart/common/ThreadPool.hpp"
 #include "dart/constraint/BoxedLcpConstraintSolver.hpp"
 #include "dart/constraint/ConstrainedGroup.hpp"
 #include "dart/dynamics/BoxShape.hpp"
@@ -118,8 +120,11 @@ WorldPtr World::clone() const
       mFallbackConstraintForceMixingConstant);
   worldClone->setContactClippingDepth(mContactClippingDepth);
   worldClone->setPenetrationCorrectionEnabled(mPenetrationCorrectionEnabled);
+  if (getWarmStartedLcpEnabled())
+    worldClone->setWarmStartedLcpEnabled(true);
   worldClone->setParallelVelocityAndPositionUpdates(
       mParallelVelocityAndPositionUpdates);
+  worldClone->setNumStepThreads(getNumStepThreads());
 
   // Copy the WithRespectToMass pointer, so we have the same object
   worldClone->mWrtMass = mWrtMass;
@@ -213,15 +218,30 @@ void World::step(bool _resetCommand)
 {
   Eigen::VectorXs initialVelocity = getVelocities();
 
+  // Runs fn(i) for each skeleton, either serially or spread over the thread
+  // pool. Every skeleton update below only touches its own skeleton, so the
+  // order doesn't change the results.
+  auto forEachSkeleton = [this](const std::function<void(std::size_t)>& fn) {
+    if (mStepThreadPool)
+    {
+      mStepThreadPool->parallelFor(mSkeletons.size(), fn);
+    }
+    else
+    {
+      for (std::size_t i = 0; i < mSkeletons.size(); i++)
+        fn(i);
+    }
+  };
+
   // Integrate velocity for unconstrained skeletons
-  for (auto& skel : mSkeletons)
-  {
+  forEachSkeleton([this](std::size_t i) {
+    const auto& skel = mSkeletons[i];
     if (!skel->isMobile())
-      continue;
+      return;
 
     skel->computeForwardDynamics();
     skel->integrateVelocities(mTimeStep);
-  }
+  });
 
   // Record the unconstrained velocities, cause we need them for backprop
   if (mConstraintSolver->getGradientEnabled())
@@ -236,10 +256,10 @@ void World::step(bool _resetCommand)
   mConstraintSolver->solve(this);
 
   // Compute velocity changes given constraint impulses
-  for (auto& skel : mSkeletons)
-  {
+  forEachSkeleton([this, _resetCommand](std::size_t i) {
+    const auto& skel = mSkeletons[i];
     if (!skel->isMobile())
-      continue;
+      return;
 
     if (skel->isImpulseApplied())
     {
@@ -259,22 +279,28 @@ void World::step(bool _resetCommand)
       skel->clearExternalForces();
       skel->resetCommands();
     }
-  }
+  });
 
   // <Nimble>: This is an easier way to compute gradients for. We update p_t+1
   // using v_t, instead of v_t+1
   if (mParallelVelocityAndPositionUpdates)
   {
+    std::vector<int> cursors;
+    cursors.reserve(mSkeletons.size());
     int cursor = 0;
     for (auto& skel : mSkeletons)
     {
+      cursors.push_back(cursor);
+      cursor += skel->getNumDofs();
+    }
+    forEachSkeleton([this, &cursors, &initialVelocity](std::size_t i) {
+      const auto& skel = mSkeletons[i];
       int dofs = skel->getNumDofs();
       skel->setPositions(skel->integratePositionsExplicit(
           skel->getPositions(),
-          initialVelocity.segment(cursor, dofs),
+          initialVelocity.segment(cursors[i], dofs),
           mTimeStep));
-      cursor += dofs;
-    }
+    });
   }
   // </Nimble>: Integrate positions before velocity changes, instead of after
 
@@ -306,6 +332,23 @@ bool World::getParallelVelocityAndPositionUpdates()
   return mParallelVelocityAndPositionUpdates;
 }
 
+//==============================================================================
+void World::setNumStepThreads(std::size_t numThreads)
+{
+  if (numThreads == getNumStepThreads())
+    return;
+  if (numThreads <= 1)
+    mStepThreadPool.reset();
+  else
+    mStepThreadPool = std::make_unique<common::ThreadPool>(numThreads);
+}
+
+//==============================================================================
+std::size_t World::getNumStepThreads() const
+{
+  return mStepThreadPool ? mStepThreadPool->getNumThreads() : 1;
+}
+
 //==============================================================================
 void World::setPenetrationCorrectionEnabled(bool enable)
 {
@@ -318,6 +361,28 @@ bool World::getPenetrationCorrectionEnabled()
   return mPenetrationCorrectionEnabled;
 }
 
+//==============================================================================
+void World::setWarmStartedLcpEnabled(bool enable)
+{
+  auto solver = dynamic_cast<constraint::BoxedLcpConstraintSolver*>(
+      mConstraintSolver.get());
+  if (solver == nullptr)
+  {
+    dtwarn << "[World::setWarmStartedLcpEnabled] The constraint solver isn't "
+           << "a BoxedLcpConstraintSolver. Doing nothing.\n";
+    return;
+  }
+  solver->setWarmStartedLcpEnabled(enable);
+}
+
+//==============================================================================
+bool World::getWarmStartedLcpEnabled() const
+{
+  auto solver = dynamic_cast<const constraint::BoxedLcpConstraintSolver*>(
+      mConstraintSolver.get());
+  return solver != nullptr && solver->isWarmStartedLcpEnabled();
+}
+
 //==============================================================================
 void World::setFallbackConstraintForceMixingConstant(s_t constant)
 {
@@ -1088,6 +1153,48 @@ Eigen::VectorXs World::getControlForces()
   return forces;
 }
 
+//==============================================================================
+void World::getPositionsInto(Eigen::Ref<Eigen::VectorXs> out)
+{
+  assert(static_cast<std::size_t>(out.size()) == mDofs);
+  std::size_t cursor = 0;
+  for (std::size_t i = 0; i < mSkeletons.size(); i++)
+  {
+    std::size_t dofs = mSkeletons[i]->getNumDofs();
+    for (std::size_t j = 0; j < dofs; j++)
+      out(cursor + j) = mSkeletons[i]->getDof(j)->getPosition();
+    cursor += dofs;
+  }
+}
+
+//==============================================================================
+void World::getVelocitiesInto(Eigen::Ref<Eigen::VectorXs> out)
+{
+  assert(static_cast<std::size_t>(out.size()) == mDofs);
+  std::size_t cursor = 0;
+  for (std::size_t i = 0; i < mSkeletons.size(); i++)
+  {
+    std::size_t dofs = mSkeletons[i]->getNumDofs();
+    for (std::size_t j = 0; j < dofs; j++)
+      out(cursor + j) = mSkeletons[i]->getDof(j)->getVelocity();
+    cursor += dofs;
+  }
+}
+
+//==============================================================================
+void World::getControlForcesInto(Eigen::Ref<Eigen::VectorXs> out)
+{
+  assert(static_cast<std::size_t>(out.size()) == mDofs);
+  std::size_t cursor = 0;
+  for (std::size_t i = 0; i < mSkeletons.size(); i++)
+  {
+    std::size_t dofs = mSkeletons[i]->getNumDofs();
+    for (std::size_t j = 0; j < dofs; j++)
+      out(cursor + j) = mSkeletons[i]->getDof(j)->getControlForce();
+    cursor += dofs;
+  }
+}
+
 //==============================================================================
 Eigen::VectorXs World::getControlForceUpperLimits()
 {
@@ -1189,7 +1296,7 @@ Eigen::VectorXs World::getMassLowerLimits()
 }
 
 //==============================================================================
-void World::setPositions(Eigen::VectorXs position)
+void World::setPositions(const Eigen::Ref<const Eigen::VectorXs>& position)
 {
   std::size_t cursor = 0;
   for (std::size_t i = 0; i < mSkeletons.size(); i++)
@@ -1201,7 +1308,7 @@ void World::setPositions(Eigen::VectorXs position)
 }
 
 //==============================================================================
-void World::setVelocities(Eigen::VectorXs velocity)
+void World::setVelocities(const Eigen::Ref<const Eigen::VectorXs>& velocity)
 {
   std::size_t cursor = 0;
   for (std::size_t i = 0; i < mSkeletons.size(); i++)
@@ -1225,7 +1332,8 @@ void World::setAccelerations(Eigen::VectorXs accelerations)
 }
 
 //==============================================================================
-void World::setControlForces(Eigen::VectorXs forces)
+void World::setControlForces(
+    const Eigen::Ref<const Eigen::VectorXs>& forces)
 {
   std::size_t cursor = 0;
   for (std::size_t i = 0; i < mSkeletons.size(); i++)
@@ -1388,7 +1496,7 @@ int World::getStateSize()
 //==============================================================================
 // This takes a single state vector and calls setPositions() and setVelocities()
 // on the head and tail, respectively
-void World::setState(Eigen::VectorXs state)
+void World::setState(const Eigen::Ref<const Eigen::VectorXs>& state)
 {
   int dofs = getNumDofs();
   if (state.size() != 2 * dofs)
@@ -1413,6 +1521,16 @@ Eigen::VectorXs World::getState()
   return state;
 }
 
+//==============================================================================
+// This writes [pos, vel] into `out`, which must have size getStateSize(),
+// without allocating
+void World::getStateInto(Eigen::Ref<Eigen::VectorXs> out)
+{
+  assert(static_cast<std::size_t>(out.size()) == 2 * mDofs);
+  getPositionsInto(out.head(mDofs));
+  getVelocitiesInto(out.tail(mDofs));
+}
+
 //==============================================================================
 // The action dim is given by the size of the action mapping. This defaults to a
 // 1-1 map onto control forces, but can be configured to be just a subset of the
@@ -59,6 +59,10 @@
 
 namespace dart {
 
+namespace common {
+class ThreadPool;
+} // namespace common
+
 namespace integration {
 class Integrator;
 } // namespace integration
@@ -245,6 +249,13 @@ public:
   /// as a single vector
   Eigen::VectorXs getControlForces();
 
+  /// These write the same values as getPositions(), getVelocities() and
+  /// getControlForces() into caller-owned memory of size getNumDofs(), without
+  /// allocating. The Python bindings use these to fill NumPy arrays in place.
+  void getPositionsInto(Eigen::Ref<Eigen::VectorXs> out);
+  void getVelocitiesInto(Eigen::Ref<Eigen::VectorXs> out);
+  void getControlForcesInto(Eigen::Ref<Eigen::VectorXs> out);
+
   /// Gets the masses of all the nodes in the world concatenated together as a
   /// single vector
   Eigen::VectorXs getMasses();
@@ -295,11 +306,11 @@ public:
 
   /// Sets the position of all the skeletons in the world from a single
   /// concatenated state vector
-  void setPositions(Eigen::VectorXs position);
+  void setPositions(const Eigen::Ref<const Eigen::VectorXs>& position);
 
   /// Sets the velocities of all the skeletons in the world from a single
   /// concatenated state vector
-  void setVelocities(Eigen::VectorXs velocity);
+  void setVelocities(const Eigen::Ref<const Eigen::VectorXs>& velocity);
 
   /// Sets the accelerations of all the skeletons in the world from a single
   /// concatenated state vector
@@ -307,7 +318,7 @@ public:
 
   /// Sets the forces of all the skeletons in the world from a single
   /// concatenated state vector
-  void setControlForces(Eigen::VectorXs torques);
+  void setControlForces(const Eigen::Ref<const Eigen::VectorXs>& torques);
 
   // Sets the upper limits of all the joints from a single vector
   void setControlForceUpperLimits(Eigen::VectorXs limits);
@@ -360,9 +371,12 @@ public:
   int getStateSize();
   // This takes a single state vector and calls setPositions() and
   // setVelocities() on the head and tail, respectively
-  void setState(Eigen::VectorXs state);
+  void setState(const Eigen::Ref<const Eigen::VectorXs>& state);
   // This return the concatenation of [pos, vel]
   Eigen::VectorXs getState();
+  // This writes [pos, vel] into `out`, which must have size getStateSize(),
+  // without allocating
+  void getStateInto(Eigen::Ref<Eigen::VectorXs> out);
 
   // The action dim is given by the size of the action mapping. This defaults to
   // a 1-1 map onto control forces, but can be configured to be just a subset of
@@ -501,12 +515,34 @@ public:
 
   bool getParallelVelocityAndPositionUpdates();
 
+  /// Sets the number of threads that step() uses to update skeletons. Forward
+  /// dynamics and integration for each skeleton only touch that skeleton, so
+  /// in worlds with many independent skeletons those updates can be fanned out
+  /// over a thread pool. Skeleton `i` is always updated by thread
+  /// `i % numThreads`, and the results are bitwise identical to the serial
+  /// path. Collision detection and the constraint solve still run serially.
+  /// 1 (the default) runs everything on the calling thread.
+  void setNumStepThreads(std::size_t numThreads);
+
+  /// Returns the number of threads that step() uses to update skeletons.
+  std::size_t getNumStepThreads() const;
+
   /// True by default. Sets whether or not to apply artifical "penetration
   /// correction" forces to objects that inter-penetrate.
   void setPenetrationCorrectionEnabled(bool enable);
 
   bool getPenetrationCorrectionEnabled();
 
+  /// False by default. Sets whether the constraint solver warm starts each
+  /// step's boxed LCP from the previous step's solution, using
+  /// BlockPivotingBoxedLcpSolver instead of Dantzig. Steps where the contacts
+  /// over-constrain a body (like the four corners of a box face) still go
+  /// through Dantzig, as a fallback. This only works if the constraint solver
+  /// is a BoxedLcpConstraintSolver, which is the default.
+  void setWarmStartedLcpEnabled(bool enable);
+
+  bool getWarmStartedLcpEnabled() const;
+
   /// We add this value to the diagonal entries of A, ONLY IF our initial LCP
   /// solution fails, to help prevent A from being low-rank. This both increases
   /// the stability of the forward LCP solution, and it also helps prevent cases
@@ -658,6 +694,10 @@ protected:
   /// environments. True by default.
   bool mParallelVelocityAndPositionUpdates;
 
+  /// Thread pool used to update skeletons in parallel during step(), or
+  /// nullptr if we're updating them serially
+  std::unique_ptr<common::ThreadPool> mStepThreadPool;
+
   /// True if we want to enable artificial penetration correction forces
   bool mPenetrationCorrectionEnabled;
 
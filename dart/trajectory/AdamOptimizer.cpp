@@ -0,0 +1,177 @@
+#include "dart/trajectory/AdamOptimizer.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "dart/simulation/World.hpp"
+
+using namespace dart;
+using namespace simulation;
+
+namespace dart {
+namespace trajectory {
+
+namespace {
+
+/// This keeps the update finite when the second moment is ~0
+constexpr s_t ADAM_EPSILON = 1e-8;
+
+} // namespace
+
+//==============================================================================
+AdamOptimizer::AdamOptimizer()
+  : mIterationLimit(100),
+    mTolerance(1e-7),
+    mLearningRate(1e-2),
+    mBeta1(0.9),
+    mBeta2(0.999),
+    mRecoverBest(true),
+    mPrintFrequency(0),
+    mRecordIterations(true)
+{
+}
+
+//==============================================================================
+std::shared_ptr<Solution> AdamOptimizer::optimize(
+    Problem* shot, std::shared_ptr<Solution> reuseRecord)
+{
+  std::shared_ptr<Solution> record
+      = reuseRecord ? reuseRecord : std::make_shared<Solution>();
+  std::shared_ptr<World> world = shot->mWorld;
+
+  int n = shot->getFlatProblemDim(world);
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs upper = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs lower = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs grad = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs firstMoment = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs secondMoment = Eigen::VectorXs::Zero(n);
+  shot->flatten(world, x);
+  shot->getUpperBounds(world, upper);
+  shot->getLowerBounds(world, lower);
+  x = x.cwiseMax(lower).cwiseMin(upper);
+  shot->unflatten(world, x);
+
+  s_t bestLoss = std::numeric_limits<s_t>::infinity();
+  Eigen::VectorXs bestX = x;
+  s_t beta1Power = 1.0;
+  s_t beta2Power = 1.0;
+  bool converged = false;
+
+  for (int iter = 0; iter < mIterationLimit; iter++)
+  {
+    // These both read from the same rollout cache, so this is one rollout
+    s_t loss = shot->getLoss(world);
+    shot->backpropGradient(world, grad);
+
+    if (loss < bestLoss)
+    {
+      bestLoss = loss;
+      bestX = x;
+    }
+    if (mPrintFrequency > 0 && iter % mPrintFrequency == 0)
+    {
+      std::cout << "Iter " << iter << ": " << loss << std::endl;
+    }
+    if (mRecordIterations)
+    {
+      record->registerIteration(iter, shot->getRolloutCache(world), loss, 0.0);
+    }
+
+    bool allCallbacksReturnedTrue = true;
+    for (auto& callback : mIntermediateCallbacks)
+    {
+      if (!callback(shot, iter, loss, 0.0))
+      {
+        allCallbacksReturnedTrue = false;
+      }
+    }
+    if (!allCallbacksReturnedTrue)
+    {
+      break;
+    }
+
+    if (getProjectedGradient(x, grad, lower, upper).norm() <= mTolerance)
+    {
+      converged = true;
+      break;
+    }
+
+    firstMoment = mBeta1 * firstMoment + (1.0 - mBeta1) * grad;
+    secondMoment = mBeta2 * secondMoment + (1.0 - mBeta2) * grad.cwiseAbs2();
+    beta1Power *= mBeta1;
+    beta2Power *= mBeta2;
+    // Correct for the moments being biased towards their 0 initialization
+    s_t stepSize
+        = mLearningRate * std::sqrt(1.0 - beta2Power) / (1.0 - beta1Power);
+
+    x -= stepSize
+         * firstMoment.cwiseQuotient(
+             (secondMoment.cwiseSqrt().array() + ADAM_EPSILON).matrix());
+    x = x.cwiseMax(lower).cwiseMin(upper);
+    shot->unflatten(world, x);
+  }
+
+  if (mRecoverBest && bestLoss < std::numeric_limits<s_t>::infinity())
+  {
+    shot->unflatten(world, bestX);
+  }
+
+  record->setSuccess(converged);
+  return record;
+}
+
+//==============================================================================
+void AdamOptimizer::setIterationLimit(int iterationLimit)
+{
+  mIterationLimit = iterationLimit;
+}
+
+//==============================================================================
+/// We stop once the norm of the projected gradient falls below this
+void AdamOptimizer::setTolerance(s_t tolerance)
+{
+  mTolerance = tolerance;
+}
+
+//==============================================================================
+void AdamOptimizer::setLearningRate(s_t learningRate)
+{
+  mLearningRate = learningRate;
+}
+
+//==============================================================================
+/// This sets the decay rates for the first and second moment estimates
+void AdamOptimizer::setMomentDecay(s_t beta1, s_t beta2)
+{
+  mBeta1 = beta1;
+  mBeta2 = beta2;
+}
+
+//==============================================================================
+/// If true (the default), we finish at the lowest loss we saw, rather than
+/// wherever the last step landed
+void AdamOptimizer::setRecoverBest(bool recoverBest)
+{
+  mRecoverBest = recoverBest;
+}
+
+//==============================================================================
+/// This sets how often (in iterations) we print progress to stdout. 0, the
+/// default, never prints.
+void AdamOptimizer::setPrintFrequency(int frequency)
+{
+  mPrintFrequency = frequency;
+}
+
+//==============================================================================
+/// If true (the default), every iteration gets registered on the returned
+/// Solution
+void AdamOptimizer::setRecordIterations(bool recordIterations)
+{
+  mRecordIterations = recordIterations;
+}
+
+} // namespace trajectory
+} // namespace dart
@@ -0,0 +1,75 @@
+#ifndef DART_TRAJECTORY_ADAM_OPTIMIZER_HPP_
+#define DART_TRAJECTORY_ADAM_OPTIMIZER_HPP_
+
+#include <memory>
+
+#include <Eigen/Dense>
+
+#include "dart/trajectory/Optimizer.hpp"
+#include "dart/trajectory/Problem.hpp"
+#include "dart/trajectory/Solution.hpp"
+#include "dart/trajectory/TrajectoryConstants.hpp"
+
+namespace dart {
+
+namespace simulation {
+class World;
+}
+
+namespace trajectory {
+
+/*
+ * This is Adam (Kingma and Ba, 2015), projected back onto the box from
+ * getUpperBounds() and getLowerBounds() after every step. Like
+ * LBFGSOptimizer, any constraints in getConstraintDim() are ignored.
+ *
+ * Each iteration costs exactly one rollout and one backprop, since the loss
+ * and the gradient share the problem's rollout cache.
+ */
+class AdamOptimizer : public Optimizer
+{
+public:
+  AdamOptimizer();
+
+  virtual ~AdamOptimizer() = default;
+
+  std::shared_ptr<Solution> optimize(
+      Problem* shot, std::shared_ptr<Solution> warmStart = nullptr) override;
+
+  void setIterationLimit(int iterationLimit);
+
+  /// We stop once the norm of the projected gradient falls below this
+  void setTolerance(s_t tolerance);
+
+  void setLearningRate(s_t learningRate);
+
+  /// This sets the decay rates for the first and second moment estimates
+  void setMomentDecay(s_t beta1, s_t beta2);
+
+  /// If true (the default), we finish at the lowest loss we saw, rather than
+  /// wherever the last step landed
+  void setRecoverBest(bool recoverBest);
+
+  /// This sets how often (in iterations) we print progress to stdout. 0, the
+  /// default, never prints.
+  void setPrintFrequency(int frequency);
+
+  /// If true (the default), every iteration gets registered on the returned
+  /// Solution
+  void setRecordIterations(bool recordIterations);
+
+protected:
+  int mIterationLimit;
+  s_t mTolerance;
+  s_t mLearningRate;
+  s_t mBeta1;
+  s_t mBeta2;
+  bool mRecoverBest;
+  int mPrintFrequency;
+  bool mRecordIterations;
+};
+
+} // namespace trajectory
+} // namespace dart
+
+#endif
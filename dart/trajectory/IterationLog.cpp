@@ -0,0 +1,668 @@
+#include "dart/trajectory/IterationLog.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dart/trajectory/Solution.hpp"
+#include "dart/trajectory/TrajectoryRollout.hpp"
+
+namespace dart {
+namespace trajectory {
+
+namespace {
+
+constexpr uint32_t LOG_MAGIC = 0x474c544e; // "NTLG"
+constexpr uint32_t LOG_VERSION = 1;
+constexpr std::size_t LOG_HEADER_BYTES = 4 * sizeof(uint32_t);
+
+/// Set in a record's flags if it doesn't depend on the record before it
+constexpr uint32_t KEYFRAME_FLAG = 1;
+
+/// The fixed part of every record, after its uint32 length prefix
+struct RecordHeader
+{
+  uint32_t flags;
+  int32_t index;
+  double loss;
+  double constraintViolation;
+  uint32_t numMatrices;
+};
+
+const std::string POSES_PREFIX = "pos:";
+const std::string VELS_PREFIX = "vel:";
+const std::string FORCES_PREFIX = "force:";
+const std::string METADATA_PREFIX = "meta:";
+const std::string MASSES_NAME = "mass";
+
+//==============================================================================
+template <typename T>
+void appendRaw(std::vector<unsigned char>& buffer, const T& value)
+{
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+//==============================================================================
+/// This reads a T at `cursor`, if it fits before `end`, and advances `cursor`
+template <typename T>
+bool readRaw(const unsigned char*& cursor, const unsigned char* end, T& value)
+{
+  if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(T)))
+    return false;
+  std::memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return true;
+}
+
+//==============================================================================
+/// This rounds to the nearest IEEE half precision float, ties to even
+uint16_t doubleToHalf(double value)
+{
+  float f = static_cast<float>(value);
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t floatExponent = (bits >> 23) & 0xff;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  // Infinity and NaN
+  if (floatExponent == 0xff)
+    return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+
+  int exponent = static_cast<int>(floatExponent) - 127 + 15;
+  if (exponent >= 0x1f)
+    return sign | 0x7c00;
+
+  if (exponent <= 0)
+  {
+    // This is a subnormal half, or rounds to zero
+    if (exponent < -10)
+      return sign;
+    mantissa |= 0x800000;
+    int shift = 14 - exponent;
+    uint32_t half = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1)))
+      half++;
+    return sign | static_cast<uint16_t>(half);
+  }
+
+  uint16_t half = sign | static_cast<uint16_t>(exponent << 10)
+                  | static_cast<uint16_t>(mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fff;
+  // A carry out of the mantissa correctly bumps the exponent
+  if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    half++;
+  return half;
+}
+
+//==============================================================================
+double halfToDouble(uint16_t half)
+{
+  double sign = (half & 0x8000) ? -1.0 : 1.0;
+  int exponent = (half >> 10) & 0x1f;
+  int mantissa = half & 0x3ff;
+  if (exponent == 0)
+    return sign * std::ldexp(static_cast<double>(mantissa), -24);
+  if (exponent == 0x1f)
+  {
+    return mantissa == 0 ? sign * std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::quiet_NaN();
+  }
+  return sign
+         * std::ldexp(static_cast<double>(mantissa | 0x400), exponent - 25);
+}
+
+//==============================================================================
+void appendMatrix(
+    const std::string& name,
+    const Eigen::Ref<const Eigen::MatrixXs>& matrix,
+    IterationLogShape& shape,
+    std::vector<double>& values)
+{
+  shape.names.push_back(name);
+  shape.rows.push_back(matrix.rows());
+  shape.cols.push_back(matrix.cols());
+  for (int col = 0; col < matrix.cols(); col++)
+  {
+    for (int row = 0; row < matrix.rows(); row++)
+    {
+      values.push_back(static_cast<double>(matrix(row, col)));
+    }
+  }
+}
+
+//==============================================================================
+/// This lays every number in a rollout out end to end, in an order that only
+/// depends on the rollout's mapping names and metadata keys
+void flattenRollout(
+    const TrajectoryRollout* rollout,
+    IterationLogShape& shape,
+    std::vector<double>& values)
+{
+  shape.names.clear();
+  shape.rows.clear();
+  shape.cols.clear();
+  values.clear();
+
+  std::vector<std::string> mappings = rollout->getMappings();
+  std::sort(mappings.begin(), mappings.end());
+  for (const std::string& mapping : mappings)
+  {
+    appendMatrix(
+        POSES_PREFIX + mapping, rollout->getPosesConst(mapping), shape, values);
+    appendMatrix(
+        VELS_PREFIX + mapping, rollout->getVelsConst(mapping), shape, values);
+    appendMatrix(
+        FORCES_PREFIX + mapping,
+        rollout->getControlForcesConst(mapping),
+        shape,
+        values);
+  }
+  appendMatrix(MASSES_NAME, rollout->getMassesConst(), shape, values);
+
+  std::vector<std::string> keys;
+  for (auto& pair : rollout->getMetadataMap())
+  {
+    keys.push_back(pair.first);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (const std::string& key : keys)
+  {
+    appendMatrix(
+        METADATA_PREFIX + key,
+        rollout->getMetadataMap().at(key),
+        shape,
+        values);
+  }
+}
+
+//==============================================================================
+/// This is the inverse of flattenRollout()
+std::shared_ptr<TrajectoryRollout> unflattenRollout(
+    const IterationLogShape& shape, const std::vector<double>& values)
+{
+  std::unordered_map<std::string, Eigen::MatrixXs> poses;
+  std::unordered_map<std::string, Eigen::MatrixXs> vels;
+  std::unordered_map<std::string, Eigen::MatrixXs> forces;
+  std::unordered_map<std::string, Eigen::MatrixXs> metadata;
+  Eigen::VectorXs masses;
+
+  std::size_t cursor = 0;
+  for (std::size_t i = 0; i < shape.names.size(); i++)
+  {
+    const std::string& name = shape.names[i];
+    Eigen::MatrixXs matrix(shape.rows[i], shape.cols[i]);
+    for (int col = 0; col < matrix.cols(); col++)
+    {
+      for (int row = 0; row < matrix.rows(); row++)
+      {
+        matrix(row, col) = values[cursor++];
+      }
+    }
+
+    if (name == MASSES_NAME)
+      masses = matrix.col(0);
+    else if (name.compare(0, POSES_PREFIX.size(), POSES_PREFIX) == 0)
+      poses[name.substr(POSES_PREFIX.size())] = matrix;
+    else if (name.compare(0, VELS_PREFIX.size(), VELS_PREFIX) == 0)
+      vels[name.substr(VELS_PREFIX.size())] = matrix;
+    else if (name.compare(0, FORCES_PREFIX.size(), FORCES_PREFIX) == 0)
+      forces[name.substr(FORCES_PREFIX.size())] = matrix;
+    else if (name.compare(0, METADATA_PREFIX.size(), METADATA_PREFIX) == 0)
+      metadata[name.substr(METADATA_PREFIX.size())] = matrix;
+  }
+
+  return std::make_shared<TrajectoryRolloutReal>(
+      poses, vels, forces, masses, metadata);
+}
+
+//==============================================================================
+std::size_t getNumValues(const IterationLogShape& shape)
+{
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < shape.rows.size(); i++)
+  {
+    count += static_cast<std::size_t>(shape.rows[i]) * shape.cols[i];
+  }
+  return count;
+}
+
+} // namespace
+
+//==============================================================================
+bool IterationLogShape::operator==(const IterationLogShape& other) const
+{
+  return names == other.names && rows == other.rows && cols == other.cols;
+}
+
+//==============================================================================
+/// This creates (or truncates) the log at `path`. Only every `decimation`'th
+/// appended iteration gets written, though the most recent iteration is always
+/// written by flush(). With DELTA compression, a full keyframe gets written
+/// every `keyframeInterval` records, which bounds how far a reader needs to
+/// decode to seek. Returns nullptr if the file can't be opened.
+std::shared_ptr<IterationLogWriter> IterationLogWriter::create(
+    const std::string& path,
+    IterationLogCompression compression,
+    int decimation,
+    int keyframeInterval)
+{
+  std::shared_ptr<IterationLogWriter> writer(new IterationLogWriter(
+      path,
+      compression,
+      std::max(1, decimation),
+      std::max(1, keyframeInterval)));
+  if (!writer->mFile.is_open())
+  {
+    std::cout << "IterationLogWriter couldn't open \"" << path
+              << "\" for writing" << std::endl;
+    return nullptr;
+  }
+
+  std::vector<unsigned char> header;
+  appendRaw(header, LOG_MAGIC);
+  appendRaw(header, LOG_VERSION);
+  appendRaw(header, static_cast<uint32_t>(compression));
+  appendRaw(header, static_cast<uint32_t>(0));
+  writer->mFile.write(
+      reinterpret_cast<const char*>(header.data()), header.size());
+  writer->mFile.flush();
+  return writer;
+}
+
+//==============================================================================
+IterationLogWriter::IterationLogWriter(
+    const std::string& path,
+    IterationLogCompression compression,
+    int decimation,
+    int keyframeInterval)
+  : mPath(path),
+    mFile(path, std::ios::binary | std::ios::out | std::ios::trunc),
+    mCompression(compression),
+    mDecimation(decimation),
+    mKeyframeInterval(keyframeInterval),
+    mNumAppended(0),
+    mRecordsSinceKeyframe(0),
+    mHasPending(false),
+    mPendingIndex(0),
+    mPendingLoss(0),
+    mPendingConstraintViolation(0),
+    mHasWritten(false)
+{
+}
+
+//==============================================================================
+/// This flushes any pending iteration and closes the file
+IterationLogWriter::~IterationLogWriter()
+{
+  flush();
+}
+
+//==============================================================================
+/// This records a single iteration. The rollout is only read during this call,
+/// so it's fine to reuse it afterwards.
+void IterationLogWriter::append(
+    int index,
+    const TrajectoryRollout* rollout,
+    s_t loss,
+    s_t constraintViolation)
+{
+  mPendingIndex = index;
+  mPendingLoss = static_cast<double>(loss);
+  mPendingConstraintViolation = static_cast<double>(constraintViolation);
+  flattenRollout(rollout, mPendingShape, mPendingValues);
+  mHasPending = true;
+
+  if (mNumAppended % mDecimation == 0)
+  {
+    writePending();
+    mFile.flush();
+  }
+  mNumAppended++;
+}
+
+//==============================================================================
+/// This writes the most recent iteration, if decimation skipped it, and
+/// flushes everything to disk so that readers can see it.
+void IterationLogWriter::flush()
+{
+  if (mHasPending)
+  {
+    writePending();
+  }
+  mFile.flush();
+}
+
+//==============================================================================
+/// Returns the path we're writing to
+const std::string& IterationLogWriter::getPath() const
+{
+  return mPath;
+}
+
+//==============================================================================
+/// This encodes the pending iteration against the last one we wrote, and
+/// appends it to the file
+void IterationLogWriter::writePending()
+{
+  bool keyframe = mCompression != DELTA || !mHasWritten
+                  || mRecordsSinceKeyframe >= mKeyframeInterval
+                  || !(mPendingShape == mWrittenShape);
+
+  mBuffer.clear();
+  // Leave room for the length prefix, which we fill in at the end
+  appendRaw(mBuffer, static_cast<uint32_t>(0));
+
+  RecordHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.flags = keyframe ? KEYFRAME_FLAG : 0;
+  header.index = mPendingIndex;
+  header.loss = mPendingLoss;
+  header.constraintViolation = mPendingConstraintViolation;
+  header.numMatrices = mPendingShape.names.size();
+  appendRaw(mBuffer, header);
+  for (std::size_t i = 0; i < mPendingShape.names.size(); i++)
+  {
+    const std::string& name = mPendingShape.names[i];
+    appendRaw(mBuffer, static_cast<uint32_t>(name.size()));
+    mBuffer.insert(mBuffer.end(), name.begin(), name.end());
+    appendRaw(mBuffer, static_cast<int32_t>(mPendingShape.rows[i]));
+    appendRaw(mBuffer, static_cast<int32_t>(mPendingShape.cols[i]));
+  }
+
+  if (mCompression == FLOAT16)
+  {
+    for (double value : mPendingValues)
+    {
+      appendRaw(mBuffer, doubleToHalf(value));
+    }
+  }
+  else if (mCompression == DELTA && !keyframe)
+  {
+    for (std::size_t i = 0; i < mPendingValues.size(); i++)
+    {
+      uint64_t bits;
+      uint64_t lastBits;
+      std::memcpy(&bits, &mPendingValues[i], sizeof(bits));
+      std::memcpy(&lastBits, &mWrittenValues[i], sizeof(lastBits));
+      uint64_t diff = bits ^ lastBits;
+      // Store only up to the highest non-zero byte of the XOR
+      unsigned char numBytes = 0;
+      while (numBytes < 8 && (diff >> (8 * numBytes)) != 0)
+      {
+        numBytes++;
+      }
+      mBuffer.push_back(numBytes);
+      for (int b = 0; b < numBytes; b++)
+      {
+        mBuffer.push_back(static_cast<unsigned char>(diff >> (8 * b)));
+      }
+    }
+  }
+  else
+  {
+    for (double value : mPendingValues)
+    {
+      appendRaw(mBuffer, value);
+    }
+  }
+
+  uint32_t bodyBytes = mBuffer.size() - sizeof(uint32_t);
+  std::memcpy(mBuffer.data(), &bodyBytes, sizeof(bodyBytes));
+  mFile.write(reinterpret_cast<const char*>(mBuffer.data()), mBuffer.size());
+
+  mRecordsSinceKeyframe = keyframe ? 1 : mRecordsSinceKeyframe + 1;
+  std::swap(mWrittenShape, mPendingShape);
+  std::swap(mWrittenValues, mPendingValues);
+  mHasWritten = true;
+  mHasPending = false;
+}
+
+//==============================================================================
+/// Returns nullptr if `path` doesn't exist or isn't an iteration log
+std::shared_ptr<IterationLogReader> IterationLogReader::open(
+    const std::string& path)
+{
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+
+  unsigned char header[LOG_HEADER_BYTES];
+  if (::read(fd, header, LOG_HEADER_BYTES)
+      != static_cast<ssize_t>(LOG_HEADER_BYTES))
+  {
+    ::close(fd);
+    return nullptr;
+  }
+  uint32_t magic;
+  uint32_t version;
+  uint32_t compression;
+  std::memcpy(&magic, header, sizeof(uint32_t));
+  std::memcpy(&version, header + sizeof(uint32_t), sizeof(uint32_t));
+  std::memcpy(&compression, header + 2 * sizeof(uint32_t), sizeof(uint32_t));
+  if (magic != LOG_MAGIC || version != LOG_VERSION || compression > FLOAT16)
+  {
+    std::cout << "IterationLogReader: \"" << path
+              << "\" isn't a compatible iteration log" << std::endl;
+    ::close(fd);
+    return nullptr;
+  }
+
+  std::shared_ptr<IterationLogReader> reader(new IterationLogReader(fd, path));
+  reader->mCompression = static_cast<IterationLogCompression>(compression);
+  reader->refresh();
+  return reader;
+}
+
+//==============================================================================
+IterationLogReader::IterationLogReader(int fd, const std::string& path)
+  : mFd(fd),
+    mPath(path),
+    mMapping(nullptr),
+    mMappedSize(0),
+    mCompression(UNCOMPRESSED),
+    mScannedBytes(LOG_HEADER_BYTES),
+    mDecodedIndex(-1),
+    mDecodedStepIndex(0),
+    mDecodedLoss(0),
+    mDecodedConstraintViolation(0)
+{
+}
+
+//==============================================================================
+IterationLogReader::~IterationLogReader()
+{
+  if (mMapping != nullptr)
+  {
+    munmap(const_cast<unsigned char*>(mMapping), mMappedSize);
+  }
+  ::close(mFd);
+}
+
+//==============================================================================
+/// This picks up any records that have been appended to the log since we last
+/// looked, and returns the total number of records
+int IterationLogReader::refresh()
+{
+  struct stat status;
+  if (fstat(mFd, &status) != 0)
+  {
+    return mOffsets.size();
+  }
+  std::size_t size = status.st_size;
+  if (size > mMappedSize)
+  {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, mFd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      return mOffsets.size();
+    }
+    if (mMapping != nullptr)
+    {
+      munmap(const_cast<unsigned char*>(mMapping), mMappedSize);
+    }
+    mMapping = static_cast<const unsigned char*>(mapping);
+    mMappedSize = size;
+  }
+
+  // Only take records whose last byte has made it into the file
+  while (mScannedBytes + sizeof(uint32_t) + sizeof(uint32_t) <= mMappedSize)
+  {
+    uint32_t bodyBytes;
+    uint32_t flags;
+    std::memcpy(&bodyBytes, mMapping + mScannedBytes, sizeof(uint32_t));
+    std::memcpy(
+        &flags, mMapping + mScannedBytes + sizeof(uint32_t), sizeof(uint32_t));
+    std::size_t end = mScannedBytes + sizeof(uint32_t) + bodyBytes;
+    if (end > mMappedSize)
+      break;
+    // A reader can't decode a delta without the record it's relative to
+    if (mOffsets.empty() && !(flags & KEYFRAME_FLAG))
+      break;
+    mOffsets.push_back(mScannedBytes);
+    mKeyframes.push_back(flags & KEYFRAME_FLAG);
+    mScannedBytes = end;
+  }
+  return mOffsets.size();
+}
+
+//==============================================================================
+/// Returns the number of complete records we've found so far
+int IterationLogReader::getNumSteps() const
+{
+  return mOffsets.size();
+}
+
+//==============================================================================
+/// This decodes a single record. Reading records in order is cheap. Random
+/// access into a DELTA log decodes forward from the nearest keyframe.
+OptimizationStep IterationLogReader::getStep(int index)
+{
+  assert(index >= 0 && index < mOffsets.size());
+  if (index != mDecodedIndex)
+  {
+    int start = index;
+    while (!mKeyframes[start])
+    {
+      start--;
+    }
+    if (mDecodedIndex >= start && mDecodedIndex < index)
+    {
+      start = mDecodedIndex + 1;
+    }
+    for (int i = start; i <= index; i++)
+    {
+      decodeRecord(i);
+    }
+  }
+
+  return OptimizationStep(
+      mDecodedStepIndex,
+      unflattenRollout(mDecodedShape, mDecodedValues),
+      mDecodedLoss,
+      mDecodedConstraintViolation);
+}
+
+//==============================================================================
+/// This decodes record `index` into mDecodedValues and mDecodedShape, which
+/// must already hold record `index - 1` if this isn't a keyframe
+void IterationLogReader::decodeRecord(int index)
+{
+  const unsigned char* cursor = mMapping + mOffsets[index];
+  uint32_t bodyBytes;
+  readRaw(cursor, mMapping + mMappedSize, bodyBytes);
+  const unsigned char* end = cursor + bodyBytes;
+
+  RecordHeader header;
+  std::memset(&header, 0, sizeof(header));
+  bool ok = readRaw(cursor, end, header);
+  mDecodedIndex = index;
+  mDecodedStepIndex = header.index;
+  mDecodedLoss = header.loss;
+  mDecodedConstraintViolation = header.constraintViolation;
+
+  IterationLogShape shape;
+  for (uint32_t i = 0; ok && i < header.numMatrices; i++)
+  {
+    uint32_t nameLength;
+    int32_t rows;
+    int32_t cols;
+    ok = readRaw(cursor, end, nameLength)
+         && static_cast<std::size_t>(end - cursor) >= nameLength;
+    if (!ok)
+      break;
+    shape.names.emplace_back(reinterpret_cast<const char*>(cursor), nameLength);
+    cursor += nameLength;
+    ok = readRaw(cursor, end, rows) && readRaw(cursor, end, cols) && rows >= 0
+         && cols >= 0;
+    shape.rows.push_back(rows);
+    shape.cols.push_back(cols);
+  }
+
+  std::size_t numValues = ok ? getNumValues(shape) : 0;
+  bool keyframe = header.flags & KEYFRAME_FLAG;
+  if (!keyframe && mDecodedValues.size() != numValues)
+  {
+    ok = false;
+  }
+  mDecodedValues.resize(numValues);
+
+  for (std::size_t i = 0; ok && i < numValues; i++)
+  {
+    if (mCompression == FLOAT16)
+    {
+      uint16_t half;
+      ok = readRaw(cursor, end, half);
+      mDecodedValues[i] = halfToDouble(half);
+    }
+    else if (mCompression == DELTA && !keyframe)
+    {
+      unsigned char numBytes;
+      ok = readRaw(cursor, end, numBytes) && numBytes <= 8
+           && static_cast<std::size_t>(end - cursor) >= numBytes;
+      if (!ok)
+        break;
+      uint64_t diff = 0;
+      for (int b = 0; b < numBytes; b++)
+      {
+        diff |= static_cast<uint64_t>(cursor[b]) << (8 * b);
+      }
+      cursor += numBytes;
+      uint64_t bits;
+      std::memcpy(&bits, &mDecodedValues[i], sizeof(bits));
+      bits ^= diff;
+      std::memcpy(&mDecodedValues[i], &bits, sizeof(bits));
+    }
+    else
+    {
+      ok = readRaw(cursor, end, mDecodedValues[i]);
+    }
+  }
+
+  if (!ok)
+  {
+    std::cout << "IterationLogReader: record " << index << " of \"" << mPath
+              << "\" is corrupt" << std::endl;
+    shape = IterationLogShape();
+    mDecodedValues.clear();
+  }
+  mDecodedShape = shape;
+}
+
+} // namespace trajectory
+} // namespace dart
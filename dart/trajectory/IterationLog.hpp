@@ -0,0 +1,176 @@
+#ifndef DART_TRAJECTORY_ITERATION_LOG_HPP_
+#define DART_TRAJECTORY_ITERATION_LOG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/math/MathTypes.hpp"
+
+namespace dart {
+namespace trajectory {
+
+class TrajectoryRollout;
+struct OptimizationStep;
+
+enum IterationLogCompression
+{
+  /// Every value is stored as a full 8 byte double
+  UNCOMPRESSED = 0,
+  /// Lossless. Each value is XOR'd against the same value in the previous
+  /// record, and only the non-zero low bytes are stored. Successive iterations
+  /// of an optimizer usually share their sign, exponent and high mantissa
+  /// bits, so this typically halves the size of a log.
+  DELTA = 1,
+  /// Lossy. Every value is rounded to an IEEE half precision float, which
+  /// keeps ~3 significant digits. That's plenty for visualizing a run.
+  FLOAT16 = 2
+};
+
+/// The names and sizes of the matrices in a single record, which tell us how
+/// to turn a flat list of values back into a TrajectoryRollout
+struct IterationLogShape
+{
+  std::vector<std::string> names;
+  std::vector<int> rows;
+  std::vector<int> cols;
+
+  bool operator==(const IterationLogShape& other) const;
+};
+
+/// This writes optimization iterations to an append-only binary file, so that
+/// recording a long run doesn't need to keep a copy of every rollout in
+/// memory. Read it back with IterationLogReader, which can run in another
+/// process while the log is still being written.
+class IterationLogWriter
+{
+public:
+  /// This creates (or truncates) the log at `path`. Only every
+  /// `decimation`'th appended iteration gets written, though the most recent
+  /// iteration is always written by flush(). With DELTA compression, a full
+  /// keyframe gets written every `keyframeInterval` records, which bounds how
+  /// far a reader needs to decode to seek. Returns nullptr if the file can't
+  /// be opened.
+  static std::shared_ptr<IterationLogWriter> create(
+      const std::string& path,
+      IterationLogCompression compression = UNCOMPRESSED,
+      int decimation = 1,
+      int keyframeInterval = 32);
+
+  /// This flushes any pending iteration and closes the file
+  ~IterationLogWriter();
+
+  IterationLogWriter(const IterationLogWriter& other) = delete;
+  IterationLogWriter& operator=(const IterationLogWriter& other) = delete;
+
+  /// This records a single iteration. The rollout is only read during this
+  /// call, so it's fine to reuse it afterwards.
+  void append(
+      int index,
+      const TrajectoryRollout* rollout,
+      s_t loss,
+      s_t constraintViolation);
+
+  /// This writes the most recent iteration, if decimation skipped it, and
+  /// flushes everything to disk so that readers can see it.
+  void flush();
+
+  /// Returns the path we're writing to
+  const std::string& getPath() const;
+
+protected:
+  IterationLogWriter(
+      const std::string& path,
+      IterationLogCompression compression,
+      int decimation,
+      int keyframeInterval);
+
+  /// This encodes the pending iteration against the last one we wrote, and
+  /// appends it to the file
+  void writePending();
+
+  std::string mPath;
+  std::ofstream mFile;
+  IterationLogCompression mCompression;
+  int mDecimation;
+  int mKeyframeInterval;
+  int mNumAppended;
+  int mRecordsSinceKeyframe;
+
+  /// The last iteration we got, which hasn't been written yet
+  bool mHasPending;
+  int mPendingIndex;
+  double mPendingLoss;
+  double mPendingConstraintViolation;
+  IterationLogShape mPendingShape;
+  std::vector<double> mPendingValues;
+
+  /// The last iteration we wrote, which DELTA records are encoded against
+  bool mHasWritten;
+  IterationLogShape mWrittenShape;
+  std::vector<double> mWrittenValues;
+
+  /// Scratch space for encoding, so we don't reallocate every iteration
+  std::vector<unsigned char> mBuffer;
+};
+
+/// This reads an IterationLogWriter's log through a read-only memory mapping,
+/// decoding iterations only when they're asked for.
+class IterationLogReader
+{
+public:
+  /// Returns nullptr if `path` doesn't exist or isn't an iteration log
+  static std::shared_ptr<IterationLogReader> open(const std::string& path);
+
+  ~IterationLogReader();
+
+  IterationLogReader(const IterationLogReader& other) = delete;
+  IterationLogReader& operator=(const IterationLogReader& other) = delete;
+
+  /// This picks up any records that have been appended to the log since we
+  /// last looked, and returns the total number of records
+  int refresh();
+
+  /// Returns the number of complete records we've found so far
+  int getNumSteps() const;
+
+  /// This decodes a single record. Reading records in order is cheap. Random
+  /// access into a DELTA log decodes forward from the nearest keyframe.
+  OptimizationStep getStep(int index);
+
+protected:
+  IterationLogReader(int fd, const std::string& path);
+
+  /// This decodes record `index` into mDecodedValues and mDecodedShape, which
+  /// must already hold record `index - 1` if this isn't a keyframe
+  void decodeRecord(int index);
+
+  int mFd;
+  std::string mPath;
+  const unsigned char* mMapping;
+  std::size_t mMappedSize;
+  IterationLogCompression mCompression;
+
+  /// The byte offset of each complete record, and whether it's a keyframe
+  std::vector<std::size_t> mOffsets;
+  std::vector<bool> mKeyframes;
+  std::size_t mScannedBytes;
+
+  /// The last record we decoded
+  int mDecodedIndex;
+  int mDecodedStepIndex;
+  double mDecodedLoss;
+  double mDecodedConstraintViolation;
+  IterationLogShape mDecodedShape;
+  std::vector<double> mDecodedValues;
+};
+
+} // namespace trajectory
+} // namespace dart
+
+#endif
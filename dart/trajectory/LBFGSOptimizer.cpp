@@ -0,0 +1,322 @@
+#include "dart/trajectory/LBFGSOptimizer.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "dart/simulation/World.hpp"
+
+using namespace dart;
+using namespace simulation;
+
+namespace dart {
+namespace trajectory {
+
+namespace {
+
+/// The sufficient decrease constant for the Armijo condition
+constexpr s_t ARMIJO_C1 = 1e-4;
+
+/// Each backtracking step shrinks the step size by this factor
+constexpr s_t BACKTRACK_FACTOR = 0.5;
+
+/// We give up on a search direction after trying this many step sizes
+constexpr int MAX_BACKTRACKS = 30;
+
+} // namespace
+
+//==============================================================================
+LBFGSOptimizer::LBFGSOptimizer()
+  : mIterationLimit(100),
+    mTolerance(1e-7),
+    mHistoryLength(10),
+    mLineSearchCandidates(4),
+    mPrintFrequency(0),
+    mRecordIterations(true)
+{
+}
+
+//==============================================================================
+std::shared_ptr<Solution> LBFGSOptimizer::optimize(
+    Problem* shot, std::shared_ptr<Solution> reuseRecord)
+{
+  std::shared_ptr<Solution> record
+      = reuseRecord ? reuseRecord : std::make_shared<Solution>();
+  std::shared_ptr<World> world = shot->mWorld;
+
+  int n = shot->getFlatProblemDim(world);
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs upper = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs lower = Eigen::VectorXs::Zero(n);
+  Eigen::VectorXs grad = Eigen::VectorXs::Zero(n);
+  shot->flatten(world, x);
+  shot->getUpperBounds(world, upper);
+  shot->getLowerBounds(world, lower);
+
+  x = x.cwiseMax(lower).cwiseMin(upper);
+  shot->unflatten(world, x);
+  s_t loss = shot->getLoss(world);
+  shot->backpropGradient(world, grad);
+  mS.clear();
+  mY.clear();
+
+  // Candidate 0 runs on the problem itself, the rest get their own copies
+  std::vector<LineSearchCandidate> candidates(
+      std::max(1, mLineSearchCandidates));
+  candidates[0].world = world;
+  for (int i = 1; i < candidates.size(); i++)
+  {
+    candidates[i].problem = shot->clone();
+    candidates[i].world = world->clone();
+  }
+  if (candidates.size() > 1)
+  {
+    // Before using Eigen in a multi-threaded environment, we need to explicitly
+    // call this (at least prior to Eigen 3.3)
+    Eigen::initParallel();
+    if (!mThreadPool || mThreadPool->getNumThreads() != candidates.size())
+    {
+      mThreadPool = std::make_unique<common::ThreadPool>(candidates.size());
+    }
+  }
+
+  if (mRecordIterations)
+  {
+    record->registerIteration(0, shot->getRolloutCache(world), loss, 0.0);
+  }
+
+  bool converged = false;
+  for (int iter = 0; iter < mIterationLimit; iter++)
+  {
+    Eigen::VectorXs projected = getProjectedGradient(x, grad, lower, upper);
+    if (projected.norm() <= mTolerance)
+    {
+      converged = true;
+      break;
+    }
+
+    // Variables held at a bound by the gradient stay out of the search
+    std::vector<bool> fixed(n);
+    for (int i = 0; i < n; i++)
+    {
+      fixed[i] = projected(i) == 0 && grad(i) != 0;
+    }
+    Eigen::VectorXs direction = getSearchDirection(grad, fixed);
+    if (direction.dot(projected) >= 0)
+    {
+      // Our curvature estimate has gone bad, so start over from steepest
+      // descent
+      mS.clear();
+      mY.clear();
+      direction = -projected;
+    }
+    bool steepestDescent = mS.empty();
+
+    // Without any curvature information yet, keep the first step short
+    s_t step = steepestDescent ? std::min<s_t>(1.0, 1.0 / direction.norm())
+                               : 1.0;
+    int accepted = -1;
+    for (int tried = 0; tried < MAX_BACKTRACKS && accepted == -1;
+         tried += candidates.size())
+    {
+      for (LineSearchCandidate& candidate : candidates)
+      {
+        candidate.x = (x + step * direction).cwiseMax(lower).cwiseMin(upper);
+        step *= BACKTRACK_FACTOR;
+      }
+      evaluateCandidates(shot, candidates);
+
+      // Take the longest step that gives a sufficient decrease
+      for (int i = 0; i < candidates.size(); i++)
+      {
+        s_t expected = grad.dot(candidates[i].x - x);
+        if (expected < 0 && candidates[i].loss <= loss + ARMIJO_C1 * expected)
+        {
+          accepted = i;
+          break;
+        }
+      }
+    }
+
+    if (accepted == -1)
+    {
+      // Put the problem back where we found it
+      shot->unflatten(world, x);
+      if (steepestDescent)
+      {
+        // Not even a tiny steepest descent step helps, so we're done
+        break;
+      }
+      mS.clear();
+      mY.clear();
+      continue;
+    }
+
+    Eigen::VectorXs newX = candidates[accepted].x;
+    if (accepted != 0)
+    {
+      shot->unflatten(world, newX);
+    }
+    // If candidate 0 won, this reuses the rollout it already cached
+    Eigen::VectorXs newGrad = Eigen::VectorXs::Zero(n);
+    shot->backpropGradient(world, newGrad);
+
+    Eigen::VectorXs s = newX - x;
+    Eigen::VectorXs y = newGrad - grad;
+    // Only keep pairs that preserve a positive definite Hessian estimate
+    if (s.dot(y) > 1e-10 * y.squaredNorm())
+    {
+      mS.push_back(s);
+      mY.push_back(y);
+      if (mS.size() > mHistoryLength)
+      {
+        mS.pop_front();
+        mY.pop_front();
+      }
+    }
+    x = newX;
+    grad = newGrad;
+    loss = candidates[accepted].loss;
+
+    if (mPrintFrequency > 0 && iter % mPrintFrequency == 0)
+    {
+      std::cout << "Iter " << iter << ": " << loss << std::endl;
+    }
+    if (mRecordIterations)
+    {
+      record->registerIteration(
+          iter + 1, shot->getRolloutCache(world), loss, 0.0);
+    }
+
+    bool allCallbacksReturnedTrue = true;
+    for (auto& callback : mIntermediateCallbacks)
+    {
+      if (!callback(shot, iter, loss, 0.0))
+      {
+        allCallbacksReturnedTrue = false;
+      }
+    }
+    if (!allCallbacksReturnedTrue)
+    {
+      break;
+    }
+  }
+
+  record->setSuccess(converged);
+  return record;
+}
+
+//==============================================================================
+void LBFGSOptimizer::setIterationLimit(int iterationLimit)
+{
+  mIterationLimit = iterationLimit;
+}
+
+//==============================================================================
+/// We stop once the norm of the projected gradient falls below this
+void LBFGSOptimizer::setTolerance(s_t tolerance)
+{
+  mTolerance = tolerance;
+}
+
+//==============================================================================
+/// This sets how many (s, y) pairs we keep to approximate the inverse Hessian
+void LBFGSOptimizer::setHistoryLength(int historyLength)
+{
+  mHistoryLength = historyLength;
+}
+
+//==============================================================================
+/// This sets how many line search step sizes we roll out at the same time.
+/// Setting this to 1 gives a plain serial backtracking line search.
+void LBFGSOptimizer::setLineSearchCandidates(int candidates)
+{
+  mLineSearchCandidates = candidates;
+}
+
+//==============================================================================
+/// This sets how often (in iterations) we print progress to stdout. 0, the
+/// default, never prints.
+void LBFGSOptimizer::setPrintFrequency(int frequency)
+{
+  mPrintFrequency = frequency;
+}
+
+//==============================================================================
+/// If true (the default), every accepted step gets registered on the returned
+/// Solution
+void LBFGSOptimizer::setRecordIterations(bool recordIterations)
+{
+  mRecordIterations = recordIterations;
+}
+
+//==============================================================================
+/// This computes -H * grad with the two-loop recursion over our history,
+/// leaving the components in `fixed` at zero.
+Eigen::VectorXs LBFGSOptimizer::getSearchDirection(
+    const Eigen::VectorXs& grad, const std::vector<bool>& fixed) const
+{
+  Eigen::VectorXs q = grad;
+  for (int i = 0; i < q.size(); i++)
+  {
+    if (fixed[i])
+      q(i) = 0;
+  }
+
+  int m = mS.size();
+  std::vector<s_t> alpha(m);
+  std::vector<s_t> rho(m);
+  for (int i = m - 1; i >= 0; i--)
+  {
+    rho[i] = 1.0 / mY[i].dot(mS[i]);
+    alpha[i] = rho[i] * mS[i].dot(q);
+    q -= alpha[i] * mY[i];
+  }
+
+  // Scale the initial Hessian estimate by the most recent curvature
+  s_t gamma = 1.0;
+  if (m > 0)
+  {
+    gamma = mS[m - 1].dot(mY[m - 1]) / mY[m - 1].squaredNorm();
+  }
+  Eigen::VectorXs r = gamma * q;
+
+  for (int i = 0; i < m; i++)
+  {
+    s_t beta = rho[i] * mY[i].dot(r);
+    r += mS[i] * (alpha[i] - beta);
+  }
+
+  for (int i = 0; i < r.size(); i++)
+  {
+    if (fixed[i])
+      r(i) = 0;
+  }
+  return -r;
+}
+
+//==============================================================================
+/// This evaluates the loss at every candidate, in parallel. Candidate 0 runs
+/// on `shot` itself on the calling thread, the rest run on their own clones.
+void LBFGSOptimizer::evaluateCandidates(
+    Problem* shot, std::vector<LineSearchCandidate>& candidates)
+{
+  if (candidates.size() == 1)
+  {
+    shot->unflatten(candidates[0].world, candidates[0].x);
+    candidates[0].loss = shot->getLoss(candidates[0].world);
+    return;
+  }
+
+  // The pool has one thread per candidate, and always runs item 0 on the
+  // calling thread, so candidate 0 stays on the thread that owns `shot`
+  mThreadPool->parallelFor(candidates.size(), [&](std::size_t i) {
+    LineSearchCandidate& candidate = candidates[i];
+    Problem* problem = i == 0 ? shot : candidate.problem.get();
+    problem->unflatten(candidate.world, candidate.x);
+    candidate.loss = problem->getLoss(candidate.world);
+  });
+}
+
+} // namespace trajectory
+} // namespace dart
@@ -0,0 +1,109 @@
+#ifndef DART_TRAJECTORY_LBFGS_OPTIMIZER_HPP_
+#define DART_TRAJECTORY_LBFGS_OPTIMIZER_HPP_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/ThreadPool.hpp"
+#include "dart/trajectory/Optimizer.hpp"
+#include "dart/trajectory/Problem.hpp"
+#include "dart/trajectory/Solution.hpp"
+#include "dart/trajectory/TrajectoryConstants.hpp"
+
+namespace dart {
+
+namespace simulation {
+class World;
+}
+
+namespace trajectory {
+
+/*
+ * This is a lightweight in-process bound constrained L-BFGS, for small
+ * problems where IPOPT's setup overhead dominates (like fitting policies in an
+ * inner loop). It only respects the bounds from getUpperBounds() and
+ * getLowerBounds(), so any constraints in getConstraintDim() (like MultiShot
+ * knot points) are ignored.
+ *
+ * Each step searches along the projected path P(x + alpha * d) with a
+ * backtracking line search. The candidate step sizes are tried in batches,
+ * with each candidate in a batch rolled out at the same time on its own clone
+ * of the problem and world, on a thread pool that's kept between batches and
+ * between calls to optimize(). The longest candidate (the one that usually gets
+ * accepted) runs on the problem itself, so its rollout cache is already warm
+ * when we backprop the next gradient.
+ */
+class LBFGSOptimizer : public Optimizer
+{
+public:
+  LBFGSOptimizer();
+
+  virtual ~LBFGSOptimizer() = default;
+
+  std::shared_ptr<Solution> optimize(
+      Problem* shot, std::shared_ptr<Solution> warmStart = nullptr) override;
+
+  void setIterationLimit(int iterationLimit);
+
+  /// We stop once the norm of the projected gradient falls below this
+  void setTolerance(s_t tolerance);
+
+  /// This sets how many (s, y) pairs we keep to approximate the inverse Hessian
+  void setHistoryLength(int historyLength);
+
+  /// This sets how many line search step sizes we roll out at the same time.
+  /// Setting this to 1 gives a plain serial backtracking line search.
+  void setLineSearchCandidates(int candidates);
+
+  /// This sets how often (in iterations) we print progress to stdout. 0, the
+  /// default, never prints.
+  void setPrintFrequency(int frequency);
+
+  /// If true (the default), every accepted step gets registered on the
+  /// returned Solution
+  void setRecordIterations(bool recordIterations);
+
+protected:
+  /// One line search trial, evaluated on its own problem and world
+  struct LineSearchCandidate
+  {
+    std::shared_ptr<Problem> problem;
+    std::shared_ptr<simulation::World> world;
+    Eigen::VectorXs x;
+    s_t loss;
+  };
+
+  /// This computes -H * grad with the two-loop recursion over our history,
+  /// leaving the components in `fixed` at zero.
+  Eigen::VectorXs getSearchDirection(
+      const Eigen::VectorXs& grad, const std::vector<bool>& fixed) const;
+
+  /// This evaluates the loss at every candidate, in parallel. Candidate 0 runs
+  /// on `shot` itself on the calling thread, the rest run on their own clones.
+  void evaluateCandidates(
+      Problem* shot, std::vector<LineSearchCandidate>& candidates);
+
+  int mIterationLimit;
+  s_t mTolerance;
+  int mHistoryLength;
+  int mLineSearchCandidates;
+  int mPrintFrequency;
+  bool mRecordIterations;
+
+  /// These get reset at the start of every call to optimize()
+  std::deque<Eigen::VectorXs> mS;
+  std::deque<Eigen::VectorXs> mY;
+
+  /// This runs the line search candidates, with one thread per candidate. It's
+  /// created the first time it's needed, and only recreated when the number of
+  /// candidates changes.
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+};
+
+} // namespace trajectory
+} // namespace dart
+
+#endif
@@ -1,5 +1,8 @@
 #include "dart/trajectory/LossFn.hpp"
 
+#include <algorithm>
+#include <utility>
+
 #include "dart/utils/tl_optional.hpp"
 
 #define LOG_PERFORMANCE_LOSS_FN
@@ -13,8 +16,10 @@ namespace trajectory {
 LossFn::LossFn()
   : mLoss(tl::nullopt),
     mLossAndGrad(tl::nullopt),
+    mComplexLoss(tl::nullopt),
     mLowerBound(-std::numeric_limits<s_t>::infinity()),
-    mUpperBound(std::numeric_limits<s_t>::infinity())
+    mUpperBound(std::numeric_limits<s_t>::infinity()),
+    mNumThreads(1)
 {
 }
 
@@ -22,8 +27,10 @@ LossFn::LossFn()
 LossFn::LossFn(TrajectoryLossFn loss)
   : mLoss(loss),
     mLossAndGrad(tl::nullopt),
+    mComplexLoss(tl::nullopt),
     mLowerBound(-std::numeric_limits<s_t>::infinity()),
-    mUpperBound(std::numeric_limits<s_t>::infinity())
+    mUpperBound(std::numeric_limits<s_t>::infinity()),
+    mNumThreads(1)
 {
 }
 
@@ -31,11 +38,61 @@ LossFn::LossFn(TrajectoryLossFn loss)
 LossFn::LossFn(TrajectoryLossFn loss, TrajectoryLossFnAndGrad lossAndGrad)
   : mLoss(loss),
     mLossAndGrad(lossAndGrad),
+    mComplexLoss(tl::nullopt),
     mLowerBound(-std::numeric_limits<s_t>::infinity()),
-    mUpperBound(std::numeric_limits<s_t>::infinity())
+    mUpperBound(std::numeric_limits<s_t>::infinity()),
+    mNumThreads(1)
+{
+}
+
+//==============================================================================
+LossFn::LossFn(const LossFn& other)
+  : mLoss(other.mLoss),
+    mLossAndGrad(other.mLossAndGrad),
+    mComplexLoss(other.mComplexLoss),
+    mLowerBound(other.mLowerBound),
+    mUpperBound(other.mUpperBound),
+    mNumThreads(other.mNumThreads)
 {
 }
 
+//==============================================================================
+LossFn::LossFn(LossFn&& other)
+  : mLoss(std::move(other.mLoss)),
+    mLossAndGrad(std::move(other.mLossAndGrad)),
+    mComplexLoss(std::move(other.mComplexLoss)),
+    mLowerBound(other.mLowerBound),
+    mUpperBound(other.mUpperBound),
+    mNumThreads(other.mNumThreads),
+    mThreadPool(std::move(other.mThreadPool))
+{
+}
+
+//==============================================================================
+LossFn& LossFn::operator=(const LossFn& other)
+{
+  mLoss = other.mLoss;
+  mLossAndGrad = other.mLossAndGrad;
+  mComplexLoss = other.mComplexLoss;
+  mLowerBound = other.mLowerBound;
+  mUpperBound = other.mUpperBound;
+  setNumThreads(other.mNumThreads);
+  return *this;
+}
+
+//==============================================================================
+LossFn& LossFn::operator=(LossFn&& other)
+{
+  mLoss = std::move(other.mLoss);
+  mLossAndGrad = std::move(other.mLossAndGrad);
+  mComplexLoss = std::move(other.mComplexLoss);
+  mLowerBound = other.mLowerBound;
+  mUpperBound = other.mUpperBound;
+  mNumThreads = other.mNumThreads;
+  mThreadPool = std::move(other.mThreadPool);
+  return *this;
+}
+
 //==============================================================================
 LossFn::~LossFn()
 {
@@ -59,6 +116,12 @@ s_t LossFn::getLoss(
   {
     loss = mLoss.value()(rollout);
   }
+  else if (mComplexLoss)
+  {
+    TrajectoryRolloutReal rolloutCopy = TrajectoryRolloutReal(rollout);
+    TrajectoryRolloutComplex complexRollout(rolloutCopy);
+    loss = mComplexLoss.value()(&complexRollout).real();
+  }
 
 #ifdef LOG_PERFORMANCE_LOSS_FN
   if (thisLog != nullptr)
@@ -90,79 +153,23 @@ s_t LossFn::getLossAndGradient(
   {
     loss = mLossAndGrad.value()(rollout, gradWrtRollout);
   }
-  else if (mLoss)
+  else if (mLoss || mComplexLoss)
   {
     TrajectoryRolloutReal rolloutCopy = TrajectoryRolloutReal(rollout);
-    s_t originalLoss = mLoss.value()(&rolloutCopy);
+    loss = getLoss(&rolloutCopy);
 
-    const s_t EPS = 1e-7;
+    // This starts as a copy just to get the same layout, and then every entry
+    // gets overwritten
+    TrajectoryRolloutReal grad = rolloutCopy;
+    getGradientWithoutAnalyticalGrad(rolloutCopy, grad);
 
-    for (int i = 0; i < rolloutCopy.getMasses().size(); i++)
+    gradWrtRollout->getMasses() = grad.getMassesConst();
+    for (const std::string& key : grad.getMappings())
     {
-      rolloutCopy.getMasses()(i) += EPS;
-      s_t lossPos = mLoss.value()(&rolloutCopy);
-      rolloutCopy.getMasses()(i) -= EPS;
-
-      rolloutCopy.getMasses()(i) -= EPS;
-      s_t lossNeg = mLoss.value()(&rolloutCopy);
-      rolloutCopy.getMasses()(i) += EPS;
-
-      gradWrtRollout->getMasses()(i) = (lossPos - lossNeg) / (2 * EPS);
-    }
-
-    for (std::string key : rolloutCopy.getMappings())
-    {
-      for (int row = 0; row < rolloutCopy.getPoses(key).rows(); row++)
-      {
-        for (int col = 0; col < rolloutCopy.getPoses(key).cols(); col++)
-        {
-          rolloutCopy.getPoses(key)(row, col) += EPS;
-          s_t lossPos = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getPoses(key)(row, col) -= EPS;
-
-          rolloutCopy.getPoses(key)(row, col) -= EPS;
-          s_t lossNeg = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getPoses(key)(row, col) += EPS;
-
-          gradWrtRollout->getPoses(key)(row, col)
-              = (lossPos - lossNeg) / (2 * EPS);
-        }
-      }
-      for (int row = 0; row < rolloutCopy.getVels(key).rows(); row++)
-      {
-        for (int col = 0; col < rolloutCopy.getVels(key).cols(); col++)
-        {
-          rolloutCopy.getVels(key)(row, col) += EPS;
-          s_t lossVel = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getVels(key)(row, col) -= EPS;
-
-          rolloutCopy.getVels(key)(row, col) -= EPS;
-          s_t lossNeg = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getVels(key)(row, col) += EPS;
-
-          gradWrtRollout->getVels(key)(row, col)
-              = (lossVel - lossNeg) / (2 * EPS);
-        }
-      }
-      for (int row = 0; row < rolloutCopy.getControlForces(key).rows(); row++)
-      {
-        for (int col = 0; col < rolloutCopy.getControlForces(key).cols(); col++)
-        {
-          rolloutCopy.getControlForces(key)(row, col) += EPS;
-          s_t lossForce = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getControlForces(key)(row, col) -= EPS;
-
-          rolloutCopy.getControlForces(key)(row, col) -= EPS;
-          s_t lossNeg = mLoss.value()(&rolloutCopy);
-          rolloutCopy.getControlForces(key)(row, col) += EPS;
-
-          gradWrtRollout->getControlForces(key)(row, col)
-              = (lossForce - lossNeg) / (2 * EPS);
-        }
-      }
+      gradWrtRollout->getPoses(key) = grad.getPosesConst(key);
+      gradWrtRollout->getVels(key) = grad.getVelsConst(key);
+      gradWrtRollout->getControlForces(key) = grad.getControlForcesConst(key);
     }
-
-    loss = originalLoss;
   }
   else
   {
@@ -218,5 +225,117 @@ void LossFn::setUpperBound(s_t upperBound)
   mUpperBound = upperBound;
 }
 
+//==============================================================================
+void LossFn::setNumThreads(std::size_t numThreads)
+{
+  numThreads = std::max<std::size_t>(numThreads, 1);
+  if (numThreads == mNumThreads)
+    return;
+  mNumThreads = numThreads;
+  mThreadPool.reset();
+}
+
+//==============================================================================
+std::size_t LossFn::getNumThreads() const
+{
+  return mNumThreads;
+}
+
+//==============================================================================
+void LossFn::setComplexStepLoss(TrajectoryLossFnComplex complexLoss)
+{
+  mComplexLoss = complexLoss;
+}
+
+//==============================================================================
+void LossFn::getGradientWithoutAnalyticalGrad(
+    const TrajectoryRolloutReal& rollout,
+    /* OUT */ TrajectoryRolloutReal& grad)
+{
+  const int n = rollout.getArenaConst().size();
+  Eigen::Ref<Eigen::VectorXs> gradArena = grad.getArena();
+
+  // Each chunk perturbs its own copy of the rollout, and takes every
+  // numChunks'th entry of the arena. The result doesn't depend on how many
+  // chunks there are, because every entry is put back exactly as it was.
+  const std::size_t numChunks
+      = std::max<std::size_t>(std::min<std::size_t>(mNumThreads, n), 1);
+
+  if (mComplexLoss)
+  {
+    const s_t h = 1e-20;
+    parallelFor(numChunks, [&](std::size_t chunk) {
+      TrajectoryRolloutComplex perturbed(rollout);
+      Eigen::Ref<VectorXcs> arena = perturbed.getArena();
+      for (int i = chunk; i < n; i += numChunks)
+      {
+        std::complex<s_t> original = arena(i);
+        arena(i) += std::complex<s_t>(0, h);
+        gradArena(i) = mComplexLoss.value()(&perturbed).imag() / h;
+        arena(i) = original;
+      }
+    });
+  }
+  else
+  {
+    const s_t EPS = 1e-7;
+    parallelFor(numChunks, [&](std::size_t chunk) {
+      TrajectoryRolloutReal perturbed(rollout);
+      Eigen::Ref<Eigen::VectorXs> arena = perturbed.getArena();
+      for (int i = chunk; i < n; i += numChunks)
+      {
+        s_t original = arena(i);
+
+        arena(i) = original + EPS;
+        s_t lossPos = mLoss.value()(&perturbed);
+
+        arena(i) = original - EPS;
+        s_t lossNeg = mLoss.value()(&perturbed);
+
+        arena(i) = original;
+        gradArena(i) = (lossPos - lossNeg) / (2 * EPS);
+      }
+    });
+  }
+}
+
+//==============================================================================
+void LossFn::parallelFor(
+    std::size_t n, const std::function<void(std::size_t)>& fn)
+{
+  // MultiShotEnsemble evaluates one LossFn from all its threads at once, and
+  // ThreadPool can't take a second parallelFor() while it's running one. So
+  // whoever gets here first borrows the pool, and anyone who comes in while
+  // it's busy runs their chunks on their own thread, which is already one of
+  // the caller's threads anyway. The chunks are the same either way, so the
+  // result doesn't depend on who got the pool.
+  bool expected = false;
+  if (mNumThreads > 1
+      && mThreadPoolInUse.compare_exchange_strong(expected, true))
+  {
+    try
+    {
+      if (!mThreadPool)
+      {
+        mThreadPool = std::make_unique<common::ThreadPool>(mNumThreads);
+      }
+      mThreadPool->parallelFor(n, fn);
+    }
+    catch (...)
+    {
+      mThreadPoolInUse = false;
+      throw;
+    }
+    mThreadPoolInUse = false;
+  }
+  else
+  {
+    for (std::size_t i = 0; i < n; i++)
+    {
+      fn(i);
+    }
+  }
+}
+
 } // namespace trajectory
 } // namespace dart
\ No newline at end of file
@@ -1,10 +1,13 @@
 #ifndef DART_TRAJECTORY_LOSS_FUNCTION_HPP_
 #define DART_TRAJECTORY_LOSS_FUNCTION_HPP_
 
+#include <atomic>
+#include <complex>
 #include <memory>
 
 #include <Eigen/Dense>
 
+#include "dart/common/ThreadPool.hpp"
 #include "dart/performance/PerformanceLog.hpp"
 #include "dart/trajectory/TrajectoryConstants.hpp"
 #include "dart/trajectory/TrajectoryRollout.hpp"
@@ -24,6 +27,15 @@ typedef std::function<s_t(
     /* OUT */ TrajectoryRollout* gradWrtRollout)>
     TrajectoryLossFnAndGrad;
 
+typedef std::function<std::complex<s_t>(
+    const TrajectoryRolloutComplex* rollout)>
+    TrajectoryLossFnComplex;
+
+/// If a LossFn isn't given a TrajectoryLossFnAndGrad, getLossAndGradient()
+/// falls back to finite differencing the loss one entry of the rollout at a
+/// time. That can be spread over several threads with setNumThreads(), or
+/// replaced by the (more accurate, and half as many evaluations) complex step
+/// method, with setComplexStepLoss().
 class LossFn
 {
 public:
@@ -33,6 +45,17 @@ public:
 
   LossFn(TrajectoryLossFn loss, TrajectoryLossFnAndGrad lossAndGrad);
 
+  /// Copies get their own thread pool, if they need one
+  LossFn(const LossFn& other);
+
+  /// Moves take over the other LossFn's thread pool. Neither LossFn can be in
+  /// use while this happens.
+  LossFn(LossFn&& other);
+
+  LossFn& operator=(const LossFn& other);
+
+  LossFn& operator=(LossFn&& other);
+
   virtual ~LossFn();
 
   virtual s_t getLoss(
@@ -59,15 +82,57 @@ public:
   /// it's allowed to reach
   void setUpperBound(s_t upperBound);
 
+  /// This sets how many threads the finite difference and complex step
+  /// fallbacks in getLossAndGradient() spread their loss evaluations over.
+  /// Each thread perturbs its own copy of the rollout, but they all call the
+  /// same loss function at once, so it must be safe to call concurrently. The
+  /// default, 1, evaluates everything on the calling thread. This isn't safe
+  /// to call while another thread is evaluating this LossFn.
+  void setNumThreads(std::size_t numThreads);
+
+  /// This returns how many threads the gradient fallbacks use
+  std::size_t getNumThreads() const;
+
+  /// This sets a complex valued version of the loss, which must compute the
+  /// same function as the real one, using only operations that are analytic
+  /// (so no abs(), or branching on values). Losses templated on their scalar
+  /// type can just be instantiated with std::complex<s_t>. When there's no
+  /// TrajectoryLossFnAndGrad, getLossAndGradient() then uses this to get the
+  /// gradient with the complex step method, which needs one loss evaluation
+  /// per entry instead of two, and is accurate to machine precision. If no
+  /// real valued loss was given, getLoss() uses the real part of this.
+  void setComplexStepLoss(TrajectoryLossFnComplex complexLoss);
+
 protected:
+  /// This fills in every entry of `grad`, which must have the same layout as
+  /// `rollout`, by finite differencing (or complex stepping) the loss
+  void getGradientWithoutAnalyticalGrad(
+      const TrajectoryRolloutReal& rollout,
+      /* OUT */ TrajectoryRolloutReal& grad);
+
+  /// This calls fn(i) for every i in [0, n), across the thread pool if there is
+  /// one. The same LossFn can be evaluated from several threads at once (like
+  /// MultiShotEnsemble does for its members), but ThreadPool isn't reentrant,
+  /// so only one caller at a time gets the pool. Everyone else runs their loop
+  /// on their own thread.
+  void parallelFor(std::size_t n, const std::function<void(std::size_t)>& fn);
+
   tl::optional<TrajectoryLossFn> mLoss;
   tl::optional<TrajectoryLossFnAndGrad> mLossAndGrad;
+  tl::optional<TrajectoryLossFnComplex> mComplexLoss;
   // If this loss function is being used as a constraint, this is the lower
   // bound it's allowed to reach
   s_t mLowerBound;
   // If this loss function is being used as a constraint, this is the upper
   // bound it's allowed to reach
   s_t mUpperBound;
+
+  std::size_t mNumThreads;
+  /// This is created the first time it's needed, so that copying a LossFn
+  /// around doesn't spawn threads
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+  /// True while a caller of parallelFor() has mThreadPool to itself
+  std::atomic<bool> mThreadPoolInUse{false};
 };
 
 } // namespace trajectory
@@ -53,6 +53,27 @@ MultiShot::~MultiShot()
   // std::cout << "Freeing MultiShot: " << this << std::endl;
 }
 
+//==============================================================================
+/// This returns a deep copy of this problem, with its own empty caches
+std::shared_ptr<Problem> MultiShot::clone() const
+{
+  std::shared_ptr<MultiShot> copy = std::make_shared<MultiShot>(*this);
+  copy->mRolloutCacheDirty = true;
+  copy->mRolloutCache = nullptr;
+  copy->mGradWrtRolloutCache = nullptr;
+  for (int i = 0; i < mShots.size(); i++)
+  {
+    copy->mShots[i] = std::static_pointer_cast<SingleShot>(mShots[i]->clone());
+  }
+  // The copy can't share our parallel worlds with us, or two copies running
+  // at once would stomp on each other
+  for (int i = 0; i < mParallelWorlds.size(); i++)
+  {
+    copy->mParallelWorlds[i] = mParallelWorlds[i]->clone();
+  }
+  return copy;
+}
+
 //==============================================================================
 void MultiShot::setParallelOperationsEnabled(bool enabled)
 {
@@ -801,28 +822,24 @@ void MultiShot::getSparseJacobian(
       int dimStatic = mShots[i - 1]->getFlatStaticProblemDim(world);
       int dimDynamic = mShots[i - 1]->getFlatDynamicProblemDim(world);
 
-      // Get the dense Jacobians for static and dynamic regions
+      // The dynamic region is stored column-major, so the shot can write its
+      // Jacobian straight into a unique spot in the output, without a dense
+      // intermediate.
       Eigen::MatrixXs jacStatic = Eigen::MatrixXs::Zero(stateDim, dimStatic);
-      Eigen::MatrixXs jacDynamic = Eigen::MatrixXs::Zero(stateDim, dimDynamic);
+      Eigen::Map<Eigen::MatrixXs> jacDynamic(
+          sparseDynamic.data() + cursorDynamic, stateDim, dimDynamic);
       mShots[i - 1]->backpropJacobianOfFinalState(
           world, jacStatic, jacDynamic, thisLog);
+      cursorDynamic += stateDim * dimDynamic;
 
-      // Copy over the static Jacobian to the global static region (this will
-      // overwrite the same region a bunch of times)
+      // Copy over the static Jacobian to the global static region, which is
+      // stored row-major
 
       for (int row = 0; row < stateDim; row++)
       {
         sparseStatic.segment(cursorStatic, dimStatic) = jacStatic.row(row);
         cursorStatic += dimStatic;
       }
-
-      // Copy over the dynamic Jacobian to a unique spot in the dynamic region
-
-      for (int col = 0; col < dimDynamic; col++)
-      {
-        sparseDynamic.segment(cursorDynamic, stateDim) = jacDynamic.col(col);
-        cursorDynamic += stateDim;
-      }
       // This is the negative identity at the end of our segment in the dynamic
       // region
       sparseDynamic.segment(cursorDynamic, stateDim) = neg;
@@ -855,11 +872,14 @@ void MultiShot::asyncPartGetSparseJacobian(
   int dimStatic = mShots[index - 1]->getFlatStaticProblemDim(world);
   int dimDynamic = mShots[index - 1]->getFlatDynamicProblemDim(world);
 
-  // Get the dense Jacobians for static and dynamic regions
+  // Write the dynamic Jacobian straight into its (column-major) spot in the
+  // output
   Eigen::MatrixXs jacStatic = Eigen::MatrixXs::Zero(stateDim, dimStatic);
-  Eigen::MatrixXs jacDynamic = Eigen::MatrixXs::Zero(stateDim, dimDynamic);
+  Eigen::Map<Eigen::MatrixXs> jacDynamic(
+      sparseDynamic.data() + cursorDynamic, stateDim, dimDynamic);
   mShots[index - 1]->backpropJacobianOfFinalState(
       world, jacStatic, jacDynamic, log);
+  cursorDynamic += stateDim * dimDynamic;
 
   // Copy over the static Jacobian
 
@@ -868,14 +888,6 @@ void MultiShot::asyncPartGetSparseJacobian(
     sparseStatic.segment(cursorStatic, dimStatic) = jacStatic.row(row);
     cursorStatic += dimStatic;
   }
-
-  // Copy over the dynamic Jacobian
-
-  for (int col = 0; col < dimDynamic; col++)
-  {
-    sparseDynamic.segment(cursorDynamic, stateDim) = jacDynamic.col(col);
-    cursorDynamic += stateDim;
-  }
   // This is the negative identity at the end
   Eigen::VectorXs neg = Eigen::VectorXs::Ones(stateDim) * -1;
   sparseDynamic.segment(cursorDynamic, stateDim) = neg;
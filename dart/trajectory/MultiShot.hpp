@@ -34,6 +34,9 @@ public:
   /// Destructor
   virtual ~MultiShot() override;
 
+  /// This returns a deep copy of this problem, with its own empty caches
+  std::shared_ptr<Problem> clone() const override;
+
   /// If TRUE, this will use multiple independent threads to compute each
   /// SingleShot's values internally. Currently defaults to FALSE. This should
   /// be considered EXPERIMENTAL! Expect bugs.
@@ -0,0 +1,1027 @@
+#include "dart/trajectory/MultiShotEnsemble.hpp"
+
+#include <algorithm>
+
+#include "dart/neural/BackpropSnapshot.hpp"
+#include "dart/simulation/World.hpp"
+#include "dart/trajectory/TrajectoryRollout.hpp"
+
+#define LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+
+namespace dart {
+namespace trajectory {
+
+//==============================================================================
+MultiShotEnsemble::MultiShotEnsemble(
+    std::vector<std::shared_ptr<simulation::World>> worlds,
+    LossFn loss,
+    int steps,
+    int shotLength,
+    bool tuneStartingState)
+  : Problem(worlds[0], loss, steps),
+    mMemberWorlds(worlds),
+    mMemberWeight(1.0 / worlds.size())
+{
+  mTuneStartingState = tuneStartingState;
+
+  int dofs = worlds[0]->getNumDofs();
+  for (const std::shared_ptr<simulation::World>& world : worlds)
+  {
+    assert(world->getNumDofs() == dofs);
+    assert(world->getMassDims() == worlds[0]->getMassDims());
+    mMembers.push_back(std::make_shared<MultiShot>(
+        world, LossFn(), steps, shotLength, tuneStartingState));
+    mMemberMassOffsets.push_back(world->getMasses() - worlds[0]->getMasses());
+  }
+
+  // Lay out the shots the same way MultiShot does, so we know which entries of
+  // each member's flat dynamic vector are forces and which are knot points
+  std::vector<int> shotSteps;
+  std::vector<bool> shotTuned;
+  int stepsRemaining = steps;
+  while (stepsRemaining > 0)
+  {
+    int shot = std::min(shotLength, stepsRemaining);
+    shotSteps.push_back(shot);
+    shotTuned.push_back(shotSteps.size() > 1 || tuneStartingState);
+    stepsRemaining -= shot;
+  }
+
+  mNumSharedDims = steps * dofs;
+  mNumKnotDims = 0;
+  for (bool tuned : shotTuned)
+  {
+    if (tuned)
+      mNumKnotDims += dofs * 2;
+  }
+
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    Eigen::VectorXi indices
+        = Eigen::VectorXi::Zero(mNumSharedDims + mNumKnotDims);
+    int memberCursor = 0;
+    int forceCursor = 0;
+    int knotCursor = mNumSharedDims + i * mNumKnotDims;
+    for (int j = 0; j < shotSteps.size(); j++)
+    {
+      if (shotTuned[j])
+      {
+        for (int k = 0; k < dofs * 2; k++)
+          indices(memberCursor++) = knotCursor++;
+      }
+      for (int k = 0; k < shotSteps[j] * dofs; k++)
+        indices(memberCursor++) = forceCursor++;
+    }
+    assert(memberCursor == indices.size());
+    assert(memberCursor == mMembers[i]->getFlatDynamicProblemDim(worlds[i]));
+    mMemberDynamicIndices.push_back(indices);
+  }
+}
+
+//==============================================================================
+MultiShotEnsemble::MultiShotEnsemble(const MultiShotEnsemble& other)
+  : Problem(other),
+    mMembers(other.mMembers),
+    mMemberWorlds(other.mMemberWorlds),
+    mMemberDynamicIndices(other.mMemberDynamicIndices),
+    mMemberMassOffsets(other.mMemberMassOffsets),
+    mNumSharedDims(other.mNumSharedDims),
+    mNumKnotDims(other.mNumKnotDims),
+    mMemberWeight(other.mMemberWeight)
+{
+  setNumThreads(other.getNumThreads());
+}
+
+//==============================================================================
+MultiShotEnsemble::~MultiShotEnsemble()
+{
+}
+
+//==============================================================================
+/// This returns a deep copy of this problem, with its own empty caches
+std::shared_ptr<Problem> MultiShotEnsemble::clone() const
+{
+  std::shared_ptr<MultiShotEnsemble> copy(new MultiShotEnsemble(*this));
+  copy->mRolloutCacheDirty = true;
+  copy->mRolloutCache = nullptr;
+  copy->mGradWrtRolloutCache = nullptr;
+  // The copy can't share our member worlds with us, or two copies running at
+  // once would stomp on each other
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    copy->mMembers[i]
+        = std::static_pointer_cast<MultiShot>(mMembers[i]->clone());
+    copy->mMemberWorlds[i] = mMemberWorlds[i]->clone();
+  }
+  return copy;
+}
+
+//==============================================================================
+void MultiShotEnsemble::setNumThreads(std::size_t numThreads)
+{
+  if (numThreads == getNumThreads())
+    return;
+  if (numThreads <= 1)
+    mThreadPool.reset();
+  else
+    mThreadPool = std::make_unique<common::ThreadPool>(numThreads);
+}
+
+//==============================================================================
+std::size_t MultiShotEnsemble::getNumThreads() const
+{
+  return mThreadPool ? mThreadPool->getNumThreads() : 1;
+}
+
+//==============================================================================
+int MultiShotEnsemble::getNumMembers() const
+{
+  return mMembers.size();
+}
+
+//==============================================================================
+std::shared_ptr<MultiShot> MultiShotEnsemble::getMember(int index)
+{
+  return mMembers[index];
+}
+
+//==============================================================================
+std::shared_ptr<simulation::World> MultiShotEnsemble::getMemberWorld(int index)
+{
+  return mMemberWorlds[index];
+}
+
+//==============================================================================
+void MultiShotEnsemble::addMapping(
+    const std::string& key, std::shared_ptr<neural::Mapping> mapping)
+{
+  Problem::addMapping(key, mapping);
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->addMapping(key, mapping);
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::removeMapping(const std::string& key)
+{
+  Problem::removeMapping(key);
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->removeMapping(key);
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::pinForce(int time, Eigen::VectorXs value)
+{
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->pinForce(time, value);
+  }
+  mRolloutCacheDirty = true;
+}
+
+//==============================================================================
+Eigen::Ref<Eigen::VectorXs> MultiShotEnsemble::getPinnedForce(int time)
+{
+  return mMembers[0]->getPinnedForce(time);
+}
+
+//==============================================================================
+int MultiShotEnsemble::getFlatDynamicProblemDim(
+    std::shared_ptr<simulation::World> /* world */) const
+{
+  return mNumSharedDims + mMembers.size() * mNumKnotDims;
+}
+
+//==============================================================================
+int MultiShotEnsemble::getConstraintDim() const
+{
+  int sum = Problem::getConstraintDim();
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    sum += member->getConstraintDim();
+  }
+  return sum;
+}
+
+//==============================================================================
+void MultiShotEnsemble::flatten(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+    PerformanceLog* log) const
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.flatten");
+  }
+#endif
+
+  // Go backwards, so that the first member gets the last word on the shared
+  // values
+  for (int i = mMembers.size() - 1; i >= 0; i--)
+  {
+    Eigen::VectorXs memberDynamic
+        = Eigen::VectorXs::Zero(mMemberDynamicIndices[i].size());
+    mMembers[i]->flatten(mMemberWorlds[i], flatStatic, memberDynamic, thisLog);
+    scatterMemberDynamic(i, memberDynamic, flatDynamic);
+  }
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::unflatten(
+    std::shared_ptr<simulation::World> world,
+    const Eigen::Ref<const Eigen::VectorXs>& flatStatic,
+    const Eigen::Ref<const Eigen::VectorXs>& flatDynamic,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.unflatten");
+  }
+#endif
+
+  // Set any static values on the main world that's been passed in
+  Problem::unflatten(
+      world,
+      flatStatic.segment(0, Problem::getFlatStaticProblemDim(world)),
+      flatDynamic.segment(0, Problem::getFlatDynamicProblemDim(world)),
+      thisLog);
+  mRolloutCacheDirty = true;
+
+  PerformanceLog* memberLog = getMemberLog(thisLog);
+  forEachMember([&](std::size_t i) {
+    Eigen::VectorXs memberDynamic
+        = Eigen::VectorXs::Zero(mMemberDynamicIndices[i].size());
+    gatherMemberDynamic(i, flatDynamic, memberDynamic);
+    // The shared masses are the first member's, so put back this member's
+    // perturbation before handing them over
+    Eigen::VectorXs memberStatic = flatStatic;
+    memberStatic.head(mMemberMassOffsets[i].size()) += mMemberMassOffsets[i];
+    mMembers[i]->unflatten(
+        mMemberWorlds[i], memberStatic, memberDynamic, memberLog);
+    // The loss sees each member's rollout, so it needs to see our metadata
+    // there too
+    mMembers[i]->getMetadataMap() = mMetadata;
+  });
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::getUpperBounds(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+    PerformanceLog* log) const
+{
+  for (int i = mMembers.size() - 1; i >= 0; i--)
+  {
+    Eigen::VectorXs memberDynamic
+        = Eigen::VectorXs::Zero(mMemberDynamicIndices[i].size());
+    mMembers[i]->getUpperBounds(
+        mMemberWorlds[i], flatStatic, memberDynamic, log);
+    scatterMemberDynamic(i, memberDynamic, flatDynamic);
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::getLowerBounds(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+    PerformanceLog* log) const
+{
+  for (int i = mMembers.size() - 1; i >= 0; i--)
+  {
+    Eigen::VectorXs memberDynamic
+        = Eigen::VectorXs::Zero(mMemberDynamicIndices[i].size());
+    mMembers[i]->getLowerBounds(
+        mMemberWorlds[i], flatStatic, memberDynamic, log);
+    scatterMemberDynamic(i, memberDynamic, flatDynamic);
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::getConstraintUpperBounds(
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flat, PerformanceLog* log) const
+{
+  int cursor = Problem::getConstraintDim();
+  Problem::getConstraintUpperBounds(flat.segment(0, cursor), log);
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    int dim = member->getConstraintDim();
+    member->getConstraintUpperBounds(flat.segment(cursor, dim), log);
+    cursor += dim;
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::getConstraintLowerBounds(
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flat, PerformanceLog* log) const
+{
+  int cursor = Problem::getConstraintDim();
+  Problem::getConstraintLowerBounds(flat.segment(0, cursor), log);
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    int dim = member->getConstraintDim();
+    member->getConstraintLowerBounds(flat.segment(cursor, dim), log);
+    cursor += dim;
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::getInitialGuess(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+    PerformanceLog* log) const
+{
+  for (int i = mMembers.size() - 1; i >= 0; i--)
+  {
+    Eigen::VectorXs memberDynamic
+        = Eigen::VectorXs::Zero(mMemberDynamicIndices[i].size());
+    mMembers[i]->getInitialGuess(
+        mMemberWorlds[i], flatStatic, memberDynamic, log);
+    scatterMemberDynamic(i, memberDynamic, flatDynamic);
+  }
+}
+
+//==============================================================================
+s_t MultiShotEnsemble::getLoss(
+    std::shared_ptr<simulation::World> /* world */, PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.getLoss");
+  }
+#endif
+
+  s_t loss = getAverageLoss(mLoss, thisLog);
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+
+  return loss;
+}
+
+//==============================================================================
+void MultiShotEnsemble::backpropGradient(
+    std::shared_ptr<simulation::World> world,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> grad,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.backpropGradient");
+  }
+#endif
+
+  int staticDim = getFlatStaticProblemDim(world);
+  int dynamicDim = getFlatDynamicProblemDim(world);
+  backpropAverageLoss(
+      mLoss,
+      grad.segment(0, staticDim),
+      grad.segment(staticDim, dynamicDim),
+      thisLog);
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::computeConstraints(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> constraints,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.computeConstraints");
+  }
+#endif
+
+  // Custom constraints apply to the average across members, just like the loss
+  int numParentConstraints = Problem::getConstraintDim();
+  for (int i = 0; i < numParentConstraints; i++)
+  {
+    constraints(i) = getAverageLoss(mConstraints[i], thisLog);
+  }
+
+  std::vector<int> rowCursors;
+  int cursor = numParentConstraints;
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    rowCursors.push_back(cursor);
+    cursor += member->getConstraintDim();
+  }
+
+  PerformanceLog* memberLog = getMemberLog(thisLog);
+  forEachMember([&](std::size_t i) {
+    mMembers[i]->computeConstraints(
+        mMemberWorlds[i],
+        constraints.segment(rowCursors[i], mMembers[i]->getConstraintDim()),
+        memberLog);
+  });
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::backpropJacobian(
+    std::shared_ptr<simulation::World> world,
+    /* OUT */ Eigen::Ref<Eigen::MatrixXs> jacStatic,
+    /* OUT */ Eigen::Ref<Eigen::MatrixXs> jacDynamic,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.backpropJacobian");
+  }
+#endif
+
+  int staticDim = getFlatStaticProblemDim(world);
+  int dynamicDim = getFlatDynamicProblemDim(world);
+  assert(jacStatic.rows() == getConstraintDim());
+  assert(jacStatic.cols() == staticDim);
+  assert(jacDynamic.rows() == getConstraintDim());
+  assert(jacDynamic.cols() == dynamicDim);
+
+  jacStatic.setZero();
+  jacDynamic.setZero();
+
+  // Handle custom constraints
+  int numParentConstraints = Problem::getConstraintDim();
+  Eigen::VectorXs gradStatic = Eigen::VectorXs::Zero(staticDim);
+  Eigen::VectorXs gradDynamic = Eigen::VectorXs::Zero(dynamicDim);
+  for (int i = 0; i < numParentConstraints; i++)
+  {
+    backpropAverageLoss(mConstraints[i], gradStatic, gradDynamic, thisLog);
+    jacStatic.row(i) = gradStatic;
+    jacDynamic.row(i) = gradDynamic;
+  }
+
+  std::vector<int> rowCursors;
+  int cursor = numParentConstraints;
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    rowCursors.push_back(cursor);
+    cursor += member->getConstraintDim();
+  }
+
+  // Each member owns a disjoint set of rows, so they can all write at once
+  PerformanceLog* memberLog = getMemberLog(thisLog);
+  forEachMember([&](std::size_t i) {
+    int rows = mMembers[i]->getConstraintDim();
+    const Eigen::VectorXi& indices = mMemberDynamicIndices[i];
+    Eigen::MatrixXs memberStatic = Eigen::MatrixXs::Zero(rows, staticDim);
+    Eigen::MatrixXs memberDynamic = Eigen::MatrixXs::Zero(rows, indices.size());
+    mMembers[i]->backpropJacobian(
+        mMemberWorlds[i], memberStatic, memberDynamic, memberLog);
+    jacStatic.block(rowCursors[i], 0, rows, staticDim) = memberStatic;
+    for (int col = 0; col < indices.size(); col++)
+    {
+      jacDynamic.block(rowCursors[i], indices(col), rows, 1)
+          = memberDynamic.col(col);
+    }
+  });
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::backpropGradientWrt(
+    std::shared_ptr<simulation::World> /* world */,
+    const TrajectoryRollout* gradWrtRollout,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.backpropGradientWrt");
+  }
+#endif
+
+  int staticDim = gradStatic.size();
+  std::vector<Eigen::VectorXs> memberGrads(mMembers.size());
+  PerformanceLog* memberLog = getMemberLog(thisLog);
+  forEachMember([&](std::size_t i) {
+    int dim = mMemberDynamicIndices[i].size();
+    memberGrads[i] = Eigen::VectorXs::Zero(staticDim + dim);
+    mMembers[i]->backpropGradientWrt(
+        mMemberWorlds[i],
+        gradWrtRollout,
+        memberGrads[i].segment(0, staticDim),
+        memberGrads[i].segment(staticDim, dim),
+        memberLog);
+  });
+  reduceMemberGradients(memberGrads, gradStatic, gradDynamic);
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::getStates(
+    std::shared_ptr<simulation::World> /* world */,
+    /* OUT */ TrajectoryRollout* rollout,
+    PerformanceLog* log,
+    bool useKnots)
+{
+  mMembers[0]->getStates(mMemberWorlds[0], rollout, log, useKnots);
+}
+
+//==============================================================================
+void MultiShotEnsemble::setStates(
+    std::shared_ptr<simulation::World> /* world */,
+    const TrajectoryRollout* rollout,
+    PerformanceLog* log)
+{
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    mMembers[i]->setStates(mMemberWorlds[i], rollout, log);
+  }
+  mRolloutCacheDirty = true;
+}
+
+//==============================================================================
+void MultiShotEnsemble::setControlForcesRaw(
+    Eigen::MatrixXs forces, PerformanceLog* log)
+{
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->setControlForcesRaw(forces, log);
+  }
+  mRolloutCacheDirty = true;
+}
+
+//==============================================================================
+Eigen::VectorXi MultiShotEnsemble::advanceSteps(
+    std::shared_ptr<simulation::World> world,
+    Eigen::VectorXs startPos,
+    Eigen::VectorXs startVel,
+    int steps)
+{
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    mMembers[i]->advanceSteps(mMemberWorlds[i], startPos, startVel, steps);
+  }
+  mRolloutCacheDirty = true;
+  return Eigen::VectorXi::Zero(getFlatProblemDim(world));
+}
+
+//==============================================================================
+Eigen::VectorXs MultiShotEnsemble::getStartState()
+{
+  return mMembers[0]->getStartState();
+}
+
+//==============================================================================
+Eigen::VectorXs MultiShotEnsemble::getStartPos()
+{
+  return mMembers[0]->getStartPos();
+}
+
+//==============================================================================
+Eigen::VectorXs MultiShotEnsemble::getStartVel()
+{
+  return mMembers[0]->getStartVel();
+}
+
+//==============================================================================
+void MultiShotEnsemble::setStartPos(Eigen::VectorXs startPos)
+{
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->setStartPos(startPos);
+  }
+  mRolloutCacheDirty = true;
+}
+
+//==============================================================================
+void MultiShotEnsemble::setStartVel(Eigen::VectorXs startVel)
+{
+  for (const std::shared_ptr<MultiShot>& member : mMembers)
+  {
+    member->setStartVel(startVel);
+  }
+  mRolloutCacheDirty = true;
+}
+
+//==============================================================================
+Eigen::VectorXs MultiShotEnsemble::getFinalState(
+    std::shared_ptr<simulation::World> /* world */, PerformanceLog* log)
+{
+  return mMembers[0]->getFinalState(mMemberWorlds[0], log);
+}
+
+//==============================================================================
+std::string MultiShotEnsemble::getFlatDimName(
+    std::shared_ptr<simulation::World> world, int dim)
+{
+  int staticDim = getFlatStaticProblemDim(world);
+  if (dim < staticDim)
+  {
+    return "Static Dim " + std::to_string(dim);
+  }
+  int dynamicDim = dim - staticDim;
+  // Shared dims are named after the first member's copy of them
+  int member = 0;
+  if (dynamicDim >= mNumSharedDims)
+  {
+    if (mNumKnotDims == 0)
+    {
+      return "Error OOB";
+    }
+    member = (dynamicDim - mNumSharedDims) / mNumKnotDims;
+  }
+  if (member >= mMembers.size())
+  {
+    return "Error OOB";
+  }
+  const Eigen::VectorXi& indices = mMemberDynamicIndices[member];
+  for (int i = 0; i < indices.size(); i++)
+  {
+    if (indices(i) == dynamicDim)
+    {
+      std::string prefix = dynamicDim < mNumSharedDims
+                               ? "Shared "
+                               : "Member " + std::to_string(member) + " ";
+      return prefix
+             + mMembers[member]->getFlatDimName(
+                 mMemberWorlds[member], staticDim + i);
+    }
+  }
+  return "Error OOB";
+}
+
+//==============================================================================
+int MultiShotEnsemble::getNumberNonZeroJacobianStatic(
+    std::shared_ptr<simulation::World> world)
+{
+  int nnzj = Problem::getNumberNonZeroJacobianStatic(world);
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    nnzj += mMembers[i]->getNumberNonZeroJacobianStatic(mMemberWorlds[i]);
+  }
+  return nnzj;
+}
+
+//==============================================================================
+int MultiShotEnsemble::getNumberNonZeroJacobianDynamic(
+    std::shared_ptr<simulation::World> world)
+{
+  int nnzj = Problem::getNumberNonZeroJacobianDynamic(world);
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    nnzj += mMembers[i]->getNumberNonZeroJacobianDynamic(mMemberWorlds[i]);
+  }
+  return nnzj;
+}
+
+//==============================================================================
+void MultiShotEnsemble::getJacobianSparsityStructureStatic(
+    std::shared_ptr<simulation::World> world,
+    Eigen::Ref<Eigen::VectorXi> rows,
+    Eigen::Ref<Eigen::VectorXi> cols,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog
+        = log->startRun("MultiShotEnsemble.getJacobianSparsityStructureStatic");
+  }
+#endif
+
+  // Handle custom constraints
+  int sparseCursor = Problem::getNumberNonZeroJacobianStatic(world);
+  Problem::getJacobianSparsityStructureStatic(
+      world,
+      rows.segment(0, sparseCursor),
+      cols.segment(0, sparseCursor),
+      thisLog);
+  int rowCursor = Problem::getConstraintDim();
+
+  // Every member's knot constraints depend on all the static values
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    int nnzj = mMembers[i]->getNumberNonZeroJacobianStatic(mMemberWorlds[i]);
+    mMembers[i]->getJacobianSparsityStructureStatic(
+        mMemberWorlds[i],
+        rows.segment(sparseCursor, nnzj),
+        cols.segment(sparseCursor, nnzj),
+        thisLog);
+    rows.segment(sparseCursor, nnzj).array() += rowCursor;
+    sparseCursor += nnzj;
+    rowCursor += mMembers[i]->getConstraintDim();
+  }
+  assert(sparseCursor == rows.size());
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::getJacobianSparsityStructureDynamic(
+    std::shared_ptr<simulation::World> world,
+    Eigen::Ref<Eigen::VectorXi> rows,
+    Eigen::Ref<Eigen::VectorXi> cols,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun(
+        "MultiShotEnsemble.getJacobianSparsityStructureDynamic");
+  }
+#endif
+
+  // Handle custom constraints
+  int sparseCursor = Problem::getNumberNonZeroJacobianDynamic(world);
+  Problem::getJacobianSparsityStructureDynamic(
+      world,
+      rows.segment(0, sparseCursor),
+      cols.segment(0, sparseCursor),
+      thisLog);
+  int rowCursor = Problem::getConstraintDim();
+
+  // Each member's knot constraints only touch the shared forces and that
+  // member's own knots, so the members' blocks only overlap in the shared
+  // columns
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    int nnzj = mMembers[i]->getNumberNonZeroJacobianDynamic(mMemberWorlds[i]);
+    mMembers[i]->getJacobianSparsityStructureDynamic(
+        mMemberWorlds[i],
+        rows.segment(sparseCursor, nnzj),
+        cols.segment(sparseCursor, nnzj),
+        thisLog);
+    const Eigen::VectorXi& indices = mMemberDynamicIndices[i];
+    for (int j = sparseCursor; j < sparseCursor + nnzj; j++)
+    {
+      rows(j) += rowCursor;
+      cols(j) = indices(cols(j));
+    }
+    sparseCursor += nnzj;
+    rowCursor += mMembers[i]->getConstraintDim();
+  }
+  assert(sparseCursor == rows.size());
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+void MultiShotEnsemble::getSparseJacobian(
+    std::shared_ptr<simulation::World> world,
+    Eigen::Ref<Eigen::VectorXs> sparseStatic,
+    Eigen::Ref<Eigen::VectorXs> sparseDynamic,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("MultiShotEnsemble.getSparseJacobian");
+  }
+#endif
+
+  // Handle custom constraints, which are stored densely in row-major order
+  int staticDim = getFlatStaticProblemDim(world);
+  int dynamicDim = getFlatDynamicProblemDim(world);
+  for (int i = 0; i < Problem::getConstraintDim(); i++)
+  {
+    backpropAverageLoss(
+        mConstraints[i],
+        sparseStatic.segment(i * staticDim, staticDim),
+        sparseDynamic.segment(i * dynamicDim, dynamicDim),
+        thisLog);
+  }
+
+  std::vector<int> cursorsStatic;
+  std::vector<int> cursorsDynamic;
+  int cursorStatic = Problem::getNumberNonZeroJacobianStatic(world);
+  int cursorDynamic = Problem::getNumberNonZeroJacobianDynamic(world);
+  for (int i = 0; i < mMembers.size(); i++)
+  {
+    cursorsStatic.push_back(cursorStatic);
+    cursorsDynamic.push_back(cursorDynamic);
+    cursorStatic
+        += mMembers[i]->getNumberNonZeroJacobianStatic(mMemberWorlds[i]);
+    cursorDynamic
+        += mMembers[i]->getNumberNonZeroJacobianDynamic(mMemberWorlds[i]);
+  }
+  assert(cursorStatic == sparseStatic.size());
+  assert(cursorDynamic == sparseDynamic.size());
+
+  // Our sparsity structure lists each member's entries in the member's own
+  // order, so members can write straight into their spots in the output
+  PerformanceLog* memberLog = getMemberLog(thisLog);
+  forEachMember([&](std::size_t i) {
+    mMembers[i]->getSparseJacobian(
+        mMemberWorlds[i],
+        sparseStatic.segment(
+            cursorsStatic[i],
+            mMembers[i]->getNumberNonZeroJacobianStatic(mMemberWorlds[i])),
+        sparseDynamic.segment(
+            cursorsDynamic[i],
+            mMembers[i]->getNumberNonZeroJacobianDynamic(mMemberWorlds[i])),
+        memberLog);
+  });
+
+#ifdef LOG_PERFORMANCE_MULTI_SHOT_ENSEMBLE
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+std::vector<neural::MappedBackpropSnapshotPtr> MultiShotEnsemble::getSnapshots(
+    std::shared_ptr<simulation::World> /* world */, PerformanceLog* log)
+{
+  return mMembers[0]->getSnapshots(mMemberWorlds[0], log);
+}
+
+//==============================================================================
+void MultiShotEnsemble::forEachMember(
+    const std::function<void(std::size_t)>& fn)
+{
+  if (mThreadPool)
+  {
+    mThreadPool->parallelFor(mMembers.size(), fn);
+  }
+  else
+  {
+    for (std::size_t i = 0; i < mMembers.size(); i++)
+    {
+      fn(i);
+    }
+  }
+}
+
+//==============================================================================
+PerformanceLog* MultiShotEnsemble::getMemberLog(PerformanceLog* log) const
+{
+  return mThreadPool ? nullptr : log;
+}
+
+//==============================================================================
+void MultiShotEnsemble::gatherMemberDynamic(
+    int index,
+    const Eigen::Ref<const Eigen::VectorXs>& flatDynamic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> memberDynamic) const
+{
+  const Eigen::VectorXi& indices = mMemberDynamicIndices[index];
+  for (int i = 0; i < indices.size(); i++)
+  {
+    memberDynamic(i) = flatDynamic(indices(i));
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::scatterMemberDynamic(
+    int index,
+    const Eigen::Ref<const Eigen::VectorXs>& memberDynamic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic) const
+{
+  const Eigen::VectorXi& indices = mMemberDynamicIndices[index];
+  for (int i = 0; i < indices.size(); i++)
+  {
+    flatDynamic(indices(i)) = memberDynamic(i);
+  }
+}
+
+//==============================================================================
+void MultiShotEnsemble::reduceMemberGradients(
+    const std::vector<Eigen::VectorXs>& memberGrads,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic) const
+{
+  int staticDim = gradStatic.size();
+  gradStatic.setZero();
+  gradDynamic.setZero();
+  for (int i = 0; i < memberGrads.size(); i++)
+  {
+    gradStatic += mMemberWeight * memberGrads[i].segment(0, staticDim);
+    const Eigen::VectorXi& indices = mMemberDynamicIndices[i];
+    for (int j = 0; j < indices.size(); j++)
+    {
+      gradDynamic(indices(j)) += mMemberWeight * memberGrads[i](staticDim + j);
+    }
+  }
+}
+
+//==============================================================================
+s_t MultiShotEnsemble::getAverageLoss(LossFn& fn, PerformanceLog* log)
+{
+  std::vector<s_t> losses(mMembers.size(), 0.0);
+  PerformanceLog* memberLog = getMemberLog(log);
+  forEachMember([&](std::size_t i) {
+    losses[i] = fn.getLoss(
+        mMembers[i]->getRolloutCache(mMemberWorlds[i], memberLog), memberLog);
+  });
+
+  // Sum in a fixed order, so the result doesn't depend on the thread count
+  s_t sum = 0.0;
+  for (s_t loss : losses)
+  {
+    sum += loss;
+  }
+  return sum * mMemberWeight;
+}
+
+//==============================================================================
+void MultiShotEnsemble::backpropAverageLoss(
+    LossFn& fn,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+    /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic,
+    PerformanceLog* log)
+{
+  int staticDim = gradStatic.size();
+  std::vector<Eigen::VectorXs> memberGrads(mMembers.size());
+  PerformanceLog* memberLog = getMemberLog(log);
+  forEachMember([&](std::size_t i) {
+    std::shared_ptr<MultiShot>& member = mMembers[i];
+    std::shared_ptr<simulation::World>& world = mMemberWorlds[i];
+    int dim = mMemberDynamicIndices[i].size();
+    memberGrads[i] = Eigen::VectorXs::Zero(staticDim + dim);
+    fn.getLossAndGradient(
+        member->getRolloutCache(world, memberLog),
+        /* OUT */ member->getGradientWrtRolloutCache(world, memberLog),
+        memberLog);
+    member->backpropGradientWrt(
+        world,
+        member->getGradientWrtRolloutCache(world, memberLog),
+        /* OUT */ memberGrads[i].segment(0, staticDim),
+        /* OUT */ memberGrads[i].segment(staticDim, dim),
+        memberLog);
+  });
+  reduceMemberGradients(memberGrads, gradStatic, gradDynamic);
+}
+
+} // namespace trajectory
+} // namespace dart
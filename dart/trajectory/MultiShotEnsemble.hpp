@@ -0,0 +1,344 @@
+#ifndef DART_TRAJECTORY_MULTI_SHOT_ENSEMBLE_HPP_
+#define DART_TRAJECTORY_MULTI_SHOT_ENSEMBLE_HPP_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "dart/common/ThreadPool.hpp"
+#include "dart/trajectory/MultiShot.hpp"
+#include "dart/trajectory/Problem.hpp"
+#include "dart/trajectory/TrajectoryConstants.hpp"
+
+namespace dart {
+
+namespace simulation {
+class World;
+}
+
+namespace trajectory {
+
+/// This optimizes a single set of control forces against several variants of
+/// the same world at once (for example with perturbed masses, or different
+/// starting states), minimizing the average loss across all of them. This is
+/// useful for finding trajectories that are robust to model error.
+///
+/// Every variant gets its own MultiShot "member", simulated in its own World.
+/// The decision vector is laid out as:
+///
+///   [ static (shared) | forces (shared) | member 0 knots | member 1 knots |..]
+///
+/// The control forces are shared by every member, but each member keeps its
+/// own knot points (and starting state, if it's being tuned), because the
+/// members' trajectories diverge from each other. Each member's knot point
+/// constraints only touch the shared forces and that member's own knots, which
+/// is reflected in the sparsity structure we report to IPOPT.
+///
+/// The loss (and any custom constraints added with addConstraint()) are
+/// evaluated on every member's rollout and averaged. Members are evaluated on a
+/// persistent thread pool, see setNumThreads().
+///
+/// The static region (masses registered on the world) is shared too, and holds
+/// the first World's masses. Every other member keeps the offset its own masses
+/// had from the first World's when the ensemble was created, so perturbing a
+/// registered mass survives unflatten(). The mass bounds are the first World's.
+class MultiShotEnsemble : public Problem
+{
+public:
+  /// This creates one member for each World in `worlds`. Every World must have
+  /// the same DOFs as the first one, which is also the World that should be
+  /// passed in to the methods on this Problem. Each member starts from the
+  /// current state of its World.
+  MultiShotEnsemble(
+      std::vector<std::shared_ptr<simulation::World>> worlds,
+      LossFn loss,
+      int steps,
+      int shotLength,
+      bool tuneStartingState = true);
+
+  /// Destructor
+  virtual ~MultiShotEnsemble() override;
+
+  /// This returns a deep copy of this problem, with its own empty caches, its
+  /// own copies of the member worlds and its own thread pool
+  std::shared_ptr<Problem> clone() const override;
+
+  /// This sets how many threads evaluate members in parallel, including the
+  /// calling thread. 1, the default, evaluates every member on the calling
+  /// thread.
+  void setNumThreads(std::size_t numThreads);
+
+  /// Returns how many threads evaluate members in parallel
+  std::size_t getNumThreads() const;
+
+  /// Returns the number of members (world variants) in the ensemble
+  int getNumMembers() const;
+
+  /// This returns the member simulated in the `index`'th World. This is useful
+  /// for giving members different starting states. Control forces set directly
+  /// on a member will be overwritten by the next unflatten().
+  std::shared_ptr<MultiShot> getMember(int index);
+
+  /// This returns the World the `index`'th member is simulated in
+  std::shared_ptr<simulation::World> getMemberWorld(int index);
+
+  /// This adds a mapping to every member
+  void addMapping(
+      const std::string& key,
+      std::shared_ptr<neural::Mapping> mapping) override;
+
+  /// This removes a mapping from every member
+  void removeMapping(const std::string& key) override;
+
+  /// This pins a force in every member
+  void pinForce(int time, Eigen::VectorXs value) override;
+
+  /// This returns the pinned force value at this timestep.
+  Eigen::Ref<Eigen::VectorXs> getPinnedForce(int time) override;
+
+  /// Returns the length of the shared forces plus every member's knot points
+  int getFlatDynamicProblemDim(
+      std::shared_ptr<simulation::World> world) const override;
+
+  /// Returns the length of the custom constraints plus every member's knot
+  /// point constraints
+  int getConstraintDim() const override;
+
+  /// This copies the shared forces and every member's knot points down into
+  /// a single flat vector
+  void flatten(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+      PerformanceLog* log = nullptr) const override;
+
+  /// This hands the shared forces, and each member's knot points, out to every
+  /// member
+  void unflatten(
+      std::shared_ptr<simulation::World> world,
+      const Eigen::Ref<const Eigen::VectorXs>& flatStatic,
+      const Eigen::Ref<const Eigen::VectorXs>& flatDynamic,
+      PerformanceLog* log = nullptr) override;
+
+  /// This gets the fixed upper bounds for a flat vector, used during
+  /// optimization
+  void getUpperBounds(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+      PerformanceLog* log = nullptr) const override;
+
+  /// This gets the fixed lower bounds for a flat vector, used during
+  /// optimization
+  void getLowerBounds(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+      PerformanceLog* log = nullptr) const override;
+
+  /// This gets the bounds on the constraint functions (both knot points and any
+  /// custom constraints)
+  void getConstraintUpperBounds(
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flat,
+      PerformanceLog* log = nullptr) const override;
+
+  /// This gets the bounds on the constraint functions (both knot points and any
+  /// custom constraints)
+  void getConstraintLowerBounds(
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flat,
+      PerformanceLog* log = nullptr) const override;
+
+  /// This returns the initial guess for the values of X when running an
+  /// optimization
+  void getInitialGuess(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic,
+      PerformanceLog* log = nullptr) const override;
+
+  /// Get the loss averaged across every member's rollout
+  s_t getLoss(
+      std::shared_ptr<simulation::World> world,
+      PerformanceLog* log = nullptr) override;
+
+  /// This computes the gradient of getLoss() in the flat problem space
+  void backpropGradient(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> grad,
+      PerformanceLog* log = nullptr) override;
+
+  /// This computes the values of the constraints
+  void computeConstraints(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> constraints,
+      PerformanceLog* log = nullptr) override;
+
+  /// This computes the Jacobian that relates the flat problem to the
+  /// constraints. This returns a matrix that's (getConstraintDim(),
+  /// getFlatProblemDim()).
+  void backpropJacobian(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::Ref<Eigen::MatrixXs> jacStatic,
+      /* OUT */ Eigen::Ref<Eigen::MatrixXs> jacDynamic,
+      PerformanceLog* log = nullptr) override;
+
+  /// This takes `gradWrtRollout` to be the gradient with respect to every
+  /// member's rollout, and averages the resulting gradients across members, the
+  /// same way getLoss() averages losses.
+  void backpropGradientWrt(
+      std::shared_ptr<simulation::World> world,
+      const TrajectoryRollout* gradWrtRollout,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic,
+      PerformanceLog* log = nullptr) override;
+
+  /// This populates the passed in rollout with the first member's trajectory
+  void getStates(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ TrajectoryRollout* rollout,
+      PerformanceLog* log = nullptr,
+      bool useKnots = true) override;
+
+  /// This fills every member's trajectory with the values from the rollout
+  /// being passed in
+  void setStates(
+      std::shared_ptr<simulation::World> world,
+      const TrajectoryRollout* rollout,
+      PerformanceLog* log = nullptr) override;
+
+  /// This sets the forces of every member from the passed in matrix
+  void setControlForcesRaw(
+      Eigen::MatrixXs forces, PerformanceLog* log = nullptr) override;
+
+  /// This advances every member, all starting from the same new start state
+  Eigen::VectorXi advanceSteps(
+      std::shared_ptr<simulation::World> world,
+      Eigen::VectorXs startPos,
+      Eigen::VectorXs startVel,
+      int steps) override;
+
+  /// This returns the first member's (start pos, start vel)
+  Eigen::VectorXs getStartState() override;
+
+  /// This returns the first member's start pos
+  Eigen::VectorXs getStartPos() override;
+
+  /// This returns the first member's start vel
+  Eigen::VectorXs getStartVel() override;
+
+  /// This sets the start pos of every member
+  void setStartPos(Eigen::VectorXs startPos) override;
+
+  /// This sets the start vel of every member
+  void setStartVel(Eigen::VectorXs startVel) override;
+
+  /// This returns the first member's final (pos, vel) state
+  Eigen::VectorXs getFinalState(
+      std::shared_ptr<simulation::World> world,
+      PerformanceLog* log = nullptr) override;
+
+  /// This returns the debugging name of a given DOF
+  std::string getFlatDimName(
+      std::shared_ptr<simulation::World> world, int dim) override;
+
+  /// This gets the number of non-zero entries in the Jacobian
+  int getNumberNonZeroJacobianStatic(
+      std::shared_ptr<simulation::World> world) override;
+
+  /// This gets the number of non-zero entries in the Jacobian
+  int getNumberNonZeroJacobianDynamic(
+      std::shared_ptr<simulation::World> world) override;
+
+  /// This gets the structure of the non-zero entries in the Jacobian
+  void getJacobianSparsityStructureStatic(
+      std::shared_ptr<simulation::World> world,
+      Eigen::Ref<Eigen::VectorXi> rows,
+      Eigen::Ref<Eigen::VectorXi> cols,
+      PerformanceLog* log = nullptr) override;
+
+  /// This gets the structure of the non-zero entries in the Jacobian
+  void getJacobianSparsityStructureDynamic(
+      std::shared_ptr<simulation::World> world,
+      Eigen::Ref<Eigen::VectorXi> rows,
+      Eigen::Ref<Eigen::VectorXi> cols,
+      PerformanceLog* log = nullptr) override;
+
+  /// This writes the Jacobian to a sparse vector
+  void getSparseJacobian(
+      std::shared_ptr<simulation::World> world,
+      Eigen::Ref<Eigen::VectorXs> sparseStatic,
+      Eigen::Ref<Eigen::VectorXs> sparseDynamic,
+      PerformanceLog* log = nullptr) override;
+
+  /// This returns the snapshots from a fresh unroll of the first member
+  std::vector<neural::MappedBackpropSnapshotPtr> getSnapshots(
+      std::shared_ptr<simulation::World> world,
+      PerformanceLog* log = nullptr) override;
+
+protected:
+  /// Copies everything but the thread pool, which gets recreated with the same
+  /// number of threads. This doesn't deep copy the members, clone() does.
+  MultiShotEnsemble(const MultiShotEnsemble& other);
+
+  /// This calls fn(i) for every member, on the thread pool if there is one
+  void forEachMember(const std::function<void(std::size_t)>& fn);
+
+  /// This returns the log that work on the thread pool should use, since
+  /// PerformanceLog isn't thread safe
+  PerformanceLog* getMemberLog(PerformanceLog* log) const;
+
+  /// This copies the parts of the flat dynamic vector that belong to member
+  /// `index` into `memberDynamic`
+  void gatherMemberDynamic(
+      int index,
+      const Eigen::Ref<const Eigen::VectorXs>& flatDynamic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> memberDynamic) const;
+
+  /// This copies a member's flat dynamic vector into its spots in the flat
+  /// dynamic vector
+  void scatterMemberDynamic(
+      int index,
+      const Eigen::Ref<const Eigen::VectorXs>& memberDynamic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> flatDynamic) const;
+
+  /// This sums every member's gradient (the static region followed by the
+  /// member's dynamic region) into the flat gradient, weighted by
+  /// mMemberWeight
+  void reduceMemberGradients(
+      const std::vector<Eigen::VectorXs>& memberGrads,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic) const;
+
+  /// Returns `fn` averaged across every member's rollout
+  s_t getAverageLoss(LossFn& fn, PerformanceLog* log);
+
+  /// This computes the gradient of getAverageLoss(fn)
+  void backpropAverageLoss(
+      LossFn& fn,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradStatic,
+      /* OUT */ Eigen::Ref<Eigen::VectorXs> gradDynamic,
+      PerformanceLog* log);
+
+  std::vector<std::shared_ptr<MultiShot>> mMembers;
+  std::vector<std::shared_ptr<simulation::World>> mMemberWorlds;
+  /// For each member, where each entry of its flat dynamic vector lives in our
+  /// flat dynamic vector
+  std::vector<Eigen::VectorXi> mMemberDynamicIndices;
+  /// For each member, how far its registered masses are from the first
+  /// member's
+  std::vector<Eigen::VectorXs> mMemberMassOffsets;
+  /// The number of shared force entries at the start of the dynamic region
+  int mNumSharedDims;
+  /// The number of knot point entries each member has
+  int mNumKnotDims;
+  s_t mMemberWeight;
+  /// This is null when we're evaluating every member on the calling thread
+  std::unique_ptr<common::ThreadPool> mThreadPool;
+};
+
+} // namespace trajectory
+} // namespace dart
+
+#endif
@@ -10,5 +10,27 @@ void Optimizer::registerIntermediateCallback(
   mIntermediateCallbacks.push_back(callback);
 }
 
+//==============================================================================
+/// This returns `grad` with every component that points out of the box
+/// [lower, upper] at `x` zeroed out. Its norm is zero exactly at a first order
+/// optimum of the bound constrained problem.
+Eigen::VectorXs Optimizer::getProjectedGradient(
+    const Eigen::VectorXs& x,
+    const Eigen::VectorXs& grad,
+    const Eigen::VectorXs& lower,
+    const Eigen::VectorXs& upper)
+{
+  Eigen::VectorXs projected = grad;
+  for (int i = 0; i < x.size(); i++)
+  {
+    // A descent step moves along -grad, so a positive gradient pushes down
+    if ((grad(i) > 0 && x(i) <= lower(i)) || (grad(i) < 0 && x(i) >= upper(i)))
+    {
+      projected(i) = 0;
+    }
+  }
+  return projected;
+}
+
 } // namespace trajectory
 } // namespace dart
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <memory>
 #include <vector>
 
+#include <Eigen/Dense>
+
 #include "dart/math/MathTypes.hpp"
 
 namespace dart {
@@ -30,6 +32,15 @@ public:
           callback);
 
 protected:
+  /// This returns `grad` with every component that points out of the box
+  /// [lower, upper] at `x` zeroed out. Its norm is zero exactly at a first
+  /// order optimum of the bound constrained problem.
+  static Eigen::VectorXs getProjectedGradient(
+      const Eigen::VectorXs& x,
+      const Eigen::VectorXs& grad,
+      const Eigen::VectorXs& lower,
+      const Eigen::VectorXs& upper);
+
   std::vector<std::function<bool(Problem* problem, int, s_t primal, s_t dual)>>
       mIntermediateCallbacks;
 };
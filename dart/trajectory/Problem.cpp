@@ -1,6 +1,8 @@
 #include "dart/trajectory/Problem.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
 #include <coin/IpIpoptApplication.hpp>
 #include <coin/IpReturnCodes.hpp>
@@ -739,6 +741,76 @@ void Problem::getSparseJacobian(
       log);
 }
 
+//==============================================================================
+/// This computes the same Jacobian as backpropJacobian(), but as a native
+/// sparse matrix of size (getConstraintDim(), getFlatProblemDim()).
+void Problem::backpropSparseJacobian(
+    std::shared_ptr<simulation::World> world,
+    /* OUT */ Eigen::SparseMatrix<s_t>& jac,
+    PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_PROBLEM
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("Problem.backpropSparseJacobian");
+  }
+#endif
+
+  int nnzj = getNumberNonZeroJacobian(world);
+  int constraintDim = getConstraintDim();
+  int flatDim = getFlatProblemDim(world);
+
+  // The sparsity structure only depends on the shape of the problem, so we
+  // only sort it into compressed column order when that changes
+  if (mSparseJacobianPattern.rows() != constraintDim
+      || mSparseJacobianPattern.cols() != flatDim
+      || mSparseJacobianOrder.size() != static_cast<std::size_t>(nnzj))
+  {
+    Eigen::VectorXi rows = Eigen::VectorXi::Zero(nnzj);
+    Eigen::VectorXi cols = Eigen::VectorXi::Zero(nnzj);
+    getJacobianSparsityStructure(world, rows, cols, thisLog);
+
+    mSparseJacobianOrder.resize(nnzj);
+    std::iota(mSparseJacobianOrder.begin(), mSparseJacobianOrder.end(), 0);
+    std::stable_sort(
+        mSparseJacobianOrder.begin(),
+        mSparseJacobianOrder.end(),
+        [&](int a, int b) {
+          return cols(a) < cols(b) || (cols(a) == cols(b) && rows(a) < rows(b));
+        });
+
+    std::vector<Eigen::Triplet<s_t>> triplets;
+    triplets.reserve(nnzj);
+    for (int i = 0; i < nnzj; i++)
+    {
+      triplets.emplace_back(rows(i), cols(i), 0.0);
+    }
+    mSparseJacobianPattern.resize(constraintDim, flatDim);
+    mSparseJacobianPattern.setFromTriplets(triplets.begin(), triplets.end());
+    mSparseJacobianPattern.makeCompressed();
+    // The structure should never list an entry twice
+    assert(mSparseJacobianPattern.nonZeros() == nnzj);
+  }
+
+  Eigen::VectorXs values = Eigen::VectorXs::Zero(nnzj);
+  getSparseJacobian(world, values, thisLog);
+
+  jac = mSparseJacobianPattern;
+  s_t* jacValues = jac.valuePtr();
+  for (int k = 0; k < nnzj; k++)
+  {
+    jacValues[k] = values(mSparseJacobianOrder[k]);
+  }
+
+#ifdef LOG_PERFORMANCE_PROBLEM
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
 //==============================================================================
 /// This computes the gradient in the flat problem space, automatically
 /// computing the gradients of the loss function as part of the call
@@ -1080,12 +1152,12 @@ void Problem::finiteDifferenceGradient(
   {
     flat(i) += EPS;
     unflatten(world, flat, nullptr);
-    s_t posLoss = mLoss.getLoss(getRolloutCache(world, nullptr), nullptr);
+    s_t posLoss = getLoss(world, nullptr);
     flat(i) -= EPS;
 
     flat(i) -= EPS;
     unflatten(world, flat, nullptr);
-    s_t negLoss = mLoss.getLoss(getRolloutCache(world, nullptr), nullptr);
+    s_t negLoss = getLoss(world, nullptr);
     flat(i) += EPS;
 
     grad(i) = (posLoss - negLoss) / (2 * EPS);
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 #include "dart/neural/MappedBackpropSnapshot.hpp"
 #include "dart/neural/Mapping.hpp"
@@ -30,6 +31,8 @@ class Problem
 public:
   friend class IPOptShotWrapper;
   friend class SGDOptimizer;
+  friend class LBFGSOptimizer;
+  friend class AdamOptimizer;
 
   /// Default constructor
   Problem(std::shared_ptr<simulation::World> world, LossFn loss, int steps);
@@ -37,6 +40,12 @@ public:
   /// Abstract destructor
   virtual ~Problem();
 
+  /// This returns a deep copy of this problem, with its own empty caches. The
+  /// loss, constraints and mappings are shared with the original. A copy can
+  /// be evaluated on another thread at the same time as the original, as long
+  /// as each of them is passed its own world.
+  virtual std::shared_ptr<Problem> clone() const = 0;
+
   /// This prevents a force from changing in optimization, keeping it fixed at a
   /// specified value.
   virtual void pinForce(int time, Eigen::VectorXs value) = 0;
@@ -165,13 +174,13 @@ public:
 
   /// This computes the gradient in the flat problem space, automatically
   /// computing the gradients of the loss function as part of the call
-  void backpropGradient(
+  virtual void backpropGradient(
       std::shared_ptr<simulation::World> world,
       /* OUT */ Eigen::Ref<Eigen::VectorXs> grad,
       PerformanceLog* log = nullptr);
 
   /// Get the loss for the rollout
-  s_t getLoss(
+  virtual s_t getLoss(
       std::shared_ptr<simulation::World> world, PerformanceLog* log = nullptr);
 
   /// This computes the gradient in the flat problem space, taking into accounts
@@ -288,6 +297,18 @@ public:
       Eigen::Ref<Eigen::VectorXs> sparse,
       PerformanceLog* log = nullptr);
 
+  /// This computes the same Jacobian as backpropJacobian(), but as a native
+  /// sparse matrix of size (getConstraintDim(), getFlatProblemDim()). This
+  /// goes through getSparseJacobian(), so there's never a dense intermediate,
+  /// and memory scales with the number of non-zeros rather than with
+  /// (constraints x flat problem dim). The sparsity pattern is only rebuilt
+  /// when the shape of the problem changes. After that each call is a single
+  /// pass that copies values into the pattern's storage order.
+  void backpropSparseJacobian(
+      std::shared_ptr<simulation::World> world,
+      /* OUT */ Eigen::SparseMatrix<s_t>& jac,
+      PerformanceLog* log = nullptr);
+
   /// This returns the snapshots from a fresh unroll
   virtual std::vector<neural::MappedBackpropSnapshotPtr> getSnapshots(
       std::shared_ptr<simulation::World> world, PerformanceLog* log = nullptr)
@@ -447,6 +468,12 @@ protected:
   std::shared_ptr<TrajectoryRolloutReal> mRolloutCache;
   std::shared_ptr<TrajectoryRolloutReal> mGradWrtRolloutCache;
   std::unordered_map<std::string, Eigen::MatrixXs> mMetadata;
+
+  /// The Jacobian sparsity pattern for backpropSparseJacobian(), with zeros
+  /// for values, and the index into getSparseJacobian()'s output for each of
+  /// its stored non-zeros. These get rebuilt when the problem's shape changes.
+  Eigen::SparseMatrix<s_t> mSparseJacobianPattern;
+  std::vector<int> mSparseJacobianOrder;
 };
 
 } // namespace trajectory
@@ -35,6 +35,8 @@ SingleShot::SingleShot(
   assert(steps > 0);
   mForces = Eigen::MatrixXs::Zero(world->getNumDofs(), steps);
   mSnapshotsCacheDirty = true;
+  mCheckpointInterval = 0;
+  mCheckpointSegment = -1;
   mPinnedForces = Eigen::MatrixXs::Zero(world->getNumDofs(), steps);
   for (int i = 0; i < steps; i++)
   {
@@ -48,6 +50,26 @@ SingleShot::~SingleShot()
   // std::cout << "Freeing SingleShot: " << this << std::endl;
 }
 
+//==============================================================================
+/// This returns a deep copy of this problem, with its own empty caches
+std::shared_ptr<Problem> SingleShot::clone() const
+{
+  std::shared_ptr<SingleShot> copy = std::make_shared<SingleShot>(*this);
+  // The caches are shared pointers, so drop them rather than letting both
+  // copies write into the same rollouts
+  copy->mRolloutCacheDirty = true;
+  copy->mRolloutCache = nullptr;
+  copy->mGradWrtRolloutCache = nullptr;
+  copy->mSnapshotsCacheDirty = true;
+  copy->mSnapshotsCache.clear();
+  copy->mCheckpoints.clear();
+  copy->mCheckpointSegment = -1;
+  copy->mCheckpointPoses.clear();
+  copy->mCheckpointVels.clear();
+  copy->mCheckpointForces.clear();
+  return copy;
+}
+
 //==============================================================================
 /// This prevents a force from changing in optimization, keeping it fixed at a
 /// specified value.
@@ -372,9 +394,6 @@ void SingleShot::backpropJacobianOfFinalState(
 
   Problem::initializeStaticJacobianOfFinalState(world, jacStatic, thisLog);
 
-  std::vector<MappedBackpropSnapshotPtr> snapshots
-      = getSnapshots(world, thisLog);
-
   int posDim = world->getNumDofs();
   int velDim = world->getNumDofs();
   int forceDim = world->getNumDofs();
@@ -401,7 +420,7 @@ void SingleShot::backpropJacobianOfFinalState(
   int cursorDynamic = getFlatDynamicProblemDim(world);
   for (int i = mSteps - 1; i >= 0; i--)
   {
-    MappedBackpropSnapshotPtr ptr = snapshots[i];
+    MappedBackpropSnapshotPtr ptr = getSnapshotAt(world, i, thisLog);
     TimestepJacobians thisTimestep;
 
     world->setPositions(ptr->getPreStepPosition());
@@ -555,10 +574,6 @@ void SingleShot::backpropGradientWrt(
   _unused(staticDims);
   assert(gradDynamic.size() == dynamicDims);
 
-  std::vector<MappedBackpropSnapshotPtr> snapshots
-      = getSnapshots(world, thisLog);
-  assert(snapshots.size() == mSteps);
-
   LossGradient nextTimestep;
   nextTimestep.lossWrtPosition = Eigen::VectorXs::Zero(world->getNumDofs());
   nextTimestep.lossWrtVelocity = Eigen::VectorXs::Zero(world->getNumDofs());
@@ -588,7 +603,7 @@ void SingleShot::backpropGradientWrt(
     mappedLosses["identity"].lossWrtVelocity += nextTimestep.lossWrtVelocity;
 
     LossGradient thisTimestep;
-    snapshots[i]->backprop(
+    getSnapshotAt(world, i, thisLog)->backprop(
         world,
         thisTimestep,
         mappedLosses,
@@ -636,6 +651,25 @@ std::vector<MappedBackpropSnapshotPtr> SingleShot::getSnapshots(
   }
 #endif
 
+  if (mCheckpointInterval > 0)
+  {
+    // The caller asked for every snapshot, so there's no way to keep memory
+    // bounded here. Rebuild them segment by segment, without caching them.
+    std::vector<MappedBackpropSnapshotPtr> snapshots;
+    snapshots.reserve(mSteps);
+    for (int i = 0; i < mSteps; i++)
+    {
+      snapshots.push_back(getSnapshotAt(world, i, thisLog));
+    }
+#ifdef LOG_PERFORMANCE_SINGLE_SHOT
+    if (thisLog != nullptr)
+    {
+      thisLog->end();
+    }
+#endif
+    return snapshots;
+  }
+
   if (mSnapshotsCacheDirty)
   {
     PerformanceLog* refreshLog = nullptr;
@@ -678,6 +712,167 @@ std::vector<MappedBackpropSnapshotPtr> SingleShot::getSnapshots(
   return mSnapshotsCache;
 }
 
+//==============================================================================
+/// This turns on memory-bounded backprop for long horizons, keeping a
+/// RestorableSnapshot every `interval` timesteps. Passing 0 turns it off.
+void SingleShot::setCheckpointInterval(int interval)
+{
+  assert(interval >= 0);
+  if (interval == mCheckpointInterval)
+    return;
+  mCheckpointInterval = interval;
+  mSnapshotsCacheDirty = true;
+  mSnapshotsCache.clear();
+  mCheckpoints.clear();
+  mCheckpointSegment = -1;
+  mCheckpointPoses.clear();
+  mCheckpointVels.clear();
+  mCheckpointForces.clear();
+}
+
+//==============================================================================
+/// This returns the number of timesteps between stored checkpoints, or 0 if
+/// checkpointing is off.
+int SingleShot::getCheckpointInterval() const
+{
+  return mCheckpointInterval;
+}
+
+//==============================================================================
+/// This returns the snapshot for timestep `i`, recomputing its segment from a
+/// checkpoint if necessary
+MappedBackpropSnapshotPtr SingleShot::getSnapshotAt(
+    std::shared_ptr<simulation::World> world, int i, PerformanceLog* log)
+{
+  assert(i >= 0 && i < mSteps);
+  if (mCheckpointInterval <= 0)
+  {
+    if (mSnapshotsCacheDirty)
+    {
+      getSnapshots(world, log);
+    }
+    return mSnapshotsCache[i];
+  }
+
+  if (mSnapshotsCacheDirty)
+  {
+    refreshCheckpoints(world, log);
+  }
+  int segment = i / mCheckpointInterval;
+  if (segment != mCheckpointSegment)
+  {
+    loadCheckpointSegment(world, segment, log);
+  }
+  return mSnapshotsCache[i - segment * mCheckpointInterval];
+}
+
+//==============================================================================
+/// This unrolls the whole shot, recording a checkpoint at the start of every
+/// segment, and leaves the last segment's snapshots loaded
+void SingleShot::refreshCheckpoints(
+    std::shared_ptr<simulation::World> world, PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_SINGLE_SHOT
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("SingleShot.refreshCheckpoints");
+  }
+#endif
+
+  RestorableSnapshot snapshot(world);
+
+  mSnapshotsCache.clear();
+  mCheckpoints.clear();
+  mCheckpoints.reserve(
+      (mSteps + mCheckpointInterval - 1) / mCheckpointInterval);
+  for (auto pair : mMappings)
+  {
+    mCheckpointPoses[pair.first]
+        = Eigen::MatrixXs::Zero(pair.second->getPosDim(), mSteps);
+    mCheckpointVels[pair.first]
+        = Eigen::MatrixXs::Zero(pair.second->getVelDim(), mSteps);
+    mCheckpointForces[pair.first]
+        = Eigen::MatrixXs::Zero(pair.second->getControlForceDim(), mSteps);
+  }
+
+  world->setPositions(mStartPos);
+  world->setVelocities(mStartVel);
+
+  for (int i = 0; i < mSteps; i++)
+  {
+    if (i % mCheckpointInterval == 0)
+    {
+      // Drop the previous segment before we start building the next one, so we
+      // never hold more than one segment's worth of snapshots
+      mSnapshotsCache.clear();
+      mCheckpoints.emplace_back(world);
+      mCheckpointSegment = i / mCheckpointInterval;
+    }
+    world->setControlForces(mForces.col(i));
+    MappedBackpropSnapshotPtr ptr = mappedForwardPass(world, mMappings);
+    for (auto pair : mMappings)
+    {
+      mCheckpointPoses[pair.first].col(i)
+          = ptr->getPostStepPosition(pair.first);
+      mCheckpointVels[pair.first].col(i) = ptr->getPostStepVelocity(pair.first);
+      mCheckpointForces[pair.first].col(i) = ptr->getPreStepTorques(pair.first);
+    }
+    mSnapshotsCache.push_back(ptr);
+  }
+
+  snapshot.restore();
+  mSnapshotsCacheDirty = false;
+
+#ifdef LOG_PERFORMANCE_SINGLE_SHOT
+  if (thisLog != nullptr)
+  {
+    thisLog->end();
+  }
+#endif
+}
+
+//==============================================================================
+/// This re-runs the forward pass from a stored checkpoint to rebuild the
+/// snapshots for a single segment
+void SingleShot::loadCheckpointSegment(
+    std::shared_ptr<simulation::World> world, int segment, PerformanceLog* log)
+{
+  PerformanceLog* thisLog = nullptr;
+#ifdef LOG_PERFORMANCE_SINGLE_SHOT
+  if (log != nullptr)
+  {
+    thisLog = log->startRun("SingleShot.loadCheckpointSegment");
+  }
+#endif
+
+  assert(segment >= 0 && segment < mCheckpoints.size());
+
+  RestorableSnapshot snapshot(world);
+
+  mSnapshotsCache.clear();
+  mCheckpoints[segment].restore();
+
+  int start = segment * mCheckpointInterval;
+  int end = std::min(start + mCheckpointInterval, mSteps);
+  for (int i = start; i < end; i++)
+  {
+    world->setControlForces(mForces.col(i));
+    mSnapshotsCache.push_back(mappedForwardPass(world, mMappings));
+  }
+  mCheckpointSegment = segment;
+
+  snapshot.restore();
+
+#ifdef LOG_PERFORMANCE_SINGLE_SHOT
+  if (thisLog != nullptr)
+  {
+    thisLog->incrementCounter("recomputedSteps", end - start);
+    thisLog->end();
+  }
+#endif
+}
+
 //==============================================================================
 /// This populates the passed in matrices with the values from this trajectory
 void SingleShot::getStates(
@@ -694,8 +889,20 @@ void SingleShot::getStates(
   }
 #endif
 
-  std::vector<MappedBackpropSnapshotPtr> snapshots
-      = getSnapshots(world, thisLog);
+  // With checkpointing on, we recorded the rollout during the checkpointing
+  // pass, so we don't need to rebuild any snapshots here
+  std::vector<MappedBackpropSnapshotPtr> snapshots;
+  if (mCheckpointInterval > 0)
+  {
+    if (mSnapshotsCacheDirty)
+    {
+      refreshCheckpoints(world, thisLog);
+    }
+  }
+  else
+  {
+    snapshots = getSnapshots(world, thisLog);
+  }
 
   for (std::string key : rollout->getMappings())
   {
@@ -705,6 +912,13 @@ void SingleShot::getStates(
     assert(rollout->getVels(key).rows() == mMappings[key]->getVelDim());
     assert(rollout->getControlForces(key).cols() == mSteps);
     assert(rollout->getControlForces(key).rows() == mMappings[key]->getControlForceDim());
+    if (mCheckpointInterval > 0)
+    {
+      rollout->getPoses(key) = mCheckpointPoses[key];
+      rollout->getVels(key) = mCheckpointVels[key];
+      rollout->getControlForces(key) = mCheckpointForces[key];
+      continue;
+    }
     for (int i = 0; i < mSteps; i++)
     {
       rollout->getPoses(key).col(i) = snapshots[i]->getPostStepPosition(key);
@@ -857,14 +1071,26 @@ Eigen::VectorXs SingleShot::getFinalState(
   }
 #endif
 
-  std::vector<MappedBackpropSnapshotPtr> snapshots
-      = getSnapshots(world, thisLog);
-
   Eigen::VectorXs state = Eigen::VectorXs::Zero(getRepresentationStateSize());
-  state.segment(0, world->getNumDofs())
-      = snapshots[snapshots.size() - 1]->getPostStepPosition("identity");
-  state.segment(world->getNumDofs(), world->getNumDofs())
-      = snapshots[snapshots.size() - 1]->getPostStepVelocity("identity");
+  if (mCheckpointInterval > 0)
+  {
+    if (mSnapshotsCacheDirty)
+    {
+      refreshCheckpoints(world, thisLog);
+    }
+    state.segment(0, world->getNumDofs())
+        = mCheckpointPoses["identity"].col(mSteps - 1);
+    state.segment(world->getNumDofs(), world->getNumDofs())
+        = mCheckpointVels["identity"].col(mSteps - 1);
+  }
+  else
+  {
+    MappedBackpropSnapshotPtr last = getSnapshotAt(world, mSteps - 1, thisLog);
+    state.segment(0, world->getNumDofs())
+        = last->getPostStepPosition("identity");
+    state.segment(world->getNumDofs(), world->getNumDofs())
+        = last->getPostStepVelocity("identity");
+  }
 
 #ifdef LOG_PERFORMANCE_SINGLE_SHOT
   if (thisLog != nullptr)
@@ -2,6 +2,8 @@
 #define DART_NEURAL_SINGLE_SHOT_HPP_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -10,6 +12,7 @@
 #include "dart/neural/BackpropSnapshot.hpp"
 #include "dart/neural/MappedBackpropSnapshot.hpp"
 #include "dart/neural/NeuralUtils.hpp"
+#include "dart/neural/RestorableSnapshot.hpp"
 #include "dart/trajectory/Problem.hpp"
 #include "dart/trajectory/TrajectoryConstants.hpp"
 
@@ -35,6 +38,9 @@ public:
   /// Destructor
   virtual ~SingleShot() override;
 
+  /// This returns a deep copy of this problem, with its own empty caches
+  std::shared_ptr<Problem> clone() const override;
+
   /// This prevents a force from changing in optimization, keeping it fixed at a
   /// specified value.
   void pinForce(int time, Eigen::VectorXs value) override;
@@ -116,6 +122,19 @@ public:
       std::shared_ptr<simulation::World> world,
       PerformanceLog* log = nullptr) override;
 
+  /// This turns on memory-bounded backprop for long horizons. Instead of
+  /// keeping a MappedBackpropSnapshot for every timestep, we keep only a
+  /// RestorableSnapshot of the world every `interval` timesteps, and re-run the
+  /// forward pass for one segment at a time as backprop walks backwards. This
+  /// costs roughly one extra forward pass, and holds at most `interval`
+  /// MappedBackpropSnapshots in memory at once. Passing 0 (the default) caches
+  /// a snapshot for every timestep.
+  void setCheckpointInterval(int interval);
+
+  /// This returns the number of timesteps between stored checkpoints, or 0 if
+  /// checkpointing is off.
+  int getCheckpointInterval() const;
+
   /// This populates the passed in matrices with the values from this trajectory
   void getStates(
       std::shared_ptr<simulation::World> world,
@@ -188,6 +207,27 @@ public:
       std::shared_ptr<simulation::World> world, s_t EPS);
 
 private:
+  /// This returns the snapshot for timestep `i`. When checkpointing is on, this
+  /// recomputes the segment containing `i` from its checkpoint if that segment
+  /// isn't already loaded.
+  neural::MappedBackpropSnapshotPtr getSnapshotAt(
+      std::shared_ptr<simulation::World> world,
+      int i,
+      PerformanceLog* log = nullptr);
+
+  /// This unrolls the whole shot, recording a checkpoint at the start of every
+  /// segment along with the rollout states, and leaves the last segment's
+  /// snapshots loaded.
+  void refreshCheckpoints(
+      std::shared_ptr<simulation::World> world, PerformanceLog* log = nullptr);
+
+  /// This re-runs the forward pass from a stored checkpoint to rebuild the
+  /// snapshots for a single segment.
+  void loadCheckpointSegment(
+      std::shared_ptr<simulation::World> world,
+      int segment,
+      PerformanceLog* log = nullptr);
+
   Eigen::VectorXs mStartPos;
   Eigen::VectorXs mStartVel;
   Eigen::MatrixXs mForces;
@@ -196,6 +236,15 @@ private:
 
   bool mSnapshotsCacheDirty;
   std::vector<neural::MappedBackpropSnapshotPtr> mSnapshotsCache;
+
+  // When checkpointing is on, mSnapshotsCache only holds the snapshots for
+  // segment mCheckpointSegment
+  int mCheckpointInterval;
+  int mCheckpointSegment;
+  std::vector<neural::RestorableSnapshot> mCheckpoints;
+  std::unordered_map<std::string, Eigen::MatrixXs> mCheckpointPoses;
+  std::unordered_map<std::string, Eigen::MatrixXs> mCheckpointVels;
+  std::unordered_map<std::string, Eigen::MatrixXs> mCheckpointForces;
 };
 
 } // namespace trajectory
@@ -1,6 +1,7 @@
 #include "dart/trajectory/Solution.hpp"
 
 #include <sstream>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
@@ -23,6 +24,46 @@ Solution::Solution() : mSuccess(false), mPerfLog(nullptr)
 {
 }
 
+//==============================================================================
+/// This opens a log written by streamIterationsTo(), possibly by another
+/// process that's still writing to it. The returned Solution reads steps from
+/// the log on demand. Returns nullptr if the log can't be opened.
+std::shared_ptr<Solution> Solution::openIterationLog(const std::string& path)
+{
+  std::shared_ptr<IterationLogReader> reader = IterationLogReader::open(path);
+  if (!reader)
+    return nullptr;
+  std::shared_ptr<Solution> solution = std::make_shared<Solution>();
+  solution->mLogReader = reader;
+  return solution;
+}
+
+//==============================================================================
+/// This sends every iteration registered from now on to an append-only log
+/// file at `path`, instead of keeping a copy of each rollout in memory. Only
+/// every `decimation`'th iteration is kept (plus the last one). Steps are read
+/// back lazily from the file by getStep() and toJson(). Returns false if the
+/// file can't be created.
+bool Solution::streamIterationsTo(
+    const std::string& path,
+    IterationLogCompression compression,
+    int decimation)
+{
+  std::shared_ptr<IterationLogWriter> writer
+      = IterationLogWriter::create(path, compression, decimation);
+  if (!writer)
+    return false;
+  std::shared_ptr<IterationLogReader> reader = IterationLogReader::open(path);
+  if (!reader)
+    return false;
+
+  mLogWriter = writer;
+  mLogReader = reader;
+  mLoggedStep = nullptr;
+  mSteps.clear();
+  return true;
+}
+
 //==============================================================================
 /// This returns a reference to the PerformanceLog for this Optimization
 void Solution::startPerfLog()
@@ -119,6 +160,12 @@ void Solution::setSuccess(bool success)
   {
     mPerfLog->end();
   }
+  if (mLogWriter)
+  {
+    // Make sure the last iteration makes it into the log, even if decimation
+    // would have skipped it
+    mLogWriter->flush();
+  }
   mSuccess = success;
 }
 
@@ -129,6 +176,11 @@ void Solution::registerIteration(
     s_t loss,
     s_t constraintViolation)
 {
+  if (mLogWriter)
+  {
+    mLogWriter->append(index, rollout, loss, constraintViolation);
+    return;
+  }
   mSteps.emplace_back(index, rollout, loss, constraintViolation);
 }
 
@@ -176,13 +228,30 @@ void Solution::registerSparseJac(Eigen::VectorXs jac)
 /// Returns the number of steps that were registered
 int Solution::getNumSteps()
 {
+  if (mLogReader)
+    return mLogReader->refresh();
   return mSteps.size();
 }
 
 //==============================================================================
 /// This returns the step record for this index
-const OptimizationStep& Solution::getStep(int index)
+OptimizationStep Solution::getStep(int index)
 {
+  if (mLogReader)
+  {
+    // Logs can be far too big to hold in memory, which is the point of
+    // streaming them, so we only hang on to the last step we decoded. Callers
+    // get their own copy, so replacing it never pulls a step out from under
+    // them.
+    if (!mLoggedStep || mLoggedStep->index != index)
+    {
+      if (index < 0 || index >= mLogReader->refresh())
+        throw std::out_of_range("Solution::getStep() index out of range");
+      mLoggedStep
+          = std::make_shared<OptimizationStep>(mLogReader->getStep(index));
+    }
+    return *mLoggedStep;
+  }
   return mSteps.at(index);
 }
 
@@ -192,7 +261,16 @@ const OptimizationStep& Solution::getStep(int index)
 std::string Solution::toJson(std::shared_ptr<simulation::World> world)
 {
   std::stringstream json;
+  writeJson(world, json);
+  return json.str();
+}
 
+//==============================================================================
+/// This writes the same JSON as toJson() to `out`. When streaming to a log,
+/// this decodes one step at a time, so only a single step is ever in memory.
+void Solution::writeJson(
+    std::shared_ptr<simulation::World> world, std::ostream& json)
+{
   json << "{";
   json << "\"world\": ";
   json << world->toJson();
@@ -201,11 +279,15 @@ std::string Solution::toJson(std::shared_ptr<simulation::World> world)
   Eigen::VectorXs originalWorldPos = world->getPositions();
 
   json << ",\"record\": [";
-  for (int i = 0; i < getNumSteps(); i++)
+  int numSteps = getNumSteps();
+  for (int i = 0; i < numSteps; i++)
   {
     json << "{";
 
-    const trajectory::OptimizationStep& step = getStep(i);
+    // Read logged steps straight from the log, rather than through the cache
+    // in getStep()
+    const trajectory::OptimizationStep& step
+        = mLogReader ? mLogReader->getStep(i) : getStep(i);
     json << "\"index\": " << step.index << ",";
     json << "\"loss\": " << step.loss << ",";
     json << "\"constraintViolation\": " << step.constraintViolation << ",";
@@ -214,7 +296,7 @@ std::string Solution::toJson(std::shared_ptr<simulation::World> world)
     json << "\"trajectory\": " << step.rollout->toJson(world);
 
     json << "}";
-    if (i < getNumSteps() - 1)
+    if (i < numSteps - 1)
       json << ",";
   }
   json << "]";
@@ -222,8 +304,6 @@ std::string Solution::toJson(std::shared_ptr<simulation::World> world)
   world->setPositions(originalWorldPos);
 
   json << "}";
-
-  return json.str();
 }
 
 } // namespace trajectory
@@ -2,6 +2,7 @@
 #define DART_TRAJECTORY_OPTIMIZATION_RECORD_HPP_
 
 #include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,7 @@
 
 #include "dart/performance/PerformanceLog.hpp"
 #include "dart/trajectory/IPOptShotWrapper.hpp"
+#include "dart/trajectory/IterationLog.hpp"
 #include "dart/trajectory/TrajectoryConstants.hpp"
 #include "dart/trajectory/TrajectoryRollout.hpp"
 
@@ -42,6 +44,19 @@ struct OptimizationStep
       constraintViolation(constraintViolation)
   {
   }
+
+  /// This takes ownership of an already copied rollout
+  OptimizationStep(
+      int index,
+      std::shared_ptr<TrajectoryRollout> rollout,
+      s_t loss,
+      s_t constraintViolation)
+    : index(index),
+      rollout(rollout),
+      loss(loss),
+      constraintViolation(constraintViolation)
+  {
+  }
 };
 
 class Solution
@@ -49,6 +64,24 @@ class Solution
 public:
   Solution();
 
+  /// This opens a log written by streamIterationsTo(), possibly by another
+  /// process that's still writing to it. The returned Solution reads steps
+  /// from the log on demand. Returns nullptr if the log can't be opened.
+  static std::shared_ptr<Solution> openIterationLog(const std::string& path);
+
+  /// This sends every iteration registered from now on to an append-only log
+  /// file at `path`, instead of keeping a copy of each rollout in memory.
+  /// Only every `decimation`'th iteration is kept (plus the last one). Steps
+  /// are read back lazily from the file by getStep() and toJson(). Returns
+  /// false if the file can't be created. The full debug info (registerX() and
+  /// friends, which the IPOPT optimizer fills in when you've called
+  /// setRecordFullDebugInfo(true)) isn't streamed, and still grows in memory
+  /// every iteration.
+  bool streamIterationsTo(
+      const std::string& path,
+      IterationLogCompression compression = UNCOMPRESSED,
+      int decimation = 1);
+
   /// After optimization, register whether IPOPT thought it was a success
   void setSuccess(bool success);
 
@@ -82,13 +115,20 @@ public:
   /// Returns the number of steps that were registered
   int getNumSteps();
 
-  /// This returns the step record for this index
-  const OptimizationStep& getStep(int index);
+  /// This returns the step record for this index. The step is returned by
+  /// value, but shares its rollout with the record, so this is cheap. When
+  /// streaming to a log, this decodes the step from the log, and only keeps
+  /// the last step it decoded in memory.
+  OptimizationStep getStep(int index);
 
   /// This converts this optimization record into a JSON blob we can display on
   /// our web GUI
   std::string toJson(std::shared_ptr<simulation::World> world);
 
+  /// This writes the same JSON as toJson() to `out`. When streaming to a log,
+  /// this decodes one step at a time, so only a single step is ever in memory.
+  void writeJson(std::shared_ptr<simulation::World> world, std::ostream& out);
+
   /// This gets called by the optimizer, if we're recording performance per
   /// optimization
   void startPerfLog();
@@ -134,6 +174,10 @@ protected:
   std::vector<Eigen::VectorXs> mGradients;
   std::vector<Eigen::VectorXs> mConstraintValues;
   std::vector<Eigen::VectorXs> mSparseJacobians;
+  // When streaming iterations to a log, these replace mSteps
+  std::shared_ptr<IterationLogWriter> mLogWriter;
+  std::shared_ptr<IterationLogReader> mLogReader;
+  std::shared_ptr<OptimizationStep> mLoggedStep;
   // In order to re-optimize
   SmartPtr<Ipopt::IpoptApplication> mIpopt;
   SmartPtr<trajectory::IPOptShotWrapper> mIpoptProblem;
@@ -1,5 +1,6 @@
 #include "dart/trajectory/TrajectoryRollout.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 #include "dart/dynamics/BodyNode.hpp"
@@ -252,15 +253,32 @@ TrajectoryRolloutReal::TrajectoryRolloutReal(
     const std::unordered_map<std::string, Eigen::MatrixXs> metadata)
   : mMetadata(metadata)
 {
+  std::unordered_map<std::string, ArenaBlock> blocks;
   for (auto pair : mappings)
   {
-    mPoses[pair.first] = Eigen::MatrixXs::Zero(pair.second->getPosDim(), steps);
-    mVels[pair.first] = Eigen::MatrixXs::Zero(pair.second->getVelDim(), steps);
-    mForces[pair.first]
-        = Eigen::MatrixXs::Zero(pair.second->getControlForceDim(), steps);
-    mMappings.push_back(pair.first);
+    blocks[pair.first] = makeArenaBlock(pair.second, steps);
+  }
+  layoutArena(blocks, massDim);
+  allocateArena();
+}
+
+//==============================================================================
+TrajectoryRolloutReal::TrajectoryRolloutReal(
+    const std::unordered_map<std::string, std::shared_ptr<neural::Mapping>>
+        mappings,
+    int steps,
+    int massDim,
+    const std::unordered_map<std::string, Eigen::MatrixXs> metadata,
+    s_t* arena,
+    std::shared_ptr<void> arenaOwner)
+  : mArena(arena), mArenaOwner(arenaOwner), mMetadata(metadata)
+{
+  std::unordered_map<std::string, ArenaBlock> blocks;
+  for (auto pair : mappings)
+  {
+    blocks[pair.first] = makeArenaBlock(pair.second, steps);
   }
-  mMasses = Eigen::VectorXs::Zero(massDim);
+  layoutArena(blocks, massDim);
 }
 
 //==============================================================================
@@ -273,6 +291,19 @@ TrajectoryRolloutReal::TrajectoryRolloutReal(Problem* shot)
 {
 }
 
+//==============================================================================
+TrajectoryRolloutReal::TrajectoryRolloutReal(
+    Problem* shot, s_t* arena, std::shared_ptr<void> arenaOwner)
+  : TrajectoryRolloutReal(
+      shot->getMappings(),
+      shot->getNumSteps(),
+      shot->getMassDims(),
+      shot->getMetadataMap(),
+      arena,
+      arenaOwner)
+{
+}
+
 //==============================================================================
 /// Raw constructor
 TrajectoryRolloutReal::TrajectoryRolloutReal(
@@ -281,22 +312,28 @@ TrajectoryRolloutReal::TrajectoryRolloutReal(
     const std::unordered_map<std::string, Eigen::MatrixXs> force,
     const Eigen::VectorXs mass,
     const std::unordered_map<std::string, Eigen::MatrixXs> metadata)
-  : mMasses(mass)
+  : mMetadata(metadata)
 {
+  std::unordered_map<std::string, ArenaBlock> blocks;
   for (auto pair : pos)
   {
-    mMappings.push_back(pair.first);
+    ArenaBlock& block = blocks[pair.first];
+    block.posDim = pair.second.rows();
+    block.velDim = vel.at(pair.first).rows();
+    block.forceDim = force.at(pair.first).rows();
+    block.steps = pair.second.cols();
+    block.offset = 0;
   }
+  layoutArena(blocks, mass.size());
+  allocateArena();
+
   for (const std::string& mapping : mMappings)
   {
-    mPoses[mapping] = pos.at(mapping);
-    mVels[mapping] = vel.at(mapping);
-    mForces[mapping] = force.at(mapping);
-  }
-  for (auto pair : metadata)
-  {
-    mMetadata[pair.first] = pair.second;
+    getPoses(mapping) = pos.at(mapping);
+    getVels(mapping) = vel.at(mapping);
+    getControlForces(mapping) = force.at(mapping);
   }
+  getMasses() = mass;
 }
 
 //==============================================================================
@@ -309,70 +346,278 @@ const std::vector<std::string>& TrajectoryRolloutReal::getMappings() const
 /// Deep copy constructor
 TrajectoryRolloutReal::TrajectoryRolloutReal(const TrajectoryRollout* copy)
 {
-  mMappings = copy->getMappings();
-  for (std::string key : copy->getMappings())
+  const TrajectoryRolloutReal* real
+      = dynamic_cast<const TrajectoryRolloutReal*>(copy);
+  if (real != nullptr)
   {
-    mPoses[key] = copy->getPosesConst(key);
-    mVels[key] = copy->getVelsConst(key);
-    mForces[key] = copy->getControlForcesConst(key);
+    // Same layout, so we can take the whole arena in one go
+    *this = *real;
+    return;
   }
-  mMasses = copy->getMassesConst();
+
+  std::unordered_map<std::string, ArenaBlock> blocks;
+  for (const std::string& key : copy->getMappings())
+  {
+    ArenaBlock& block = blocks[key];
+    block.posDim = copy->getPosesConst(key).rows();
+    block.velDim = copy->getVelsConst(key).rows();
+    block.forceDim = copy->getControlForcesConst(key).rows();
+    block.steps = copy->getPosesConst(key).cols();
+    block.offset = 0;
+  }
+  layoutArena(blocks, copy->getMassesConst().size());
+  allocateArena();
+
+  for (const std::string& key : mMappings)
+  {
+    getPoses(key) = copy->getPosesConst(key);
+    getVels(key) = copy->getVelsConst(key);
+    getControlForces(key) = copy->getControlForcesConst(key);
+  }
+  getMasses() = copy->getMassesConst();
   mMetadata = copy->getMetadataMap();
 }
 
+//==============================================================================
+TrajectoryRolloutReal::TrajectoryRolloutReal(const TrajectoryRolloutReal& copy)
+  : mMappings(copy.mMappings),
+    mBlocks(copy.mBlocks),
+    mMassDim(copy.mMassDim),
+    mMassOffset(copy.mMassOffset),
+    mArenaSize(copy.mArenaSize),
+    mMetadata(copy.mMetadata)
+{
+  allocateArena();
+  std::copy(copy.mArena, copy.mArena + mArenaSize, mArena);
+}
+
+//==============================================================================
+TrajectoryRolloutReal::TrajectoryRolloutReal(TrajectoryRolloutReal&& other)
+  : mMappings(std::move(other.mMappings)),
+    mBlocks(std::move(other.mBlocks)),
+    mMassDim(other.mMassDim),
+    mMassOffset(other.mMassOffset),
+    mArenaSize(other.mArenaSize),
+    mArena(other.mArena),
+    mArenaOwner(std::move(other.mArenaOwner)),
+    mMetadata(std::move(other.mMetadata))
+{
+  other.clearArena();
+}
+
+//==============================================================================
+TrajectoryRolloutReal& TrajectoryRolloutReal::operator=(
+    TrajectoryRolloutReal&& other)
+{
+  if (this == &other)
+    return *this;
+
+  mMappings = std::move(other.mMappings);
+  mBlocks = std::move(other.mBlocks);
+  mMassDim = other.mMassDim;
+  mMassOffset = other.mMassOffset;
+  mArenaSize = other.mArenaSize;
+  mArena = other.mArena;
+  mArenaOwner = std::move(other.mArenaOwner);
+  mMetadata = std::move(other.mMetadata);
+  other.clearArena();
+  return *this;
+}
+
+//==============================================================================
+TrajectoryRolloutReal& TrajectoryRolloutReal::operator=(
+    const TrajectoryRolloutReal& copy)
+{
+  if (this == &copy)
+    return *this;
+
+  // Reuse our arena if it's already the right size, writing through to it if
+  // it's adopted. Otherwise we can't fit the copy in it, so detach.
+  if (mArena == nullptr || mArenaSize != copy.mArenaSize)
+  {
+    mArenaSize = copy.mArenaSize;
+    allocateArena();
+  }
+  mMappings = copy.mMappings;
+  mBlocks = copy.mBlocks;
+  mMassDim = copy.mMassDim;
+  mMassOffset = copy.mMassOffset;
+  mMetadata = copy.mMetadata;
+  std::copy(copy.mArena, copy.mArena + mArenaSize, mArena);
+  return *this;
+}
+
+//==============================================================================
+int TrajectoryRolloutReal::getArenaSize(
+    const std::unordered_map<std::string, std::shared_ptr<neural::Mapping>>&
+        mappings,
+    int steps,
+    int massDim)
+{
+  int size = massDim;
+  for (auto pair : mappings)
+  {
+    size += (pair.second->getPosDim() + pair.second->getVelDim()
+             + pair.second->getControlForceDim())
+            * steps;
+  }
+  return size;
+}
+
+//==============================================================================
+int TrajectoryRolloutReal::getArenaSize(Problem* shot)
+{
+  return getArenaSize(
+      shot->getMappings(), shot->getNumSteps(), shot->getMassDims());
+}
+
+//==============================================================================
+Eigen::Ref<Eigen::VectorXs> TrajectoryRolloutReal::getArena()
+{
+  return Eigen::Map<Eigen::VectorXs>(mArena, mArenaSize);
+}
+
+//==============================================================================
+const Eigen::Ref<const Eigen::VectorXs> TrajectoryRolloutReal::getArenaConst()
+    const
+{
+  return Eigen::Map<const Eigen::VectorXs>(mArena, mArenaSize);
+}
+
 //==============================================================================
 Eigen::Ref<Eigen::MatrixXs> TrajectoryRolloutReal::getPoses(
     const std::string& mapping)
 {
-  return mPoses.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<Eigen::MatrixXs>(
+      mArena + block.offset, block.posDim, block.steps);
 }
 
 //==============================================================================
 Eigen::Ref<Eigen::MatrixXs> TrajectoryRolloutReal::getVels(
     const std::string& mapping)
 {
-  return mVels.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<Eigen::MatrixXs>(
+      mArena + block.offset + block.posDim * block.steps,
+      block.velDim,
+      block.steps);
 }
 
 //==============================================================================
 Eigen::Ref<Eigen::MatrixXs> TrajectoryRolloutReal::getControlForces(
     const std::string& mapping)
 {
-  return mForces.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<Eigen::MatrixXs>(
+      mArena + block.offset + (block.posDim + block.velDim) * block.steps,
+      block.forceDim,
+      block.steps);
 }
 
 //==============================================================================
 Eigen::Ref<Eigen::VectorXs> TrajectoryRolloutReal::getMasses()
 {
-  return mMasses;
+  return Eigen::Map<Eigen::VectorXs>(mArena + mMassOffset, mMassDim);
 }
 
 //==============================================================================
 const Eigen::Ref<const Eigen::MatrixXs> TrajectoryRolloutReal::getPosesConst(
     const std::string& mapping) const
 {
-  return mPoses.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const Eigen::MatrixXs>(
+      mArena + block.offset, block.posDim, block.steps);
 }
 
 //==============================================================================
 const Eigen::Ref<const Eigen::MatrixXs> TrajectoryRolloutReal::getVelsConst(
     const std::string& mapping) const
 {
-  return mVels.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const Eigen::MatrixXs>(
+      mArena + block.offset + block.posDim * block.steps,
+      block.velDim,
+      block.steps);
 }
 
 //==============================================================================
-const Eigen::Ref<const Eigen::MatrixXs> TrajectoryRolloutReal::getControlForcesConst(
-    const std::string& mapping) const
+const Eigen::Ref<const Eigen::MatrixXs>
+TrajectoryRolloutReal::getControlForcesConst(const std::string& mapping) const
 {
-  return mForces.at(mapping);
+  const ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const Eigen::MatrixXs>(
+      mArena + block.offset + (block.posDim + block.velDim) * block.steps,
+      block.forceDim,
+      block.steps);
 }
 
 //==============================================================================
 const Eigen::Ref<const Eigen::VectorXs> TrajectoryRolloutReal::getMassesConst()
     const
 {
-  return mMasses;
+  return Eigen::Map<const Eigen::VectorXs>(mArena + mMassOffset, mMassDim);
+}
+
+//==============================================================================
+TrajectoryRolloutReal::ArenaBlock TrajectoryRolloutReal::makeArenaBlock(
+    std::shared_ptr<neural::Mapping> mapping, int steps)
+{
+  ArenaBlock block;
+  block.posDim = mapping->getPosDim();
+  block.velDim = mapping->getVelDim();
+  block.forceDim = mapping->getControlForceDim();
+  block.steps = steps;
+  block.offset = 0;
+  return block;
+}
+
+//==============================================================================
+void TrajectoryRolloutReal::layoutArena(
+    const std::unordered_map<std::string, ArenaBlock>& blocks, int massDim)
+{
+  // Sort the mappings, so the layout doesn't depend on hashing and people
+  // adopting an arena can rely on it
+  mMappings.clear();
+  for (auto pair : blocks)
+  {
+    mMappings.push_back(pair.first);
+  }
+  std::sort(mMappings.begin(), mMappings.end());
+
+  int cursor = 0;
+  mBlocks.clear();
+  for (const std::string& mapping : mMappings)
+  {
+    ArenaBlock block = blocks.at(mapping);
+    block.offset = cursor;
+    cursor += (block.posDim + block.velDim + block.forceDim) * block.steps;
+    mBlocks[mapping] = block;
+  }
+  mMassDim = massDim;
+  mMassOffset = cursor;
+  mArenaSize = cursor + massDim;
+}
+
+//==============================================================================
+void TrajectoryRolloutReal::clearArena()
+{
+  mMappings.clear();
+  mBlocks.clear();
+  mMassDim = 0;
+  mMassOffset = 0;
+  mArenaSize = 0;
+  mArena = nullptr;
+  mArenaOwner = nullptr;
+}
+
+//==============================================================================
+void TrajectoryRolloutReal::allocateArena()
+{
+  std::shared_ptr<s_t> arena(
+      new s_t[mArenaSize](), std::default_delete<s_t[]>());
+  mArena = arena.get();
+  mArenaOwner = arena;
 }
 
 //==============================================================================
@@ -597,5 +842,80 @@ void TrajectoryRolloutConstRef::setMetadata(
   assert(false && "It should be impossible to get a mutable reference from a TrajectorRolloutConstRef");
 }
 
+//==============================================================================
+TrajectoryRolloutComplex::TrajectoryRolloutComplex(
+    const TrajectoryRolloutReal& real)
+  : mMappings(real.mMappings),
+    mBlocks(real.mBlocks),
+    mMassDim(real.mMassDim),
+    mMassOffset(real.mMassOffset),
+    mArena(real.getArenaConst().cast<std::complex<s_t>>()),
+    mMetadata(real.mMetadata)
+{
+}
+
+//==============================================================================
+const std::vector<std::string>& TrajectoryRolloutComplex::getMappings() const
+{
+  return mMappings;
+}
+
+//==============================================================================
+const Eigen::Ref<const MatrixXcs> TrajectoryRolloutComplex::getPosesConst(
+    const std::string& mapping) const
+{
+  const TrajectoryRolloutReal::ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const MatrixXcs>(
+      mArena.data() + block.offset, block.posDim, block.steps);
+}
+
+//==============================================================================
+const Eigen::Ref<const MatrixXcs> TrajectoryRolloutComplex::getVelsConst(
+    const std::string& mapping) const
+{
+  const TrajectoryRolloutReal::ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const MatrixXcs>(
+      mArena.data() + block.offset + block.posDim * block.steps,
+      block.velDim,
+      block.steps);
+}
+
+//==============================================================================
+const Eigen::Ref<const MatrixXcs>
+TrajectoryRolloutComplex::getControlForcesConst(
+    const std::string& mapping) const
+{
+  const TrajectoryRolloutReal::ArenaBlock& block = mBlocks.at(mapping);
+  return Eigen::Map<const MatrixXcs>(
+      mArena.data() + block.offset
+          + (block.posDim + block.velDim) * block.steps,
+      block.forceDim,
+      block.steps);
+}
+
+//==============================================================================
+const Eigen::Ref<const VectorXcs> TrajectoryRolloutComplex::getMassesConst()
+    const
+{
+  return mArena.segment(mMassOffset, mMassDim);
+}
+
+//==============================================================================
+Eigen::MatrixXs TrajectoryRolloutComplex::getMetadata(
+    const std::string& key) const
+{
+  if (mMetadata.find(key) != mMetadata.end())
+  {
+    return mMetadata.at(key);
+  }
+  return Eigen::MatrixXs::Zero(0, 0);
+}
+
+//==============================================================================
+Eigen::Ref<VectorXcs> TrajectoryRolloutComplex::getArena()
+{
+  return mArena;
+}
+
 } // namespace trajectory
 } // namespace dart
\ No newline at end of file
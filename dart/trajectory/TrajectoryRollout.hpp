@@ -1,6 +1,7 @@
 #ifndef DART_TRAJECTORY_ROLLOUT_HPP_
 #define DART_TRAJECTORY_ROLLOUT_HPP_
 
+#include <complex>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,6 +25,11 @@ class Problem;
 class TrajectoryRolloutReal;
 class TrajectoryRolloutRef;
 class TrajectoryRolloutConstRef;
+class TrajectoryRolloutComplex;
+
+typedef Eigen::Matrix<std::complex<s_t>, Eigen::Dynamic, Eigen::Dynamic>
+    MatrixXcs;
+typedef Eigen::Matrix<std::complex<s_t>, Eigen::Dynamic, 1> VectorXcs;
 
 class TrajectoryRollout
 {
@@ -91,6 +97,12 @@ public:
       std::vector<Eigen::VectorXs> poses);
 };
 
+/// This owns all of its numbers in a single contiguous buffer, the "arena".
+/// The arena holds each mapping in the (alphabetical) order of getMappings(),
+/// with that mapping's poses, then vels, then control forces, each stored
+/// column-major as (dim x steps). The masses come last. That makes copies a
+/// single memcpy, and lets an arena be shared with NumPy or Torch without
+/// copying, see getArena() and the adopting constructor.
 class TrajectoryRolloutReal : public TrajectoryRollout
 {
 public:
@@ -102,12 +114,49 @@ public:
       int massDim,
       const std::unordered_map<std::string, Eigen::MatrixXs> metadata);
 
+  /// This creates a rollout that reads and writes `arena` in place, instead of
+  /// allocating its own. `arena` must hold getArenaSize(mappings, steps,
+  /// massDim) numbers, laid out as described above. If `arenaOwner` is passed,
+  /// we hold onto it for as long as we're using `arena`. Otherwise, the caller
+  /// must keep `arena` alive for as long as this rollout exists.
+  TrajectoryRolloutReal(
+      const std::unordered_map<std::string, std::shared_ptr<neural::Mapping>>
+          mappings,
+      int steps,
+      int massDim,
+      const std::unordered_map<std::string, Eigen::MatrixXs> metadata,
+      s_t* arena,
+      std::shared_ptr<void> arenaOwner = nullptr);
+
   /// Create a fresh trajector rollout for a shot
   TrajectoryRolloutReal(Problem* shot);
 
+  /// Create a trajectory rollout for a shot that uses `arena` in place, which
+  /// must hold getArenaSize(shot) numbers. See the adopting constructor above.
+  TrajectoryRolloutReal(
+      Problem* shot, s_t* arena, std::shared_ptr<void> arenaOwner = nullptr);
+
   /// Deep copy constructor
   TrajectoryRolloutReal(const TrajectoryRollout* copy);
 
+  /// Deep copy constructor. The copy always gets its own arena, even if
+  /// `copy` is using an adopted one.
+  TrajectoryRolloutReal(const TrajectoryRolloutReal& copy);
+
+  /// Move constructor, which takes over the arena. `other` is left empty,
+  /// with no arena.
+  TrajectoryRolloutReal(TrajectoryRolloutReal&& other);
+
+  /// Deep copy assignment. If our arena is already the same size as `copy`'s,
+  /// the values are written into it in place, even if it's an adopted arena,
+  /// so a NumPy or Torch view onto it sees the new values. Otherwise we let go
+  /// of our arena (adopted or not) and allocate a fresh one of our own.
+  TrajectoryRolloutReal& operator=(const TrajectoryRolloutReal& copy);
+
+  /// Move assignment, which lets go of our arena (adopted or not) and takes
+  /// over `other`'s. `other` is left empty, with no arena.
+  TrajectoryRolloutReal& operator=(TrajectoryRolloutReal&& other);
+
   /// Raw constructor
   TrajectoryRolloutReal(
       const std::unordered_map<std::string, Eigen::MatrixXs> pos,
@@ -116,6 +165,24 @@ public:
       const Eigen::VectorXs mass,
       const std::unordered_map<std::string, Eigen::MatrixXs> metadata);
 
+  /// Returns the number of numbers in the arena of a rollout with these
+  /// dimensions
+  static int getArenaSize(
+      const std::unordered_map<std::string, std::shared_ptr<neural::Mapping>>&
+          mappings,
+      int steps,
+      int massDim);
+
+  /// Returns the number of numbers in the arena of a rollout for this shot
+  static int getArenaSize(Problem* shot);
+
+  /// This returns the whole arena as one flat vector. Writes to it are writes
+  /// to the rollout.
+  Eigen::Ref<Eigen::VectorXs> getArena();
+
+  /// This returns the whole arena as one flat vector
+  const Eigen::Ref<const Eigen::VectorXs> getArenaConst() const;
+
   const std::vector<std::string>& getMappings() const override;
   Eigen::Ref<Eigen::MatrixXs> getPoses(
       const std::string& mapping = "identity") override;
@@ -139,12 +206,44 @@ public:
       const std::string& key, Eigen::MatrixXs value) override;
 
 protected:
-  std::unordered_map<std::string, Eigen::MatrixXs> mPoses;
-  std::unordered_map<std::string, Eigen::MatrixXs> mVels;
-  std::unordered_map<std::string, Eigen::MatrixXs> mForces;
-  Eigen::VectorXs mMasses;
-  std::unordered_map<std::string, Eigen::MatrixXs> mMetadata;
+  /// Where a mapping's values live in the arena
+  struct ArenaBlock
+  {
+    int posDim;
+    int velDim;
+    int forceDim;
+    int steps;
+    /// The poses start here, followed immediately by the vels and the forces
+    int offset;
+  };
+
+  /// This returns the block a fresh rollout would use for this mapping. The
+  /// offset is left for layoutArena() to fill in.
+  static ArenaBlock makeArenaBlock(
+      std::shared_ptr<neural::Mapping> mapping, int steps);
+
+  /// This fills in mMappings, mBlocks (including their offsets) and the mass
+  /// and arena sizes, for a rollout with these blocks and masses
+  void layoutArena(
+      const std::unordered_map<std::string, ArenaBlock>& blocks, int massDim);
+
+  /// This allocates a fresh arena of mArenaSize zeros
+  void allocateArena();
+
+  /// This leaves us with no mappings, masses or arena, after being moved from
+  void clearArena();
+
   std::vector<std::string> mMappings;
+  std::unordered_map<std::string, ArenaBlock> mBlocks;
+  int mMassDim;
+  int mMassOffset;
+  int mArenaSize;
+  s_t* mArena = nullptr;
+  /// This keeps mArena alive. It's null for arenas adopted without an owner.
+  std::shared_ptr<void> mArenaOwner;
+  std::unordered_map<std::string, Eigen::MatrixXs> mMetadata;
+
+  friend class TrajectoryRolloutComplex;
 };
 
 class TrajectoryRolloutRef : public TrajectoryRollout
@@ -216,6 +315,39 @@ protected:
   int mLen;
 };
 
+/// This is a complex valued copy of a TrajectoryRolloutReal, with the same
+/// arena layout. Losses written to accept any scalar type can be evaluated on
+/// it, which lets LossFn differentiate them with the complex step method, see
+/// LossFn::setComplexStepLoss().
+class TrajectoryRolloutComplex
+{
+public:
+  /// This copies `real`, with every imaginary part 0
+  TrajectoryRolloutComplex(const TrajectoryRolloutReal& real);
+
+  const std::vector<std::string>& getMappings() const;
+  const Eigen::Ref<const MatrixXcs> getPosesConst(
+      const std::string& mapping = "identity") const;
+  const Eigen::Ref<const MatrixXcs> getVelsConst(
+      const std::string& mapping = "identity") const;
+  const Eigen::Ref<const MatrixXcs> getControlForcesConst(
+      const std::string& mapping = "identity") const;
+  const Eigen::Ref<const VectorXcs> getMassesConst() const;
+  Eigen::MatrixXs getMetadata(const std::string& key) const;
+
+  /// This returns the whole arena as one flat vector, laid out the same way as
+  /// TrajectoryRolloutReal::getArena()
+  Eigen::Ref<VectorXcs> getArena();
+
+protected:
+  std::vector<std::string> mMappings;
+  std::unordered_map<std::string, TrajectoryRolloutReal::ArenaBlock> mBlocks;
+  int mMassDim;
+  int mMassOffset;
+  VectorXcs mArena;
+  std::unordered_map<std::string, Eigen::MatrixXs> mMetadata;
+};
+
 } // namespace trajectory
 } // namespace dart
 
@@ -1,5 +1,6 @@
 #include "AccelerationSmoother.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace dart {
@@ -10,11 +11,22 @@ namespace utils {
  * seriese of data.
  *
  * The alpha value will determine how much smoothing to apply. A value of 0
- * corresponds to no smoothing.
+ * corresponds to no smoothing. Alpha must be non-negative.
+ *
+ * The system matrix is banded (identity plus 4x4 jerk stamps along the
+ * diagonal), so this stores and factors only the band, which takes O(T)
+ * time and memory rather than O(T^2) / O(T^3).
  */
 AccelerationSmoother::AccelerationSmoother(int timesteps, s_t alpha)
-  : mTimesteps(timesteps), mAlpha(alpha)
+  : mTimesteps(timesteps),
+    mAlpha(alpha),
+    mStreamOverlap(0),
+    mStreamLength(0),
+    mStreamStart(0),
+    mStreamFilled(0)
 {
+  assert(mAlpha >= 0);
+
   Eigen::Matrix4s stamp;
   // clang-format off
   stamp <<  1, -3,  3, -1,
@@ -25,14 +37,43 @@ AccelerationSmoother::AccelerationSmoother(int timesteps, s_t alpha)
   stamp *= mAlpha;
   mPosMap = stamp * 2;
 
-  mB = Eigen::MatrixXs::Zero(mTimesteps, mTimesteps);
+  // B = I + sum of the stamps, which has a bandwidth of 3. We only keep the
+  // lower band, since B is symmetric.
+  mBandB = Eigen::MatrixXs::Zero(4, mTimesteps);
+  mBandB.row(0).setOnes();
   for (int i = 0; i < mTimesteps - 3; i++)
   {
-    mB.block<4, 4>(i, i) += stamp;
+    for (int a = 0; a < 4; a++)
+    {
+      for (int b = 0; b <= a; b++)
+      {
+        mBandB(a - b, i + b) += stamp(a, b);
+      }
+    }
   }
-  mB += Eigen::MatrixXs::Identity(mTimesteps, mTimesteps);
 
-  mFactoredB = Eigen::HouseholderQR<Eigen::MatrixXs>(mB);
+  // Banded Cholesky. B is SPD (identity plus PSD stamps), and L keeps the same
+  // bandwidth as B, so this is O(T).
+  mBandL = Eigen::MatrixXs::Zero(4, mTimesteps);
+  for (int j = 0; j < mTimesteps; j++)
+  {
+    s_t diag = mBandB(0, j);
+    for (int k = std::max(0, j - 3); k < j; k++)
+    {
+      diag -= mBandL(j - k, k) * mBandL(j - k, k);
+    }
+    mBandL(0, j) = sqrt(diag);
+
+    for (int i = j + 1; i < std::min(j + 4, mTimesteps); i++)
+    {
+      s_t sum = mBandB(i - j, j);
+      for (int k = std::max(0, i - 3); k < j; k++)
+      {
+        sum -= mBandL(i - k, k) * mBandL(j - k, k);
+      }
+      mBandL(i - j, j) = sum / mBandL(0, j);
+    }
+  }
 };
 
 /**
@@ -48,24 +89,149 @@ Eigen::MatrixXs AccelerationSmoother::smooth(Eigen::MatrixXs series)
 {
   assert(series.cols() == mTimesteps);
 
-  Eigen::MatrixXs smoothed
-      = Eigen::MatrixXs::Zero(series.rows(), mTimesteps - 3);
+  // Build the right hand side for every DOF at once, one column per timestep
+  Eigen::MatrixXs deltas = Eigen::MatrixXs::Zero(series.rows(), mTimesteps);
+  for (int i = 0; i < mTimesteps - 3; i++)
+  {
+    deltas.middleCols<4>(i) += series.middleCols<4>(i) * mPosMap.transpose();
+  }
+  solveInPlace(deltas);
+
+  return series.leftCols(mTimesteps - 3) - deltas.leftCols(mTimesteps - 3);
+};
+
+/**
+ * Smooth a time series of any length (at least `mTimesteps` columns) by
+ * running overlapping windows of `mTimesteps` frames, all sharing this
+ * smoother's factorization. Each window discards `overlap` frames at its
+ * interior edges, where the window boundary distorts the solution, so the
+ * stitched result closely matches smoothing the whole series at once. Each
+ * window still allocates its own solve, in proportion to the window size,
+ * and the result is as long as the series, so this isn't constant memory.
+ * What it saves is factoring a band for the whole series. To smooth frames
+ * as they arrive, in bounded memory, see startStream().
+ *
+ * `overlap` must be at least 3, and less than half of `mTimesteps`. Like
+ * smooth(), this returns a series missing the last 3 entries.
+ */
+Eigen::MatrixXs AccelerationSmoother::smoothWindowed(
+    const Eigen::MatrixXs& series, int overlap)
+{
+  assert(overlap >= 3);
+  assert(2 * overlap < mTimesteps);
+  assert(series.cols() >= mTimesteps);
+
+  const int length = series.cols();
+  Eigen::MatrixXs smoothed = Eigen::MatrixXs::Zero(series.rows(), length - 3);
 
-  for (int row = 0; row < series.rows(); row++)
+  // `filled` is the first output column we haven't written yet
+  int filled = 0;
+  int start = 0;
+  while (true)
   {
-    Eigen::VectorXs c = Eigen::VectorXs::Zero(mTimesteps);
-    for (int i = 0; i < mTimesteps - 3; i++)
-    {
-      c.segment<4>(i) += mPosMap * series.block<1, 4>(row, i).transpose();
-    }
-    // Eigen::VectorXs deltas = mB.completeOrthogonalDecomposition().solve(c);
-    Eigen::VectorXs deltas = mFactoredB.solve(c);
-    smoothed.row(row) = series.block(row, 0, 1, mTimesteps - 3)
-                        - deltas.segment(0, mTimesteps - 3).transpose();
+    if (start + mTimesteps > length)
+      start = length - mTimesteps;
+    bool last = start + mTimesteps == length;
+
+    Eigen::MatrixXs window = smooth(series.middleCols(start, mTimesteps));
+
+    // Only the true end of the series gets to keep its trailing frames
+    int keepEnd = last ? mTimesteps - 3 : mTimesteps - overlap;
+    int from = filled - start;
+    smoothed.middleCols(filled, keepEnd - from)
+        = window.middleCols(from, keepEnd - from);
+    filled = start + keepEnd;
+
+    if (last)
+      break;
+    start = filled - overlap;
   }
 
   return smoothed;
-};
+}
+
+/**
+ * Start smoothing a stream of frames, one at a time. This runs the same
+ * windows as smoothWindowed(), and produces exactly the same frames, but only
+ * ever holds on to the last `mTimesteps` frames pushed. This discards any
+ * stream already in progress.
+ *
+ * `overlap` must be at least 3, and less than half of `mTimesteps`.
+ */
+void AccelerationSmoother::startStream(int overlap)
+{
+  assert(overlap >= 3);
+  assert(2 * overlap < mTimesteps);
+
+  mStreamOverlap = overlap;
+  mStreamLength = 0;
+  mStreamStart = 0;
+  mStreamFilled = 0;
+  mStreamOutput.clear();
+}
+
+/**
+ * Push the next frame of the stream, a complete joint configuration. Each time
+ * this completes a window, a batch of smoothed frames becomes ready to pop.
+ * Once the first window is full, the smoothed frames lag `overlap` to
+ * `mTimesteps - overlap` frames behind the pushed ones.
+ */
+void AccelerationSmoother::pushFrame(const Eigen::VectorXs& frame)
+{
+  assert(mStreamOverlap >= 3);
+
+  if (mStreamLength == 0)
+  {
+    mStreamFrames.resize(frame.size(), mTimesteps);
+  }
+  assert(frame.size() == mStreamFrames.rows());
+  mStreamFrames.col(mStreamLength % mTimesteps) = frame;
+  mStreamLength++;
+
+  // This is the same schedule as smoothWindowed(), except that we can't know
+  // which window is the last one until finishStream()
+  if (mStreamLength == mStreamStart + mTimesteps)
+  {
+    smoothStreamWindow(mStreamStart, mTimesteps - mStreamOverlap);
+    mStreamStart = mStreamFilled - mStreamOverlap;
+  }
+}
+
+/**
+ * Smooth the frames still in the buffer, once the stream has ended. After this
+ * every smoothed frame is ready to pop, except the last 3, like smooth(). At
+ * least `mTimesteps` frames must have been pushed.
+ */
+void AccelerationSmoother::finishStream()
+{
+  assert(mStreamLength >= mTimesteps);
+
+  // Like the last window of smoothWindowed(), this is the last `mTimesteps`
+  // frames, which is exactly what the ring buffer holds
+  smoothStreamWindow(mStreamLength - mTimesteps, mTimesteps - 3);
+}
+
+/**
+ * This returns the number of smoothed frames waiting in popSmoothedFrame()
+ */
+int AccelerationSmoother::getNumSmoothedFrames() const
+{
+  return mStreamOutput.size();
+}
+
+/**
+ * This returns the oldest smoothed frame we haven't popped yet. The frames
+ * queue up until they're popped, so pop them as they become ready to keep
+ * memory bounded.
+ */
+Eigen::VectorXs AccelerationSmoother::popSmoothedFrame()
+{
+  assert(!mStreamOutput.empty());
+
+  Eigen::VectorXs frame = mStreamOutput.front();
+  mStreamOutput.pop_front();
+  return frame;
+}
 
 /**
  * This computes the squared loss for this smoother, given a time series and a
@@ -88,10 +254,8 @@ s_t AccelerationSmoother::getLoss(
   {
     c.segment<4>(i) += mPosMap * series.segment<4>(i);
   }
-  Eigen::MatrixXs BminusI
-      = mB - Eigen::MatrixXs::Identity(mTimesteps, mTimesteps);
-  s_t matrix_score = (deltas.transpose() * mB * deltas)(0)
-                     + (series.transpose() * BminusI * series)(0)
+  s_t matrix_score = deltas.dot(multiplyB(deltas))
+                     + series.dot(multiplyB(series)) - series.dot(series)
                      + c.dot(deltas);
   // s_t matrix_score = series.transpose() * BminusI * series;
 
@@ -171,5 +335,69 @@ void AccelerationSmoother::debugTimeSeries(Eigen::VectorXs series)
   std::cout << "pos - vel - acc - jerk" << std::endl << cols << std::endl;
 }
 
+/**
+ * This computes B * x using the banded storage of B
+ */
+Eigen::VectorXs AccelerationSmoother::multiplyB(const Eigen::VectorXs& x) const
+{
+  Eigen::VectorXs result = mBandB.row(0).transpose().cwiseProduct(x);
+  for (int k = 1; k < 4; k++)
+  {
+    for (int j = 0; j + k < mTimesteps; j++)
+    {
+      result(j + k) += mBandB(k, j) * x(j);
+      result(j) += mBandB(k, j) * x(j + k);
+    }
+  }
+  return result;
+}
+
+/**
+ * This solves B * X^T = C^T in place for every row of `c` at once, using the
+ * banded Cholesky factor
+ */
+void AccelerationSmoother::solveInPlace(Eigen::MatrixXs& c) const
+{
+  // Forward substitution, L * Y = C
+  for (int j = 0; j < mTimesteps; j++)
+  {
+    for (int k = std::max(0, j - 3); k < j; k++)
+    {
+      c.col(j) -= mBandL(j - k, k) * c.col(k);
+    }
+    c.col(j) /= mBandL(0, j);
+  }
+  // Back substitution, L^T * X = Y
+  for (int j = mTimesteps - 1; j >= 0; j--)
+  {
+    for (int i = j + 1; i < std::min(j + 4, mTimesteps); i++)
+    {
+      c.col(j) -= mBandL(i - j, j) * c.col(i);
+    }
+    c.col(j) /= mBandL(0, j);
+  }
+}
+
+/**
+ * This smooths the window of the stream starting at frame `start`, and queues
+ * up the smoothed frames we haven't output yet, up to (but not including)
+ * `start + keepEnd`
+ */
+void AccelerationSmoother::smoothStreamWindow(int start, int keepEnd)
+{
+  Eigen::MatrixXs window(mStreamFrames.rows(), mTimesteps);
+  for (int i = 0; i < mTimesteps; i++)
+  {
+    window.col(i) = mStreamFrames.col((start + i) % mTimesteps);
+  }
+  Eigen::MatrixXs smoothed = smooth(window);
+
+  for (int i = mStreamFilled; i < start + keepEnd; i++)
+  {
+    mStreamOutput.push_back(smoothed.col(i - start));
+  }
+  mStreamFilled = start + keepEnd;
+}
+
 } // namespace utils
 } // namespace dart
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef UTILS_PATH_SMOOTHER
 #define UTILS_PATH_SMOOTHER
 
+#include <deque>
+
 #include "dart/math/MathTypes.hpp"
 
 namespace dart {
@@ -14,7 +16,11 @@ public:
    * seriese of data.
    *
    * The alpha value will determine how much smoothing to apply. A value of 0
-   * corresponds to no smoothing.
+   * corresponds to no smoothing. Alpha must be non-negative.
+   *
+   * The system matrix is banded (identity plus 4x4 jerk stamps along the
+   * diagonal), so this stores and factors only the band, which takes O(T)
+   * time and memory rather than O(T^2) / O(T^3).
    */
   AccelerationSmoother(int timesteps, s_t alpha);
 
@@ -30,6 +36,59 @@ public:
    */
   Eigen::MatrixXs smooth(Eigen::MatrixXs series);
 
+  /**
+   * Smooth a time series of any length (at least `mTimesteps` columns) by
+   * running overlapping windows of `mTimesteps` frames, all sharing this
+   * smoother's factorization. Each window discards `overlap` frames at its
+   * interior edges, where the window boundary distorts the solution, so the
+   * stitched result closely matches smoothing the whole series at once. Each
+   * window still allocates its own solve, in proportion to the window size,
+   * and the result is as long as the series, so this isn't constant memory.
+   * What it saves is factoring a band for the whole series. To smooth frames
+   * as they arrive, in bounded memory, see startStream().
+   *
+   * `overlap` must be at least 3, and less than half of `mTimesteps`. Like
+   * smooth(), this returns a series missing the last 3 entries.
+   */
+  Eigen::MatrixXs smoothWindowed(const Eigen::MatrixXs& series, int overlap);
+
+  /**
+   * Start smoothing a stream of frames, one at a time. This runs the same
+   * windows as smoothWindowed(), and produces exactly the same frames, but
+   * only ever holds on to the last `mTimesteps` frames pushed. This discards
+   * any stream already in progress.
+   *
+   * `overlap` must be at least 3, and less than half of `mTimesteps`.
+   */
+  void startStream(int overlap);
+
+  /**
+   * Push the next frame of the stream, a complete joint configuration. Each
+   * time this completes a window, a batch of smoothed frames becomes ready to
+   * pop. Once the first window is full, the smoothed frames lag `overlap` to
+   * `mTimesteps - overlap` frames behind the pushed ones.
+   */
+  void pushFrame(const Eigen::VectorXs& frame);
+
+  /**
+   * Smooth the frames still in the buffer, once the stream has ended. After
+   * this every smoothed frame is ready to pop, except the last 3, like
+   * smooth(). At least `mTimesteps` frames must have been pushed.
+   */
+  void finishStream();
+
+  /**
+   * This returns the number of smoothed frames waiting in popSmoothedFrame()
+   */
+  int getNumSmoothedFrames() const;
+
+  /**
+   * This returns the oldest smoothed frame we haven't popped yet. The frames
+   * queue up until they're popped, so pop them as they become ready to keep
+   * memory bounded.
+   */
+  Eigen::VectorXs popSmoothedFrame();
+
   /**
    * This computes the squared loss for this smoother, given a time series and a
    * set of perturbations `delta` to the time series.
@@ -44,11 +103,40 @@ public:
   void debugTimeSeries(Eigen::VectorXs series);
 
 private:
+  /// This computes B * x using the banded storage of B
+  Eigen::VectorXs multiplyB(const Eigen::VectorXs& x) const;
+
+  /// This solves B * X^T = C^T in place for every row of `c` at once, using
+  /// the banded Cholesky factor
+  void solveInPlace(Eigen::MatrixXs& c) const;
+
+  /// This smooths the window of the stream starting at frame `start`, and
+  /// queues up the smoothed frames we haven't output yet, up to (but not
+  /// including) `start + keepEnd`
+  void smoothStreamWindow(int start, int keepEnd);
+
   int mTimesteps;
   s_t mAlpha;
   Eigen::Matrix4s mPosMap;
-  Eigen::MatrixXs mB;
-  Eigen::HouseholderQR<Eigen::MatrixXs> mFactoredB;
+  /// The lower band of B, stored as mBandB(k, j) = B(j + k, j)
+  Eigen::MatrixXs mBandB;
+  /// The lower band of the Cholesky factor L, where B = L * L^T, stored the
+  /// same way as mBandB
+  Eigen::MatrixXs mBandL;
+
+  /// The stream's window overlap, see startStream()
+  int mStreamOverlap;
+  /// The last `mTimesteps` frames pushed, as a ring buffer, so frame i lives
+  /// in column (i % mTimesteps)
+  Eigen::MatrixXs mStreamFrames;
+  /// The number of frames pushed since startStream()
+  int mStreamLength;
+  /// The first frame of the next window we'll smooth
+  int mStreamStart;
+  /// The first frame we haven't queued a smoothed version of yet
+  int mStreamFilled;
+  /// The smoothed frames waiting to be popped
+  std::deque<Eigen::VectorXs> mStreamOutput;
 };
 
 } // namespace utils
@@ -1,5 +1,13 @@
 #include "dart/utils/UniversalLoader.hpp"
 
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include <sys/stat.h>
+
 #include "dart/dynamics/BodyNode.hpp"
 #include "dart/dynamics/FreeJoint.hpp"
 #include "dart/dynamics/Joint.hpp"
@@ -9,12 +17,118 @@
 #include "dart/utils/SkelParser.hpp"
 #include "dart/utils/sdf/SdfParser.hpp"
 #include "dart/utils/urdf/DartLoader.hpp"
+#include "dart/simulation/World.hpp"
 #include "dart/utils/DartResourceRetriever.hpp"
 
 namespace dart {
 namespace utils {
 namespace UniversalLoader {
 
+namespace {
+
+/// Enough about a version of a file to tell when it's been rewritten. The
+/// modification time is down to the nanosecond, and the size catches rewrites
+/// on file systems with coarser timestamps than that.
+struct FileVersion
+{
+  std::time_t seconds = 0;
+  long nanoseconds = 0;
+  off_t size = 0;
+
+  bool operator==(const FileVersion& other) const
+  {
+    return seconds == other.seconds && nanoseconds == other.nanoseconds
+           && size == other.size;
+  }
+
+  bool operator!=(const FileVersion& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+/// A file we've already parsed, which later loads of the same file get cloned
+/// from
+template <typename T>
+struct CachedFile
+{
+  FileVersion version;
+  bool parsed = false;
+  std::shared_ptr<T> original;
+  /// Held while parsing and cloning, so the original never gets read by two
+  /// threads at once
+  std::mutex mutex;
+};
+
+template <typename T>
+using FileCache = std::map<std::string, std::shared_ptr<CachedFile<T>>>;
+
+std::atomic<bool> gCacheEnabled(false);
+std::mutex gCacheMutex;
+FileCache<dynamics::Skeleton> gSkeletonCache;
+FileCache<simulation::World> gWorldCache;
+
+//==============================================================================
+/// Returns the current version of `path`, or all zeros if it isn't a local file
+/// (like a "dart://" or "package://" URI). We can't see those change, so once
+/// they're cached they stay cached until they're evicted.
+FileVersion getFileVersion(const std::string& path)
+{
+  FileVersion version;
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0)
+    return version;
+  version.seconds = info.st_mtime;
+#ifdef __APPLE__
+  version.nanoseconds = info.st_mtimespec.tv_nsec;
+#else
+  version.nanoseconds = info.st_mtim.tv_nsec;
+#endif
+  version.size = info.st_size;
+  return version;
+}
+
+//==============================================================================
+/// This returns a clone of the cached result of `parse(path)`, only calling
+/// `parse` if we don't have a result for the current version of the file yet.
+/// Failed parses aren't cached.
+template <typename T>
+std::shared_ptr<T> loadCached(
+    FileCache<T>& cache,
+    const std::string& path,
+    const std::function<std::shared_ptr<T>(const std::string&)>& parse,
+    const std::function<std::shared_ptr<T>(const T&)>& clone)
+{
+  if (!gCacheEnabled)
+    return parse(path);
+
+  const FileVersion version = getFileVersion(path);
+  std::shared_ptr<CachedFile<T>> file;
+  {
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    std::shared_ptr<CachedFile<T>>& slot = cache[path];
+    if (!slot || slot->version != version)
+    {
+      slot = std::make_shared<CachedFile<T>>();
+      slot->version = version;
+    }
+    file = slot;
+  }
+
+  // Other files can be parsed and cloned concurrently with this one
+  std::lock_guard<std::mutex> lock(file->mutex);
+  if (!file->parsed)
+  {
+    file->original = parse(path);
+    file->parsed = file->original != nullptr;
+    if (!file->parsed)
+      return nullptr;
+  }
+  return clone(*file->original);
+}
+
+} // namespace
+
 /// Credit
 /// https://stackoverflow.com/questions/20446201/how-to-check-if-string-ends-with-txt/20446257
 /// keenon: Yes I'm embarassed to copy-paste something as simple as this, but I
@@ -35,10 +149,36 @@ bool hasSuffix(const std::string& str, const std::string& suffix)
 #define GetCurrentDir getcwd
 #endif
 
+//==============================================================================
+/// Relative paths are taken relative to the current working directory
+std::string resolvePath(const std::string& path)
+{
+  // Source: https://stackoverflow.com/a/145309/13177487
+  if (path[0] != '.')
+    return path;
+
+  char cCurrentPath[FILENAME_MAX];
+
+  if (!GetCurrentDir(cCurrentPath, sizeof(cCurrentPath)))
+  {
+    // ignore, couldn't prefix the current working directory
+  }
+  cCurrentPath[sizeof(cCurrentPath) - 1] = '\0'; /* not really required */
+  std::string cwd(cCurrentPath);
+
+  return cwd + "/" + path;
+}
+
 //==============================================================================
 std::shared_ptr<simulation::World> loadWorld(const std::string& path)
 {
-  return dart::utils::SkelParser::readWorld(path);
+  return loadCached<simulation::World>(
+      gWorldCache,
+      path,
+      [](const std::string& path) {
+        return dart::utils::SkelParser::readWorld(path);
+      },
+      [](const simulation::World& world) { return world.clone(); });
 }
 
 //==============================================================================
@@ -50,33 +190,27 @@ std::shared_ptr<dynamics::Skeleton> loadSkeleton(
 {
   std::shared_ptr<dynamics::Skeleton> skel = nullptr;
 
-  // Source: https://stackoverflow.com/a/145309/13177487
-  if (path[0] == '.')
-  {
-    char cCurrentPath[FILENAME_MAX];
-
-    if (!GetCurrentDir(cCurrentPath, sizeof(cCurrentPath)))
-    {
-      // ignore, couldn't prefix the current working directory
-    }
-    cCurrentPath[sizeof(cCurrentPath) - 1] = '\0'; /* not really required */
-    std::string cwd(cCurrentPath);
-
-    path = cwd + "/" + path;
-  }
+  path = resolvePath(path);
 
+  std::function<std::shared_ptr<dynamics::Skeleton>(const std::string&)> parse;
   if (hasSuffix(path, ".skel"))
   {
-    skel = SkelParser::readSkeleton(path);
+    parse = [](const std::string& path) {
+      return SkelParser::readSkeleton(path);
+    };
   }
   else if (hasSuffix(path, ".urdf"))
   {
-    dart::utils::DartLoader urdfLoader;
-    skel = urdfLoader.parseSkeleton(path);
+    parse = [](const std::string& path) {
+      dart::utils::DartLoader urdfLoader;
+      return urdfLoader.parseSkeleton(path);
+    };
   }
   else if (hasSuffix(path, ".sdf"))
   {
-    skel = dart::utils::SdfParser::readSkeleton(path);
+    parse = [](const std::string& path) {
+      return dart::utils::SdfParser::readSkeleton(path);
+    };
   }
   else
   {
@@ -87,6 +221,11 @@ std::shared_ptr<dynamics::Skeleton> loadSkeleton(
     return nullptr;
   }
 
+  skel = loadCached<dynamics::Skeleton>(
+      gSkeletonCache, path, parse, [](const dynamics::Skeleton& original) {
+        return original.cloneSkeleton();
+      });
+
   if (skel == nullptr)
   {
     dterr << "[UniversalLoader] Error when ettempting to load a file [" << path
@@ -118,20 +257,7 @@ std::shared_ptr<dynamics::Skeleton> loadSkeleton(
 /// This loads a mesh from a file
 std::shared_ptr<dynamics::MeshShape> loadMeshShape(std::string path)
 {
-  // Source: https://stackoverflow.com/a/145309/13177487
-  if (path[0] == '.')
-  {
-    char cCurrentPath[FILENAME_MAX];
-
-    if (!GetCurrentDir(cCurrentPath, sizeof(cCurrentPath)))
-    {
-      // ignore, couldn't prefix the current working directory
-    }
-    cCurrentPath[sizeof(cCurrentPath) - 1] = '\0'; /* not really required */
-    std::string cwd(cCurrentPath);
-
-    path = cwd + "/" + path;
-  }
+  path = resolvePath(path);
 
   auto retriever = std::make_shared<utils::CompositeResourceRetriever>();
   retriever->addSchemaRetriever(
@@ -144,6 +270,39 @@ std::shared_ptr<dynamics::MeshShape> loadMeshShape(std::string path)
       retriever);
 }
 
+//==============================================================================
+void setCacheEnabled(bool enabled)
+{
+  gCacheEnabled = enabled;
+  // Nothing will read the cache anymore, so don't hang on to it
+  if (!enabled)
+    clearCache();
+}
+
+//==============================================================================
+bool isCacheEnabled()
+{
+  return gCacheEnabled;
+}
+
+//==============================================================================
+void evictFromCache(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  // loadSkeleton() keys on the resolved path, and loadWorld() on the path as
+  // it was given
+  gSkeletonCache.erase(resolvePath(path));
+  gWorldCache.erase(path);
+}
+
+//==============================================================================
+void clearCache()
+{
+  std::lock_guard<std::mutex> lock(gCacheMutex);
+  gSkeletonCache.clear();
+  gWorldCache.clear();
+}
+
 } // namespace UniversalLoader
 } // namespace utils
 } // namespace dart
\ No newline at end of file
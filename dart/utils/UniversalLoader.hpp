@@ -23,7 +23,8 @@ class Skeleton;
 namespace utils {
 namespace UniversalLoader {
 
-/// This loads a whole world from a skel file
+/// This loads a whole world from a skel file. Like loadSkeleton(), a repeat
+/// load of the same file clones a cached copy instead of parsing it again.
 std::shared_ptr<simulation::World> loadWorld(const std::string& path);
 
 /// This loads a skeleton from a path, attempting to decide which loader to use
@@ -39,6 +40,35 @@ std::shared_ptr<dynamics::Skeleton> loadSkeleton(
 /// This loads a mesh from a file
 std::shared_ptr<dynamics::MeshShape> loadMeshShape(std::string path);
 
+/// If this is turned on (it's off by default), loadSkeleton() and loadWorld()
+/// keep a process-wide cache of every file they parse, keyed on the path and
+/// the file's modification time and size. A repeat load of an unchanged file
+/// clones the cached copy instead of parsing the file (and loading its meshes)
+/// again. It's safe to load from multiple threads either way.
+///
+/// Clones share their Shapes with the cached copy, just like
+/// Skeleton::clone() does, so editing a Shape on a loaded Skeleton (resizing a
+/// box, scaling a mesh, changing visual data) also changes every later load of
+/// that file. Only turn this on if loaded Shapes are treated as read-only, or
+/// evict the file with evictFromCache() before editing them. Cached files stay
+/// in memory until they're evicted, clearCache() is called, or the cache is
+/// turned off.
+///
+/// URIs that aren't local paths (like "dart://" or "package://") can't be
+/// checked for changes, so they're cached until they're evicted.
+void setCacheEnabled(bool enabled);
+
+/// Returns true if loads are being cached
+bool isCacheEnabled();
+
+/// This drops the cached copy of `path`, if there is one, so the next load of
+/// it parses it from scratch
+void evictFromCache(const std::string& path);
+
+/// This drops every cached Skeleton and World, so the next load of any file
+/// parses it from scratch
+void clearCache();
+
 } // namespace UniversalLoader
 } // namespace utils
 } // namespace dart
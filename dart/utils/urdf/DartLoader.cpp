@@ -32,10 +32,14 @@
 
 #include "dart/utils/urdf/DartLoader.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
+#include <assimp/cimport.h>
 #include <urdf_parser/urdf_parser.h>
 #include <urdf_world/world.h>
 
@@ -65,7 +69,8 @@ using ModelInterfacePtr = urdf_shared_ptr<urdf::ModelInterface>;
 DartLoader::DartLoader()
   : mLocalRetriever(new common::LocalResourceRetriever),
     mPackageRetriever(new utils::PackageResourceRetriever(mLocalRetriever)),
-    mRetriever(new utils::CompositeResourceRetriever)
+    mRetriever(new utils::CompositeResourceRetriever),
+    mNumMeshLoadingThreads(0)
 {
   mRetriever->addSchemaRetriever("file", mLocalRetriever);
   mRetriever->addSchemaRetriever("package", mPackageRetriever);
@@ -78,6 +83,16 @@ void DartLoader::addPackageDirectory(const std::string& _packageName,
   mPackageRetriever->addPackageDirectory(_packageName, _packageDirectory);
 }
 
+void DartLoader::setNumMeshLoadingThreads(std::size_t _numThreads)
+{
+  mNumMeshLoadingThreads = _numThreads;
+}
+
+std::size_t DartLoader::getNumMeshLoadingThreads() const
+{
+  return mNumMeshLoadingThreads;
+}
+
 dynamics::SkeletonPtr DartLoader::parseSkeleton(
   const common::Uri& _uri,
   const common::ResourceRetrieverPtr& _resourceRetriever)
@@ -98,7 +113,8 @@ dynamics::SkeletonPtr DartLoader::parseSkeleton(
     return nullptr;
   }
 
-  return modelInterfaceToSkeleton(urdfInterface.get(), _uri, resourceRetriever);
+  return modelInterfaceToSkeleton(
+    urdfInterface.get(), _uri, resourceRetriever, mNumMeshLoadingThreads);
 }
 
 dynamics::SkeletonPtr DartLoader::parseSkeletonString(
@@ -120,7 +136,8 @@ dynamics::SkeletonPtr DartLoader::parseSkeletonString(
   }
 
   return modelInterfaceToSkeleton(
-    urdfInterface.get(), _baseUri, getResourceRetriever(_resourceRetriever));
+    urdfInterface.get(), _baseUri, getResourceRetriever(_resourceRetriever),
+    mNumMeshLoadingThreads);
 }
 
 simulation::WorldPtr DartLoader::parseWorld(
@@ -166,7 +183,8 @@ simulation::WorldPtr DartLoader::parseWorldString(
   {
     const urdf_parsing::Entity& entity = worldInterface->models[i];
     dynamics::SkeletonPtr skeleton = modelInterfaceToSkeleton(
-      entity.model.get(), entity.uri, resourceRetriever);
+      entity.model.get(), entity.uri, resourceRetriever,
+      mNumMeshLoadingThreads);
 
     if(!skeleton)
     {
@@ -194,8 +212,14 @@ simulation::WorldPtr DartLoader::parseWorldString(
 dynamics::SkeletonPtr DartLoader::modelInterfaceToSkeleton(
   const urdf::ModelInterface* model,
   const common::Uri& baseUri,
-  const common::ResourceRetrieverPtr& resourceRetriever)
+  const common::ResourceRetrieverPtr& resourceRetriever,
+  std::size_t numMeshLoadingThreads)
 {
+  // Mesh loading dominates the time it takes to parse most robots, so we do it
+  // all at once up front, when it can be spread across threads
+  LoadedMeshes meshes = loadMeshes(
+      model, baseUri, resourceRetriever, numMeshLoadingThreads);
+
   dynamics::SkeletonPtr skeleton = dynamics::Skeleton::create(model->getName());
 
   dynamics::BodyNode* rootNode = nullptr;
@@ -226,6 +250,7 @@ dynamics::SkeletonPtr DartLoader::modelInterfaceToSkeleton(
     if (!createDartNodeProperties(
         root, rootProperties, baseUri, resourceRetriever))
     {
+      releaseMeshes(meshes);
       return nullptr;
     }
 
@@ -237,19 +262,23 @@ dynamics::SkeletonPtr DartLoader::modelInterfaceToSkeleton(
           rootProperties);
     rootNode = pair.second;
 
-    const auto result
-        = createShapeNodes(model, root, rootNode, baseUri, resourceRetriever);
+    const auto result = createShapeNodes(
+        model, root, rootNode, baseUri, resourceRetriever, meshes);
 
     if(!result)
+    {
+      releaseMeshes(meshes);
       return nullptr;
+    }
   }
 
   for(std::size_t i = 0; i < root->child_links.size(); i++)
   {
     if (!createSkeletonRecursive(
            model, skeleton, root->child_links[i].get(), rootNode,
-           baseUri, resourceRetriever))
+           baseUri, resourceRetriever, meshes))
     {
+      releaseMeshes(meshes);
       return nullptr;
     }
   }
@@ -258,9 +287,80 @@ dynamics::SkeletonPtr DartLoader::modelInterfaceToSkeleton(
   for(std::size_t i = 0; i < root->child_links.size(); i++)
     addMimicJointsRecursive(model, skeleton, root->child_links[i].get());
 
+  // Meshes of links that aren't part of the tree, like the "world" link
+  releaseMeshes(meshes);
+
   return skeleton;
 }
 
+//==============================================================================
+DartLoader::LoadedMeshes DartLoader::loadMeshes(
+  const urdf::ModelInterface* model,
+  const common::Uri& baseUri,
+  const common::ResourceRetrieverPtr& resourceRetriever,
+  std::size_t numThreads)
+{
+  // Every occurrence of a mesh gets its own aiScene, even if the same file is
+  // used more than once, because each MeshShape takes ownership of its scene
+  std::vector<const urdf::Mesh*> geometries;
+  std::vector<std::string> uris;
+  for (const auto& link : model->links_)
+  {
+    std::vector<const urdf::Geometry*> linkGeometries;
+    for (const auto& visual : link.second->visual_array)
+      linkGeometries.push_back(visual->geometry.get());
+    for (const auto& collision : link.second->collision_array)
+      linkGeometries.push_back(collision->geometry.get());
+
+    for (const urdf::Geometry* geometry : linkGeometries)
+    {
+      const urdf::Mesh* mesh = dynamic_cast<const urdf::Mesh*>(geometry);
+      common::Uri absoluteUri;
+      // createShape() reports URIs that fail to resolve
+      if (mesh && absoluteUri.fromRelativeUri(baseUri, mesh->filename))
+      {
+        geometries.push_back(mesh);
+        uris.push_back(absoluteUri.toString());
+      }
+    }
+  }
+
+  std::vector<const aiScene*> scenes(geometries.size(), nullptr);
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < geometries.size(); i = next++)
+      scenes[i] = dynamics::MeshShape::loadMesh(uris[i], resourceRetriever);
+  };
+
+  if (numThreads == 0)
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::min(numThreads, geometries.size());
+
+  // The calling thread does its share of the work too
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < numThreads; i++)
+    threads.emplace_back(work);
+  work();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  LoadedMeshes meshes;
+  for (std::size_t i = 0; i < geometries.size(); i++)
+  {
+    if (scenes[i])
+      meshes[geometries[i]] = scenes[i];
+  }
+  return meshes;
+}
+
+//==============================================================================
+void DartLoader::releaseMeshes(LoadedMeshes& meshes)
+{
+  for (const auto& mesh : meshes)
+    aiReleaseImport(mesh.second);
+  meshes.clear();
+}
+
 //==============================================================================
 bool DartLoader::createSkeletonRecursive(
   const urdf::ModelInterface* model,
@@ -268,7 +368,8 @@ bool DartLoader::createSkeletonRecursive(
   const urdf::Link* lk,
   dynamics::BodyNode* parentNode,
   const common::Uri& baseUri,
-  const common::ResourceRetrieverPtr& resourceRetriever)
+  const common::ResourceRetrieverPtr& resourceRetriever,
+  LoadedMeshes& meshes)
 {
   dynamics::BodyNode::Properties properties;
   if (!createDartNodeProperties(lk, properties, baseUri, resourceRetriever))
@@ -282,7 +383,7 @@ bool DartLoader::createSkeletonRecursive(
     return false;
 
   const auto result = createShapeNodes(
-      model, lk, node, baseUri, resourceRetriever);
+      model, lk, node, baseUri, resourceRetriever, meshes);
 
   if(!result)
     return false;
@@ -290,7 +391,7 @@ bool DartLoader::createSkeletonRecursive(
   for(std::size_t i = 0; i < lk->child_links.size(); ++i)
   {
     if (!createSkeletonRecursive(model, skel, lk->child_links[i].get(), node,
-                                 baseUri, resourceRetriever))
+                                 baseUri, resourceRetriever, meshes))
     {
       return false;
     }
@@ -562,13 +663,14 @@ bool DartLoader::createShapeNodes(
   const urdf::Link* lk,
   dynamics::BodyNode* bodyNode,
   const common::Uri& baseUri,
-  const common::ResourceRetrieverPtr& resourceRetriever)
+  const common::ResourceRetrieverPtr& resourceRetriever,
+  LoadedMeshes& meshes)
 {
   // Set visual information
   for(auto visual : lk->visual_array)
   {
     dynamics::ShapePtr shape
-        = createShape(visual.get(), baseUri, resourceRetriever);
+        = createShape(visual.get(), baseUri, resourceRetriever, meshes);
 
     if(shape)
     {
@@ -586,7 +688,7 @@ bool DartLoader::createShapeNodes(
   for(auto collision : lk->collision_array)
   {
     dynamics::ShapePtr shape
-        = createShape(collision.get(), baseUri, resourceRetriever);
+        = createShape(collision.get(), baseUri, resourceRetriever, meshes);
 
     if (shape)
     {
@@ -608,7 +710,8 @@ template <class VisualOrCollision>
 dynamics::ShapePtr DartLoader::createShape(
   const VisualOrCollision* _vizOrCol,
   const common::Uri& _baseUri,
-  const common::ResourceRetrieverPtr& _resourceRetriever)
+  const common::ResourceRetrieverPtr& _resourceRetriever,
+  LoadedMeshes& _meshes)
 {
   dynamics::ShapePtr shape;
 
@@ -642,10 +745,20 @@ dynamics::ShapePtr DartLoader::createShape(
       return nullptr;
     }
 
-    // Load the mesh.
+    // Load the mesh, unless loadMeshes() already has. The MeshShape takes
+    // ownership of the scene, so it must not stay in _meshes.
     const std::string resolvedUri = absoluteUri.toString();
-    const aiScene* scene = dynamics::MeshShape::loadMesh(
-      resolvedUri, _resourceRetriever);
+    const aiScene* scene = nullptr;
+    auto loaded = _meshes.find(mesh);
+    if (loaded != _meshes.end())
+    {
+      scene = loaded->second;
+      _meshes.erase(loaded);
+    }
+    else
+    {
+      scene = dynamics::MeshShape::loadMesh(resolvedUri, _resourceRetriever);
+    }
     if (!scene)
       return nullptr;
 
@@ -677,11 +790,13 @@ common::ResourceRetrieverPtr DartLoader::getResourceRetriever(
 template dynamics::ShapePtr DartLoader::createShape<urdf::Visual>(
   const urdf::Visual* _vizOrCol,
   const common::Uri& _baseUri,
-  const common::ResourceRetrieverPtr& _resourceRetriever);
+  const common::ResourceRetrieverPtr& _resourceRetriever,
+  LoadedMeshes& _meshes);
 template dynamics::ShapePtr DartLoader::createShape<urdf::Collision>(
   const urdf::Collision* _vizOrCol,
   const common::Uri& _baseUri,
-  const common::ResourceRetrieverPtr& _resourceRetriever);
+  const common::ResourceRetrieverPtr& _resourceRetriever,
+  LoadedMeshes& _meshes);
 
 /**
  * @function pose2Affine3d
@@ -37,6 +37,7 @@
 #include <Eigen/Geometry>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "dart/common/LocalResourceRetriever.hpp"
 #include "dart/common/ResourceRetriever.hpp"
@@ -48,6 +49,8 @@
 #include "dart/utils/CompositeResourceRetriever.hpp"
 #include "dart/utils/PackageResourceRetriever.hpp"
 
+struct aiScene;
+
 namespace urdf
 {
   class ModelInterface;
@@ -55,6 +58,7 @@ namespace urdf
   class Joint;
   class Pose;
   class Vector3;
+  class Mesh;
 }
 
 namespace dart {
@@ -103,6 +107,17 @@ class DartLoader {
     void addPackageDirectory(const std::string& _packageName,
                              const std::string& _packageDirectory);
 
+    /// Set how many threads load the meshes of a model. Every mesh in the
+    /// model gets loaded up front, before any of the Skeleton is built. 0, the
+    /// default, uses one thread per hardware core, and 1 loads every mesh on
+    /// the calling thread. With more than 1, the ResourceRetriever must be safe
+    /// to call from multiple threads at once, which all of the built in ones
+    /// are.
+    void setNumMeshLoadingThreads(std::size_t _numThreads);
+
+    /// Get how many threads load the meshes of a model
+    std::size_t getNumMeshLoadingThreads() const;
+
     /// Parse a file to produce a Skeleton
     dynamics::SkeletonPtr parseSkeleton(
       const common::Uri& _uri,
@@ -126,11 +141,26 @@ private:
     typedef std::shared_ptr<dynamics::BodyNode::Properties> BodyPropPtr;
     typedef std::shared_ptr<dynamics::Joint::Properties> JointPropPtr;
 
+    /// Meshes that have been loaded ahead of time, but not yet handed to a
+    /// MeshShape, keyed by the URDF geometry they were loaded for
+    typedef std::map<const urdf::Mesh*, const aiScene*> LoadedMeshes;
+
     /// Parses the ModelInterface and spits out a Skeleton object
     static dart::dynamics::SkeletonPtr modelInterfaceToSkeleton(
       const urdf::ModelInterface* model,
       const common::Uri& baseUri,
-      const common::ResourceRetrieverPtr& resourceRetriever);
+      const common::ResourceRetrieverPtr& resourceRetriever,
+      std::size_t numMeshLoadingThreads);
+
+    /// Loads every mesh in the model, spread across `numThreads` threads
+    static LoadedMeshes loadMeshes(
+      const urdf::ModelInterface* model,
+      const common::Uri& baseUri,
+      const common::ResourceRetrieverPtr& resourceRetriever,
+      std::size_t numThreads);
+
+    /// Releases any meshes that didn't end up in a MeshShape
+    static void releaseMeshes(LoadedMeshes& meshes);
 
     static bool createSkeletonRecursive(
       const urdf::ModelInterface* model,
@@ -138,7 +168,8 @@ private:
       const urdf::Link* lk,
       dynamics::BodyNode* parent,
       const common::Uri& baseUri,
-      const common::ResourceRetrieverPtr& _resourceRetriever);
+      const common::ResourceRetrieverPtr& _resourceRetriever,
+      LoadedMeshes& meshes);
 
     static bool addMimicJointsRecursive(
       const urdf::ModelInterface* model,
@@ -148,7 +179,8 @@ private:
     template <class VisualOrCollision>
     static dynamics::ShapePtr createShape(const VisualOrCollision* _vizOrCol,
       const common::Uri& _baseUri,
-      const common::ResourceRetrieverPtr& _resourceRetriever);
+      const common::ResourceRetrieverPtr& _resourceRetriever,
+      LoadedMeshes& _meshes);
 
     static dynamics::BodyNode* createDartJointAndNode(
       const urdf::Joint* _jt,
@@ -169,7 +201,8 @@ private:
       const urdf::Link* lk,
       dynamics::BodyNode* bodyNode,
       const common::Uri& baseUri,
-      const common::ResourceRetrieverPtr& resourceRetriever);
+      const common::ResourceRetrieverPtr& resourceRetriever,
+      LoadedMeshes& meshes);
 
     common::ResourceRetrieverPtr getResourceRetriever(
       const common::ResourceRetrieverPtr& _resourceRetriever);
@@ -185,6 +218,7 @@ private:
     common::LocalResourceRetrieverPtr mLocalRetriever;
     utils::PackageResourceRetrieverPtr mPackageRetriever;
     utils::CompositeResourceRetrieverPtr mRetriever;
+    std::size_t mNumMeshLoadingThreads;
 };
 
 }
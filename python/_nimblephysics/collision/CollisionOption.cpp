@@ -62,7 +62,10 @@ void CollisionOption(py::module& m)
           "maxNumContacts", &dart::collision::CollisionOption::maxNumContacts)
       .def_readwrite(
           "collisionFilter",
-          &dart::collision::CollisionOption::collisionFilter);
+          &dart::collision::CollisionOption::collisionFilter)
+      .def_readwrite(
+          "maxNumContactsPerPair",
+          &dart::collision::CollisionOption::maxNumContactsPerPair);
 }
 
 } // namespace python
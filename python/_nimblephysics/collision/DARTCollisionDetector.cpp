@@ -31,7 +31,9 @@
  */
 
 #include <dart/collision/dart/DARTCollisionDetector.hpp>
+#include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 
@@ -65,6 +67,30 @@ void DARTCollisionDetector(py::module& m)
               -> std::unique_ptr<dart::collision::CollisionGroup> {
             return self->createCollisionGroup();
           })
+      .def(
+          "raycastBatch",
+          +[](dart::collision::DARTCollisionDetector* self,
+              dart::collision::CollisionGroup* group,
+              const std::vector<Eigen::Vector3s>& from,
+              const std::vector<Eigen::Vector3s>& to,
+              const dart::collision::RaycastOption& option)
+              -> std::vector<dart::collision::RaycastResult> {
+            std::vector<dart::collision::RaycastResult> results;
+            self->raycastBatch(group, from, to, option, &results);
+            return results;
+          },
+          ::py::arg("group"),
+          ::py::arg("from"),
+          ::py::arg("to"),
+          ::py::arg("option") = dart::collision::RaycastOption(),
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "setNumRaycastThreads",
+          &dart::collision::DARTCollisionDetector::setNumRaycastThreads,
+          ::py::arg("numThreads"))
+      .def(
+          "getNumRaycastThreads",
+          &dart::collision::DARTCollisionDetector::getNumRaycastThreads)
       .def_static(
           "getStaticType",
           +[]() -> const std::string& {
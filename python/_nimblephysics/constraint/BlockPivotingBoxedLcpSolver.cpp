@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <dart/constraint/BlockPivotingBoxedLcpSolver.hpp>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+namespace dart {
+namespace python {
+
+void BlockPivotingBoxedLcpSolver(py::module& m)
+{
+  ::py::class_<dart::constraint::BlockPivotingBoxedLcpSolver::Option>(
+      m, "BlockPivotingBoxedLcpSolverOption")
+      .def(
+          ::py::init<int, s_t, s_t>(),
+          ::py::arg("maxPivots") = 10,
+          ::py::arg("tolerance") = 1e-9,
+          ::py::arg("epsilonForDivision") = 1e-12)
+      .def_readwrite(
+          "mMaxPivots",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::Option::mMaxPivots)
+      .def_readwrite(
+          "mTolerance",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::Option::mTolerance)
+      .def_readwrite(
+          "mEpsilonForDivision",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::Option::
+              mEpsilonForDivision);
+
+  ::py::class_<
+      dart::constraint::BlockPivotingBoxedLcpSolver,
+      dart::constraint::DantzigBoxedLcpSolver,
+      std::shared_ptr<dart::constraint::BlockPivotingBoxedLcpSolver>>(
+      m, "BlockPivotingBoxedLcpSolver")
+      .def(::py::init<>())
+      .def(
+          "getType",
+          +[](const dart::constraint::BlockPivotingBoxedLcpSolver* self)
+              -> const std::string& { return self->getType(); },
+          ::py::return_value_policy::reference_internal)
+      .def(
+          "setOption",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::setOption,
+          ::py::arg("option"))
+      .def(
+          "getOption",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::getOption,
+          ::py::return_value_policy::reference_internal)
+      .def(
+          "setPerformanceLog",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::setPerformanceLog,
+          ::py::arg("log"))
+      .def(
+          "getLastNumPivots",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::getLastNumPivots)
+      .def(
+          "getLastUsedFallback",
+          &dart::constraint::BlockPivotingBoxedLcpSolver::getLastUsedFallback)
+      .def_static(
+          "getStaticType",
+          +[]() -> const std::string& {
+            return dart::constraint::BlockPivotingBoxedLcpSolver::
+                getStaticType();
+          },
+          ::py::return_value_policy::reference_internal);
+}
+
+} // namespace python
+} // namespace dart
@@ -64,7 +64,16 @@ void BoxedLcpConstraintSolver(py::module& m)
           +[](const dart::constraint::BoxedLcpConstraintSolver* self)
               -> dart::constraint::ConstBoxedLcpSolverPtr {
             return self->getBoxedLcpSolver();
-          });
+          })
+      .def(
+          "setWarmStartedLcpEnabled",
+          &dart::constraint::BoxedLcpConstraintSolver::
+              setWarmStartedLcpEnabled,
+          ::py::arg("enabled"))
+      .def(
+          "isWarmStartedLcpEnabled",
+          &dart::constraint::BoxedLcpConstraintSolver::
+              isWarmStartedLcpEnabled);
 }
 
 } // namespace python
@@ -43,6 +43,24 @@ namespace python {
 
 void ConstraintSolver(py::module& m)
 {
+  ::py::class_<dart::constraint::ContactCoherenceStats>(
+      m, "ContactCoherenceStats")
+      .def(::py::init<>())
+      .def_readwrite(
+          "numSteps", &dart::constraint::ContactCoherenceStats::numSteps)
+      .def_readwrite(
+          "numPersistentContacts",
+          &dart::constraint::ContactCoherenceStats::numPersistentContacts)
+      .def_readwrite(
+          "numNewContacts",
+          &dart::constraint::ContactCoherenceStats::numNewContacts)
+      .def_readwrite(
+          "numRemovedContacts",
+          &dart::constraint::ContactCoherenceStats::numRemovedContacts)
+      .def_readwrite(
+          "numReusedConstrainedGroups",
+          &dart::constraint::ContactCoherenceStats::numReusedConstrainedGroups);
+
   ::py::class_<
       dart::constraint::ConstraintSolver,
       std::shared_ptr<dart::constraint::ConstraintSolver>>(
@@ -147,6 +165,28 @@ void ConstraintSolver(py::module& m)
               -> dart::collision::ConstCollisionGroupPtr {
             return self->getCollisionGroup();
           })
+      .def(
+          "setContactCoherenceEnabled",
+          +[](dart::constraint::ConstraintSolver* self, bool enabled) {
+            self->setContactCoherenceEnabled(enabled);
+          },
+          ::py::arg("enabled"))
+      .def(
+          "getContactCoherenceEnabled",
+          +[](const dart::constraint::ConstraintSolver* self) -> bool {
+            return self->getContactCoherenceEnabled();
+          })
+      .def(
+          "getContactCoherenceStats",
+          +[](const dart::constraint::ConstraintSolver* self)
+              -> dart::constraint::ContactCoherenceStats {
+            return self->getContactCoherenceStats();
+          })
+      .def(
+          "resetContactCoherenceStats",
+          +[](dart::constraint::ConstraintSolver* self) {
+            self->resetContactCoherenceStats();
+          })
       .def(
           "solve",
           +[](dart::constraint::ConstraintSolver* self,
@@ -44,6 +44,7 @@ void JointCoulombFrictionConstraint(py::module& sm);
 
 void BoxedLcpSolver(py::module& sm);
 void DantzigBoxedLcpSolver(py::module& sm);
+void BlockPivotingBoxedLcpSolver(py::module& sm);
 void PgsBoxedLcpSolver(py::module& sm);
 
 void ConstraintSolver(py::module& sm);
@@ -64,6 +65,7 @@ void dart_constraint(py::module& m)
 
   BoxedLcpSolver(sm);
   DantzigBoxedLcpSolver(sm);
+  BlockPivotingBoxedLcpSolver(sm);
   PgsBoxedLcpSolver(sm);
 
   ConstraintSolver(sm);
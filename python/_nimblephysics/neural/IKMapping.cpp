@@ -63,7 +63,31 @@ void IKMapping(py::module& m)
           "addAngularBodyNode",
           &dart::neural::IKMapping::addAngularBodyNode,
           "This adds the angular (3D) coordinates of a body node to the "
-          "mapping, increasing the dimension of the mapped space by 3");
+          "mapping, increasing the dimension of the mapped space by 3")
+      .def(
+          "setIKIterationLimit",
+          &dart::neural::IKMapping::setIKIterationLimit,
+          ::py::arg("limit"))
+      .def("getIKIterationLimit", &dart::neural::IKMapping::getIKIterationLimit)
+      .def(
+          "setIKWarmStart",
+          &dart::neural::IKMapping::setIKWarmStart,
+          ::py::arg("warmStart"),
+          "By default, the IK solve in setPositions() starts from all zeros, "
+          "which makes the answer independent of the world's prior state. "
+          "Turning this on starts every solve from the world's current "
+          "positions, which is faster but order dependent.")
+      .def("getIKWarmStart", &dart::neural::IKMapping::getIKWarmStart)
+      .def(
+          "setIKTolerance",
+          &dart::neural::IKMapping::setIKTolerance,
+          ::py::arg("tolerance"))
+      .def("getIKTolerance", &dart::neural::IKMapping::getIKTolerance)
+      .def(
+          "setIKDamping",
+          &dart::neural::IKMapping::setIKDamping,
+          ::py::arg("damping"))
+      .def("getIKDamping", &dart::neural::IKMapping::getIKDamping);
 }
 
 } // namespace python
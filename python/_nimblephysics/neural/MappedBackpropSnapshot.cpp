@@ -52,74 +52,87 @@ void MappedBackpropSnapshot(py::module& m)
           ::py::arg("thisTimestepLoss"),
           ::py::arg("nextTimestepLosses"),
           ::py::arg("perfLog") = nullptr,
-          ::py::arg("exploreAlternateStrategies") = false)
+          ::py::arg("exploreAlternateStrategies") = false,
+          ::py::call_guard<py::gil_scoped_release>())
       .def("getMappings", &dart::neural::MappedBackpropSnapshot::getMappings)
       .def(
           "getVelVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getVelVelJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getControlForceVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getControlForceVelJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getPosPosJacobian",
           &dart::neural::MappedBackpropSnapshot::getPosPosJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getVelPosJacobian",
           &dart::neural::MappedBackpropSnapshot::getVelPosJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getPosVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getPosVelJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getMassVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getMassVelJacobian,
           ::py::arg("world"),
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getVelMappedVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getVelMappedVelJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getControlForceMappedVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getControlForceMappedVelJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getPosMappedPosJacobian",
           &dart::neural::MappedBackpropSnapshot::getPosMappedPosJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getVelMappedPosJacobian",
           &dart::neural::MappedBackpropSnapshot::getVelMappedPosJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getPosMappedVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getPosMappedVelJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getMassMappedVelJacobian",
           &dart::neural::MappedBackpropSnapshot::getMassMappedVelJacobian,
           ::py::arg("world"),
           ::py::arg("mapAfter") = "identity",
-          ::py::arg("perfLog") = nullptr)
+          ::py::arg("perfLog") = nullptr,
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getPreStepPosition",
           &dart::neural::MappedBackpropSnapshot::getPreStepPosition,
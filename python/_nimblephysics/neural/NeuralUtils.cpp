@@ -95,13 +95,15 @@ void NeuralUtils(py::module& m)
       "forwardPass",
       &dart::neural::forwardPass,
       ::py::arg("world"),
-      ::py::arg("idempotent") = false);
+      ::py::arg("idempotent") = false,
+      ::py::call_guard<py::gil_scoped_release>());
   m.def(
       "mappedForwardPass",
       &dart::neural::mappedForwardPass,
       ::py::arg("world"),
       ::py::arg("mappings"),
-      ::py::arg("idempotent") = false);
+      ::py::arg("idempotent") = false,
+      ::py::call_guard<py::gil_scoped_release>());
   m.def(
       "convertJointSpaceToWorldSpace",
       &dart::neural::convertJointSpaceToWorldSpace,
@@ -48,9 +48,25 @@ void PerformanceLog(py::module& m)
       .def(
           "prettyPrint",
           &dart::performance::FinalizedPerformanceLog::prettyPrint)
-      .def("toJson", &dart::performance::FinalizedPerformanceLog::toJson);
+      .def("toJson", &dart::performance::FinalizedPerformanceLog::toJson)
+      .def(
+          "getCounterTotal",
+          &dart::performance::FinalizedPerformanceLog::getCounterTotal,
+          ::py::arg("name"))
+      .def(
+          "getCounterSamples",
+          &dart::performance::FinalizedPerformanceLog::getCounterSamples,
+          ::py::arg("name"));
 
   ::py::class_<dart::performance::PerformanceLog>(m, "PerformanceLog")
+      .def_static(
+          "startRoot",
+          +[](const std::string& name) -> dart::performance::PerformanceLog* {
+            return dart::performance::PerformanceLog::startRoot(name.c_str());
+          },
+          ::py::arg("name"),
+          ::py::return_value_policy::reference)
+      .def("end", &dart::performance::PerformanceLog::end)
       .def(
           "finalize",
           +[](dart::performance::PerformanceLog* self)
@@ -31,6 +31,7 @@
  */
 
 #include <dart/realtime/MPC.hpp>
+#include <dart/realtime/Millis.hpp>
 #include <dart/simulation/World.hpp>
 #include <dart/trajectory/LossFn.hpp>
 #include <dart/trajectory/Optimizer.hpp>
@@ -50,10 +51,19 @@ void MPC(py::module& m)
       m, "MPC")
       .def(
           "getRemainingPlanBufferMillis",
-          &dart::realtime::MPC::getRemainingPlanBufferMillis)
+          +[](dart::realtime::MPC* self) -> long {
+            return dart::realtime::toMillis(self->getRemainingPlanBuffer());
+          })
       .def(
           "recordGroundTruthState",
-          &dart::realtime::MPC::recordGroundTruthState,
+          +[](dart::realtime::MPC* self,
+              long time,
+              Eigen::VectorXs pos,
+              Eigen::VectorXs vel,
+              Eigen::VectorXs mass) -> void {
+            self->recordGroundTruthState(
+                dart::realtime::fromEpochMillis(time), pos, vel, mass);
+          },
           ::py::arg("time"),
           ::py::arg("pos"),
           ::py::arg("vel"),
@@ -63,8 +73,16 @@ void MPC(py::module& m)
           &dart::realtime::MPC::recordGroundTruthStateNow,
           ::py::arg("pos"),
           ::py::arg("vel"),
-          ::py::arg("mass"))
-      .def("getControlForce", &dart::realtime::MPC::getControlForce, ::py::arg("now"))
+          ::py::arg("mass"),
+          "The time is in wall clock milliseconds since the epoch")
+      .def(
+          "getControlForce",
+          +[](dart::realtime::MPC* self, long now) -> Eigen::VectorXs {
+            return self->getControlForce(dart::realtime::fromEpochMillis(now));
+          },
+          ::py::arg("now"),
+          "The time is in wall clock milliseconds since the epoch, like the "
+          "deadlines Ticker.registerTickListener() gets")
       .def("getControlForceNow", &dart::realtime::MPC::getControlForceNow)
       .def(
           "start",
@@ -73,8 +91,24 @@ void MPC(py::module& m)
       .def("stop", &dart::realtime::MPC::stop)
       .def(
           "registerReplaningListener",
-          &dart::realtime::MPC::registerReplanningListener,
+          +[](dart::realtime::MPC* self,
+              std::function<void(
+                  long, const dart::trajectory::TrajectoryRollout*, long)>
+                  replanListener) -> void {
+            self->registerReplanningListener(
+                [replanListener](
+                    dart::realtime::TimePoint startTime,
+                    const dart::trajectory::TrajectoryRollout* rollout,
+                    dart::realtime::Duration duration) {
+                  replanListener(
+                      dart::realtime::toEpochMillis(startTime),
+                      rollout,
+                      dart::realtime::toMillis(duration));
+                });
+          },
           ::py::arg("replanListener"),
+          "The listener gets the plan's start time in wall clock milliseconds "
+          "since the epoch, and how many milliseconds it took to compute",
           ::py::call_guard<py::gil_scoped_release>());
 }
 
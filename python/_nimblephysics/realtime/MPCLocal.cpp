@@ -32,6 +32,7 @@
 
 #include <dart/realtime/MPC.hpp>
 #include <dart/realtime/MPCLocal.hpp>
+#include <dart/realtime/Millis.hpp>
 #include <dart/simulation/World.hpp>
 #include <dart/trajectory/LossFn.hpp>
 #include <dart/trajectory/Optimizer.hpp>
@@ -52,10 +53,12 @@ void MPCLocal(py::module& m)
       dart::realtime::MPC,
       std::shared_ptr<dart::realtime::MPCLocal>>(m, "MPCLocal")
       .def(
-          ::py::init<
-              std::shared_ptr<dart::simulation::World>,
-              std::shared_ptr<dart::trajectory::LossFn>,
-              int>(),
+          ::py::init([](std::shared_ptr<dart::simulation::World> world,
+                        std::shared_ptr<dart::trajectory::LossFn> loss,
+                        int planningHorizonMillis) {
+            return std::make_shared<dart::realtime::MPCLocal>(
+                world, loss, std::chrono::milliseconds(planningHorizonMillis));
+          }),
           ::py::arg("world"),
           ::py::arg("loss"),
           ::py::arg("planningHorizonMillis"))
@@ -70,9 +73,6 @@ void MPCLocal(py::module& m)
           ::py::arg("problem"))
       .def("getProblem", &dart::realtime::MPCLocal::getProblem)
       .def("getOptimizer", &dart::realtime::MPCLocal::getOptimizer)
-      .def(
-          "getRemainingPlanBufferMillis",
-          &dart::realtime::MPCLocal::getRemainingPlanBufferMillis)
       .def(
           "setSilent",
           &dart::realtime::MPCLocal::setSilent,
@@ -94,13 +94,6 @@ void MPCLocal(py::module& m)
           "setMaxIterations",
           &dart::realtime::MPCLocal::setMaxIterations,
           ::py::arg("maxIterations"))
-      .def(
-          "recordGroundTruthState",
-          &dart::realtime::MPCLocal::recordGroundTruthState,
-          ::py::arg("time"),
-          ::py::arg("pos"),
-          ::py::arg("vel"),
-          ::py::arg("mass"))
       .def(
           "recordGroundTruthStateNow",
           &dart::realtime::MPCLocal::recordGroundTruthStateNow,
@@ -109,11 +102,17 @@ void MPCLocal(py::module& m)
           ::py::arg("mass"))
       .def(
           "optimizePlan",
-          &dart::realtime::MPCLocal::optimizePlan,
+          +[](dart::realtime::MPCLocal* self, long now) -> void {
+            self->optimizePlan(dart::realtime::fromEpochMillis(now));
+          },
           ::py::arg("now"))
       .def(
           "adjustPerformance",
-          &dart::realtime::MPCLocal::adjustPerformance,
+          +[](dart::realtime::MPCLocal* self,
+              long lastOptimizationTimeMillis) -> void {
+            self->adjustPerformance(
+                std::chrono::milliseconds(lastOptimizationTimeMillis));
+          },
           ::py::arg("lastOptimizationTimeMillis"))
       .def("start", &dart::realtime::MPCLocal::start)
       .def("stop", &dart::realtime::MPCLocal::stop)
@@ -124,11 +123,23 @@ void MPCLocal(py::module& m)
           "A blocking call - this starts a gRPC server that clients can "
           "connect to to get MPC computations done remotely",
           ::py::call_guard<py::gil_scoped_release>())
-      .def("getCurrentSolution", &dart::realtime::MPCLocal::getCurrentSolution)
       .def(
-          "registerReplaningListener",
-          &dart::realtime::MPCLocal::registerReplanningListener,
-          ::py::arg("replanListener"));
+          "serveSharedMemory",
+          +[](dart::realtime::MPCLocal* self,
+              const std::string& name,
+              bool replaceExisting) {
+            self->serveSharedMemory(name, replaceExisting);
+          },
+          ::py::arg("name"),
+          ::py::arg("replaceExisting") = false,
+          "A blocking call - this creates a named shared memory channel that "
+          "MPCSharedMemory clients on this machine can connect to, for much "
+          "lower latency than serve(). If the name is already taken, this "
+          "returns straight away, unless replaceExisting is True, which takes "
+          "over a name left behind by a server that crashed.",
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "getCurrentSolution", &dart::realtime::MPCLocal::getCurrentSolution);
 }
 
 } // namespace python
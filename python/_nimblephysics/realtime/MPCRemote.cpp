@@ -52,7 +52,18 @@ void MPCRemote(py::module& m)
       dart::realtime::MPC,
       std::shared_ptr<dart::realtime::MPCRemote>>(m, "MPCRemote")
       .def(
-          ::py::init<std::string, int, int, int, int>(),
+          ::py::init([](std::string host,
+                        int port,
+                        int dofs,
+                        int steps,
+                        int millisPerStep) {
+            return std::make_shared<dart::realtime::MPCRemote>(
+                host,
+                port,
+                dofs,
+                steps,
+                std::chrono::milliseconds(millisPerStep));
+          }),
           ::py::arg("host"),
           ::py::arg("port"),
           ::py::arg("dofs"),
@@ -62,32 +73,17 @@ void MPCRemote(py::module& m)
           ::py::init<dart::realtime::MPCLocal&, int>(),
           ::py::arg("local"),
           ::py::arg("ignored") = 0)
-      .def(
-          "getRemainingPlanBufferMillis",
-          &dart::realtime::MPCRemote::getRemainingPlanBufferMillis)
-      .def(
-          "recordGroundTruthState",
-          &dart::realtime::MPCRemote::recordGroundTruthState,
-          ::py::arg("time"),
-          ::py::arg("pos"),
-          ::py::arg("vel"),
-          ::py::arg("mass"))
       .def(
           "recordGroundTruthStateNow",
           &dart::realtime::MPCRemote::recordGroundTruthStateNow,
           ::py::arg("pos"),
           ::py::arg("vel"),
           ::py::arg("mass"))
-      .def("getControlForce", &dart::realtime::MPCRemote::getControlForce, ::py::arg("now"))
       .def(
           "start",
           &dart::realtime::MPCRemote::start,
           ::py::call_guard<py::gil_scoped_release>())
-      .def("stop", &dart::realtime::MPCRemote::stop)
-      .def(
-          "registerReplaningListener",
-          &dart::realtime::MPCRemote::registerReplanningListener,
-          ::py::arg("replanListener"));
+      .def("stop", &dart::realtime::MPCRemote::stop);
 }
 
 } // namespace python
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <dart/realtime/MPC.hpp>
+#include <dart/realtime/MPCSharedMemory.hpp>
+#include <dart/trajectory/TrajectoryRollout.hpp>
+#include <pybind11/eigen.h>
+#include <pybind11/functional.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+namespace dart {
+namespace python {
+
+void MPCSharedMemory(py::module& m)
+{
+  ::py::class_<
+      dart::realtime::MPCSharedMemory,
+      dart::realtime::MPC,
+      std::shared_ptr<dart::realtime::MPCSharedMemory>>(m, "MPCSharedMemory")
+      .def(::py::init<std::string>(), ::py::arg("name"))
+      .def(::py::init<dart::realtime::MPCLocal&>(), ::py::arg("local"))
+      .def(
+          "recordGroundTruthStateNow",
+          &dart::realtime::MPCSharedMemory::recordGroundTruthStateNow,
+          ::py::arg("pos"),
+          ::py::arg("vel"),
+          ::py::arg("mass"))
+      .def(
+          "start",
+          &dart::realtime::MPCSharedMemory::start,
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "stop",
+          &dart::realtime::MPCSharedMemory::stop,
+          ::py::call_guard<py::gil_scoped_release>());
+}
+
+} // namespace python
+} // namespace dart
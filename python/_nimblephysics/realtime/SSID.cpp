@@ -30,6 +30,7 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <dart/realtime/Millis.hpp>
 #include <dart/realtime/SSID.hpp>
 #include <dart/simulation/World.hpp>
 #include <dart/trajectory/LossFn.hpp>
@@ -48,11 +49,16 @@ void SSID(py::module& m)
 {
   ::py::class_<dart::realtime::SSID>(m, "SSID")
       .def(
-          ::py::init<
-              std::shared_ptr<dart::simulation::World>,
-              std::shared_ptr<dart::trajectory::LossFn>,
-              int,
-              int>(),
+          ::py::init([](std::shared_ptr<dart::simulation::World> world,
+                        std::shared_ptr<dart::trajectory::LossFn> loss,
+                        int planningHorizonMillis,
+                        int sensorDim) {
+            return new dart::realtime::SSID(
+                world,
+                loss,
+                std::chrono::milliseconds(planningHorizonMillis),
+                sensorDim);
+          }),
           ::py::arg("world"),
           ::py::arg("loss"),
           ::py::arg("planningHorizonMillis"),
@@ -68,7 +74,16 @@ void SSID(py::module& m)
       .def("getOptimizer", &dart::realtime::SSID::getOptimizer)
       .def(
           "setInitialPosEstimator",
-          &dart::realtime::SSID::setInitialPosEstimator,
+          +[](dart::realtime::SSID* self,
+              std::function<Eigen::VectorXs(Eigen::MatrixXs, long)>
+                  initialPosEstimator) -> void {
+            self->setInitialPosEstimator(
+                [initialPosEstimator](
+                    Eigen::MatrixXs sensors, dart::realtime::TimePoint time) {
+                  return initialPosEstimator(
+                      sensors, dart::realtime::toEpochMillis(time));
+                });
+          },
           ::py::arg("initialPosEstimator"))
       .def(
           "registerSensorsNow",
@@ -80,14 +95,26 @@ void SSID(py::module& m)
           ::py::arg("controls"))
       .def(
           "registerSensors",
-          &dart::realtime::SSID::registerSensors,
+          +[](dart::realtime::SSID* self,
+              long now,
+              Eigen::VectorXs sensors) -> void {
+            self->registerSensors(
+                dart::realtime::fromEpochMillis(now), sensors);
+          },
           ::py::arg("now"),
-          ::py::arg("sensors"))
+          ::py::arg("sensors"),
+          "The time is in wall clock milliseconds since the epoch")
       .def(
           "registerControls",
-          &dart::realtime::SSID::registerControls,
+          +[](dart::realtime::SSID* self,
+              long now,
+              Eigen::VectorXs controls) -> void {
+            self->registerControls(
+                dart::realtime::fromEpochMillis(now), controls);
+          },
           ::py::arg("now"),
-          ::py::arg("controls"))
+          ::py::arg("controls"),
+          "The time is in wall clock milliseconds since the epoch")
       .def(
           "start",
           &dart::realtime::SSID::start,
@@ -95,12 +122,37 @@ void SSID(py::module& m)
       .def("stop", &dart::realtime::SSID::stop)
       .def(
           "runInference",
-          &dart::realtime::SSID::runInference,
+          +[](dart::realtime::SSID* self, long startTime) -> void {
+            self->runInference(dart::realtime::fromEpochMillis(startTime));
+          },
           ::py::arg("startTime"))
       .def(
           "registerInferListener",
-          &dart::realtime::SSID::registerInferListener,
-          ::py::arg("inferListener"));
+          +[](dart::realtime::SSID* self,
+              std::function<void(
+                  long,
+                  Eigen::VectorXs,
+                  Eigen::VectorXs,
+                  Eigen::VectorXs,
+                  long)> inferListener) -> void {
+            self->registerInferListener(
+                [inferListener](
+                    dart::realtime::TimePoint time,
+                    Eigen::VectorXs pos,
+                    Eigen::VectorXs vel,
+                    Eigen::VectorXs mass,
+                    dart::realtime::Duration duration) {
+                  inferListener(
+                      dart::realtime::toEpochMillis(time),
+                      pos,
+                      vel,
+                      mass,
+                      dart::realtime::toMillis(duration));
+                });
+          },
+          ::py::arg("inferListener"),
+          "The listener gets the inferred time in wall clock milliseconds "
+          "since the epoch, and how many milliseconds inference took");
 }
 
 } // namespace python
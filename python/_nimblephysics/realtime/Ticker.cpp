@@ -1,6 +1,8 @@
 #include <iostream>
 
 #include <Python.h>
+#include <dart/performance/PerformanceLog.hpp>
+#include <dart/realtime/Millis.hpp>
 #include <dart/realtime/Ticker.hpp>
 #include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
@@ -10,6 +12,41 @@ namespace py = pybind11;
 namespace dart {
 namespace python {
 
+/// Wraps a Python tick listener, so it gets the GIL and any exception it
+/// throws gets reported instead of taking down the ticker thread. The listener
+/// gets each deadline as `toTime(deadline)`.
+template <typename Time>
+std::function<void(dart::realtime::TimePoint)> wrapTickListener(
+    std::function<void(Time)> callback,
+    Time (*toTime)(dart::realtime::TimePoint))
+{
+  return [callback, toTime](dart::realtime::TimePoint deadline) {
+    /* Acquire GIL before calling Python code */
+    py::gil_scoped_acquire acquire;
+    try
+    {
+      callback(toTime(deadline));
+    }
+    catch (::py::error_already_set& e)
+    {
+      if (e.matches(PyExc_KeyboardInterrupt))
+      {
+        std::cout << "Nimble caught a keyboard interrupt in a callback from "
+                     "registerTickListener(). Exiting with code 0."
+                  << std::endl;
+        exit(0);
+      }
+      else
+      {
+        std::cout << "Nimble caught an exception calling callback from "
+                     "registerTickListener():"
+                  << std::endl
+                  << std::string(e.what()) << std::endl;
+      }
+    }
+  };
+}
+
 void Ticker(py::module& m)
 {
   ::py::class_<dart::realtime::Ticker, std::shared_ptr<dart::realtime::Ticker>>(
@@ -19,43 +56,50 @@ void Ticker(py::module& m)
           "registerTickListener",
           +[](dart::realtime::Ticker* self,
               std::function<void(long)> callback) -> void {
-            std::function<void(long now)> wrappedCallback
-                = [callback](long now) {
-                    /* Acquire GIL before calling Python code */
-                    py::gil_scoped_acquire acquire;
-                    try
-                    {
-                      callback(now);
-                    }
-                    catch (::py::error_already_set& e)
-                    {
-                      if (e.matches(PyExc_KeyboardInterrupt))
-                      {
-                        std::cout
-                            << "Nimble caught a keyboard interrupt in a "
-                               "callback from registerTickListener(). Exiting "
-                               "with code 0."
-                            << std::endl;
-                        exit(0);
-                      }
-                      else
-                      {
-                        std::cout << "Nimble caught an exception calling "
-                                     "callback from registerTickListener():"
-                                  << std::endl
-                                  << std::string(e.what()) << std::endl;
-                      }
-                    }
-                  };
-            self->registerTickListener(wrappedCallback);
+            self->registerTickListener(wrapTickListener<long>(
+                callback, &dart::realtime::toEpochMillis));
+          },
+          ::py::arg("listener"),
+          "This registers a listener that gets each tick's scheduled deadline "
+          "in wall clock milliseconds since the epoch, which is what the MPC "
+          "methods take")
+      .def(
+          "registerTickListenerNanos",
+          +[](dart::realtime::Ticker* self,
+              std::function<void(int64_t)> callback) -> void {
+            self->registerTickListener(wrapTickListener<int64_t>(
+                callback, +[](dart::realtime::TimePoint deadline) -> int64_t {
+                  return deadline.time_since_epoch().count();
+                }));
           },
-          ::py::arg("listener"))
+          ::py::arg("listener"),
+          "This registers a listener that gets each tick's scheduled deadline "
+          "in nanoseconds on the steady clock, instead of wall clock millis")
       .def(
           "start",
           &dart::realtime::Ticker::start,
           ::py::call_guard<py::gil_scoped_release>())
       .def("stop", &dart::realtime::Ticker::stop)
-      .def("clear", &dart::realtime::Ticker::clear);
+      .def("clear", &dart::realtime::Ticker::clear)
+      .def(
+          "setSpinWaitNanos",
+          +[](dart::realtime::Ticker* self, int64_t nanos) -> void {
+            self->setSpinWait(dart::realtime::Duration(nanos));
+          },
+          ::py::arg("nanos"))
+      .def(
+          "getSpinWaitNanos",
+          +[](dart::realtime::Ticker* self) -> int64_t {
+            return self->getSpinWait().count();
+          })
+      .def("getNumTicks", &dart::realtime::Ticker::getNumTicks)
+      .def("getNumOverruns", &dart::realtime::Ticker::getNumOverruns)
+      .def("getNumSkippedTicks", &dart::realtime::Ticker::getNumSkippedTicks)
+      .def(
+          "setPerformanceLog",
+          &dart::realtime::Ticker::setPerformanceLog,
+          ::py::arg("log"),
+          ::py::keep_alive<1, 2>());
 }
 
 } // namespace python
@@ -41,6 +41,7 @@ namespace python {
 
 void MPCLocal(py::module& sm);
 void MPCRemote(py::module& sm);
+void MPCSharedMemory(py::module& sm);
 void MPC(py::module& sm);
 void Ticker(py::module& sm);
 
@@ -55,6 +56,7 @@ void dart_realtime(py::module& m)
   MPC(sm);
   MPCLocal(sm);
   MPCRemote(sm);
+  MPCSharedMemory(sm);
   Ticker(sm);
 }
 
@@ -30,6 +30,9 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdexcept>
+#include <string>
+
 #include <dart/collision/CollisionResult.hpp>
 #include <dart/constraint/ConstraintSolver.hpp>
 #include <dart/dynamics/Skeleton.hpp>
@@ -44,6 +47,23 @@ namespace py = pybind11;
 namespace dart {
 namespace python {
 
+namespace {
+
+/// The *Into() bindings write straight into caller-owned NumPy (or Torch, via
+/// `.numpy()`) memory, so they can't resize it for the caller
+void checkBufferSize(
+    const Eigen::Ref<Eigen::VectorXs>& out, std::size_t expected, const char* fn)
+{
+  if (static_cast<std::size_t>(out.size()) != expected)
+  {
+    throw std::invalid_argument(
+        std::string("World.") + fn + "() expected a buffer of size "
+        + std::to_string(expected) + ", got " + std::to_string(out.size()));
+  }
+}
+
+} // namespace
+
 void World(py::module& m)
 {
   ::py::class_<
@@ -240,13 +260,15 @@ void World(py::module& m)
           +[](dart::simulation::World* self) -> void { return self->reset(); })
       .def(
           "step",
-          +[](dart::simulation::World* self) -> void { return self->step(); })
+          +[](dart::simulation::World* self) -> void { return self->step(); },
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "step",
           +[](dart::simulation::World* self, bool _resetCommand) -> void {
             return self->step(_resetCommand);
           },
-          ::py::arg("resetCommand"))
+          ::py::arg("resetCommand"),
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "setTime",
           +[](dart::simulation::World* self, s_t _time) -> void {
@@ -301,6 +323,33 @@ void World(py::module& m)
           +[](dart::simulation::World* self) -> Eigen::VectorXs {
             return self->getControlForces();
           })
+      .def(
+          "getPositionsInto",
+          +[](dart::simulation::World* self, Eigen::Ref<Eigen::VectorXs> out)
+              -> void {
+            checkBufferSize(out, self->getNumDofs(), "getPositionsInto");
+            self->getPositionsInto(out);
+          },
+          ::py::arg("out").noconvert(),
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "getVelocitiesInto",
+          +[](dart::simulation::World* self, Eigen::Ref<Eigen::VectorXs> out)
+              -> void {
+            checkBufferSize(out, self->getNumDofs(), "getVelocitiesInto");
+            self->getVelocitiesInto(out);
+          },
+          ::py::arg("out").noconvert(),
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "getControlForcesInto",
+          +[](dart::simulation::World* self, Eigen::Ref<Eigen::VectorXs> out)
+              -> void {
+            checkBufferSize(out, self->getNumDofs(), "getControlForcesInto");
+            self->getControlForcesInto(out);
+          },
+          ::py::arg("out").noconvert(),
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getMasses",
           +[](dart::simulation::World* self) -> Eigen::VectorXs {
@@ -348,17 +397,25 @@ void World(py::module& m)
           })
       .def(
           "setPositions",
-          +[](dart::simulation::World* self, Eigen::VectorXs positions)
-              -> void { self->setPositions(positions); })
+          +[](dart::simulation::World* self,
+              Eigen::Ref<const Eigen::VectorXs> positions) -> void {
+            self->setPositions(positions);
+          },
+          ::py::arg("positions"))
       .def(
           "setVelocities",
-          +[](dart::simulation::World* self, Eigen::VectorXs velocities)
-              -> void { self->setVelocities(velocities); })
+          +[](dart::simulation::World* self,
+              Eigen::Ref<const Eigen::VectorXs> velocities) -> void {
+            self->setVelocities(velocities);
+          },
+          ::py::arg("velocities"))
       .def(
           "setControlForces",
-          +[](dart::simulation::World* self, Eigen::VectorXs forces) -> void {
+          +[](dart::simulation::World* self,
+              Eigen::Ref<const Eigen::VectorXs> forces) -> void {
             self->setControlForces(forces);
-          })
+          },
+          ::py::arg("forces"))
       .def(
           "setMasses",
           +[](dart::simulation::World* self, Eigen::VectorXs forces) -> void {
@@ -398,22 +455,26 @@ void World(py::module& m)
           "getCoriolisAndGravityForces",
           +[](dart::simulation::World* self) -> Eigen::VectorXs {
             return self->getCoriolisAndGravityForces();
-          })
+          },
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getCoriolisAndGravityAndExternalForces",
           +[](dart::simulation::World* self) -> Eigen::VectorXs {
             return self->getCoriolisAndGravityAndExternalForces();
-          })
+          },
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getMassMatrix",
           +[](dart::simulation::World* self) -> Eigen::MatrixXs {
             return self->getMassMatrix();
-          })
+          },
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getInvMassMatrix",
           +[](dart::simulation::World* self) -> Eigen::MatrixXs {
             return self->getInvMassMatrix();
-          })
+          },
+          ::py::call_guard<py::gil_scoped_release>())
       .def(
           "getParallelVelocityAndPositionUpdates",
           &dart::simulation::World::getParallelVelocityAndPositionUpdates)
@@ -421,6 +482,12 @@ void World(py::module& m)
           "setParallelVelocityAndPositionUpdates",
           &dart::simulation::World::setParallelVelocityAndPositionUpdates,
           ::py::arg("enabled"))
+      .def(
+          "getNumStepThreads", &dart::simulation::World::getNumStepThreads)
+      .def(
+          "setNumStepThreads",
+          &dart::simulation::World::setNumStepThreads,
+          ::py::arg("numThreads"))
       .def(
           "getPenetrationCorrectionEnabled",
           &dart::simulation::World::getPenetrationCorrectionEnabled)
@@ -428,6 +495,13 @@ void World(py::module& m)
           "setPenetrationCorrectionEnabled",
           &dart::simulation::World::setPenetrationCorrectionEnabled,
           ::py::arg("enabled"))
+      .def(
+          "getWarmStartedLcpEnabled",
+          &dart::simulation::World::getWarmStartedLcpEnabled)
+      .def(
+          "setWarmStartedLcpEnabled",
+          &dart::simulation::World::setWarmStartedLcpEnabled,
+          ::py::arg("enabled"))
       .def(
           "getFallbackConstraintForceMixingConstant",
           &dart::simulation::World::getFallbackConstraintForceMixingConstant)
@@ -459,8 +533,23 @@ void World(py::module& m)
           "setSlowDebugResultsAgainstFD",
           &dart::simulation::World::setSlowDebugResultsAgainstFD)
       .def("getStateSize", &dart::simulation::World::getStateSize)
-      .def("setState", &dart::simulation::World::setState, ::py::arg("state"))
+      .def(
+          "setState",
+          +[](dart::simulation::World* self,
+              Eigen::Ref<const Eigen::VectorXs> state) -> void {
+            self->setState(state);
+          },
+          ::py::arg("state"))
       .def("getState", &dart::simulation::World::getState)
+      .def(
+          "getStateInto",
+          +[](dart::simulation::World* self, Eigen::Ref<Eigen::VectorXs> out)
+              -> void {
+            checkBufferSize(out, self->getStateSize(), "getStateInto");
+            self->getStateInto(out);
+          },
+          ::py::arg("out").noconvert(),
+          ::py::call_guard<py::gil_scoped_release>())
       .def("getActionSize", &dart::simulation::World::getActionSize)
       .def(
           "setAction", &dart::simulation::World::setAction, ::py::arg("action"))
@@ -478,8 +567,14 @@ void World(py::module& m)
           "addDofToActionSpace",
           &dart::simulation::World::addDofToActionSpace,
           ::py::arg("dofIndex"))
-      .def("getStateJacobian", &dart::simulation::World::getStateJacobian)
-      .def("getActionJacobian", &dart::simulation::World::getActionJacobian)
+      .def(
+          "getStateJacobian",
+          &dart::simulation::World::getStateJacobian,
+          ::py::call_guard<py::gil_scoped_release>())
+      .def(
+          "getActionJacobian",
+          &dart::simulation::World::getActionJacobian,
+          ::py::call_guard<py::gil_scoped_release>())
       .def_readonly("onNameChanged", &dart::simulation::World::onNameChanged);
 }
 
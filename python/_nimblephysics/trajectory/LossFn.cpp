@@ -75,7 +75,12 @@ void LossFn(py::module& m)
           "setLowerBound",
           &dart::trajectory::LossFn::setLowerBound,
           ::py::arg("lowerBound"))
-      .def("getLowerBound", &dart::trajectory::LossFn::getLowerBound);
+      .def("getLowerBound", &dart::trajectory::LossFn::getLowerBound)
+      .def(
+          "setNumThreads",
+          &dart::trajectory::LossFn::setNumThreads,
+          ::py::arg("numThreads"))
+      .def("getNumThreads", &dart::trajectory::LossFn::getNumThreads);
 }
 
 } // namespace python
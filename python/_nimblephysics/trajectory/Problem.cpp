@@ -399,6 +399,15 @@ void Problem(py::module& m)
   "getSparseJacobian",
   &dart::trajectory::Problem::getSparseJacobian,
   ::py::arg("sparse"))
+.def(
+  "backpropSparseJacobian",
+  +[](dart::trajectory::Problem* self,
+      std::shared_ptr<simulation::World> world) -> Eigen::SparseMatrix<s_t> {
+    Eigen::SparseMatrix<s_t> jac;
+    self->backpropSparseJacobian(world, jac);
+    return jac;
+  },
+  ::py::arg("world"))
 .def(
   "finiteDifferenceJacobian",
   &dart::trajectory::Problem::finiteDifferenceJacobian,
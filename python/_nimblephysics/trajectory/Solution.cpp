@@ -42,21 +42,35 @@ namespace python {
 
 void Solution(py::module& m)
 {
+  ::py::enum_<dart::trajectory::IterationLogCompression>(
+      m, "IterationLogCompression")
+      .value("UNCOMPRESSED", dart::trajectory::UNCOMPRESSED)
+      .value("DELTA", dart::trajectory::DELTA)
+      .value("FLOAT16", dart::trajectory::FLOAT16)
+      .export_values();
+
   ::py::class_<
       dart::trajectory::Solution,
       std::shared_ptr<dart::trajectory::Solution>>(m, "Solution")
       .def("toJson", &dart::trajectory::Solution::toJson, ::py::arg("world"))
       .def("getNumSteps", &dart::trajectory::Solution::getNumSteps)
       .def(
-          "getStep",
-          &dart::trajectory::Solution::getStep,
-          ::py::arg("step"),
-          ::py::return_value_policy::reference_internal)
+          "getStep", &dart::trajectory::Solution::getStep, ::py::arg("step"))
       .def(
           "getPerfLog",
           &dart::trajectory::Solution::getPerfLog,
           ::py::return_value_policy::reference)
-      .def("reoptimize", &dart::trajectory::Solution::reoptimize);
+      .def("reoptimize", &dart::trajectory::Solution::reoptimize)
+      .def(
+          "streamIterationsTo",
+          &dart::trajectory::Solution::streamIterationsTo,
+          ::py::arg("path"),
+          ::py::arg("compression") = dart::trajectory::UNCOMPRESSED,
+          ::py::arg("decimation") = 1)
+      .def_static(
+          "openIterationLog",
+          &dart::trajectory::Solution::openIterationLog,
+          ::py::arg("path"));
 
   ::py::class_<dart::trajectory::OptimizationStep>(m, "OptimizationStep")
       .def_readonly("index", &dart::trajectory::OptimizationStep::index)
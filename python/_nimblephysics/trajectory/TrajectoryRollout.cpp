@@ -30,7 +30,10 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdexcept>
+
 #include <dart/simulation/World.hpp>
+#include <dart/trajectory/Problem.hpp>
 #include <dart/trajectory/TrajectoryConstants.hpp>
 #include <dart/trajectory/TrajectoryRollout.hpp>
 #include <pybind11/eigen.h>
@@ -75,6 +78,36 @@ void TrajectoryRollout(py::module& m)
           "copy",
           &dart::trajectory::TrajectoryRollout::copy,
           ::py::return_value_policy::automatic);
+
+  ::py::class_<
+      dart::trajectory::TrajectoryRolloutReal,
+      dart::trajectory::TrajectoryRollout>(m, "TrajectoryRolloutReal")
+      .def(
+          ::py::init<dart::trajectory::Problem*>(), ::py::arg("shot"))
+      .def(
+          ::py::init([](dart::trajectory::Problem* shot,
+                        Eigen::Ref<Eigen::VectorXs> arena) {
+            if (arena.size()
+                != dart::trajectory::TrajectoryRolloutReal::getArenaSize(shot))
+            {
+              throw std::invalid_argument(
+                  "arena must have exactly getArenaSize(shot) entries");
+            }
+            return new dart::trajectory::TrajectoryRolloutReal(
+                shot, arena.data());
+          }),
+          ::py::arg("shot"),
+          ::py::arg("arena"),
+          ::py::keep_alive<1, 3>())
+      .def_static(
+          "getArenaSize",
+          ::py::overload_cast<dart::trajectory::Problem*>(
+              &dart::trajectory::TrajectoryRolloutReal::getArenaSize),
+          ::py::arg("shot"))
+      .def(
+          "getArena",
+          &dart::trajectory::TrajectoryRolloutReal::getArena,
+          ::py::return_value_policy::reference_internal);
 }
 
 } // namespace python
@@ -42,9 +42,12 @@ namespace python {
 void Optimizer(py::module& sm);
 void IPOptOptimizer(py::module& sm);
 void SGDOptimizer(py::module& sm);
+void LBFGSOptimizer(py::module& sm);
+void AdamOptimizer(py::module& sm);
 void LossFn(py::module& sm);
 void Problem(py::module& sm);
 void MultiShot(py::module& sm);
+void MultiShotEnsemble(py::module& sm);
 void SingleShot(py::module& sm);
 void TrajectoryRollout(py::module& sm);
 void Solution(py::module& sm);
@@ -60,9 +63,12 @@ void dart_trajectory(py::module& m)
   Optimizer(sm);
   IPOptOptimizer(sm);
   SGDOptimizer(sm);
+  LBFGSOptimizer(sm);
+  AdamOptimizer(sm);
   LossFn(sm);
   Problem(sm);
   MultiShot(sm);
+  MultiShotEnsemble(sm);
   SingleShot(sm);
   TrajectoryRollout(sm);
   Solution(sm);
@@ -47,6 +47,26 @@ void AccelerationSmoother(py::module& m)
           "smooth",
           &dart::utils::AccelerationSmoother::smooth,
           ::py::arg("series"))
+      .def(
+          "smoothWindowed",
+          &dart::utils::AccelerationSmoother::smoothWindowed,
+          ::py::arg("series"),
+          ::py::arg("overlap"))
+      .def(
+          "startStream",
+          &dart::utils::AccelerationSmoother::startStream,
+          ::py::arg("overlap"))
+      .def(
+          "pushFrame",
+          &dart::utils::AccelerationSmoother::pushFrame,
+          ::py::arg("frame"))
+      .def("finishStream", &dart::utils::AccelerationSmoother::finishStream)
+      .def(
+          "getNumSmoothedFrames",
+          &dart::utils::AccelerationSmoother::getNumSmoothedFrames)
+      .def(
+          "popSmoothedFrame",
+          &dart::utils::AccelerationSmoother::popSmoothedFrame)
       .def(
           "debugTimeSeries",
           &dart::utils::AccelerationSmoother::debugTimeSeries,
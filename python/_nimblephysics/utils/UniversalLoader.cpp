@@ -59,6 +59,16 @@ void UniversalLoader(py::module& m)
       ::py::arg("path"),
       ::py::arg("basePosition"),
       ::py::arg("baseEulerXYZ"));
+  sm.def(
+      "setCacheEnabled",
+      &dart::utils::UniversalLoader::setCacheEnabled,
+      ::py::arg("enabled"));
+  sm.def("isCacheEnabled", &dart::utils::UniversalLoader::isCacheEnabled);
+  sm.def(
+      "evictFromCache",
+      &dart::utils::UniversalLoader::evictFromCache,
+      ::py::arg("path"));
+  sm.def("clearCache", &dart::utils::UniversalLoader::clearCache);
 }
 
 } // namespace python
@@ -308,6 +308,81 @@ bool verifyShotGradient(
   return true;
 }
 
+bool verifyCheckpointedShot(
+    WorldPtr world,
+    int steps,
+    int checkpointInterval,
+    std::shared_ptr<Mapping> mapping)
+{
+  LossFn lossFn = LossFn();
+  SingleShot shot(world, lossFn, steps, true);
+  SingleShot checkpointed(world, lossFn, steps, true);
+  checkpointed.setCheckpointInterval(checkpointInterval);
+  if (mapping != nullptr)
+  {
+    shot.addMapping("custom", mapping);
+    checkpointed.addMapping("custom", mapping);
+  }
+
+  int stateSize = world->getNumDofs() * 2;
+  int dim = shot.getFlatProblemDim(world);
+
+  srand(42);
+  Eigen::MatrixXs forces = Eigen::MatrixXs::Random(world->getNumDofs(), steps);
+  shot.setControlForcesRaw(forces);
+  checkpointed.setControlForcesRaw(forces);
+
+  // Replaying segments from checkpoints has to reproduce the original forward
+  // pass exactly, so everything downstream should match bit for bit
+  Eigen::MatrixXs jac = Eigen::MatrixXs::Zero(stateSize, dim);
+  shot.backpropJacobianOfFinalState(world, jac);
+  Eigen::MatrixXs checkpointedJac = Eigen::MatrixXs::Zero(stateSize, dim);
+  checkpointed.backpropJacobianOfFinalState(world, checkpointedJac);
+  if (!equals(jac, checkpointedJac, 0))
+  {
+    std::cout << "Checkpointed Jacobians don't match!" << std::endl;
+    std::cout << "Diff:" << std::endl << (jac - checkpointedJac) << std::endl;
+    return false;
+  }
+
+  TrajectoryRolloutReal rollout = TrajectoryRolloutReal(&shot);
+  shot.getStates(world, &rollout);
+  TrajectoryRolloutReal checkpointedRollout
+      = TrajectoryRolloutReal(&checkpointed);
+  checkpointed.getStates(world, &checkpointedRollout);
+  for (std::string key : rollout.getMappings())
+  {
+    if (!equals(rollout.getPoses(key), checkpointedRollout.getPoses(key), 0)
+        || !equals(rollout.getVels(key), checkpointedRollout.getVels(key), 0))
+    {
+      std::cout << "Checkpointed rollouts don't match for mapping \"" << key
+                << "\"!" << std::endl;
+      return false;
+    }
+  }
+  if (!equals(
+          shot.getFinalState(world), checkpointed.getFinalState(world), 0))
+  {
+    std::cout << "Checkpointed final states don't match!" << std::endl;
+    return false;
+  }
+
+  // Use the rollout itself as an arbitrary incoming gradient
+  Eigen::VectorXs grad = Eigen::VectorXs::Zero(dim);
+  static_cast<Problem&>(shot).backpropGradientWrt(world, &rollout, grad);
+  Eigen::VectorXs checkpointedGrad = Eigen::VectorXs::Zero(dim);
+  static_cast<Problem&>(checkpointed)
+      .backpropGradientWrt(world, &rollout, checkpointedGrad);
+  if (!equals(grad, checkpointedGrad, 0))
+  {
+    std::cout << "Checkpointed gradients don't match!" << std::endl;
+    std::cout << "Diff:" << std::endl
+              << (grad - checkpointedGrad) << std::endl;
+    return false;
+  }
+  return true;
+}
+
 bool verifyMultiShotJacobian(
     WorldPtr world, int steps, int shotLength, std::shared_ptr<Mapping> mapping)
 {
@@ -370,7 +445,7 @@ bool verifyMultiShotJacobian(
   return true;
 }
 
-bool verifySparseJacobian(WorldPtr world, MultiShot& shot)
+bool verifySparseJacobian(WorldPtr world, Problem& shot)
 {
   // Random initialization
   /*
@@ -398,7 +473,24 @@ bool verifySparseJacobian(WorldPtr world, MultiShot& shot)
     sparseRecoveredJacobian(rows(i), cols(i)) = sparseValues(i);
   }
 
+  Eigen::SparseMatrix<s_t> nativeSparseJacobian;
+  shot.backpropSparseJacobian(world, nativeSparseJacobian);
+
   s_t threshold = 0;
+  if (!equals(
+          analyticalJacobian, Eigen::MatrixXs(nativeSparseJacobian), threshold))
+  {
+    std::cout << "Native sparse jacobian doesn't match!" << std::endl;
+    return false;
+  }
+  // The second call reuses the cached sparsity pattern
+  shot.backpropSparseJacobian(world, nativeSparseJacobian);
+  if (!equals(
+          analyticalJacobian, Eigen::MatrixXs(nativeSparseJacobian), threshold))
+  {
+    std::cout << "Native sparse jacobian doesn't match on reuse!" << std::endl;
+    return false;
+  }
   if (!equals(analyticalJacobian, sparseRecoveredJacobian, threshold))
   {
     std::cout << "Sparse jacobians don't match!" << std::endl;
@@ -59,6 +59,24 @@ class Collision : public testing::Test
 public:
 };
 
+//==============================================================================
+void expectSameContacts(
+    const CollisionResult& expected, const CollisionResult& actual)
+{
+  ASSERT_EQ(expected.getNumContacts(), actual.getNumContacts());
+  for (std::size_t i = 0; i < expected.getNumContacts(); ++i)
+  {
+    const auto& contact1 = expected.getContact(i);
+    const auto& contact2 = actual.getContact(i);
+    EXPECT_EQ(contact1.collisionObject1, contact2.collisionObject1);
+    EXPECT_EQ(contact1.collisionObject2, contact2.collisionObject2);
+    EXPECT_EQ(contact1.type, contact2.type);
+    EXPECT_TRUE(equals(contact1.point, contact2.point));
+    EXPECT_TRUE(equals(contact1.normal, contact2.normal));
+    EXPECT_EQ(contact1.penetrationDepth, contact2.penetrationDepth);
+  }
+}
+
 //==============================================================================
 void testSimpleFrames(const std::shared_ptr<CollisionDetector>& cd)
 {
@@ -1072,4 +1090,89 @@ TEST_F(Collision, Factory)
   EXPECT_TRUE(!collision::CollisionDetector::getFactory()->canCreate("ode"));
 #endif
 }
-#endif
\ No newline at end of file
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST_F(Collision, DARTBatchedNarrowphase)
+{
+  auto cd = DARTCollisionDetector::create();
+  EXPECT_TRUE(cd->getUseBatchedNarrowphase());
+
+  std::vector<SimpleFramePtr> frames;
+  for (std::size_t i = 0; i < 60; ++i)
+  {
+    auto frame = SimpleFrame::createShared(Frame::World());
+    ShapePtr shape;
+    switch (i % 4)
+    {
+      case 0:
+        shape = std::make_shared<SphereShape>(Random::uniform<s_t>(0.1, 0.4));
+        break;
+      case 1:
+        shape = std::make_shared<BoxShape>(
+            Random::uniform<Eigen::Vector3s>(0.2, 0.8));
+        break;
+      case 2:
+        shape = std::make_shared<CapsuleShape>(
+            Random::uniform<s_t>(0.1, 0.3), Random::uniform<s_t>(0.2, 0.8));
+        break;
+      default:
+        shape = std::make_shared<EllipsoidShape>(
+            Eigen::Vector3s::Constant(Random::uniform<s_t>(0.2, 0.8)));
+        break;
+    }
+    frame->setShape(shape);
+
+    Eigen::Isometry3s tf = Eigen::Isometry3s::Identity();
+    tf.linear() = expMapRot(Random::uniform<Eigen::Vector3s>(-3.0, 3.0));
+    tf.translation() = Random::uniform<Eigen::Vector3s>(-2.0, 2.0);
+    frame->setRelativeTransform(tf);
+    frames.push_back(frame);
+  }
+
+  auto groupAll = cd->createCollisionGroup();
+  auto groupA = cd->createCollisionGroup();
+  auto groupB = cd->createCollisionGroup();
+  for (std::size_t i = 0; i < frames.size(); ++i)
+  {
+    groupAll->addShapeFrame(frames[i].get());
+    if (i < frames.size() / 3)
+      groupA->addShapeFrame(frames[i].get());
+    else
+      groupB->addShapeFrame(frames[i].get());
+  }
+
+  CollisionOption option(true, 1000u);
+  CollisionResult batched;
+  CollisionResult unbatched;
+
+  cd->setUseBatchedNarrowphase(true);
+  const bool batchedFound = groupAll->collide(option, &batched);
+  // The shapes are spread out enough that plenty of pairs can't touch, so the
+  // bulk pass has to have ruled some out for the comparison to mean anything
+  EXPECT_LT(0u, cd->getNumCulledPairs());
+  cd->setUseBatchedNarrowphase(false);
+  const bool unbatchedFound = groupAll->collide(option, &unbatched);
+  EXPECT_EQ(0u, cd->getNumCulledPairs());
+  EXPECT_EQ(unbatchedFound, batchedFound);
+  EXPECT_LT(0u, unbatched.getNumContacts());
+  expectSameContacts(unbatched, batched);
+
+  cd->setUseBatchedNarrowphase(true);
+  groupA->collide(groupB.get(), option, &batched);
+  cd->setUseBatchedNarrowphase(false);
+  groupA->collide(groupB.get(), option, &unbatched);
+  expectSameContacts(unbatched, batched);
+
+  // Binary checks stop at the first colliding pair either way. With a result,
+  // collide() only reports the last pair it checked, so compare these against
+  // each other rather than against unbatchedFound
+  const bool unbatchedAnyFound = groupAll->collide();
+  EXPECT_TRUE(unbatchedAnyFound);
+  const bool unbatchedPairFound = groupA->collide(groupB.get());
+  cd->setUseBatchedNarrowphase(true);
+  EXPECT_EQ(unbatchedAnyFound, groupAll->collide());
+  EXPECT_EQ(unbatchedPairFound, groupA->collide(groupB.get()));
+}
+#endif
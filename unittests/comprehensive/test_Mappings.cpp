@@ -357,4 +357,60 @@ TEST(GRADIENTS, WORLD_SPACE_BOXES_FREE_JOINT)
 {
   testWorldSpaceWithBoxes(2);
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ALL_TESTS
+TEST(GRADIENTS, IK_WARM_START)
+{
+  srand(42);
+
+  WorldPtr world = World::create();
+  SkeletonPtr arm = Skeleton::create("arm");
+  BodyNode* parent = nullptr;
+  for (int i = 0; i < 3; i++)
+  {
+    RevoluteJoint::Properties jointProps;
+    jointProps.mName = "revolute_" + std::to_string(i);
+    BodyNode::Properties bodyProps;
+    bodyProps.mName = "arm_" + std::to_string(i);
+    std::pair<RevoluteJoint*, BodyNode*> jointPair
+        = arm->createJointAndBodyNodePair<RevoluteJoint>(
+            parent, jointProps, bodyProps);
+    Eigen::Isometry3s bodyOffset = Eigen::Isometry3s::Identity();
+    bodyOffset.translation() = Eigen::Vector3s(0, -1.0, 0);
+    jointPair.first->setTransformFromChildBodyNode(bodyOffset);
+    jointPair.first->setAxis(Eigen::Vector3s::UnitX());
+    parent = jointPair.second;
+  }
+  world->addSkeleton(arm);
+
+  // The end of the arm has more DOFs than it needs to reach a point
+  std::shared_ptr<IKMapping> mapping = std::make_shared<IKMapping>(world);
+  mapping->addLinearBodyNode(parent);
+
+  EXPECT_FALSE(mapping->getIKWarmStart());
+  mapping->setIKWarmStart(true);
+
+  Eigen::VectorXs solution = Eigen::VectorXs::Random(3);
+  world->setPositions(solution);
+  Eigen::VectorXs target = mapping->getPositions(world);
+
+  // Starting from the answer, we shouldn't move at all
+  mapping->setPositions(world, target);
+  EXPECT_TRUE(equals(solution, world->getPositions(), 0));
+
+  // Starting nearby, we should converge back onto the target
+  world->setPositions(solution + Eigen::VectorXs::Random(3) * 0.1);
+  mapping->setPositions(world, target);
+  EXPECT_TRUE(equals(target, mapping->getPositions(world), 1e-9));
+
+  // Without warm starting, the answer doesn't depend on where we started
+  mapping->setIKWarmStart(false);
+  world->setPositions(Eigen::VectorXs::Random(3));
+  mapping->setPositions(world, target);
+  Eigen::VectorXs coldSolution = world->getPositions();
+  EXPECT_TRUE(equals(target, mapping->getPositions(world), 1e-9));
+  world->setPositions(Eigen::VectorXs::Random(3));
+  mapping->setPositions(world, target);
+  EXPECT_TRUE(equals(coldSolution, world->getPositions(), 0));
+}
+#endif
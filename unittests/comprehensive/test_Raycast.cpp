@@ -43,18 +43,16 @@ using namespace dart;
 //==============================================================================
 void testBasicInterface(const std::shared_ptr<CollisionDetector>& cd)
 {
+  if (cd->getType() != DARTCollisionDetector::getStaticType()
 #if HAVE_BULLET
-  if (cd->getType() != collision::BulletCollisionDetector::getStaticType())
+      && cd->getType() != collision::BulletCollisionDetector::getStaticType()
+#endif
+  )
   {
-    dtwarn << "Aborting test: distance check is not supported by "
-           << cd->getType() << ".\n";
+    dtwarn << "Aborting test: raycast is not supported by " << cd->getType()
+           << ".\n";
     return;
   }
-#else
-  dtwarn << "Aborting test: distance check is not supported by "
-         << cd->getType() << ".\n";
-  return;
-#endif
 
   auto simpleFrame1 = SimpleFrame::createShared(Frame::World());
 
@@ -130,18 +128,16 @@ TEST(Distance, testBasicInterface)
 //==============================================================================
 void testOptions(const std::shared_ptr<CollisionDetector>& cd)
 {
+  if (cd->getType() != DARTCollisionDetector::getStaticType()
 #if HAVE_BULLET
-  if (cd->getType() != collision::BulletCollisionDetector::getStaticType())
+      && cd->getType() != collision::BulletCollisionDetector::getStaticType()
+#endif
+  )
   {
-    dtwarn << "Aborting test: distance check is not supported by "
-           << cd->getType() << ".\n";
+    dtwarn << "Aborting test: raycast is not supported by " << cd->getType()
+           << ".\n";
     return;
   }
-#else
-  dtwarn << "Aborting test: distance check is not supported by "
-         << cd->getType() << ".\n";
-  return;
-#endif
 
   auto simpleFrame1 = SimpleFrame::createShared(Frame::World());
   auto shape1 = std::make_shared<SphereShape>(1.0);
@@ -208,3 +204,220 @@ TEST(Distance, testOptions)
   auto dart = DARTCollisionDetector::create();
   testOptions(dart);
 }
+
+//==============================================================================
+TEST(Raycast, DARTBatchMatchesSingleRays)
+{
+  auto cd = DARTCollisionDetector::create();
+
+  auto group = cd->createCollisionGroup();
+  std::vector<std::shared_ptr<SimpleFrame>> frames;
+  for (int i = 0; i < 5; ++i)
+  {
+    for (int j = 0; j < 5; ++j)
+    {
+      auto frame = SimpleFrame::createShared(Frame::World());
+      if ((i + j) % 3 == 0)
+        frame->setShape(std::make_shared<SphereShape>(0.4));
+      else if ((i + j) % 3 == 1)
+        frame->setShape(
+            std::make_shared<BoxShape>(Eigen::Vector3s(0.6, 0.5, 0.7)));
+      else
+        frame->setShape(std::make_shared<CapsuleShape>(0.3, 0.5));
+      frame->setTranslation(Eigen::Vector3s(i - 2.0, j - 2.0, 0.0));
+      group->addShapeFrame(frame.get());
+      frames.push_back(frame);
+    }
+  }
+
+  std::vector<Eigen::Vector3s> from;
+  std::vector<Eigen::Vector3s> to;
+  for (int i = 0; i < 1000; ++i)
+  {
+    from.push_back(Eigen::Vector3s::Random() * 3.0 + Eigen::Vector3s(0, 0, 4));
+    to.push_back(Eigen::Vector3s::Random() * 3.0 - Eigen::Vector3s(0, 0, 4));
+  }
+
+  collision::RaycastOption option;
+  std::vector<collision::RaycastResult> results;
+  cd->setNumRaycastThreads(4);
+  EXPECT_EQ(cd->getNumRaycastThreads(), 4u);
+  const std::size_t numHits
+      = cd->raycastBatch(group.get(), from, to, option, &results);
+  ASSERT_EQ(results.size(), from.size());
+
+  std::size_t numExpectedHits = 0u;
+  for (std::size_t i = 0; i < from.size(); ++i)
+  {
+    collision::RaycastResult expected;
+    if (cd->raycast(group.get(), from[i], to[i], option, &expected))
+      ++numExpectedHits;
+
+    ASSERT_EQ(expected.hasHit(), results[i].hasHit());
+    if (!expected.hasHit())
+      continue;
+
+    EXPECT_EQ(
+        expected.mRayHits[0].mCollisionObject,
+        results[i].mRayHits[0].mCollisionObject);
+    EXPECT_NEAR(
+        expected.mRayHits[0].mFraction, results[i].mRayHits[0].mFraction, 1e-9);
+  }
+  EXPECT_EQ(numHits, numExpectedHits);
+  EXPECT_GT(numHits, 0u);
+}
+
+//==============================================================================
+TEST(Distance, DARTConvexShapes)
+{
+  auto cd = DARTCollisionDetector::create();
+
+  auto frame1 = SimpleFrame::createShared(Frame::World());
+  frame1->setShape(std::make_shared<BoxShape>(Eigen::Vector3s(2, 2, 2)));
+  auto frame2 = SimpleFrame::createShared(Frame::World());
+  frame2->setShape(std::make_shared<SphereShape>(0.5));
+  frame2->setTranslation(Eigen::Vector3s(3.0, 0.0, 0.0));
+
+  auto group1 = cd->createCollisionGroup(frame1.get());
+  auto group2 = cd->createCollisionGroup(frame2.get());
+
+  collision::DistanceOption option;
+  option.enableNearestPoints = true;
+  option.distanceLowerBound = -1.0;
+  collision::DistanceResult result;
+
+  s_t distance = cd->distance(group1.get(), group2.get(), option, &result);
+  EXPECT_NEAR(distance, 1.5, 1e-6);
+  EXPECT_NEAR(result.unclampedMinDistance, 1.5, 1e-6);
+  EXPECT_TRUE(result.nearestPoint1.isApprox(Eigen::Vector3s(1, 0, 0), 1e-6));
+  EXPECT_TRUE(
+      result.nearestPoint2.isApprox(Eigen::Vector3s(2.5, 0, 0), 1e-6));
+  EXPECT_EQ(result.shapeFrame1, frame1.get());
+  EXPECT_EQ(result.shapeFrame2, frame2.get());
+
+  // Overlapping shapes report the penetration depth as a negative distance
+  frame2->setTranslation(Eigen::Vector3s(1.25, 0.0, 0.0));
+  distance = cd->distance(group1.get(), group2.get(), option, &result);
+  EXPECT_NEAR(distance, -0.25, 1e-6);
+
+  // A single group measures the closest pair among its own objects
+  auto frame3 = SimpleFrame::createShared(Frame::World());
+  frame3->setShape(std::make_shared<CapsuleShape>(0.5, 1.0));
+  frame3->setTranslation(Eigen::Vector3s(0.0, 0.0, 4.0));
+  frame2->setTranslation(Eigen::Vector3s(0.0, 0.0, 8.0));
+  auto group = cd->createCollisionGroup(
+      frame1.get(), frame2.get(), frame3.get());
+  distance = cd->distance(group.get(), option, &result);
+  EXPECT_NEAR(distance, 2.0, 1e-6);
+  EXPECT_NEAR(result.nearestPoint1[2], 1.0, 1e-6);
+  EXPECT_NEAR(result.nearestPoint2[2], 3.0, 1e-6);
+}
+
+//==============================================================================
+/// Builds a mesh of two parallel triangles, at x = -offset and x = offset.
+/// Its convex hull is a slab that contains the origin, but the mesh itself
+/// stays `offset` away from it.
+aiScene* createTwoTriangleMeshUnsafe(float offset)
+{
+  aiScene* scene = (aiScene*)malloc(sizeof(aiScene));
+  scene->mNumMeshes = 1;
+  aiMesh* mesh = (aiMesh*)malloc(sizeof(aiMesh));
+  scene->mMeshes = (aiMesh**)malloc(sizeof(void*) * scene->mNumMeshes);
+  scene->mMeshes[0] = mesh;
+  scene->mMaterials = nullptr;
+
+  mesh->mNormals = nullptr;
+  mesh->mNumUVComponents[0] = 0;
+
+  mesh->mNumVertices = 6;
+  mesh->mVertices = (aiVector3D*)malloc(sizeof(aiVector3D) * 6);
+  for (int side = 0; side < 2; side++)
+  {
+    const float x = side == 0 ? -offset : offset;
+    aiVector3D* corners = mesh->mVertices + 3 * side;
+    corners[0].x = x;
+    corners[0].y = -1;
+    corners[0].z = -1;
+    corners[1].x = x;
+    corners[1].y = 1;
+    corners[1].z = -1;
+    corners[2].x = x;
+    corners[2].y = 0;
+    corners[2].z = 1;
+  }
+
+  mesh->mNumFaces = 2;
+  mesh->mFaces = (aiFace*)malloc(sizeof(aiFace) * mesh->mNumFaces);
+  for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+  {
+    mesh->mFaces[i].mNumIndices = 3;
+    mesh->mFaces[i].mIndices = (unsigned int*)malloc(sizeof(unsigned int) * 3);
+    for (unsigned int k = 0; k < 3; k++)
+      mesh->mFaces[i].mIndices[k] = 3 * i + k;
+  }
+
+  return scene;
+}
+
+//==============================================================================
+TEST(Distance, DARTConcaveMesh)
+{
+  auto cd = DARTCollisionDetector::create();
+
+  auto meshFrame = SimpleFrame::createShared(Frame::World());
+  meshFrame->setShape(std::make_shared<MeshShape>(
+      Eigen::Vector3s::Ones(),
+      createTwoTriangleMeshUnsafe(2.0),
+      "",
+      nullptr,
+      true));
+  auto sphereFrame = SimpleFrame::createShared(Frame::World());
+  sphereFrame->setShape(std::make_shared<SphereShape>(0.5));
+
+  auto group1 = cd->createCollisionGroup(meshFrame.get());
+  auto group2 = cd->createCollisionGroup(sphereFrame.get());
+
+  collision::DistanceOption option;
+  option.enableNearestPoints = true;
+  option.distanceLowerBound = -1.0;
+  collision::DistanceResult result;
+
+  // The sphere sits inside the mesh's convex hull, but between its triangles
+  s_t distance = cd->distance(group1.get(), group2.get(), option, &result);
+  EXPECT_NEAR(distance, 1.5, 1e-6);
+  EXPECT_NEAR(std::abs(result.nearestPoint1[0]), 2.0, 1e-6);
+  EXPECT_NEAR(std::abs(result.nearestPoint2[0]), 0.5, 1e-6);
+
+  // Mesh to mesh also measures triangles against triangles
+  auto otherMeshFrame = SimpleFrame::createShared(Frame::World());
+  otherMeshFrame->setShape(std::make_shared<MeshShape>(
+      Eigen::Vector3s::Ones(),
+      createTwoTriangleMeshUnsafe(0.5),
+      "",
+      nullptr,
+      true));
+  auto group3 = cd->createCollisionGroup(otherMeshFrame.get());
+  distance = cd->distance(group1.get(), group3.get(), option, &result);
+  EXPECT_NEAR(distance, 1.5, 1e-6);
+}
+
+//==============================================================================
+TEST(Distance, DARTNothingInRange)
+{
+  auto cd = DARTCollisionDetector::create();
+
+  // An empty heightmap never has a triangle in range, so there's no nearest
+  // pair to report
+  auto terrainFrame = SimpleFrame::createShared(Frame::World());
+  terrainFrame->setShape(std::make_shared<HeightmapShapef>());
+  auto sphereFrame = SimpleFrame::createShared(Frame::World());
+  sphereFrame->setShape(std::make_shared<SphereShape>(0.5));
+  auto group
+      = cd->createCollisionGroup(terrainFrame.get(), sphereFrame.get());
+
+  collision::DistanceOption option;
+  collision::DistanceResult result;
+  EXPECT_EQ(cd->distance(group.get(), option, &result), 0.0);
+  EXPECT_EQ(result.shapeFrame1, nullptr);
+  EXPECT_EQ(result.shapeFrame2, nullptr);
+}
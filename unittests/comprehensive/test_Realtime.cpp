@@ -216,8 +216,8 @@ TEST(REALTIME, CARTPOLE_MPC)
   world->setTimeStep(1.0 / 100);
 
   // 300 timesteps
-  int millisPerTimestep = world->getTimeStep() * 1000;
-  int planningHorizonMillis = 300 * millisPerTimestep;
+  Duration timestep = secondsToDuration(world->getTimeStep());
+  Duration planningHorizon = 300 * timestep;
   int advanceSteps = 70;
 
   s_t goalX = 1.0;
@@ -271,13 +271,13 @@ TEST(REALTIME, CARTPOLE_MPC)
       };
 
   MPCLocal mpcLocal = MPCLocal(
-      world, std::make_shared<LossFn>(loss, lossGrad), planningHorizonMillis);
+      world, std::make_shared<LossFn>(loss, lossGrad), planningHorizon);
   mpcLocal.setSilent(true);
 
-  int inferenceHistoryMillis = 10 * millisPerTimestep;
+  Duration inferenceHistory = 10 * timestep;
   std::shared_ptr<simulation::World> ssidWorld = world->clone();
   SSID ssid = SSID(
-      ssidWorld, getSSIDLoss(), inferenceHistoryMillis, world->getNumDofs());
+      ssidWorld, getSSIDLoss(), inferenceHistory, world->getNumDofs());
 
   mpcLocal.setMaxIterations(7);
 
@@ -299,11 +299,11 @@ TEST(REALTIME, CARTPOLE_MPC)
           mpcRemote.recordGroundTruthStateNow(pos, vel, mass);
           // ssid.registerSensorsNow(pos);
         };
-  ssid.registerInferListener([&](long time,
+  ssid.registerInferListener([&](TimePoint time,
                                  Eigen::VectorXs pos,
                                  Eigen::VectorXs vel,
                                  Eigen::VectorXs mass,
-                                 long duration) {
+                                 Duration duration) {
     mpcRemote.recordGroundTruthState(time, pos, vel, mass);
     world->setMasses(mass);
   });
@@ -331,7 +331,7 @@ TEST(REALTIME, CARTPOLE_MPC)
                             ->getVisualAspect();
   Eigen::Vector3s originalColor = sledBodyVisual->getColor();
 
-  ticker.registerTickListener([&](long now) {
+  ticker.registerTickListener([&](TimePoint now) {
     realtimeUnderlyingWorld->setControlForces(mpcRemote.getControlForce(now));
 
     if (server.getKeysDown().count("a"))
@@ -366,7 +366,7 @@ TEST(REALTIME, CARTPOLE_MPC)
 
     /*
     realtimeWorld.registerTiming(
-        "buffer", mpcRemote.getRemainingPlanBufferMillis(), "ms");
+        "buffer", toMillis(mpcRemote.getRemainingPlanBuffer()), "ms");
         */
 
     realtimeUnderlyingWorld->step();
@@ -380,9 +380,9 @@ TEST(REALTIME, CARTPOLE_MPC)
   });
 
   mpcRemote.registerReplanningListener(
-      [&](long time,
+      [&](TimePoint time,
           const trajectory::TrajectoryRollout* rollout,
-          long duration) {
+          Duration duration) {
         server.renderTrajectoryLines(world, rollout->getPosesConst());
         // realtimeWorld.registerTiming("replanning", duration, "ms");
       });
@@ -487,16 +487,16 @@ TEST(REALTIME, CARTPOLE_SSID)
   world->setTimeStep(1.0 / 100);
 
   // 300 timesteps
-  int millisPerTimestep = world->getTimeStep() * 1000;
-  int inferenceHistoryMillis = 5 * millisPerTimestep;
+  Duration timestep = secondsToDuration(world->getTimeStep());
+  Duration inferenceHistory = 5 * timestep;
   int advanceSteps = 70;
 
-  SSID ssid = SSID(world, lossFn, inferenceHistoryMillis, world->getNumDofs());
+  SSID ssid = SSID(world, lossFn, inferenceHistory, world->getNumDofs());
 
   armPair.second->setMass(2.0);
   for (int i = 0; i < 50; i++)
   {
-    long time = i * millisPerTimestep;
+    TimePoint time = TimePoint(i * timestep);
     Eigen::VectorXs forces = Eigen::VectorXs::Ones(world->getNumDofs());
     world->setControlForces(forces);
     world->step();
@@ -505,17 +505,18 @@ TEST(REALTIME, CARTPOLE_SSID)
   }
   armPair.second->setMass(1.0);
 
-  ssid.setInitialPosEstimator([](Eigen::MatrixXs sensors, long timestamp) {
+  ssid.setInitialPosEstimator([](Eigen::MatrixXs sensors,
+                                 TimePoint timestamp) {
     // Use the first column of sensor data as an approximate starting point
     return sensors.col(0);
   });
 
-  ssid.runInference(30 * millisPerTimestep);
+  ssid.runInference(TimePoint(30 * timestep));
 
   std::cout << "Recovered mass after 1st iteration: "
             << armPair.second->getMass() << std::endl;
 
-  ssid.runInference(50 * millisPerTimestep);
+  ssid.runInference(TimePoint(50 * timestep));
 
   std::cout << "Recovered mass after 2nd iteration: "
             << armPair.second->getMass() << std::endl;
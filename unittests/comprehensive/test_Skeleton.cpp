@@ -1050,4 +1050,144 @@ TEST(Skeleton, MultiTreeRobotImplicitMass)
   boxBody->setMass(2);
 
   EXPECT_TRUE(verifyImplicitMass(multiRootRobot));
-}
\ No newline at end of file
+}
+//==============================================================================
+/// A branching tree, with a zero-dof joint in the middle of one branch
+SkeletonPtr createBranchingRobot()
+{
+  SkeletonPtr skel = Skeleton::create("branching");
+
+  auto root = skel->createJointAndBodyNodePair<FreeJoint>(nullptr);
+  auto left = skel->createJointAndBodyNodePair<BallJoint>(root.second);
+  auto leftTip = skel->createJointAndBodyNodePair<RevoluteJoint>(left.second);
+  auto right = skel->createJointAndBodyNodePair<WeldJoint>(root.second);
+  auto rightTip
+      = skel->createJointAndBodyNodePair<UniversalJoint>(right.second);
+  auto rightTip2
+      = skel->createJointAndBodyNodePair<PrismaticJoint>(rightTip.second);
+
+  std::vector<Joint*> joints = {left.first,
+                                leftTip.first,
+                                right.first,
+                                rightTip.first,
+                                rightTip2.first};
+  for (Joint* joint : joints)
+  {
+    Eigen::Isometry3s T = Eigen::Isometry3s::Identity();
+    T.translation() = Eigen::Vector3s::Random();
+    T.linear() = math::expMapRot(Eigen::Vector3s::Random());
+    joint->setTransformFromParentBodyNode(T);
+    T.translation() = 0.3 * Eigen::Vector3s::Random();
+    joint->setTransformFromChildBodyNode(T);
+  }
+
+  for (std::size_t i = 0; i < skel->getNumBodyNodes(); i++)
+  {
+    BodyNode* body = skel->getBodyNode(i);
+    body->setMass(1.0 + i);
+    body->setMomentOfInertia(
+        0.5 + 0.1 * i, 0.6 + 0.1 * i, 0.7, 0.01, 0.02, 0.03);
+    body->setLocalCOM(0.1 * Eigen::Vector3s::Random());
+  }
+
+  return skel;
+}
+
+//==============================================================================
+TEST(Skeleton, CompositeRigidBodyMassMatrix)
+{
+  SkeletonPtr skel = createBranchingRobot();
+  skel->setGravity(Eigen::Vector3s::Zero());
+  const std::size_t dofs = skel->getNumDofs();
+
+  for (int trial = 0; trial < 5; trial++)
+  {
+    skel->setPositions(Eigen::VectorXs::Random(dofs));
+    skel->setVelocities(Eigen::VectorXs::Zero(dofs));
+
+    // multiplyByImplicitMassMatrix() still goes through the recursive
+    // dynamics, so it's an independent reference for the CRBA
+    Eigen::MatrixXs M = skel->getMassMatrix();
+    Eigen::MatrixXs reference(dofs, dofs);
+    for (std::size_t i = 0; i < dofs; i++)
+    {
+      reference.col(i)
+          = skel->multiplyByImplicitMassMatrix(Eigen::VectorXs::Unit(dofs, i));
+    }
+    EXPECT_TRUE(equals(M, reference, 1e-10));
+
+    // The inverse and implicit inverse both come from the LTDL factorization
+    Eigen::MatrixXs Minv = skel->getInvMassMatrix();
+    Eigen::MatrixXs identity = Eigen::MatrixXs::Identity(dofs, dofs);
+    EXPECT_TRUE(equals(Eigen::MatrixXs(Minv * M), identity, 1e-9));
+    EXPECT_TRUE(verifyImplicitMass(skel));
+
+    // With no velocity or gravity, forward dynamics gives M^{-1} * tau
+    Eigen::VectorXs tau = Eigen::VectorXs::Random(dofs);
+    skel->setControlForces(tau);
+    skel->computeForwardDynamics();
+    Eigen::VectorXs expectedAcc = Minv * tau;
+    EXPECT_TRUE(equals(skel->getAccelerations(), expectedAcc, 1e-9));
+    skel->setControlForces(Eigen::VectorXs::Zero(dofs));
+  }
+
+  // A kinematic joint sends M^{-1} back through the articulated body
+  // algorithm, which treats that joint's motion as prescribed. That's not the
+  // full M^{-1} * x, so it should differ from the factorization, and going
+  // back to a force joint should bring the factorization path back.
+  Eigen::MatrixXs Minv = skel->getInvMassMatrix();
+  skel->getJoint(0)->setActuatorType(Joint::VELOCITY);
+  Eigen::VectorXs x = Eigen::VectorXs::Random(dofs);
+  Eigen::VectorXs articulated = skel->multiplyByImplicitInvMassMatrix(x);
+  skel->getJoint(0)->setActuatorType(Joint::FORCE);
+  Eigen::VectorXs factored = Minv * x;
+  EXPECT_FALSE(equals(articulated, factored, 1e-9));
+  EXPECT_TRUE(
+      equals(skel->multiplyByImplicitInvMassMatrix(x), factored, 1e-9));
+}
+
+//==============================================================================
+TEST(Skeleton, WorldPositionJacobianCache)
+{
+  SkeletonPtr skel = createBranchingRobot();
+  const std::size_t dofs = skel->getNumDofs();
+
+  std::vector<const BodyNode*> nodes;
+  for (std::size_t i = 0; i < skel->getNumBodyNodes(); i++)
+  {
+    nodes.push_back(skel->getBodyNode(i));
+  }
+
+  for (int trial = 0; trial < 3; trial++)
+  {
+    if (trial < 2)
+    {
+      skel->setPositions(0.3 * Eigen::VectorXs::Random(dofs));
+    }
+    else
+    {
+      // Moving a joint's frame has to invalidate the cache too
+      Eigen::Isometry3s T = Eigen::Isometry3s::Identity();
+      T.translation() = Eigen::Vector3s::Random();
+      skel->getJoint(3)->setTransformFromParentBodyNode(T);
+    }
+
+    Eigen::MatrixXs stacked = skel->getWorldPositionJacobians(nodes);
+    Eigen::MatrixXs stackedVel = skel->getWorldJacobians(nodes);
+    EXPECT_EQ(6 * nodes.size(), stacked.rows());
+    EXPECT_EQ(dofs, stacked.cols());
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+      math::Jacobian J = skel->getWorldPositionJacobian(nodes[i]);
+      Eigen::MatrixXs stackedJ = stacked.block(6 * i, 0, 6, dofs);
+      EXPECT_TRUE(equals(Eigen::MatrixXs(J), stackedJ, 0));
+      math::Jacobian bruteForce
+          = skel->finiteDifferenceWorldPositionJacobian(nodes[i]);
+      EXPECT_TRUE(equals(J, bruteForce, 1e-7));
+
+      Eigen::MatrixXs stackedVelJ = stackedVel.block(6 * i, 0, 6, dofs);
+      EXPECT_TRUE(equals(
+          Eigen::MatrixXs(skel->getWorldJacobian(nodes[i])), stackedVelJ, 0));
+    }
+  }
+}
@@ -37,6 +37,7 @@
 #include <gtest/gtest.h>
 
 #include "dart/common/Console.hpp"
+#include "dart/dynamics/FreeJoint.hpp"
 #include "dart/dynamics/Joint.hpp"
 #include "dart/dynamics/PointMass.hpp"
 #include "dart/dynamics/Skeleton.hpp"
@@ -459,3 +460,197 @@ TEST_F(SoftDynamicsTest, compareEquationsOfMotion)
   //    compareEquationsOfMotion(getList()[i]);
   //  }
 }
+
+//==============================================================================
+/// Creates a floating soft box with one extra point mass, with every point
+/// mass moved away from rest and moving
+dynamics::SkeletonPtr createPointMassTestSkeleton()
+{
+  using namespace dynamics;
+
+  SkeletonPtr skel = Skeleton::create("soft");
+  auto pair = skel->createJointAndBodyNodePair<FreeJoint, SoftBodyNode>();
+  SoftBodyNode* softBody = pair.second;
+  SoftBodyNodeHelper::setBox(
+      softBody,
+      Vector3s(0.3, 0.2, 0.25),
+      Isometry3s::Identity(),
+      Vector3i(3, 3, 3),
+      2.0,
+      500,
+      50,
+      0.2);
+
+  // A point mass added after the fact joins the same sweeps as the others
+  softBody->addPointMass(PointMass::Properties(Vector3s(0.0, 0.2, 0.0), 0.01));
+
+  VectorXs q(skel->getNumDofs());
+  for (int i = 0; i < q.size(); ++i)
+    q[i] = 0.1 * std::sin(1.3 * i + 0.4);
+  skel->setPositions(q);
+  skel->setVelocities(0.5 * q);
+  for (std::size_t i = 0; i < softBody->getNumPointMasses(); ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    pm->setPositions(
+        0.005 * Vector3s(std::sin(i), std::cos(2.0 * i), std::sin(0.7 * i)));
+    pm->setVelocities(0.01 * Vector3s(std::cos(i), std::sin(3.0 * i), 0.3));
+  }
+
+  return skel;
+}
+
+//==============================================================================
+TEST_F(SoftDynamicsTest, pointMassKinematics)
+{
+  using namespace dynamics;
+
+  SkeletonPtr skel = createPointMassTestSkeleton();
+  SoftBodyNode* softBody = skel->getSoftBodyNode(0);
+  PointMass* extra = softBody->getPointMass(softBody->getNumPointMasses() - 1);
+  EXPECT_EQ(extra->getIndexInSoftBodyNode(), softBody->getNumPointMasses() - 1);
+  EXPECT_TRUE(equals(extra->getRestingPosition(), Vector3s(0.0, 0.2, 0.0)));
+
+  const Isometry3s& T = softBody->getWorldTransform();
+  const Vector6s& V = softBody->getSpatialVelocity();
+  for (std::size_t i = 0; i < softBody->getNumPointMasses(); ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    const Vector3s X = pm->getRestingPosition() + pm->getPositions();
+    EXPECT_TRUE(equals(pm->getLocalPosition(), X, 1e-12));
+    EXPECT_TRUE(equals(pm->getWorldPosition(), Vector3s(T * X), 1e-12));
+
+    const Vector3s v
+        = V.head<3>().cross(X) + V.tail<3>() + pm->getVelocities();
+    EXPECT_TRUE(equals(pm->getBodyVelocity(), v, 1e-12));
+    EXPECT_TRUE(equals(
+        pm->getPartialAccelerations(),
+        Vector3s(V.head<3>().cross(pm->getVelocities())),
+        1e-12));
+  }
+
+  skel->computeForwardDynamics();
+
+  // The mass and spring terms of each point mass match the closed forms
+  const s_t dt = skel->getTimeStep();
+  for (std::size_t i = 0; i < softBody->getNumPointMasses(); ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    const s_t m = pm->getMass();
+    const s_t implicitPsi
+        = 1.0
+          / (m + dt * softBody->getDampingCoefficient()
+             + dt * dt * softBody->getVertexSpringStiffness());
+    EXPECT_NEAR(pm->getPsi(), 1.0 / m, 1e-12);
+    EXPECT_NEAR(pm->getImplicitPsi(), implicitPsi, 1e-12);
+    EXPECT_NEAR(pm->getImplicitPi(), m - m * m * implicitPsi, 1e-12);
+
+    // dv = dw(parent) x X + dv(parent) + eta + ddq
+    const Vector6s& A = softBody->getSpatialAcceleration();
+    const Vector3s a = A.head<3>().cross(pm->getLocalPosition()) + A.tail<3>()
+                       + pm->getPartialAccelerations()
+                       + pm->getAccelerations();
+    EXPECT_TRUE(equals(pm->getBodyAcceleration(), a, 1e-10));
+  }
+
+  // Integration moves every point mass by its own velocity
+  std::vector<Vector3s> positions;
+  std::vector<Vector3s> velocities;
+  for (std::size_t i = 0; i < softBody->getNumPointMasses(); ++i)
+  {
+    positions.push_back(softBody->getPointMass(i)->getPositions());
+    velocities.push_back(softBody->getPointMass(i)->getVelocities());
+  }
+  skel->integrateVelocities(dt);
+  skel->integratePositions(dt);
+  for (std::size_t i = 0; i < softBody->getNumPointMasses(); ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    const Vector3s dq = velocities[i] + dt * pm->getAccelerations();
+    EXPECT_TRUE(equals(pm->getVelocities(), dq, 1e-12));
+    EXPECT_TRUE(
+        equals(pm->getPositions(), Vector3s(positions[i] + dt * dq), 1e-12));
+    EXPECT_TRUE(equals(
+        pm->getLocalPosition(),
+        Vector3s(pm->getRestingPosition() + pm->getPositions()),
+        1e-12));
+  }
+}
+
+//==============================================================================
+TEST_F(SoftDynamicsTest, pointMassImpulseAndInverseDynamics)
+{
+  using namespace dynamics;
+
+  SkeletonPtr skel = createPointMassTestSkeleton();
+  SoftBodyNode* softBody = skel->getSoftBodyNode(0);
+  const std::size_t numPointMasses = softBody->getNumPointMasses();
+  const s_t dt = skel->getTimeStep();
+
+  // Inverse dynamics, checked against the per point mass formulas
+  skel->setAccelerations(VectorXs::LinSpaced(skel->getNumDofs(), -0.3, 0.4));
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+  {
+    softBody->getPointMass(i)->setAccelerations(
+        0.02 * Vector3s(std::sin(2.0 * i), 0.1, std::cos(i)));
+  }
+  skel->computeInverseDynamics();
+
+  const Isometry3s& T = softBody->getWorldTransform();
+  const Vector6s& V = softBody->getSpatialVelocity();
+  const Vector6s& A = softBody->getSpatialAcceleration();
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    const s_t m = pm->getMass();
+    const Vector3s X = pm->getRestingPosition() + pm->getPositions();
+    const Vector3s v = V.head<3>().cross(X) + V.tail<3>() + pm->getVelocities();
+    const Vector3s eta = V.head<3>().cross(pm->getVelocities());
+    const Vector3s a
+        = A.head<3>().cross(X) + A.tail<3>() + eta + pm->getAccelerations();
+
+    // f = m*dv + w(parent) x m*v - fgravity
+    const Vector3s f = m * a + V.head<3>().cross(m * v)
+                       - m * (T.linear().transpose() * skel->getGravity());
+    EXPECT_TRUE(equals(pm->getControlForces(), f, 1e-10));
+  }
+
+  // Impulse-based forward dynamics, checked against the per point mass
+  // formulas
+  skel->computeForwardDynamics();
+  std::vector<Vector3s> velocities;
+  std::vector<Vector3s> accelerations;
+  std::vector<Vector3s> forces;
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    pm->setForces(Vector3s(0.01 * i, -0.02, 0.005));
+    pm->setConstraintImpulse(
+        1e-3 * Vector3s(std::cos(i), 0.5, std::sin(3.0 * i)), true);
+    velocities.push_back(pm->getVelocities());
+    accelerations.push_back(pm->getAccelerations());
+    forces.push_back(pm->getControlForces());
+  }
+  skel->computeImpulseForwardDynamics();
+
+  const Vector6s& dV = softBody->getBodyVelocityChange();
+  for (std::size_t i = 0; i < numPointMasses; ++i)
+  {
+    PointMass* pm = softBody->getPointMass(i);
+    const Vector3s imp = pm->getConstraintImpulses();
+    const Vector3s parentDelV
+        = dV.head<3>().cross(pm->getLocalPosition()) + dV.tail<3>();
+    const Vector3s delDq = pm->getPsi() * imp - parentDelV;
+    const Vector3s delV = parentDelV + delDq;
+
+    EXPECT_TRUE(equals(pm->getBodyVelocityChange(), delV, 1e-10));
+    EXPECT_TRUE(
+        equals(pm->getVelocities(), Vector3s(velocities[i] + delDq), 1e-10));
+    EXPECT_TRUE(equals(
+        pm->getAccelerations(),
+        Vector3s(accelerations[i] + delDq / dt + delV / dt),
+        1e-8));
+    EXPECT_TRUE(
+        equals(pm->getControlForces(), Vector3s(forces[i] + imp / dt), 1e-10));
+  }
+}
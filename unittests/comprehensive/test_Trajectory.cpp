@@ -31,6 +31,8 @@
  */
 
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <thread>
 
@@ -53,8 +55,11 @@
 #include "dart/neural/RestorableSnapshot.hpp"
 #include "dart/neural/WithRespectToMass.hpp"
 #include "dart/simulation/World.hpp"
+#include "dart/trajectory/AdamOptimizer.hpp"
 #include "dart/trajectory/IPOptOptimizer.hpp"
+#include "dart/trajectory/LBFGSOptimizer.hpp"
 #include "dart/trajectory/MultiShot.hpp"
+#include "dart/trajectory/MultiShotEnsemble.hpp"
 #include "dart/trajectory/Problem.hpp"
 #include "dart/trajectory/SingleShot.hpp"
 #include "dart/trajectory/Solution.hpp"
@@ -117,6 +122,7 @@ TEST(TRAJECTORY, UNCONSTRAINED_BOX)
   EXPECT_TRUE(verifySingleShot(world, 40, 1e-7, false, nullptr));
   EXPECT_TRUE(verifyShotJacobian(world, 40, nullptr));
   EXPECT_TRUE(verifyMultiShotJacobian(world, 8, 2, nullptr));
+  EXPECT_TRUE(verifyCheckpointedShot(world, 40, 7, nullptr));
 
   // Verify using the IK mapping as the representation
   std::shared_ptr<IKMapping> ikMap = std::make_shared<IKMapping>(world);
@@ -124,6 +130,7 @@ TEST(TRAJECTORY, UNCONSTRAINED_BOX)
   EXPECT_TRUE(verifySingleShot(world, 40, 1e-7, false, ikMap));
   EXPECT_TRUE(verifyShotJacobian(world, 40, ikMap));
   EXPECT_TRUE(verifyMultiShotJacobian(world, 8, 2, ikMap));
+  EXPECT_TRUE(verifyCheckpointedShot(world, 40, 7, ikMap));
 }
 #endif
 
@@ -1426,4 +1433,649 @@ TEST(TRAJECTORY, REOPTIMIZATION)
     record->reoptimize();
   }
 }
-#endif
\ No newline at end of file
+#endif
+//==============================================================================
+/// A box on a plane with no gravity, that wants to get much further than its
+/// force limits allow in the time it has. The optimum pushes every force to
+/// its upper bound, except the last one, which never reaches the final pose.
+std::shared_ptr<Problem> createSaturatingBoxShot(WorldPtr world)
+{
+  world->setGravity(Eigen::Vector3s::Zero());
+  world->setTimeStep(1e-2);
+
+  SkeletonPtr box = Skeleton::create("box");
+  std::pair<TranslationalJoint2D*, BodyNode*> pair
+      = box->createJointAndBodyNodePair<TranslationalJoint2D>(nullptr);
+  pair.first->setXYPlane();
+  pair.second->setMass(1.0);
+  world->addSkeleton(box);
+
+  world->setControlForceUpperLimits(Eigen::Vector2s(1.0, 1.0));
+  world->setControlForceLowerLimits(Eigen::Vector2s(-1.0, -1.0));
+
+  TrajectoryLossFn loss = [](const TrajectoryRollout* rollout) {
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    return (poses.col(poses.cols() - 1) - goal).squaredNorm();
+  };
+  TrajectoryLossFnAndGrad lossGrad = [](const TrajectoryRollout* rollout,
+                                        TrajectoryRollout* gradWrtRollout // OUT
+                                     ) {
+    gradWrtRollout->getPoses("identity").setZero();
+    gradWrtRollout->getVels("identity").setZero();
+    gradWrtRollout->getControlForces("identity").setZero();
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    Eigen::Vector2s diff = poses.col(poses.cols() - 1) - goal;
+    gradWrtRollout->getPoses("identity").col(poses.cols() - 1) = 2 * diff;
+    return diff.squaredNorm();
+  };
+
+  return std::make_shared<SingleShot>(
+      world, LossFn(loss, lossGrad), 20, false);
+}
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, CLONE_PROBLEM)
+{
+  WorldPtr world = World::create();
+  std::shared_ptr<Problem> shot = createSaturatingBoxShot(world);
+  int n = shot->getFlatProblemDim(world);
+  Eigen::VectorXs x = Eigen::VectorXs::Random(n) * 0.5;
+  shot->unflatten(world, x);
+  s_t loss = shot->getLoss(world);
+
+  WorldPtr cloneWorld = world->clone();
+  std::shared_ptr<Problem> copy = shot->clone();
+  EXPECT_NEAR(loss, copy->getLoss(cloneWorld), 1e-12);
+
+  // Changing the copy must leave the original (and its caches) alone
+  copy->unflatten(cloneWorld, Eigen::VectorXs::Zero(n));
+  EXPECT_NE(loss, copy->getLoss(cloneWorld));
+  EXPECT_EQ(loss, shot->getLoss(world));
+  Eigen::VectorXs flat = Eigen::VectorXs::Zero(n);
+  shot->flatten(world, flat);
+  EXPECT_TRUE(equals(x, flat, 0));
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, NATIVE_OPTIMIZERS)
+{
+  for (int candidates = 1; candidates <= 4; candidates += 3)
+  {
+    WorldPtr world = World::create();
+    std::shared_ptr<Problem> shot = createSaturatingBoxShot(world);
+    int n = shot->getFlatProblemDim(world);
+    s_t startLoss = shot->getLoss(world);
+
+    LBFGSOptimizer optimizer;
+    optimizer.setLineSearchCandidates(candidates);
+    optimizer.setIterationLimit(50);
+    std::shared_ptr<Solution> record = optimizer.optimize(shot.get());
+    EXPECT_TRUE(record->getNumSteps() > 1);
+
+    Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+    shot->flatten(world, x);
+    Eigen::VectorXs forces = x.head(n - 2);
+    Eigen::VectorXs start = x.tail(2);
+    EXPECT_TRUE(equals(forces, Eigen::VectorXs::Ones(n - 2).eval(), 1e-8));
+    EXPECT_TRUE(equals(start, Eigen::VectorXs::Zero(2).eval(), 0));
+    EXPECT_LT(shot->getLoss(world), startLoss);
+
+    // Running again reuses the same thread pool, and gets the same answer
+    WorldPtr againWorld = World::create();
+    std::shared_ptr<Problem> again = createSaturatingBoxShot(againWorld);
+    optimizer.optimize(again.get());
+    Eigen::VectorXs againX = Eigen::VectorXs::Zero(n);
+    again->flatten(againWorld, againX);
+    EXPECT_TRUE(equals(x, againX, 0));
+  }
+
+  WorldPtr world = World::create();
+  std::shared_ptr<Problem> shot = createSaturatingBoxShot(world);
+  int n = shot->getFlatProblemDim(world);
+  s_t startLoss = shot->getLoss(world);
+
+  AdamOptimizer adam;
+  adam.setLearningRate(0.1);
+  adam.setIterationLimit(100);
+  int callbacks = 0;
+  adam.registerIntermediateCallback(
+      [&](Problem* /* problem */, int /* step */, s_t, s_t) {
+        callbacks++;
+        return true;
+      });
+  std::shared_ptr<Solution> record = adam.optimize(shot.get());
+  // Once every force is pinned against its bound, the projected gradient
+  // vanishes and we stop early
+  EXPECT_LT(callbacks, 100);
+  EXPECT_EQ(callbacks, record->getNumSteps());
+
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  shot->flatten(world, x);
+  Eigen::VectorXs forces = x.head(n - 2);
+  EXPECT_TRUE(equals(forces, Eigen::VectorXs::Ones(n - 2).eval(), 1e-8));
+  EXPECT_LT(shot->getLoss(world), startLoss);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, ITERATION_LOG)
+{
+  const std::string path = "./test_iteration_log.bin";
+
+  AdamOptimizer adam;
+  adam.setLearningRate(0.1);
+  adam.setIterationLimit(20);
+
+  WorldPtr world = World::create();
+  std::shared_ptr<Solution> inMemory
+      = adam.optimize(createSaturatingBoxShot(world).get());
+  int numSteps = inMemory->getNumSteps();
+  EXPECT_TRUE(numSteps > 1);
+
+  std::vector<long> fileSizes;
+  for (IterationLogCompression compression : {UNCOMPRESSED, DELTA, FLOAT16})
+  {
+    std::shared_ptr<Solution> streamed = std::make_shared<Solution>();
+    EXPECT_TRUE(streamed->streamIterationsTo(path, compression));
+    WorldPtr streamedWorld = World::create();
+    adam.optimize(createSaturatingBoxShot(streamedWorld).get(), streamed);
+    EXPECT_EQ(numSteps, streamed->getNumSteps());
+
+    // FLOAT16 only keeps ~3 significant digits
+    s_t threshold = compression == FLOAT16 ? 2e-3 : 0;
+    for (int i = 0; i < numSteps; i++)
+    {
+      OptimizationStep expected = inMemory->getStep(i);
+      OptimizationStep actual = streamed->getStep(i);
+      EXPECT_EQ(expected.index, actual.index);
+      EXPECT_EQ(expected.loss, actual.loss);
+      EXPECT_TRUE(equals(
+          expected.rollout->getPosesConst("identity"),
+          actual.rollout->getPosesConst("identity"),
+          threshold));
+      EXPECT_TRUE(equals(
+          expected.rollout->getVelsConst("identity"),
+          actual.rollout->getVelsConst("identity"),
+          threshold));
+      EXPECT_TRUE(equals(
+          expected.rollout->getControlForcesConst("identity"),
+          actual.rollout->getControlForcesConst("identity"),
+          threshold));
+    }
+
+    // Only the last step that was decoded is cached, but steps we already
+    // got back stay valid after decoding others
+    OptimizationStep last = streamed->getStep(numSteps - 1);
+    OptimizationStep first = streamed->getStep(0);
+    EXPECT_EQ(numSteps - 1, last.index);
+    EXPECT_EQ(0, first.index);
+    EXPECT_NE(first.rollout, last.rollout);
+    EXPECT_EQ(inMemory->getStep(numSteps - 1).loss, last.loss);
+    EXPECT_TRUE(equals(
+        inMemory->getStep(numSteps - 1).rollout->getPosesConst(),
+        last.rollout->getPosesConst(),
+        threshold));
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    fileSizes.push_back(file.tellg());
+
+    // Another reader sees exactly the same log
+    std::shared_ptr<Solution> reopened = Solution::openIterationLog(path);
+    EXPECT_TRUE(reopened != nullptr);
+    EXPECT_EQ(numSteps, reopened->getNumSteps());
+    EXPECT_EQ(
+        streamed->getStep(numSteps - 1).loss,
+        reopened->getStep(numSteps - 1).loss);
+    EXPECT_EQ(streamed->toJson(world), reopened->toJson(world));
+  }
+  EXPECT_LT(fileSizes[1], fileSizes[0]);
+  EXPECT_LT(fileSizes[2], fileSizes[0]);
+
+  // Decimation keeps every 3rd iteration, plus the last one
+  std::shared_ptr<Solution> decimated = std::make_shared<Solution>();
+  EXPECT_TRUE(decimated->streamIterationsTo(path, DELTA, 3));
+  WorldPtr decimatedWorld = World::create();
+  adam.optimize(createSaturatingBoxShot(decimatedWorld).get(), decimated);
+  int numDecimated = (numSteps + 2) / 3;
+  if ((numSteps - 1) % 3 != 0)
+    numDecimated++;
+  EXPECT_EQ(numDecimated, decimated->getNumSteps());
+  for (int i = 0; i < numDecimated - 1; i++)
+  {
+    EXPECT_EQ(3 * i, decimated->getStep(i).index);
+  }
+  const OptimizationStep& last = decimated->getStep(numDecimated - 1);
+  EXPECT_EQ(numSteps - 1, last.index);
+  EXPECT_EQ(inMemory->getStep(numSteps - 1).loss, last.loss);
+
+  EXPECT_TRUE(Solution::openIterationLog("./does_not_exist.bin") == nullptr);
+  std::remove(path.c_str());
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, ENSEMBLE_MULTI_SHOT)
+{
+  const int steps = 20;
+  const int shotLength = 5;
+  std::vector<s_t> masses = {1.0, 1.5, 0.7};
+
+  TrajectoryLossFn loss = [](const TrajectoryRollout* rollout) {
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    return (poses.col(poses.cols() - 1) - goal).squaredNorm();
+  };
+  TrajectoryLossFnAndGrad lossGrad = [](const TrajectoryRollout* rollout,
+                                        TrajectoryRollout* gradWrtRollout // OUT
+                                     ) {
+    gradWrtRollout->getPoses("identity").setZero();
+    gradWrtRollout->getVels("identity").setZero();
+    gradWrtRollout->getControlForces("identity").setZero();
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    Eigen::Vector2s diff = poses.col(poses.cols() - 1) - goal;
+    gradWrtRollout->getPoses("identity").col(poses.cols() - 1) = 2 * diff;
+    return diff.squaredNorm();
+  };
+
+  // The same box, with a different mass in every world
+  std::vector<WorldPtr> worlds;
+  for (s_t mass : masses)
+  {
+    WorldPtr world = World::create();
+    world->setGravity(Eigen::Vector3s::Zero());
+    world->setTimeStep(1e-2);
+    SkeletonPtr box = Skeleton::create("box");
+    std::pair<TranslationalJoint2D*, BodyNode*> pair
+        = box->createJointAndBodyNodePair<TranslationalJoint2D>(nullptr);
+    pair.first->setXYPlane();
+    pair.second->setMass(mass);
+    world->addSkeleton(box);
+    worlds.push_back(world);
+  }
+  WorldPtr world = worlds[0];
+
+  std::shared_ptr<MultiShotEnsemble> ensemble
+      = std::make_shared<MultiShotEnsemble>(
+          worlds, LossFn(loss, lossGrad), steps, shotLength);
+  Problem& problem = *ensemble;
+
+  // The forces are shared, but every member has its own knots
+  int numShots = steps / shotLength;
+  EXPECT_EQ(
+      steps * 2 + masses.size() * numShots * 4,
+      problem.getFlatDynamicProblemDim(world));
+  EXPECT_EQ(masses.size() * (numShots - 1) * 4, problem.getConstraintDim());
+
+  int dim = problem.getFlatProblemDim(world);
+  srand(42);
+  Eigen::VectorXs x = Eigen::VectorXs::Random(dim) * 0.5;
+  problem.unflatten(world, x);
+  Eigen::VectorXs flat = Eigen::VectorXs::Zero(dim);
+  problem.flatten(world, flat);
+  EXPECT_TRUE(equals(x, flat, 0));
+
+  Eigen::VectorXs analyticalGrad = Eigen::VectorXs::Zero(dim);
+  problem.backpropGradient(world, analyticalGrad);
+  Eigen::VectorXs bruteForceGrad = Eigen::VectorXs::Zero(dim);
+  problem.finiteDifferenceGradient(world, bruteForceGrad);
+  EXPECT_TRUE(equals(analyticalGrad, bruteForceGrad, 2e-8));
+
+  int numConstraints = problem.getConstraintDim();
+  Eigen::MatrixXs analyticalJac = Eigen::MatrixXs::Zero(numConstraints, dim);
+  problem.backpropJacobian(world, analyticalJac);
+  Eigen::MatrixXs bruteForceJac = Eigen::MatrixXs::Zero(numConstraints, dim);
+  problem.finiteDifferenceJacobian(world, bruteForceJac);
+  EXPECT_TRUE(equals(analyticalJac, bruteForceJac, 1e-8));
+  EXPECT_TRUE(verifySparseJacobian(world, problem));
+
+  // Members are independent, so the pool can't change any of the results
+  problem.unflatten(world, x);
+  s_t serialLoss = problem.getLoss(world);
+  Eigen::VectorXs serialConstraints = Eigen::VectorXs::Zero(numConstraints);
+  problem.computeConstraints(world, serialConstraints);
+  ensemble->setNumThreads(3);
+  problem.unflatten(world, x);
+  EXPECT_EQ(serialLoss, problem.getLoss(world));
+  Eigen::VectorXs parallelGrad = Eigen::VectorXs::Zero(dim);
+  problem.backpropGradient(world, parallelGrad);
+  EXPECT_TRUE(equals(analyticalGrad, parallelGrad, 0));
+  Eigen::VectorXs parallelConstraints = Eigen::VectorXs::Zero(numConstraints);
+  problem.computeConstraints(world, parallelConstraints);
+  EXPECT_TRUE(equals(serialConstraints, parallelConstraints, 0));
+  EXPECT_TRUE(verifySparseJacobian(world, problem));
+
+  // An ensemble of one world is just a MultiShot
+  WorldPtr ensembleWorld = world->clone();
+  WorldPtr shotWorld = world->clone();
+  MultiShotEnsemble single(
+      {ensembleWorld}, LossFn(loss, lossGrad), steps, shotLength);
+  MultiShot shot(shotWorld, LossFn(loss, lossGrad), steps, shotLength);
+  EXPECT_EQ(
+      shot.getFlatProblemDim(shotWorld),
+      single.getFlatProblemDim(ensembleWorld));
+  Eigen::MatrixXs forces = Eigen::MatrixXs::Random(2, steps);
+  single.setControlForcesRaw(forces);
+  shot.setControlForcesRaw(forces);
+  EXPECT_EQ(shot.getLoss(shotWorld), single.getLoss(ensembleWorld));
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, ENSEMBLE_MASS_PERTURBATIONS)
+{
+  const int steps = 10;
+  const int shotLength = 5;
+  std::vector<s_t> masses = {1.0, 1.5, 0.7};
+
+  TrajectoryLossFn loss = [](const TrajectoryRollout* rollout) {
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    return (poses.col(poses.cols() - 1) - goal).squaredNorm();
+  };
+
+  // The box's mass is being optimized, and every world perturbs it
+  std::vector<WorldPtr> worlds;
+  for (s_t mass : masses)
+  {
+    WorldPtr world = World::create();
+    world->setGravity(Eigen::Vector3s::Zero());
+    world->setTimeStep(1e-2);
+    SkeletonPtr box = Skeleton::create("box");
+    std::pair<TranslationalJoint2D*, BodyNode*> pair
+        = box->createJointAndBodyNodePair<TranslationalJoint2D>(nullptr);
+    pair.first->setXYPlane();
+    pair.second->setMass(mass);
+    world->addSkeleton(box);
+    world->getWrtMass()->registerNode(
+        pair.second,
+        neural::WrtMassBodyNodeEntryType::INERTIA_MASS,
+        Eigen::VectorXs::Ones(1) * 5.0,
+        Eigen::VectorXs::Ones(1) * 0.1);
+    worlds.push_back(world);
+  }
+  WorldPtr world = worlds[0];
+
+  MultiShotEnsemble ensemble(worlds, LossFn(loss), steps, shotLength);
+  Problem& problem = ensemble;
+  EXPECT_EQ(1, problem.getFlatStaticProblemDim(world));
+
+  int dim = problem.getFlatProblemDim(world);
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(dim);
+  problem.flatten(world, x);
+  EXPECT_EQ(masses[0], x(0));
+
+  // Moving the shared mass moves every member's, but keeps their offsets
+  x(0) = 2.0;
+  problem.unflatten(world, x);
+  for (int i = 0; i < masses.size(); i++)
+  {
+    EXPECT_NEAR(
+        2.0 + masses[i] - masses[0],
+        ensemble.getMemberWorld(i)->getMasses()(0),
+        1e-12);
+  }
+  Eigen::VectorXs flat = Eigen::VectorXs::Zero(dim);
+  problem.flatten(world, flat);
+  EXPECT_TRUE(equals(x, flat, 0));
+
+  // Every member's mass moves one for one with the shared one, so the
+  // gradients still line up
+  Eigen::VectorXs analyticalGrad = Eigen::VectorXs::Zero(dim);
+  problem.backpropGradient(world, analyticalGrad);
+  Eigen::VectorXs bruteForceGrad = Eigen::VectorXs::Zero(dim);
+  problem.finiteDifferenceGradient(world, bruteForceGrad);
+  EXPECT_TRUE(equals(analyticalGrad, bruteForceGrad, 1e-7));
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, ENSEMBLE_THREADED_LOSS_FN)
+{
+  const int steps = 10;
+  const int shotLength = 5;
+
+  TrajectoryLossFn loss = [](const TrajectoryRollout* rollout) {
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    Eigen::Vector2s goal = Eigen::Vector2s(2.0, 1.0);
+    return (poses.col(poses.cols() - 1) - goal).squaredNorm();
+  };
+
+  std::vector<WorldPtr> worlds;
+  for (s_t mass : {1.0, 1.5, 0.7})
+  {
+    WorldPtr world = World::create();
+    world->setGravity(Eigen::Vector3s::Zero());
+    world->setTimeStep(1e-2);
+    SkeletonPtr box = Skeleton::create("box");
+    std::pair<TranslationalJoint2D*, BodyNode*> pair
+        = box->createJointAndBodyNodePair<TranslationalJoint2D>(nullptr);
+    pair.first->setXYPlane();
+    pair.second->setMass(mass);
+    world->addSkeleton(box);
+    worlds.push_back(world);
+  }
+  WorldPtr world = worlds[0];
+
+  // Every member finite differences the loss through the same threaded LossFn
+  // at once, so they all go after its one thread pool together
+  LossFn threadedLoss(loss);
+  threadedLoss.setNumThreads(4);
+  MultiShotEnsemble ensemble(worlds, threadedLoss, steps, shotLength);
+  Problem& problem = ensemble;
+
+  int dim = problem.getFlatProblemDim(world);
+  srand(42);
+  Eigen::VectorXs x = Eigen::VectorXs::Random(dim) * 0.5;
+  problem.unflatten(world, x);
+  Eigen::VectorXs serialGrad = Eigen::VectorXs::Zero(dim);
+  problem.backpropGradient(world, serialGrad);
+
+  ensemble.setNumThreads(3);
+  for (int i = 0; i < 5; i++)
+  {
+    problem.unflatten(world, x);
+    Eigen::VectorXs parallelGrad = Eigen::VectorXs::Zero(dim);
+    problem.backpropGradient(world, parallelGrad);
+    EXPECT_TRUE(equals(serialGrad, parallelGrad, 0));
+  }
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(TRAJECTORY, ROLLOUT_ARENA)
+{
+  const int steps = 4;
+  std::unordered_map<std::string, Eigen::MatrixXs> pos;
+  std::unordered_map<std::string, Eigen::MatrixXs> vel;
+  std::unordered_map<std::string, Eigen::MatrixXs> force;
+  pos["b"] = Eigen::MatrixXs::Random(2, steps);
+  vel["b"] = Eigen::MatrixXs::Random(2, steps);
+  force["b"] = Eigen::MatrixXs::Random(1, steps);
+  pos["a"] = Eigen::MatrixXs::Random(3, steps);
+  vel["a"] = Eigen::MatrixXs::Random(3, steps);
+  force["a"] = Eigen::MatrixXs::Random(3, steps);
+  Eigen::VectorXs masses = Eigen::VectorXs::Random(2);
+  std::unordered_map<std::string, Eigen::MatrixXs> metadata;
+  TrajectoryRolloutReal rollout(pos, vel, force, masses, metadata);
+
+  // Mappings are laid out alphabetically, poses then vels then forces, with
+  // the masses at the end
+  Eigen::VectorXs expected = Eigen::VectorXs::Zero(9 * steps + 5 * steps + 2);
+  int cursor = 0;
+  for (std::string key : {"a", "b"})
+  {
+    for (Eigen::MatrixXs* m : {&pos[key], &vel[key], &force[key]})
+    {
+      expected.segment(cursor, m->size())
+          = Eigen::Map<Eigen::VectorXs>(m->data(), m->size());
+      cursor += m->size();
+    }
+  }
+  expected.tail(2) = masses;
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), rollout.getMappings());
+  EXPECT_TRUE(equals(expected, Eigen::VectorXs(rollout.getArenaConst()), 0));
+
+  // Copies are deep
+  TrajectoryRolloutReal copy(rollout);
+  EXPECT_TRUE(equals(rollout.getArenaConst(), copy.getArenaConst(), 0));
+  copy.getVels("b")(1, 2) += 1.0;
+  EXPECT_TRUE(equals(expected, Eigen::VectorXs(rollout.getArenaConst()), 0));
+  copy = rollout;
+  EXPECT_TRUE(equals(rollout.getArenaConst(), copy.getArenaConst(), 0));
+  TrajectoryRolloutReal fromBase(static_cast<const TrajectoryRollout*>(&copy));
+  EXPECT_TRUE(equals(rollout.getArenaConst(), fromBase.getArenaConst(), 0));
+
+  // Slices are views onto the arena
+  rollout.slice(1, 2).getPoses("a")(0, 0) = 7.0;
+  EXPECT_EQ(7.0, rollout.getArenaConst()(3));
+
+  // An adopted arena is read and written in place
+  WorldPtr world = World::create();
+  std::shared_ptr<Problem> shot = createSaturatingBoxShot(world);
+  int size = TrajectoryRolloutReal::getArenaSize(shot.get());
+  std::shared_ptr<Eigen::VectorXs> buffer
+      = std::make_shared<Eigen::VectorXs>(Eigen::VectorXs::Random(size));
+  Eigen::VectorXs original = *buffer;
+  TrajectoryRolloutReal adopted(shot.get(), buffer->data(), buffer);
+  EXPECT_EQ(size, adopted.getArenaConst().size());
+  EXPECT_EQ(buffer->data(), adopted.getArenaConst().data());
+  EXPECT_TRUE(equals(original, Eigen::VectorXs(adopted.getArenaConst()), 0));
+  adopted.getControlForces("identity")(0, 1) = 3.0;
+  EXPECT_EQ(
+      3.0,
+      (*buffer)(
+          adopted.getPosesConst().size() + adopted.getVelsConst().size()
+          + adopted.getControlForcesConst().rows()));
+  (*buffer)(0) = -2.0;
+  EXPECT_EQ(-2.0, adopted.getPosesConst("identity")(0, 0));
+
+  // Copying an adopted rollout gives it its own arena
+  TrajectoryRolloutReal detached(adopted);
+  EXPECT_NE(buffer->data(), detached.getArenaConst().data());
+  EXPECT_TRUE(equals(*buffer, Eigen::VectorXs(detached.getArenaConst()), 0));
+
+  // Assigning a rollout of the same size writes through to an adopted arena
+  detached.getPoses("identity")(0, 0) = 5.0;
+  adopted = detached;
+  EXPECT_EQ(buffer->data(), adopted.getArenaConst().data());
+  EXPECT_EQ(5.0, (*buffer)(0));
+
+  // Assigning a rollout of a different size detaches from it instead
+  Eigen::VectorXs beforeResize = *buffer;
+  adopted = rollout;
+  EXPECT_NE(buffer->data(), adopted.getArenaConst().data());
+  EXPECT_TRUE(equals(beforeResize, *buffer, 0));
+  EXPECT_TRUE(equals(rollout.getArenaConst(), adopted.getArenaConst(), 0));
+
+  // Moves hand the arena over, and leave nothing behind
+  const s_t* arena = detached.getArenaConst().data();
+  TrajectoryRolloutReal moved(std::move(detached));
+  EXPECT_EQ(arena, moved.getArenaConst().data());
+  EXPECT_EQ(0, detached.getArenaConst().size());
+  EXPECT_EQ(nullptr, detached.getArenaConst().data());
+  EXPECT_TRUE(detached.getMappings().empty());
+  adopted = std::move(moved);
+  EXPECT_EQ(arena, adopted.getArenaConst().data());
+  EXPECT_EQ(0, moved.getArenaConst().size());
+  EXPECT_EQ(5.0, adopted.getPosesConst("identity")(0, 0));
+}
+#endif
+
+#ifdef ALL_TESTS
+/// A loss that works on any scalar type, so it can be complex stepped
+template <typename Rollout>
+auto fallbackTestLoss(const Rollout* rollout)
+{
+  auto poses = rollout->getPosesConst("identity");
+  auto vels = rollout->getVelsConst("identity");
+  auto forces = rollout->getControlForcesConst("identity");
+  auto masses = rollout->getMassesConst();
+  return (poses.array() * vels.array()).sum()
+         + (forces.array() * forces.array()).sum()
+         + masses(0) * poses(0, 0) * poses(0, 0);
+}
+
+TEST(TRAJECTORY, LOSS_FN_GRADIENT_FALLBACKS)
+{
+  const int steps = 6;
+  std::unordered_map<std::string, Eigen::MatrixXs> pos;
+  std::unordered_map<std::string, Eigen::MatrixXs> vel;
+  std::unordered_map<std::string, Eigen::MatrixXs> force;
+  pos["identity"] = Eigen::MatrixXs::Random(3, steps);
+  vel["identity"] = Eigen::MatrixXs::Random(3, steps);
+  force["identity"] = Eigen::MatrixXs::Random(3, steps);
+  TrajectoryRolloutReal rollout(
+      pos,
+      vel,
+      force,
+      Eigen::VectorXs::Random(2),
+      std::unordered_map<std::string, Eigen::MatrixXs>());
+
+  TrajectoryLossFn loss = [](const TrajectoryRollout* rollout) {
+    return fallbackTestLoss(rollout);
+  };
+  TrajectoryLossFnAndGrad lossGrad = [](const TrajectoryRollout* rollout,
+                                        TrajectoryRollout* gradWrtRollout) {
+    const Eigen::Ref<const Eigen::MatrixXs> poses
+        = rollout->getPosesConst("identity");
+    s_t mass = rollout->getMassesConst()(0);
+    gradWrtRollout->getPoses("identity") = rollout->getVelsConst("identity");
+    gradWrtRollout->getPoses("identity")(0, 0) += 2 * mass * poses(0, 0);
+    gradWrtRollout->getVels("identity") = poses;
+    gradWrtRollout->getControlForces("identity")
+        = 2 * rollout->getControlForcesConst("identity");
+    gradWrtRollout->getMasses().setZero();
+    gradWrtRollout->getMasses()(0) = poses(0, 0) * poses(0, 0);
+    return fallbackTestLoss(rollout);
+  };
+  TrajectoryLossFnComplex complexLoss
+      = [](const TrajectoryRolloutComplex* rollout) {
+          return fallbackTestLoss(rollout);
+        };
+
+  TrajectoryRolloutReal analytical(rollout);
+  s_t expectedLoss
+      = LossFn(loss, lossGrad).getLossAndGradient(&rollout, &analytical);
+
+  // Finite differences, serially and across threads
+  LossFn finiteDifference(loss);
+  TrajectoryRolloutReal serial(rollout);
+  EXPECT_EQ(
+      expectedLoss, finiteDifference.getLossAndGradient(&rollout, &serial));
+  EXPECT_TRUE(equals(analytical.getArenaConst(), serial.getArenaConst(), 1e-7));
+
+  finiteDifference.setNumThreads(4);
+  LossFn finiteDifferenceCopy = finiteDifference;
+  EXPECT_EQ(4, finiteDifferenceCopy.getNumThreads());
+  TrajectoryRolloutReal threaded(rollout);
+  EXPECT_EQ(
+      expectedLoss,
+      finiteDifferenceCopy.getLossAndGradient(&rollout, &threaded));
+  EXPECT_TRUE(equals(serial.getArenaConst(), threaded.getArenaConst(), 0));
+
+  // Complex step, serially and across threads
+  LossFn complexStep;
+  complexStep.setComplexStepLoss(complexLoss);
+  EXPECT_NEAR(expectedLoss, complexStep.getLoss(&rollout), 1e-14);
+  TrajectoryRolloutReal complexSerial(rollout);
+  complexStep.getLossAndGradient(&rollout, &complexSerial);
+  EXPECT_TRUE(equals(
+      analytical.getArenaConst(), complexSerial.getArenaConst(), 1e-14));
+
+  complexStep.setNumThreads(3);
+  TrajectoryRolloutReal complexThreaded(rollout);
+  complexStep.getLossAndGradient(&rollout, &complexThreaded);
+  EXPECT_TRUE(equals(
+      complexSerial.getArenaConst(), complexThreaded.getArenaConst(), 0));
+}
+#endif
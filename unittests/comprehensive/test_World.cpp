@@ -378,3 +378,48 @@ TEST(World, SetNewConstraintSolver)
   EXPECT_TRUE(world->getConstraintSolver()->getSkeletons().size() == 1);
   EXPECT_TRUE(world->getConstraintSolver()->getConstraints().size() == 1);
 }
+
+//==============================================================================
+TEST(World, ParallelSkeletonUpdates)
+{
+  for (bool parallelVelocityAndPosition : {true, false})
+  {
+    WorldPtr serial = World::create();
+    serial->setParallelVelocityAndPositionUpdates(parallelVelocityAndPosition);
+    for (int i = 0; i < 10; i++)
+    {
+      SkeletonPtr robot = createThreeLinkRobot(
+          Eigen::Vector3s(1.0, 1.0, 1.0),
+          DOF_ROLL,
+          Eigen::Vector3s(1.0, 1.0, 1.0),
+          DOF_PITCH,
+          Eigen::Vector3s(1.0, 1.0, 1.0),
+          DOF_YAW,
+          false,
+          false);
+      robot->setPositions(Eigen::VectorXs::Random(robot->getNumDofs()));
+      serial->addSkeleton(robot);
+    }
+
+    WorldPtr parallel = serial->clone();
+    parallel->setNumStepThreads(3);
+    EXPECT_EQ(parallel->getNumStepThreads(), 3u);
+
+    for (int t = 0; t < 200; t++)
+    {
+      Eigen::VectorXs forces = Eigen::VectorXs::Random(serial->getNumDofs());
+      serial->setControlForces(forces);
+      parallel->setControlForces(forces);
+      serial->step();
+      parallel->step();
+    }
+
+    // Each skeleton is updated independently, so the results have to be
+    // bitwise identical to the serial path
+    EXPECT_TRUE(equals(serial->getPositions(), parallel->getPositions(), 0));
+    EXPECT_TRUE(equals(serial->getVelocities(), parallel->getVelocities(), 0));
+
+    parallel->setNumStepThreads(1);
+    EXPECT_EQ(parallel->getNumStepThreads(), 1u);
+  }
+}
@@ -35,4 +35,112 @@ TEST(ACCEL_SMOOTHER, BASIC)
   smoother.debugTimeSeries(smoothed.row(0));
 
   EXPECT_EQ(smoothed.cols(), timesteps - 3);
-}
\ No newline at end of file
+}
+
+TEST(ACCEL_SMOOTHER, BANDED_MATCHES_DENSE)
+{
+  int dofs = 3;
+  int timesteps = 50;
+  s_t alpha = 0.3;
+  Eigen::MatrixXs data = Eigen::MatrixXs::Random(dofs, timesteps);
+
+  AccelerationSmoother smoother(timesteps, alpha);
+  Eigen::MatrixXs smoothed = smoother.smooth(data);
+
+  // Reference solution with the dense system
+  Eigen::Matrix4s stamp;
+  // clang-format off
+  stamp <<  1, -3,  3, -1,
+           -3,  9, -9,  3,
+            3, -9,  9, -3,
+           -1,  3, -3,  1;
+  // clang-format on
+  stamp *= alpha;
+  Eigen::MatrixXs B = Eigen::MatrixXs::Identity(timesteps, timesteps);
+  for (int i = 0; i < timesteps - 3; i++)
+  {
+    B.block<4, 4>(i, i) += stamp;
+  }
+  Eigen::MatrixXs expected = Eigen::MatrixXs::Zero(dofs, timesteps - 3);
+  for (int row = 0; row < dofs; row++)
+  {
+    Eigen::VectorXs c = Eigen::VectorXs::Zero(timesteps);
+    for (int i = 0; i < timesteps - 3; i++)
+    {
+      c.segment<4>(i) += 2 * stamp * data.block<1, 4>(row, i).transpose();
+    }
+    Eigen::VectorXs deltas = B.householderQr().solve(c);
+    expected.row(row) = data.block(row, 0, 1, timesteps - 3)
+                        - deltas.head(timesteps - 3).transpose();
+  }
+
+  EXPECT_TRUE(equals(smoothed, expected, 1e-10));
+}
+
+TEST(ACCEL_SMOOTHER, WINDOWED_MATCHES_FULL)
+{
+  int dofs = 2;
+  int timesteps = 1000;
+  Eigen::MatrixXs data = Eigen::MatrixXs::Random(dofs, timesteps);
+
+  AccelerationSmoother full(timesteps, 0.05);
+  Eigen::MatrixXs expected = full.smooth(data);
+
+  AccelerationSmoother windowed(120, 0.05);
+  Eigen::MatrixXs smoothed = windowed.smoothWindowed(data, 30);
+
+  EXPECT_EQ(smoothed.cols(), timesteps - 3);
+  EXPECT_TRUE(equals(smoothed, expected, 1e-8));
+}
+
+TEST(ACCEL_SMOOTHER, STREAMING_MATCHES_WINDOWED)
+{
+  int dofs = 2;
+  int window = 120;
+  int overlap = 30;
+  AccelerationSmoother smoother(window, 0.05);
+
+  // Try a stream that ends exactly at the end of a window, as well as ones
+  // that don't
+  for (int timesteps : {1000, window, window + 1, 2 * window - 2 * overlap})
+  {
+    Eigen::MatrixXs data = Eigen::MatrixXs::Random(dofs, timesteps);
+    Eigen::MatrixXs expected = smoother.smoothWindowed(data, overlap);
+
+    Eigen::MatrixXs smoothed = Eigen::MatrixXs::Zero(dofs, timesteps - 3);
+    int popped = 0;
+    smoother.startStream(overlap);
+    for (int i = 0; i < timesteps; i++)
+    {
+      smoother.pushFrame(data.col(i));
+      // Frames come out at most a window behind the ones going in
+      EXPECT_GE(popped + smoother.getNumSmoothedFrames(), i + 1 - window);
+      while (smoother.getNumSmoothedFrames() > 0)
+      {
+        smoothed.col(popped++) = smoother.popSmoothedFrame();
+      }
+    }
+    smoother.finishStream();
+    while (smoother.getNumSmoothedFrames() > 0)
+    {
+      smoothed.col(popped++) = smoother.popSmoothedFrame();
+    }
+
+    EXPECT_EQ(popped, timesteps - 3);
+    EXPECT_TRUE(equals(smoothed, expected, 1e-12));
+  }
+}
+
+TEST(ACCEL_SMOOTHER, LONG_SERIES)
+{
+  // The dense formulation would need a 100k x 100k matrix here
+  int dofs = 3;
+  int timesteps = 100000;
+  Eigen::MatrixXs data = Eigen::MatrixXs::Random(dofs, timesteps);
+
+  AccelerationSmoother smoother(timesteps, 0.05);
+  Eigen::MatrixXs smoothed = smoother.smooth(data);
+
+  EXPECT_EQ(smoothed.cols(), timesteps - 3);
+  EXPECT_TRUE(smoothed.allFinite());
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "dart/constraint/BlockPivotingBoxedLcpSolver.hpp"
+#include "dart/constraint/LCPUtils.hpp"
+#include "dart/external/odelcpsolver/lcp.h"
+
+using namespace dart;
+using namespace dart::constraint;
+
+typedef Eigen::Matrix<s_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    PaddedMatrix;
+
+struct ContactLCP
+{
+  Eigen::MatrixXs A;
+  Eigen::VectorXs b;
+  Eigen::VectorXs hi;
+  Eigen::VectorXs lo;
+  Eigen::VectorXi fIndex;
+};
+
+/// This builds an LCP that looks like it came from `numContacts` frictional
+/// contacts, each of which has one normal and two friction directions.
+ContactLCP createContactLCP(int numContacts)
+{
+  const int n = numContacts * 3;
+  Eigen::MatrixXs J = Eigen::MatrixXs::Random(n, n + 6);
+  ContactLCP lcp;
+  lcp.A = J * J.transpose() + Eigen::MatrixXs::Identity(n, n) * 0.1;
+  lcp.b = Eigen::VectorXs::Random(n);
+  lcp.hi = Eigen::VectorXs::Zero(n);
+  lcp.lo = Eigen::VectorXs::Zero(n);
+  lcp.fIndex = Eigen::VectorXi::Constant(n, -1);
+  for (int i = 0; i < numContacts; i++)
+  {
+    // Normals push, mostly
+    lcp.b(i * 3) = abs(lcp.b(i * 3)) + 0.1;
+    lcp.hi(i * 3) = std::numeric_limits<s_t>::infinity();
+    for (int j = 1; j < 3; j++)
+    {
+      lcp.hi(i * 3 + j) = 0.5;
+      lcp.lo(i * 3 + j) = -0.5;
+      lcp.fIndex(i * 3 + j) = i * 3;
+    }
+  }
+  return lcp;
+}
+
+/// This runs a solver on a copy of the LCP, so the solver can't scribble on
+/// the original, and returns whether it succeeded.
+bool solveCopy(
+    BoxedLcpSolver& solver,
+    const ContactLCP& lcp,
+    Eigen::VectorXs& x,
+    int nub = 0)
+{
+  const int n = lcp.b.size();
+  PaddedMatrix A = PaddedMatrix::Zero(n, dPAD(n));
+  A.block(0, 0, n, n) = lcp.A;
+  Eigen::VectorXs b = lcp.b;
+  Eigen::VectorXs hi = lcp.hi;
+  Eigen::VectorXs lo = lcp.lo;
+  Eigen::VectorXi fIndex = lcp.fIndex;
+  return solver.solve(
+      n,
+      A.data(),
+      x.data(),
+      b.data(),
+      nub,
+      lo.data(),
+      hi.data(),
+      fIndex.data(),
+      false);
+}
+
+//==============================================================================
+TEST(BLOCK_PIVOTING_LCP, WARM_START_FROM_SOLUTION)
+{
+  srand(42);
+  ContactLCP lcp = createContactLCP(4);
+  const int n = lcp.b.size();
+
+  // With a generous pivot budget, we can pivot all the way from a cold start
+  BlockPivotingBoxedLcpSolver solver;
+  solver.setOption(BlockPivotingBoxedLcpSolver::Option(100));
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  EXPECT_TRUE(solveCopy(solver, lcp, x));
+  EXPECT_FALSE(solver.getLastUsedFallback());
+  EXPECT_TRUE(solver.getLastNumPivots() > 0);
+  EXPECT_TRUE(LCPUtils::isLCPSolutionValid(
+      lcp.A, x, lcp.b, lcp.hi, lcp.lo, lcp.fIndex, false));
+
+  // Re-solving from the previous solution should take no pivots at all
+  Eigen::VectorXs warmX = x;
+  EXPECT_TRUE(solveCopy(solver, lcp, warmX));
+  EXPECT_FALSE(solver.getLastUsedFallback());
+  EXPECT_EQ(solver.getLastNumPivots(), 0);
+  EXPECT_TRUE((warmX - x).norm() < 1e-8);
+}
+
+//==============================================================================
+TEST(BLOCK_PIVOTING_LCP, ONE_CONTACT_BREAKS)
+{
+  srand(42);
+  // Frictionless, so that every contact is independent of the others' bounds
+  const int n = 6;
+  Eigen::MatrixXs J = Eigen::MatrixXs::Random(n, n + 6);
+  ContactLCP lcp;
+  lcp.A = J * J.transpose() + Eigen::MatrixXs::Identity(n, n) * 0.1;
+  lcp.hi = Eigen::VectorXs::Constant(n, std::numeric_limits<s_t>::infinity());
+  lcp.lo = Eigen::VectorXs::Zero(n);
+  lcp.fIndex = Eigen::VectorXi::Constant(n, -1);
+  // Choose a solution where every contact is active
+  Eigen::VectorXs solution = Eigen::VectorXs::Random(n).cwiseAbs()
+                             + Eigen::VectorXs::Constant(n, 0.1);
+  lcp.b = lcp.A * solution;
+
+  BlockPivotingBoxedLcpSolver solver;
+  Eigen::VectorXs x = solution;
+  EXPECT_TRUE(solveCopy(solver, lcp, x));
+  EXPECT_EQ(solver.getLastNumPivots(), 0);
+
+  // Now pull the last contact apart, so that the old guess is wrong about
+  // exactly one index
+  lcp.b(n - 1) = -100.0;
+  EXPECT_TRUE(solveCopy(solver, lcp, x));
+  EXPECT_FALSE(solver.getLastUsedFallback());
+  EXPECT_EQ(solver.getLastNumPivots(), 1);
+  EXPECT_TRUE(LCPUtils::isLCPSolutionValid(
+      lcp.A, x, lcp.b, lcp.hi, lcp.lo, lcp.fIndex, false));
+  EXPECT_EQ(x(n - 1), 0.0);
+}
+
+//==============================================================================
+TEST(BLOCK_PIVOTING_LCP, COLD_START_FALLS_BACK)
+{
+  srand(42);
+  const int n = 20;
+  Eigen::MatrixXs J = Eigen::MatrixXs::Random(n, n + 6);
+  ContactLCP lcp;
+  lcp.A = J * J.transpose() + Eigen::MatrixXs::Identity(n, n) * 0.1;
+  lcp.b = Eigen::VectorXs::Random(n);
+  lcp.hi = Eigen::VectorXs::Constant(n, std::numeric_limits<s_t>::infinity());
+  lcp.lo = Eigen::VectorXs::Zero(n);
+  lcp.fIndex = Eigen::VectorXi::Constant(n, -1);
+
+  // Even with a terrible guess and a tiny pivot budget, we should still get a
+  // valid solution out, by falling back to Dantzig
+  BlockPivotingBoxedLcpSolver solver;
+  solver.setOption(BlockPivotingBoxedLcpSolver::Option(1));
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  EXPECT_TRUE(solveCopy(solver, lcp, x));
+  EXPECT_TRUE(solver.getLastUsedFallback());
+  EXPECT_TRUE(LCPUtils::isLCPSolutionValid(
+      lcp.A, x, lcp.b, lcp.hi, lcp.lo, lcp.fIndex, false));
+}
+
+//==============================================================================
+TEST(BLOCK_PIVOTING_LCP, UNBOUNDED_PREFIX)
+{
+  srand(42);
+  const int n = 8;
+  const int nub = 3;
+  Eigen::MatrixXs J = Eigen::MatrixXs::Random(n, n + 6);
+  ContactLCP lcp;
+  lcp.A = J * J.transpose() + Eigen::MatrixXs::Identity(n, n) * 0.1;
+  lcp.b = Eigen::VectorXs::Random(n);
+  lcp.hi = Eigen::VectorXs::Constant(n, std::numeric_limits<s_t>::infinity());
+  lcp.lo = Eigen::VectorXs::Zero(n);
+  lcp.fIndex = Eigen::VectorXi::Constant(n, -1);
+  // Make sure the unbounded indices want to go negative, so the bounds in lo
+  // would matter if we didn't ignore them
+  lcp.b.head(nub) = -Eigen::VectorXs::Ones(nub) - lcp.b.head(nub).cwiseAbs();
+
+  BlockPivotingBoxedLcpSolver solver;
+  solver.setOption(BlockPivotingBoxedLcpSolver::Option(100));
+  Eigen::VectorXs x = Eigen::VectorXs::Zero(n);
+  EXPECT_TRUE(solveCopy(solver, lcp, x, nub));
+  EXPECT_FALSE(solver.getLastUsedFallback());
+
+  // Dantzig only knows an index is unbounded from its limits
+  ContactLCP unboundedLcp = lcp;
+  unboundedLcp.lo.head(nub).setConstant(
+      -std::numeric_limits<s_t>::infinity());
+  Eigen::VectorXs dantzigX = Eigen::VectorXs::Zero(n);
+  DantzigBoxedLcpSolver dantzig;
+  EXPECT_TRUE(solveCopy(dantzig, unboundedLcp, dantzigX));
+  EXPECT_TRUE((x - dantzigX).norm() < 1e-8);
+
+  // Running out of pivots falls back to Dantzig, which has to get the same
+  // answer
+  solver.setOption(BlockPivotingBoxedLcpSolver::Option(1));
+  x.setZero();
+  EXPECT_TRUE(solveCopy(solver, lcp, x, nub));
+  EXPECT_TRUE(solver.getLastUsedFallback());
+  EXPECT_TRUE((x - dantzigX).norm() < 1e-8);
+
+  // The unbounded rows are solved as equalities
+  Eigen::VectorXs w = lcp.A * x - lcp.b;
+  EXPECT_TRUE(w.head(nub).norm() < 1e-8);
+  EXPECT_TRUE((x.head(nub).array() < 0).any());
+}
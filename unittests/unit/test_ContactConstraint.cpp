@@ -109,3 +109,193 @@ TEST(ContactConstraint, ContactWithKinematicJoint)
       std::make_shared<constraint::PgsBoxedLcpSolver>(), 1e-4);
 #endif
 }
+
+//==============================================================================
+/// Creates a world with `numBoxes` boxes resting on the ground. Past the
+/// first, each box is stacked slightly staggered on the one below, so it
+/// touches two others.
+simulation::WorldPtr createRestingBoxWorld(
+    int numBoxes = 1, bool jacobianAssembly = false, int numThreads = 1)
+{
+  auto world = std::make_shared<simulation::World>();
+  world->setGravity(Eigen::Vector3s(0, 0, -9.81));
+  if (jacobianAssembly)
+  {
+    auto solver = static_cast<constraint::BoxedLcpConstraintSolver*>(
+        world->getConstraintSolver());
+    solver->setJacobianAssemblyEnabled(true);
+    solver->setNumAssemblyThreads(numThreads);
+  }
+
+  auto ground = dynamics::Skeleton::create("ground");
+  auto groundPair = ground->createJointAndBodyNodePair<dynamics::WeldJoint>();
+  auto groundShape
+      = std::make_shared<dynamics::BoxShape>(Eigen::Vector3s(4.0, 4.0, 1.0));
+  groundPair.second
+      ->createShapeNodeWith<VisualAspect, CollisionAspect, DynamicsAspect>(
+          groundShape);
+  world->addSkeleton(ground);
+
+  for (int i = 0; i < numBoxes; ++i)
+  {
+    auto box = dynamics::Skeleton::create(
+        i == 0 ? std::string("box") : "box" + std::to_string(i));
+    auto boxPair = box->createJointAndBodyNodePair<dynamics::FreeJoint>();
+    auto boxShape
+        = std::make_shared<dynamics::BoxShape>(Eigen::Vector3s(0.5, 0.5, 0.5));
+    boxPair.second
+        ->createShapeNodeWith<VisualAspect, CollisionAspect, DynamicsAspect>(
+            boxShape);
+    // Start just barely interpenetrating whatever is below, so it rests there
+    box->setPosition(3, 0.05 * i);
+    box->setPosition(5, 0.749 + 0.499 * i);
+    world->addSkeleton(box);
+  }
+
+  return world;
+}
+
+//==============================================================================
+TEST(ContactConstraint, ContactCoherence)
+{
+  auto world = createRestingBoxWorld();
+  auto coherentWorld = createRestingBoxWorld();
+  coherentWorld->getConstraintSolver()->setContactCoherenceEnabled(true);
+
+  for (auto i = 0u; i < 100; ++i)
+  {
+    world->step();
+    coherentWorld->step();
+
+    // Reusing constraints must not change the simulation at all
+    EXPECT_TRUE(world->getPositions() == coherentWorld->getPositions());
+    EXPECT_TRUE(world->getVelocities() == coherentWorld->getVelocities());
+  }
+
+  const constraint::ContactCoherenceStats& stats
+      = coherentWorld->getConstraintSolver()->getContactCoherenceStats();
+  EXPECT_EQ(stats.numSteps, 100u);
+  EXPECT_GT(stats.numPersistentContacts, 0u);
+  EXPECT_GT(stats.numReusedConstrainedGroups, 0u);
+  // A box resting on the ground should keep the same contacts almost every
+  // step
+  EXPECT_GT(
+      stats.numPersistentContacts,
+      4 * (stats.numNewContacts + stats.numRemovedContacts));
+
+  coherentWorld->getConstraintSolver()->resetContactCoherenceStats();
+  EXPECT_EQ(
+      coherentWorld->getConstraintSolver()->getContactCoherenceStats().numSteps,
+      0u);
+}
+
+//==============================================================================
+/// Returns the block pivoting solver of a world with warm started LCPs enabled
+std::shared_ptr<const constraint::BlockPivotingBoxedLcpSolver>
+getBlockPivotingSolver(const simulation::WorldPtr& world)
+{
+  auto solver = static_cast<constraint::BoxedLcpConstraintSolver*>(
+      world->getConstraintSolver());
+  EXPECT_EQ(
+      solver->getBoxedLcpSolver()->getType(),
+      constraint::BlockPivotingBoxedLcpSolver::getStaticType());
+  return std::static_pointer_cast<
+      const constraint::BlockPivotingBoxedLcpSolver>(
+      solver->getBoxedLcpSolver());
+}
+
+//==============================================================================
+TEST(ContactConstraint, WarmStartedLcp)
+{
+  auto world = createRestingBoxWorld();
+  auto warmWorld = createRestingBoxWorld();
+  EXPECT_FALSE(warmWorld->getWarmStartedLcpEnabled());
+  warmWorld->setWarmStartedLcpEnabled(true);
+  EXPECT_TRUE(warmWorld->getWarmStartedLcpEnabled());
+  EXPECT_TRUE(warmWorld->clone()->getWarmStartedLcpEnabled());
+  auto boxLcpSolver = getBlockPivotingSolver(warmWorld);
+
+  for (auto i = 0u; i < 50; ++i)
+  {
+    world->step();
+    warmWorld->step();
+
+    // Both solvers find the same solution for a resting box. The four corners
+    // of a box face over-constrain it, but the redundant rows shouldn't send
+    // us to the Dantzig fallback.
+    EXPECT_TRUE(
+        equals(world->getPositions(), warmWorld->getPositions(), 1e-8));
+    EXPECT_TRUE(
+        equals(world->getVelocities(), warmWorld->getVelocities(), 1e-8));
+    EXPECT_FALSE(boxLcpSolver->getLastUsedFallback());
+  }
+
+  warmWorld->setWarmStartedLcpEnabled(false);
+  EXPECT_FALSE(warmWorld->getWarmStartedLcpEnabled());
+
+  // A stack of boxes needs more pivots than we allow while it settles, but
+  // once it has, every step should be solved from the previous one
+  auto stackWorld = createRestingBoxWorld(3);
+  stackWorld->setWarmStartedLcpEnabled(true);
+  auto stackLcpSolver = getBlockPivotingSolver(stackWorld);
+  for (auto i = 0u; i < 10; ++i)
+    stackWorld->step();
+  for (auto i = 0u; i < 50; ++i)
+  {
+    stackWorld->step();
+    EXPECT_FALSE(stackLcpSolver->getLastUsedFallback());
+  }
+
+  // Once a sphere settles the previous step's solution is already right
+  auto sphereWorld = std::make_shared<simulation::World>();
+  sphereWorld->setGravity(Eigen::Vector3s(0, 0, -9.81));
+  sphereWorld->addSkeleton(world->getSkeleton("ground")->cloneSkeleton());
+  auto sphere = dynamics::Skeleton::create("sphere");
+  auto spherePair = sphere->createJointAndBodyNodePair<dynamics::FreeJoint>();
+  spherePair.second
+      ->createShapeNodeWith<VisualAspect, CollisionAspect, DynamicsAspect>(
+          std::make_shared<dynamics::SphereShape>(0.25));
+  sphere->setPosition(5, 0.749);
+  sphereWorld->addSkeleton(sphere);
+  sphereWorld->setWarmStartedLcpEnabled(true);
+  auto lcpSolver = getBlockPivotingSolver(sphereWorld);
+
+  for (auto i = 0u; i < 50; ++i)
+    sphereWorld->step();
+
+  EXPECT_GT(sphereWorld->getLastCollisionResult().getNumContacts(), 0u);
+  EXPECT_EQ(lcpSolver->getLastNumPivots(), 0);
+  EXPECT_FALSE(lcpSolver->getLastUsedFallback());
+}
+
+//==============================================================================
+TEST(ContactConstraint, JacobianAssembly)
+{
+  auto world = createRestingBoxWorld(4);
+  auto jacobianWorld = createRestingBoxWorld(4, true, 1);
+  auto threadedWorld = createRestingBoxWorld(4, true, 4);
+  for (auto w : {world, jacobianWorld, threadedWorld})
+    w->getConstraintSolver()->setGradientEnabled(true);
+
+  for (auto i = 0u; i < 50; ++i)
+  {
+    world->step();
+    jacobianWorld->step();
+    threadedWorld->step();
+
+    // J * M^{-1} * J^T matches the impulse tests up to round-off
+    EXPECT_TRUE(
+        equals(world->getPositions(), jacobianWorld->getPositions(), 1e-8));
+    EXPECT_TRUE(
+        equals(world->getVelocities(), jacobianWorld->getVelocities(), 1e-8));
+
+    // The number of threads doesn't change the result at all
+    EXPECT_TRUE(
+        jacobianWorld->getPositions() == threadedWorld->getPositions());
+    EXPECT_TRUE(
+        jacobianWorld->getVelocities() == threadedWorld->getVelocities());
+  }
+
+  // Make sure the stack actually came into contact
+  EXPECT_GT(jacobianWorld->getLastCollisionResult().getNumContacts(), 0u);
+}
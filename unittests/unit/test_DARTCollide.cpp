@@ -9,6 +9,8 @@
 
 #include "dart/collision/CollisionResult.hpp"
 #include "dart/collision/dart/DARTCollide.hpp"
+#include "dart/collision/dart/DARTCollisionDetector.hpp"
+#include "dart/collision/dart/DARTContactManifold.hpp"
 #include "dart/neural/RestorableSnapshot.hpp"
 #include "dart/realtime/Ticker.hpp"
 #include "dart/server/GUIWebsocketServer.hpp"
@@ -4189,6 +4191,325 @@ TEST(DARTCollide, CAPSULE_CCD_SUPPORT_FN)
 }
 #endif
 
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, SPHERE_PLANE_COLLISION)
+{
+  Eigen::Isometry3s planeT = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s sphereT = Eigen::Isometry3s::Identity();
+  sphereT.translation() = Eigen::Vector3s(0.3, -0.2, 1.49);
+
+  CollisionOption option;
+  CollisionResult result;
+  collideSpherePlane(
+      nullptr,
+      nullptr,
+      0.5,
+      sphereT,
+      Eigen::Vector3s::UnitZ(),
+      1.0,
+      planeT,
+      option,
+      result);
+
+  EXPECT_EQ(result.getNumContacts(), 1);
+  Contact& contact = result.getContact(0);
+  EXPECT_EQ(contact.type, ContactType::SPHERE_FACE);
+  EXPECT_TRUE(equals(contact.normal, Eigen::Vector3s::UnitZ().eval()));
+  EXPECT_TRUE(equals(contact.point, Eigen::Vector3s(0.3, -0.2, 0.99)));
+  EXPECT_TRUE(equals(contact.sphereCenter, sphereT.translation()));
+  EXPECT_NEAR(static_cast<double>(contact.penetrationDepth), 0.01, 1e-12);
+
+  // Swapping the objects flips the normal and the contact type
+  result.clear();
+  collidePlaneSphere(
+      nullptr,
+      nullptr,
+      Eigen::Vector3s::UnitZ(),
+      1.0,
+      planeT,
+      0.5,
+      sphereT,
+      option,
+      result);
+  EXPECT_EQ(result.getNumContacts(), 1);
+  EXPECT_EQ(result.getContact(0).type, ContactType::FACE_SPHERE);
+  EXPECT_TRUE(
+      equals(result.getContact(0).normal, (-Eigen::Vector3s::UnitZ()).eval()));
+
+  // Out of contact
+  result.clear();
+  sphereT.translation()(2) = 1.51;
+  collideSpherePlane(
+      nullptr,
+      nullptr,
+      0.5,
+      sphereT,
+      Eigen::Vector3s::UnitZ(),
+      1.0,
+      planeT,
+      option,
+      result);
+  EXPECT_EQ(result.getNumContacts(), 0);
+}
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, BOX_PLANE_COLLISION)
+{
+  Eigen::Isometry3s planeT = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  boxT.translation() = Eigen::Vector3s(0.0, 0.0, 0.49);
+
+  CollisionOption option;
+  CollisionResult result;
+  collideBoxPlane(
+      nullptr,
+      nullptr,
+      Eigen::Vector3s::Ones(),
+      boxT,
+      Eigen::Vector3s::UnitZ(),
+      0.0,
+      planeT,
+      option,
+      result);
+
+  // One vertex-face contact for each of the bottom corners
+  EXPECT_EQ(result.getNumContacts(), 4);
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    Contact& contact = result.getContact(i);
+    EXPECT_EQ(contact.type, ContactType::VERTEX_FACE);
+    EXPECT_TRUE(equals(contact.normal, Eigen::Vector3s::UnitZ().eval()));
+    EXPECT_NEAR(static_cast<double>(contact.point(2)), -0.01, 1e-12);
+  }
+}
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, SPHERE_HEIGHTMAP_FEATURES)
+{
+  HeightmapField<s_t> heights = HeightmapField<s_t>::Zero(5, 5);
+  Eigen::Vector3s scale = Eigen::Vector3s::Ones();
+  Eigen::Isometry3s terrainT = Eigen::Isometry3s::Identity();
+  Eigen::Isometry3s sphereT = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  CollisionResult result;
+
+  // Resting on the middle of a flat triangle only gives a face contact, and
+  // no extra contacts with the neighboring triangles
+  sphereT.translation() = Eigen::Vector3s(0.3, 0.2, 0.49);
+  collideSphereHeightmap(
+      nullptr, nullptr, 0.5, sphereT, heights, scale, terrainT, option, result);
+  EXPECT_EQ(result.getNumContacts(), 1);
+  EXPECT_EQ(result.getContact(0).type, ContactType::SPHERE_FACE);
+  EXPECT_TRUE(
+      equals(result.getContact(0).normal, Eigen::Vector3s::UnitZ().eval()));
+  EXPECT_TRUE(
+      equals(result.getContact(0).point, Eigen::Vector3s(0.3, 0.2, -0.01)));
+
+  // Resting on a single raised vertex gives a vertex contact
+  heights(2, 2) = 1.0;
+  result.clear();
+  sphereT.translation() = Eigen::Vector3s(0.0, 0.0, 1.49);
+  collideSphereHeightmap(
+      nullptr, nullptr, 0.5, sphereT, heights, scale, terrainT, option, result);
+  EXPECT_EQ(result.getNumContacts(), 1);
+  EXPECT_EQ(result.getContact(0).type, ContactType::SPHERE_VERTEX);
+  EXPECT_TRUE(
+      equals(result.getContact(0).point, Eigen::Vector3s(0.0, 0.0, 1.0)));
+
+  // Resting on a ridge gives an edge contact
+  heights.setZero();
+  heights.col(2).setConstant(1.0);
+  result.clear();
+  sphereT.translation() = Eigen::Vector3s(0.0, 0.3, 1.49);
+  collideSphereHeightmap(
+      nullptr, nullptr, 0.5, sphereT, heights, scale, terrainT, option, result);
+  EXPECT_EQ(result.getNumContacts(), 1);
+  EXPECT_EQ(result.getContact(0).type, ContactType::SPHERE_EDGE);
+  EXPECT_TRUE(
+      equals(result.getContact(0).point, Eigen::Vector3s(0.0, 0.3, 1.0)));
+
+  // Swapping the objects swaps the types
+  result.clear();
+  collideHeightmapSphere(
+      nullptr, nullptr, heights, scale, terrainT, 0.5, sphereT, option, result);
+  EXPECT_EQ(result.getNumContacts(), 1);
+  EXPECT_EQ(result.getContact(0).type, ContactType::EDGE_SPHERE);
+
+  // Far away from the terrain, there's nothing
+  result.clear();
+  sphereT.translation() = Eigen::Vector3s(10.0, 0.0, 0.49);
+  collideSphereHeightmap(
+      nullptr, nullptr, 0.5, sphereT, heights, scale, terrainT, option, result);
+  EXPECT_EQ(result.getNumContacts(), 0);
+}
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, BOX_AND_CAPSULE_HEIGHTMAP_COLLISION)
+{
+  HeightmapField<float> heights = HeightmapField<float>::Zero(11, 11);
+  Eigen::Vector3f scale(0.5, 0.5, 1.0);
+  Eigen::Isometry3s terrainT = Eigen::Isometry3s::Identity();
+  CollisionOption option;
+  CollisionResult result;
+
+  // A box resting on flat terrain touches it with its four bottom corners,
+  // and the terrain vertices that poke into its bottom face
+  Eigen::Isometry3s boxT = Eigen::Isometry3s::Identity();
+  boxT.translation() = Eigen::Vector3s(0.1, 0.1, 0.49);
+  collideBoxHeightmap(
+      nullptr,
+      nullptr,
+      Eigen::Vector3s::Ones(),
+      boxT,
+      heights,
+      scale,
+      terrainT,
+      option,
+      result);
+  int numVertexFace = 0;
+  int numFaceVertex = 0;
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    Contact& contact = result.getContact(i);
+    EXPECT_TRUE(equals(contact.normal, Eigen::Vector3s::UnitZ().eval()));
+    if (contact.type == ContactType::VERTEX_FACE)
+      numVertexFace++;
+    if (contact.type == ContactType::FACE_VERTEX)
+      numFaceVertex++;
+  }
+  EXPECT_EQ(numVertexFace, 4);
+  EXPECT_EQ(numFaceVertex, 4);
+
+  // A capsule lying flat touches with both end spheres
+  result.clear();
+  Eigen::Isometry3s capsuleT = Eigen::Isometry3s::Identity();
+  capsuleT.linear() = Eigen::AngleAxis_s(0.5 * M_PI, Eigen::Vector3s::UnitY())
+                          .toRotationMatrix();
+  capsuleT.translation() = Eigen::Vector3s(0.1, 0.1, 0.19);
+  collideCapsuleHeightmap(
+      nullptr,
+      nullptr,
+      1.0,
+      0.2,
+      capsuleT,
+      heights,
+      scale,
+      terrainT,
+      option,
+      result);
+  EXPECT_EQ(result.getNumContacts(), 2);
+  for (int i = 0; i < result.getNumContacts(); i++)
+  {
+    EXPECT_EQ(result.getContact(i).type, ContactType::SPHERE_FACE);
+    EXPECT_TRUE(equals(
+        result.getContact(i).normal, Eigen::Vector3s::UnitZ().eval()));
+  }
+}
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, CONTACT_MANIFOLD_REDUCTION)
+{
+  // A 5x5 grid of contacts, like a box resting on a face
+  std::vector<Contact> contacts;
+  for (int i = 0; i < 5; i++)
+  {
+    for (int j = 0; j < 5; j++)
+    {
+      Contact contact;
+      contact.point = Eigen::Vector3s(i * 0.1, j * 0.1, 0.0);
+      contact.normal = Eigen::Vector3s::UnitZ();
+      contact.penetrationDepth = 0.01;
+      contact.type = ContactType::VERTEX_FACE;
+      contacts.push_back(contact);
+    }
+  }
+
+  // Nothing to reduce
+  EXPECT_EQ(reduceContactManifold(contacts, 100).size(), contacts.size());
+
+  // Reducing to 4 keeps the corners, in their original order
+  std::vector<std::size_t> kept = reduceContactManifold(contacts, 4);
+  std::vector<std::size_t> corners = {0, 4, 20, 24};
+  EXPECT_EQ(kept, corners);
+
+  // The deepest contact always survives
+  contacts[12].penetrationDepth = 0.02;
+  kept = reduceContactManifold(contacts, 4);
+  EXPECT_EQ(kept.size(), 4u);
+  EXPECT_TRUE(std::find(kept.begin(), kept.end(), 12) != kept.end());
+  contacts[12].penetrationDepth = 0.01;
+
+  // Nudge the contacts next to the corners slightly outwards, so they cover a
+  // tiny bit more area than the corners. Without any history they win, but
+  // once the corners have been kept they stick.
+  contacts[1].point(1) = -0.001;
+  contacts[5].point(0) = -0.001;
+  contacts[19].point(0) = 0.401;
+  contacts[23].point(1) = 0.401;
+  std::vector<Eigen::Vector3s> lastPoints;
+  for (std::size_t index : corners)
+    lastPoints.push_back(contacts[index].point);
+  kept = reduceContactManifold(contacts, 4, lastPoints);
+  EXPECT_EQ(kept, corners);
+  kept = reduceContactManifold(contacts, 4);
+  EXPECT_NE(kept, corners);
+}
+#endif
+
+//==============================================================================
+#ifdef ALL_TESTS
+TEST(DARTCollide, MAX_CONTACTS_PER_PAIR_THROUGH_DETECTOR)
+{
+  auto cd = DARTCollisionDetector::create();
+
+  // A box resting on another, twisted 45 degrees so the faces overlap in an
+  // octagon, which gives more than 4 contacts
+  auto bottom = SimpleFrame::createShared(Frame::World());
+  bottom->setShape(std::make_shared<BoxShape>(Eigen::Vector3s::Ones()));
+  auto top = SimpleFrame::createShared(Frame::World());
+  top->setShape(std::make_shared<BoxShape>(Eigen::Vector3s::Ones()));
+  Eigen::Isometry3s topT = Eigen::Isometry3s::Identity();
+  topT.linear() = Eigen::AngleAxis_s(0.25 * M_PI, Eigen::Vector3s::UnitZ())
+                      .toRotationMatrix();
+  topT.translation() = Eigen::Vector3s(0, 0, 0.99);
+  top->setRelativeTransform(topT);
+
+  auto group = cd->createCollisionGroup(bottom.get(), top.get());
+
+  CollisionOption option(true, 1000u);
+  CollisionResult full;
+  EXPECT_TRUE(group->collide(option, &full));
+  EXPECT_GT(full.getNumContacts(), 4u);
+
+  option.maxNumContactsPerPair = 4u;
+  CollisionResult reduced;
+  EXPECT_TRUE(group->collide(option, &reduced));
+  EXPECT_EQ(reduced.getNumContacts(), 4u);
+
+  // Every kept contact is one of the full set
+  for (std::size_t i = 0; i < reduced.getNumContacts(); i++)
+  {
+    bool found = false;
+    for (std::size_t j = 0; j < full.getNumContacts(); j++)
+    {
+      if (equals(
+              reduced.getContact(i).point, full.getContact(j).point, 1e-12))
+        found = true;
+    }
+    EXPECT_TRUE(found);
+  }
+}
+#endif
+
 // The number of contacts shouldn't change under tiny perturbations to position,
 // and the contacts should move in predictable ways.
 
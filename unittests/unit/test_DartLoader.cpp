@@ -458,3 +458,51 @@ TEST(DartLoader, KR5MeshColor)
     }
   }
 }
+
+//==============================================================================
+TEST(DartLoader, ConcurrentMeshLoadingMatchesSerial)
+{
+  const std::string uri = "dart://sample/urdf/KR5/KR5 sixx R650.urdf";
+
+  DartLoader serialLoader;
+  serialLoader.setNumMeshLoadingThreads(1);
+  auto serial = serialLoader.parseSkeleton(uri);
+  ASSERT_TRUE(nullptr != serial);
+
+  DartLoader threadedLoader;
+  threadedLoader.setNumMeshLoadingThreads(4);
+  EXPECT_EQ(threadedLoader.getNumMeshLoadingThreads(), 4u);
+  auto threaded = threadedLoader.parseSkeleton(uri);
+  ASSERT_TRUE(nullptr != threaded);
+
+  ASSERT_EQ(serial->getNumBodyNodes(), threaded->getNumBodyNodes());
+  std::size_t numMeshes = 0u;
+  for (auto i = 0u; i < serial->getNumBodyNodes(); ++i)
+  {
+    auto serialNodes = serial->getBodyNode(i)->getShapeNodes();
+    auto threadedNodes = threaded->getBodyNode(i)->getShapeNodes();
+    ASSERT_EQ(serialNodes.size(), threadedNodes.size());
+    for (auto j = 0u; j < serialNodes.size(); ++j)
+    {
+      auto serialMesh = std::dynamic_pointer_cast<dynamics::MeshShape>(
+          serialNodes[j]->getShape());
+      auto threadedMesh = std::dynamic_pointer_cast<dynamics::MeshShape>(
+          threadedNodes[j]->getShape());
+      ASSERT_EQ(nullptr == serialMesh, nullptr == threadedMesh);
+      if (!serialMesh)
+        continue;
+
+      // Every mesh ends up on the same node it would have loading serially
+      ++numMeshes;
+      EXPECT_EQ(serialMesh->getMeshUri(), threadedMesh->getMeshUri());
+      EXPECT_TRUE(serialMesh->getScale().isApprox(threadedMesh->getScale()));
+      EXPECT_TRUE(serialMesh->getBoundingBox().getMin().isApprox(
+          threadedMesh->getBoundingBox().getMin()));
+      EXPECT_TRUE(serialMesh->getBoundingBox().getMax().isApprox(
+          threadedMesh->getBoundingBox().getMax()));
+      EXPECT_TRUE(serialNodes[j]->getRelativeTransform().isApprox(
+          threadedNodes[j]->getRelativeTransform()));
+    }
+  }
+  EXPECT_GT(numMeshes, 1u);
+}
@@ -237,6 +237,46 @@ TEST(INV_DYN_FOR_CONTACT, TEST_MULTI_CONTACT_MULTI_TIMESTEP_PREV_FORCE)
       resultOverTime.computePrevForceLoss());
 }
 
+//==============================================================================
+TEST(INV_DYN_FOR_CONTACT, TEST_MULTI_CONTACT_LONG_TRAJECTORY)
+{
+  // set precision to 256 bits (double has only 53 bits)
+#ifdef DART_USE_ARBITRARY_PRECISION
+  mpfr::mpreal::set_default_prec(256);
+#endif
+
+  std::shared_ptr<simulation::World> world = simulation::World::create();
+  std::shared_ptr<dynamics::Skeleton> skel = UniversalLoader::loadSkeleton(
+      world.get(), "dart://sample/sdf/atlas/atlas_v3_no_head.sdf");
+
+  // A dense KKT system for this would be ~10k x 10k
+  int numTimesteps = 500;
+
+  Eigen::MatrixXs pos
+      = Eigen::MatrixXs::Random(skel->getNumDofs(), numTimesteps);
+  for (int i = 1; i < pos.cols(); i++)
+  {
+    pos.col(i)
+        = pos.col(i - 1) + Eigen::VectorXs::Random(skel->getNumDofs()) * 0.001;
+  }
+
+  std::vector<dynamics::BodyNode*> nodes;
+  std::vector<Eigen::Vector6s> wrenchGuesses;
+  nodes.push_back(skel->getBodyNode("l_foot"));
+  wrenchGuesses.push_back(Eigen::Vector6s::Random());
+  nodes.push_back(skel->getBodyNode("r_foot"));
+  wrenchGuesses.push_back(Eigen::Vector6s::Random());
+
+  Skeleton::MultipleContactInverseDynamicsOverTimeResult resultOverTime
+      = skel->getMultipleContactInverseDynamicsOverTime(
+          pos, nodes, 1.0, 1.0, wrenchGuesses, 1.0);
+
+  EXPECT_EQ(resultOverTime.timesteps, numTimesteps - 2);
+  EXPECT_EQ(resultOverTime.contactWrenches.size(), numTimesteps - 2);
+  s_t error = resultOverTime.sumError();
+  EXPECT_LE(error, 1e-9);
+}
+
 //==============================================================================
 TEST(INV_DYN_FOR_CONTACT, EXPLORE_RECOVER_CENTER_OF_PRESSURE)
 {
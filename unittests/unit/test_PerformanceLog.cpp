@@ -95,3 +95,29 @@ TEST(PERFORMANCE, NESTED)
 
   std::cout << finalizedRoot->prettyPrint() << std::endl;
 }
+
+TEST(PERFORMANCE, COUNTERS)
+{
+  PerformanceLog::initialize();
+  PerformanceLog* root = PerformanceLog::startRoot("root");
+  for (int i = 0; i < 10; i++)
+  {
+    PerformanceLog* child = root->startRun("child");
+    child->incrementCounter("pivots", i);
+    child->incrementCounter("pivots");
+    child->end();
+  }
+  root->end();
+
+  std::unordered_map<std::string, std::shared_ptr<FinalizedPerformanceLog>>
+      finalizedRoots = PerformanceLog::finalize();
+  std::shared_ptr<FinalizedPerformanceLog> child
+      = finalizedRoots["root"]->getChild("child");
+
+  EXPECT_EQ(child->getCounterSamples("pivots").size(), 10);
+  EXPECT_EQ(child->getCounterTotal("pivots"), 55);
+  EXPECT_EQ(child->getCounterTotal("missing"), 0);
+  EXPECT_EQ(finalizedRoots["root"]->getCounterTotal("pivots"), 0);
+
+  std::cout << finalizedRoots["root"]->prettyPrint() << std::endl;
+}
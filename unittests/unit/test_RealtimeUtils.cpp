@@ -30,18 +30,38 @@
  *   POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
+#include <csignal>
+
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include "dart/dynamics/BodyNode.hpp"
+#include "dart/dynamics/PrismaticJoint.hpp"
+#include "dart/dynamics/Skeleton.hpp"
 #include "dart/realtime/ControlLog.hpp"
+#include "dart/realtime/MPCLocal.hpp"
+#include "dart/realtime/MPCSharedMemory.hpp"
+#include "dart/realtime/Millis.hpp"
 #include "dart/realtime/ObservationLog.hpp"
 #include "dart/realtime/RealTimeControlBuffer.hpp"
+#include "dart/realtime/SharedMemoryChannel.hpp"
+#include "dart/realtime/Ticker.hpp"
 #include "dart/realtime/VectorLog.hpp"
 #include "dart/simulation/World.hpp"
+#include "dart/trajectory/LossFn.hpp"
+#include "dart/trajectory/TrajectoryRollout.hpp"
 
 #include "TestHelpers.hpp"
 #include "stdio.h"
@@ -55,18 +75,26 @@ using namespace simulation;
 using namespace neural;
 using namespace realtime;
 
+/// The tests count time in milliseconds from the realtime clock's epoch, which
+/// keeps the expected values readable
+TimePoint at(long millis)
+{
+  return TimePoint(std::chrono::milliseconds(millis));
+}
+
 #ifdef ALL_TESTS
 TEST(REALTIME, VECTOR_LOG)
 {
   int dim = 2;
   VectorLog log = VectorLog(dim);
 
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
 
   Eigen::MatrixXs expected = Eigen::MatrixXs::Ones(dim, 20);
   expected.block(0, 10, 2, 10) *= 2;
-  Eigen::MatrixXs actual = log.getValues(0L, 20, 1L);
+  Eigen::MatrixXs actual
+      = log.getValues(at(0), 20, std::chrono::milliseconds(1));
 
   if (!equals(expected, actual))
   {
@@ -84,12 +112,13 @@ TEST(REALTIME, VECTOR_LOG_EXTEND)
   int dim = 2;
   VectorLog log = VectorLog(dim);
 
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
 
   Eigen::MatrixXs expected = Eigen::MatrixXs::Ones(dim, 20);
   expected.block(0, 2, 2, 18) *= 2;
-  Eigen::MatrixXs actual = log.getValues(8L, 20, 1L);
+  Eigen::MatrixXs actual
+      = log.getValues(at(8), 20, std::chrono::milliseconds(1));
 
   if (!equals(expected, actual))
   {
@@ -107,12 +136,13 @@ TEST(REALTIME, VECTOR_LOG_AFTER)
   int dim = 2;
   VectorLog log = VectorLog(dim);
 
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
 
   Eigen::MatrixXs expected = Eigen::MatrixXs::Ones(dim, 20);
   expected *= 2;
-  Eigen::MatrixXs actual = log.getValues(18L, 20, 1L);
+  Eigen::MatrixXs actual
+      = log.getValues(at(18), 20, std::chrono::milliseconds(1));
 
   if (!equals(expected, actual))
   {
@@ -128,16 +158,16 @@ TEST(REALTIME, VECTOR_LOG_AFTER)
 TEST(REALTIME, CONTROL_LOG)
 {
   int dim = 2;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   ControlLog log = ControlLog(dim, dt);
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
-
-  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(-3L)(0)));
-  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(3L)(0)));
-  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(7L)(0)));
-  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(10L)(0)));
-  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(24L)(0)));
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
+
+  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(at(-3))(0)));
+  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(at(3))(0)));
+  EXPECT_DOUBLE_EQ(1.0, static_cast<double>(log.get(at(7))(0)));
+  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(at(10))(0)));
+  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(at(24))(0)));
 }
 #endif
 
@@ -145,18 +175,18 @@ TEST(REALTIME, CONTROL_LOG)
 TEST(REALTIME, CONTROL_LOG_DISCARD_BEFORE)
 {
   int dim = 2;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   ControlLog log = ControlLog(dim, dt);
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(5L, Eigen::VectorXs::Ones(dim) * 3);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
-  log.discardBefore(5L);
-
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(-3L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(3L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(7L)(0)));
-  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(24L)(0)));
-  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(10L)(0)));
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(5), Eigen::VectorXs::Ones(dim) * 3);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
+  log.discardBefore(at(5));
+
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(-3))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(3))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(7))(0)));
+  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(at(24))(0)));
+  EXPECT_DOUBLE_EQ(2.0, static_cast<double>(log.get(at(10))(0)));
 }
 #endif
 
@@ -164,23 +194,23 @@ TEST(REALTIME, CONTROL_LOG_DISCARD_BEFORE)
 TEST(REALTIME, CONTROL_LOG_DISCARD_BEFORE_OFF_TIMESTEP)
 {
   int dim = 2;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   ControlLog log = ControlLog(dim, dt);
-  log.record(0L, Eigen::VectorXs::Ones(dim) * 1);
-  log.record(5L, Eigen::VectorXs::Ones(dim) * 3);
-  log.record(10L, Eigen::VectorXs::Ones(dim) * 2);
-  // This should discard up through 5L, and set last observed to 10L
-  log.discardBefore(7L);
-  // This should overwrite the 10L slot, because it's not far enough to hit the
-  // 15L slot. That won't happen if the discardBefore() didn't set the last
+  log.record(at(0), Eigen::VectorXs::Ones(dim) * 1);
+  log.record(at(5), Eigen::VectorXs::Ones(dim) * 3);
+  log.record(at(10), Eigen::VectorXs::Ones(dim) * 2);
+  // This should discard up through 5ms, and set last observed to 10ms
+  log.discardBefore(at(7));
+  // This should overwrite the 10ms slot, because it's not far enough to hit the
+  // 15ms slot. That won't happen if the discardBefore() didn't set the last
   // observed point correctly.
-  log.record(14L, Eigen::VectorXs::Ones(dim) * 3);
+  log.record(at(14), Eigen::VectorXs::Ones(dim) * 3);
 
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(-3L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(3L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(7L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(24L)(0)));
-  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(10L)(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(-3))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(3))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(7))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(24))(0)));
+  EXPECT_DOUBLE_EQ(3.0, static_cast<double>(log.get(at(10))(0)));
 }
 #endif
 
@@ -188,12 +218,12 @@ TEST(REALTIME, CONTROL_LOG_DISCARD_BEFORE_OFF_TIMESTEP)
 TEST(REALTIME, CONTROL_LOG_GET_EMPTY)
 {
   int dim = 2;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   ControlLog log = ControlLog(dim, dt);
-  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(-3L)(0)));
-  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(3L)(0)));
-  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(7L)(0)));
-  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(24L)(0)));
+  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(at(-3))(0)));
+  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(at(3))(0)));
+  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(at(7))(0)));
+  EXPECT_DOUBLE_EQ(0.0, static_cast<double>(log.get(at(24))(0)));
 }
 #endif
 
@@ -202,12 +232,13 @@ TEST(REALTIME, CONTROL_BUFFER)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
-  buffer.setControlForcePlan(0L, 0L, Eigen::MatrixXs::Ones(forceDim, steps) * 2);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(25L)(0)), 2.0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(49L)(0)), 2.0);
+  buffer.setControlForcePlan(
+      at(0), at(0), Eigen::MatrixXs::Ones(forceDim, steps) * 2);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(25))(0)), 2.0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(49))(0)), 2.0);
 }
 #endif
 
@@ -216,12 +247,13 @@ TEST(REALTIME, CONTROL_BUFFER_OOB)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
-  buffer.setControlForcePlan(0L, 0L, Eigen::MatrixXs::Ones(forceDim, steps) * 2);
+  buffer.setControlForcePlan(
+      at(0), at(0), Eigen::MatrixXs::Ones(forceDim, steps) * 2);
   // This reads off the end, should print a warning and return 0s
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(50L)(0)), 0.0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(50))(0)), 0.0);
 }
 #endif
 
@@ -230,7 +262,7 @@ TEST(REALTIME, CONTROL_BUFFER_SCALE_DOWN)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Ones(forceDim, steps);
@@ -238,17 +270,17 @@ TEST(REALTIME, CONTROL_BUFFER_SCALE_DOWN)
   {
     plan.col(i) *= i;
   }
-  buffer.setControlForcePlan(0L, 0L, plan);
-  buffer.setMillisPerStep(10);
+  buffer.setControlForcePlan(at(0), at(0), plan);
+  buffer.setStepDuration(std::chrono::milliseconds(10));
   buffer.setNumSteps(5);
 
   // Read off the lower resolution, should now jump by whole numbers
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(0 * dt)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(1 * dt)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(2 * dt)(0)), 2);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(3 * dt)(0)), 2);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(4 * dt)(0)), 4);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(5 * dt)(0)), 4);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(0))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(5))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(10))(0)), 2);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(15))(0)), 2);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(20))(0)), 4);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(25))(0)), 4);
 }
 #endif
 
@@ -257,7 +289,7 @@ TEST(REALTIME, CONTROL_BUFFER_SCALE_UP)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Ones(forceDim, steps);
@@ -265,23 +297,23 @@ TEST(REALTIME, CONTROL_BUFFER_SCALE_UP)
   {
     plan.col(i) *= i;
   }
-  buffer.setControlForcePlan(0L, 0L, plan);
-  buffer.setMillisPerStep(1);
+  buffer.setControlForcePlan(at(0), at(0), plan);
+  buffer.setStepDuration(std::chrono::milliseconds(1));
 
   // Read off the lower resolution, should now jump by whole numbers
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(0)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(1)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(2)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(3)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(4)(0)), 0);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(5)(0)), 1);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(6)(0)), 1);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(7)(0)), 1);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(8)(0)), 1);
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(9)(0)), 1);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(0))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(1))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(2))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(3))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(4))(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(5))(0)), 1);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(6))(0)), 1);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(7))(0)), 1);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(8))(0)), 1);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(9))(0)), 1);
 
   // This is OOB, throws a warning and return 0
-  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(10)(0)), 0);
+  EXPECT_DOUBLE_EQ(static_cast<double>(buffer.getPlannedForce(at(10))(0)), 0);
 }
 #endif
 
@@ -290,7 +322,7 @@ TEST(REALTIME, CONTROL_BUFFER_MIX)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Ones(forceDim, steps);
@@ -298,17 +330,17 @@ TEST(REALTIME, CONTROL_BUFFER_MIX)
   {
     plan.col(i) *= i;
   }
-  buffer.setControlForcePlan(0L, 0L, plan);
+  buffer.setControlForcePlan(at(0), at(0), plan);
 
   Eigen::MatrixXs plan2 = Eigen::MatrixXs::Ones(forceDim, steps) * 2;
   for (int i = 0; i < steps; i++)
   {
     plan2.col(i) *= i;
   }
-  buffer.setControlForcePlan(25L, 0L, plan2);
+  buffer.setControlForcePlan(at(25), at(0), plan2);
 
   Eigen::MatrixXs planOut = Eigen::MatrixXs::Random(forceDim, steps);
-  buffer.getPlannedForcesStartingAt(0L, planOut);
+  buffer.getPlannedForcesStartingAt(at(0), planOut);
 
   Eigen::MatrixXs expectedPlan = Eigen::MatrixXs::Ones(forceDim, steps);
   for (int i = 0; i < 5; i++)
@@ -334,7 +366,7 @@ TEST(REALTIME, CONTROL_BUFFER_GAP)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Ones(forceDim, steps);
@@ -342,17 +374,17 @@ TEST(REALTIME, CONTROL_BUFFER_GAP)
   {
     plan.col(i) *= i;
   }
-  buffer.setControlForcePlan(0L, 0L, plan);
+  buffer.setControlForcePlan(at(0), at(0), plan);
 
   Eigen::MatrixXs plan2 = Eigen::MatrixXs::Ones(forceDim, steps) * 2;
   for (int i = 0; i < steps; i++)
   {
     plan2.col(i) *= i;
   }
-  buffer.setControlForcePlan(12 * dt, 8 * dt, plan2);
+  buffer.setControlForcePlan(TimePoint(12 * dt), TimePoint(8 * dt), plan2);
 
   Eigen::MatrixXs planOut = Eigen::MatrixXs::Random(forceDim, steps);
-  buffer.getPlannedForcesStartingAt(8 * dt, planOut);
+  buffer.getPlannedForcesStartingAt(TimePoint(8 * dt), planOut);
 
   Eigen::MatrixXs expectedPlan = Eigen::MatrixXs::Ones(forceDim, steps);
   for (int i = 0; i < 2; i++)
@@ -382,7 +414,7 @@ TEST(REALTIME, CONTROL_BUFFER_MERGE_OOB)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Ones(forceDim, steps);
@@ -390,7 +422,7 @@ TEST(REALTIME, CONTROL_BUFFER_MERGE_OOB)
   {
     plan.col(i) *= i;
   }
-  buffer.setControlForcePlan(0L, 0L, plan);
+  buffer.setControlForcePlan(at(0), at(0), plan);
 
   Eigen::MatrixXs plan2 = Eigen::MatrixXs::Ones(forceDim, steps) * 2;
   for (int i = 0; i < steps; i++)
@@ -399,10 +431,10 @@ TEST(REALTIME, CONTROL_BUFFER_MERGE_OOB)
   }
 
   // This is out of bounds, so should be discarded
-  buffer.setControlForcePlan(12 * dt, 0L, plan2);
+  buffer.setControlForcePlan(TimePoint(12 * dt), at(0), plan2);
 
   Eigen::MatrixXs planOut = Eigen::MatrixXs::Random(forceDim, steps);
-  buffer.getPlannedForcesStartingAt(0L, planOut);
+  buffer.getPlannedForcesStartingAt(at(0), planOut);
 
   if (!equals(planOut, plan))
   {
@@ -418,13 +450,14 @@ TEST(REALTIME, CONTROL_BUFFER_PLAN)
 {
   int forceDim = 3;
   int steps = 10;
-  int dt = 5;
+  std::chrono::milliseconds dt(5);
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
 
-  buffer.setControlForcePlan(0L, 0L, Eigen::MatrixXs::Ones(forceDim, steps) * 2);
+  buffer.setControlForcePlan(
+      at(0), at(0), Eigen::MatrixXs::Ones(forceDim, steps) * 2);
 
   Eigen::MatrixXs plan = Eigen::MatrixXs::Random(forceDim, steps);
-  buffer.getPlannedForcesStartingAt(25L, plan);
+  buffer.getPlannedForcesStartingAt(at(25), plan);
 
   // the beginning of the buffer should be the old plan
   for (int i = 0; i < 5; i++)
@@ -483,15 +516,16 @@ TEST(REALTIME, CONTROL_BUFFER_ESTIMATE)
 
   int forceDim = world->getNumDofs();
   int steps = 100;
-  int dt = static_cast<int>(world->getTimeStep() * 1000);
+  Duration dt = secondsToDuration(world->getTimeStep());
   RealTimeControlBuffer buffer = RealTimeControlBuffer(forceDim, steps, dt);
   ObservationLog log = ObservationLog(
-      0L, world->getPositions(), world->getVelocities(), world->getMasses());
+      at(0), world->getPositions(), world->getVelocities(), world->getMasses());
 
-  buffer.setControlForcePlan(0L, 0L, Eigen::MatrixXs::Ones(forceDim, steps) * 2);
+  buffer.setControlForcePlan(
+      at(0), at(0), Eigen::MatrixXs::Ones(forceDim, steps) * 2);
 
   log.observe(
-      0L,
+      at(0),
       Eigen::VectorXs::Zero(1),
       Eigen::VectorXs::Zero(1),
       Eigen::VectorXs::Ones(1));
@@ -502,7 +536,7 @@ TEST(REALTIME, CONTROL_BUFFER_ESTIMATE)
 
   for (int i = 0; i < steps; i++)
   {
-    world->setControlForces(buffer.getPlannedForce(i * dt));
+    world->setControlForces(buffer.getPlannedForce(TimePoint(i * dt)));
     world->step();
   }
   Eigen::VectorXs truePos = world->getPositions();
@@ -516,9 +550,313 @@ TEST(REALTIME, CONTROL_BUFFER_ESTIMATE)
   world->setPositions(Eigen::VectorXs::Random(1));
   world->setVelocities(Eigen::VectorXs::Random(1));
   // Estimate state
-  buffer.estimateWorldStateAt(world, &log, steps * dt);
+  buffer.estimateWorldStateAt(world, &log, TimePoint(steps * dt));
 
   EXPECT_TRUE(equals(truePos, world->getPositions()));
   EXPECT_TRUE(equals(trueVel, world->getVelocities()));
 }
-#endif
\ No newline at end of file
+#endif
+
+#ifdef ALL_TESTS
+TEST(REALTIME, TICKER_DEADLINES)
+{
+  const Duration period = std::chrono::milliseconds(5);
+  Ticker ticker(0.005);
+  ticker.setSpinWait(std::chrono::microseconds(200));
+
+  std::mutex deadlinesMutex;
+  std::vector<TimePoint> deadlines;
+  ticker.registerTickListener([&](TimePoint deadline) {
+    const std::lock_guard<std::mutex> lock(deadlinesMutex);
+    // We should never be called before the scheduled deadline
+    EXPECT_GE(now(), deadline);
+    deadlines.push_back(deadline);
+  });
+  ticker.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ticker.stop();
+
+  const std::lock_guard<std::mutex> lock(deadlinesMutex);
+  ASSERT_GE(deadlines.size(), 2u);
+  EXPECT_EQ(ticker.getNumTicks(), (long)deadlines.size());
+  // Deadlines land on exact multiples of the period, so they don't drift
+  for (std::size_t i = 1; i < deadlines.size(); i++)
+  {
+    EXPECT_EQ((deadlines[i] - deadlines[0]) % period, Duration::zero());
+    EXPECT_GT(deadlines[i], deadlines[i - 1]);
+  }
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(REALTIME, TICKER_SKIPS_OVERRUNS)
+{
+  Ticker ticker(0.002);
+  std::atomic<int> calls(0);
+  ticker.registerTickListener([&](TimePoint /* now */) {
+    calls++;
+    // Take longer than two periods, so the ticker has to skip ahead
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  });
+  ticker.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ticker.stop();
+
+  EXPECT_GT(calls.load(), 0);
+  EXPECT_EQ(ticker.getNumTicks(), calls.load());
+  EXPECT_GT(ticker.getNumOverruns(), 0);
+  EXPECT_GE(ticker.getNumSkippedTicks(), 2 * ticker.getNumOverruns());
+}
+#endif
+
+/// This kills and reaps a forked child, if the test bails out (say, on a
+/// failed ASSERT) before it gets around to waiting for it
+struct ForkedChild
+{
+  pid_t pid;
+
+  ForkedChild(pid_t pid) : pid(pid)
+  {
+  }
+
+  ~ForkedChild()
+  {
+    if (pid <= 0)
+      return;
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+  }
+
+  /// Waits for the child to exit by itself, and returns its status
+  int wait()
+  {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    pid = -1;
+    return status;
+  }
+};
+
+#ifdef ALL_TESTS
+TEST(REALTIME, SHARED_MEMORY_CHANNEL)
+{
+  const int dofs = 3;
+  const int massDim = 2;
+  const int steps = 5;
+  std::shared_ptr<SharedMemoryChannel> channel
+      = SharedMemoryChannel::createAnonymous(
+          dofs, massDim, steps, std::chrono::milliseconds(10));
+  ASSERT_NE(channel, nullptr);
+
+  int child_id = fork();
+  ASSERT_GE(child_id, 0);
+  if (child_id == 0)
+  {
+    // Stand in for MPCLocal: answer every state with a plan derived from it
+    SharedMemoryMessage message;
+    while (!channel->isClosed())
+    {
+      if (!channel->receiveMessage(message, std::chrono::milliseconds(100)))
+        continue;
+      if (message.type != SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE)
+        continue;
+      std::unordered_map<std::string, Eigen::MatrixXs> poses;
+      std::unordered_map<std::string, Eigen::MatrixXs> vels;
+      std::unordered_map<std::string, Eigen::MatrixXs> forces;
+      poses["identity"] = message.pos.replicate(1, steps);
+      vels["identity"] = message.vel.replicate(1, steps);
+      forces["identity"] = 2 * message.pos.replicate(1, steps);
+      trajectory::TrajectoryRolloutReal rollout(
+          poses,
+          vels,
+          forces,
+          message.mass,
+          std::unordered_map<std::string, Eigen::MatrixXs>());
+      channel->publishPlan(
+          message.time, std::chrono::milliseconds(7), &rollout);
+    }
+    // Skip gtest's teardown in the child
+    _exit(0);
+  }
+  ForkedChild child(child_id);
+
+  EXPECT_EQ(channel->getNumDofs(), dofs);
+  EXPECT_EQ(channel->getMassDim(), massDim);
+  EXPECT_EQ(channel->getNumSteps(), steps);
+  EXPECT_EQ(channel->getStepDuration(), std::chrono::milliseconds(10));
+
+  // Nothing has been published yet
+  uint32_t sequence = 0;
+  SharedMemoryPlan plan;
+  EXPECT_FALSE(
+      channel->waitForPlan(sequence, plan, std::chrono::milliseconds(1)));
+
+  const int rounds = 200;
+  std::vector<Duration> latencies;
+  for (int i = 0; i < rounds; i++)
+  {
+    Eigen::VectorXs pos = Eigen::VectorXs::Random(dofs);
+    Eigen::VectorXs vel = Eigen::VectorXs::Random(dofs);
+    Eigen::VectorXs mass = Eigen::VectorXs::Random(massDim);
+
+    TimePoint start = now();
+    ASSERT_TRUE(channel->sendMessage(
+        SharedMemoryMessage::RECORD_GROUND_TRUTH_STATE,
+        at(i),
+        pos,
+        vel,
+        mass));
+    ASSERT_TRUE(
+        channel->waitForPlan(sequence, plan, std::chrono::milliseconds(5000)));
+    latencies.push_back(now() - start);
+
+    EXPECT_EQ(plan.startTime, at(i));
+    EXPECT_EQ(plan.replanDuration, std::chrono::milliseconds(7));
+    ASSERT_EQ(plan.forces.rows(), dofs);
+    ASSERT_EQ(plan.forces.cols(), steps);
+    Eigen::MatrixXs expectedPoses = pos.replicate(1, steps);
+    Eigen::MatrixXs expectedVels = vel.replicate(1, steps);
+    Eigen::MatrixXs expectedForces = 2 * pos.replicate(1, steps);
+    EXPECT_TRUE(equals(plan.poses, expectedPoses, 1e-12));
+    EXPECT_TRUE(equals(plan.vels, expectedVels, 1e-12));
+    EXPECT_TRUE(equals(plan.forces, expectedForces, 1e-12));
+    EXPECT_TRUE(equals(plan.masses, mass, 1e-12));
+  }
+
+  channel->close();
+  int status = child.wait();
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_TRUE(channel->isClosed());
+  EXPECT_FALSE(channel->sendMessage(SharedMemoryMessage::START, at(0)));
+
+  std::sort(latencies.begin(), latencies.end());
+  Duration median = latencies[latencies.size() / 2];
+  std::cout << "Shared memory state-to-plan round trip, median: "
+            << (median.count() / 1000) << "us" << std::endl;
+  // This bound is loose, so that loaded CI machines still pass
+  EXPECT_LT(median, std::chrono::milliseconds(1));
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(REALTIME, SHARED_MEMORY_CHANNEL_NAME_TAKEN)
+{
+  const std::string name = "/nimble_test_" + std::to_string(getpid());
+
+  // Stand in for a server that crashed without unlinking its channel
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  const Duration stepDuration = std::chrono::milliseconds(10);
+  EXPECT_EQ(SharedMemoryChannel::create(name, 1, 0, 5, stepDuration), nullptr);
+  std::shared_ptr<SharedMemoryChannel> channel
+      = SharedMemoryChannel::create(name, 1, 0, 5, stepDuration, true);
+  ASSERT_NE(channel, nullptr);
+
+  // Our own live channel can't be taken over by accident either
+  EXPECT_EQ(SharedMemoryChannel::create(name, 1, 0, 5, stepDuration), nullptr);
+  std::shared_ptr<SharedMemoryChannel> opened = SharedMemoryChannel::open(name);
+  ASSERT_NE(opened, nullptr);
+  EXPECT_EQ(opened->getNumSteps(), 5);
+
+  // Destroying the channel unlinks its name
+  opened = nullptr;
+  channel = nullptr;
+  EXPECT_EQ(SharedMemoryChannel::open(name), nullptr);
+}
+#endif
+
+#ifdef ALL_TESTS
+TEST(REALTIME, MPC_SHARED_MEMORY_END_TO_END)
+{
+  const std::string name = "/nimble_mpc_test_" + std::to_string(getpid());
+
+  // A box on a rail, which should be driven to x = 1
+  WorldPtr world = World::create();
+  world->setGravity(Eigen::Vector3s::Zero());
+  world->setTimeStep(1.0 / 100);
+  SkeletonPtr box = Skeleton::create("box");
+  std::pair<PrismaticJoint*, BodyNode*> pair
+      = box->createJointAndBodyNodePair<PrismaticJoint>(nullptr);
+  pair.first->setAxis(Eigen::Vector3s::UnitX());
+  world->addSkeleton(box);
+  box->setControlForceUpperLimit(0, 10);
+  box->setControlForceLowerLimit(0, -10);
+
+  trajectory::TrajectoryLossFn loss
+      = [](const trajectory::TrajectoryRollout* rollout) {
+          return (rollout->getPosesConst().array() - 1.0).square().sum();
+        };
+  trajectory::TrajectoryLossFnAndGrad lossGrad
+      = [](const trajectory::TrajectoryRollout* rollout,
+           trajectory::TrajectoryRollout* gradWrtRollout // OUT
+        ) {
+          gradWrtRollout->getVels().setZero();
+          gradWrtRollout->getControlForces().setZero();
+          gradWrtRollout->getPoses()
+              = 2 * (rollout->getPosesConst().array() - 1.0).matrix();
+          return (rollout->getPosesConst().array() - 1.0).square().sum();
+        };
+
+  MPCLocal local(
+      world,
+      std::make_shared<trajectory::LossFn>(loss, lossGrad),
+      std::chrono::milliseconds(100));
+  local.setSilent(true);
+  local.setMaxIterations(3);
+
+  int child_id = fork();
+  ASSERT_GE(child_id, 0);
+  if (child_id == 0)
+  {
+    local.serveSharedMemory(name);
+    // Skip gtest's teardown in the child
+    _exit(0);
+  }
+  ForkedChild child(child_id);
+
+  // Wait for the server to come up
+  std::shared_ptr<SharedMemoryChannel> probe;
+  for (int i = 0; i < 1000 && !probe; i++)
+  {
+    probe = SharedMemoryChannel::open(name);
+    if (!probe)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_NE(probe, nullptr);
+  EXPECT_EQ(probe->getNumDofs(), 1);
+  probe = nullptr;
+
+  std::atomic<int> numPlans(0);
+  {
+    MPCSharedMemory client(name);
+    client.registerReplanningListener(
+        [&](TimePoint /* startTime */,
+            const trajectory::TrajectoryRollout* rollout,
+            Duration /* duration */) {
+          if (rollout->getControlForcesConst().rows() == 1)
+            numPlans++;
+        });
+    client.recordGroundTruthState(
+        now(),
+        Eigen::VectorXs::Zero(1),
+        Eigen::VectorXs::Zero(1),
+        world->getMasses());
+    client.start();
+    for (int i = 0; i < 3000 && numPlans.load() == 0; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(numPlans.load(), 0);
+    EXPECT_EQ(client.getControlForce(now()).size(), 1);
+
+    // The client closes the channel on the way out, which stops the server
+    client.stop();
+  }
+  int status = child.wait();
+  EXPECT_TRUE(WIFEXITED(status));
+  // The server unlinked the name on its way out
+  EXPECT_EQ(SharedMemoryChannel::open(name), nullptr);
+}
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2011-2019, The DART development contributors
+ * All rights reserved.
+ *
+ * The list of contributors can be found at:
+ *   https://github.com/dartsim/dart/blob/master/LICENSE
+ *
+ * This file is provided under the following "BSD-style" License:
+ *   Redistribution and use in source and binary forms, with or
+ *   without modification, are permitted provided that the following
+ *   conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ *   CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *   INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ *   MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ *   USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ *   AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *   ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *   POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dart/common/ThreadPool.hpp"
+
+using namespace dart;
+
+//==============================================================================
+TEST(ThreadPool, RunsEveryItemOnce)
+{
+  common::ThreadPool pool(4);
+  EXPECT_EQ(pool.getNumThreads(), 4u);
+
+  // Reuse the same pool for many jobs, to make sure workers pick up every one
+  for (std::size_t n : {0u, 1u, 3u, 4u, 17u, 1000u})
+  {
+    std::vector<int> counts(n, 0);
+    pool.parallelFor(n, [&](std::size_t i) { counts[i]++; });
+    for (std::size_t i = 0; i < n; i++)
+    {
+      EXPECT_EQ(counts[i], 1);
+    }
+  }
+}
+
+//==============================================================================
+TEST(ThreadPool, FixedAssignment)
+{
+  common::ThreadPool pool(3);
+  const std::size_t n = 30;
+
+  std::vector<std::thread::id> first(n);
+  pool.parallelFor(n, [&](std::size_t i) {
+    first[i] = std::this_thread::get_id();
+  });
+  std::vector<std::thread::id> second(n);
+  pool.parallelFor(n, [&](std::size_t i) {
+    second[i] = std::this_thread::get_id();
+  });
+
+  for (std::size_t i = 0; i < n; i++)
+  {
+    // The same item always lands on the same thread
+    EXPECT_EQ(first[i], second[i]);
+    // Items are dealt out round-robin, with the caller taking share 0
+    EXPECT_EQ(first[i], first[i % 3]);
+    if (i % 3 == 0)
+    {
+      EXPECT_EQ(first[i], std::this_thread::get_id());
+    }
+    else
+    {
+      EXPECT_NE(first[i], std::this_thread::get_id());
+    }
+  }
+}
+
+//==============================================================================
+TEST(ThreadPool, RethrowsExceptions)
+{
+  common::ThreadPool pool(2);
+  std::atomic<int> finished(0);
+  EXPECT_THROW(
+      pool.parallelFor(
+          10,
+          [&](std::size_t i) {
+            if (i == 5)
+              throw std::runtime_error("failed");
+            finished++;
+          }),
+      std::runtime_error);
+
+  // The pool should still be usable afterwards
+  finished = 0;
+  pool.parallelFor(10, [&](std::size_t) { finished++; });
+  EXPECT_EQ(finished.load(), 10);
+}
+
+//==============================================================================
+TEST(ThreadPool, SingleThreadRunsInline)
+{
+  common::ThreadPool pool(1);
+  EXPECT_EQ(pool.getNumThreads(), 1u);
+  const std::thread::id caller = std::this_thread::get_id();
+  std::vector<std::size_t> order;
+  pool.parallelFor(5, [&](std::size_t i) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    order.push_back(i);
+  });
+  EXPECT_EQ(order, std::vector<std::size_t>({0, 1, 2, 3, 4}));
+}
@@ -1,3 +1,5 @@
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -70,4 +72,89 @@ TEST(UniversalLoader, LOAD_URDF_FROM_RELATIVE_PATH)
   std::shared_ptr<dynamics::Skeleton> skel = UniversalLoader::loadSkeleton(
       world.get(), "../../../data/sdf/atlas/ground.urdf");
   EXPECT_TRUE(skel != nullptr);
-}
\ No newline at end of file
+}
+//==============================================================================
+TEST(UniversalLoader, CACHED_LOADS_ARE_INDEPENDENT)
+{
+  // Caching is opt-in
+  EXPECT_FALSE(UniversalLoader::isCacheEnabled());
+  UniversalLoader::setCacheEnabled(true);
+
+  std::shared_ptr<simulation::World> world = simulation::World::create();
+  Eigen::Vector3s basePosition(1.0, 2.0, 3.0);
+  std::shared_ptr<dynamics::Skeleton> first = UniversalLoader::loadSkeleton(
+      world.get(), "dart://sample//skel/test/cube_skeleton.skel", basePosition);
+  std::shared_ptr<dynamics::Skeleton> second = UniversalLoader::loadSkeleton(
+      world.get(), "dart://sample//skel/test/cube_skeleton.skel", basePosition);
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first->getNumBodyNodes(), second->getNumBodyNodes());
+  EXPECT_EQ(first->getNumDofs(), second->getNumDofs());
+
+  // Moving the first copy shouldn't have moved the cached original
+  EXPECT_TRUE(equals(
+      first->getRootJoint()->getTransformFromParentBodyNode().matrix(),
+      second->getRootJoint()->getTransformFromParentBodyNode().matrix()));
+
+  first->setPositions(Eigen::VectorXs::Ones(first->getNumDofs()));
+  EXPECT_TRUE(second->getPositions().isZero());
+
+  // Shapes are shared with the cached copy, until the file gets evicted
+  ASSERT_LT(0u, first->getBodyNode(0)->getNumShapeNodes());
+  EXPECT_EQ(
+      first->getBodyNode(0)->getShapeNode(0)->getShape(),
+      second->getBodyNode(0)->getShapeNode(0)->getShape());
+  UniversalLoader::evictFromCache(
+      "dart://sample//skel/test/cube_skeleton.skel");
+  std::shared_ptr<dynamics::Skeleton> evicted = UniversalLoader::loadSkeleton(
+      world.get(), "dart://sample//skel/test/cube_skeleton.skel", basePosition);
+  ASSERT_TRUE(evicted != nullptr);
+  EXPECT_NE(
+      first->getBodyNode(0)->getShapeNode(0)->getShape(),
+      evicted->getBodyNode(0)->getShapeNode(0)->getShape());
+
+  UniversalLoader::setCacheEnabled(false);
+  std::shared_ptr<dynamics::Skeleton> uncached = UniversalLoader::loadSkeleton(
+      world.get(), "dart://sample//skel/test/cube_skeleton.skel", basePosition);
+  ASSERT_TRUE(uncached != nullptr);
+  EXPECT_NE(
+      evicted->getBodyNode(0)->getShapeNode(0)->getShape(),
+      uncached->getBodyNode(0)->getShapeNode(0)->getShape());
+  EXPECT_EQ(first->getNumDofs(), uncached->getNumDofs());
+  EXPECT_TRUE(equals(
+      first->getRootJoint()->getTransformFromParentBodyNode().matrix(),
+      uncached->getRootJoint()->getTransformFromParentBodyNode().matrix()));
+}
+
+//==============================================================================
+TEST(UniversalLoader, CACHE_SEES_QUICK_REWRITES)
+{
+  UniversalLoader::setCacheEnabled(true);
+  const std::string path = "./universal_loader_rewrite_test.urdf";
+  auto writeRobot = [&](int numLinks) {
+    std::ofstream out(path);
+    out << "<robot name=\"rewritten\">";
+    for (int i = 0; i < numLinks; i++)
+      out << "<link name=\"link" << i << "\"/>";
+    out << "</robot>";
+  };
+
+  std::shared_ptr<simulation::World> world = simulation::World::create();
+  writeRobot(1);
+  std::shared_ptr<dynamics::Skeleton> before
+      = UniversalLoader::loadSkeleton(world.get(), path);
+  ASSERT_TRUE(before != nullptr);
+  EXPECT_EQ(1u, before->getNumBodyNodes());
+
+  // This almost certainly lands in the same second as the first write, so the
+  // cache has to look closer than that to notice it
+  writeRobot(2);
+  std::shared_ptr<dynamics::Skeleton> after
+      = UniversalLoader::loadSkeleton(world.get(), path);
+  ASSERT_TRUE(after != nullptr);
+  EXPECT_EQ(2u, after->getNumBodyNodes());
+
+  UniversalLoader::setCacheEnabled(false);
+  std::remove(path.c_str());
+}